@@ -61,7 +61,9 @@
 	CLI_CLIENT_SERVER_PROTOCOL_CODE_AT(CLI_CLIENT_SERVER_STATISTICS_CLEAR,     3)\
 	CLI_CLIENT_SERVER_PROTOCOL_CODE_AT(CLI_CLIENT_RETRANSMIT_SHOW,             4)\
 	CLI_CLIENT_SERVER_PROTOCOL_CODE_AT(CLI_CLIENT_RETRANSMIT_LOG_LEVEL,        5)\
-	CLI_CLIENT_SERVER_PROTOCOL_CODE_AT(CLI_CLIENT_SERVER_MAX,                  6)\
+	CLI_CLIENT_SERVER_PROTOCOL_CODE_AT(CLI_CLIENT_SERVER_LATENCY_SHOW,         6)\
+	CLI_CLIENT_SERVER_PROTOCOL_CODE_AT(CLI_CLIENT_SERVER_LATENCY_CLEAR,        7)\
+	CLI_CLIENT_SERVER_PROTOCOL_CODE_AT(CLI_CLIENT_SERVER_MAX,                  8)\
 
 #define CLI_CLIENT_SERVER_PROTOCOL_CODE_AT(_cli_code, _val) _cli_code = _val,
 typedef enum {
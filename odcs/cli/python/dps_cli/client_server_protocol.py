@@ -88,6 +88,8 @@ class cli_interface_client_server_protocol:
     CLI_CLIENT_SERVER_STATISTICS_CLEAR = 3
     CLI_CLIENT_RETRANSMIT_SHOW = 4
     CLI_CLIENT_RETRANSMIT_LOG_LEVEL = 5
+    CLI_CLIENT_SERVER_LATENCY_SHOW = 6
+    CLI_CLIENT_SERVER_LATENCY_CLEAR = 7
 
 class cli_client_server(cli_dps_config):
     '''
@@ -501,3 +503,86 @@ class cli_cs_retransmit_log_level(cli_client_server):
 #Add this class of command to global list of supported commands
 cli_cs_retransmit_log_level.add_cli()
 
+class cli_cs_latency_show(cli_cs_show):
+    '''
+    Represents the CLI Object for showing the Decode, Handler, Encode
+    and Xmit latency in the DPS Client Server Protocol
+    '''
+    #The Possible Unique Names that identify this command
+    #These will be the 1st parameter in the CLI command (20 chars max)
+    command_id = 'latency'
+    #Definition of the Command - Keep it short (40 chars)
+    command_def = 'Show DPS Protocol Latency'
+    #Whether it's a hidden command
+    hidden = False
+    #Whether the command is only available in god mode
+    GodModeOnly = False
+    #This is MAJOR TYPE of the Command
+    major_type = cli_dps_interface.CLI_CLIENT_SERVER_PROTOCOL
+    #CLI CODE
+    cli_code = cli_interface_client_server_protocol.CLI_CLIENT_SERVER_LATENCY_SHOW
+    #The Parameters of the rest of the command
+    #Each parameter must have ('Name', 'Type', 'Non-Optional?', 'Range' )
+    #All optional parameters MUST come after the required parameters
+    command_format = [('msg-type', cli_type_string_set, False, cli_interface_client_server_protocol.MsgCodesStringRange)]
+    support_random = False
+    #Structure to send
+    # 2 Integers (MAJOR CODE, MINOR CODE) followed by
+    #typedef struct cli_cs_protocol_stats_s{
+    #    uint32_t pkt_type;
+    #}cli_cs_protocol_stats_t;
+    fmt = 'III'
+    #This function 'execute' must exist for all CLI objects
+    def execute(self, session):
+        '''
+        @param session: The session context
+        @type session: Class login_context
+        '''
+        #self.params hold the variables
+        try:
+            msg_type = cli_interface_client_server_protocol.MsgStringToType[self.params[0]]
+        except Exception:
+            msg_type = cli_interface_client_server_protocol.DPS_MSG_ALL
+        c_struct = struct.pack(self.fmt, self.major_type, self.cli_code, msg_type)
+        ret = dcslib.process_cli_data(c_struct)
+        cli_interface.process_error(ret)
+#Add this class of command to global list of supported commands
+cli_cs_latency_show.add_cli()
+
+class cli_cs_latency_clear(cli_cs_clear):
+    '''
+    Represents the CLI Object for clearing the latency statistics in
+    the DPS Client Server Protocol
+    '''
+    #The Possible Unique Names that identify this command
+    #These will be the 1st parameter in the CLI command (20 chars max)
+    command_id = 'latency'
+    #Definition of the Command - Keep it short (40 chars)
+    command_def = 'Clear DPS Protocol Latency'
+    #Whether it's a hidden command
+    hidden = False
+    #Whether the command is only available in god mode
+    GodModeOnly = False
+    #This is MAJOR TYPE of the Command
+    major_type = cli_dps_interface.CLI_CLIENT_SERVER_PROTOCOL
+    #CLI CODE
+    cli_code = cli_interface_client_server_protocol.CLI_CLIENT_SERVER_LATENCY_CLEAR
+    #The Parameters of the rest of the command
+    #Each parameter must have ('Name', 'Type', 'Non-Optional?', 'Range' )
+    #All optional parameters MUST come after the required parameters
+    command_format = []
+    support_random = False
+    #Structure to send
+    # 2 Integers (MAJOR CODE, MINOR CODE)
+    fmt = 'II'
+    #This function 'execute' must exist for all CLI objects
+    def execute(self, session):
+        '''
+        @param session: The session context
+        @type session: Class login_context
+        '''
+        c_struct = struct.pack(self.fmt, self.major_type, self.cli_code)
+        ret = dcslib.process_cli_data(c_struct)
+        cli_interface.process_error(ret)
+#Add this class of command to global list of supported commands
+cli_cs_latency_clear.add_cli()
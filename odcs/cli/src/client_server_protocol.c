@@ -147,6 +147,39 @@ static dove_status retransmit_log_level(cli_client_server_protocol_t *cli_prot)
 	return DOVE_STATUS_OK;
 }
 
+/*
+ ******************************************************************************
+ * latency_show                                                           *//**
+ *
+ * \brief - Show the per Stage latency of the packets
+ *
+ * \return dove_status
+ *
+ ******************************************************************************
+ */
+static dove_status latency_show(cli_client_server_protocol_t *cli_prot)
+{
+	log_info(CliLogLevel,
+	         "Client Server Protocol, Packet Type %d",
+	         cli_prot->stats_type.pkt_type);
+	return dps_packet_latency_show(cli_prot->stats_type.pkt_type);
+}
+
+/*
+ ******************************************************************************
+ * latency_clear                                                          *//**
+ *
+ * \brief - Clear the per Stage latency of the packets
+ *
+ * \return dove_status
+ *
+ ******************************************************************************
+ */
+static dove_status latency_clear(cli_client_server_protocol_t *cli_prot)
+{
+	return dps_packet_latency_clear();
+}
+
 /*
  ******************************************************************************
  * cli_client_server_protocol_callback                                    *//**
@@ -205,6 +238,8 @@ dove_status cli_client_server_protocol_init(void)
 	cli_callback_array[CLI_CLIENT_SERVER_STATISTICS_CLEAR] = stastistics_clear;
 	cli_callback_array[CLI_CLIENT_RETRANSMIT_SHOW] = retransmit_show;
 	cli_callback_array[CLI_CLIENT_RETRANSMIT_LOG_LEVEL] = retransmit_log_level;
+	cli_callback_array[CLI_CLIENT_SERVER_LATENCY_SHOW] = latency_show;
+	cli_callback_array[CLI_CLIENT_SERVER_LATENCY_CLEAR] = latency_clear;
 
 	log_debug(CliLogLevel, "Exit");
 
@@ -0,0 +1,861 @@
+/*
+ * Copyright (c) 2010-2013 IBM Corporation
+ * All rights reserved.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License v1.0 which accompanies this
+ * distribution, and is available at http://www.eclipse.org/legal/epl-v10.html
+ *
+ *  Source File:
+ *      dps_codec_bench.c
+ *      Microbenchmark of the DPS Client Server Protocol wire codec
+ *
+ *  Abstract:
+ *      This program links dps_pkt_process.c on its own, without the PYTHON
+ *      runtime or the network, and measures the cost of encoding and
+ *      decoding every DPS message type for a range of payload shapes.
+ *
+ *      Encoding goes through dps_protocol_client_send() exactly like the
+ *      Data Handler does. dps_protocol_xmit() is replaced by a stub which
+ *      copies the packet aside (the copy stands in for the transmit batch
+ *      arena of the server). Decoding feeds the copied packet back into
+ *      dps_process_rcvd_pkt() and ends in a dps_protocol_send_to_server()
+ *      stub, in a General Ack, or in both. Heap allocations are
+ *      counted by wrapping malloc, calloc and realloc at link time, so only
+ *      allocations made by the codec itself are counted.
+ *
+ *      Usage: dps_codec_bench [-n iterations] [-t msg_type]
+ *
+ */
+
+#include "include.h"
+#include "raw_proto_timer.h"
+#include "dps_client_common.h"
+#include "dps_pkt.h"
+#include "dps_log.h"
+#include <time.h>
+
+const char *dps_msg_name(uint8_t);
+
+/*
+ ******************************************************************************
+ * Stubs for the rest of the DCS Server                                   *//**
+ *
+ ******************************************************************************
+ */
+
+int32_t DpsProtocolLogLevel = DPS_LOGLEVEL_EMERGENCY;
+uint32_t log_console = 0;
+
+/**
+ * \brief The last packet handed to dps_protocol_xmit
+ */
+static uint8_t bench_pkt[DPS_MAX_BUFF_SZ];
+static uint32_t bench_pkt_len;
+
+/**
+ * \brief Number of packets transmitted and messages delivered to the
+ *        Data Handler
+ */
+static unsigned long bench_xmit_count;
+static unsigned long bench_deliver_count;
+
+/**
+ * \brief Number of tunnels in the last Endpoint Update or Endpoint Location
+ *        Reply delivered to the Data Handler
+ */
+static uint32_t bench_deliver_tunnels;
+
+/**
+ * \brief The last Endpoint Location Request delivered to the Data Handler
+ */
+static dps_endpoint_loc_req_t bench_deliver_loc_req;
+
+/**
+ * \brief Number of heap allocations made by the codec
+ */
+static unsigned long bench_alloc_count;
+
+/**
+ * \brief The version of the last list built. Every case builds a different
+ *        list, so every case gets its own version like the DCS would.
+ */
+static uint32_t bench_list_version;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size)
+{
+	bench_alloc_count++;
+	return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size)
+{
+	bench_alloc_count++;
+	return __real_calloc(nmemb, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+	bench_alloc_count++;
+	return __real_realloc(ptr, size);
+}
+
+uint32_t dps_protocol_xmit(uint8_t *buff, uint32_t buff_len, ip_addr_t *addr, void *context)
+{
+	if (buff_len > sizeof(bench_pkt))
+	{
+		return DPS_ERROR;
+	}
+	memcpy(bench_pkt, buff, buff_len);
+	bench_pkt_len = buff_len;
+	bench_xmit_count++;
+	return DPS_SUCCESS;
+}
+
+dps_return_status dps_protocol_send_to_server(dps_client_data_t *client_data)
+{
+	bench_deliver_count++;
+	switch (client_data->hdr.type)
+	{
+		case DPS_ENDPOINT_UPDATE:
+			bench_deliver_tunnels = client_data->endpoint_update.tunnel_info.num_of_tunnels;
+			break;
+		case DPS_ENDPOINT_LOC_REPLY:
+			bench_deliver_tunnels = client_data->endpoint_loc_reply.tunnel_info.num_of_tunnels;
+			break;
+		case DPS_ENDPOINT_LOC_REQ:
+			bench_deliver_loc_req = client_data->endpoint_loc_req;
+			break;
+		default:
+			break;
+	}
+	return DPS_SUCCESS;
+}
+
+int dps_cluster_is_local_node_active(void)
+{
+	return 1;
+}
+
+int retransmit_timer_stop(uint32_t query_id, void **pcontext)
+{
+	*pcontext = NULL;
+	return 0;
+}
+
+dove_status dps_svr_batch_stats_show(void)
+{
+	return DOVE_STATUS_OK;
+}
+
+dove_status dps_svr_batch_stats_clear(void)
+{
+	return DOVE_STATUS_OK;
+}
+
+void _show_print(const char *fmt, ...)
+{
+	va_list ap;
+
+	va_start(ap, fmt);
+	vprintf(fmt, ap);
+	va_end(ap);
+	printf("\n");
+}
+
+/*
+ ******************************************************************************
+ * Message Builders                                                       *//**
+ *
+ ******************************************************************************
+ */
+
+/**
+ * \brief Room left after the dps_client_data_t for the variable length lists
+ */
+#define BENCH_MSG_EXTRA (DPS_MAX_BUFF_SZ * 2)
+
+/**
+ * \brief The most IPv4 and IPv6 tunnels a single packet carries, leaving room
+ *        for the headers and the other TLVs
+ */
+#define BENCH_MAX_TUNNELS_V4 ((DPS_MAX_BUFF_SZ - 256) / DPS_IP4_TUNNEL_INFO_LEN)
+#define BENCH_MAX_TUNNELS_V6 ((DPS_MAX_BUFF_SZ - 256) / DPS_IP6_TUNNEL_INFO_LEN)
+
+static void bench_ip_fill(ip_addr_t *ip, int family, uint32_t seed)
+{
+	int i;
+
+	ip->family = family;
+	ip->port = 12345;
+	if (family == AF_INET)
+	{
+		ip->ip4 = 0x0a000000 | (seed & 0xffffff);
+	}
+	else
+	{
+		for (i = 0; i < 16; i++)
+		{
+			ip->ip6[i] = (uint8_t)(seed + i);
+		}
+		ip->ip6[0] = 0xfd;
+	}
+}
+
+static void bench_endpoint_fill(dps_endpoint_info_t *endpoint, int family, uint32_t seed)
+{
+	endpoint->vnid = 1000 + seed;
+	endpoint->mac[0] = 0x02;
+	endpoint->mac[5] = (uint8_t)seed;
+	bench_ip_fill(&endpoint->vm_ip_addr, family, seed);
+}
+
+static void bench_tunnels_fill(dps_tunnel_list_t *tunnel_info, int family, uint32_t count)
+{
+	uint32_t i;
+
+	tunnel_info->num_of_tunnels = count;
+	for (i = 0; i < count; i++)
+	{
+		tunnel_info->tunnel_list[i].family = family;
+		tunnel_info->tunnel_list[i].port = 4789;
+		tunnel_info->tunnel_list[i].vnid = 1000;
+		tunnel_info->tunnel_list[i].tunnel_type = TUNNEL_TYPE_VXLAN;
+		if (family == AF_INET)
+		{
+			tunnel_info->tunnel_list[i].ip4 = 0xc0a80000 | i;
+		}
+		else
+		{
+			memset(tunnel_info->tunnel_list[i].ip6, 0, 16);
+			tunnel_info->tunnel_list[i].ip6[0] = 0xfd;
+			tunnel_info->tunnel_list[i].ip6[15] = (uint8_t)i;
+		}
+	}
+}
+
+static void bench_loc_reply_fill(dps_endpoint_loc_reply_t *reply, int family, uint32_t count)
+{
+	reply->vnid = 1000;
+	reply->mac[0] = 0x02;
+	reply->version = 1;
+	bench_ip_fill(&reply->vm_ip_addr, AF_INET, 1);
+	bench_tunnels_fill(&reply->tunnel_info, family, count);
+}
+
+static void bench_build_endpoint_loc_req(dps_client_data_t *msg, int family, uint32_t count)
+{
+	dps_endpoint_loc_req_t *req = &msg->endpoint_loc_req;
+
+	req->vnid = 1000;
+	req->mac[0] = 0x02;
+	bench_ip_fill(&req->vm_ip_addr, family, 1);
+	bench_ip_fill(&req->dps_client_addr, AF_INET, 2);
+}
+
+static void bench_build_endpoint_loc_reply(dps_client_data_t *msg, int family, uint32_t count)
+{
+	bench_loc_reply_fill(&msg->endpoint_loc_reply, family, count);
+}
+
+static void bench_build_policy_req(dps_client_data_t *msg, int family, uint32_t count)
+{
+	bench_endpoint_fill(&msg->policy_req.dst_endpoint, family, 1);
+	bench_endpoint_fill(&msg->policy_req.src_endpoint, family, 2);
+	bench_ip_fill(&msg->policy_req.dps_client_addr, AF_INET, 3);
+}
+
+static void bench_build_policy_reply(dps_client_data_t *msg, int family, uint32_t count)
+{
+	dps_policy_info_t *policy_info = &msg->policy_reply.dps_policy_info;
+
+	policy_info->policy_id = 1;
+	policy_info->version = 1;
+	policy_info->ttl = 3600;
+	policy_info->dps_policy.version = 1;
+	policy_info->dps_policy.policy_type = DPS_POLICY_TYPE_CONNECTIVITY;
+	// The rule array is not at the end of the structure so only one fits
+	policy_info->dps_policy.vnid_policy.num_permit_rules = 1;
+	policy_info->dps_policy.vnid_policy.src_dst_vnid[0].svnid = 1000;
+	policy_info->dps_policy.vnid_policy.src_dst_vnid[0].dvnid = 1001;
+	bench_loc_reply_fill(&msg->policy_reply.dst_endpoint_loc_reply, family, count);
+}
+
+static void bench_build_endpoint_update(dps_client_data_t *msg, int family, uint32_t count)
+{
+	dps_endpoint_update_t *update = &msg->endpoint_update;
+
+	update->vnid = 1000;
+	update->mac[0] = 0x02;
+	update->version = 1;
+	bench_ip_fill(&update->vm_ip_addr, AF_INET, 1);
+	bench_ip_fill(&update->dps_client_addr, AF_INET, 2);
+	bench_tunnels_fill(&update->tunnel_info, family, count);
+}
+
+static void bench_build_endpoint_update_reply(dps_client_data_t *msg, int family, uint32_t count)
+{
+	dps_endpoint_update_reply_t *reply = &msg->endpoint_update_reply;
+	uint32_t i;
+
+	reply->vnid = 1000;
+	reply->mac[0] = 0x02;
+	reply->version = 1;
+	reply->num_of_vip = (count > MAX_VIP_ADDR) ? MAX_VIP_ADDR : count;
+	for (i = 0; i < reply->num_of_vip; i++)
+	{
+		bench_ip_fill(&reply->vm_ip_addr[i], family, i);
+	}
+	bench_tunnels_fill(&reply->tunnel_info, AF_INET, 1);
+}
+
+static void bench_build_addr_resolve(dps_client_data_t *msg, int family, uint32_t count)
+{
+	dps_endpoint_loc_req_t *req = &msg->address_resolve;
+
+	req->vnid = 1000;
+	bench_ip_fill(&req->vm_ip_addr, family, 1);
+}
+
+static void bench_build_internal_gw_reply(dps_client_data_t *msg, int family, uint32_t count)
+{
+	dps_internal_gw_t *gw = &msg->internal_gw_list;
+	uint32_t i;
+
+	if (family == AF_INET)
+	{
+		gw->num_v4_gw = count;
+		for (i = 0; i < count; i++)
+		{
+			gw->gw_list[i] = 0xc0a80000 | i;
+		}
+	}
+	else
+	{
+		gw->num_v6_gw = count;
+		for (i = 0; i < count * 4; i++)
+		{
+			gw->gw_list[i] = 0xfd000000 | i;
+		}
+	}
+}
+
+static void bench_build_gen_msg_req(dps_client_data_t *msg, int family, uint32_t count)
+{
+	bench_ip_fill(&msg->gen_msg_req.dps_client_addr, family, 1);
+}
+
+static void bench_build_bcast_list_reply(dps_client_data_t *msg, int family, uint32_t count)
+{
+	dps_pkd_tunnel_list_t *list = &msg->dove_switch_list;
+	uint32_t i;
+
+	// The DCS sets the Broadcast Version, which keys the payload cache
+	msg->hdr.payload_version = ++bench_list_version;
+	list->vnid = 1000;
+	if (family == AF_INET)
+	{
+		list->num_v4_tunnels = count;
+		for (i = 0; i < count; i++)
+		{
+			list->tunnel_list[i] = 0xc0a80000 | i;
+		}
+	}
+	else
+	{
+		list->num_v6_tunnels = count;
+		for (i = 0; i < count * 4; i++)
+		{
+			list->tunnel_list[i] = 0xfd000000 | i;
+		}
+	}
+}
+
+static void bench_build_bcast_list_req_seq(dps_client_data_t *msg, int family, uint32_t count)
+{
+	bench_build_gen_msg_req(msg, family, count);
+	msg->hdr.sub_type = DPS_BCAST_LIST_SEQUENCED;
+	msg->gen_msg_req.bcast_seq_num = 100;
+}
+
+static void bench_build_bcast_list_delta(dps_client_data_t *msg, int family, uint32_t count)
+{
+	dps_bcast_list_delta_t *delta = &msg->dove_switch_delta;
+	uint32_t i;
+
+	msg->hdr.sub_type = DPS_BCAST_LIST_SEQUENCED;
+	delta->vnid = 1000;
+	delta->base_seq_num = 100;
+	delta->seq_num = delta->base_seq_num + (++bench_list_version);
+	if (family == AF_INET)
+	{
+		delta->num_v4_add = count;
+		delta->num_v4_del = 1;
+		for (i = 0; i < count + 1; i++)
+		{
+			delta->tunnel_list[i] = 0xc0a80000 | i;
+		}
+	}
+	else
+	{
+		delta->num_v6_add = count;
+		delta->num_v6_del = 1;
+		for (i = 0; i < (count + 1) * 4; i++)
+		{
+			delta->tunnel_list[i] = 0xfd000000 | i;
+		}
+	}
+}
+
+static void bench_build_bulk_policy(dps_client_data_t *msg, int family, uint32_t count)
+{
+	dps_bulk_vnid_policy_t *policy = &msg->bulk_vnid_policy;
+	uint32_t i;
+
+	policy->num_permit_rules = count - (count / 4);
+	policy->num_deny_rules = count / 4;
+	for (i = 0; i < count; i++)
+	{
+		policy->src_dst_vnid[i].svnid = 1000 + i;
+		policy->src_dst_vnid[i].dvnid = 2000 + i;
+	}
+}
+
+static void bench_build_tunnel_list(dps_client_data_t *msg, int family, uint32_t count)
+{
+	// The DCS sets the Gateway Version, which keys the payload cache
+	msg->hdr.payload_version = ++bench_list_version;
+	bench_tunnels_fill(&msg->tunnel_info, family, count);
+}
+
+static void bench_build_tunnel_reg(dps_client_data_t *msg, int family, uint32_t count)
+{
+	bench_ip_fill(&msg->tunnel_reg_dereg.dps_client_addr, AF_INET, 1);
+	bench_tunnels_fill(&msg->tunnel_reg_dereg.tunnel_info, family, count);
+}
+
+static void bench_build_vm_migration(dps_client_data_t *msg, int family, uint32_t count)
+{
+	bench_endpoint_fill(&msg->vm_migration_event.migrated_vm_info, AF_INET, 1);
+	bench_loc_reply_fill(&msg->vm_migration_event.src_vm_loc, family, count);
+}
+
+static void bench_build_replication_batch(dps_client_data_t *msg, int family, uint32_t count)
+{
+	dps_replication_batch_t *batch = &msg->replication_batch;
+	dps_endpoint_update_t *update;
+	uint32_t i;
+
+	msg->hdr.transaction_type = DPS_TRANSACTION_REPLICATION;
+	batch->channel_id = 0x1234;
+	batch->seq_num = 1;
+	batch->num_entries = count;
+	for (i = 0; i < count; i++)
+	{
+		batch->entries[i].vnid = 1000;
+		batch->entries[i].sub_type = DPS_ENDPOINT_UPDATE_ADD;
+		batch->entries[i].client_id = DPS_SWITCH_AGENT_ID;
+		update = &batch->entries[i].endpoint_update;
+		update->vnid = 1000;
+		update->mac[0] = 0x02;
+		update->mac[5] = (uint8_t)i;
+		update->version = 1;
+		bench_ip_fill(&update->vm_ip_addr, family, i + 1);
+		bench_ip_fill(&update->dps_client_addr, AF_INET, 2);
+		bench_tunnels_fill(&update->tunnel_info, family, 1);
+	}
+}
+
+static void bench_build_replication_ack(dps_client_data_t *msg, int family, uint32_t count)
+{
+	dps_replication_ack_t *ack = &msg->replication_ack;
+	uint32_t i;
+
+	ack->channel_id = 0x1234;
+	ack->ack_seq_num = 100;
+	ack->errors_seq_num = 100 - count;
+	ack->num_errors = count;
+	for (i = 0; i < count; i++)
+	{
+		ack->errors[i].seq_num = 100 - i;
+		ack->errors[i].index = (uint16_t)i;
+		ack->errors[i].status = DPS_ERROR_RETRY;
+	}
+}
+
+/**
+ * \brief A benchmark case: a message type with a payload shape
+ */
+typedef struct bench_case_s {
+	uint8_t type;
+	const char *shape;
+	void (*build)(dps_client_data_t *msg, int family, uint32_t count);
+	int family;
+	uint32_t count;
+} bench_case_t;
+
+static bench_case_t bench_cases[] = {
+	{DPS_ENDPOINT_LOC_REQ, "IPv4 VIP", bench_build_endpoint_loc_req, AF_INET, 0},
+	{DPS_ENDPOINT_LOC_REQ, "IPv6 VIP", bench_build_endpoint_loc_req, AF_INET6, 0},
+	{DPS_ENDPOINT_LOC_REPLY, "1 tunnel", bench_build_endpoint_loc_reply, AF_INET, 1},
+	{DPS_ENDPOINT_LOC_REPLY, "16 tunnels", bench_build_endpoint_loc_reply, AF_INET, 16},
+	{DPS_ENDPOINT_LOC_REPLY, "64 tunnels", bench_build_endpoint_loc_reply, AF_INET, 64},
+	{DPS_ENDPOINT_LOC_REPLY, "16 IPv6 tunnels", bench_build_endpoint_loc_reply, AF_INET6, 16},
+	{DPS_ENDPOINT_LOC_REPLY, "max tunnels", bench_build_endpoint_loc_reply, AF_INET, BENCH_MAX_TUNNELS_V4},
+	{DPS_ENDPOINT_LOC_REPLY, "max IPv6 tunnels", bench_build_endpoint_loc_reply, AF_INET6, BENCH_MAX_TUNNELS_V6},
+	{DPS_POLICY_REQ, "IPv4 VIPs", bench_build_policy_req, AF_INET, 0},
+	{DPS_POLICY_REQ, "IPv6 VIPs", bench_build_policy_req, AF_INET6, 0},
+	{DPS_POLICY_REPLY, "1 tunnel", bench_build_policy_reply, AF_INET, 1},
+	{DPS_POLICY_REPLY, "16 tunnels", bench_build_policy_reply, AF_INET, 16},
+	{DPS_ENDPOINT_UPDATE, "1 tunnel", bench_build_endpoint_update, AF_INET, 1},
+	{DPS_ENDPOINT_UPDATE, "16 tunnels", bench_build_endpoint_update, AF_INET, 16},
+	{DPS_ENDPOINT_UPDATE, "64 tunnels", bench_build_endpoint_update, AF_INET, 64},
+	{DPS_ENDPOINT_UPDATE, "max tunnels", bench_build_endpoint_update, AF_INET, BENCH_MAX_TUNNELS_V4},
+	{DPS_ENDPOINT_UPDATE, "max IPv6 tunnels", bench_build_endpoint_update, AF_INET6, BENCH_MAX_TUNNELS_V6},
+	{DPS_ENDPOINT_UPDATE_REPLY, "16 IPv4 VIPs", bench_build_endpoint_update_reply, AF_INET, 16},
+	{DPS_ENDPOINT_UPDATE_REPLY, "16 IPv6 VIPs", bench_build_endpoint_update_reply, AF_INET6, 16},
+	{DPS_ADDR_RESOLVE, "IPv4 VIP", bench_build_addr_resolve, AF_INET, 0},
+	{DPS_ADDR_RESOLVE, "IPv6 VIP", bench_build_addr_resolve, AF_INET6, 0},
+	{DPS_INTERNAL_GW_REQ, "", bench_build_gen_msg_req, AF_INET, 0},
+	{DPS_INTERNAL_GW_REPLY, "16 IPv4", bench_build_internal_gw_reply, AF_INET, 16},
+	{DPS_INTERNAL_GW_REPLY, "16 IPv6", bench_build_internal_gw_reply, AF_INET6, 16},
+	{DPS_BCAST_LIST_REQ, "", bench_build_gen_msg_req, AF_INET, 0},
+	{DPS_BCAST_LIST_REPLY, "1 IPv4", bench_build_bcast_list_reply, AF_INET, 1},
+	{DPS_BCAST_LIST_REPLY, "16 IPv4", bench_build_bcast_list_reply, AF_INET, 16},
+	{DPS_BCAST_LIST_REPLY, "64 IPv4", bench_build_bcast_list_reply, AF_INET, 64},
+	{DPS_BCAST_LIST_REPLY, "64 IPv6", bench_build_bcast_list_reply, AF_INET6, 64},
+	{DPS_BCAST_LIST_REQ, "sequenced", bench_build_bcast_list_req_seq, AF_INET, 0},
+	{DPS_UNSOLICITED_BCAST_LIST_REPLY, "64 IPv4", bench_build_bcast_list_reply, AF_INET, 64},
+	{DPS_UNSOLICITED_BCAST_LIST_REPLY, "+1 -1 IPv4", bench_build_bcast_list_delta, AF_INET, 1},
+	{DPS_UNSOLICITED_BCAST_LIST_REPLY, "+16 -1 IPv4", bench_build_bcast_list_delta, AF_INET, 16},
+	{DPS_UNSOLICITED_BCAST_LIST_REPLY, "+1 -1 IPv6", bench_build_bcast_list_delta, AF_INET6, 1},
+	{DPS_VM_MIGRATION_EVENT, "1 tunnel", bench_build_vm_migration, AF_INET, 1},
+	{DPS_TUNNEL_REGISTER, "1 tunnel", bench_build_tunnel_reg, AF_INET, 1},
+	{DPS_TUNNEL_REGISTER, "16 tunnels", bench_build_tunnel_reg, AF_INET, 16},
+	{DPS_TUNNEL_REGISTER, "64 tunnels", bench_build_tunnel_reg, AF_INET, 64},
+	{DPS_EXTERNAL_GW_LIST_REQ, "", bench_build_gen_msg_req, AF_INET, 0},
+	{DPS_EXTERNAL_GW_LIST_REPLY, "1 tunnel", bench_build_tunnel_list, AF_INET, 1},
+	{DPS_EXTERNAL_GW_LIST_REPLY, "16 tunnels", bench_build_tunnel_list, AF_INET, 16},
+	{DPS_EXTERNAL_GW_LIST_REPLY, "64 tunnels", bench_build_tunnel_list, AF_INET, 64},
+	{DPS_VLAN_GW_LIST_REPLY, "16 IPv6 tunnels", bench_build_tunnel_list, AF_INET6, 16},
+	{DPS_VNID_POLICY_LIST_REQ, "", bench_build_gen_msg_req, AF_INET, 0},
+	{DPS_VNID_POLICY_LIST_REPLY, "16 rules", bench_build_bulk_policy, AF_INET, 16},
+	{DPS_VNID_POLICY_LIST_REPLY, "256 rules", bench_build_bulk_policy, AF_INET, 256},
+	{DPS_UNSOLICITED_VNID_POLICY_LIST, "1024 rules", bench_build_bulk_policy, AF_INET, 1024},
+	{DPS_CTRL_PLANE_HB, "", bench_build_gen_msg_req, AF_INET, 0},
+	{DPS_REPLICATION_BATCH, "1 update", bench_build_replication_batch, AF_INET, 1},
+	{DPS_REPLICATION_BATCH, "12 updates", bench_build_replication_batch, AF_INET, DPS_REPLICATION_BATCH_MAX},
+	{DPS_REPLICATION_BATCH, "12 IPv6 updates", bench_build_replication_batch, AF_INET6, DPS_REPLICATION_BATCH_MAX},
+	{DPS_REPLICATION_BATCH_ACK, "", bench_build_replication_ack, AF_INET, 0},
+	{DPS_REPLICATION_BATCH_ACK, "16 errors", bench_build_replication_ack, AF_INET, DPS_REPLICATION_ACK_ERRORS_MAX},
+};
+
+/*
+ ******************************************************************************
+ * Measurement                                                            *//**
+ *
+ ******************************************************************************
+ */
+
+static uint64_t bench_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * \brief The result of timing one direction of one case
+ */
+typedef struct bench_result_s {
+	double ns_per_msg;
+	double msgs_per_sec;
+	double allocs_per_msg;
+	int ok;
+} bench_result_t;
+
+static void bench_result_set(bench_result_t *result, uint64_t elapsed_ns,
+                             unsigned long allocs, uint32_t iterations,
+                             int ok)
+{
+	result->ns_per_msg = (double)elapsed_ns / iterations;
+	result->msgs_per_sec = (elapsed_ns) ? (1e9 * iterations) / elapsed_ns : 0;
+	result->allocs_per_msg = (double)allocs / iterations;
+	result->ok = ok;
+}
+
+static void bench_encode(dps_client_data_t *msg, uint32_t iterations, bench_result_t *result)
+{
+	unsigned long allocs, xmits;
+	uint64_t start;
+	uint32_t i;
+
+	// Warm up the buffer pool and the payload cache
+	for (i = 0; i < 16; i++)
+	{
+		dps_protocol_client_send(msg);
+	}
+	allocs = bench_alloc_count;
+	xmits = bench_xmit_count;
+	start = bench_now_ns();
+	for (i = 0; i < iterations; i++)
+	{
+		dps_protocol_client_send(msg);
+	}
+	bench_result_set(result, bench_now_ns() - start,
+	                 bench_alloc_count - allocs, iterations,
+	                 (bench_xmit_count - xmits) == iterations);
+}
+
+static void bench_decode(uint8_t *pkt, uint32_t pkt_len, uint32_t iterations,
+                         bench_result_t *result)
+{
+	ip_addr_t sender;
+	unsigned long allocs, delivered, xmits;
+	uint64_t start;
+	uint32_t i;
+
+	memset(&sender, 0, sizeof(sender));
+	bench_ip_fill(&sender, AF_INET, 99);
+
+	for (i = 0; i < 16; i++)
+	{
+		dps_process_rcvd_pkt(pkt, pkt_len, &sender);
+	}
+	allocs = bench_alloc_count;
+	delivered = bench_deliver_count;
+	xmits = bench_xmit_count;
+	start = bench_now_ns();
+	for (i = 0; i < iterations; i++)
+	{
+		dps_process_rcvd_pkt(pkt, pkt_len, &sender);
+	}
+	bench_result_set(result, bench_now_ns() - start,
+	                 bench_alloc_count - allocs, iterations,
+	                 ((bench_deliver_count - delivered) == iterations) ||
+	                 ((bench_xmit_count - xmits) == iterations));
+}
+
+/*
+ ******************************************************************************
+ * bench_check_loc_req_mac                                                *//**
+ *
+ * \brief Checks that when an Endpoint Location Request carries both an EUID
+ *        and a VMAC TLV, the MAC of the TLV that comes last in the packet
+ *        is delivered to the Data Handler.
+ *
+ * \param[in] msg - Scratch message
+ * \param[in] pkt - Scratch buffer of DPS_MAX_BUFF_SZ bytes
+ *
+ * \return 1 if the MAC delivered is the expected one for both orders
+ *
+ ******************************************************************************
+ */
+static int bench_check_loc_req_mac(dps_client_data_t *msg, uint8_t *pkt)
+{
+	uint8_t vmac[DPS_MAC_ADDR_LEN] = {0x02, 0, 0, 0, 0, 0xaa};
+	dps_vmac_tlv_t vmac_tlv;
+	dps_pkt_hdr_t *pkt_hdr = (dps_pkt_hdr_t *)pkt;
+	ip_addr_t sender;
+	int vmac_last, ok = 1;
+
+	memset(&sender, 0, sizeof(sender));
+	bench_ip_fill(&sender, AF_INET, 99);
+	memset(&vmac_tlv, 0, sizeof(vmac_tlv));
+	vmac_tlv.tlv.s.ver = 1;
+	vmac_tlv.tlv.s.type = VMAC_TLV;
+	vmac_tlv.tlv.s.len = htons(DPS_VMAC_TLV_LEN - DPS_TLV_HDR_LEN);
+	memcpy(vmac_tlv.mac, vmac, DPS_MAC_ADDR_LEN);
+
+	memset(msg, 0, sizeof(dps_client_data_t));
+	msg->hdr.type = DPS_ENDPOINT_LOC_REQ;
+	msg->hdr.vnid = 1000;
+	msg->hdr.query_id = 1;
+	msg->hdr.client_id = DPS_SWITCH_AGENT_ID;
+	bench_build_endpoint_loc_req(msg, AF_INET, 0);
+	dps_protocol_client_send(msg);
+
+	for (vmac_last = 0; vmac_last < 2; vmac_last++)
+	{
+		// The encoder starts with the EUID, put the VMAC before or after it
+		memcpy(pkt, bench_pkt, DPS_PKT_HDR_LEN);
+		if (vmac_last)
+		{
+			memcpy(pkt + DPS_PKT_HDR_LEN, bench_pkt + DPS_PKT_HDR_LEN, DPS_EUID_TLV_LEN);
+			memcpy(pkt + DPS_PKT_HDR_LEN + DPS_EUID_TLV_LEN, &vmac_tlv, DPS_VMAC_TLV_LEN);
+		}
+		else
+		{
+			memcpy(pkt + DPS_PKT_HDR_LEN, &vmac_tlv, DPS_VMAC_TLV_LEN);
+			memcpy(pkt + DPS_PKT_HDR_LEN + DPS_VMAC_TLV_LEN, bench_pkt + DPS_PKT_HDR_LEN, DPS_EUID_TLV_LEN);
+		}
+		memcpy(pkt + DPS_PKT_HDR_LEN + DPS_EUID_TLV_LEN + DPS_VMAC_TLV_LEN,
+		       bench_pkt + DPS_PKT_HDR_LEN + DPS_EUID_TLV_LEN,
+		       bench_pkt_len - DPS_PKT_HDR_LEN - DPS_EUID_TLV_LEN);
+		pkt_hdr->len = htons(ntohs(pkt_hdr->len) + ((DPS_VMAC_TLV_LEN) >> 2));
+
+		memset(&bench_deliver_loc_req, 0, sizeof(bench_deliver_loc_req));
+		dps_process_rcvd_pkt(pkt, bench_pkt_len + DPS_VMAC_TLV_LEN, &sender);
+		if ((bench_deliver_loc_req.vnid != msg->endpoint_loc_req.vnid) ||
+		    memcmp(bench_deliver_loc_req.mac,
+		           vmac_last ? vmac : msg->endpoint_loc_req.mac,
+		           DPS_MAC_ADDR_LEN))
+		{
+			ok = 0;
+		}
+	}
+	return ok;
+}
+
+/*
+ ******************************************************************************
+ * bench_check_truncated                                                  *//**
+ *
+ * \brief Checks that a packet is dropped when the datagram is shorter than
+ *        the length stated in its header, even though the rest of the TLVs
+ *        are still in the (reused) receive buffer.
+ *
+ * \param[in] msg - Scratch message
+ * \param[in] pkt - Scratch buffer of DPS_MAX_BUFF_SZ bytes
+ *
+ * \return 1 if only the complete datagram is delivered
+ *
+ ******************************************************************************
+ */
+static int bench_check_truncated(dps_client_data_t *msg, uint8_t *pkt)
+{
+	ip_addr_t sender;
+	unsigned long delivered;
+	int ok = 1;
+
+	memset(&sender, 0, sizeof(sender));
+	bench_ip_fill(&sender, AF_INET, 99);
+
+	memset(msg, 0, sizeof(dps_client_data_t));
+	msg->hdr.type = DPS_ENDPOINT_LOC_REQ;
+	msg->hdr.vnid = 1000;
+	msg->hdr.query_id = 1;
+	msg->hdr.client_id = DPS_SWITCH_AGENT_ID;
+	bench_build_endpoint_loc_req(msg, AF_INET, 0);
+	dps_protocol_client_send(msg);
+	memcpy(pkt, bench_pkt, bench_pkt_len);
+
+	delivered = bench_deliver_count;
+	dps_process_rcvd_pkt(pkt, bench_pkt_len - 4, &sender);
+	dps_process_rcvd_pkt(pkt, DPS_PKT_HDR_LEN - 1, &sender);
+	if (bench_deliver_count != delivered)
+	{
+		ok = 0;
+	}
+	dps_process_rcvd_pkt(pkt, bench_pkt_len, &sender);
+	if (bench_deliver_count != delivered + 1)
+	{
+		ok = 0;
+	}
+	return ok;
+}
+
+static void bench_usage(const char *prog)
+{
+	fprintf(stderr, "Usage: %s [-n iterations] [-t msg_type]\n", prog);
+	exit(1);
+}
+
+int main(int argc, char **argv)
+{
+	dps_client_data_t *msg;
+	bench_result_t encode, decode;
+	uint8_t *pkt;
+	uint32_t iterations = 200000;
+	uint32_t pkt_len;
+	int only_type = -1;
+	int opt;
+	size_t i;
+
+	while ((opt = getopt(argc, argv, "n:t:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'n':
+				iterations = (uint32_t)strtoul(optarg, NULL, 0);
+				break;
+			case 't':
+				only_type = atoi(optarg);
+				break;
+			default:
+				bench_usage(argv[0]);
+		}
+	}
+	if (iterations == 0)
+	{
+		bench_usage(argv[0]);
+	}
+
+	msg = (dps_client_data_t *)__real_malloc(sizeof(dps_client_data_t) + BENCH_MSG_EXTRA);
+	pkt = (uint8_t *)__real_malloc(DPS_MAX_BUFF_SZ);
+	if ((msg == NULL) || (pkt == NULL))
+	{
+		fprintf(stderr, "No memory\n");
+		return 1;
+	}
+
+	printf("%u iterations per case\n\n", iterations);
+	printf("%-34s %-16s %6s | %10s %12s %8s | %10s %12s %8s\n",
+	       "Message Type", "Shape", "Bytes",
+	       "Enc ns/msg", "Enc msgs/s", "allocs",
+	       "Dec ns/msg", "Dec msgs/s", "allocs");
+
+	for (i = 0; i < sizeof(bench_cases)/sizeof(bench_cases[0]); i++)
+	{
+		if ((only_type >= 0) && (bench_cases[i].type != only_type))
+		{
+			continue;
+		}
+		memset(msg, 0, sizeof(dps_client_data_t) + BENCH_MSG_EXTRA);
+		msg->hdr.type = bench_cases[i].type;
+		msg->hdr.vnid = 1000;
+		msg->hdr.query_id = 1;
+		msg->hdr.client_id = DPS_SWITCH_AGENT_ID;
+		bench_ip_fill(&msg->hdr.reply_addr, AF_INET, 7);
+		bench_cases[i].build(msg, bench_cases[i].family, bench_cases[i].count);
+
+		bench_encode(msg, iterations, &encode);
+		// Decode the packet that was encoded last
+		pkt_len = bench_pkt_len;
+		memcpy(pkt, bench_pkt, pkt_len);
+		bench_deliver_tunnels = 0;
+		bench_decode(pkt, pkt_len, iterations, &decode);
+		// Every tunnel that was encoded must come out of the decoder
+		if (((bench_cases[i].type == DPS_ENDPOINT_UPDATE) ||
+		     (bench_cases[i].type == DPS_ENDPOINT_LOC_REPLY)) &&
+		    (bench_deliver_tunnels != bench_cases[i].count))
+		{
+			decode.ok = 0;
+		}
+
+		printf("%-34s %-16s %6u | %10.1f %12.0f %8.2f | %10.1f %12.0f %8.2f%s\n",
+		       dps_msg_name(bench_cases[i].type), bench_cases[i].shape, pkt_len,
+		       encode.ns_per_msg, encode.msgs_per_sec, encode.allocs_per_msg,
+		       decode.ns_per_msg, decode.msgs_per_sec, decode.allocs_per_msg,
+		       (encode.ok && decode.ok) ? "" : " FAILED");
+	}
+
+	if ((only_type < 0) || (only_type == DPS_ENDPOINT_LOC_REQ))
+	{
+		printf("\n%-34s %-16s%s\n", dps_msg_name(DPS_ENDPOINT_LOC_REQ),
+		       "EUID/VMAC order",
+		       bench_check_loc_req_mac(msg, pkt) ? "" : " FAILED");
+		printf("%-34s %-16s%s\n", dps_msg_name(DPS_ENDPOINT_LOC_REQ),
+		       "Truncated",
+		       bench_check_truncated(msg, pkt) ? "" : " FAILED");
+	}
+
+	free(pkt);
+	free(msg);
+	return 0;
+}
@@ -0,0 +1,889 @@
+/*
+ * Copyright (c) 2010-2013 IBM Corporation
+ * All rights reserved.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License v1.0 which accompanies this
+ * distribution, and is available at http://www.eclipse.org/legal/epl-v10.html
+ *
+ *  Source File:
+ *      dps_load_gen.c
+ *      Synthetic DPS Client load generator for DCS capacity testing
+ *
+ *  Abstract:
+ *      This program simulates a population of Dove Switch agents talking to
+ *      a DCS Server over the DPS Client Server Protocol. It is built from
+ *      the Client Part of the protocol (dps_client_ctrl.c, dps_pkt_process.c)
+ *      and sends every request through dps_protocol_client_send() exactly
+ *      like a Dove Switch does.
+ *
+ *      The program takes the role of the agent's retransmit timer module:
+ *      raw_proto_timer_start() records the time a request is sent and
+ *      raw_proto_timer_stop() computes its latency when the reply arrives.
+ *      Requests are never retransmitted, a request that is not answered
+ *      within the timeout is counted as lost.
+ *
+ *      The agents are spread over a number of UDP sockets so that the load
+ *      is hashed over all the DCS Server worker sockets. The run has two
+ *      phases:
+ *      1. Setup: every agent registers its tunnel endpoint and all its
+ *                endpoints.
+ *      2. Mix:   requests are sent at the target rate in the configured mix
+ *                for the configured duration.
+ *      At the end of each phase the p50/p99/p999 latency of every message
+ *      type and the achieved QPS are reported.
+ *
+ *      The VNIDs used by the agents must already exist on the DCS (they can
+ *      be created through the DCS CLI or the REST interface).
+ *
+ *      Usage: dps_load_gen [options], see dps_load_gen -h
+ *
+ */
+
+#include "dps_client_common.h"
+#include "dps_pkt.h"
+#include "dps_log.h"
+#include "raw_proto_timer.h"
+#include <poll.h>
+#include <getopt.h>
+
+const char *dps_msg_name(uint8_t);
+void dps_copy_saddr_laddr(struct sockaddr_storage *src, ip_addr_t *dst);
+
+extern dps_svr_addr_info_t dps_svr_addr_list[1];
+
+/*
+ ******************************************************************************
+ * Configuration                                                          *//**
+ *
+ ******************************************************************************
+ */
+
+/**
+ * \brief The maximum number of requests in flight. Must be a power of 2
+ */
+#define LG_PENDING_SZ            65536
+#define LG_MAX_SOCKETS           1024
+#define LG_MCAST_GROUPS          16
+#define LG_SWEEP_INTERVAL_NS     10000000ULL
+
+/**
+ * \brief The kinds of requests that make up the mix
+ */
+typedef enum {
+	LG_REQ_REGISTER = 0,
+	LG_REQ_UPDATE = 1,
+	LG_REQ_LOCATION = 2,
+	LG_REQ_POLICY = 3,
+	LG_REQ_MCAST = 4,
+	LG_REQ_MAX = 5
+} lg_req_kind;
+
+static const char *lg_req_names[LG_REQ_MAX] = {
+	"register", "update", "location", "policy", "mcast"
+};
+
+static struct {
+	ip_addr_t server;
+	uint32_t num_agents;
+	uint32_t num_sockets;
+	uint32_t endpoints_per_agent;
+	uint32_t vnid_base;
+	uint32_t num_vnids;
+	uint32_t qps;
+	uint32_t window;
+	uint32_t duration;
+	uint32_t timeout_ms;
+	uint32_t mix[LG_REQ_MAX];
+	uint32_t mix_total;
+	int skip_setup;
+} lg_cfg = {
+	.num_agents = 1000,
+	.num_sockets = 64,
+	.endpoints_per_agent = 4,
+	.vnid_base = 1,
+	.num_vnids = 1,
+	.qps = 0,
+	.window = 1024,
+	.duration = 10,
+	.timeout_ms = 1000,
+	.mix = {1, 10, 60, 25, 4},
+};
+
+/*
+ ******************************************************************************
+ * State                                                                  *//**
+ *
+ ******************************************************************************
+ */
+
+/**
+ * \brief A simulated Dove Switch agent
+ */
+typedef struct lg_agent_s {
+	uint32_t index;
+	uint32_t vnid;
+	uint32_t sock_index;
+	uint32_t tep_ip4;
+	uint32_t version;
+} lg_agent_t;
+
+/**
+ * \brief A request waiting for its reply
+ */
+typedef struct lg_pending_s {
+	uint64_t sent_ns;
+	void *context;
+	uint32_t query_id;
+	uint8_t type;
+	uint8_t inuse;
+} lg_pending_t;
+
+/**
+ * \brief Log-linear latency histogram: exact below 16ns, then 16 buckets
+ *        per power of 2 (about 6% precision)
+ */
+#define LG_HIST_BUCKETS          976
+
+/**
+ * \brief Statistics for one request message type
+ */
+typedef struct lg_type_stats_s {
+	uint64_t sent;
+	uint64_t replies;
+	uint64_t errors;
+	uint64_t lost;
+	uint64_t hist[LG_HIST_BUCKETS];
+} lg_type_stats_t;
+
+static lg_agent_t *lg_agents;
+static lg_pending_t lg_pending[LG_PENDING_SZ];
+static uint32_t lg_outstanding;
+static uint32_t lg_next_query_id = 1;
+static uint32_t lg_last_reply_type;
+static uint64_t lg_last_reply_ns;
+static lg_type_stats_t lg_stats[DPS_MAX_MSG_TYPE];
+static uint64_t lg_unsolicited;
+static uint64_t lg_send_failures;
+
+/**
+ * \brief The sockets the agents are spread over, and their receive callbacks
+ */
+static int lg_socks[LG_MAX_SOCKETS];
+static struct pollfd lg_pollfds[LG_MAX_SOCKETS];
+static poll_event_callback lg_poll_callbacks[LG_MAX_SOCKETS];
+static void *lg_poll_contexts[LG_MAX_SOCKETS];
+static uint32_t lg_num_pollfds;
+static int8_t lg_recv_buff[DPS_MAX_BUFF_SZ];
+
+static uint64_t lg_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ ******************************************************************************
+ * Latency Histogram                                                      *//**
+ *
+ ******************************************************************************
+ */
+
+static uint32_t lg_hist_bucket(uint64_t value)
+{
+	uint32_t msb;
+
+	if (value < 16)
+	{
+		return (uint32_t)value;
+	}
+	msb = 63 - __builtin_clzll(value);
+	return ((msb - 3) << 4) | (uint32_t)((value >> (msb - 4)) & 15);
+}
+
+static uint64_t lg_hist_value(uint32_t bucket)
+{
+	uint32_t msb;
+
+	if (bucket < 16)
+	{
+		return bucket;
+	}
+	msb = (bucket >> 4) + 3;
+	// The middle of the bucket
+	return ((uint64_t)(16 | (bucket & 15)) << (msb - 4)) + ((1ULL << (msb - 4)) >> 1);
+}
+
+static uint64_t lg_hist_percentile(uint64_t *hist, uint64_t count, double pct)
+{
+	uint64_t rank, seen = 0;
+	uint32_t i;
+
+	if (count == 0)
+	{
+		return 0;
+	}
+	rank = (uint64_t)(pct * count);
+	if (rank >= count)
+	{
+		rank = count - 1;
+	}
+	for (i = 0; i < LG_HIST_BUCKETS; i++)
+	{
+		seen += hist[i];
+		if (seen > rank)
+		{
+			return lg_hist_value(i);
+		}
+	}
+	return lg_hist_value(LG_HIST_BUCKETS - 1);
+}
+
+/*
+ ******************************************************************************
+ * DPS Client Agent Hooks                                                 *//**
+ *
+ * \brief The functions a Dove Switch agent provides to the Client Part of
+ *        the DPS Client Server Protocol.
+ *
+ ******************************************************************************
+ */
+
+int fd_process_add_fd(int fd, poll_event_callback callback, void *context)
+{
+	if (lg_num_pollfds >= LG_MAX_SOCKETS)
+	{
+		return -1;
+	}
+	lg_pollfds[lg_num_pollfds].fd = fd;
+	lg_pollfds[lg_num_pollfds].events = POLLIN;
+	lg_poll_callbacks[lg_num_pollfds] = callback;
+	lg_poll_contexts[lg_num_pollfds] = context;
+	lg_num_pollfds++;
+	return 0;
+}
+
+raw_proto_timer_return_status_t
+raw_proto_timer_init(rpt_callback_ptr callback, rpt_owner_t owner)
+{
+	return RAW_PROTO_TIMER_RETURN_OK;
+}
+
+unsigned int raw_proto_query_id_generate(void)
+{
+	if (lg_next_query_id == 0)
+	{
+		lg_next_query_id = 1;
+	}
+	return lg_next_query_id++;
+}
+
+int raw_proto_timer_start(char *rawPkt, int rawPktLen, int rawPktId,
+                          int retransmitInterval, int maxNumRetransmit,
+                          int sockFd, struct sockaddr *addr,
+                          void *context, rpt_owner_t owner)
+{
+	lg_pending_t *pending = &lg_pending[(uint32_t)rawPktId & (LG_PENDING_SZ - 1)];
+	dps_client_hdr_t hdr;
+
+	if (pending->inuse)
+	{
+		// A lost request that has not timed out yet, the query IDs wrapped
+		lg_stats[pending->type].lost++;
+		lg_outstanding--;
+	}
+	dps_get_pkt_hdr((dps_pkt_hdr_t *)rawPkt, &hdr);
+	pending->query_id = (uint32_t)rawPktId;
+	pending->type = hdr.type;
+	pending->context = context;
+	pending->inuse = 1;
+	lg_outstanding++;
+	lg_stats[hdr.type].sent++;
+	// Taken last so that the encoding cost is not counted
+	pending->sent_ns = lg_now_ns();
+	return RAW_PROTO_TIMER_RETURN_OK;
+}
+
+raw_proto_timer_return_status_t
+raw_proto_timer_stop(int rawPktId, void **context, rpt_owner_t *owner)
+{
+	lg_pending_t *pending = &lg_pending[(uint32_t)rawPktId & (LG_PENDING_SZ - 1)];
+	lg_type_stats_t *stats;
+
+	if ((!pending->inuse) || (pending->query_id != (uint32_t)rawPktId))
+	{
+		return RAW_PROTO_TIMER_RETURN_INVALID_ARG;
+	}
+	stats = &lg_stats[pending->type];
+	lg_last_reply_ns = lg_now_ns();
+	stats->replies++;
+	stats->hist[lg_hist_bucket(lg_last_reply_ns - pending->sent_ns)]++;
+	lg_last_reply_type = pending->type;
+	*context = pending->context;
+	*owner = RPT_OWNER_DPSA;
+	pending->inuse = 0;
+	lg_outstanding--;
+	return RAW_PROTO_TIMER_RETURN_OK;
+}
+
+void dps_protocol_send_to_client(dps_client_data_t *msg)
+{
+	if (msg->context == NULL)
+	{
+		// Unsolicited messages, General Acks of expired requests and
+		// DPS_GET_DCS_NODE requests
+		if (msg->hdr.type == DPS_GET_DCS_NODE)
+		{
+			lg_send_failures++;
+		}
+		else
+		{
+			lg_unsolicited++;
+		}
+		return;
+	}
+	if (msg->hdr.resp_status != DPS_NO_ERR)
+	{
+		lg_stats[lg_last_reply_type].errors++;
+	}
+}
+
+/*
+ ******************************************************************************
+ * Sockets                                                                *//**
+ *
+ ******************************************************************************
+ */
+
+static int lg_sock_rcvd(int socket, void *context)
+{
+	struct sockaddr_storage sender;
+	socklen_t addr_len;
+	ip_addr_t sender_addr;
+	int bytes_read;
+	int loops;
+
+	for (loops = 0; loops < 10000; loops++)
+	{
+		addr_len = sizeof(sender);
+		bytes_read = recvfrom(socket, lg_recv_buff, sizeof(lg_recv_buff), 0,
+		                      (struct sockaddr *)&sender, &addr_len);
+		if (bytes_read <= 0)
+		{
+			break;
+		}
+		dps_copy_saddr_laddr(&sender, &sender_addr);
+		dps_process_rcvd_pkt((void *)lg_recv_buff, (uint32_t)bytes_read,
+		                     (void *)&sender_addr);
+	}
+	return DPS_SUCCESS;
+}
+
+static int lg_sockets_open(void)
+{
+	int bufsz = 4 * 1024 * 1024;
+	uint32_t i;
+	int fd;
+
+	if (dps_client_init() != DPS_SUCCESS)
+	{
+		fprintf(stderr, "dps_client_init failed\n");
+		return -1;
+	}
+	// The first socket is the one the DPS Client opens itself
+	if (dps_server_add(0, &lg_cfg.server) != DPS_SUCCESS)
+	{
+		fprintf(stderr, "dps_server_add failed\n");
+		return -1;
+	}
+	lg_socks[0] = dps_svr_addr_list[0].sock_fd;
+	for (i = 0; i < lg_cfg.num_sockets; i++)
+	{
+		if (i == 0)
+		{
+			fd = lg_socks[0];
+		}
+		else
+		{
+			fd = socket(lg_cfg.server.family, SOCK_DGRAM, 0);
+			if (fd < 0)
+			{
+				perror("socket");
+				return -1;
+			}
+			if (fcntl(fd, F_SETFL, O_NONBLOCK) == -1)
+			{
+				perror("fcntl");
+				return -1;
+			}
+			if (fd_process_add_fd(fd, lg_sock_rcvd, NULL) != 0)
+			{
+				fprintf(stderr, "Too many sockets\n");
+				return -1;
+			}
+			lg_socks[i] = fd;
+		}
+		setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &bufsz, sizeof(bufsz));
+		setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &bufsz, sizeof(bufsz));
+	}
+	return 0;
+}
+
+static void lg_poll(int timeout_ms)
+{
+	uint32_t i;
+	int ready;
+
+	ready = poll(lg_pollfds, lg_num_pollfds, timeout_ms);
+	for (i = 0; (ready > 0) && (i < lg_num_pollfds); i++)
+	{
+		if (lg_pollfds[i].revents & POLLIN)
+		{
+			lg_poll_callbacks[i](lg_pollfds[i].fd, lg_poll_contexts[i]);
+			ready--;
+		}
+	}
+}
+
+/**
+ * \brief Count the requests that were not answered within the timeout as
+ *        lost and forget them
+ */
+static void lg_sweep(void)
+{
+	uint64_t timeout_ns = (uint64_t)lg_cfg.timeout_ms * 1000000ULL;
+	uint64_t now = lg_now_ns();
+	uint32_t i;
+
+	for (i = 0; (lg_outstanding > 0) && (i < LG_PENDING_SZ); i++)
+	{
+		if (lg_pending[i].inuse && ((now - lg_pending[i].sent_ns) > timeout_ns))
+		{
+			lg_stats[lg_pending[i].type].lost++;
+			lg_pending[i].inuse = 0;
+			lg_outstanding--;
+		}
+	}
+}
+
+/*
+ ******************************************************************************
+ * Request Builders                                                       *//**
+ *
+ ******************************************************************************
+ */
+
+/**
+ * \brief The endpoints of an agent: the global endpoint number is used to
+ *        derive a unique vMAC and vIP (10.0.0.0/8)
+ */
+static void lg_endpoint_info(lg_agent_t *agent, uint32_t endpoint, dps_endpoint_info_t *info)
+{
+	uint32_t global = (agent->index * lg_cfg.endpoints_per_agent) + endpoint;
+
+	memset(info, 0, sizeof(*info));
+	info->vnid = agent->vnid;
+	info->mac[0] = 0x02;
+	info->mac[1] = 0x4c;
+	info->mac[2] = (uint8_t)(global >> 24);
+	info->mac[3] = (uint8_t)(global >> 16);
+	info->mac[4] = (uint8_t)(global >> 8);
+	info->mac[5] = (uint8_t)global;
+	info->vm_ip_addr.family = AF_INET;
+	info->vm_ip_addr.ip4 = 0x0a000000 | ((global + 1) & 0x00ffffff);
+}
+
+static void lg_tep_fill(lg_agent_t *agent, dps_tunnel_list_t *tunnel_info)
+{
+	tunnel_info->num_of_tunnels = 1;
+	tunnel_info->tunnel_list[0].family = AF_INET;
+	tunnel_info->tunnel_list[0].port = 0;
+	tunnel_info->tunnel_list[0].vnid = agent->vnid;
+	tunnel_info->tunnel_list[0].tunnel_type = TUNNEL_TYPE_VXLAN;
+	tunnel_info->tunnel_list[0].ip4 = agent->tep_ip4;
+}
+
+/**
+ * \brief A random agent in the same VNID as agent
+ */
+static lg_agent_t *lg_peer_agent(lg_agent_t *agent)
+{
+	uint32_t per_vnid = lg_cfg.num_agents / lg_cfg.num_vnids;
+	uint32_t slot = (per_vnid) ? (uint32_t)random() % per_vnid : 0;
+
+	return &lg_agents[(agent->index % lg_cfg.num_vnids) + (slot * lg_cfg.num_vnids)];
+}
+
+static void lg_build(dps_client_data_t *msg, lg_agent_t *agent, lg_req_kind kind, uint32_t endpoint)
+{
+	dps_endpoint_info_t info;
+	uint32_t group;
+
+	memset(msg, 0, sizeof(*msg));
+	msg->context = (void *)agent;
+	msg->hdr.vnid = agent->vnid;
+	msg->hdr.client_id = DPS_SWITCH_AGENT_ID;
+
+	switch(kind)
+	{
+		case LG_REQ_REGISTER:
+			msg->hdr.type = DPS_TUNNEL_REGISTER;
+			lg_tep_fill(agent, &msg->tunnel_reg_dereg.tunnel_info);
+			break;
+		case LG_REQ_UPDATE:
+			msg->hdr.type = DPS_ENDPOINT_UPDATE;
+			msg->hdr.sub_type = DPS_ENDPOINT_UPDATE_ADD;
+			lg_endpoint_info(agent, endpoint, &info);
+			msg->endpoint_update.vnid = info.vnid;
+			memcpy(msg->endpoint_update.mac, info.mac, 6);
+			msg->endpoint_update.vm_ip_addr = info.vm_ip_addr;
+			msg->endpoint_update.version = ++agent->version;
+			lg_tep_fill(agent, &msg->endpoint_update.tunnel_info);
+			break;
+		case LG_REQ_LOCATION:
+			msg->hdr.type = DPS_ENDPOINT_LOC_REQ;
+			lg_endpoint_info(lg_peer_agent(agent), endpoint, &info);
+			msg->endpoint_loc_req.vnid = info.vnid;
+			msg->endpoint_loc_req.vm_ip_addr = info.vm_ip_addr;
+			break;
+		case LG_REQ_POLICY:
+			msg->hdr.type = DPS_POLICY_REQ;
+			lg_endpoint_info(agent, endpoint, &msg->policy_req.src_endpoint);
+			lg_endpoint_info(lg_peer_agent(agent),
+			                 (uint32_t)random() % lg_cfg.endpoints_per_agent,
+			                 &msg->policy_req.dst_endpoint);
+			break;
+		case LG_REQ_MCAST:
+			msg->hdr.type = DPS_MCAST_RECEIVER_JOIN;
+			group = (uint32_t)random() % LG_MCAST_GROUPS;
+			msg->mcast_receiver.tunnel_endpoint.family = AF_INET;
+			msg->mcast_receiver.tunnel_endpoint.ip4 = agent->tep_ip4;
+			msg->mcast_receiver.mcast_group_rec.mcast_addr.mcast_addr_type = MCAST_ADDR_V4;
+			msg->mcast_receiver.mcast_group_rec.mcast_addr.u.mcast_ip4 = 0xef010000 | group;
+			msg->mcast_receiver.mcast_group_rec.mcast_addr.mcast_mac[0] = 0x01;
+			msg->mcast_receiver.mcast_group_rec.mcast_addr.mcast_mac[2] = 0x5e;
+			msg->mcast_receiver.mcast_group_rec.mcast_addr.mcast_mac[3] = 0x01;
+			msg->mcast_receiver.mcast_group_rec.mcast_addr.mcast_mac[5] = (uint8_t)group;
+			msg->mcast_receiver.mcast_group_rec.family = AF_INET;
+			break;
+		default:
+			break;
+	}
+}
+
+static void lg_send(lg_agent_t *agent, lg_req_kind kind, uint32_t endpoint)
+{
+	dps_client_data_t msg;
+
+	lg_build(&msg, agent, kind, endpoint);
+	// The DPS Client sends on the socket of its single DPS Server entry
+	dps_svr_addr_list[0].sock_fd = lg_socks[agent->sock_index];
+	if (dps_protocol_client_send(&msg) != DPS_SUCCESS)
+	{
+		lg_send_failures++;
+	}
+}
+
+static lg_req_kind lg_mix_pick(void)
+{
+	uint32_t pick = (uint32_t)random() % lg_cfg.mix_total;
+	uint32_t i;
+
+	for (i = 0; i < LG_REQ_MAX - 1; i++)
+	{
+		if (pick < lg_cfg.mix[i])
+		{
+			break;
+		}
+		pick -= lg_cfg.mix[i];
+	}
+	return (lg_req_kind)i;
+}
+
+/*
+ ******************************************************************************
+ * Phases                                                                 *//**
+ *
+ ******************************************************************************
+ */
+
+static void lg_stats_clear(void)
+{
+	memset(lg_stats, 0, sizeof(lg_stats));
+	lg_unsolicited = 0;
+	lg_send_failures = 0;
+}
+
+static void lg_stats_show(const char *phase, uint64_t elapsed_ns)
+{
+	lg_type_stats_t *stats;
+	uint64_t replies = 0, sent = 0;
+	double secs = (double)elapsed_ns / 1e9;
+	uint32_t i;
+
+	printf("\n%s phase: %.2f seconds\n", phase, secs);
+	printf("%-24s %10s %10s %8s %8s %10s %10s %10s %10s\n",
+	       "Message Type", "Sent", "Replies", "Errors", "Lost",
+	       "QPS", "p50 us", "p99 us", "p999 us");
+	for (i = 0; i < DPS_MAX_MSG_TYPE; i++)
+	{
+		stats = &lg_stats[i];
+		if (stats->sent == 0)
+		{
+			continue;
+		}
+		printf("%-24s %10lu %10lu %8lu %8lu %10.0f %10.1f %10.1f %10.1f\n",
+		       dps_msg_name(i), stats->sent, stats->replies, stats->errors,
+		       stats->lost, (secs > 0) ? stats->replies / secs : 0,
+		       lg_hist_percentile(stats->hist, stats->replies, 0.50) / 1000.0,
+		       lg_hist_percentile(stats->hist, stats->replies, 0.99) / 1000.0,
+		       lg_hist_percentile(stats->hist, stats->replies, 0.999) / 1000.0);
+		sent += stats->sent;
+		replies += stats->replies;
+	}
+	printf("%-24s %10lu %10lu %8s %8s %10.0f\n", "Total", sent, replies, "", "",
+	       (secs > 0) ? replies / secs : 0);
+	printf("Unsolicited messages %lu, send failures %lu\n",
+	       lg_unsolicited, lg_send_failures);
+}
+
+/**
+ * \brief Wait for the requests in flight to be answered or to time out
+ */
+static void lg_drain(void)
+{
+	uint64_t now, last_sweep = 0;
+
+	while (lg_outstanding > 0)
+	{
+		lg_poll(1);
+		now = lg_now_ns();
+		if (now - last_sweep > LG_SWEEP_INTERVAL_NS)
+		{
+			lg_sweep();
+			last_sweep = now;
+		}
+	}
+}
+
+/**
+ * \brief Run a phase. When total is 0 the phase runs for the configured
+ *        duration, otherwise until total requests have been sent.
+ */
+static void lg_run(const char *phase, uint64_t total, int setup)
+{
+	uint64_t start, now, last_sweep, allowed, sent = 0;
+	uint64_t duration_ns = (uint64_t)lg_cfg.duration * 1000000000ULL;
+	uint32_t per_agent = 1 + lg_cfg.endpoints_per_agent;
+	lg_agent_t *agent;
+
+	lg_stats_clear();
+	start = last_sweep = lg_now_ns();
+	while (1)
+	{
+		now = lg_now_ns();
+		if (total ? (sent >= total) : ((now - start) >= duration_ns))
+		{
+			break;
+		}
+		allowed = (lg_cfg.qps) ? ((now - start) * lg_cfg.qps) / 1000000000ULL : ~0ULL;
+		while ((sent < allowed) && (lg_outstanding < lg_cfg.window) &&
+		       ((total == 0) || (sent < total)))
+		{
+			if (setup)
+			{
+				// Register each agent first then its endpoints
+				agent = &lg_agents[sent / per_agent];
+				if ((sent % per_agent) == 0)
+				{
+					lg_send(agent, LG_REQ_REGISTER, 0);
+				}
+				else
+				{
+					lg_send(agent, LG_REQ_UPDATE, (sent % per_agent) - 1);
+				}
+			}
+			else
+			{
+				agent = &lg_agents[(uint32_t)random() % lg_cfg.num_agents];
+				lg_send(agent, lg_mix_pick(),
+				        (uint32_t)random() % lg_cfg.endpoints_per_agent);
+			}
+			sent++;
+		}
+		lg_poll((lg_outstanding < lg_cfg.window) ? 0 : 1);
+		if (now - last_sweep > LG_SWEEP_INTERVAL_NS)
+		{
+			lg_sweep();
+			last_sweep = now;
+		}
+	}
+	lg_drain();
+	// The QPS is measured up to the last reply, not the end of the timeout
+	lg_stats_show(phase, ((lg_last_reply_ns > now) ? lg_last_reply_ns : now) - start);
+}
+
+/*
+ ******************************************************************************
+ * Main                                                                   *//**
+ *
+ ******************************************************************************
+ */
+
+static void lg_usage(const char *prog)
+{
+	fprintf(stderr,
+	        "Usage: %s [options]\n"
+	        "  -s <ip>      DCS Server address (default 127.0.0.1)\n"
+	        "  -p <port>    DCS Server UDP port (default 12345)\n"
+	        "  -a <num>     Number of simulated agents (default %u)\n"
+	        "  -S <num>     Number of UDP sockets the agents are spread over (default %u)\n"
+	        "  -e <num>     Endpoints per agent (default %u)\n"
+	        "  -v <vnid>    First VNID (default %u)\n"
+	        "  -V <num>     Number of VNIDs the agents are spread over (default %u)\n"
+	        "  -q <qps>     Target requests per second, 0 for as fast as possible (default %u)\n"
+	        "  -w <num>     Maximum requests in flight (default %u)\n"
+	        "  -d <secs>    Duration of the mix phase (default %u)\n"
+	        "  -t <ms>      Reply timeout (default %u)\n"
+	        "  -m <mix>     Request mix, e.g. register=1,update=10,location=60,policy=25,mcast=4\n"
+	        "  -n           Skip the setup phase\n",
+	        prog, lg_cfg.num_agents, lg_cfg.num_sockets, lg_cfg.endpoints_per_agent,
+	        lg_cfg.vnid_base, lg_cfg.num_vnids, lg_cfg.qps, lg_cfg.window,
+	        lg_cfg.duration, lg_cfg.timeout_ms);
+	exit(1);
+}
+
+static int lg_mix_parse(char *spec)
+{
+	char *token, *value, *saveptr = NULL;
+	uint32_t i;
+
+	memset(lg_cfg.mix, 0, sizeof(lg_cfg.mix));
+	for (token = strtok_r(spec, ",", &saveptr); token != NULL;
+	     token = strtok_r(NULL, ",", &saveptr))
+	{
+		value = strchr(token, '=');
+		if (value == NULL)
+		{
+			return -1;
+		}
+		*value++ = '\0';
+		for (i = 0; i < LG_REQ_MAX; i++)
+		{
+			if (strcmp(token, lg_req_names[i]) == 0)
+			{
+				lg_cfg.mix[i] = (uint32_t)strtoul(value, NULL, 0);
+				break;
+			}
+		}
+		if (i == LG_REQ_MAX)
+		{
+			return -1;
+		}
+	}
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	const char *server = "127.0.0.1";
+	uint32_t port = 12345;
+	uint32_t i;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "s:p:a:S:e:v:V:q:w:d:t:m:nh")) != -1)
+	{
+		switch (opt)
+		{
+			case 's': server = optarg; break;
+			case 'p': port = (uint32_t)strtoul(optarg, NULL, 0); break;
+			case 'a': lg_cfg.num_agents = (uint32_t)strtoul(optarg, NULL, 0); break;
+			case 'S': lg_cfg.num_sockets = (uint32_t)strtoul(optarg, NULL, 0); break;
+			case 'e': lg_cfg.endpoints_per_agent = (uint32_t)strtoul(optarg, NULL, 0); break;
+			case 'v': lg_cfg.vnid_base = (uint32_t)strtoul(optarg, NULL, 0); break;
+			case 'V': lg_cfg.num_vnids = (uint32_t)strtoul(optarg, NULL, 0); break;
+			case 'q': lg_cfg.qps = (uint32_t)strtoul(optarg, NULL, 0); break;
+			case 'w': lg_cfg.window = (uint32_t)strtoul(optarg, NULL, 0); break;
+			case 'd': lg_cfg.duration = (uint32_t)strtoul(optarg, NULL, 0); break;
+			case 't': lg_cfg.timeout_ms = (uint32_t)strtoul(optarg, NULL, 0); break;
+			case 'm':
+				if (lg_mix_parse(optarg) != 0)
+				{
+					lg_usage(argv[0]);
+				}
+				break;
+			case 'n': lg_cfg.skip_setup = 1; break;
+			default: lg_usage(argv[0]);
+		}
+	}
+	for (i = 0; i < LG_REQ_MAX; i++)
+	{
+		lg_cfg.mix_total += lg_cfg.mix[i];
+	}
+	if ((lg_cfg.num_agents == 0) || (lg_cfg.num_vnids == 0) ||
+	    (lg_cfg.num_sockets == 0) || (lg_cfg.num_sockets > LG_MAX_SOCKETS) ||
+	    (lg_cfg.endpoints_per_agent == 0) || (lg_cfg.mix_total == 0) ||
+	    (lg_cfg.window == 0) || (lg_cfg.window >= LG_PENDING_SZ))
+	{
+		lg_usage(argv[0]);
+	}
+
+	memset(&lg_cfg.server, 0, sizeof(lg_cfg.server));
+	lg_cfg.server.port = (uint16_t)port;
+	lg_cfg.server.xport_type = SOCK_DGRAM;
+	if (inet_pton(AF_INET, server, &lg_cfg.server.ip4) == 1)
+	{
+		lg_cfg.server.family = AF_INET;
+		lg_cfg.server.ip4 = ntohl(lg_cfg.server.ip4);
+	}
+	else if (inet_pton(AF_INET6, server, lg_cfg.server.ip6) == 1)
+	{
+		lg_cfg.server.family = AF_INET6;
+	}
+	else
+	{
+		lg_usage(argv[0]);
+	}
+
+	DpsProtocolLogLevel = DPS_LOGLEVEL_EMERGENCY;
+	lg_agents = (lg_agent_t *)calloc(lg_cfg.num_agents, sizeof(lg_agent_t));
+	if (lg_agents == NULL)
+	{
+		fprintf(stderr, "No memory\n");
+		return 1;
+	}
+	for (i = 0; i < lg_cfg.num_agents; i++)
+	{
+		lg_agents[i].index = i;
+		lg_agents[i].vnid = lg_cfg.vnid_base + (i % lg_cfg.num_vnids);
+		lg_agents[i].sock_index = i % lg_cfg.num_sockets;
+		// Tunnel Endpoints in 172.16.0.0/12
+		lg_agents[i].tep_ip4 = 0xac100000 | ((i + 1) & 0x000fffff);
+	}
+	if (lg_sockets_open() != 0)
+	{
+		return 1;
+	}
+	srandom((unsigned int)lg_now_ns());
+
+	printf("%u agents, %u endpoints each, %u VNIDs from %u, %u sockets, window %u, %s QPS\n",
+	       lg_cfg.num_agents, lg_cfg.endpoints_per_agent, lg_cfg.num_vnids,
+	       lg_cfg.vnid_base, lg_cfg.num_sockets, lg_cfg.window,
+	       (lg_cfg.qps) ? "target" : "unlimited");
+	if (!lg_cfg.skip_setup)
+	{
+		lg_run("Setup", (uint64_t)lg_cfg.num_agents * (1 + lg_cfg.endpoints_per_agent), 1);
+	}
+	printf("\nMix:");
+	for (i = 0; i < LG_REQ_MAX; i++)
+	{
+		printf(" %s=%u", lg_req_names[i], lg_cfg.mix[i]);
+	}
+	printf("\n");
+	lg_run("Mix", 0, 0);
+
+	free(lg_agents);
+	return 0;
+}
@@ -129,6 +129,8 @@ typedef enum {
 	DPS_CTRL_PLANE_HB = 39,                 // Heart Beat sent from the DCS node to Dove Switches
 	DPS_GET_DCS_NODE = 40,                  // Used to request a new DCS node ip address. Never seen on the wire. 
 	DPS_UNSOLICITED_VM_LOC_INFO = 41,       // Invalidate the VM.This msg is sent by DCS in response to a VM migration
+	DPS_REPLICATION_BATCH = 42,             // Sequenced batch of Endpoint Updates replicated between DCS Servers
+	DPS_REPLICATION_BATCH_ACK = 43,         // Cumulative ACK of DPS_REPLICATION_BATCH between DCS Servers
 	DPS_MAX_MSG_TYPE                       // This MUST be the Final Message Type
 } dps_client_req_type;
 
@@ -452,6 +454,14 @@ typedef struct dps_client_hdr {
 	 *        DPS Server should set this field for replication AND forwarding.
 	 */
 	ip_addr_t reply_addr;
+	/**
+	 * \brief DPS Clients MUST set this to 0. Not sent on the wire.
+	 *        DPS Server sets this on Broadcast List and Gateway List replies
+	 *        to the version of the list: Replies of the same type for the
+	 *        same VNID with the same non-zero version carry the same list.
+	 *        0 if the version is not known.
+	 */
+	uint32_t payload_version;
 } dps_client_hdr_t;
 
 typedef struct dps_endpoint_loc_req_s {
@@ -814,9 +824,28 @@ typedef struct dps_gen_msg_req_t {
 	 *        DPS Clients MUST NOT set this value i.e. family should be 0
 	 */
 	ip_addr_t dps_client_addr;
+	/**
+	 * \brief Only used by DPS_BCAST_LIST_REQ with sub_type
+	 *        DPS_BCAST_LIST_SEQUENCED: The sequence number of the
+	 *        broadcast list the DPS Client has, 0 if it has none
+	 */
+	uint32_t bcast_seq_num;
 
 } dps_gen_msg_req_t;
 
+/**
+ * \brief The sub_type of DPS_BCAST_LIST_REQ, DPS_BCAST_LIST_REPLY and
+ *        DPS_UNSOLICITED_BCAST_LIST_REPLY messages.
+ *        A DPS Client that sends a DPS_BCAST_LIST_REQ with sub_type
+ *        DPS_BCAST_LIST_SEQUENCED gets its broadcast lists as sequenced
+ *        changes (dps_bcast_list_delta_t) from then on. Other DPS Clients
+ *        keep getting the full list (dps_pkd_tunnel_list_t).
+ */
+typedef enum {
+	DPS_BCAST_LIST_FULL = 0,
+	DPS_BCAST_LIST_SEQUENCED = 1,
+} dps_bcast_list_type;
+
 // Dove Switch List Structure
 /**
  * \brief The DPS server sends a list of Dove switches in the domain.
@@ -845,6 +874,53 @@ typedef struct dps_pkd_tunnel_list_t {
 	uint32_t tunnel_list[0];
 } dps_pkd_tunnel_list_t;
 
+/**
+ * \brief A change to the list of Dove switches in a VNID. Every change moves
+ *        the list from the base_seq_num to the seq_num sequence number.
+ *        - base_seq_num is 0: The added tunnels are the whole list.
+ *        - base_seq_num is the DPS Client's sequence number: The change must
+ *          be applied to the list the DPS Client has. seq_num equal to
+ *          base_seq_num with no tunnels means the list didn't change.
+ *        - Otherwise the DPS Client missed a change and must ask for the
+ *          whole list with a DPS_BCAST_LIST_REQ.
+ */
+typedef struct dps_bcast_list_delta_s {
+	/**
+	 * \brief The vnid value used by the tunnels
+	 */
+	uint32_t vnid;
+	/**
+	 * \brief The sequence number of the list after the change
+	 */
+	uint32_t seq_num;
+	/**
+	 * \brief The sequence number of the list the change applies to
+	 */
+	uint32_t base_seq_num;
+	/**
+	 * \brief The number of v4 Dove switches added
+	 */
+	uint16_t num_v4_add;
+	/**
+	 * \brief The number of v4 Dove switches removed
+	 */
+	uint16_t num_v4_del;
+	/**
+	 * \brief The number of v6 Dove switches added
+	 */
+	uint16_t num_v6_add;
+	/**
+	 * \brief The number of v6 Dove switches removed
+	 */
+	uint16_t num_v6_del;
+	/**
+	 * \brief The v4 Dove switches added, followed by the v4 Dove switches
+	 *        removed, the v6 Dove switches added and the v6 Dove switches
+	 *        removed. A v6 Dove switch takes 4 elements.
+	 */
+	uint32_t tunnel_list[0];
+} dps_bcast_list_delta_t;
+
 
 /**
  * \brief A Dove switch on receiving data traffic for a VM that has moved, will send the migrated
@@ -1042,6 +1118,123 @@ typedef struct dps_vm_invalidate_s {
 	dps_epri_t epri;
 } dps_vm_invalidate_t;
 
+/**
+ * \brief The maximum number of Endpoint Updates in a DPS_REPLICATION_BATCH.
+ *        A batch of IPv6 updates still fits in a 1500 byte MTU.
+ */
+#define DPS_REPLICATION_BATCH_MAX 12
+
+/**
+ * \brief The maximum number of failed Endpoint Updates a
+ *        DPS_REPLICATION_BATCH_ACK reports. Holds all the failures of a
+ *        full batch.
+ */
+#define DPS_REPLICATION_ACK_ERRORS_MAX 16
+
+/**
+ * \brief An Endpoint Update carried in a DPS_REPLICATION_BATCH. Only the
+ *        first tunnel of the Endpoint Update is replicated.
+ */
+typedef struct dps_replication_entry_s {
+	/**
+	 * \brief The VNID in the header of the Endpoint Update
+	 */
+	uint32_t vnid;
+	/**
+	 * \brief The sub_type (dps_endpoint_update_option) of the Endpoint Update
+	 */
+	uint8_t sub_type;
+	/**
+	 * \brief The client_id of the Endpoint Update
+	 */
+	uint8_t client_id;
+	/**
+	 * \brief RESERVED
+	 */
+	uint8_t padding[2];
+	/**
+	 * \brief The Endpoint Update
+	 */
+	dps_endpoint_update_t endpoint_update;
+} dps_replication_entry_t;
+
+/**
+ * \brief A batch of Endpoint Updates sent by a DCS Server on the Replication
+ *        Channel of a Domain to another DCS Server. Batches are numbered from
+ *        1 on every Channel and must be applied in order.
+ */
+typedef struct dps_replication_batch_s {
+	/**
+	 * \brief The Replication Channel. A new Channel ID starts again at
+	 *        sequence number 1.
+	 */
+	uint32_t channel_id;
+	/**
+	 * \brief The sequence number of the batch
+	 */
+	uint32_t seq_num;
+	/**
+	 * \brief The number of entries
+	 */
+	uint32_t num_entries;
+	/**
+	 * \brief The Endpoint Updates in the order they must be applied
+	 */
+	dps_replication_entry_t entries[0];
+} dps_replication_batch_t;
+
+/**
+ * \brief An Endpoint Update that the receiver of a DPS_REPLICATION_BATCH
+ *        could not apply
+ */
+typedef struct dps_replication_error_s {
+	/**
+	 * \brief The sequence number of the batch
+	 */
+	uint32_t seq_num;
+	/**
+	 * \brief The index of the entry in the batch
+	 */
+	uint16_t index;
+	/**
+	 * \brief The dps_resp_status_t
+	 */
+	uint16_t status;
+} dps_replication_error_t;
+
+/**
+ * \brief The cumulative ACK of the batches received on a Replication
+ *        Channel. It also repeats the most recent failed Endpoint Updates so
+ *        that a lost ACK doesn't lose them. When older failures no longer
+ *        fit, errors_seq_num tells the sender which batches the list is
+ *        still complete for.
+ */
+typedef struct dps_replication_ack_s {
+	/**
+	 * \brief The Replication Channel
+	 */
+	uint32_t channel_id;
+	/**
+	 * \brief All batches up to and including this sequence number have
+	 *        been applied
+	 */
+	uint32_t ack_seq_num;
+	/**
+	 * \brief The errors list holds all the failures of the batches from
+	 *        this sequence number on. The sender fails the updates of older
+	 *        batches it hasn't seen acked yet with DPS_ERROR_RETRY.
+	 */
+	uint32_t errors_seq_num;
+	/**
+	 * \brief The number of errors
+	 */
+	uint32_t num_errors;
+	/**
+	 * \brief The most recent failed Endpoint Updates
+	 */
+	dps_replication_error_t errors[DPS_REPLICATION_ACK_ERRORS_MAX];
+} dps_replication_ack_t;
+
 typedef struct dps_client_data_s {
 	void *context;
 	dps_client_hdr_t hdr;
@@ -1061,6 +1254,9 @@ typedef struct dps_client_data_s {
 		dps_gen_msg_req_t               gen_msg_req;
 		// dove_switch_list used by DPS_BCAST_LIST_REPLY/DPS_UNSOLICITED_BCAST_LIST_REPLY
 		dps_pkd_tunnel_list_t           dove_switch_list;
+		// dove_switch_delta used by DPS_BCAST_LIST_REPLY/DPS_UNSOLICITED_BCAST_LIST_REPLY
+		// with sub_type DPS_BCAST_LIST_SEQUENCED
+		dps_bcast_list_delta_t          dove_switch_delta;
 		dps_vm_migration_event_t        vm_migration_event;
 		dps_mcast_sender_t              mcast_sender;
 		dps_mcast_receiver_t            mcast_receiver;
@@ -1073,6 +1269,10 @@ typedef struct dps_client_data_s {
 		dps_endpoint_loc_req_t          address_resolve;
 		// Used by DPS_UNSOLICITED_INVALIDATE_VM
 		dps_vm_invalidate_t             vm_invalidate_msg;
+		// Used by DPS_REPLICATION_BATCH
+		dps_replication_batch_t         replication_batch;
+		// Used by DPS_REPLICATION_BATCH_ACK
+		dps_replication_ack_t           replication_ack;
 	};
 } dps_client_data_t;
 
@@ -1218,6 +1418,15 @@ void dps_protocol_construct_reply_msg(dps_client_data_t *msg,
  */
 typedef int (*poll_event_callback)(int fd, void *context);
 
+/**
+ * \brief The Priorities of polled File Descriptors. When several File
+ *        Descriptors are ready the ones with higher priority are processed
+ *        first.
+ */
+#define FD_PROCESS_PRIORITY_LOW     0
+#define FD_PROCESS_PRIORITY_NORMAL  1
+#define FD_PROCESS_PRIORITY_HIGH    2
+
 /*
  ******************************************************************************
  * fd_process_add_fd --                                                   *//**
@@ -1231,15 +1440,33 @@ typedef int (*poll_event_callback)(int fd, void *context);
  *
  * \return The Status of the Add
  *
- * \note This routine updates the Global fd_count_total to the number of
- *       FDs that can be polled
- *
  *****************************************************************************/
 
 int fd_process_add_fd(int fd,
                       poll_event_callback callback,
                       void *context);
 
+/*
+ ******************************************************************************
+ * fd_process_add_fd_priority --                                          *//**
+ *
+ * \brief This routine adds a new file descriptor to the set of polled
+ *        file descriptors with a processing priority
+ *
+ * \param[in] fd	The File Descriptor
+ * \param[in] callback	The Callback to invoke when an event occurs on the fd
+ * \param[in] context	The Context to invoke with the callback
+ * \param[in] priority	One of FD_PROCESS_PRIORITY_*
+ *
+ * \return The Status of the Add
+ *
+ *****************************************************************************/
+
+int fd_process_add_fd_priority(int fd,
+                               poll_event_callback callback,
+                               void *context,
+                               int priority);
+
 /*
  ******************************************************************************
  * fd_process_del_fd --                                                    *//**
@@ -1250,10 +1477,7 @@ int fd_process_add_fd(int fd,
  * \param[in] fd	The File Descriptor
  *
  * \retval DOVE_STATUS_OK Success
- * \retval DOVE_STATUS_INVALID_FD File Descriptor doesn't exist in Array
- *
- * \note This routine updates the Global fd_count_total to the number of
- *       FDs that can be polled
+ * \retval DOVE_STATUS_INVALID_FD File Descriptor is not registered
  *
  *****************************************************************************/
 
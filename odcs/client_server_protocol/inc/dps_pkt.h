@@ -54,6 +54,11 @@
 #define DPS_POLICY_ID_TLV_LEN	    DPS_TLV_HDR_LEN + 12
 #define DPS_ENDPOINT4_INFO_TLV_LEN DPS_TLV_HDR_LEN + 12 + DPS_IP4_TLV_LEN
 #define DPS_ENDPOINT6_INFO_TLV_LEN DPS_TLV_HDR_LEN + 12 + DPS_IP6_TLV_LEN
+#define DPS_BCAST_LIST_DELTA_TLV_LEN DPS_TLV_HDR_LEN + 16 // Without the addresses
+#define DPS_REPLICATION_BATCH_TLV_LEN DPS_TLV_HDR_LEN + 12
+#define DPS_REPLICATION_ENTRY_TLV_LEN DPS_TLV_HDR_LEN + 8 // Without the Endpoint Update
+#define DPS_REPLICATION_ACK_TLV_LEN DPS_TLV_HDR_LEN + 16 // Without the errors
+#define DPS_REPLICATION_ERROR_LEN   8
 
 // TLV Base Type 
 
@@ -81,6 +86,10 @@
 #define EPRI_TLV                    22
 #define IP4_INFO_LIST_TLV           23
 #define IP6_INFO_LIST_TLV           24
+#define BCAST_LIST_DELTA_TLV        25
+#define REPLICATION_BATCH_TLV       26
+#define REPLICATION_ENTRY_TLV       27
+#define REPLICATION_ACK_TLV         28
 
 /*
  ******************************************************************************
@@ -268,6 +277,8 @@ typedef void (*dps_bit_func)(uint8_t *, uint8_t);
  *
  * \param[in] recv_buff - A pointer to a message that the socket received.
  *                        Type - dps_pkt_hdr_t
+ * \param[in] recv_len - The number of bytes the socket received. Packets
+ *                       whose stated length exceeds it are dropped.
  * \param[in] cli_addr - The address of the sender in sockaddr_in format
  *
  * \retval 0 DPS_SUCCESS
@@ -275,7 +286,7 @@ typedef void (*dps_bit_func)(uint8_t *, uint8_t);
  *
  ******************************************************************************
  */
-uint32_t dps_process_rcvd_pkt(void *, void *);
+uint32_t dps_process_rcvd_pkt(void *, uint32_t, void *);
 
 /*
  ******************************************************************************
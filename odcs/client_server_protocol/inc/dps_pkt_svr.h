@@ -26,6 +26,39 @@
 
 #if defined(DPS_SERVER)
 
+/**
+ * \brief The Stages a DPS Client Server packet goes through. The latency of
+ *        every Stage is accounted per Packet Type.
+ */
+typedef enum {
+	DPS_PKT_STAGE_DECODE = 0,
+	DPS_PKT_STAGE_HANDLER = 1,
+	DPS_PKT_STAGE_ENCODE = 2,
+	DPS_PKT_STAGE_XMIT = 3,
+	DPS_PKT_STAGE_MAX = 4,
+} dps_pkt_stage_t;
+
+/**
+ * \brief The Number of Buckets in a Latency Histogram. Bucket i counts the
+ *        samples in [2^i, 2^(i+1)) nanoseconds, the last Bucket counts all
+ *        samples above 2^31 nanoseconds.
+ */
+#define DPS_PKT_LATENCY_BUCKETS 32
+
+/**
+ * \brief The Latency Histogram of a Packet Type and Stage
+ */
+typedef struct dps_pkt_latency_s{
+	uint64_t	count;
+	/**
+	 * \brief The samples where the Stage failed. For the Handler Stage these
+	 *        are the packets the Data Handler dropped.
+	 */
+	uint64_t	errors;
+	uint64_t	total_ns;
+	uint64_t	bucket[DPS_PKT_LATENCY_BUCKETS];
+} dps_pkt_latency_t;
+
 /*
  ******************************************************************************
  * dps_svr_proto_init                                                     *//**
@@ -46,6 +79,24 @@
  */
 dove_status dps_svr_proto_init(uint32_t portnum);
 
+/*
+ ******************************************************************************
+ * dps_svr_proto_workers_set                                              *//**
+ *
+ * \brief - This routine sets the Number of Workers that will service the DPS
+ *          Server UDP Port. It MUST be called before dps_svr_proto_init to
+ *          take effect.
+ *
+ * \param[in] num_workers - The Number of Workers. 1 means the Server Socket
+ *                          is serviced by the CORE API polling thread.
+ *
+ * \retval DOVE_STATUS_OK Success
+ * \retval DOVE_STATUS_INVALID_PARAMETER Number out of range
+ *
+ ******************************************************************************
+ */
+dove_status dps_svr_proto_workers_set(uint32_t num_workers);
+
 /*
  ******************************************************************************
  * dps_packet_stats_show                                                  *//**
@@ -78,6 +129,151 @@ dove_status dps_packet_stats_show(uint32_t pkt_type);
  */
 dove_status dps_packet_stats_clear(uint32_t pkt_type);
 
+/*
+ ******************************************************************************
+ * dps_svr_batch_stats_show                                               *//**
+ *
+ * \brief - This routine shows the statistics of the Batched Receive and
+ *          Transmit on the DPS Server Socket
+ *
+ * \retval DOVE_STATUS_OK
+ *
+ ******************************************************************************
+ */
+dove_status dps_svr_batch_stats_show(void);
+
+/*
+ ******************************************************************************
+ * dps_svr_batch_stats_clear                                              *//**
+ *
+ * \brief - This routine clears the statistics of the Batched Receive and
+ *          Transmit on the DPS Server Socket
+ *
+ * \retval DOVE_STATUS_OK
+ *
+ ******************************************************************************
+ */
+dove_status dps_svr_batch_stats_clear(void);
+
+/*
+ ******************************************************************************
+ * dps_msg_name                                                           *//**
+ *
+ * \brief - Returns the printable name of a DPS packet type
+ *
+ * \param[in] pkt_type - The DPS packet type
+ *
+ ******************************************************************************
+ */
+const char *dps_msg_name(uint8_t pkt_type);
+
+/*
+ ******************************************************************************
+ * dps_pkt_latency_start                                                  *//**
+ *
+ * \brief - Marks the start of a Processing Stage of a packet on the calling
+ *          thread. MUST be paired with dps_pkt_latency_end. The time spent
+ *          in nested Stages is not accounted to this Stage.
+ *
+ * \param[in] pkt_type - The DPS packet type
+ * \param[in] stage - The Processing Stage: dps_pkt_stage_t
+ *
+ ******************************************************************************
+ */
+void dps_pkt_latency_start(uint32_t pkt_type, uint32_t stage);
+
+/*
+ ******************************************************************************
+ * dps_pkt_latency_end                                                    *//**
+ *
+ * \brief - Marks the end of the innermost Processing Stage on the calling
+ *          thread and records its latency
+ *
+ * \param[in] error - Whether the Stage failed
+ *
+ ******************************************************************************
+ */
+void dps_pkt_latency_end(int error);
+
+/*
+ ******************************************************************************
+ * dps_pkt_latency_record                                                 *//**
+ *
+ * \brief - Records a latency measured by the caller
+ *
+ * \param[in] pkt_type - The DPS packet type
+ * \param[in] stage - The Processing Stage: dps_pkt_stage_t
+ * \param[in] ns - The latency in nanoseconds
+ * \param[in] error - Whether the Stage failed
+ *
+ ******************************************************************************
+ */
+void dps_pkt_latency_record(uint32_t pkt_type, uint32_t stage, uint64_t ns, int error);
+
+/*
+ ******************************************************************************
+ * dps_pkt_latency_get                                                    *//**
+ *
+ * \brief - Returns the Latency Histogram of a Packet Type and Stage summed
+ *          over all threads
+ *
+ * \param[in] pkt_type - The DPS packet type
+ * \param[in] stage - The Processing Stage: dps_pkt_stage_t
+ * \param[out] lat - The Latency Histogram
+ *
+ * \retval DOVE_STATUS_OK
+ * \retval DOVE_STATUS_INVALID_PARAMETER
+ *
+ ******************************************************************************
+ */
+dove_status dps_pkt_latency_get(uint32_t pkt_type, uint32_t stage,
+                                dps_pkt_latency_t *lat);
+
+/*
+ ******************************************************************************
+ * dps_pkt_latency_percentile                                             *//**
+ *
+ * \brief - Returns the upper bound of the Histogram Bucket that holds a
+ *          percentile
+ *
+ * \param[in] lat - The Latency Histogram
+ * \param[in] permille - The percentile in tenths of a percent (990 is p99)
+ *
+ * \return The latency in nanoseconds, 0 if there are no samples
+ *
+ ******************************************************************************
+ */
+uint64_t dps_pkt_latency_percentile(dps_pkt_latency_t *lat, uint32_t permille);
+
+/*
+ ******************************************************************************
+ * dps_packet_latency_show                                                *//**
+ *
+ * \brief This routine shows the Decode, Handler, Encode and Xmit latency of
+ *        DPS Client Server packets
+ *
+ * \param[in] pkt_type - DPS Client Server Protocol Message Type i.e.
+ *                       dps_client_req_type. 0 shows all types.
+ *
+ * \retval DOVE_STATUS_OK
+ *
+ ******************************************************************************
+ */
+dove_status dps_packet_latency_show(uint32_t pkt_type);
+
+/*
+ ******************************************************************************
+ * dps_packet_latency_clear                                               *//**
+ *
+ * \brief This routine clears the latency statistics of all DPS Client
+ *        Server packets
+ *
+ * \retval DOVE_STATUS_OK
+ *
+ ******************************************************************************
+ */
+dove_status dps_packet_latency_clear(void);
+
 #endif
 
 #endif // _DPS_PKT_SVR_
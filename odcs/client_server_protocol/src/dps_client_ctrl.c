@@ -740,7 +740,8 @@ static int dps_process_data_rcvd(int socket, void *context)
 			                        str_ip, sizeof(str_ip)), 
 			              (client_addr.ss_family == AF_INET) ? ntohs(sin->sin_port) : ntohs(sin6->sin6_port), bytes_read);
 		
-			dps_process_rcvd_pkt((void *)dps_svr_addr_list[index].buff, (void *)&sender_addr);
+			dps_process_rcvd_pkt((void *)dps_svr_addr_list[index].buff,
+			                     (uint32_t)bytes_read, (void *)&sender_addr);
 
 
 
@@ -81,19 +81,245 @@ static void dump_pkt(uint8_t *buff, uint32_t len);
 
 static uint8_t zero_mac[6] = {0x0,0x0,0x0,0x0,0x0,0x0};
 
+/**
+ * \brief The Buffer Size Classes. A buffer request is served from the
+ *        smallest class that fits it. Requests larger than the Jumbo class
+ *        are allocated directly and not pooled.
+ */
+typedef enum {
+	DPS_BUFF_CLASS_SMALL = 0,
+	DPS_BUFF_CLASS_MEDIUM = 1,
+	DPS_BUFF_CLASS_JUMBO = 2,
+	DPS_BUFF_CLASS_MAX = 3,
+	DPS_BUFF_CLASS_UNPOOLED = DPS_BUFF_CLASS_MAX,
+} dps_buff_class_t;
+
+/**
+ * \brief The Size and the Maximum number of free buffers each thread keeps
+ *        for every Buffer Size Class
+ */
+typedef struct dps_buff_class_cfg_s{
+	const char	*name;
+	uint32_t	size;
+	uint32_t	max_free;
+} dps_buff_class_cfg_t;
+
+static dps_buff_class_cfg_t dps_buff_class_cfg[DPS_BUFF_CLASS_MAX] = {
+	{"Small", 2048, 128},
+	{"Medium", 8192, 32},
+	{"Jumbo", DPS_MAX_BUFF_SZ, 4},
+};
+
+/**
+ * \brief The Header that precedes every buffer handed out by dps_alloc_buff.
+ *        It is 16 bytes so that the buffer itself stays 16 byte aligned.
+ */
+typedef struct dps_buff_hdr_s{
+	struct dps_buff_hdr_s	*next;
+	uint32_t		buff_class;
+	uint32_t		reserved;
+} dps_buff_hdr_t;
+
+/**
+ * \brief The per thread Buffer Pool. Buffers are returned to the pool of
+ *        the thread that frees them.
+ */
+typedef struct dps_buff_pool_s{
+	dps_buff_hdr_t	*free_list[DPS_BUFF_CLASS_MAX];
+	uint32_t	free_count[DPS_BUFF_CLASS_MAX];
+} dps_buff_pool_t;
+
+/**
+ * \brief The Statistics of a Buffer Size Class, summed over all threads
+ */
+typedef struct dps_buff_class_stats_s{
+	unsigned long int	alloc;
+	unsigned long int	pool_hit;
+	long int		in_use;
+	long int		high_water;
+} dps_buff_class_stats_t;
+
+static dps_buff_class_stats_t dps_buff_class_stats[DPS_BUFF_CLASS_MAX + 1];
+
+static pthread_key_t dps_buff_pool_key;
+static pthread_once_t dps_buff_pool_key_once = PTHREAD_ONCE_INIT;
+
+/*
+ ******************************************************************************
+ * dps_buff_pool_destroy                                                  *//**
+ *
+ * \brief - Frees the pooled buffers of a thread when the thread exits
+ *
+ * \param[in] arg - The Buffer Pool of the thread
+ *
+ ******************************************************************************
+ */
+
+static void dps_buff_pool_destroy(void *arg)
+{
+	dps_buff_pool_t *pool = (dps_buff_pool_t *)arg;
+	dps_buff_hdr_t *hdr;
+	int i;
+
+	for (i = 0; i < DPS_BUFF_CLASS_MAX; i++)
+	{
+		while ((hdr = pool->free_list[i]) != NULL)
+		{
+			pool->free_list[i] = hdr->next;
+			free(hdr);
+		}
+	}
+	free(pool);
+	return;
+}
+
+static void dps_buff_pool_key_create(void)
+{
+	pthread_key_create(&dps_buff_pool_key, dps_buff_pool_destroy);
+	return;
+}
+
+/*
+ ******************************************************************************
+ * dps_buff_pool_get                                                      *//**
+ *
+ * \brief - Returns the Buffer Pool of the calling thread, creating it on
+ *          first use
+ *
+ * \return Pointer to the Buffer Pool, NULL if no memory
+ *
+ ******************************************************************************
+ */
+
+static dps_buff_pool_t *dps_buff_pool_get(void)
+{
+	dps_buff_pool_t *pool;
+
+	pthread_once(&dps_buff_pool_key_once, dps_buff_pool_key_create);
+	pool = (dps_buff_pool_t *)pthread_getspecific(dps_buff_pool_key);
+	if (pool == NULL)
+	{
+		pool = (dps_buff_pool_t *)malloc(sizeof(dps_buff_pool_t));
+		if (pool != NULL)
+		{
+			memset(pool, 0, sizeof(dps_buff_pool_t));
+			pthread_setspecific(dps_buff_pool_key, pool);
+		}
+	}
+	return pool;
+}
+
+/*
+ ******************************************************************************
+ * dps_alloc_buff                                                         *//**
+ *
+ * \brief - Allocates a buffer of at least len bytes from the Buffer Pool of
+ *          the calling thread. The first sizeof(dps_client_data_t) bytes
+ *          (or the whole buffer if it is smaller) are zeroed.
+ *
+ * \param[in] len - The number of bytes needed
+ *
+ * \return Pointer to the buffer, NULL if no memory
+ *
+ ******************************************************************************
+ */
+
 uint8_t *dps_alloc_buff(uint32_t len)
 {
-	uint8_t *buff = NULL;
-	if ((buff = (uint8_t *)malloc(DPS_MAX_BUFF_SZ)) != NULL)
+	dps_buff_pool_t *pool;
+	dps_buff_hdr_t *hdr = NULL;
+	uint32_t buff_class, size;
+	long int in_use;
+
+	for (buff_class = 0; buff_class < DPS_BUFF_CLASS_MAX; buff_class++)
 	{
-		memset(buff, 0, sizeof(dps_client_data_t));
+		if (len <= dps_buff_class_cfg[buff_class].size)
+		{
+			break;
+		}
 	}
-	return (buff);
+
+	if (buff_class < DPS_BUFF_CLASS_MAX)
+	{
+		size = dps_buff_class_cfg[buff_class].size;
+		pool = dps_buff_pool_get();
+		if ((pool != NULL) && (pool->free_list[buff_class] != NULL))
+		{
+			hdr = pool->free_list[buff_class];
+			pool->free_list[buff_class] = hdr->next;
+			pool->free_count[buff_class]--;
+			__sync_fetch_and_add(&dps_buff_class_stats[buff_class].pool_hit, 1);
+		}
+	}
+	else
+	{
+		buff_class = DPS_BUFF_CLASS_UNPOOLED;
+		size = len;
+	}
+
+	if (hdr == NULL)
+	{
+		hdr = (dps_buff_hdr_t *)malloc(sizeof(dps_buff_hdr_t) + size);
+		if (hdr == NULL)
+		{
+			return NULL;
+		}
+	}
+	hdr->next = NULL;
+	hdr->buff_class = buff_class;
+
+	__sync_fetch_and_add(&dps_buff_class_stats[buff_class].alloc, 1);
+	in_use = __sync_add_and_fetch(&dps_buff_class_stats[buff_class].in_use, 1);
+	if (in_use > dps_buff_class_stats[buff_class].high_water)
+	{
+		dps_buff_class_stats[buff_class].high_water = in_use;
+	}
+
+	memset((uint8_t *)(hdr + 1), 0,
+	       (size < sizeof(dps_client_data_t)) ? size : sizeof(dps_client_data_t));
+	return ((uint8_t *)(hdr + 1));
 }
 
+/*
+ ******************************************************************************
+ * dps_free_buff                                                          *//**
+ *
+ * \brief - Returns a buffer allocated by dps_alloc_buff to the Buffer Pool of
+ *          the calling thread, or frees it if the pool is full
+ *
+ * \param[in] buff - The buffer
+ *
+ ******************************************************************************
+ */
+
 void dps_free_buff(uint8_t *buff)
 {
-	free(buff);
+	dps_buff_pool_t *pool;
+	dps_buff_hdr_t *hdr;
+	uint32_t buff_class;
+
+	if (buff == NULL)
+	{
+		return;
+	}
+	hdr = ((dps_buff_hdr_t *)buff) - 1;
+	buff_class = hdr->buff_class;
+	__sync_fetch_and_sub(&dps_buff_class_stats[buff_class].in_use, 1);
+
+	if (buff_class < DPS_BUFF_CLASS_MAX)
+	{
+		pool = dps_buff_pool_get();
+		if ((pool != NULL) &&
+		    (pool->free_count[buff_class] < dps_buff_class_cfg[buff_class].max_free))
+		{
+			hdr->next = pool->free_list[buff_class];
+			pool->free_list[buff_class] = hdr;
+			pool->free_count[buff_class]++;
+			return;
+		}
+	}
+	free(hdr);
+	return;
 }
 
 /*
@@ -262,8 +488,414 @@ static dps_pkt_stats_t dps_pkt_stats_tbl[] = {
 	{"Control Plane Heart Beat", 0, 0, 0, 0},                            // DPS_CTRL_PLANE_HB
 	{"New DCS Node Req",  0, 0, 0, 0},                                   // DPS_GET_DCS_NODE
 	{"Unsolicited VM Location Info", 0, 0, 0, 0},                        // DPS_UNSOLICITED_VM_LOC_INFO
+	{"Replication Batch", 0, 0, 0, 0},                                   // DPS_REPLICATION_BATCH
+	{"Replication Batch Ack", 0, 0, 0, 0},                               // DPS_REPLICATION_BATCH_ACK
+};
+
+#if defined(DPS_SERVER)
+/**
+ * \brief The Names of the Processing Stages, MUST be kept in sync with
+ *        dps_pkt_stage_t
+ */
+static const char *dps_pkt_stage_name[DPS_PKT_STAGE_MAX] = {
+	"Decode",
+	"Handler",
+	"Encode",
+	"Xmit",
 };
 
+/**
+ * \brief The Maximum nesting of Processing Stages on a thread. A received
+ *        packet nests Decode -> Handler -> Encode -> Xmit.
+ */
+#define DPS_PKT_LATENCY_MAX_DEPTH 8
+
+/**
+ * \brief A Processing Stage in progress on a thread. The time spent in
+ *        nested stages is subtracted so every stage only accounts for its
+ *        own work.
+ */
+typedef struct dps_pkt_latency_frame_s{
+	uint32_t	pkt_type;
+	uint32_t	stage;
+	uint64_t	start_ns;
+	uint64_t	child_ns;
+} dps_pkt_latency_frame_t;
+
+/**
+ * \brief The per thread Latency Accounting. Only the owning thread writes
+ *        to it, readers sum over all threads.
+ */
+typedef struct dps_pkt_latency_thread_s{
+	struct dps_pkt_latency_thread_s	*next;
+	/**
+	 * \brief The Clear Generation the counters belong to. The owning thread
+	 *        zeroes its counters when the Generation moves on.
+	 */
+	uint32_t			generation;
+	uint32_t			depth;
+	dps_pkt_latency_frame_t		frame[DPS_PKT_LATENCY_MAX_DEPTH];
+	dps_pkt_latency_t		latency[DPS_MAX_MSG_TYPE][DPS_PKT_STAGE_MAX];
+} dps_pkt_latency_thread_t;
+
+/**
+ * \brief The threads doing Latency Accounting and the counters of the threads
+ *        that have exited. The lock is only taken when a thread comes or
+ *        goes and by the readers.
+ */
+static dps_pkt_latency_thread_t *dps_pkt_latency_threads = NULL;
+static dps_pkt_latency_t dps_pkt_latency_retired[DPS_MAX_MSG_TYPE][DPS_PKT_STAGE_MAX];
+static pthread_mutex_t dps_pkt_latency_lock = PTHREAD_MUTEX_INITIALIZER;
+static volatile uint32_t dps_pkt_latency_generation = 0;
+
+static pthread_key_t dps_pkt_latency_key;
+static pthread_once_t dps_pkt_latency_key_once = PTHREAD_ONCE_INIT;
+
+/*
+ ******************************************************************************
+ * dps_pkt_latency_destroy                                                *//**
+ *
+ * \brief - Folds the Latency Accounting of a thread into the retired counters
+ *          when the thread exits
+ *
+ * \param[in] arg - The Latency Accounting of the thread
+ *
+ ******************************************************************************
+ */
+
+static void dps_pkt_latency_destroy(void *arg)
+{
+	dps_pkt_latency_thread_t *lt = (dps_pkt_latency_thread_t *)arg;
+	dps_pkt_latency_thread_t **plt;
+	dps_pkt_latency_t *src, *dst;
+	int i, j, k;
+
+	pthread_mutex_lock(&dps_pkt_latency_lock);
+	for (plt = &dps_pkt_latency_threads; *plt != NULL; plt = &(*plt)->next)
+	{
+		if (*plt == lt)
+		{
+			*plt = lt->next;
+			break;
+		}
+	}
+	if (lt->generation == dps_pkt_latency_generation)
+	{
+		for (i = 0; i < DPS_MAX_MSG_TYPE; i++)
+		{
+			for (j = 0; j < DPS_PKT_STAGE_MAX; j++)
+			{
+				src = &lt->latency[i][j];
+				dst = &dps_pkt_latency_retired[i][j];
+				dst->count += src->count;
+				dst->errors += src->errors;
+				dst->total_ns += src->total_ns;
+				for (k = 0; k < DPS_PKT_LATENCY_BUCKETS; k++)
+				{
+					dst->bucket[k] += src->bucket[k];
+				}
+			}
+		}
+	}
+	pthread_mutex_unlock(&dps_pkt_latency_lock);
+	free(lt);
+	return;
+}
+
+static void dps_pkt_latency_key_create(void)
+{
+	pthread_key_create(&dps_pkt_latency_key, dps_pkt_latency_destroy);
+	return;
+}
+
+/*
+ ******************************************************************************
+ * dps_pkt_latency_thread_get                                             *//**
+ *
+ * \brief - Returns the Latency Accounting of the calling thread, creating it
+ *          on first use
+ *
+ * \return Pointer to the Latency Accounting, NULL if no memory
+ *
+ ******************************************************************************
+ */
+
+static dps_pkt_latency_thread_t *dps_pkt_latency_thread_get(void)
+{
+	dps_pkt_latency_thread_t *lt;
+
+	pthread_once(&dps_pkt_latency_key_once, dps_pkt_latency_key_create);
+	lt = (dps_pkt_latency_thread_t *)pthread_getspecific(dps_pkt_latency_key);
+	if (lt == NULL)
+	{
+		lt = (dps_pkt_latency_thread_t *)malloc(sizeof(dps_pkt_latency_thread_t));
+		if (lt == NULL)
+		{
+			return NULL;
+		}
+		memset(lt, 0, sizeof(dps_pkt_latency_thread_t));
+		pthread_setspecific(dps_pkt_latency_key, lt);
+		pthread_mutex_lock(&dps_pkt_latency_lock);
+		lt->generation = dps_pkt_latency_generation;
+		lt->next = dps_pkt_latency_threads;
+		dps_pkt_latency_threads = lt;
+		pthread_mutex_unlock(&dps_pkt_latency_lock);
+	}
+	else if (lt->generation != dps_pkt_latency_generation)
+	{
+		// The statistics were cleared since this thread last recorded
+		memset(lt->latency, 0, sizeof(lt->latency));
+		lt->generation = dps_pkt_latency_generation;
+	}
+	return lt;
+}
+
+static inline uint64_t dps_pkt_latency_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ ******************************************************************************
+ * dps_pkt_latency_add                                                    *//**
+ *
+ * \brief - Adds a sample to the Latency Histogram of a Packet Type and Stage.
+ *          Bucket i counts the samples in [2^i, 2^(i+1)) nanoseconds.
+ *
+ ******************************************************************************
+ */
+
+static void dps_pkt_latency_add(dps_pkt_latency_thread_t *lt, uint32_t pkt_type,
+                                uint32_t stage, uint64_t ns, int error)
+{
+	dps_pkt_latency_t *lat;
+	uint32_t bucket;
+
+	if ((pkt_type >= DPS_MAX_MSG_TYPE) || (stage >= DPS_PKT_STAGE_MAX))
+	{
+		pkt_type = 0;
+		stage = (stage >= DPS_PKT_STAGE_MAX) ? DPS_PKT_STAGE_DECODE : stage;
+	}
+	lat = &lt->latency[pkt_type][stage];
+	bucket = (ns > 1) ? (uint32_t)(63 - __builtin_clzll(ns)) : 0;
+	if (bucket >= DPS_PKT_LATENCY_BUCKETS)
+	{
+		bucket = DPS_PKT_LATENCY_BUCKETS - 1;
+	}
+	lat->count++;
+	lat->total_ns += ns;
+	lat->bucket[bucket]++;
+	if (error)
+	{
+		lat->errors++;
+	}
+	return;
+}
+
+/*
+ ******************************************************************************
+ * dps_pkt_latency_start                                                  *//**
+ *
+ * \brief - Marks the start of a Processing Stage of a packet on the calling
+ *          thread. MUST be paired with dps_pkt_latency_end.
+ *
+ * \param[in] pkt_type - The DPS packet type
+ * \param[in] stage - The Processing Stage: dps_pkt_stage_t
+ *
+ ******************************************************************************
+ */
+
+void dps_pkt_latency_start(uint32_t pkt_type, uint32_t stage)
+{
+	dps_pkt_latency_thread_t *lt;
+	dps_pkt_latency_frame_t *frame;
+
+	lt = dps_pkt_latency_thread_get();
+	if (lt == NULL)
+	{
+		return;
+	}
+	if (lt->depth < DPS_PKT_LATENCY_MAX_DEPTH)
+	{
+		frame = &lt->frame[lt->depth];
+		frame->pkt_type = pkt_type;
+		frame->stage = stage;
+		frame->child_ns = 0;
+		frame->start_ns = dps_pkt_latency_now_ns();
+	}
+	// Too deep stages are not accounted for but still keep the pairing
+	lt->depth++;
+	return;
+}
+
+/*
+ ******************************************************************************
+ * dps_pkt_latency_end                                                    *//**
+ *
+ * \brief - Marks the end of the innermost Processing Stage on the calling
+ *          thread and records its latency
+ *
+ * \param[in] error - Whether the Stage failed
+ *
+ ******************************************************************************
+ */
+
+void dps_pkt_latency_end(int error)
+{
+	dps_pkt_latency_thread_t *lt;
+	dps_pkt_latency_frame_t *frame;
+	uint64_t elapsed_ns;
+
+	lt = (dps_pkt_latency_thread_t *)pthread_getspecific(dps_pkt_latency_key);
+	if ((lt == NULL) || (lt->depth == 0))
+	{
+		return;
+	}
+	lt->depth--;
+	if (lt->depth >= DPS_PKT_LATENCY_MAX_DEPTH)
+	{
+		return;
+	}
+	frame = &lt->frame[lt->depth];
+	elapsed_ns = dps_pkt_latency_now_ns() - frame->start_ns;
+	if (lt->depth > 0)
+	{
+		lt->frame[lt->depth - 1].child_ns += elapsed_ns;
+	}
+	elapsed_ns = (elapsed_ns > frame->child_ns) ? (elapsed_ns - frame->child_ns) : 0;
+	dps_pkt_latency_add(lt, frame->pkt_type, frame->stage, elapsed_ns, error);
+	return;
+}
+
+/*
+ ******************************************************************************
+ * dps_pkt_latency_record                                                 *//**
+ *
+ * \brief - Records a latency measured by the caller, for e.g. the share of a
+ *          batched transmit that falls on a single packet. The time is not
+ *          accounted to the enclosing Stage.
+ *
+ * \param[in] pkt_type - The DPS packet type
+ * \param[in] stage - The Processing Stage: dps_pkt_stage_t
+ * \param[in] ns - The latency in nanoseconds
+ * \param[in] error - Whether the Stage failed
+ *
+ ******************************************************************************
+ */
+
+void dps_pkt_latency_record(uint32_t pkt_type, uint32_t stage, uint64_t ns, int error)
+{
+	dps_pkt_latency_thread_t *lt;
+
+	lt = dps_pkt_latency_thread_get();
+	if (lt == NULL)
+	{
+		return;
+	}
+	if ((lt->depth > 0) && (lt->depth <= DPS_PKT_LATENCY_MAX_DEPTH))
+	{
+		lt->frame[lt->depth - 1].child_ns += ns;
+	}
+	dps_pkt_latency_add(lt, pkt_type, stage, ns, error);
+	return;
+}
+
+/*
+ ******************************************************************************
+ * dps_pkt_latency_get                                                    *//**
+ *
+ * \brief - Returns the Latency Histogram of a Packet Type and Stage summed
+ *          over all threads
+ *
+ * \param[in] pkt_type - The DPS packet type
+ * \param[in] stage - The Processing Stage: dps_pkt_stage_t
+ * \param[out] lat - The Latency Histogram
+ *
+ * \retval DOVE_STATUS_OK
+ * \retval DOVE_STATUS_INVALID_PARAMETER
+ *
+ ******************************************************************************
+ */
+
+dove_status dps_pkt_latency_get(uint32_t pkt_type, uint32_t stage,
+                                dps_pkt_latency_t *lat)
+{
+	dps_pkt_latency_thread_t *lt;
+	dps_pkt_latency_t *src;
+	int k;
+
+	if ((pkt_type >= DPS_MAX_MSG_TYPE) || (stage >= DPS_PKT_STAGE_MAX))
+	{
+		return DOVE_STATUS_INVALID_PARAMETER;
+	}
+	pthread_mutex_lock(&dps_pkt_latency_lock);
+	memcpy(lat, &dps_pkt_latency_retired[pkt_type][stage], sizeof(dps_pkt_latency_t));
+	for (lt = dps_pkt_latency_threads; lt != NULL; lt = lt->next)
+	{
+		if (lt->generation != dps_pkt_latency_generation)
+		{
+			continue;
+		}
+		src = &lt->latency[pkt_type][stage];
+		lat->count += src->count;
+		lat->errors += src->errors;
+		lat->total_ns += src->total_ns;
+		for (k = 0; k < DPS_PKT_LATENCY_BUCKETS; k++)
+		{
+			lat->bucket[k] += src->bucket[k];
+		}
+	}
+	pthread_mutex_unlock(&dps_pkt_latency_lock);
+	return DOVE_STATUS_OK;
+}
+
+/*
+ ******************************************************************************
+ * dps_pkt_latency_percentile                                             *//**
+ *
+ * \brief - Returns the upper bound of the Histogram Bucket that holds a
+ *          percentile
+ *
+ * \param[in] lat - The Latency Histogram
+ * \param[in] permille - The percentile in tenths of a percent (990 is p99)
+ *
+ * \return The latency in nanoseconds, 0 if there are no samples
+ *
+ ******************************************************************************
+ */
+
+uint64_t dps_pkt_latency_percentile(dps_pkt_latency_t *lat, uint32_t permille)
+{
+	uint64_t target, seen = 0;
+	int k;
+
+	if (lat->count == 0)
+	{
+		return 0;
+	}
+	target = ((lat->count * permille) + 999) / 1000;
+	for (k = 0; k < DPS_PKT_LATENCY_BUCKETS; k++)
+	{
+		seen += lat->bucket[k];
+		if (seen >= target)
+		{
+			break;
+		}
+	}
+	if (k >= DPS_PKT_LATENCY_BUCKETS)
+	{
+		k = DPS_PKT_LATENCY_BUCKETS - 1;
+	}
+	return (2ULL << k);
+}
+#else
+#define dps_pkt_latency_start(_pkt_type, _stage)
+#define dps_pkt_latency_end(_error)
+#endif // #if defined(DPS_SERVER)
+
 /*
  ******************************************************************************
  * dps_send_to_protocol_client                                            *//**
@@ -281,7 +913,12 @@ static dps_pkt_stats_t dps_pkt_stats_tbl[] = {
 static uint32_t dps_send_to_protocol_client(void *msg)
 {
 #if defined(DPS_SERVER)
-	dps_protocol_send_to_server((dps_client_data_t *)msg);
+	dps_return_status ret;
+
+	dps_pkt_latency_start(((dps_client_data_t *)msg)->hdr.type, DPS_PKT_STAGE_HANDLER);
+	ret = dps_protocol_send_to_server((dps_client_data_t *)msg);
+	// A failure means the Data Handler dropped the message
+	dps_pkt_latency_end(ret != DPS_SUCCESS);
 #else
 	dps_protocol_send_to_client((dps_client_data_t *)msg);
 #endif
@@ -341,48 +978,33 @@ static uint32_t dps_stop_retransmit_timer(dps_client_data_t *client_buff)
 	return ret_status;
 }
 
+/*
+ * The list length helpers below return the largest size the list can take
+ * on the wire, assuming every entry is IPv6, without walking the list. The
+ * exact length is known once the packet has been encoded and is backpatched
+ * into the packet header by the send functions.
+ */
 static inline uint32_t 
-dps_calc_vip_tlv_len(uint32_t num_of_vip, ip_addr_t *vip)
+dps_calc_vip_tlv_max_len(uint32_t num_of_vip)
 {
-	uint32_t i, j = 0, k = 0, len = 0;
-	
-	for (i = 0 ; i < num_of_vip; i++)
+	uint32_t len = 0;
+
+	if (num_of_vip)
 	{
-	    if (vip[i].family == AF_INET)
-	       j++;
-	    else
-	    {
-	       if (vip[i].family == AF_INET6)
-		  k++;
-	       else
-		  dps_log_debug(DpsProtocolLogLevel, "Tunnel Endpoint Invalid Family");
-	    }
+		// Up to one IPV4_ADDR_LIST_TLV and one IPV6_ADDR_LIST_TLV
+		len += ((2 * DPS_TLV_HDR_LEN) + (num_of_vip * DPS_IP6_ADDR_LEN));
 	}
-	if (j)
-	   len += (DPS_TLV_HDR_LEN + (j * DPS_IP4_ADDR_LEN));
-	if (k)
-	   len += (DPS_TLV_HDR_LEN + (k * DPS_IP6_ADDR_LEN));
 	return len;
 }
 
 static inline uint32_t 
-dps_calc_tunnel_tlv_len(uint32_t num_of_tunnels, dps_tunnel_endpoint_t *tunnel)
+dps_calc_tunnel_tlv_max_len(uint32_t num_of_tunnels)
 {
-	uint32_t i, len = 0;
-	
+	uint32_t len = 0;
+
 	if (num_of_tunnels)
-		len += DPS_TLV_HDR_LEN;
-	for (i =0 ; i < num_of_tunnels; i++)
 	{
-		if (tunnel[i].family == AF_INET)
-			len += DPS_IP4_TUNNEL_INFO_LEN;
-		else
-		{
-			if (tunnel[i].family == AF_INET6)
-				len += DPS_IP6_TUNNEL_INFO_LEN;
-			else
-				dps_log_debug(DpsProtocolLogLevel, "Tunnel Endpoint Invalid Family");
-		}
+		len += (DPS_TLV_HDR_LEN + (num_of_tunnels * DPS_IP6_TUNNEL_INFO_LEN));
 	}
 	return len;
 }
@@ -399,7 +1021,7 @@ dps_calc_endpoint_loc_reply_tlv_len(dps_endpoint_loc_reply_t *client_info)
 	else
 		len += DPS_IP6_TLV_LEN;
 	
-	len += dps_calc_tunnel_tlv_len(client_info->tunnel_info.num_of_tunnels, client_info->tunnel_info.tunnel_list);
+	len += dps_calc_tunnel_tlv_max_len(client_info->tunnel_info.num_of_tunnels);
 
 	return len;
 }
@@ -415,19 +1037,33 @@ dps_calc_endpoint_info_tlv_len(	dps_endpoint_info_t *client_data)
 	return len;
 }
 
+static inline uint32_t
+dps_calc_replication_entry_tlv_max_len(void)
+{
+	uint32_t len = DPS_REPLICATION_ENTRY_TLV_LEN;
+
+	// ENDPOINT_LOC_TLV with an IPv6 VIP and the first tunnel
+	len += (DPS_TLV_HDR_LEN + DPS_DATA_VER_LEN + DPS_EUID_TLV_LEN + DPS_IP6_TLV_LEN);
+	len += dps_calc_tunnel_tlv_max_len(1);
+	len += DPS_SVCLOC6_TLV_LEN;
+	return len;
+}
+
 /*
  ******************************************************************************
  * calc_pkt_len                                                           *//**
  *
  * \brief - This routine is called by all send functions that need to send a
  *          DPS protocol packet. The length is calculated based on the type of
- *          packet and the information it needs to encode.
+ *          packet and the information it needs to encode. It is only used
+ *          to size the buffer: for variable length lists it is an upper
+ *          bound computed from the entry counts, and the send functions
+ *          write the actual length into the header after encoding.
  *
  * \param[in] pkt_type - The DPS packet type
  * \param[in] req - The contents of the client data which needs to be encoded
  *
- * \retval 0 DPS_SUCCESS
- * \retval 1 DPS_FAILURE
+ * \return The size of the buffer needed to encode the packet
  *
  *
  ******************************************************************************
@@ -553,7 +1189,7 @@ static uint32_t calc_pkt_len(uint8_t pkt_type, void *req)
 				len += DPS_IP6_TLV_LEN;
 			}
 
-			len += dps_calc_tunnel_tlv_len(msg->tunnel_info.num_of_tunnels, msg->tunnel_info.tunnel_list);
+			len += dps_calc_tunnel_tlv_max_len(msg->tunnel_info.num_of_tunnels);
 
 			if (msg->dps_client_addr.family == AF_INET)
 			{
@@ -570,9 +1206,9 @@ static uint32_t calc_pkt_len(uint8_t pkt_type, void *req)
 		{
 			dps_endpoint_update_reply_t *msg = DPS_GET_CLIENT_ENDPT_UPDATE_REPLY(req);
 			len += (DPS_TLV_HDR_LEN + DPS_EUID_TLV_LEN + DPS_DATA_VER_LEN);
-			len += dps_calc_vip_tlv_len(msg->num_of_vip, msg->vm_ip_addr);
+			len += dps_calc_vip_tlv_max_len(msg->num_of_vip);
 
-			len += dps_calc_tunnel_tlv_len(msg->tunnel_info.num_of_tunnels, msg->tunnel_info.tunnel_list);
+			len += dps_calc_tunnel_tlv_max_len(msg->tunnel_info.num_of_tunnels);
 
 			break;
 		}
@@ -610,6 +1246,12 @@ static uint32_t calc_pkt_len(uint8_t pkt_type, void *req)
 			{
 				len += DPS_SVCLOC6_TLV_LEN;
 			}
+			// The sequence number of the broadcast list the DPS Client has
+			if ((pkt_type == DPS_BCAST_LIST_REQ) &&
+			    (((dps_client_data_t *)req)->hdr.sub_type == DPS_BCAST_LIST_SEQUENCED))
+			{
+				len += DPS_BCAST_LIST_DELTA_TLV_LEN;
+			}
 			break;
 		}
 
@@ -618,6 +1260,14 @@ static uint32_t calc_pkt_len(uint8_t pkt_type, void *req)
 		case DPS_UNSOLICITED_BCAST_LIST_REPLY:
 		{
 			dps_pkd_tunnel_list_t *client_data = &((dps_client_data_t *)req)->dove_switch_list;
+			if (((dps_client_data_t *)req)->hdr.sub_type == DPS_BCAST_LIST_SEQUENCED)
+			{
+				dps_bcast_list_delta_t *delta = &((dps_client_data_t *)req)->dove_switch_delta;
+				len += DPS_BCAST_LIST_DELTA_TLV_LEN;
+				len += ((delta->num_v4_add + delta->num_v4_del) * DPS_IP4_ADDR_LEN);
+				len += ((delta->num_v6_add + delta->num_v6_del) * DPS_IP6_ADDR_LEN);
+				break;
+			}
 			if (client_data->num_v4_tunnels)
 			{
 				len += (DPS_TLV_HDR_LEN + (client_data->num_v4_tunnels * DPS_IP4_ADDR_LEN));
@@ -740,6 +1390,22 @@ static uint32_t calc_pkt_len(uint8_t pkt_type, void *req)
 			len += DPS_SVCLOC6_TLV_LEN;
 			break;
 		}
+		case DPS_REPLICATION_BATCH:
+		{
+			dps_replication_batch_t *msg = &((dps_client_data_t *)req)->replication_batch;
+
+			len += DPS_REPLICATION_BATCH_TLV_LEN;
+			len += (msg->num_entries * dps_calc_replication_entry_tlv_max_len());
+			break;
+		}
+		case DPS_REPLICATION_BATCH_ACK:
+		{
+			dps_replication_ack_t *msg = &((dps_client_data_t *)req)->replication_ack;
+
+			len += DPS_REPLICATION_ACK_TLV_LEN;
+			len += (msg->num_errors * DPS_REPLICATION_ERROR_LEN);
+			break;
+		}
 		default:
 			dps_log_info(DpsProtocolLogLevel,"Invalid Msg Type %d", pkt_type);
 			break;
@@ -1268,6 +1934,70 @@ static uint32_t dps_set_ipv6_list_tlv(uint8_t *buff, uint8_t *client_buff, uint3
 	return (buff - recvbuf);
 	
 }
+
+/*
+ ******************************************************************************
+ * dps_set_bcast_list_delta_tlv                                           *//**
+ *
+ * \brief Construct a change to the broadcast list.
+ *
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |Version| BCAST_LIST_DELTA_TLV  |          Length              |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |                       Sequence Number                         |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |                     Base Sequence Number                      |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |       Num v4 Added            |       Num v4 Removed          |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |       Num v6 Added            |       Num v6 Removed          |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |        v4 added, v4 removed, v6 added, v6 removed addresses   |
+ *  |                             .                                 |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *
+ * \param[in] buff - To be filled in with the TLV
+ * \param[in] delta - The change to the broadcast list
+ *
+ * \retval  The number of bytes processed
+ *
+ ******************************************************************************
+ */
+static uint32_t dps_set_bcast_list_delta_tlv(uint8_t *buff, dps_bcast_list_delta_t *delta)
+{
+	uint8_t *recvbuf;
+	uint32_t i, num_v4, num_v6;
+
+	recvbuf = buff;
+	num_v4 = delta->num_v4_add + delta->num_v4_del;
+	num_v6 = delta->num_v6_add + delta->num_v6_del;
+
+	dps_set_tlv_hdr(buff, 1, BCAST_LIST_DELTA_TLV,
+	                (DPS_BCAST_LIST_DELTA_TLV_LEN - DPS_TLV_HDR_LEN) +
+	                (num_v4 * DPS_IP4_ADDR_LEN) + (num_v6 * DPS_IP6_ADDR_LEN));
+	buff += DPS_TLV_HDR_LEN;
+	*((uint32_t *)buff) = htonl(delta->seq_num);
+	buff += SZ_OF_INT32;
+	*((uint32_t *)buff) = htonl(delta->base_seq_num);
+	buff += SZ_OF_INT32;
+	*((uint16_t *)buff) = htons(delta->num_v4_add);
+	buff += SZ_OF_INT16;
+	*((uint16_t *)buff) = htons(delta->num_v4_del);
+	buff += SZ_OF_INT16;
+	*((uint16_t *)buff) = htons(delta->num_v6_add);
+	buff += SZ_OF_INT16;
+	*((uint16_t *)buff) = htons(delta->num_v6_del);
+	buff += SZ_OF_INT16;
+	for (i = 0; i < num_v4; i++)
+	{
+		*((uint32_t *)buff) = htonl(delta->tunnel_list[i]);
+		buff += DPS_IP4_ADDR_LEN;
+	}
+	memcpy(buff, &delta->tunnel_list[num_v4], num_v6 * DPS_IP6_ADDR_LEN);
+	buff += num_v6 * DPS_IP6_ADDR_LEN;
+
+	return (buff - recvbuf);
+}
 /*
  ******************************************************************************
  *  dps_set_ip4_info_tlv                                                   *//**
@@ -2112,25 +2842,171 @@ dps_set_vnid_tunnel_list_tlv(uint8_t *buff, dps_pkd_tunnel_list_t *client_data)
 static uint32_t
 dps_set_epri_tlv(uint8_t *buff, dps_epri_t *client_data)
 {
-	uint32_t len = 0;
+	uint32_t len = 0;
+	uint8_t *buff_start = buff;
+
+    // Make space for epri tlv hdr 
+	buff += DPS_TLV_HDR_LEN;
+
+	buff += dps_set_euid_tlv(buff, &client_data->vnid);
+
+	buff += dps_set_ip4_info_tlv(buff, &client_data->vm_ip4_addr);
+
+	buff += dps_set_ip6_info_tlv(buff, &client_data->vm_ip6_addr);
+	// encode tunnel endpoints
+	buff += dps_set_tunnel_list_tlv(buff, client_data->tunnel_info.tunnel_list, client_data->tunnel_info.num_of_tunnels);
+
+	len = buff - buff_start;
+
+	dps_set_tlv_hdr(buff_start, 1, EPRI_TLV, len - DPS_TLV_HDR_LEN);
+
+	return (len); 
+}
+
+/*
+ ******************************************************************************
+ * dps_set_replication_batch_tlv                                          *//**
+ *
+ * \brief Construct the header of a batch of replicated Endpoint Updates. The
+ *        REPLICATION_ENTRY_TLVs follow it.
+ *
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |Version| REPLICATION_BATCH_TLV |          Length              |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |                          Channel ID                           |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |                        Sequence Number                        |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |                       Number of Entries                       |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *
+ * \param[in] buff - To be filled in with the TLV
+ * \param[in] batch - The batch
+ *
+ * \retval DPS_REPLICATION_BATCH_TLV_LEN
+ *
+ ******************************************************************************
+ */
+static uint32_t dps_set_replication_batch_tlv(uint8_t *buff, dps_replication_batch_t *batch)
+{
+	dps_set_tlv_hdr(buff, 1, REPLICATION_BATCH_TLV,
+	                DPS_REPLICATION_BATCH_TLV_LEN - DPS_TLV_HDR_LEN);
+	buff += DPS_TLV_HDR_LEN;
+	*((uint32_t *)buff) = htonl(batch->channel_id);
+	buff += SZ_OF_INT32;
+	*((uint32_t *)buff) = htonl(batch->seq_num);
+	buff += SZ_OF_INT32;
+	*((uint32_t *)buff) = htonl(batch->num_entries);
+
+	return DPS_REPLICATION_BATCH_TLV_LEN;
+}
+
+/*
+ ******************************************************************************
+ * dps_set_replication_entry_tlv                                          *//**
+ *
+ * \brief Construct a replicated Endpoint Update. The ENDPOINT_LOC_TLV and the
+ *        SERVICE_LOC_TLV are the ones of a DPS_ENDPOINT_UPDATE.
+ *
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |Version| REPLICATION_ENTRY_TLV |          Length              |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |                             VNID                              |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |   Sub Type    |   Client ID   |           Reserved            |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |                       ENDPOINT_LOC_TLV                        |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |                       SERVICE_LOC_TLV                         |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *
+ * \param[in] buff - To be filled in with the TLV
+ * \param[in] entry - The replicated Endpoint Update
+ *
+ * \retval The number of bytes processed
+ *
+ ******************************************************************************
+ */
+static uint32_t dps_set_replication_entry_tlv(uint8_t *buff, dps_replication_entry_t *entry)
+{
+	uint8_t *buff_start = buff;
+	uint32_t len;
+
+	buff += DPS_TLV_HDR_LEN;
+	*((uint32_t *)buff) = htonl(entry->vnid);
+	buff += SZ_OF_INT32;
+	buff[0] = entry->sub_type;
+	buff[1] = entry->client_id;
+	*((uint16_t *)(buff + 2)) = 0;
+	buff += SZ_OF_INT32;
+	buff += dps_set_endpoint_update_tlv(buff, &entry->endpoint_update, 0);
+	buff += dps_set_svcloc_tlv(buff, &entry->endpoint_update.dps_client_addr);
+
+	len = buff - buff_start;
+	dps_set_tlv_hdr(buff_start, 1, REPLICATION_ENTRY_TLV, len - DPS_TLV_HDR_LEN);
+
+	return len;
+}
+
+/*
+ ******************************************************************************
+ * dps_set_replication_ack_tlv                                            *//**
+ *
+ * \brief Construct the cumulative ACK of a Replication Channel.
+ *
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |Version|  REPLICATION_ACK_TLV  |          Length              |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |                          Channel ID                           |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |                      ACK Sequence Number                      |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |                  Errors Complete From Sequence                |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |                       Number of Errors                        |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |                        Sequence Number                        |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |         Entry Index           |         Resp Status           |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |                               .                               |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *
+ * \param[in] buff - To be filled in with the TLV
+ * \param[in] ack - The ACK
+ *
+ * \retval The number of bytes processed
+ *
+ ******************************************************************************
+ */
+static uint32_t dps_set_replication_ack_tlv(uint8_t *buff, dps_replication_ack_t *ack)
+{
 	uint8_t *buff_start = buff;
+	uint32_t i;
 
-    // Make space for epri tlv hdr 
+	dps_set_tlv_hdr(buff, 1, REPLICATION_ACK_TLV,
+	                (DPS_REPLICATION_ACK_TLV_LEN - DPS_TLV_HDR_LEN) +
+	                (ack->num_errors * DPS_REPLICATION_ERROR_LEN));
 	buff += DPS_TLV_HDR_LEN;
+	*((uint32_t *)buff) = htonl(ack->channel_id);
+	buff += SZ_OF_INT32;
+	*((uint32_t *)buff) = htonl(ack->ack_seq_num);
+	buff += SZ_OF_INT32;
+	*((uint32_t *)buff) = htonl(ack->errors_seq_num);
+	buff += SZ_OF_INT32;
+	*((uint32_t *)buff) = htonl(ack->num_errors);
+	buff += SZ_OF_INT32;
+	for (i = 0; i < ack->num_errors; i++)
+	{
+		*((uint32_t *)buff) = htonl(ack->errors[i].seq_num);
+		buff += SZ_OF_INT32;
+		*((uint16_t *)buff) = htons(ack->errors[i].index);
+		buff += SZ_OF_INT16;
+		*((uint16_t *)buff) = htons(ack->errors[i].status);
+		buff += SZ_OF_INT16;
+	}
 
-	buff += dps_set_euid_tlv(buff, &client_data->vnid);
-
-	buff += dps_set_ip4_info_tlv(buff, &client_data->vm_ip4_addr);
-
-	buff += dps_set_ip6_info_tlv(buff, &client_data->vm_ip6_addr);
-	// encode tunnel endpoints
-	buff += dps_set_tunnel_list_tlv(buff, client_data->tunnel_info.tunnel_list, client_data->tunnel_info.num_of_tunnels);
-
-	len = buff - buff_start;
-
-	dps_set_tlv_hdr(buff_start, 1, EPRI_TLV, len - DPS_TLV_HDR_LEN);
-
-	return (len); 
+	return (buff - buff_start);
 }
 
 /*
@@ -2158,6 +3034,7 @@ uint32_t dps_get_pkt_hdr(dps_pkt_hdr_t *pkt_hdr, dps_client_hdr_t *client_hdr)
 	client_hdr->sub_type = (uint8_t)ntohs(pkt_hdr->sub_type);
 	client_hdr->client_id = pkt_hdr->client_id;
 	client_hdr->transaction_type = pkt_hdr->transaction_type;
+	client_hdr->payload_version = 0;
 	// the len of the packet does not include hdr tlv len(4) but the 
 	// DPS_PKT_HDR_LEN(20) includes the 4 bytes of tlv len.
 	return ((ntohs(pkt_hdr->len)<<2) - DPS_PKT_HDR_LEN + DPS_PKT_HDR_TLV_LEN);
@@ -2328,6 +3205,63 @@ static uint32_t dps_get_ipv6_list_tlv(uint8_t *buff, uint8_t *client_buff)
 	
 }
 
+/*
+ ******************************************************************************
+ * dps_get_bcast_list_delta_tlv                                           *//**
+ *
+ * \brief Parse a change to the broadcast list.
+ *
+ * \param[in] buff - Points to the beginning of the BCAST_LIST_DELTA_TLV
+ * \param[in] delta - To be filled in after parsing the TLV. Must have room
+ *                    for the addresses in the TLV.
+ *
+ * \retval  The number of bytes processed, 0 if the TLV is malformed
+ *
+ ******************************************************************************
+ */
+static uint32_t dps_get_bcast_list_delta_tlv(uint8_t *buff, dps_bcast_list_delta_t *delta)
+{
+	uint8_t *recvbuf;
+	dps_tlv_hdr_t tlv_hdr;
+	uint32_t i, num_v4, num_v6;
+
+	recvbuf = buff;
+	buff += dps_get_tlv_hdr(buff, &tlv_hdr);
+	if (DPS_GET_TLV_LEN(&tlv_hdr) < (DPS_BCAST_LIST_DELTA_TLV_LEN - DPS_TLV_HDR_LEN))
+	{
+		return 0;
+	}
+	delta->seq_num = ntohl(*((uint32_t *)buff));
+	buff += SZ_OF_INT32;
+	delta->base_seq_num = ntohl(*((uint32_t *)buff));
+	buff += SZ_OF_INT32;
+	delta->num_v4_add = ntohs(*((uint16_t *)buff));
+	buff += SZ_OF_INT16;
+	delta->num_v4_del = ntohs(*((uint16_t *)buff));
+	buff += SZ_OF_INT16;
+	delta->num_v6_add = ntohs(*((uint16_t *)buff));
+	buff += SZ_OF_INT16;
+	delta->num_v6_del = ntohs(*((uint16_t *)buff));
+	buff += SZ_OF_INT16;
+	num_v4 = delta->num_v4_add + delta->num_v4_del;
+	num_v6 = delta->num_v6_add + delta->num_v6_del;
+	if (DPS_GET_TLV_LEN(&tlv_hdr) != ((DPS_BCAST_LIST_DELTA_TLV_LEN - DPS_TLV_HDR_LEN) +
+	                                  (num_v4 * DPS_IP4_ADDR_LEN) +
+	                                  (num_v6 * DPS_IP6_ADDR_LEN)))
+	{
+		return 0;
+	}
+	for (i = 0; i < num_v4; i++)
+	{
+		delta->tunnel_list[i] = ntohl(*((uint32_t *)buff));
+		buff += DPS_IP4_ADDR_LEN;
+	}
+	memcpy(&delta->tunnel_list[num_v4], buff, num_v6 * DPS_IP6_ADDR_LEN);
+	buff += num_v6 * DPS_IP6_ADDR_LEN;
+
+	return (buff - recvbuf);
+}
+
 
 static uint32_t dps_get_ipv4_list_to_ipaddr(uint8_t *buff, ip_addr_t **dst_buff, uint32_t *num_of_vip, uint32_t max_vip)
 {
@@ -2515,20 +3449,59 @@ return ((uint8_t *)buff_ptr - recvbuf);
 }
 
 
+/**
+ * \brief The size of the buffer a packet carrying tunnel lists is decoded
+ *        into. Every tunnel takes at least DPS_IP4_TUNNEL_INFO_LEN bytes of
+ *        the packet and a dps_tunnel_endpoint_t once decoded.
+ */
+#define DPS_TUNNEL_DECODE_BUFF_LEN(_pkt_len) \
+	(sizeof(dps_client_data_t) + (((_pkt_len)/DPS_IP4_TUNNEL_INFO_LEN) * sizeof(dps_tunnel_endpoint_t)))
+
+/*
+ ******************************************************************************
+ * dps_tunnel_list_room                                                   *//**
+ *
+ * \brief Returns the number of tunnels that fit in a decode buffer from the
+ *        tunnel list to the end of the buffer.
+ *
+ * \param[in] client_buff - The decode buffer
+ * \param[in] buff_len - The size of the decode buffer
+ * \param[in] tunnel_list - The tunnel list inside the decode buffer
+ *
+ * \retval  The number of tunnels
+ *
+ ******************************************************************************
+ */
+static uint32_t dps_tunnel_list_room(void *client_buff, uint32_t buff_len,
+                                     dps_tunnel_endpoint_t *tunnel_list)
+{
+	uint32_t offset = (uint8_t *)tunnel_list - (uint8_t *)client_buff;
+
+	if (offset >= buff_len)
+	{
+		return 0;
+	}
+	return ((buff_len - offset)/sizeof(dps_tunnel_endpoint_t));
+}
+
 /*
  ******************************************************************************
  * dps_get_tunnel_list_tlv                                                *//**
  *
- * \brief TBD.
+ * \brief Parse a TUNNEL_LIST_TLV. Tunnels that don't fit in the client
+ *        buffer are dropped.
  *
- * \param[in] buff - Points to the beginning of ipv4 address list
- * \param[in] client_buff - To be filled in after parsing the ipv4 address list
+ * \param[in] buff - Points to the TUNNEL_LIST_TLV
+ * \param[in] client_buff - To be filled in with the tunnels
+ * \param[out] num_of_gw - The number of tunnels filled in
+ * \param[in] max_tunnels - The number of tunnels client_buff holds
  *
  * \retval  The number of bytes processed
  *
  ******************************************************************************
  */
-static uint32_t dps_get_tunnel_list_tlv(uint8_t *buff, dps_tunnel_endpoint_t *client_buff, uint16_t *num_of_gw)
+static uint32_t dps_get_tunnel_list_tlv(uint8_t *buff, dps_tunnel_endpoint_t *client_buff,
+                                        uint16_t *num_of_gw, uint32_t max_tunnels)
 {
 	uint8_t *bufptr, *recvbuf; 
 	dps_tlv_hdr_t tlv_hdr;
@@ -2542,6 +3515,13 @@ static uint32_t dps_get_tunnel_list_tlv(uint8_t *buff, dps_tunnel_endpoint_t *cl
 	              DPS_GET_TLV_LEN((&tlv_hdr)));
 	while ((buff - bufptr) < DPS_GET_TLV_LEN((&tlv_hdr)))
 	{
+		if (i >= max_tunnels)
+		{
+			dps_log_notice(DpsProtocolLogLevel, "Tunnel List TLV len %d exceeds %d tunnels",
+			               DPS_GET_TLV_LEN((&tlv_hdr)), max_tunnels);
+			*num_of_gw = i;
+			return (DPS_GET_TLV_LEN((&tlv_hdr)) + 4);
+		}
 		if (ntohs(*((uint16_t *)buff)) == 4) // AF_INET
 		{
 			buff += dps_get_ipv4_tunnel_info(buff, &client_buff[i]);
@@ -2568,7 +3548,8 @@ static uint32_t dps_get_tunnel_list_tlv(uint8_t *buff, dps_tunnel_endpoint_t *cl
 
 static uint32_t
 dps_get_endpoint_loc_reply_tlv(uint8_t *buff,
-                               dps_endpoint_loc_reply_t *endpoint_reply)
+                               dps_endpoint_loc_reply_t *endpoint_reply,
+                               uint32_t max_tunnels)
 {
 	uint8_t *buff_end, *buff_start = buff; 
 	dps_tlv_hdr_t tlv_hdr;
@@ -2600,7 +3581,7 @@ dps_get_endpoint_loc_reply_tlv(uint8_t *buff,
 			    break;
 		    case TUNNEL_LIST_TLV:
 			    // Get tunnel list
-			    buff += dps_get_tunnel_list_tlv(buff, endpoint_reply->tunnel_info.tunnel_list,  &(endpoint_reply->tunnel_info.num_of_tunnels));
+			    buff += dps_get_tunnel_list_tlv(buff, endpoint_reply->tunnel_info.tunnel_list,  &(endpoint_reply->tunnel_info.num_of_tunnels), max_tunnels);
 			    break;
 		    default:
 			    dps_log_info(DpsProtocolLogLevel,"Invalid TLV");
@@ -2616,7 +3597,8 @@ static uint32_t
 dps_get_endpoint_update_tlv(uint8_t *buff,
                             uint32_t pkt_len,
                             dps_endpoint_update_t *endpoint_update,
-                            ip_addr_t *sender_addr)
+                            ip_addr_t *sender_addr,
+                            uint32_t max_tunnels)
 {
 	uint8_t *buff_start = buff; 
 	uint8_t *buff_end = buff + pkt_len - 4; // -4 ignores the version which is always present
@@ -2649,7 +3631,7 @@ dps_get_endpoint_update_tlv(uint8_t *buff,
 			    break;
 		    case TUNNEL_LIST_TLV:
 			    // Get tunnel list
-			    buff += dps_get_tunnel_list_tlv(buff, endpoint_update->tunnel_info.tunnel_list,  &(endpoint_update->tunnel_info.num_of_tunnels));
+			    buff += dps_get_tunnel_list_tlv(buff, endpoint_update->tunnel_info.tunnel_list,  &(endpoint_update->tunnel_info.num_of_tunnels), max_tunnels);
 			    break;
 			default:
 			    dps_log_info(DpsProtocolLogLevel,"Invalid TLV");
@@ -2664,7 +3646,8 @@ error:
 
 static uint32_t
 dps_get_endpoint_update_reply_tlv(uint8_t *buff,
-                                  dps_endpoint_update_reply_t *endpoint_update)
+                                  dps_endpoint_update_reply_t *endpoint_update,
+                                  uint32_t max_tunnels)
 {
         uint32_t tlv_len = 0;
 	dps_tlv_hdr_t tlv_hdr;
@@ -2699,7 +3682,7 @@ dps_get_endpoint_update_reply_tlv(uint8_t *buff,
 		       break;
 	       case TUNNEL_LIST_TLV:
 		       // Get tunnel list
-		       buff += dps_get_tunnel_list_tlv(buff, endpoint_update->tunnel_info.tunnel_list,  &(endpoint_update->tunnel_info.num_of_tunnels));
+		       buff += dps_get_tunnel_list_tlv(buff, endpoint_update->tunnel_info.tunnel_list,  &(endpoint_update->tunnel_info.num_of_tunnels), max_tunnels);
 		       break;
 	        default:
 		        dps_log_info(DpsProtocolLogLevel,"Invalid TLV");
@@ -2852,7 +3835,7 @@ dps_get_vnid_tunnel_list_tlv(uint8_t *buff, dps_pkd_tunnel_list_t *client_data)
 }
 
 static uint32_t
-dps_get_epri_tlv(uint8_t *buff, dps_epri_t *epri)
+dps_get_epri_tlv(uint8_t *buff, dps_epri_t *epri, uint32_t max_tunnels)
 {
 	uint8_t *buff_start; 
 	dps_tlv_hdr_t tlv_hdr;
@@ -2884,7 +3867,7 @@ dps_get_epri_tlv(uint8_t *buff, dps_epri_t *epri)
 			    break;
 		    case TUNNEL_LIST_TLV:
 			    // Get tunnel list
-			    buff += dps_get_tunnel_list_tlv(buff, epri->tunnel_info.tunnel_list,  &(epri->tunnel_info.num_of_tunnels));
+			    buff += dps_get_tunnel_list_tlv(buff, epri->tunnel_info.tunnel_list,  &(epri->tunnel_info.num_of_tunnels), max_tunnels);
 			    break;
 		    default:
 			    dps_log_info(DpsProtocolLogLevel, "TLV type %d not suppoted len %d", 
@@ -2896,6 +3879,175 @@ dps_get_epri_tlv(uint8_t *buff, dps_epri_t *epri)
 	return ((buff - buff_start));
 }
 
+/*
+ * The most tunnels a REPLICATION_ENTRY_TLV is decoded with. Senders only
+ * replicate the first tunnel of an Endpoint Update.
+ */
+#define DPS_REPLICATION_ENTRY_MAX_TUNNELS 8
+
+static uint32_t dps_get_replication_batch_tlv(uint8_t *buff, dps_replication_batch_t *batch)
+{
+	buff += DPS_TLV_HDR_LEN;
+	batch->channel_id = ntohl(*((uint32_t *)buff));
+	buff += SZ_OF_INT32;
+	batch->seq_num = ntohl(*((uint32_t *)buff));
+	buff += SZ_OF_INT32;
+	batch->num_entries = ntohl(*((uint32_t *)buff));
+	return DPS_REPLICATION_BATCH_TLV_LEN;
+}
+
+/*
+ ******************************************************************************
+ * dps_get_replication_entry_tlv                                          *//**
+ *
+ * \brief Parse a replicated Endpoint Update. The ENDPOINT_LOC_TLV is decoded
+ *        in a scratch buffer since it may carry more tunnels than the entry
+ *        holds; only the first one is kept.
+ *
+ * \param[in] buff - Points to the REPLICATION_ENTRY_TLV
+ * \param[in] len - The number of bytes left in the packet
+ * \param[out] entry - To be filled in
+ *
+ * \retval The number of bytes processed
+ * \retval 0 The TLV is malformed
+ *
+ ******************************************************************************
+ */
+static uint32_t dps_get_replication_entry_tlv(uint8_t *buff, uint32_t len,
+                                              dps_replication_entry_t *entry)
+{
+	dps_tlv_hdr_t tlv_hdr;
+	struct {
+		dps_endpoint_update_t endpoint_update;
+		dps_tunnel_endpoint_t tunnel_list[DPS_REPLICATION_ENTRY_MAX_TUNNELS];
+	} scratch;
+	uint8_t *buff_end;
+	uint32_t tlv_len, num_tunnels, ret_len = 0;
+
+	do
+	{
+		dps_get_tlv_hdr(buff, &tlv_hdr);
+		tlv_len = DPS_GET_TLV_LEN(&tlv_hdr);
+		if ((DPS_GET_TLV_TYPE(&tlv_hdr) != REPLICATION_ENTRY_TLV) ||
+		    (tlv_len < (DPS_REPLICATION_ENTRY_TLV_LEN - DPS_TLV_HDR_LEN)) ||
+		    ((tlv_len + DPS_TLV_HDR_LEN) > len))
+		{
+			dps_log_info(DpsProtocolLogLevel, "Invalid Replication Entry TLV");
+			break;
+		}
+		buff_end = buff + DPS_TLV_HDR_LEN + tlv_len;
+		buff += DPS_TLV_HDR_LEN;
+		memset(entry, 0, sizeof(dps_replication_entry_t));
+		entry->vnid = ntohl(*((uint32_t *)buff));
+		buff += SZ_OF_INT32;
+		entry->sub_type = buff[0];
+		entry->client_id = buff[1];
+		buff += SZ_OF_INT32;
+
+		// ENDPOINT_LOC_TLV
+		dps_get_tlv_hdr(buff, &tlv_hdr);
+		if ((DPS_GET_TLV_TYPE(&tlv_hdr) != ENDPOINT_LOC_TLV) ||
+		    ((buff + DPS_TLV_HDR_LEN + DPS_GET_TLV_LEN(&tlv_hdr)) > buff_end))
+		{
+			dps_log_info(DpsProtocolLogLevel, "Invalid Replication Entry Endpoint TLV");
+			break;
+		}
+		// Bounds the tunnels the TLV can hold
+		num_tunnels = DPS_GET_TLV_LEN(&tlv_hdr)/DPS_IP4_TUNNEL_INFO_LEN;
+		if (num_tunnels > DPS_REPLICATION_ENTRY_MAX_TUNNELS)
+		{
+			dps_log_info(DpsProtocolLogLevel, "Replication Entry Endpoint TLV too long %d",
+			             DPS_GET_TLV_LEN(&tlv_hdr));
+			break;
+		}
+		memset(&scratch.endpoint_update, 0, sizeof(dps_endpoint_update_t));
+		buff += dps_get_endpoint_update_tlv(buff, buff_end - buff, &scratch.endpoint_update, NULL,
+		                                    dps_tunnel_list_room(&scratch, sizeof(scratch),
+		                                                         scratch.endpoint_update.tunnel_info.tunnel_list));
+		memcpy(&entry->endpoint_update, &scratch.endpoint_update, sizeof(dps_endpoint_update_t));
+		if (entry->endpoint_update.tunnel_info.num_of_tunnels > 1)
+		{
+			entry->endpoint_update.tunnel_info.num_of_tunnels = 1;
+		}
+
+		// SERVICE_LOC_TLV
+		if ((buff + DPS_SVCLOC4_TLV_LEN) > buff_end)
+		{
+			dps_log_info(DpsProtocolLogLevel, "Replication Entry without Service Location");
+			break;
+		}
+		dps_get_tlv_hdr(buff, &tlv_hdr);
+		if ((DPS_GET_TLV_TYPE(&tlv_hdr) != SERVICE_LOC_TLV) ||
+		    ((buff + DPS_TLV_HDR_LEN + DPS_GET_TLV_LEN(&tlv_hdr)) > buff_end))
+		{
+			dps_log_info(DpsProtocolLogLevel, "Invalid Replication Entry Service Location");
+			break;
+		}
+		dps_get_svcloc_tlv(buff, &entry->endpoint_update.dps_client_addr);
+		ret_len = tlv_len + DPS_TLV_HDR_LEN;
+	}while(0);
+
+	return ret_len;
+}
+
+/*
+ ******************************************************************************
+ * dps_get_replication_ack_tlv                                            *//**
+ *
+ * \brief Parse the cumulative ACK of a Replication Channel
+ *
+ * \param[in] buff - Points to the REPLICATION_ACK_TLV
+ * \param[in] len - The number of bytes left in the packet
+ * \param[out] ack - To be filled in
+ *
+ * \retval The number of bytes processed
+ * \retval 0 The TLV is malformed
+ *
+ ******************************************************************************
+ */
+static uint32_t dps_get_replication_ack_tlv(uint8_t *buff, uint32_t len,
+                                            dps_replication_ack_t *ack)
+{
+	dps_tlv_hdr_t tlv_hdr;
+	uint32_t tlv_len, i;
+
+	dps_get_tlv_hdr(buff, &tlv_hdr);
+	tlv_len = DPS_GET_TLV_LEN(&tlv_hdr);
+	if ((tlv_len < (DPS_REPLICATION_ACK_TLV_LEN - DPS_TLV_HDR_LEN)) ||
+	    ((tlv_len + DPS_TLV_HDR_LEN) > len))
+	{
+		dps_log_info(DpsProtocolLogLevel, "Invalid Replication ACK TLV");
+		return 0;
+	}
+	buff += DPS_TLV_HDR_LEN;
+	ack->channel_id = ntohl(*((uint32_t *)buff));
+	buff += SZ_OF_INT32;
+	ack->ack_seq_num = ntohl(*((uint32_t *)buff));
+	buff += SZ_OF_INT32;
+	ack->errors_seq_num = ntohl(*((uint32_t *)buff));
+	buff += SZ_OF_INT32;
+	ack->num_errors = ntohl(*((uint32_t *)buff));
+	buff += SZ_OF_INT32;
+	if ((ack->num_errors > DPS_REPLICATION_ACK_ERRORS_MAX) ||
+	    (tlv_len != ((DPS_REPLICATION_ACK_TLV_LEN - DPS_TLV_HDR_LEN) +
+	                 (ack->num_errors * DPS_REPLICATION_ERROR_LEN))))
+	{
+		dps_log_info(DpsProtocolLogLevel, "Invalid Replication ACK errors %d",
+		             ack->num_errors);
+		return 0;
+	}
+	for (i = 0; i < ack->num_errors; i++)
+	{
+		ack->errors[i].seq_num = ntohl(*((uint32_t *)buff));
+		buff += SZ_OF_INT32;
+		ack->errors[i].index = ntohs(*((uint16_t *)buff));
+		buff += SZ_OF_INT16;
+		ack->errors[i].status = ntohs(*((uint16_t *)buff));
+		buff += SZ_OF_INT16;
+	}
+	return (tlv_len + DPS_TLV_HDR_LEN);
+}
+
 /*******************************************************************************
  *                             Packet Send Functions
  *******************************************************************************/
@@ -2948,7 +4100,7 @@ static uint32_t dps_send_endpoint_loc_req(void *client_req, void *cli_addr)
 
 	bufptr = buff;
 
-	buff += dps_set_pkt_hdr(buff, DPS_ENDPOINT_LOC_REQ, (dps_client_data_t *)client_req, len);
+	buff += DPS_PKT_HDR_LEN;
 
 	buff += dps_set_euid_tlv(buff, &client_data->vnid);
 
@@ -2970,6 +4122,8 @@ static uint32_t dps_send_endpoint_loc_req(void *client_req, void *cli_addr)
 		buff += dps_set_svcloc_tlv(buff, &(client_data->dps_client_addr));
 	}
 
+	len = buff - bufptr;
+	dps_set_pkt_hdr(bufptr, DPS_ENDPOINT_LOC_REQ, (dps_client_data_t *)client_req, len);
 	dump_pkt(bufptr, len);
 
 	status = dps_protocol_xmit(bufptr, (buff - bufptr), &client_hdr->reply_addr, ((dps_client_data_t *)client_req)->context);
@@ -3037,13 +4191,15 @@ static uint32_t dps_send_endpoint_loc_reply(void *client_req, void *cli_addr)
 		}
 
 		bufptr = buff;
-		buff += dps_set_pkt_hdr(buff, client_hdr->type, (dps_client_data_t *)client_req, len);
+		buff += DPS_PKT_HDR_LEN;
 		if (len != DPS_PKT_HDR_LEN)
 		{
 			// set endpoint location tlv which has a number of sub-tlvs
 			buff += dps_set_endpoint_loc_reply_tlv(buff, client_data);
 		}
 
+		len = buff - bufptr;
+		dps_set_pkt_hdr(bufptr, client_hdr->type, (dps_client_data_t *)client_req, len);
 		status = dps_protocol_xmit(bufptr, (buff - bufptr),
 		                           &client_hdr->reply_addr,
 		                           ((dps_client_data_t *)client_req)->context);
@@ -3177,7 +4333,7 @@ static uint32_t dps_send_endpoint_update_reply(void *client_req, void *cli_addr)
 
 	bufptr = buff;
 
-	buff += dps_set_pkt_hdr(buff, DPS_ENDPOINT_UPDATE_REPLY, (dps_client_data_t *)client_req, len);
+	buff += DPS_PKT_HDR_LEN;
 
 	if (len != DPS_PKT_HDR_LEN) 
 	{
@@ -3185,6 +4341,8 @@ static uint32_t dps_send_endpoint_update_reply(void *client_req, void *cli_addr)
 		buff += dps_set_endpoint_update_reply_tlv(buff, client_data, len-DPS_PKT_HDR_LEN);
  	}
 	
+	len = buff - bufptr;
+	dps_set_pkt_hdr(bufptr, DPS_ENDPOINT_UPDATE_REPLY, (dps_client_data_t *)client_req, len);
 	dump_pkt(bufptr, len);
 	status = dps_protocol_xmit(bufptr, (buff - bufptr), &client_hdr->reply_addr, ((dps_client_data_t *)client_req)->context);
 
@@ -3249,7 +4407,7 @@ static uint32_t dps_send_policy_req(void *client_req, void *cli_addr)
 
 	bufptr = buff;
 
-	buff += dps_set_pkt_hdr(buff, DPS_POLICY_REQ, (dps_client_data_t *)client_req, len);
+	buff += DPS_PKT_HDR_LEN;
 
 	//encode dest_endpoint info_tlv
 	buff += dps_set_endpoint_info_tlv(buff, &client_data->dst_endpoint);
@@ -3264,6 +4422,8 @@ static uint32_t dps_send_policy_req(void *client_req, void *cli_addr)
 		buff += dps_set_svcloc_tlv(buff, &(client_data->dps_client_addr));
 	}
 
+	len = buff - bufptr;
+	dps_set_pkt_hdr(bufptr, DPS_POLICY_REQ, (dps_client_data_t *)client_req, len);
 	status = dps_protocol_xmit(bufptr, (buff - bufptr), &client_hdr->reply_addr, ((dps_client_data_t *)client_req)->context);
 
 	dps_free_buff(bufptr);
@@ -3327,11 +4487,13 @@ static uint32_t dps_send_policy_reply(void *client_req, void *cli_addr)
 
 	bufptr = buff;
 
-	buff += dps_set_pkt_hdr(buff, DPS_POLICY_REPLY, (dps_client_data_t *)client_req, len);
+	buff += DPS_PKT_HDR_LEN;
 
 	// set policy reply tlv which has a number of sub-tlvs
 	buff += dps_set_policy_reply_tlv(buff, client_data, client_hdr, len - DPS_PKT_HDR_LEN);
 
+	len = buff - bufptr;
+	dps_set_pkt_hdr(bufptr, DPS_POLICY_REPLY, (dps_client_data_t *)client_req, len);
 	dump_pkt(bufptr, len);
 	dps_protocol_xmit(bufptr, (buff - bufptr), &client_hdr->reply_addr, ((dps_client_data_t *)client_req)->context);
 
@@ -3394,7 +4556,7 @@ static uint32_t dps_send_internal_gw_reply(void *client_req, void *cli_addr)
 	}
 
 	bufptr = buff;
-	buff += dps_set_pkt_hdr(buff, client_hdr->type, (dps_client_data_t *)client_req, len);
+	buff += DPS_PKT_HDR_LEN;
 
 	if (len != DPS_PKT_HDR_LEN)
 	{
@@ -3412,6 +4574,8 @@ static uint32_t dps_send_internal_gw_reply(void *client_req, void *cli_addr)
 		}
 	}
 
+	len = buff - bufptr;
+	dps_set_pkt_hdr(bufptr, client_hdr->type, (dps_client_data_t *)client_req, len);
 	dump_pkt(bufptr,len);
 	status = dps_protocol_xmit(bufptr, (buff - bufptr), &client_hdr->reply_addr, ((dps_client_data_t *)client_req)->context);
 	dps_free_buff(bufptr);
@@ -3452,19 +4616,249 @@ static uint32_t dps_send_gen_msg_req(void *client_req, void *cli_addr)
 	}
 
 	bufptr = buff;
-	buff += dps_set_pkt_hdr(buff, client_hdr->type, (dps_client_data_t *)client_req, len);
+	buff += DPS_PKT_HDR_LEN;
 
 
 	if ((client_data->dps_client_addr.family == AF_INET) ||
 	    (client_data->dps_client_addr.family == AF_INET6))
 	{
-	    buff += dps_set_svcloc_tlv(buff, &(client_data->dps_client_addr));
+	    buff += dps_set_svcloc_tlv(buff, &(client_data->dps_client_addr));
+	}
+
+	if ((client_hdr->type == DPS_BCAST_LIST_REQ) &&
+	    (client_hdr->sub_type == DPS_BCAST_LIST_SEQUENCED))
+	{
+		dps_bcast_list_delta_t have;
+
+		// Only the sequence number of the list the DPS Client has
+		memset(&have, 0, sizeof(have));
+		have.seq_num = client_data->bcast_seq_num;
+		have.base_seq_num = client_data->bcast_seq_num;
+		buff += dps_set_bcast_list_delta_tlv(buff, &have);
+	}
+
+	len = buff - bufptr;
+	dps_set_pkt_hdr(bufptr, client_hdr->type, (dps_client_data_t *)client_req, len);
+	status = dps_protocol_xmit(bufptr, (buff - bufptr), &client_hdr->reply_addr, ((dps_client_data_t *)client_req)->context);
+	dps_free_buff(bufptr);
+	dps_log_info(DpsProtocolLogLevel, "Exit");
+	return status;	
+}
+
+/*
+ ******************************************************************************
+ * Payload Cache                                                          *//**
+ *
+ * \brief The Broadcast List and Gateway List replies for a VNID rarely change
+ *        but are sent over and over, typically to every Dove Switch in the
+ *        VNID in turn. Each thread keeps the encoded TLVs of the last few of
+ *        these replies keyed on the version of the list they were encoded
+ *        from. If the next reply of the same type for the same VNID carries
+ *        the same version of the list, the TLVs are copied instead of being
+ *        encoded again and only the header is rewritten. Lists without a
+ *        version (0) are never cached.
+ *
+ ******************************************************************************
+ */
+
+/**
+ * \brief The number of entries in the Payload Cache of every thread. Must be
+ *        a power of 2.
+ */
+#define DPS_PAYLOAD_CACHE_SZ 64
+
+/**
+ * \brief Encoded payloads larger than this are not cached
+ */
+#define DPS_PAYLOAD_CACHE_MAX_LEN 8192
+
+typedef struct dps_payload_cache_entry_s{
+	/**
+	 * \brief The Packet Type, 0 if the entry is not in use
+	 */
+	uint32_t	pkt_type;
+	uint32_t	vnid;
+	/**
+	 * \brief The version of the list the payload was encoded from
+	 */
+	uint64_t	version;
+	/**
+	 * \brief The length of the encoded payload
+	 */
+	uint32_t	payload_len;
+	/**
+	 * \brief The allocated size of data
+	 */
+	uint32_t	data_size;
+	/**
+	 * \brief The encoded payload
+	 */
+	uint8_t		*data;
+} dps_payload_cache_entry_t;
+
+typedef struct dps_payload_cache_s{
+	dps_payload_cache_entry_t entry[DPS_PAYLOAD_CACHE_SZ];
+} dps_payload_cache_t;
+
+/**
+ * \brief The Payload Cache Statistics, summed over all threads
+ */
+static struct {
+	unsigned long int	hit;
+	unsigned long int	miss;
+} dps_payload_cache_stats;
+
+static pthread_key_t dps_payload_cache_key;
+static pthread_once_t dps_payload_cache_key_once = PTHREAD_ONCE_INIT;
+
+static void dps_payload_cache_destroy(void *arg)
+{
+	dps_payload_cache_t *cache = (dps_payload_cache_t *)arg;
+	int i;
+
+	for (i = 0; i < DPS_PAYLOAD_CACHE_SZ; i++)
+	{
+		if (cache->entry[i].data != NULL)
+		{
+			free(cache->entry[i].data);
+		}
+	}
+	free(cache);
+	return;
+}
+
+static void dps_payload_cache_key_create(void)
+{
+	pthread_key_create(&dps_payload_cache_key, dps_payload_cache_destroy);
+	return;
+}
+
+/*
+ ******************************************************************************
+ * dps_payload_cache_entry_get                                            *//**
+ *
+ * \brief - Returns the Payload Cache entry of the calling thread that a
+ *          Packet Type and VNID map to
+ *
+ * \param[in] pkt_type - The DPS packet type
+ * \param[in] vnid - The VNID
+ *
+ * \return Pointer to the entry, NULL if no memory
+ *
+ ******************************************************************************
+ */
+
+static dps_payload_cache_entry_t *dps_payload_cache_entry_get(uint8_t pkt_type,
+                                                              uint32_t vnid)
+{
+	dps_payload_cache_t *cache;
+	uint32_t index;
+
+	pthread_once(&dps_payload_cache_key_once, dps_payload_cache_key_create);
+	cache = (dps_payload_cache_t *)pthread_getspecific(dps_payload_cache_key);
+	if (cache == NULL)
+	{
+		cache = (dps_payload_cache_t *)malloc(sizeof(dps_payload_cache_t));
+		if (cache == NULL)
+		{
+			return NULL;
+		}
+		memset(cache, 0, sizeof(dps_payload_cache_t));
+		pthread_setspecific(dps_payload_cache_key, cache);
+	}
+	index = ((vnid * 2654435761U) ^ pkt_type) & (DPS_PAYLOAD_CACHE_SZ - 1);
+	return &cache->entry[index];
+}
+
+/*
+ ******************************************************************************
+ * dps_payload_cache_get                                                  *//**
+ *
+ * \brief - Copies the cached payload for a version of a list into buff
+ *
+ * \param[in] pkt_type - The DPS packet type
+ * \param[in] vnid - The VNID
+ * \param[in] version - The version of the list to be encoded, 0 if none
+ * \param[in] buff - Where the payload is copied to
+ *
+ * \return The length of the payload copied, 0 if it is not cached
+ *
+ ******************************************************************************
+ */
+
+static uint32_t dps_payload_cache_get(uint8_t pkt_type, uint32_t vnid,
+                                      uint64_t version, uint8_t *buff)
+{
+	dps_payload_cache_entry_t *entry;
+
+	if (version == 0)
+	{
+		return 0;
+	}
+	entry = dps_payload_cache_entry_get(pkt_type, vnid);
+	if ((entry == NULL) ||
+	    (entry->pkt_type != pkt_type) ||
+	    (entry->vnid != vnid) ||
+	    (entry->version != version))
+	{
+		__sync_fetch_and_add(&dps_payload_cache_stats.miss, 1);
+		return 0;
+	}
+	memcpy(buff, entry->data, entry->payload_len);
+	__sync_fetch_and_add(&dps_payload_cache_stats.hit, 1);
+	return entry->payload_len;
+}
+
+/*
+ ******************************************************************************
+ * dps_payload_cache_put                                                  *//**
+ *
+ * \brief - Stores the encoded payload of a version of a list, replacing
+ *          whatever the entry held before
+ *
+ * \param[in] pkt_type - The DPS packet type
+ * \param[in] vnid - The VNID
+ * \param[in] version - The version of the list that was encoded, 0 if none
+ * \param[in] payload - The encoded payload
+ * \param[in] payload_len - The length of the encoded payload
+ *
+ ******************************************************************************
+ */
+
+static void dps_payload_cache_put(uint8_t pkt_type, uint32_t vnid,
+                                  uint64_t version,
+                                  uint8_t *payload, uint32_t payload_len)
+{
+	dps_payload_cache_entry_t *entry;
+	uint8_t *data;
+
+	if ((version == 0) || (payload_len == 0) ||
+	    (payload_len > DPS_PAYLOAD_CACHE_MAX_LEN))
+	{
+		return;
 	}
-
-	status = dps_protocol_xmit(bufptr, (buff - bufptr), &client_hdr->reply_addr, ((dps_client_data_t *)client_req)->context);
-	dps_free_buff(bufptr);
-	dps_log_info(DpsProtocolLogLevel, "Exit");
-	return status;	
+	entry = dps_payload_cache_entry_get(pkt_type, vnid);
+	if (entry == NULL)
+	{
+		return;
+	}
+	entry->pkt_type = 0;
+	if (entry->data_size < payload_len)
+	{
+		data = (uint8_t *)realloc(entry->data, payload_len);
+		if (data == NULL)
+		{
+			return;
+		}
+		entry->data = data;
+		entry->data_size = payload_len;
+	}
+	memcpy(entry->data, payload, payload_len);
+	entry->vnid = vnid;
+	entry->version = version;
+	entry->payload_len = payload_len;
+	entry->pkt_type = pkt_type;
+	return;
 }
 
 /*
@@ -3486,6 +4880,9 @@ static uint32_t dps_send_gen_msg_req(void *client_req, void *cli_addr)
  *  |                        IPV6_ADDR_LIST_TLV (optional)          |
  *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
  *
+ *        With sub_type DPS_BCAST_LIST_SEQUENCED the list is carried in a
+ *        single BCAST_LIST_DELTA_TLV instead.
+ *
  * \param[in] client_req - A pointer to a message that the client wants to send
  * \param[in] cli_addr - The address of the dove switch.
  *
@@ -3499,7 +4896,10 @@ static uint32_t dps_send_bcast_list_reply(void *client_req, void *cli_addr)
 	uint8_t *buff, *bufptr;
 	dps_client_hdr_t *client_hdr = DPS_GET_CLIENT_HDR(client_req);
 	dps_pkd_tunnel_list_t *client_data = &((dps_client_data_t *)client_req)->dove_switch_list;
+	dps_bcast_list_delta_t *delta = &((dps_client_data_t *)client_req)->dove_switch_delta;
 	uint32_t *client_switch, len, status = DPS_SUCCESS;
+	uint32_t payload_len;
+	uint64_t version;
 
 	dps_log_info(DpsProtocolLogLevel, "Enter");
 
@@ -3526,24 +4926,58 @@ static uint32_t dps_send_bcast_list_reply(void *client_req, void *cli_addr)
 		}
 
 		bufptr = buff;
-		buff += dps_set_pkt_hdr(buff, client_hdr->type, (dps_client_data_t *)client_req, len);
+		buff += DPS_PKT_HDR_LEN;
 
-		if (len != DPS_PKT_HDR_LEN)
+		if ((len != DPS_PKT_HDR_LEN) && (client_hdr->sub_type == DPS_BCAST_LIST_SEQUENCED))
 		{
-			client_switch = client_data->tunnel_list;
-
-			if (client_data->num_v4_tunnels)
+			// Every DPS Client one change behind gets the same change: The
+			// change from base_seq_num to seq_num never differs
+			version = (((uint64_t)delta->base_seq_num) << 32) | delta->seq_num;
+			payload_len = dps_payload_cache_get(client_hdr->type, client_hdr->vnid,
+			                                    version, buff);
+			if (payload_len)
 			{
-				buff += dps_set_ipv4_list_tlv(buff, client_switch, client_data->num_v4_tunnels);
-				//Advance switch list by the number of v4 switches
-				client_switch += client_data->num_v4_tunnels;
+				buff += payload_len;
 			}
-			if (client_data->num_v6_tunnels)
+			else
+			{
+				buff += dps_set_bcast_list_delta_tlv(buff, delta);
+				dps_payload_cache_put(client_hdr->type, client_hdr->vnid, version,
+				                      bufptr + DPS_PKT_HDR_LEN,
+				                      (uint32_t)(buff - bufptr) - DPS_PKT_HDR_LEN);
+			}
+		}
+		else if (len != DPS_PKT_HDR_LEN)
+		{
+			payload_len = dps_payload_cache_get(client_hdr->type, client_hdr->vnid,
+			                                    client_hdr->payload_version, buff);
+			if (payload_len)
 			{
-				buff += dps_set_ipv6_list_tlv(buff, (uint8_t *)client_switch, client_data->num_v6_tunnels);
+				buff += payload_len;
+			}
+			else
+			{
+				client_switch = client_data->tunnel_list;
+
+				if (client_data->num_v4_tunnels)
+				{
+					buff += dps_set_ipv4_list_tlv(buff, client_switch, client_data->num_v4_tunnels);
+					//Advance switch list by the number of v4 switches
+					client_switch += client_data->num_v4_tunnels;
+				}
+				if (client_data->num_v6_tunnels)
+				{
+					buff += dps_set_ipv6_list_tlv(buff, (uint8_t *)client_switch, client_data->num_v6_tunnels);
+				}
+				dps_payload_cache_put(client_hdr->type, client_hdr->vnid,
+				                      client_hdr->payload_version,
+				                      bufptr + DPS_PKT_HDR_LEN,
+				                      (uint32_t)(buff - bufptr) - DPS_PKT_HDR_LEN);
 			}
 		}
 
+		len = buff - bufptr;
+		dps_set_pkt_hdr(bufptr, client_hdr->type, (dps_client_data_t *)client_req, len);
 		dump_pkt(bufptr,len);
 		status = dps_protocol_xmit(bufptr,
 		                           (buff - bufptr),
@@ -3624,10 +5058,11 @@ static uint32_t dps_send_bulk_policy_xfer(void *client_req, void *cli_addr)
 		}
 
 		bufptr = buff;
-		buff += dps_set_pkt_hdr(buff, client_hdr->type,
-		                        (dps_client_data_t *)client_req, len);
+		buff += DPS_PKT_HDR_LEN;
 		buff += dps_set_bulk_policy_xfer(buff, client_data, len - DPS_PKT_HDR_LEN);
 
+		len = buff - bufptr;
+		dps_set_pkt_hdr(bufptr, client_hdr->type, (dps_client_data_t *)client_req, len);
 		dump_pkt(bufptr, len);
 		status = dps_protocol_xmit(bufptr,
 		                           (buff - bufptr),
@@ -3670,6 +5105,7 @@ static uint32_t dps_send_gw_list(void *client_req, void *cli_addr)
 	dps_tunnel_list_t *client_data = &((dps_client_data_t *)client_req)->tunnel_info;
 	uint32_t len = 0;
 	uint32_t status = DPS_SUCCESS;
+	uint32_t payload_len;
 
 	dps_log_info(DpsProtocolLogLevel, "Enter");
 
@@ -3690,13 +5126,27 @@ static uint32_t dps_send_gw_list(void *client_req, void *cli_addr)
 		{
 			dps_log_error(DpsProtocolLogLevel,"No memory");
 			status = DPS_ERROR;
+			break;
 		}
 
 		bufptr = buff;
 		buff += DPS_PKT_HDR_LEN;
 		if (len != DPS_PKT_HDR_LEN)
 		{
-			buff += dps_set_tunnel_list_tlv(buff, client_data->tunnel_list, client_data->num_of_tunnels);
+			payload_len = dps_payload_cache_get(client_hdr->type, client_hdr->vnid,
+			                                    client_hdr->payload_version, buff);
+			if (payload_len)
+			{
+				buff += payload_len;
+			}
+			else
+			{
+				buff += dps_set_tunnel_list_tlv(buff, client_data->tunnel_list, client_data->num_of_tunnels);
+				dps_payload_cache_put(client_hdr->type, client_hdr->vnid,
+				                      client_hdr->payload_version,
+				                      bufptr + DPS_PKT_HDR_LEN,
+				                      (uint32_t)(buff - bufptr) - DPS_PKT_HDR_LEN);
+			}
 		}
 		len = buff - bufptr;
 		dps_set_pkt_hdr(bufptr, client_hdr->type, (dps_client_data_t *)client_req, len);
@@ -3836,12 +5286,14 @@ static uint32_t dps_send_vm_migration_event(void *client_req, void *cli_addr)
 
 	bufptr = buff;
 
-	buff += dps_set_pkt_hdr(buff, DPS_VM_MIGRATION_EVENT, (dps_client_data_t *)client_req, len);
+	buff += DPS_PKT_HDR_LEN;
 
 	buff += dps_set_endpoint_info_tlv(buff, &client_data->migrated_vm_info);
 	// set endpoint location tlv which has a number of sub-tlvs
 	buff += dps_set_endpoint_loc_reply_tlv(buff, &client_data->src_vm_loc);
 
+	len = buff - bufptr;
+	dps_set_pkt_hdr(bufptr, DPS_VM_MIGRATION_EVENT, (dps_client_data_t *)client_req, len);
 	status = dps_protocol_xmit(bufptr, (buff - bufptr), &client_hdr->reply_addr, ((dps_client_data_t *)client_req)->context);
 
 	dps_free_buff(bufptr);
@@ -3898,7 +5350,7 @@ static uint32_t dps_send_mcast_sender_reg_dereg(void *client_req, void *cli_addr
 	}
 
 	bufptr = buff;
-	buff += dps_set_pkt_hdr(buff, (dps_client_req_type)client_hdr->type, (dps_client_data_t *)client_req, len);
+	buff += DPS_PKT_HDR_LEN;
 
 	while (((uint32_t)(buff - bufptr)) < len)
 	{
@@ -3912,6 +5364,8 @@ static uint32_t dps_send_mcast_sender_reg_dereg(void *client_req, void *cli_addr
 		}
 	}
 
+	len = buff - bufptr;
+	dps_set_pkt_hdr(bufptr, (dps_client_req_type)client_hdr->type, (dps_client_data_t *)client_req, len);
 	status = dps_protocol_xmit(bufptr, (buff - bufptr), &client_hdr->reply_addr, ((dps_client_data_t *)client_req)->context);
 	dps_free_buff(bufptr);
 	dps_log_info(DpsProtocolLogLevel, "Exit");
@@ -3967,7 +5421,7 @@ static uint32_t dps_send_mcast_receiver_join_leave(void *client_req, void *cli_a
 	}
 
 	bufptr = buff;
-	buff += dps_set_pkt_hdr(buff, (dps_client_req_type)client_hdr->type, (dps_client_data_t *)client_req, len);
+	buff += DPS_PKT_HDR_LEN;
 
 	while (((uint32_t)(buff - bufptr)) < len)
 	{
@@ -3983,6 +5437,8 @@ static uint32_t dps_send_mcast_receiver_join_leave(void *client_req, void *cli_a
 		}
 	}
 
+	len = buff - bufptr;
+	dps_set_pkt_hdr(bufptr, (dps_client_req_type)client_hdr->type, (dps_client_data_t *)client_req, len);
 	dump_pkt(bufptr,len);
 
 	status = dps_protocol_xmit(bufptr, (buff - bufptr), &client_hdr->reply_addr, ((dps_client_data_t *)client_req)->context);
@@ -4108,6 +5564,8 @@ static uint32_t dps_client_create_general_ack(dps_client_data_t *client_buff)
 {
 	dps_client_data_t client_data;
 
+	// Acks are never retransmitted
+	client_data.context = NULL;
 	client_data.hdr = ((dps_client_data_t *)client_buff)->hdr;
 
 	if (client_data.hdr.query_id != 0)
@@ -4218,137 +5676,461 @@ static uint32_t dps_send_policy_invalidate(void *client_req, void *cli_addr)
 
 static uint32_t dps_send_addr_resolve(void *client_req, void *cli_addr)
 {
-	uint32_t len = 0;
+	uint32_t len = 0;
+	uint8_t *buff, *bufptr;
+	uint32_t status = DPS_SUCCESS;
+	dps_client_hdr_t *client_hdr = DPS_GET_CLIENT_HDR(client_req);
+	dps_endpoint_loc_req_t *client_data = (dps_endpoint_loc_req_t *)&(((dps_client_data_t *)(client_req))->address_resolve);
+
+	dps_log_info(DpsProtocolLogLevel, "Enter");
+	do
+	{
+		dump_client_info((dps_client_data_t *)client_req);
+		len = calc_pkt_len(DPS_ADDR_RESOLVE, (void *)client_req);
+		if ((buff = dps_alloc_buff(len)) == NULL)
+		{
+			dps_log_error(DpsProtocolLogLevel,"No memory");
+			status = DPS_ERROR;
+			break;
+		}
+
+		bufptr = buff;
+		buff += DPS_PKT_HDR_LEN;
+		buff += dps_set_euid_tlv(buff, &client_data->vnid);
+
+		// Request for endpoint is indexed via vip/vMac/EUID sent by the client
+		if (client_data-> vm_ip_addr.family == AF_INET)
+		{
+			buff += dps_set_ip4_tlv(buff,client_data-> vm_ip_addr.ip4);
+		}
+		else if (client_data->vm_ip_addr.family == AF_INET6)
+		{
+			buff += dps_set_ip6_tlv(buff, client_data-> vm_ip_addr.ip6);
+		}
+
+		// DPS Client Location - If provided
+		if ((client_data->dps_client_addr.family == AF_INET) ||
+		    (client_data->dps_client_addr.family == AF_INET6))
+		{
+			buff += dps_set_svcloc_tlv(buff, &(client_data->dps_client_addr));
+		}
+		len = buff - bufptr;
+		dps_set_pkt_hdr(bufptr, client_hdr->type, (dps_client_data_t *)client_req, len);
+		dump_pkt(bufptr, len);
+		status = dps_protocol_xmit(bufptr, (buff - bufptr),
+		                           &client_hdr->reply_addr,
+		                           ((dps_client_data_t *)client_req)->context);
+		dps_free_buff(bufptr);
+	}while(0);
+	dps_log_info(DpsProtocolLogLevel, "Exit");
+	return status;
+}
+
+/*
+ ******************************************************************************
+ * dps_send_addr_reply                                                    *//**
+ *
+ * \brief TBD.
+ *
+ * \param[in] client_req - A pointer to a message that the client wants to send
+ * \param[in] cli_addr - Not used, it is a NULL value.
+ *
+ * \retval 0 DPS_SUCCESS
+ * \retval 1 DPS_FAILURE
+ *
+ ******************************************************************************
+ */
+
+static uint32_t dps_send_addr_reply(void *client_req, void *cli_addr)
+{
+	dps_log_notice(DpsProtocolLogLevel,"Not implemented");
+	return DPS_SUCCESS;
+}
+
+/*
+ ******************************************************************************
+ * dps_send_invalidate_vm                                                 *//**
+ *
+ * \brief This msg is sent to all DOVE switches in the domain to update the VMs
+ *        location if present in the forwarding table. This message is sent
+ *        in response to a migration_in event sent by the DOVE switch to which
+ *        the VM has moved.
+ *
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |                         Header                                |
+ *  |                                                               |
+ *  |                                                               |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |                        EPRI_TLV                               |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *
+ * \param[in] client_req - A pointer to a message that the client wants to send
+ * \param[in] cli_addr - Not used, it is a NULL value.
+ *
+ * \retval 0 DPS_SUCCESS
+ * \retval 1 DPS_FAILURE
+ *
+ ******************************************************************************
+ */
+static uint32_t dps_send_vm_loc_info(void *client_req, void *cli_addr)
+{
+	uint32_t len = 0;
+	uint8_t *buff, *buff_start;
+	uint32_t status = DPS_SUCCESS;
+
+	dps_client_hdr_t *client_hdr = DPS_GET_CLIENT_HDR(client_req);
+	
+	dps_epri_t *client_data = (dps_epri_t *)&(((dps_client_data_t *)(client_req))->vm_invalidate_msg.epri);
+
+	dps_log_info(DpsProtocolLogLevel, "Enter");
+
+	do
+	{
+		dump_client_info((dps_client_data_t *)client_req);
+		
+		if ((buff = dps_alloc_buff(DPS_MAX_BUFF_SZ)) == NULL)
+		{
+			dps_log_error(DpsProtocolLogLevel,"No memory");
+			return DPS_ERROR;
+		}
+	
+		buff_start = buff;
+		buff += DPS_PKT_HDR_LEN;
+		
+		// set epri_tlv which has a number of sub-tlvs
+		buff += dps_set_epri_tlv(buff, client_data);
+
+		len = buff-buff_start;
+		dps_set_pkt_hdr(buff_start, client_hdr->type, (dps_client_data_t *)client_req, len);
+		dump_pkt(buff_start, len);
+		dps_protocol_xmit(buff_start, len, &client_hdr->reply_addr, ((dps_client_data_t *)client_req)->context);
+	} while(0);
+
+	dps_free_buff(buff_start);
+	dps_log_info(DpsProtocolLogLevel, "Exit");
+	return status;
+}
+
+/*
+ ******************************************************************************
+ * dps_send_replication_batch                                             *//**
+ *
+ * \brief This routine is called by a DPS Server to send a sequenced batch of
+ *        Endpoint Updates on the Replication Channel of a Domain to another
+ *        DPS Server.
+ *
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |                         Header                                |
+ *  |                                                               |
+ *  |                                                               |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |                        REPLICATION_BATCH_TLV                  |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |                        REPLICATION_ENTRY_TLV                  |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |                               .                               |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *
+ * \param[in] client_req - A pointer to a message that the client wants to send
+ * \param[in] cli_addr - Not used, it is a NULL value.
+ *
+ * \retval 0 DPS_SUCCESS
+ * \retval 1 DPS_FAILURE
+ *
+ ******************************************************************************
+ */
+static uint32_t dps_send_replication_batch(void *client_req, void *cli_addr)
+{
+	uint32_t len, i;
+	uint8_t *buff, *bufptr;
+	uint32_t status = DPS_SUCCESS;
+	dps_client_hdr_t *client_hdr = DPS_GET_CLIENT_HDR(client_req);
+	dps_replication_batch_t *batch = &((dps_client_data_t *)client_req)->replication_batch;
+
+	dps_log_info(DpsProtocolLogLevel, "Enter");
+
+	if ((batch->num_entries == 0) || (batch->num_entries > DPS_REPLICATION_BATCH_MAX))
+	{
+		dps_log_error(DpsProtocolLogLevel,"Replication Batch with %d entries",
+		              batch->num_entries);
+		return DPS_ERROR;
+	}
+
+	len = calc_pkt_len(DPS_REPLICATION_BATCH, client_req);
+	if ((buff = dps_alloc_buff(len)) == NULL)
+	{
+		dps_log_error(DpsProtocolLogLevel,"No memory");
+		return DPS_ERROR;
+	}
+
+	bufptr = buff;
+	buff += DPS_PKT_HDR_LEN;
+	buff += dps_set_replication_batch_tlv(buff, batch);
+	for (i = 0; i < batch->num_entries; i++)
+	{
+		buff += dps_set_replication_entry_tlv(buff, &batch->entries[i]);
+	}
+
+	dps_set_pkt_hdr(bufptr, DPS_REPLICATION_BATCH, (dps_client_data_t *)client_req, (buff - bufptr));
+	dump_pkt(bufptr, (buff - bufptr));
+
+	status = dps_protocol_xmit(bufptr, (buff - bufptr), &client_hdr->reply_addr, ((dps_client_data_t *)client_req)->context);
+
+	dps_free_buff(bufptr);
+	dps_log_info(DpsProtocolLogLevel, "Exit");
+	return status;
+}
+
+/*
+ ******************************************************************************
+ * dps_send_replication_ack                                               *//**
+ *
+ * \brief This routine is called by a DPS Server to acknowledge all batches
+ *        received in order on a Replication Channel.
+ *
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |                         Header                                |
+ *  |                                                               |
+ *  |                                                               |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *  |                        REPLICATION_ACK_TLV                    |
+ *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *
+ * \param[in] client_req - A pointer to a message that the client wants to send
+ * \param[in] cli_addr - Not used, it is a NULL value.
+ *
+ * \retval 0 DPS_SUCCESS
+ * \retval 1 DPS_FAILURE
+ *
+ ******************************************************************************
+ */
+static uint32_t dps_send_replication_ack(void *client_req, void *cli_addr)
+{
+	uint32_t len;
 	uint8_t *buff, *bufptr;
 	uint32_t status = DPS_SUCCESS;
 	dps_client_hdr_t *client_hdr = DPS_GET_CLIENT_HDR(client_req);
-	dps_endpoint_loc_req_t *client_data = (dps_endpoint_loc_req_t *)&(((dps_client_data_t *)(client_req))->address_resolve);
+	dps_replication_ack_t *ack = &((dps_client_data_t *)client_req)->replication_ack;
 
 	dps_log_info(DpsProtocolLogLevel, "Enter");
-	do
+
+	if (ack->num_errors > DPS_REPLICATION_ACK_ERRORS_MAX)
 	{
-		dump_client_info((dps_client_data_t *)client_req);
-		len = calc_pkt_len(DPS_ADDR_RESOLVE, (void *)client_req);
-		if ((buff = dps_alloc_buff(len)) == NULL)
-		{
-			dps_log_error(DpsProtocolLogLevel,"No memory");
-			status = DPS_ERROR;
-			break;
-		}
+		ack->num_errors = DPS_REPLICATION_ACK_ERRORS_MAX;
+	}
 
-		bufptr = buff;
-		buff += dps_set_pkt_hdr(buff, client_hdr->type, (dps_client_data_t *)client_req, len);
-		buff += dps_set_euid_tlv(buff, &client_data->vnid);
+	len = calc_pkt_len(DPS_REPLICATION_BATCH_ACK, client_req);
+	if ((buff = dps_alloc_buff(len)) == NULL)
+	{
+		dps_log_error(DpsProtocolLogLevel,"No memory");
+		return DPS_ERROR;
+	}
 
-		// Request for endpoint is indexed via vip/vMac/EUID sent by the client
-		if (client_data-> vm_ip_addr.family == AF_INET)
-		{
-			buff += dps_set_ip4_tlv(buff,client_data-> vm_ip_addr.ip4);
-		}
-		else if (client_data->vm_ip_addr.family == AF_INET6)
-		{
-			buff += dps_set_ip6_tlv(buff, client_data-> vm_ip_addr.ip6);
-		}
+	bufptr = buff;
+	buff += DPS_PKT_HDR_LEN;
+	buff += dps_set_replication_ack_tlv(buff, ack);
 
-		// DPS Client Location - If provided
-		if ((client_data->dps_client_addr.family == AF_INET) ||
-		    (client_data->dps_client_addr.family == AF_INET6))
-		{
-			buff += dps_set_svcloc_tlv(buff, &(client_data->dps_client_addr));
-		}
-		dump_pkt(bufptr, len);
-		status = dps_protocol_xmit(bufptr, (buff - bufptr),
-		                           &client_hdr->reply_addr,
-		                           ((dps_client_data_t *)client_req)->context);
-		dps_free_buff(bufptr);
-	}while(0);
+	dps_set_pkt_hdr(bufptr, DPS_REPLICATION_BATCH_ACK, (dps_client_data_t *)client_req, (buff - bufptr));
+	dump_pkt(bufptr, (buff - bufptr));
+
+	status = dps_protocol_xmit(bufptr, (buff - bufptr), &client_hdr->reply_addr, ((dps_client_data_t *)client_req)->context);
+
+	dps_free_buff(bufptr);
 	dps_log_info(DpsProtocolLogLevel, "Exit");
 	return status;
 }
 
+/*******************************************************************************
+ *                             Packet View Functions
+ *******************************************************************************/
+
+/*
+ * The number of ENDPOINT_INFO_TLVs a Policy Request can carry: the
+ * destination endpoint followed by the source endpoint.
+ */
+#define DPS_PKT_VIEW_MAX_ENDPOINTS 2
+
 /*
  ******************************************************************************
- * dps_send_addr_reply                                                    *//**
+ * dps_pkt_view_t                                                         *//**
  *
- * \brief TBD.
+ * \brief A read-only view of a received DPS packet. The TLV chain is walked
+ *        and bounds checked once by dps_pkt_view_init(), which records where
+ *        each TLV lives in the receive buffer. The TLVs are then decoded in
+ *        place through the dps_get_*_tlv routines straight into the
+ *        dps_client_data_t handed to the Data Handler, without the pooled
+ *        buffer. When a TLV type repeats the last one is recorded.
  *
- * \param[in] client_req - A pointer to a message that the client wants to send
- * \param[in] cli_addr - Not used, it is a NULL value.
+ ******************************************************************************
+ */
+typedef struct dps_pkt_view_s {
+	/**
+	 * \brief The beginning of the packet (the DPS header)
+	 */
+	uint8_t *pkt;
+	/**
+	 * \brief The length of the TLV area following the DPS header
+	 */
+	uint32_t pkt_len;
+	/**
+	 * \brief VMAC_TLV, NULL if not present
+	 */
+	uint8_t *vmac;
+	/**
+	 * \brief IP_ADDR_TLV, NULL if not present
+	 */
+	uint8_t *ip;
+	/**
+	 * \brief EUID_TLV, NULL if not present
+	 */
+	uint8_t *euid;
+	/**
+	 * \brief SERVICE_LOC_TLV or REPLY_SERVICE_LOC_TLV, NULL if not present
+	 */
+	uint8_t *svcloc;
+	/**
+	 * \brief ENDPOINT_INFO_TLVs in the order they appear in the packet
+	 */
+	uint8_t *endpoint[DPS_PKT_VIEW_MAX_ENDPOINTS];
+	uint32_t num_endpoints;
+} dps_pkt_view_t;
+
+#define DPS_PKT_VIEW_TLV(_type) (1 << (_type))
+
+/*
+ ******************************************************************************
+ * dps_pkt_view_tlv_len                                                   *//**
  *
- * \retval 0 DPS_SUCCESS
- * \retval 1 DPS_FAILURE
+ * \brief - Returns the number of bytes a TLV occupies on the wire. The size
+ *          is derived from the TLV type and version the same way the
+ *          dps_get_*_tlv routines advance through the packet.
+ *
+ * \param[in] tlv - Points to the beginning of the TLV
+ * \param[in] avail - The number of bytes left in the packet from tlv onwards
+ *
+ * \return The TLV length, 0 if the TLV is unknown or does not fit in avail
  *
  ******************************************************************************
  */
-
-static uint32_t dps_send_addr_reply(void *client_req, void *cli_addr)
+static uint32_t dps_pkt_view_tlv_len(uint8_t *tlv, uint32_t avail)
 {
-	dps_log_notice(DpsProtocolLogLevel,"Not implemented");
-	return DPS_SUCCESS;
+	dps_tlv_hdr_t tlv_hdr;
+	uint32_t len = 0;
+
+	if (avail < DPS_TLV_HDR_LEN)
+	{
+		return 0;
+	}
+	dps_get_tlv_hdr(tlv, &tlv_hdr);
+	switch (DPS_GET_TLV_TYPE(&tlv_hdr))
+	{
+		case VMAC_TLV:
+			len = DPS_VMAC_TLV_LEN;
+			break;
+		case IP_ADDR_TLV:
+			len = (tlv[0] == 4) ? DPS_IP4_TLV_LEN : DPS_IP6_TLV_LEN;
+			break;
+		case EUID_TLV:
+			len = DPS_EUID_TLV_LEN;
+			break;
+		case SERVICE_LOC_TLV:
+		case REPLY_SERVICE_LOC_TLV:
+			len = (tlv[0] == 4) ? DPS_SVCLOC4_TLV_LEN : DPS_SVCLOC6_TLV_LEN;
+			break;
+		case ENDPOINT_INFO_TLV:
+			// The VM IP Address follows as a sub-tlv
+			len = DPS_TLV_HDR_LEN + 12;
+			if (avail < len + DPS_TLV_HDR_LEN)
+			{
+				return 0;
+			}
+			len += (tlv[len] == 4) ? DPS_IP4_TLV_LEN : DPS_IP6_TLV_LEN;
+			break;
+		default:
+			break;
+	}
+	if (len > avail)
+	{
+		len = 0;
+	}
+	return len;
 }
 
 /*
  ******************************************************************************
- * dps_send_invalidate_vm                                                 *//**
- *
- * \brief This msg is sent to all DOVE switches in the domain to update the VMs
- *        location if present in the forwarding table. This message is sent
- *        in response to a migration_in event sent by the DOVE switch to which
- *        the VM has moved.
+ * dps_pkt_view_init                                                      *//**
  *
- *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
- *  |                         Header                                |
- *  |                                                               |
- *  |                                                               |
- *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
- *  |                        EPRI_TLV                               |
- *  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ * \brief - Validates the TLV chain of a received packet and records the
+ *          location of every TLV. Any TLV whose type is not in tlv_mask, or
+ *          which extends past the end of the packet, fails the whole packet.
  *
- * \param[in] client_req - A pointer to a message that the client wants to send
- * \param[in] cli_addr - Not used, it is a NULL value.
+ * \param[in] view - The view to initialize
+ * \param[in] recv_buff - The received packet starting with the DPS header
+ * \param[in] client_hdr - Filled in with the decoded DPS header
+ * \param[in] tlv_mask - DPS_PKT_VIEW_TLV() bits of the TLVs accepted
  *
- * \retval 0 DPS_SUCCESS
- * \retval 1 DPS_FAILURE
+ * \retval DPS_SUCCESS
+ * \retval DPS_ERROR
  *
  ******************************************************************************
  */
-static uint32_t dps_send_vm_loc_info(void *client_req, void *cli_addr)
+static uint32_t dps_pkt_view_init(dps_pkt_view_t *view, uint8_t *recv_buff,
+                                  dps_client_hdr_t *client_hdr, uint32_t tlv_mask)
 {
-	uint32_t len = 0;
-	uint8_t *buff, *buff_start;
-	uint32_t status = DPS_SUCCESS;
-
-	dps_client_hdr_t *client_hdr = DPS_GET_CLIENT_HDR(client_req);
-	
-	dps_epri_t *client_data = (dps_epri_t *)&(((dps_client_data_t *)(client_req))->vm_invalidate_msg.epri);
+	uint8_t *buff, *buff_end;
+	uint32_t tlv_len;
+	uint8_t tlv_type;
 
-	dps_log_info(DpsProtocolLogLevel, "Enter");
+	memset(view, 0, sizeof(dps_pkt_view_t));
+	view->pkt = recv_buff;
+	// dps_process_rcvd_pkt has checked the len against the datagram
+	view->pkt_len = dps_get_pkt_hdr((dps_pkt_hdr_t *)recv_buff, client_hdr);
+	if (view->pkt_len > (DPS_MAX_BUFF_SZ - DPS_PKT_HDR_LEN))
+	{
+		dps_log_info(DpsProtocolLogLevel, "Invalid packet len %d", view->pkt_len);
+		return DPS_ERROR;
+	}
 
-	do
+	buff = recv_buff + DPS_PKT_HDR_LEN;
+	buff_end = buff + view->pkt_len;
+	while (buff < buff_end)
 	{
-		dump_client_info((dps_client_data_t *)client_req);
-		
-		if ((buff = dps_alloc_buff(DPS_MAX_BUFF_SZ)) == NULL)
+		tlv_type = DPS_GET_TLV_TYPE((dps_tlv_hdr_t *)buff);
+		tlv_len = dps_pkt_view_tlv_len(buff, (uint32_t)(buff_end - buff));
+		if ((tlv_len == 0) || (tlv_type >= 32) ||
+		    !(tlv_mask & DPS_PKT_VIEW_TLV(tlv_type)))
 		{
-			dps_log_error(DpsProtocolLogLevel,"No memory");
+			dps_log_info(DpsProtocolLogLevel, "Invalid TLV %d", tlv_type);
 			return DPS_ERROR;
 		}
-	
-		buff_start = buff;
-		buff += DPS_PKT_HDR_LEN;
-		
-		// set epri_tlv which has a number of sub-tlvs
-		buff += dps_set_epri_tlv(buff, client_data);
-
-		len = buff-buff_start;
-		dps_set_pkt_hdr(buff_start, client_hdr->type, (dps_client_data_t *)client_req, len);
-		dump_pkt(buff_start, len);
-		dps_protocol_xmit(buff_start, len, &client_hdr->reply_addr, ((dps_client_data_t *)client_req)->context);
-	} while(0);
+		switch (tlv_type)
+		{
+			case VMAC_TLV:
+				view->vmac = buff;
+				break;
+			case IP_ADDR_TLV:
+				view->ip = buff;
+				break;
+			case EUID_TLV:
+				view->euid = buff;
+				break;
+			case SERVICE_LOC_TLV:
+			case REPLY_SERVICE_LOC_TLV:
+				view->svcloc = buff;
+				break;
+			case ENDPOINT_INFO_TLV:
+				if (view->num_endpoints >= DPS_PKT_VIEW_MAX_ENDPOINTS)
+				{
+					dps_log_info(DpsProtocolLogLevel, "Too many Endpoint Info TLVs");
+					return DPS_ERROR;
+				}
+				view->endpoint[view->num_endpoints++] = buff;
+				break;
+		}
+		buff += tlv_len;
+	}
 
-	dps_free_buff(buff_start);
-	dps_log_info(DpsProtocolLogLevel, "Exit");
-	return status;
+	return DPS_SUCCESS;
 }
 
 /*******************************************************************************
@@ -4374,65 +6156,57 @@ static uint32_t dps_send_vm_loc_info(void *client_req, void *cli_addr)
 
 static uint32_t dps_process_endpoint_loc_req(void *recv_buff, void *senders_addr)
 {
-	dps_endpoint_loc_req_t *endpoint_req = NULL;
-	dps_client_data_t *client_buff;
-	uint32_t pkt_len;
-	dps_tlv_hdr_t tlv_hdr;	
-	uint8_t *buff = (uint8_t *)recv_buff;
+	dps_endpoint_loc_req_t *endpoint_req;
+	dps_client_data_t client_msg;
+	dps_pkt_view_t view;
 
 	dps_log_info(DpsProtocolLogLevel, "Enter");
-	
-	if ((client_buff = (dps_client_data_t *)dps_alloc_buff(sizeof(dps_client_data_t))) == NULL)
-	{
-		dps_log_error(DpsProtocolLogLevel,"No memory");
-		return DPS_ERROR;
-	}
 
-	endpoint_req = (dps_endpoint_loc_req_t *)&(client_buff->endpoint_loc_req);
+	client_msg.context = NULL;
+	memset(&client_msg.hdr, 0, sizeof(dps_client_hdr_t));
+	endpoint_req = &client_msg.endpoint_loc_req;
+	memset(endpoint_req, 0, sizeof(dps_endpoint_loc_req_t));
 
 	// Set hdr info
-	pkt_len = dps_get_pkt_hdr((dps_pkt_hdr_t *)recv_buff, &client_buff->hdr);
-	client_buff->hdr.reply_addr = *((ip_addr_t *)senders_addr);
+	if (dps_pkt_view_init(&view, (uint8_t *)recv_buff, &client_msg.hdr,
+	                      DPS_PKT_VIEW_TLV(VMAC_TLV) |
+	                      DPS_PKT_VIEW_TLV(IP_ADDR_TLV) |
+	                      DPS_PKT_VIEW_TLV(EUID_TLV) |
+	                      DPS_PKT_VIEW_TLV(SERVICE_LOC_TLV) |
+	                      DPS_PKT_VIEW_TLV(REPLY_SERVICE_LOC_TLV)) != DPS_SUCCESS)
+	{
+		dps_log_info(DpsProtocolLogLevel, "Exit: Invalid packet");
+		return DPS_ERROR;
+	}
+	client_msg.hdr.reply_addr = *((ip_addr_t *)senders_addr);
 
+	dps_log_debug(DpsProtocolLogLevel, "packet len %d", view.pkt_len);
+
+	// Materialize only the TLVs present in the packet. The EUID and the
+	// VMAC TLV both carry the MAC, the one later in the packet wins.
+	if (view.euid != NULL)
+	{
+		dps_get_euid_tlv(view.euid, &endpoint_req->vnid);
+	}
+	if ((view.vmac != NULL) && ((view.euid == NULL) || (view.vmac > view.euid)))
+	{
+		dps_get_vmac_tlv(view.vmac, endpoint_req->mac);
+	}
+	if (view.ip != NULL)
+	{
+		dps_get_ip_tlv(view.ip, &endpoint_req->vm_ip_addr);
+	}
 	// Assume DPS Client to be the Sender's Location
 	endpoint_req->dps_client_addr = *((ip_addr_t *)senders_addr);
-
-	dps_log_debug(DpsProtocolLogLevel, "packet len %d", pkt_len);
-	buff += DPS_PKT_HDR_LEN;
-
-	// Go to the end of buffer
-	while (buff < ((uint8_t *)recv_buff + DPS_PKT_HDR_LEN + pkt_len))
+	if (view.svcloc != NULL)
 	{
-		dps_get_tlv_hdr(buff, &tlv_hdr);
-		switch (DPS_GET_TLV_TYPE(&tlv_hdr))
-		{
-			case VMAC_TLV:
-				buff += dps_get_vmac_tlv(buff, endpoint_req->mac);
-				break;
-			case IP_ADDR_TLV:
-				buff += dps_get_ip_tlv(buff, &endpoint_req->vm_ip_addr);
-				break;
-			case EUID_TLV:
-				buff += dps_get_euid_tlv(buff, &endpoint_req->vnid);
-				break;
-			case REPLY_SERVICE_LOC_TLV:
-			case SERVICE_LOC_TLV:
-				// Update the DPS Client Location
-				buff += dps_get_svcloc_tlv(buff, &endpoint_req->dps_client_addr);
-				break;
-			default:
-				dps_log_info(DpsProtocolLogLevel, "Invalid TLV");
-			    goto error;
-			    break;
-		}
-	
+		// Update the DPS Client Location
+		dps_get_svcloc_tlv(view.svcloc, &endpoint_req->dps_client_addr);
 	}
 
-	dump_client_info(client_buff);
+	dump_client_info(&client_msg);
 
-	dps_send_to_protocol_client((void *)client_buff);
-error:
-	dps_free_buff((uint8_t *)client_buff);
+	dps_send_to_protocol_client((void *)&client_msg);
 
 	dps_log_info(DpsProtocolLogLevel, "Exit");
 
@@ -4465,20 +6239,23 @@ static uint32_t dps_process_endpoint_loc_reply(void *recv_buff,
 	dps_endpoint_loc_reply_t *endpoint_reply;
 	dps_client_data_t *client_buff;
 	dps_client_hdr_t hdr;
-	uint32_t pkt_len, ret_status = DPS_SUCCESS;
+	uint32_t pkt_len, buff_len, max_tunnels, ret_status = DPS_SUCCESS;
 	uint8_t *buff = (uint8_t *)recv_buff;
 
 	dps_log_info(DpsProtocolLogLevel, "Enter");
 
 	pkt_len = dps_get_pkt_hdr((dps_pkt_hdr_t *)recv_buff, &hdr);
+	buff_len = DPS_TUNNEL_DECODE_BUFF_LEN(pkt_len);
 
-	if ((client_buff = (dps_client_data_t *)dps_alloc_buff(sizeof(dps_client_data_t) + (pkt_len))) == NULL)
+	if ((client_buff = (dps_client_data_t *)dps_alloc_buff(buff_len)) == NULL)
 	{
 		dps_log_error(DpsProtocolLogLevel,"No memory");
 		return DPS_ERROR;
 	}
 
 	endpoint_reply = (dps_endpoint_loc_reply_t *)&(client_buff->endpoint_loc_reply);
+	max_tunnels = dps_tunnel_list_room(client_buff, buff_len,
+	                                   endpoint_reply->tunnel_info.tunnel_list);
 
 	// Set hdr info
 	client_buff->hdr = hdr;
@@ -4496,7 +6273,7 @@ static uint32_t dps_process_endpoint_loc_reply(void *recv_buff,
 
 	while (buff < ((uint8_t *)recv_buff + DPS_PKT_HDR_LEN + pkt_len))
 	{
-		buff += dps_get_endpoint_loc_reply_tlv(buff, endpoint_reply);
+		buff += dps_get_endpoint_loc_reply_tlv(buff, endpoint_reply, max_tunnels);
 	}
 
 	dump_client_info(client_buff);
@@ -4541,7 +6318,7 @@ static uint32_t dps_process_endpoint_update(void *recv_buff, void *senders_addr)
 {
 	dps_endpoint_update_t *endpoint_update;
 	dps_client_data_t *client_buff;
-	uint32_t pkt_len;
+	uint32_t pkt_len, buff_len, max_tunnels;
 	dps_client_hdr_t hdr;
 	dps_tlv_hdr_t tlv_hdr;	
 	uint8_t *buff = (uint8_t *)recv_buff;
@@ -4549,13 +6326,16 @@ static uint32_t dps_process_endpoint_update(void *recv_buff, void *senders_addr)
 	dps_log_info(DpsProtocolLogLevel, "Enter");
 
 	pkt_len = dps_get_pkt_hdr((dps_pkt_hdr_t *)recv_buff, &hdr);
-	if ((client_buff = (dps_client_data_t *)dps_alloc_buff(sizeof(dps_client_data_t) + pkt_len)) == NULL)
+	buff_len = DPS_TUNNEL_DECODE_BUFF_LEN(pkt_len);
+	if ((client_buff = (dps_client_data_t *)dps_alloc_buff(buff_len)) == NULL)
 	{
 		dps_log_error(DpsProtocolLogLevel,"No memory");
 		return DPS_ERROR;
 	}
-	dps_log_info(DpsProtocolLogLevel, "Alloc Buff Len %d", pkt_len + sizeof(dps_client_data_t));
+	dps_log_info(DpsProtocolLogLevel, "Alloc Buff Len %d", buff_len);
 	endpoint_update = (dps_endpoint_update_t *)&(client_buff->endpoint_update);
+	max_tunnels = dps_tunnel_list_room(client_buff, buff_len,
+	                                   endpoint_update->tunnel_info.tunnel_list);
 
 	// Set hdr info
 	client_buff->hdr = hdr;
@@ -4576,7 +6356,8 @@ static uint32_t dps_process_endpoint_update(void *recv_buff, void *senders_addr)
 			    buff += dps_get_endpoint_update_tlv(buff,
 			                                        pkt_len,
 			                                        endpoint_update,
-			                                        (ip_addr_t *)senders_addr);
+			                                        (ip_addr_t *)senders_addr,
+			                                        max_tunnels);
 			    break;
 		    case SERVICE_LOC_TLV:
 		    case REPLY_SERVICE_LOC_TLV:
@@ -4623,7 +6404,7 @@ static uint32_t dps_process_endpoint_update_reply(void *recv_buff,
 {
 	dps_endpoint_update_reply_t *endpoint_reply;
 	dps_client_data_t *client_buff;
-	uint32_t pkt_len, ret_status = DPS_SUCCESS;	
+	uint32_t pkt_len, buff_len, max_tunnels, ret_status = DPS_SUCCESS;	
 	dps_client_hdr_t hdr;
 	dps_tlv_hdr_t tlv_hdr;
 	uint8_t *buff = (uint8_t *)recv_buff;
@@ -4631,13 +6412,16 @@ static uint32_t dps_process_endpoint_update_reply(void *recv_buff,
 	dps_log_info(DpsProtocolLogLevel, "Enter");
 
 	pkt_len = dps_get_pkt_hdr((dps_pkt_hdr_t *)recv_buff, &hdr);
-	if ((client_buff = (dps_client_data_t *)dps_alloc_buff(sizeof(dps_client_data_t) + pkt_len)) == NULL)
+	buff_len = DPS_TUNNEL_DECODE_BUFF_LEN(pkt_len);
+	if ((client_buff = (dps_client_data_t *)dps_alloc_buff(buff_len)) == NULL)
 	{
 		dps_log_error(DpsProtocolLogLevel,"No memory");
 		return DPS_ERROR;
 	}
 	
 	endpoint_reply = (dps_endpoint_update_reply_t *)&(client_buff->endpoint_update_reply);
+	max_tunnels = dps_tunnel_list_room(client_buff, buff_len,
+	                                   endpoint_reply->tunnel_info.tunnel_list);
 	// Set hdr info
 	client_buff->hdr = hdr;
 	client_buff->hdr.reply_addr = *((ip_addr_t *)senders_addr);
@@ -4653,7 +6437,7 @@ static uint32_t dps_process_endpoint_update_reply(void *recv_buff,
 	   switch (DPS_GET_TLV_TYPE(&tlv_hdr))
 	   {
 	      case ENDPOINT_UPDATE_REPLY_TLV:
-		      buff += dps_get_endpoint_update_reply_tlv(buff, endpoint_reply);
+		      buff += dps_get_endpoint_update_reply_tlv(buff, endpoint_reply, max_tunnels);
 		      break;
 	      default:
 		      dps_log_info(DpsProtocolLogLevel, "Invalid TLV");
@@ -4688,61 +6472,52 @@ error:
 
 static uint32_t dps_process_policy_req(void *recv_buff, void *senders_addr)
 {
-	dps_endpoint_info_t *endpoint_info;
-	dps_policy_req_t *policy_req = NULL;
-	dps_client_data_t *client_buff;
-	uint32_t pkt_len;
-	dps_tlv_hdr_t tlv_hdr;	
-	uint8_t *buff = (uint8_t *)recv_buff;
+	dps_policy_req_t *policy_req;
+	dps_client_data_t client_msg;
+	dps_pkt_view_t view;
 
 	dps_log_info(DpsProtocolLogLevel, "Enter");
-	
-	if ((client_buff = (dps_client_data_t *)dps_alloc_buff(sizeof(dps_client_data_t))) == NULL)
-	{
-		dps_log_error(DpsProtocolLogLevel,"No memory");
-		return DPS_ERROR;
-	}
 
-	policy_req = (dps_policy_req_t *)&(client_buff->policy_req);
+	client_msg.context = NULL;
+	memset(&client_msg.hdr, 0, sizeof(dps_client_hdr_t));
+	policy_req = &client_msg.policy_req;
+	memset(policy_req, 0, sizeof(dps_policy_req_t));
 
 	// Set hdr info
-	pkt_len = dps_get_pkt_hdr((dps_pkt_hdr_t *)recv_buff, &client_buff->hdr);
-
-	client_buff->hdr.reply_addr = *((ip_addr_t *)senders_addr);
-
-	// Assume DPS Client's IP to be the Sender's IP
-	policy_req->dps_client_addr = *((ip_addr_t *)senders_addr);
-
-	dps_log_debug(DpsProtocolLogLevel, "Plcy Req len %d", pkt_len);
+	if (dps_pkt_view_init(&view, (uint8_t *)recv_buff, &client_msg.hdr,
+	                      DPS_PKT_VIEW_TLV(ENDPOINT_INFO_TLV) |
+	                      DPS_PKT_VIEW_TLV(SERVICE_LOC_TLV) |
+	                      DPS_PKT_VIEW_TLV(REPLY_SERVICE_LOC_TLV)) != DPS_SUCCESS)
+	{
+		dps_log_info(DpsProtocolLogLevel, "Exit: Invalid packet");
+		return DPS_ERROR;
+	}
+	client_msg.hdr.reply_addr = *((ip_addr_t *)senders_addr);
 
-	dump_pkt((uint8_t *)recv_buff, pkt_len+DPS_PKT_HDR_LEN);
+	dps_log_debug(DpsProtocolLogLevel, "Plcy Req len %d", view.pkt_len);
 
-	buff += DPS_PKT_HDR_LEN;
+	dump_pkt((uint8_t *)recv_buff, view.pkt_len+DPS_PKT_HDR_LEN);
 
-	// Go to the end of buffer
-	endpoint_info = &policy_req->dst_endpoint;
-	while (buff < ((uint8_t *)recv_buff + DPS_PKT_HDR_LEN + pkt_len))
+	// The first Endpoint Info is the destination, the second the source
+	if (view.num_endpoints > 0)
 	{
-		dps_get_tlv_hdr(buff, &tlv_hdr);
-		switch (DPS_GET_TLV_TYPE(&tlv_hdr))
-		{
-			case ENDPOINT_INFO_TLV:
-				buff += dps_get_endpoint_info_tlv(buff, endpoint_info);
-				endpoint_info++;
-				break;
-			case SERVICE_LOC_TLV:
-			case REPLY_SERVICE_LOC_TLV:
-				// Update the DPS Client IP
-				buff += dps_get_svcloc_tlv(buff, &policy_req->dps_client_addr);
-				break;
-		}
+		dps_get_endpoint_info_tlv(view.endpoint[0], &policy_req->dst_endpoint);
+	}
+	if (view.num_endpoints > 1)
+	{
+		dps_get_endpoint_info_tlv(view.endpoint[1], &policy_req->src_endpoint);
+	}
+	// Assume DPS Client's IP to be the Sender's IP
+	policy_req->dps_client_addr = *((ip_addr_t *)senders_addr);
+	if (view.svcloc != NULL)
+	{
+		// Update the DPS Client IP
+		dps_get_svcloc_tlv(view.svcloc, &policy_req->dps_client_addr);
 	}
 
-	dump_client_info(client_buff);
-
-	dps_send_to_protocol_client((void *)client_buff);
+	dump_client_info(&client_msg);
 
-	dps_free_buff((uint8_t *)client_buff);
+	dps_send_to_protocol_client((void *)&client_msg);
 
 	dps_log_info(DpsProtocolLogLevel, "Exit");
 
@@ -4884,7 +6659,7 @@ static uint32_t dps_process_policy_reply(void *recv_buff, void *senders_addr)
 {
 	dps_policy_info_t *plcy_info;
 	dps_client_data_t *client_buff;
-	uint32_t pkt_len;
+	uint32_t pkt_len, buff_len;
 	dps_client_hdr_t hdr;
 	dps_tlv_hdr_t tlv_hdr;
 	dps_endpoint_loc_reply_t *endpoint_reply;
@@ -4894,8 +6669,9 @@ static uint32_t dps_process_policy_reply(void *recv_buff, void *senders_addr)
 
 	// Get the header len, policy_reply is of variable len so have to alloc the client buffer
 	pkt_len = dps_get_pkt_hdr((dps_pkt_hdr_t *)recv_buff, &hdr);
+	buff_len = DPS_TUNNEL_DECODE_BUFF_LEN(pkt_len);
 	
-	if ((client_buff = (dps_client_data_t *)dps_alloc_buff(sizeof(dps_client_data_t) + pkt_len)) == NULL)
+	if ((client_buff = (dps_client_data_t *)dps_alloc_buff(buff_len)) == NULL)
 	{
 		dps_log_error(DpsProtocolLogLevel,"No memory");
 		return DPS_ERROR;
@@ -4917,7 +6693,9 @@ static uint32_t dps_process_policy_reply(void *recv_buff, void *senders_addr)
 		    case ENDPOINT_LOC_TLV:
 			    //Get endpoint loc reply tlv
 			    endpoint_reply = &(client_buff->policy_reply.dst_endpoint_loc_reply);
-			    buff += dps_get_endpoint_loc_reply_tlv(buff, endpoint_reply);
+			    buff += dps_get_endpoint_loc_reply_tlv(buff, endpoint_reply,
+			                                           dps_tunnel_list_room(client_buff, buff_len,
+			                                                                endpoint_reply->tunnel_info.tunnel_list));
 			    break;
 
 		    case POLICY_TLV:
@@ -5068,6 +6846,7 @@ static uint32_t dps_process_gen_msg_req(void *recv_buff, void *senders_addr)
 	
 	client_buff->hdr.reply_addr = *((ip_addr_t *)senders_addr);
 	msg_req->dps_client_addr = *((ip_addr_t *)senders_addr);
+	msg_req->bcast_seq_num = 0;
 	
 	buff += DPS_PKT_HDR_LEN;
 	while (buff < ((uint8_t *)recv_buff + DPS_PKT_HDR_LEN + pkt_len))
@@ -5079,6 +6858,28 @@ static uint32_t dps_process_gen_msg_req(void *recv_buff, void *senders_addr)
 		    case REPLY_SERVICE_LOC_TLV:
 			    buff += dps_get_svcloc_tlv(buff, &msg_req->dps_client_addr);
 			    break;
+		    case BCAST_LIST_DELTA_TLV:
+		    {
+			    dps_bcast_list_delta_t have;
+			    uint32_t tlv_len;
+
+			    // Carries no addresses in a request
+			    if ((DPS_GET_TLV_LEN(&tlv_hdr) != (DPS_BCAST_LIST_DELTA_TLV_LEN - DPS_TLV_HDR_LEN)) ||
+			        (client_buff->hdr.type != DPS_BCAST_LIST_REQ))
+			    {
+				    dps_log_info(DpsProtocolLogLevel, "Invalid TLV");
+				    goto error;
+			    }
+			    tlv_len = dps_get_bcast_list_delta_tlv(buff, &have);
+			    if (tlv_len == 0)
+			    {
+				    dps_log_info(DpsProtocolLogLevel, "Invalid TLV");
+				    goto error;
+			    }
+			    msg_req->bcast_seq_num = have.seq_num;
+			    buff += tlv_len;
+			    break;
+		    }
 		    default:
 			    dps_log_info(DpsProtocolLogLevel, "Invalid TLV");
 			    goto error;
@@ -5151,15 +6952,37 @@ static uint32_t dps_process_bcast_list_reply(void *recv_buff, void *senders_addr
 	// a bcast_list_req. A reply was received so stop the retranmsit timer
 	if (client_buff->hdr.type == DPS_BCAST_LIST_REPLY)
 		dps_stop_retransmit_timer(client_buff);
+	else
+		client_buff->context = NULL;
 
 	switch_info = &client_buff->dove_switch_list;
 	switch_list = switch_info->tunnel_list;
+	switch_info->num_v4_tunnels = 0;
+	switch_info->num_v6_tunnels = 0;
+	// Only a BCAST_LIST_DELTA_TLV makes the list sequenced
+	client_buff->hdr.sub_type = DPS_BCAST_LIST_FULL;
 
 	while (buff < ((uint8_t *)recv_buff + DPS_PKT_HDR_LEN + pkt_len))
 	{ 
 		dps_get_tlv_hdr(buff, &tlv_hdr);
 		switch (DPS_GET_TLV_TYPE(&tlv_hdr))
 		{
+		    case BCAST_LIST_DELTA_TLV:
+		    {
+			    uint32_t tlv_len;
+
+			    // The only TLV of a sequenced list
+			    tlv_len = dps_get_bcast_list_delta_tlv(buff, &client_buff->dove_switch_delta);
+			    if ((tlv_len == 0) ||
+			        ((buff + tlv_len) != ((uint8_t *)recv_buff + DPS_PKT_HDR_LEN + pkt_len)))
+			    {
+				    dps_log_info(DpsProtocolLogLevel, "Invalid TLV");
+				    goto error;
+			    }
+			    client_buff->hdr.sub_type = DPS_BCAST_LIST_SEQUENCED;
+			    buff += tlv_len;
+			    break;
+		    }
 		    case IPV4_ADDR_LIST_TLV:
 			    buff += dps_get_ipv4_list_tlv(buff, switch_list);
 			    switch_info->num_v4_tunnels = ((DPS_GET_TLV_LEN(&tlv_hdr))/DPS_IP4_ADDR_LEN);				
@@ -5352,7 +7175,10 @@ static uint32_t dps_process_gw_list(void *recv_buff, void *senders_addr)
 		switch (DPS_GET_TLV_TYPE(&tlv_hdr))
 		{
 		    case  TUNNEL_LIST_TLV:
-			    buff += dps_get_tunnel_list_tlv(buff, gw_info->tunnel_list, &gw_info->num_of_tunnels);
+			    buff += dps_get_tunnel_list_tlv(buff, gw_info->tunnel_list, &gw_info->num_of_tunnels,
+			                                    dps_tunnel_list_room(client_buff,
+			                                                         DPS_TUNNEL_DECODE_BUFF_LEN(pkt_len),
+			                                                         gw_info->tunnel_list));
 			break;	
 
   		    default:
@@ -5436,7 +7262,10 @@ static uint32_t dps_process_tunnel_reg_dereg(void *recv_buff, void *senders_addr
 		switch (DPS_GET_TLV_TYPE(&tlv_hdr))
 		{
 		    case  TUNNEL_LIST_TLV:
-			    buff += dps_get_tunnel_list_tlv(buff, tunnel_info->tunnel_list, &tunnel_info->num_of_tunnels);
+			    buff += dps_get_tunnel_list_tlv(buff, tunnel_info->tunnel_list, &tunnel_info->num_of_tunnels,
+			                                    dps_tunnel_list_room(client_buff,
+			                                                         DPS_TUNNEL_DECODE_BUFF_LEN(pkt_len),
+			                                                         tunnel_info->tunnel_list));
 			break;	
 			case SERVICE_LOC_TLV:
 			case REPLY_SERVICE_LOC_TLV:
@@ -5486,13 +7315,17 @@ static uint32_t dps_process_vm_migration_event(void *recv_buff,
 {
 	dps_vm_migration_event_t *vm_migration;
 	dps_client_data_t *client_buff;
-	uint32_t pkt_len;	
+	dps_client_hdr_t hdr;
+	uint32_t pkt_len, buff_len;	
 	dps_tlv_hdr_t tlv_hdr;
 	uint8_t *buff = (uint8_t *)recv_buff;
 
 	dps_log_info(DpsProtocolLogLevel, "Enter");
 
-	if ((client_buff = (dps_client_data_t *)dps_alloc_buff(sizeof(dps_client_data_t))) == NULL)
+	pkt_len = dps_get_pkt_hdr((dps_pkt_hdr_t *)recv_buff, &hdr);
+	buff_len = DPS_TUNNEL_DECODE_BUFF_LEN(pkt_len);
+
+	if ((client_buff = (dps_client_data_t *)dps_alloc_buff(buff_len)) == NULL)
 	{
 		dps_log_error(DpsProtocolLogLevel,"No memory");
 		return DPS_ERROR;
@@ -5500,7 +7333,7 @@ static uint32_t dps_process_vm_migration_event(void *recv_buff,
 
 	vm_migration = (dps_vm_migration_event_t *)&(client_buff->vm_migration_event);
 
-	pkt_len = dps_get_pkt_hdr((dps_pkt_hdr_t *)recv_buff, &client_buff->hdr);
+	client_buff->hdr = hdr;
 	
 	//Increment by pkt hdr len
 	buff += DPS_PKT_HDR_LEN;
@@ -5511,7 +7344,9 @@ static uint32_t dps_process_vm_migration_event(void *recv_buff,
 		switch (DPS_GET_TLV_TYPE(&tlv_hdr))
 		{
 		    case ENDPOINT_LOC_TLV:
-			    buff += dps_get_endpoint_loc_reply_tlv(buff, &vm_migration->src_vm_loc);
+			    buff += dps_get_endpoint_loc_reply_tlv(buff, &vm_migration->src_vm_loc,
+			                                           dps_tunnel_list_room(client_buff, buff_len,
+			                                                                vm_migration->src_vm_loc.tunnel_info.tunnel_list));
 			    break;
 		    case ENDPOINT_INFO_TLV:
 			    buff += dps_get_endpoint_info_tlv(buff, &vm_migration->migrated_vm_info);
@@ -6011,7 +7846,9 @@ static uint32_t dps_process_vm_loc_info(void *recv_buff, void *senders_addr)
 		{
 		    case EPRI_TLV:
 			    epri = &(client_buff->vm_invalidate_msg.epri);
-			    buff += dps_get_epri_tlv(buff, epri);
+			    buff += dps_get_epri_tlv(buff, epri,
+			                             dps_tunnel_list_room(client_buff, DPS_MAX_BUFF_SZ,
+			                                                  epri->tunnel_info.tunnel_list));
 			    break;
 
 		    default:
@@ -6035,6 +7872,154 @@ static uint32_t dps_process_vm_loc_info(void *recv_buff, void *senders_addr)
 	return DPS_SUCCESS;
 }
 
+/*
+ ******************************************************************************
+ * dps_process_replication_batch                                          *//**
+ *
+ * \brief This routine processes a batch of Endpoint Updates received on a
+ *        Replication Channel from another DPS Server. The batch is handed
+ *        over as a whole, the receiver applies it in sequence and replies
+ *        with a DPS_REPLICATION_BATCH_ACK.
+ *
+ * \param[in] recv_buff - A pointer to the replication batch pkt.
+ * \param[in] senders_addr - The senders address
+ *
+ * \retval 0 DPS_SUCCESS
+ * \retval 1 DPS_FAILURE
+ *
+ ******************************************************************************
+ */
+static uint32_t dps_process_replication_batch(void *recv_buff, void *senders_addr)
+{
+	dps_client_data_t *client_buff;
+	dps_replication_batch_t *batch;
+	dps_client_hdr_t hdr;
+	dps_tlv_hdr_t tlv_hdr;
+	uint32_t pkt_len, i, tlv_len;
+	uint8_t *buff = (uint8_t *)recv_buff;
+	uint8_t *buff_end;
+
+	dps_log_info(DpsProtocolLogLevel, "Enter");
+
+	pkt_len = dps_get_pkt_hdr((dps_pkt_hdr_t *)recv_buff, &hdr);
+	if ((client_buff = (dps_client_data_t *)dps_alloc_buff(sizeof(dps_client_data_t) +
+	                                                      (DPS_REPLICATION_BATCH_MAX * sizeof(dps_replication_entry_t)))) == NULL)
+	{
+		dps_log_error(DpsProtocolLogLevel,"No memory");
+		return DPS_ERROR;
+	}
+	batch = &client_buff->replication_batch;
+	client_buff->hdr = hdr;
+	client_buff->hdr.reply_addr = *((ip_addr_t *)senders_addr);
+
+	buff += DPS_PKT_HDR_LEN;
+	buff_end = buff + pkt_len;
+
+	do
+	{
+		if ((buff + DPS_REPLICATION_BATCH_TLV_LEN) > buff_end)
+		{
+			dps_log_info(DpsProtocolLogLevel, "Replication Batch too short %d", pkt_len);
+			break;
+		}
+		dps_get_tlv_hdr(buff, &tlv_hdr);
+		if ((DPS_GET_TLV_TYPE(&tlv_hdr) != REPLICATION_BATCH_TLV) ||
+		    (DPS_GET_TLV_LEN(&tlv_hdr) != (DPS_REPLICATION_BATCH_TLV_LEN - DPS_TLV_HDR_LEN)))
+		{
+			dps_log_info(DpsProtocolLogLevel, "Invalid TLV");
+			break;
+		}
+		buff += dps_get_replication_batch_tlv(buff, batch);
+		if ((batch->num_entries == 0) || (batch->num_entries > DPS_REPLICATION_BATCH_MAX))
+		{
+			dps_log_info(DpsProtocolLogLevel, "Replication Batch with %d entries",
+			             batch->num_entries);
+			break;
+		}
+		for (i = 0; i < batch->num_entries; i++)
+		{
+			tlv_len = dps_get_replication_entry_tlv(buff, buff_end - buff, &batch->entries[i]);
+			if (tlv_len == 0)
+			{
+				break;
+			}
+			buff += tlv_len;
+		}
+		if (i < batch->num_entries)
+		{
+			break;
+		}
+
+		dump_client_info(client_buff);
+
+		// call the client
+		dps_send_to_protocol_client((void *)client_buff);
+	}while(0);
+
+	dps_free_buff((uint8_t *)client_buff);
+	dps_log_info(DpsProtocolLogLevel, "Exit");
+	return DPS_SUCCESS;
+}
+
+/*
+ ******************************************************************************
+ * dps_process_replication_ack                                            *//**
+ *
+ * \brief This routine processes the cumulative ACK of a Replication Channel
+ *        sent by another DPS Server.
+ *
+ * \param[in] recv_buff - A pointer to the replication ack pkt.
+ * \param[in] senders_addr - The senders address
+ *
+ * \retval 0 DPS_SUCCESS
+ * \retval 1 DPS_FAILURE
+ *
+ ******************************************************************************
+ */
+static uint32_t dps_process_replication_ack(void *recv_buff, void *senders_addr)
+{
+	dps_client_data_t client_msg;
+	dps_tlv_hdr_t tlv_hdr;
+	uint32_t pkt_len;
+	uint8_t *buff = (uint8_t *)recv_buff;
+
+	dps_log_info(DpsProtocolLogLevel, "Enter");
+
+	client_msg.context = NULL;
+	memset(&client_msg.hdr, 0, sizeof(dps_client_hdr_t));
+	memset(&client_msg.replication_ack, 0, sizeof(dps_replication_ack_t));
+	pkt_len = dps_get_pkt_hdr((dps_pkt_hdr_t *)recv_buff, &client_msg.hdr);
+	client_msg.hdr.reply_addr = *((ip_addr_t *)senders_addr);
+	buff += DPS_PKT_HDR_LEN;
+
+	do
+	{
+		if (pkt_len < DPS_REPLICATION_ACK_TLV_LEN)
+		{
+			dps_log_info(DpsProtocolLogLevel, "Replication ACK too short %d", pkt_len);
+			break;
+		}
+		dps_get_tlv_hdr(buff, &tlv_hdr);
+		if (DPS_GET_TLV_TYPE(&tlv_hdr) != REPLICATION_ACK_TLV)
+		{
+			dps_log_info(DpsProtocolLogLevel, "Invalid TLV");
+			break;
+		}
+		if (dps_get_replication_ack_tlv(buff, pkt_len, &client_msg.replication_ack) == 0)
+		{
+			break;
+		}
+
+		dump_client_info(&client_msg);
+
+		// call the client
+		dps_send_to_protocol_client((void *)&client_msg);
+	}while(0);
+
+	dps_log_info(DpsProtocolLogLevel, "Exit");
+	return DPS_SUCCESS;
+}
+
 /*
  ******************************************************************************
  * dps_noop_func                                                          *//**
@@ -6133,6 +8118,8 @@ static dps_func_tbl_t dps_send_func_tbl[] = {
 	{"Control Plane heart beat", dps_send_gen_msg_req},
 	{"New DCS Node Req", dps_noop_func},
 	{"Unsolicited VM Location Info", dps_send_vm_loc_info},
+	{"Replication Batch", dps_send_replication_batch},
+	{"Replication Batch Ack", dps_send_replication_ack},
 };
 
 /**
@@ -6184,6 +8171,8 @@ static dps_func_tbl_t dps_recv_func_tbl[] = {
 	{"Control Plane Heart Beat", dps_process_gen_msg_req},
 	{"New DCS Node Req", dps_noop_func},
 	{"Unsolicited VM Location Info", dps_process_vm_loc_info},
+	{"Replication Batch", dps_process_replication_batch},
+	{"Replication Batch Ack", dps_process_replication_ack},
 };
 
 const char *dps_msg_name(uint8_t pkt_type)
@@ -6456,6 +8445,8 @@ static dps_construct_reply_func_t dps_construct_msg_reply_table[] = {
 	{"Control Plane Heart Beat", dps_construct_reply_generic_ack},
 	{"New DCS Node Req", dps_construct_noop_func},
 	{"VM Invalidate Msg", dps_construct_reply_generic_ack},
+	{"Replication Batch", NULL},
+	{"Replication Batch Ack", NULL},
 };
 
 /*
@@ -6529,6 +8520,7 @@ void dps_retransmit_callback(raw_proto_retransmit_status_t status, char *pRawPkt
  *
  * \param[in] recv_buff - A pointer to a message that the socket received.
  *                        Type - dps_pkt_hdr_t
+ * \param[in] recv_len - The number of bytes the socket received
  * \param[in] cli_addr - The address of the sender in sockaddr_in format. The
  *                       addresses are in HOST ORDER at this point.
  *
@@ -6538,24 +8530,39 @@ void dps_retransmit_callback(raw_proto_retransmit_status_t status, char *pRawPkt
  ******************************************************************************
  */
 
-uint32_t dps_process_rcvd_pkt(void *recv_buff, void *cli_addr)
+uint32_t dps_process_rcvd_pkt(void *recv_buff, uint32_t recv_len, void *cli_addr)
 {
 	dps_pkt_hdr_t *hdr = (dps_pkt_hdr_t *)recv_buff;
 	uint32_t ret = DPS_ERROR;
 
-	dps_log_debug(DpsProtocolLogLevel, "Enter: Msg type %d", hdr->type);
-
 	do
 	{
+		if (recv_len < DPS_PKT_HDR_LEN)
+		{
+			dps_pkt_stats_tbl[0].recv_error++;
+			dps_log_debug(DpsProtocolLogLevel, "Runt packet len %d received", recv_len);
+			break;
+		}
+		dps_log_debug(DpsProtocolLogLevel, "Enter: Msg type %d", hdr->type);
 		if ((hdr->type < DPS_ENDPOINT_LOC_REQ) || (hdr->type >= DPS_MAX_MSG_TYPE))
 		{
 			dps_pkt_stats_tbl[0].recv_error++;
 			dps_log_debug(DpsProtocolLogLevel, "Incorrect msg type %d received", hdr->type);
 			break;
 		}
-		// TODO: Verify Packet Length - Confirm that the RECV FROM length is >= the length
-		//       stated in the packet
+		// The receive buffers are reused, the TLVs must not run past the
+		// end of the datagram into the bytes of an earlier one. The len in
+		// the header doesn't count the header tlv len, see dps_get_pkt_hdr.
+		if (((uint32_t)ntohs(hdr->len) << 2) + DPS_PKT_HDR_TLV_LEN > recv_len)
+		{
+			dps_pkt_stats_tbl[hdr->type].recv_error++;
+			dps_log_debug(DpsProtocolLogLevel, "Msg type %d len %d exceeds datagram len %d",
+			              hdr->type, ntohs(hdr->len) << 2, recv_len);
+			break;
+		}
+		dps_pkt_latency_start(hdr->type, DPS_PKT_STAGE_DECODE);
 		ret = dps_recv_func_tbl[hdr->type].dps_fn(recv_buff, cli_addr);
+		dps_pkt_latency_end(ret != DPS_SUCCESS);
 		if (ret == DPS_SUCCESS)
 		{
 			dps_pkt_stats_tbl[hdr->type].recv++;
@@ -6612,7 +8619,9 @@ dps_return_status dps_protocol_client_send(dps_client_data_t *msg)
 			               msg->hdr.type);
 			break;
 		}
+		dps_pkt_latency_start(msg->hdr.type, DPS_PKT_STAGE_ENCODE);
 		ret = (dps_return_status)(dps_send_func_tbl[msg->hdr.type].dps_fn((void *)msg, (void *)NULL));
+		dps_pkt_latency_end(ret != DPS_SUCCESS);
 		if (ret == DPS_SUCCESS)
 		{
 			dps_pkt_stats_tbl[msg->hdr.type].sent++;
@@ -6630,6 +8639,68 @@ dps_return_status dps_protocol_client_send(dps_client_data_t *msg)
 }
 
 #if defined(DPS_SERVER)
+/*
+ ******************************************************************************
+ * dps_buff_pool_stats_show                                               *//**
+ *
+ * \brief This routine shows the occupancy and high water mark of every
+ *        Buffer Size Class
+ *
+ * \retval None
+ *
+ ******************************************************************************
+ */
+
+static void dps_buff_pool_stats_show(void)
+{
+	int i;
+
+	show_print("Packet Buffers");
+	for (i = 0; i <= DPS_BUFF_CLASS_MAX; i++)
+	{
+		if (i < DPS_BUFF_CLASS_MAX)
+		{
+			show_print("%-8s (%5d bytes): Alloc %15lu: Pool Hit %15lu",
+			           dps_buff_class_cfg[i].name, dps_buff_class_cfg[i].size,
+			           dps_buff_class_stats[i].alloc, dps_buff_class_stats[i].pool_hit);
+		}
+		else
+		{
+			show_print("%-22s: Alloc %15lu", "Unpooled",
+			           dps_buff_class_stats[i].alloc);
+		}
+		show_print("%-22s: In Use %14ld: High Water %13ld", "",
+		           dps_buff_class_stats[i].in_use, dps_buff_class_stats[i].high_water);
+	}
+	show_print("");
+	return;
+}
+
+/*
+ ******************************************************************************
+ * dps_buff_pool_stats_clear                                              *//**
+ *
+ * \brief This routine clears the Buffer Size Class statistics. The buffers
+ *        in use are still accounted for.
+ *
+ * \retval None
+ *
+ ******************************************************************************
+ */
+
+static void dps_buff_pool_stats_clear(void)
+{
+	int i;
+
+	for (i = 0; i <= DPS_BUFF_CLASS_MAX; i++)
+	{
+		dps_buff_class_stats[i].alloc = 0;
+		dps_buff_class_stats[i].pool_hit = 0;
+		dps_buff_class_stats[i].high_water = dps_buff_class_stats[i].in_use;
+	}
+	return;
+}
+
 /*
  ******************************************************************************
  * dps_packet_stats_show                                                  *//**
@@ -6664,6 +8735,11 @@ dove_status dps_packet_stats_show(uint32_t pkt_type)
 			           dps_pkt_stats_tbl[i].recv, dps_pkt_stats_tbl[i].recv_error);
 			show_print("");
 		}
+		dps_buff_pool_stats_show();
+		show_print("Payload Cache: Hit %15lu: Miss %15lu",
+		           dps_payload_cache_stats.hit, dps_payload_cache_stats.miss);
+		show_print("");
+		dps_svr_batch_stats_show();
 	}
 	else
 	{
@@ -6710,6 +8786,10 @@ dove_status dps_packet_stats_clear(uint32_t pkt_type)
 			dps_pkt_stats_tbl[i].recv = 0;
 			dps_pkt_stats_tbl[i].recv_error = 0;
 		}
+		dps_buff_pool_stats_clear();
+		dps_payload_cache_stats.hit = 0;
+		dps_payload_cache_stats.miss = 0;
+		dps_svr_batch_stats_clear();
 	}
 	else
 	{
@@ -6722,6 +8802,114 @@ dove_status dps_packet_stats_clear(uint32_t pkt_type)
 	dps_log_debug(DpsProtocolLogLevel, "Exit");
 	return DOVE_STATUS_OK;
 }
+
+/*
+ ******************************************************************************
+ * dps_packet_latency_show_type                                           *//**
+ *
+ * \brief This routine shows the latency of every Stage of a Packet Type.
+ *        Packet Types that never went through any Stage are skipped unless
+ *        fAlways is set.
+ *
+ ******************************************************************************
+ */
+
+static void dps_packet_latency_show_type(uint32_t pkt_type, int fAlways)
+{
+	dps_pkt_latency_t lat[DPS_PKT_STAGE_MAX];
+	uint64_t total = 0;
+	int j;
+
+	for (j = 0; j < DPS_PKT_STAGE_MAX; j++)
+	{
+		dps_pkt_latency_get(pkt_type, j, &lat[j]);
+		total += lat[j].count;
+	}
+	if ((total == 0) && !fAlways)
+	{
+		return;
+	}
+	show_print("Packet Type: %s", dps_pkt_stats_tbl[pkt_type].packet_name);
+	show_print("%-8s %12s %10s %10s %10s %10s %10s",
+	           "Stage", "Count", "Errors", "Avg(ns)", "p50(ns)", "p99(ns)", "p999(ns)");
+	for (j = 0; j < DPS_PKT_STAGE_MAX; j++)
+	{
+		show_print("%-8s %12lu %10lu %10lu %10lu %10lu %10lu",
+		           dps_pkt_stage_name[j],
+		           (unsigned long)lat[j].count,
+		           (unsigned long)lat[j].errors,
+		           (unsigned long)(lat[j].count ? (lat[j].total_ns / lat[j].count) : 0),
+		           (unsigned long)dps_pkt_latency_percentile(&lat[j], 500),
+		           (unsigned long)dps_pkt_latency_percentile(&lat[j], 990),
+		           (unsigned long)dps_pkt_latency_percentile(&lat[j], 999));
+	}
+	show_print("");
+	return;
+}
+
+/*
+ ******************************************************************************
+ * dps_packet_latency_show                                                *//**
+ *
+ * \brief This routine shows the Decode, Handler, Encode and Xmit latency of
+ *        DPS Client Server packets. The percentiles are the upper bound of
+ *        the power of 2 bucket they fall in.
+ *
+ * \param[in] pkt_type - DPS Client Server Protocol Message Type i.e.
+ *                       dps_client_req_type. 0 shows all types.
+ *
+ * \retval DOVE_STATUS_OK
+ *
+ ******************************************************************************
+ */
+
+dove_status dps_packet_latency_show(uint32_t pkt_type)
+{
+	uint32_t i;
+
+	dps_log_debug(DpsProtocolLogLevel, "Enter: packet type %d", pkt_type);
+
+	show_print("");
+	if ((pkt_type < DPS_ENDPOINT_LOC_REQ) || (pkt_type >= DPS_MAX_MSG_TYPE))
+	{
+		// Show all Packet Types that have seen traffic
+		for (i = 0; i < DPS_MAX_MSG_TYPE; i++)
+		{
+			dps_packet_latency_show_type(i, 0);
+		}
+	}
+	else
+	{
+		dps_packet_latency_show_type(pkt_type, 1);
+	}
+
+	dps_log_debug(DpsProtocolLogLevel, "Exit");
+	return DOVE_STATUS_OK;
+}
+
+/*
+ ******************************************************************************
+ * dps_packet_latency_clear                                               *//**
+ *
+ * \brief This routine clears the latency statistics of all DPS Client
+ *        Server packets. Every thread zeroes its own counters the next time
+ *        it records a sample.
+ *
+ * \retval DOVE_STATUS_OK
+ *
+ ******************************************************************************
+ */
+
+dove_status dps_packet_latency_clear(void)
+{
+	dps_log_debug(DpsProtocolLogLevel, "Enter");
+	pthread_mutex_lock(&dps_pkt_latency_lock);
+	memset(dps_pkt_latency_retired, 0, sizeof(dps_pkt_latency_retired));
+	dps_pkt_latency_generation++;
+	pthread_mutex_unlock(&dps_pkt_latency_lock);
+	dps_log_debug(DpsProtocolLogLevel, "Exit");
+	return DOVE_STATUS_OK;
+}
 #endif // #if defined(DPS_SERVER)
 
 /*
@@ -7166,6 +9354,16 @@ static void dump_client_info(dps_client_data_t *buff)
 		ip_addr = switch_info->tunnel_list;
 
 		print_client_hdr(&buff->hdr, buff->context);
+		if (buff->hdr.sub_type == DPS_BCAST_LIST_SEQUENCED)
+		{
+			dps_bcast_list_delta_t *delta = &(buff->dove_switch_delta);
+			dps_log_debug(DpsProtocolLogLevel,
+			              "Seq %u Base %u: V4 Switch Addr +%d -%d, V6 Switch Addr +%d -%d",
+			              delta->seq_num, delta->base_seq_num,
+			              delta->num_v4_add, delta->num_v4_del,
+			              delta->num_v6_add, delta->num_v6_del);
+			break;
+		}
 		dps_log_debug(DpsProtocolLogLevel,"V4 Switch Addr: %d", switch_info->num_v4_tunnels);
 		for (i = 0; i < switch_info->num_v4_tunnels; i++, ip_addr++)
 		{
@@ -7374,6 +9572,34 @@ static void dump_client_info(dps_client_data_t *buff)
 	    
 	    break;
 	}
+	case DPS_REPLICATION_BATCH:
+	{
+		uint32_t i;
+
+		print_client_hdr(&buff->hdr, buff->context);
+		dps_log_debug(DpsProtocolLogLevel, "Replication Channel %d Seq %d Entries %d",
+		              buff->replication_batch.channel_id,
+		              buff->replication_batch.seq_num,
+		              buff->replication_batch.num_entries);
+		for (i = 0; i < buff->replication_batch.num_entries; i++)
+		{
+			dps_log_debug(DpsProtocolLogLevel, "Entry %d: Vnid %d Sub-Type %d Version %d",
+			              i, buff->replication_batch.entries[i].vnid,
+			              buff->replication_batch.entries[i].sub_type,
+			              buff->replication_batch.entries[i].endpoint_update.version);
+		}
+		break;
+	}
+	case DPS_REPLICATION_BATCH_ACK:
+	{
+		print_client_hdr(&buff->hdr, buff->context);
+		dps_log_debug(DpsProtocolLogLevel, "Replication Channel %d ACK Seq %d Errors %d from Seq %d",
+		              buff->replication_ack.channel_id,
+		              buff->replication_ack.ack_seq_num,
+		              buff->replication_ack.num_errors,
+		              buff->replication_ack.errors_seq_num);
+		break;
+	}
 	default:
 		dps_log_info(DpsProtocolLogLevel, "Invalid Msg Type %d", client_hdr->type);
 		break;
@@ -23,13 +23,132 @@
 #include "dps_log.h"
 
 int32_t DpsProtocolLogLevel = DPS_LOGLEVEL_NOTICE;
-static int8_t buffer[DPS_MAX_BUFF_SZ];
 
 /**
- * \brief The Server UDP Socket
+ * \brief The Maximum number of datagrams pulled from the Socket in a single
+ *        recvmmsg() call
+ */
+#define DPS_SVR_RECV_BATCH_SZ 64
+
+/**
+ * \brief The Maximum number of replies gathered before a sendmmsg() flush
+ */
+#define DPS_SVR_XMIT_BATCH_SZ 64
+
+/**
+ * \brief The Size of the area holding the gathered replies till they are
+ *        flushed. A reply that doesn't fit forces an early flush.
+ */
+#define DPS_SVR_XMIT_ARENA_SZ (1 << 18)
+
+/**
+ * \brief The Maximum number of Workers that can service the Server UDP Port
+ */
+#define DPS_SVR_MAX_WORKERS 16
+
+/**
+ * \brief The Stack Size of a Worker Thread. The Workers call into PYTHON so
+ *        they need a decent stack.
+ */
+#define DPS_SVR_WORKER_STACK_SZ 0x100000
+
+/**
+ * \brief The Statistics of Batched Receive and Transmit on a Server Socket
+ */
+typedef struct dps_svr_batch_stats_s{
+	uint64_t recv_batches;
+	uint64_t recv_pkts;
+	uint64_t recv_batch_max;
+	uint64_t xmit_batches;
+	uint64_t xmit_pkts;
+	uint64_t xmit_errors;
+}dps_svr_batch_stats_t;
+
+/**
+ * \brief The Batched Receive and Transmit state of a Server Socket. Every
+ *        Worker owns one of these.
+ */
+typedef struct dps_svr_batch_s{
+	/**
+	 * \brief The Socket this batch is received on and flushed to
+	 */
+	int sock;
+	/**
+	 * \brief The Receive Buffers, one per datagram in the batch
+	 */
+	int8_t recv_buff[DPS_SVR_RECV_BATCH_SZ][DPS_MAX_BUFF_SZ];
+	/**
+	 * \brief The recvmmsg() headers pointing into recv_buff
+	 */
+	struct mmsghdr recv_msgs[DPS_SVR_RECV_BATCH_SZ];
+	struct iovec recv_iov[DPS_SVR_RECV_BATCH_SZ];
+	struct sockaddr_storage recv_addr[DPS_SVR_RECV_BATCH_SZ];
+	/**
+	 * \brief The gathered replies waiting for the sendmmsg() flush
+	 */
+	uint32_t xmit_count;
+	uint32_t xmit_arena_used;
+	struct mmsghdr xmit_msgs[DPS_SVR_XMIT_BATCH_SZ];
+	struct iovec xmit_iov[DPS_SVR_XMIT_BATCH_SZ];
+	struct sockaddr_storage xmit_addr[DPS_SVR_XMIT_BATCH_SZ];
+	uint8_t xmit_arena[DPS_SVR_XMIT_ARENA_SZ];
+	/**
+	 * \brief The Statistics of this batch
+	 */
+	dps_svr_batch_stats_t stats;
+}dps_svr_batch_t;
+
+/**
+ * \brief A Worker servicing the Server UDP Port. In Multi Worker mode every
+ *        Worker owns a SO_REUSEPORT socket and a thread, and the kernel
+ *        hashes the DPS Clients across the Workers.
+ */
+typedef struct dps_svr_worker_s{
+	/**
+	 * \brief The Worker Socket
+	 */
+	int sock;
+	/**
+	 * \brief The Worker Thread (Multi Worker mode only)
+	 */
+	long tid;
+	/**
+	 * \brief The Batched Receive and Transmit state
+	 */
+	dps_svr_batch_t *batch;
+}dps_svr_worker_t;
+
+/**
+ * \brief The Workers servicing the Server UDP Port
+ */
+static dps_svr_worker_t svr_workers[DPS_SVR_MAX_WORKERS];
+
+/**
+ * \brief The Number of Workers. With a single Worker the Server Socket is
+ *        serviced by the CORE API polling thread.
+ */
+static uint32_t svr_num_workers = 1;
+
+/**
+ * \brief The Batch that the calling thread is currently processing. Only
+ *        replies sent from inside a batch are gathered, all other threads
+ *        transmit inline.
+ */
+static pthread_key_t svr_batch_key;
+
+/**
+ * \brief The Server UDP Socket. Used for replies sent from outside a batch
+ *        and for retransmits.
  */
 static int server_sock;
 
+/**
+ * \brief The Address Family of the Server Sockets. AF_INET6 means the
+ *        sockets are dual stack and IPv4 DPS Clients show up as IPv4 mapped
+ *        IPv6 addresses. Falls back to AF_INET if the host has no IPv6.
+ */
+static int server_sock_family = AF_INET6;
+
 void dps_retransmit_callback(raw_proto_retransmit_status_t status, char *pRawPkt, 
                              void* context, rpt_owner_t owner);
 /*
@@ -69,6 +188,314 @@ int32_t DpsProtocolCustomerLogLevel = DPS_SERVER_LOGLEVEL_WARNING;
  *
  */
 
+/*
+ ******************************************************************************
+ * dps_svr_xmit_batch_flush                                               *//**
+ *
+ * \brief - Sends all the replies gathered in the batch with sendmmsg() and
+ *          empties the batch
+ *
+ * \param[in] batch - The Batch State of the Server Socket
+ *
+ * \retval None
+ *
+ ******************************************************************************
+ */
+
+static void dps_svr_xmit_batch_flush(dps_svr_batch_t *batch)
+{
+	uint32_t sent = 0;
+	int32_t ret_val;
+#if defined(DPS_SERVER)
+	uint32_t i, pkt_type;
+	struct timespec ts_start, ts_end;
+	uint64_t elapsed_ns;
+#endif
+
+	if (batch->xmit_count > 0)
+	{
+		batch->stats.xmit_batches++;
+	}
+	while (sent < batch->xmit_count)
+	{
+#if defined(DPS_SERVER)
+		clock_gettime(CLOCK_MONOTONIC, &ts_start);
+#endif
+		ret_val = sendmmsg(batch->sock, &batch->xmit_msgs[sent],
+		                   batch->xmit_count - sent, 0);
+#if defined(DPS_SERVER)
+		clock_gettime(CLOCK_MONOTONIC, &ts_end);
+		elapsed_ns = ((uint64_t)(ts_end.tv_sec - ts_start.tv_sec) * 1000000000ULL) +
+		             ts_end.tv_nsec - ts_start.tv_nsec;
+#endif
+		if (ret_val <= 0)
+		{
+			// Skip the message that failed and carry on with the rest
+			dps_log_notice(DpsProtocolLogLevel, "sendmmsg() error %s",
+			               strerror(errno));
+			batch->stats.xmit_errors++;
+#if defined(DPS_SERVER)
+			pkt_type = ((dps_pkt_hdr_t *)batch->xmit_iov[sent].iov_base)->type;
+			dps_pkt_latency_record(pkt_type, DPS_PKT_STAGE_XMIT, elapsed_ns, 1);
+#endif
+			sent++;
+			continue;
+		}
+		dps_log_debug(DpsProtocolLogLevel, "sendmmsg() msgs_sent %d", ret_val);
+		batch->stats.xmit_pkts += ret_val;
+#if defined(DPS_SERVER)
+		// Every packet in the call gets an equal share of the time
+		for (i = sent; i < sent + ret_val; i++)
+		{
+			pkt_type = ((dps_pkt_hdr_t *)batch->xmit_iov[i].iov_base)->type;
+			dps_pkt_latency_record(pkt_type, DPS_PKT_STAGE_XMIT,
+			                       elapsed_ns / ret_val, 0);
+		}
+#endif
+		sent += ret_val;
+	}
+	batch->xmit_count = 0;
+	batch->xmit_arena_used = 0;
+
+	return;
+}
+
+/*
+ ******************************************************************************
+ * dps_svr_xmit_batch_start                                               *//**
+ *
+ * \brief - Marks the start of a Receive Batch. Replies sent by the calling
+ *          thread from here on are gathered instead of transmitted inline.
+ *
+ * \param[in] batch - The Batch State of the Server Socket
+ *
+ * \retval None
+ *
+ ******************************************************************************
+ */
+
+static void dps_svr_xmit_batch_start(dps_svr_batch_t *batch)
+{
+	batch->xmit_count = 0;
+	batch->xmit_arena_used = 0;
+	pthread_setspecific(svr_batch_key, batch);
+	return;
+}
+
+/*
+ ******************************************************************************
+ * dps_svr_xmit_batch_end                                                 *//**
+ *
+ * \brief - Marks the end of a Receive Batch and flushes the gathered replies
+ *
+ * \param[in] batch - The Batch State of the Server Socket
+ *
+ * \retval None
+ *
+ ******************************************************************************
+ */
+
+static void dps_svr_xmit_batch_end(dps_svr_batch_t *batch)
+{
+	dps_svr_xmit_batch_flush(batch);
+	pthread_setspecific(svr_batch_key, NULL);
+	return;
+}
+
+/*
+ ******************************************************************************
+ * dps_svr_xmit_batch_add                                                 *//**
+ *
+ * \brief - Gathers a reply into the batch if the calling thread is currently
+ *          processing a Receive Batch. The buffer is copied since the caller
+ *          frees it on return.
+ *
+ * \param[in] buff - Pointer to a char buffer
+ * \param[in] buff_len - Size of the Buffer
+ * \param[in] dst_addr - The Remote End to send the Buffer To
+ * \param[in] dst_addr_len - The Length of dst_addr
+ *
+ * \retval 1 The reply was gathered
+ * \retval 0 The reply MUST be transmitted inline
+ *
+ ******************************************************************************
+ */
+
+static int dps_svr_xmit_batch_add(uint8_t *buff, uint32_t buff_len,
+                                  struct sockaddr_storage *dst_addr,
+                                  socklen_t dst_addr_len)
+{
+	dps_svr_batch_t *batch;
+	uint32_t index;
+
+	batch = (dps_svr_batch_t *)pthread_getspecific(svr_batch_key);
+	if ((batch == NULL) || (buff_len > DPS_SVR_XMIT_ARENA_SZ))
+	{
+		return 0;
+	}
+
+	if ((batch->xmit_count == DPS_SVR_XMIT_BATCH_SZ) ||
+	    ((batch->xmit_arena_used + buff_len) > DPS_SVR_XMIT_ARENA_SZ))
+	{
+		dps_svr_xmit_batch_flush(batch);
+	}
+
+	index = batch->xmit_count;
+	memcpy(&batch->xmit_arena[batch->xmit_arena_used], buff, buff_len);
+	memcpy(&batch->xmit_addr[index], dst_addr, dst_addr_len);
+	batch->xmit_iov[index].iov_base = &batch->xmit_arena[batch->xmit_arena_used];
+	batch->xmit_iov[index].iov_len = buff_len;
+	batch->xmit_msgs[index].msg_hdr.msg_name = &batch->xmit_addr[index];
+	batch->xmit_msgs[index].msg_hdr.msg_namelen = dst_addr_len;
+	batch->xmit_msgs[index].msg_hdr.msg_iov = &batch->xmit_iov[index];
+	batch->xmit_msgs[index].msg_hdr.msg_iovlen = 1;
+	batch->xmit_msgs[index].msg_hdr.msg_control = NULL;
+	batch->xmit_msgs[index].msg_hdr.msg_controllen = 0;
+	batch->xmit_msgs[index].msg_hdr.msg_flags = 0;
+	batch->xmit_count++;
+	batch->xmit_arena_used += buff_len;
+
+	return 1;
+}
+
+/*
+ ******************************************************************************
+ * dps_svr_batch_alloc                                                    *//**
+ *
+ * \brief - Allocates the Batch State of a Server Socket and points the
+ *          recvmmsg() headers at the Receive Buffers
+ *
+ * \param[in] sock - The Server Socket
+ *
+ * \retval Pointer to the Batch State, NULL if no memory
+ *
+ ******************************************************************************
+ */
+
+static dps_svr_batch_t *dps_svr_batch_alloc(int sock)
+{
+	dps_svr_batch_t *batch;
+	int i;
+
+	batch = (dps_svr_batch_t *)malloc(sizeof(dps_svr_batch_t));
+	if (batch == NULL)
+	{
+		return NULL;
+	}
+	memset(batch, 0, sizeof(dps_svr_batch_t));
+	batch->sock = sock;
+	for (i = 0; i < DPS_SVR_RECV_BATCH_SZ; i++)
+	{
+		batch->recv_iov[i].iov_base = batch->recv_buff[i];
+		batch->recv_iov[i].iov_len = DPS_MAX_BUFF_SZ;
+		batch->recv_msgs[i].msg_hdr.msg_name = &batch->recv_addr[i];
+		batch->recv_msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
+		batch->recv_msgs[i].msg_hdr.msg_iov = &batch->recv_iov[i];
+		batch->recv_msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	return batch;
+}
+
+/*
+ ******************************************************************************
+ * dps_svr_sockaddr_to_ip                                                 *//**
+ *
+ * \brief - Converts the Socket Address of a DPS Client to the ip_addr_t used
+ *          by the DPS Client Server Protocol. IPv4 mapped IPv6 addresses are
+ *          converted to plain IPv4 addresses.
+ *
+ * \param[in] sa - The Socket Address
+ * \param[out] ip - The ip_addr_t. The IPv4 address is in Host Byte Order.
+ *
+ * \retval None
+ *
+ ******************************************************************************
+ */
+
+static void dps_svr_sockaddr_to_ip(struct sockaddr_storage *sa, ip_addr_t *ip)
+{
+	struct sockaddr_in *sa4;
+	struct sockaddr_in6 *sa6;
+
+	memset(ip, 0, sizeof(ip_addr_t));
+	if (sa->ss_family == AF_INET6)
+	{
+		sa6 = (struct sockaddr_in6 *)sa;
+		ip->port = ntohs(sa6->sin6_port);
+		if (IN6_IS_ADDR_V4MAPPED(&sa6->sin6_addr))
+		{
+			ip->family = AF_INET;
+			ip->ip4 = ntohl(((uint32_t *)sa6->sin6_addr.s6_addr)[3]);
+		}
+		else
+		{
+			ip->family = AF_INET6;
+			memcpy(ip->ip6, sa6->sin6_addr.s6_addr, 16);
+		}
+	}
+	else
+	{
+		sa4 = (struct sockaddr_in *)sa;
+		ip->family = AF_INET;
+		ip->port = ntohs(sa4->sin_port);
+		ip->ip4 = ntohl(sa4->sin_addr.s_addr);
+	}
+	return;
+}
+
+/*
+ ******************************************************************************
+ * dps_svr_ip_to_sockaddr                                                 *//**
+ *
+ * \brief - Converts an ip_addr_t to a Socket Address that can be used on the
+ *          Server Sockets. On dual stack sockets IPv4 addresses are converted
+ *          to IPv4 mapped IPv6 addresses.
+ *
+ * \param[in] ip - The ip_addr_t. The IPv4 address is in Host Byte Order.
+ * \param[out] sa - The Socket Address
+ *
+ * \retval The Length of the Socket Address, 0 if it cannot be reached
+ *         from the Server Sockets
+ *
+ ******************************************************************************
+ */
+
+static socklen_t dps_svr_ip_to_sockaddr(ip_addr_t *ip, struct sockaddr_storage *sa)
+{
+	struct sockaddr_in *sa4;
+	struct sockaddr_in6 *sa6;
+
+	memset(sa, 0, sizeof(struct sockaddr_storage));
+	if (server_sock_family == AF_INET6)
+	{
+		sa6 = (struct sockaddr_in6 *)sa;
+		sa6->sin6_family = AF_INET6;
+		sa6->sin6_port = htons(ip->port);
+		if (ip->family == AF_INET6)
+		{
+			memcpy(sa6->sin6_addr.s6_addr, ip->ip6, 16);
+		}
+		else
+		{
+			sa6->sin6_addr.s6_addr[10] = 0xff;
+			sa6->sin6_addr.s6_addr[11] = 0xff;
+			((uint32_t *)sa6->sin6_addr.s6_addr)[3] = htonl(ip->ip4);
+		}
+		return sizeof(struct sockaddr_in6);
+	}
+
+	if (ip->family == AF_INET6)
+	{
+		return 0;
+	}
+	sa4 = (struct sockaddr_in *)sa;
+	sa4->sin_family = AF_INET;
+	sa4->sin_port = htons(ip->port);
+	sa4->sin_addr.s_addr = htonl(ip->ip4);
+	return sizeof(struct sockaddr_in);
+}
+
 /*
  ******************************************************************************
  * dps_process_data_rcvd                                                  *//**
@@ -79,7 +506,7 @@ int32_t DpsProtocolCustomerLogLevel = DPS_SERVER_LOGLEVEL_WARNING;
  *          in the header
  *
  * \param[in] socket - The socket on which the information arrived
- * \param[in] context - An index value used to access the dps server information
+ * \param[in] context - The Batch State of the Worker owning the socket
  *
  * \retval DOVE_STATUS_OK
  *
@@ -88,9 +515,10 @@ int32_t DpsProtocolCustomerLogLevel = DPS_SERVER_LOGLEVEL_WARNING;
 
 static int dps_process_data_rcvd(int socket, void *context)
 {
-	struct sockaddr_in client_addr;
-	ip_addr_t sender_addr = {AF_INET, 0};
-	int32_t bytes_read, addr_len = sizeof(struct sockaddr_in);
+	dps_svr_batch_t *batch = (dps_svr_batch_t *)context;
+	ip_addr_t sender_addr;
+	char str[INET6_ADDRSTRLEN];
+	int32_t pkts_read, i;
 	int32_t loops = 0;
 
 	dps_log_debug(DpsProtocolLogLevel,"Enter");
@@ -98,40 +526,71 @@ static int dps_process_data_rcvd(int socket, void *context)
 	// Loop forever till all UDP data is consumed
 	do
 	{
+		for (i = 0; i < DPS_SVR_RECV_BATCH_SZ; i++)
+		{
+			batch->recv_msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
+		}
 
-		memset(&client_addr, 0, sizeof(client_addr));
-
-		bytes_read = recvfrom(socket, buffer, DPS_MAX_BUFF_SZ,
-		                      0, (struct sockaddr *)&client_addr, (socklen_t *)&addr_len);
+		pkts_read = recvmmsg(socket, batch->recv_msgs, DPS_SVR_RECV_BATCH_SZ,
+		                     0, NULL);
 
-		if(bytes_read <= 0)
+		if(pkts_read <= 0)
 		{
 			if (loops == 0)
 			{
-				// Error in 1st recvfrom itself - Why did we get woken up???
-				dps_log_error(DpsProtocolLogLevel, "[loop %d] recvfrom() error %s",
+				// Error in 1st recvmmsg itself - Why did we get woken up???
+				dps_log_error(DpsProtocolLogLevel, "[loop %d] recvmmsg() error %s",
 				              loops, strerror(errno));
 			}
 			else
 			{
 				// Normal
-				dps_log_debug(DpsProtocolLogLevel, "[loop %d] recvfrom() error %s",
+				dps_log_debug(DpsProtocolLogLevel, "[loop %d] recvmmsg() error %s",
 				              loops, strerror(errno));
 			}
 			break;
 		}
 
-		dps_log_debug(DpsProtocolLogLevel,"Msg from [%s:%d] bytes read %d",
-		          inet_ntoa(client_addr.sin_addr), ntohs(client_addr.sin_port), bytes_read);
+		batch->stats.recv_batches++;
+		batch->stats.recv_pkts += pkts_read;
+		if ((uint64_t)pkts_read > batch->stats.recv_batch_max)
+		{
+			batch->stats.recv_batch_max = pkts_read;
+		}
 
-		if (sender_addr.family == AF_INET)
+		// Gather all the replies generated by this batch
+		dps_svr_xmit_batch_start(batch);
+#if defined(DPS_SERVER)
+		// Hand the requests which need PYTHON over in one go
+		dps_protocol_server_batch_start();
+#endif
+		for (i = 0; i < pkts_read; i++)
 		{
-			sender_addr.ip4 = ntohl(client_addr.sin_addr.s_addr);
+			dps_svr_sockaddr_to_ip(&batch->recv_addr[i], &sender_addr);
+			if (DpsProtocolLogLevel >= DPS_LOGLEVEL_VERBOSE)
+			{
+				if (sender_addr.family == AF_INET)
+				{
+					uint32_t ip4 = htonl(sender_addr.ip4);
+					inet_ntop(AF_INET, &ip4, str, INET6_ADDRSTRLEN);
+				}
+				else
+				{
+					inet_ntop(AF_INET6, sender_addr.ip6, str, INET6_ADDRSTRLEN);
+				}
+				dps_log_debug(DpsProtocolLogLevel,"Msg from [%s:%d] bytes read %d",
+				              str, sender_addr.port, batch->recv_msgs[i].msg_len);
+			}
+			dps_process_rcvd_pkt((void *)batch->recv_buff[i],
+			                     batch->recv_msgs[i].msg_len,
+			                     (void *)&sender_addr);
 		}
-		sender_addr.port = ntohs(client_addr.sin_port);
-		dps_process_rcvd_pkt((void *)buffer,(void *)&sender_addr);
+#if defined(DPS_SERVER)
+		dps_protocol_server_batch_end();
+#endif
+		dps_svr_xmit_batch_end(batch);
 
-		loops++;
+		loops += pkts_read;
 	}while(loops < 50000); // MAX 50,000 loops before releasing CPU???
 
 	dps_log_debug(DpsProtocolLogLevel, "Exit");
@@ -160,20 +619,25 @@ uint32_t dps_protocol_xmit(uint8_t *buff, uint32_t buff_len, ip_addr_t *addr, vo
 
 
 	int32_t ret_val = 0;
-	struct sockaddr_in dst_addr;
+	struct sockaddr_storage dst_addr;
+	socklen_t dst_addr_len;
 	dps_client_hdr_t hdr;
 	uint32_t status = DPS_SUCCESS;
-
-	dst_addr.sin_family = AF_INET;
-	dst_addr.sin_port = htons(addr->port);
-	dst_addr.sin_addr.s_addr = htonl(addr->ip4);
 	int32_t rc = 0;
 
-	dps_log_debug(DpsProtocolLogLevel,"Send to: [%s:%d], context %p",
-	              inet_ntoa(dst_addr.sin_addr), ntohs(dst_addr.sin_port), context);
+	dps_log_debug(DpsProtocolLogLevel,"Send to: family %d port %d, context %p",
+	              addr->family, addr->port, context);
 
 	do
 	{
+		dst_addr_len = dps_svr_ip_to_sockaddr(addr, &dst_addr);
+		if (dst_addr_len == 0)
+		{
+			dps_log_notice(DpsProtocolLogLevel,
+			               "Cannot reach IPv6 address from IPv4 only Server Socket");
+			status = DPS_ERROR;
+			break;
+		}
 
 		if (context)
 		{
@@ -191,8 +655,22 @@ uint32_t dps_protocol_xmit(uint8_t *buff, uint32_t buff_len, ip_addr_t *addr, vo
 			}
 		}
 
+		if (dps_svr_xmit_batch_add(buff, buff_len, &dst_addr, dst_addr_len))
+		{
+			// Sent with the rest of the batch
+			status = DPS_SUCCESS;
+			break;
+		}
+
+		// Batched packets are accounted when the batch is flushed
+#if defined(DPS_SERVER)
+		dps_pkt_latency_start(((dps_pkt_hdr_t *)buff)->type, DPS_PKT_STAGE_XMIT);
+#endif
 		ret_val = sendto(server_sock, (void *)buff, buff_len, 0,
-		                 (struct sockaddr *)&(dst_addr), sizeof(struct sockaddr));
+		                 (struct sockaddr *)&(dst_addr), dst_addr_len);
+#if defined(DPS_SERVER)
+		dps_pkt_latency_end(ret_val <= 0);
+#endif
 
 		if (ret_val <= 0)
 		{
@@ -213,16 +691,17 @@ uint32_t dps_protocol_xmit(uint8_t *buff, uint32_t buff_len, ip_addr_t *addr, vo
 
 /*
  ******************************************************************************
- * dps_svr_proto_init                                                     *//**
+ * dps_svr_socket_open                                                    *//**
  *
- * \brief - This routine initializes the DPS Server part of the Protocol. This
- *          routine MUST be called before the DPS Client Server Protocol can
- *          become alive.
+ * \brief - This routine creates a Non Blocking UDP Socket bound to the DPS
+ *          Server Port. The Socket is a dual stack IPv6 Socket unless the
+ *          host doesn't support IPv6 in which case an IPv4 Socket is used.
  *
  * \param[in] portnum - The UDP Port on which the DPS Server will be "listening"
+ * \param[in] fReusePort - Whether other Workers will be bound to the same Port
+ * \param[out] psock - The Socket
  *
  * \retval DOVE_STATUS_OK Success
- * \retval DOVE_STATUS_NO_RESOURCES No Resources
  * \retval DOVE_STATUS_INVALID_FD Couldn't create UDP Socket
  * \retval DOVE_STATUS_BIND_FAILED Bind failed to the Provided Port
  * \retval DOVE_STATUS_NOT_SUPPORTED Cannot function in Non Blocking Mode
@@ -230,30 +709,34 @@ uint32_t dps_protocol_xmit(uint8_t *buff, uint32_t buff_len, ip_addr_t *addr, vo
  ******************************************************************************
  */
 
-dove_status dps_svr_proto_init(uint32_t portnum)
+static dove_status dps_svr_socket_open(uint32_t portnum, int fReusePort, int *psock)
 {
-	int32_t rc;
-	struct sockaddr_in srvAddr;
-	int core_status;
+	struct sockaddr_storage srvAddr;
+	socklen_t srvAddr_len;
 	size_t rcv_size;
 	socklen_t rcv_size_len;
-	dove_status status = DOVE_STATUS_NO_RESOURCES;
+	int sock, optval;
+	dove_status status = DOVE_STATUS_OK;
 
 	do
 	{
-		dps_log_debug(DpsProtocolLogLevel,"dps_svr_proto_init");
-
-		// Register timer callback
-		rc = raw_proto_timer_init(&dps_retransmit_callback, RPT_OWNER_DPS);
-		if (rc != RAW_PROTO_TIMER_RETURN_OK)
+		sock = -1;
+		if (server_sock_family == AF_INET6)
 		{
-			dps_log_error(DpsProtocolLogLevel, "raw_proto_timer_init %d\n",
-			              rc);
-			status = DOVE_STATUS_NO_RESOURCES;
-			break;
+			sock = socket(AF_INET6, SOCK_DGRAM, 0);
+			if (sock == -1)
+			{
+				dps_log_notice(DpsProtocolLogLevel,
+				               "IPv6 socket() failed Error %s, using IPv4",
+				               strerror(errno));
+				server_sock_family = AF_INET;
+			}
 		}
-
-		if ((server_sock = socket(AF_INET, SOCK_DGRAM, 0)) == -1)
+		if (server_sock_family == AF_INET)
+		{
+			sock = socket(AF_INET, SOCK_DGRAM, 0);
+		}
+		if (sock == -1)
 		{
 			dps_log_error(DpsProtocolLogLevel, "socket() failed Error %s\n",
 			              strerror(errno));
@@ -261,22 +744,60 @@ dove_status dps_svr_proto_init(uint32_t portnum)
 			break;
 		}
 
-		memset(&srvAddr, 0, sizeof(srvAddr));
+		if (server_sock_family == AF_INET6)
+		{
+			// Accept IPv4 DPS Clients on the same Socket
+			optval = 0;
+			if (setsockopt(sock, IPPROTO_IPV6, IPV6_V6ONLY, (void *)&optval, sizeof(optval)) != 0)
+			{
+				dps_log_error(DpsProtocolLogLevel, "setsockopt IPV6_V6ONLY error %s",
+				              strerror(errno));
+				close(sock);
+				status = DOVE_STATUS_NOT_SUPPORTED;
+				break;
+			}
+		}
 
-		srvAddr.sin_family = AF_INET;
-		srvAddr.sin_addr.s_addr = INADDR_ANY;
-		srvAddr.sin_port = htons(portnum);
+		if (fReusePort)
+		{
+			optval = 1;
+			if (setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, (void *)&optval, sizeof(optval)) != 0)
+			{
+				dps_log_error(DpsProtocolLogLevel, "setsockopt SO_REUSEPORT error %s",
+				              strerror(errno));
+				close(sock);
+				status = DOVE_STATUS_NOT_SUPPORTED;
+				break;
+			}
+		}
+
+		memset(&srvAddr, 0, sizeof(srvAddr));
+		if (server_sock_family == AF_INET6)
+		{
+			((struct sockaddr_in6 *)&srvAddr)->sin6_family = AF_INET6;
+			((struct sockaddr_in6 *)&srvAddr)->sin6_addr = in6addr_any;
+			((struct sockaddr_in6 *)&srvAddr)->sin6_port = htons(portnum);
+			srvAddr_len = sizeof(struct sockaddr_in6);
+		}
+		else
+		{
+			((struct sockaddr_in *)&srvAddr)->sin_family = AF_INET;
+			((struct sockaddr_in *)&srvAddr)->sin_addr.s_addr = INADDR_ANY;
+			((struct sockaddr_in *)&srvAddr)->sin_port = htons(portnum);
+			srvAddr_len = sizeof(struct sockaddr_in);
+		}
 
-		if (bind(server_sock,(struct sockaddr *) &srvAddr,
-		         sizeof(struct sockaddr)) == -1)
+		if (bind(sock,(struct sockaddr *) &srvAddr, srvAddr_len) == -1)
 		{
 			dps_log_error(DpsProtocolLogLevel, "bind() failed Error %s\n",
 			              strerror(errno));
+			close(sock);
 			status = DOVE_STATUS_BIND_FAILED;
 			break;
 		}
 
-		if (getsockopt(server_sock, SOL_SOCKET, SO_RCVBUF, (void *)&rcv_size, &rcv_size_len) == 0)
+		rcv_size_len = sizeof(rcv_size);
+		if (getsockopt(sock, SOL_SOCKET, SO_RCVBUF, (void *)&rcv_size, &rcv_size_len) == 0)
 		{
 			dps_log_notice(DpsProtocolLogLevel,
 			               "getsockopt SO_RCVBUF returns %d, rcv_size_len %d",
@@ -288,7 +809,7 @@ dove_status dps_svr_proto_init(uint32_t portnum)
 		}
 
 		rcv_size = 1 << 26; // 64 MB
-		if (setsockopt(server_sock, SOL_SOCKET, SO_RCVBUF, (void *)&rcv_size, sizeof(rcv_size)) == 0)
+		if (setsockopt(sock, SOL_SOCKET, SO_RCVBUF, (void *)&rcv_size, sizeof(rcv_size)) == 0)
 		{
 			dps_log_notice(DpsProtocolLogLevel, "setsockopt SO_RCVBUF set to %d", rcv_size);
 		}
@@ -297,21 +818,202 @@ dove_status dps_svr_proto_init(uint32_t portnum)
 			dps_log_error(DpsProtocolLogLevel, "setsockopt SO_RCVBUF error %d", errno);
 		}
 
-		if(fcntl(server_sock, F_SETFL, O_NONBLOCK) == -1)
+		if(fcntl(sock, F_SETFL, O_NONBLOCK) == -1)
 		{
 			dps_log_error(DpsProtocolLogLevel, "fcntl O_NONBLOCK failed Error %d\n",
 			        errno);
+			close(sock);
 			status = DOVE_STATUS_NOT_SUPPORTED;
 			break;
 		}
 
-		memset(buffer, 0, DPS_MAX_BUFF_SZ);
-		dps_log_notice(DpsProtocolLogLevel, "Adding Socket %d to CORE API\n", server_sock);
-		core_status = fd_process_add_fd(server_sock, dps_process_data_rcvd, NULL);
-		if (core_status == 0)
+		*psock = sock;
+	} while(0);
+
+	return status;
+}
+
+/*
+ ******************************************************************************
+ * dps_svr_worker_main                                                    *//**
+ *
+ * \brief - The Main Loop of a Worker Thread in Multi Worker mode. Waits on
+ *          the Worker Socket and processes all the data that arrives on it.
+ *
+ * \param[in] arg - The Worker
+ *
+ * \retval None
+ *
+ ******************************************************************************
+ */
+
+static void dps_svr_worker_main(void *arg)
+{
+	dps_svr_worker_t *worker = (dps_svr_worker_t *)arg;
+	struct pollfd pfd;
+	int ret;
+
+	dps_log_notice(DpsProtocolLogLevel, "Worker started on Socket %d", worker->sock);
+
+	while (1)
+	{
+		pfd.fd = worker->sock;
+		pfd.events = POLLIN | POLLPRI;
+		pfd.revents = 0;
+		ret = poll(&pfd, 1, -1);
+		if (ret < 0)
+		{
+			if (errno != EINTR)
+			{
+				dps_log_error(DpsProtocolLogLevel, "poll() error %s",
+				              strerror(errno));
+			}
+			continue;
+		}
+		if (pfd.revents & (POLLIN | POLLPRI))
+		{
+			dps_process_data_rcvd(worker->sock, (void *)worker->batch);
+		}
+	}
+
+	return;
+}
+
+/*
+ ******************************************************************************
+ * dps_svr_proto_workers_set                                              *//**
+ *
+ * \brief - This routine sets the Number of Workers that will service the DPS
+ *          Server UDP Port. It MUST be called before dps_svr_proto_init to
+ *          take effect.
+ *
+ * \param[in] num_workers - The Number of Workers. 1 means the Server Socket
+ *                          is serviced by the CORE API polling thread.
+ *
+ * \retval DOVE_STATUS_OK Success
+ * \retval DOVE_STATUS_INVALID_PARAMETER Number out of range
+ *
+ ******************************************************************************
+ */
+
+dove_status dps_svr_proto_workers_set(uint32_t num_workers)
+{
+	if ((num_workers == 0) || (num_workers > DPS_SVR_MAX_WORKERS))
+	{
+		dps_log_error(DpsProtocolLogLevel, "Invalid Number of Workers %d, Max %d",
+		              num_workers, DPS_SVR_MAX_WORKERS);
+		return DOVE_STATUS_INVALID_PARAMETER;
+	}
+	svr_num_workers = num_workers;
+	return DOVE_STATUS_OK;
+}
+
+/*
+ ******************************************************************************
+ * dps_svr_proto_init                                                     *//**
+ *
+ * \brief - This routine initializes the DPS Server part of the Protocol. This
+ *          routine MUST be called before the DPS Client Server Protocol can
+ *          become alive.
+ *
+ * \param[in] portnum - The UDP Port on which the DPS Server will be "listening"
+ *
+ * \retval DOVE_STATUS_OK Success
+ * \retval DOVE_STATUS_NO_RESOURCES No Resources
+ * \retval DOVE_STATUS_INVALID_FD Couldn't create UDP Socket
+ * \retval DOVE_STATUS_BIND_FAILED Bind failed to the Provided Port
+ * \retval DOVE_STATUS_NOT_SUPPORTED Cannot function in Non Blocking Mode
+ * \retval DOVE_STATUS_THREAD_FAILED Couldn't start a Worker Thread
+ *
+ ******************************************************************************
+ */
+
+dove_status dps_svr_proto_init(uint32_t portnum)
+{
+	int32_t rc;
+	int core_status;
+	uint32_t i;
+	char name[16];
+	dps_svr_worker_t *worker;
+	dove_status status = DOVE_STATUS_NO_RESOURCES;
+
+	do
+	{
+		dps_log_debug(DpsProtocolLogLevel,"dps_svr_proto_init");
+
+		// Register timer callback
+		rc = raw_proto_timer_init(&dps_retransmit_callback, RPT_OWNER_DPS);
+		if (rc != RAW_PROTO_TIMER_RETURN_OK)
+		{
+			dps_log_error(DpsProtocolLogLevel, "raw_proto_timer_init %d\n",
+			              rc);
+			status = DOVE_STATUS_NO_RESOURCES;
+			break;
+		}
+
+		if (pthread_key_create(&svr_batch_key, NULL) != 0)
+		{
+			dps_log_error(DpsProtocolLogLevel, "pthread_key_create failed");
+			status = DOVE_STATUS_NO_RESOURCES;
+			break;
+		}
+
+		memset(svr_workers, 0, sizeof(svr_workers));
+		for (i = 0; i < svr_num_workers; i++)
+		{
+			worker = &svr_workers[i];
+			status = dps_svr_socket_open(portnum, (svr_num_workers > 1),
+			                             &worker->sock);
+			if (status != DOVE_STATUS_OK)
+			{
+				break;
+			}
+			worker->batch = dps_svr_batch_alloc(worker->sock);
+			if (worker->batch == NULL)
+			{
+				dps_log_error(DpsProtocolLogLevel, "Cannot allocate Batch Buffers");
+				status = DOVE_STATUS_NO_RESOURCES;
+				break;
+			}
+		}
+		if (status != DOVE_STATUS_OK)
+		{
+			break;
+		}
+		server_sock = svr_workers[0].sock;
+
+		if (svr_num_workers == 1)
+		{
+			dps_log_notice(DpsProtocolLogLevel, "Adding Socket %d to CORE API\n", server_sock);
+			core_status = fd_process_add_fd_priority(server_sock, dps_process_data_rcvd,
+			                                         (void *)svr_workers[0].batch,
+			                                         FD_PROCESS_PRIORITY_HIGH);
+			if (core_status != 0)
+			{
+				status = DOVE_STATUS_NO_RESOURCES;
+			}
+			break;
+		}
+
+		for (i = 0; i < svr_num_workers; i++)
+		{
+			worker = &svr_workers[i];
+			snprintf(name, sizeof(name), "DPSW%d", i);
+			if (create_task((const char *)name, 0, DPS_SVR_WORKER_STACK_SZ,
+			                dps_svr_worker_main, (void *)worker,
+			                &worker->tid) != OSW_OK)
+			{
+				dps_log_error(DpsProtocolLogLevel, "Cannot start Worker %d", i);
+				status = DOVE_STATUS_THREAD_FAILED;
+				break;
+			}
+		}
+		if (status != DOVE_STATUS_OK)
 		{
-			status = DOVE_STATUS_OK;
+			break;
 		}
+		dps_log_notice(DpsProtocolLogLevel, "Started %d Workers on Port %d",
+		               svr_num_workers, portnum);
 
 	} while(0);
 
@@ -319,6 +1021,75 @@ dove_status dps_svr_proto_init(uint32_t portnum)
 
 }
 
+/*
+ ******************************************************************************
+ * dps_svr_batch_stats_show                                               *//**
+ *
+ * \brief - This routine shows the statistics of the Batched Receive and
+ *          Transmit on the DPS Server Socket
+ *
+ * \retval DOVE_STATUS_OK
+ *
+ ******************************************************************************
+ */
+
+dove_status dps_svr_batch_stats_show(void)
+{
+	dps_svr_batch_stats_t *stats;
+	uint32_t i;
+
+	for (i = 0; i < svr_num_workers; i++)
+	{
+		if (svr_workers[i].batch == NULL)
+		{
+			continue;
+		}
+		stats = &svr_workers[i].batch->stats;
+		show_print("Batched Socket I/O: Worker %d, Socket %d",
+		           i, svr_workers[i].sock);
+		show_print("Recv Batches %17lu: Recv Packets %17lu",
+		           stats->recv_batches, stats->recv_pkts);
+		show_print("Avg Recv Batch %15lu: Max Recv Batch %15lu",
+		           (stats->recv_batches ?
+		            stats->recv_pkts/stats->recv_batches : 0),
+		           stats->recv_batch_max);
+		show_print("Xmit Batches %17lu: Xmit Packets %17lu",
+		           stats->xmit_batches, stats->xmit_pkts);
+		show_print("Avg Xmit Batch %15lu: Xmit Errors %18lu",
+		           (stats->xmit_batches ?
+		            stats->xmit_pkts/stats->xmit_batches : 0),
+		           stats->xmit_errors);
+		show_print("");
+	}
+	return DOVE_STATUS_OK;
+}
+
+/*
+ ******************************************************************************
+ * dps_svr_batch_stats_clear                                              *//**
+ *
+ * \brief - This routine clears the statistics of the Batched Receive and
+ *          Transmit on the DPS Server Socket
+ *
+ * \retval DOVE_STATUS_OK
+ *
+ ******************************************************************************
+ */
+
+dove_status dps_svr_batch_stats_clear(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < svr_num_workers; i++)
+	{
+		if (svr_workers[i].batch != NULL)
+		{
+			memset(&svr_workers[i].batch->stats, 0, sizeof(dps_svr_batch_stats_t));
+		}
+	}
+	return DOVE_STATUS_OK;
+}
+
 /** @} */
 /** @} */
 /** @} */
@@ -33,6 +33,7 @@
 #define DPS_NODE_DOMAIN_VNID_LIST   "/api/dove/dps/domains/*/vnid-listing"
 #define DOVE_CLUSTER_BULK_POLICY_URI "/api/dove/dps/domains/*/bulk_policy"
 #define DOVE_CLUSTER_BULK_SUBNET4_URI "/api/dove/dps/domains/*/bulk_ipv4-subnets"
+#define DOVE_CLUSTER_MASS_TRANSFER_STREAM_URI "/api/dove/dps/domains/*/mass-transfer-stream"
 
 #define DOVE_CLUSTER_POLICY_INFO_URI_GEN(_buf, _id) \
 	snprintf((_buf), DOVE_CONTROLLER_URI_LEN, \
@@ -46,6 +47,10 @@
 	snprintf((_buf), DOVE_CONTROLLER_URI_LEN, \
 	         "/api/dove/dps/domains/%d/bulk_ipv4-subnets", (unsigned int)(_id))
 
+#define DOVE_CLUSTER_MASS_TRANSFER_STREAM_URI_GEN(_buf, _id) \
+	snprintf((_buf), DOVE_CONTROLLER_URI_LEN, \
+	         "/api/dove/dps/domains/%d/mass-transfer-stream", (unsigned int)(_id))
+
 #define DOVE_CLUSTER_VNID_LISTING_URI_GEN(_buf, _id) \
 	snprintf((_buf), DOVE_CONTROLLER_URI_LEN, \
 	         "api/dove/dps/domains/%d/vnid-listing", (unsigned int)(_id))
@@ -70,6 +75,9 @@ int dps_cluster_bulk_policy_replication(char *dps_node, uint32_t crud,
 int dps_cluster_bulk_ip4subnet_replication(char *dps_node, uint32_t crud,
                                            uint32_t domain, PyObject *pyList_subnet);
 
+int dps_cluster_mass_transfer_stream_send(char *dps_node, uint32_t domain,
+                                          char *frame, int frame_size);
+
 /*
  ******************************************************************************
  * dps_leader_create_domain                                               *//**
@@ -53,4 +53,7 @@ void dps_req_handler_domain_bulk_policy(struct evhttp_request *req, void *arg,
 void dps_req_handler_domain_bulk_ip4subnets(struct evhttp_request *req, void *arg,
                                             int argc, char **argv);
 
+void dps_req_handler_domain_mass_transfer_stream(struct evhttp_request *req, void *arg,
+                                                 int argc, char **argv);
+
 #endif // _DPS_CLUSTER_REST_REQ_HANDLER_H
@@ -1578,3 +1578,129 @@ int dps_cluster_bulk_ip4subnet_replication(char *dps_node, uint32_t crud,
 	return ret;
 }
 
+
+/*
+ * This function handles the cumulative ACK of a mass transfer stream frame
+ * {
+ * 	"stream": <stream id>, "ack": <last applied sequence>, "status": <status>
+ * }
+ * If the node doesn't reply, the sender resends from its checkpoint.
+ */
+static void dps_mass_transfer_stream_response_handler(struct evhttp_request *req, void *arg)
+{
+	struct evbuffer *buf;
+	char response[256];
+	int n;
+	json_t *js_root = NULL;
+	json_t *js_stream, *js_ack, *js_status;
+	json_error_t jerror;
+
+	log_info(PythonClusterDataLogLevel, "Enter req %p", req);
+	do
+	{
+		if (req == NULL)
+		{
+			log_info(PythonClusterDataLogLevel, "Request timed out");
+			break;
+		}
+		if (evhttp_request_get_response_code(req) != HTTP_OK)
+		{
+			log_info(PythonClusterDataLogLevel, "Resp Code = %d",
+			         evhttp_request_get_response_code(req));
+			break;
+		}
+		buf = evhttp_request_get_input_buffer(req);
+		if (buf == NULL)
+		{
+			break;
+		}
+		n = evbuffer_copyout(buf, response, sizeof(response) - 1);
+		if (n < 1)
+		{
+			break;
+		}
+		response[n] = '\0';
+		js_root = json_loads(response, 0, &jerror);
+		if (js_root == NULL)
+		{
+			log_info(PythonClusterDataLogLevel, "Bad Response %s", response);
+			break;
+		}
+		/* Borrowed reference, no need to decref */
+		js_stream = json_object_get(js_root, "stream");
+		js_ack = json_object_get(js_root, "ack");
+		js_status = json_object_get(js_root, "status");
+		if (NULL == js_stream || !json_is_integer(js_stream) ||
+		    NULL == js_ack || !json_is_integer(js_ack) ||
+		    NULL == js_status || !json_is_integer(js_status))
+		{
+			log_info(PythonClusterDataLogLevel, "Bad Response %s", response);
+			break;
+		}
+		dps_mass_transfer_stream_ack((uint32_t)json_integer_value(js_stream),
+		                             (uint32_t)json_integer_value(js_ack),
+		                             (uint32_t)json_integer_value(js_status));
+	}while(0);
+	if (js_root)
+	{
+		json_decref(js_root);
+	}
+	log_info(PythonClusterDataLogLevel, "Exit");
+	return;
+}
+
+/*
+ * This function queues a mass transfer stream frame to a DPS Node. Frames
+ * to the same node are sent in order by the REST client infrastructure,
+ * so the caller can have several frames outstanding.
+ */
+int dps_cluster_mass_transfer_stream_send(char *dps_node, uint32_t domain,
+                                          char *frame, int frame_size)
+{
+	struct evhttp_request *request = NULL;
+	char uri[256];
+	int ret = -1;
+
+	log_info(PythonClusterDataLogLevel, "Enter");
+	do
+	{
+		request = evhttp_request_new(dps_mass_transfer_stream_response_handler, NULL);
+		if(request == NULL)
+		{
+			log_alert(PythonClusterDataLogLevel,
+			          "Can not alloc the evhttp request");
+			break;
+		}
+		if (dps_rest_client_dove_controller_fill_evhttp(request, NULL) != DOVE_STATUS_OK)
+		{
+			evhttp_request_free(request);
+			break;
+		}
+		if (evbuffer_add(evhttp_request_get_output_buffer(request),
+		                 frame, frame_size) != 0)
+		{
+			evhttp_request_free(request);
+			break;
+		}
+		evhttp_add_header(evhttp_request_get_output_headers(request),
+		                  "Content-Type", "application/octet-stream");
+
+		//set the uri
+		DOVE_CLUSTER_MASS_TRANSFER_STREAM_URI_GEN(uri, domain);
+
+		log_info(PythonClusterDataLogLevel,
+		         "DCS Node %s Port %d URI %s, Frame Size %d",
+		         dps_node, dps_rest_port, uri, frame_size);
+
+		if (dps_rest_client_dove_controller_send_asyncprocess(dps_node, uri,
+		                                                      dps_rest_port,
+		                                                      EVHTTP_REQ_POST,
+		                                                      request) != DOVE_STATUS_OK)
+		{
+			break;
+		}
+		ret = 0;
+	} while (0);
+	log_info(PythonClusterDataLogLevel, "Exit");
+	return ret;
+}
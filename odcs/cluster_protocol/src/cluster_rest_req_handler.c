@@ -1119,3 +1119,119 @@ void dps_req_handler_domain_bulk_ip4subnets(struct evhttp_request *req, void *ar
 	log_info(RESTHandlerLogLevel,"Exit");
 	return;
 }
+
+/*
+ * POST /api/dove/dps/domains/<domain_id>/mass-transfer-stream
+ * The body is a binary mass transfer stream frame (see DPSMassTransferStream).
+ * The reply is the cumulative ACK of the stream
+ * {
+ * 	"stream": <stream id>, "ack": <last applied sequence>, "status": <status>
+ * }
+ */
+void dps_req_handler_domain_mass_transfer_stream(struct evhttp_request *req, void *arg,
+                                                 int argc, char **argv)
+{
+	json_t *js_res = NULL;
+	char *res_body_str = NULL;
+	struct evbuffer *retbuf = NULL;
+	struct evbuffer *req_body = NULL;
+	int res_code = HTTP_BADREQUEST;
+	int n;
+	uint32_t domain_id, stream_id, ack_seq, status;
+	char *endptr = NULL;
+
+	log_info(PythonClusterDataLogLevel, "Enter");
+
+	if (argc != 1 || NULL == argv )
+	{
+		log_info(PythonClusterDataLogLevel,
+		         "Exit: HTTP_BADREQUEST: (argc != 1 || NULL == argv )");
+		evhttp_send_reply(req, HTTP_BADREQUEST, NULL, NULL);
+		return;
+	}
+	domain_id = strtoul(argv[0], &endptr, 10);
+	if (*endptr != '\0')
+	{
+		log_info(PythonClusterDataLogLevel,
+		         "Exit: HTTP_BADREQUEST: Can't get domain id in request");
+		evhttp_send_reply(req, HTTP_BADREQUEST, NULL, NULL);
+		return;
+	}
+
+	switch (evhttp_request_get_command(req))
+	{
+		case EVHTTP_REQ_POST:
+		{
+			req_body = evhttp_request_get_input_buffer(req);
+			if (!req_body)
+			{
+				log_info(PythonClusterDataLogLevel,
+				         "evhttp_request_get_input_buffer returns NULL");
+				break;
+			}
+			if (evbuffer_get_length(req_body) > LARGE_REST_BUFFER_SIZE)
+			{
+				log_error(PythonClusterDataLogLevel,
+				          "Mass Transfer Frame Size %d too big, Quitting!!!",
+				          evbuffer_get_length(req_body));
+				break;
+			}
+			n = evbuffer_copyout(req_body, large_REST_buffer, LARGE_REST_BUFFER_SIZE);
+			if (n < 1)
+			{
+				break;
+			}
+			if (dps_mass_transfer_stream_receive(domain_id, large_REST_buffer, n,
+			                                     &stream_id, &ack_seq,
+			                                     &status) != DOVE_STATUS_OK)
+			{
+				res_code = HTTP_INTERNAL;
+				break;
+			}
+			js_res = json_pack("{s:i, s:i, s:i}",
+			                   "stream", (int)stream_id,
+			                   "ack", (int)ack_seq,
+			                   "status", (int)status);
+			if (js_res == NULL)
+			{
+				res_code = HTTP_INTERNAL;
+				break;
+			}
+			res_body_str = json_dumps(js_res, JSON_PRESERVE_ORDER);
+			if (res_body_str == NULL)
+			{
+				res_code = HTTP_INTERNAL;
+				break;
+			}
+			retbuf = evbuffer_new();
+			if (retbuf == NULL)
+			{
+				res_code = HTTP_INTERNAL;
+				break;
+			}
+			evbuffer_add(retbuf, res_body_str, strlen(res_body_str) + 1);
+			res_code = HTTP_OK;
+			break;
+		}
+		default:
+		{
+			res_code = HTTP_BADMETHOD;
+			break;
+		}
+	}
+	evhttp_send_reply(req, res_code, NULL, retbuf);
+	if (js_res)
+	{
+		json_decref(js_res);
+	}
+	if (res_body_str)
+	{
+		free(res_body_str);
+	}
+	if (retbuf)
+	{
+		evbuffer_free(retbuf);
+	}
+	log_info(PythonClusterDataLogLevel, "Exit");
+	return;
+}
@@ -33,6 +33,7 @@
 #define DPS_EXTERNAL_GATEWAY_URI "/api/dove/dps/vns/*/ipv4-external-gateways/*"
 #define DPS_STATISTICS_LOAD_BALANCING_URI "/api/dove/dps/domains/bynumber/*/load-balancing"
 #define DPS_STATISTICS_GENERAL_STATISTICS_URI "/api/dove/dps/domains/bynumber/*/general-statistics"
+#define DPS_PROTOCOL_LATENCY_URI "/api/dove/dps/protocol-latency"
 
 #define DPS_DOMAIN_IPV4SUBNETS_URI "/api/dove/dps/domains/bynumber/*/ipv4-subnets"
 #define DPS_DOMAIN_IPV4SUBNET_URI "/api/dove/dps/domains/bynumber/*/ipv4-subnets/*"
@@ -101,6 +102,7 @@ dove_status dps_rest_api_del_gateway_all(unsigned int vn_id);
 dove_status dps_rest_api_del_gateway(unsigned int vn_id, unsigned int gateway_id);
 json_t *dps_rest_api_get_statistics_load_balancing(unsigned int domain_id);
 json_t *dps_rest_api_get_statistics_general_statistics(unsigned int domain_id);
+json_t *dps_rest_api_get_protocol_latency(void);
 dove_status dps_rest_api_create_ipsubnet(unsigned int associated_type, unsigned int associated_id, unsigned int type, unsigned char *ip, unsigned int mask, unsigned int mode, unsigned char *gateway);
 dove_status dps_rest_api_del_ipsubnet(unsigned int associated_type, unsigned int associated_id, unsigned int type, unsigned char *ip, unsigned int mask);
 json_t *dps_rest_api_get_ipsubnet(unsigned int associated_type, unsigned int associated_id, unsigned int type, unsigned char *ip, unsigned int mask);
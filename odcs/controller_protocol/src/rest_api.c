@@ -721,6 +721,68 @@ json_t *dps_rest_api_get_statistics_general_statistics(unsigned int domain_id)
 	return js_root;
 }
 
+json_t *dps_rest_api_get_protocol_latency(void)
+{
+	json_t *js_root = NULL;
+	json_t *js_stages = NULL;
+	json_t *js_stage = NULL;
+	dps_pkt_latency_t lat;
+	static const char *stage_key[DPS_PKT_STAGE_MAX] = {"decode", "handler", "encode", "xmit"};
+	uint64_t total;
+	uint32_t i, j;
+
+	/* [
+		{
+			"type":1,
+			"name":"Endpoint Loc Req",
+			"decode":{"count":1001, "errors":0, "avg_ns":2100, "p50_ns":2048, "p99_ns":8192, "p999_ns":16384},
+			"handler":{...},
+			"encode":{...},
+			"xmit":{...}
+		}
+	]*/
+	js_root = json_array();
+	if (NULL == js_root)
+	{
+		return NULL;
+	}
+	for (i = DPS_ENDPOINT_LOC_REQ; i < DPS_MAX_MSG_TYPE; i++)
+	{
+		js_stages = json_pack("{s:i, s:s}", "type", (int)i, "name", dps_msg_name(i));
+		if (NULL == js_stages)
+		{
+			json_decref(js_root);
+			return NULL;
+		}
+		total = 0;
+		for (j = 0; j < DPS_PKT_STAGE_MAX; j++)
+		{
+			dps_pkt_latency_get(i, j, &lat);
+			total += lat.count;
+			js_stage = json_pack("{s:{s:I, s:I, s:I, s:I, s:I, s:I}}", stage_key[j],
+			                     "count", (json_int_t)lat.count,
+			                     "errors", (json_int_t)lat.errors,
+			                     "avg_ns", (json_int_t)(lat.count ? (lat.total_ns / lat.count) : 0),
+			                     "p50_ns", (json_int_t)dps_pkt_latency_percentile(&lat, 500),
+			                     "p99_ns", (json_int_t)dps_pkt_latency_percentile(&lat, 990),
+			                     "p999_ns", (json_int_t)dps_pkt_latency_percentile(&lat, 999));
+			if (js_stage)
+			{
+				json_object_update(js_stages, js_stage);
+				json_decref(js_stage);
+			}
+		}
+		if (total == 0)
+		{
+			// Only report the Packet Types that have seen traffic
+			json_decref(js_stages);
+			continue;
+		}
+		json_array_append_new(js_root, js_stages);
+	}
+	return js_root;
+}
+
 dove_status dps_rest_api_create_ipsubnet(unsigned int associated_type, unsigned int associated_id, unsigned int type, unsigned char *ip, unsigned int mask, unsigned int mode, unsigned char *gateway)
 {
 	dps_controller_data_op_t data_op;
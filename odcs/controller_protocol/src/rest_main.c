@@ -472,6 +472,8 @@ static void http_server_main (void *pDummy)
 	                             dps_req_handler_statistics_load_balancing, NULL);
 	helper_evhttp_set_cb_pattern(DPS_STATISTICS_GENERAL_STATISTICS_URI, DPS_REST_FWD_FLAG_DENY,
 	                             dps_req_handler_statistics_general_statistics, NULL);
+	helper_evhttp_set_cb_pattern(DPS_PROTOCOL_LATENCY_URI, DPS_REST_FWD_FLAG_DENY,
+	                             dps_req_handler_protocol_latency, NULL);
 	helper_evhttp_set_cb_pattern(DPS_DOMAIN_IPV4SUBNET_URI, DPS_REST_FWD_FLAG_GENERIC,
 	                             dps_req_handler_ipsubnet, NULL);
 	helper_evhttp_set_cb_pattern(ODCS_DVG_IPV4SUBNET_URI, DPS_REST_FWD_FLAG_GENERIC,
@@ -510,6 +512,8 @@ static void http_server_main (void *pDummy)
 	                             dps_req_handler_domain_bulk_policy, NULL);
 	helper_evhttp_set_cb_pattern(DOVE_CLUSTER_BULK_SUBNET4_URI, DPS_REST_FWD_FLAG_DENY,
 	                             dps_req_handler_domain_bulk_ip4subnets, NULL);
+	helper_evhttp_set_cb_pattern(DOVE_CLUSTER_MASS_TRANSFER_STREAM_URI, DPS_REST_FWD_FLAG_DENY,
+	                             dps_req_handler_domain_mass_transfer_stream, NULL);
 
 	/*  DPS DEBUG for DMC */
 	helper_evhttp_set_cb_pattern(DPS_DEBUG_VNID_ENDPOINTS_URI, DPS_REST_FWD_FLAG_GENERIC,
@@ -2151,6 +2151,66 @@ void dps_req_handler_statistics_load_balancing(struct evhttp_request *req, void
 	}
 }
 
+/*
+   GET /api/dove/dps/protocol-latency
+   DELETE /api/dove/dps/protocol-latency
+ */
+void dps_req_handler_protocol_latency(struct evhttp_request *req, void *arg, int argc, char **argv)
+{
+	json_t *js_res = NULL;
+	char *res_body_str = NULL;
+	struct evbuffer *retbuf = NULL;
+	int res_code = HTTP_BADREQUEST;
+
+	switch (evhttp_request_get_command(req))
+	{
+		case EVHTTP_REQ_GET:
+		{
+			js_res = dps_rest_api_get_protocol_latency();
+			if (js_res)
+			{
+				res_body_str = json_dumps(js_res, JSON_PRESERVE_ORDER);
+				if (NULL == res_body_str)
+				{
+					break;
+				}
+				retbuf = evbuffer_new();
+				if (NULL == retbuf)
+				{
+					break;
+				}
+				evbuffer_add(retbuf, res_body_str, strlen(res_body_str) + 1);
+				res_code = HTTP_OK;
+			}
+			break;
+		}
+		case EVHTTP_REQ_DELETE:
+		{
+			dps_packet_latency_clear();
+			res_code = HTTP_NOCONTENT;
+			break;
+		}
+		default:
+		{
+			res_code = HTTP_BADMETHOD;
+			break;
+		}
+	}
+	evhttp_send_reply(req, res_code, NULL, retbuf);
+	if (js_res)
+	{
+		json_decref(js_res);
+	}
+	if (res_body_str)
+	{
+		free(res_body_str);
+	}
+	if (retbuf)
+	{
+		evbuffer_free(retbuf);
+	}
+}
+
 /*
    GET /api/dps/domains/{domain_id}/general-statistics
  */
@@ -129,6 +129,38 @@ PyObject *send_gateways(PyObject *self, PyObject *args);
  ******************************************************************************/
 PyObject *send_multicast_tunnels(PyObject *self, PyObject *args);
 
+/*
+ ******************************************************************************
+ * broadcast_table_pack --                                                *//**
+ *
+ * \brief This is the routine that the PYTHON Scripts call to pack the
+ *        broadcast table of a VNID once, every time the table changes.
+ *
+ * \param[in] self  PyObject
+ * \param[in] args  The IPv4 and IPv6 Lists of DOVE Switches
+ *
+ * \return The packed table (String), None on failure
+ *
+ ******************************************************************************/
+PyObject *broadcast_table_pack(PyObject *self, PyObject *args);
+
+/*
+ ******************************************************************************
+ * broadcast_delta_pack --                                                *//**
+ *
+ * \brief This is the routine that the PYTHON Scripts call to pack a change
+ *        to the broadcast table of a VNID for DPS Clients that asked for
+ *        sequenced broadcast lists.
+ *
+ * \param[in] self  PyObject
+ * \param[in] args  The Sequence Numbers and the IPv4 and IPv6 Lists of
+ *                  DOVE Switches added and removed
+ *
+ * \return The packed change (String), None on failure
+ *
+ ******************************************************************************/
+PyObject *broadcast_delta_pack(PyObject *self, PyObject *args);
+
 /*
  ******************************************************************************
  * send_broadcast_table --                                                *//**
@@ -353,6 +385,122 @@ PyObject * dps_policy_bulk_replicate(PyObject *self, PyObject *args);
  ******************************************************************************/
 PyObject * dps_ipsubnet_bulk_replicate(PyObject *self, PyObject *args);
 
+/*
+ ******************************************************************************
+ * mass_transfer_stream_send --                                           *//**
+ *
+ * \brief This is the routine that the PYTHON Scripts calls to send a Mass
+ *        Transfer Stream Frame (a batch of packed objects) to a remote node
+ *
+ * \param[in] self  PyObject
+ * \param[in] args  The input must be the following:
+ *                  dps_node_ip (packed), domain, frame (packed)
+ *
+ * \retval 0 Success
+ * \retval -1 Failure
+ *
+ ******************************************************************************/
+PyObject *mass_transfer_stream_send(PyObject *self, PyObject *args);
+
+/*
+ ******************************************************************************
+ * dps_mass_transfer_stream_ack --                                        *//**
+ *
+ * \brief This routine hands the cumulative ACK of a Mass Transfer Stream
+ *        (received from the remote DCS Server) to the PYTHON Mass Transfer
+ *        handler
+ *
+ * \param stream_id The Stream ID
+ * \param ack_seq The highest frame sequence applied in order by the remote
+ * \param status The status of the last frame processed by the remote
+ *
+ * \retval None
+ *
+ *****************************************************************************/
+void dps_mass_transfer_stream_ack(uint32_t stream_id,
+                                  uint32_t ack_seq,
+                                  uint32_t status);
+
+/*
+ ******************************************************************************
+ * dps_mass_transfer_stream_receive --                                    *//**
+ *
+ * \brief This routine hands a received Mass Transfer Stream Frame to the
+ *        PYTHON Mass Transfer handler and returns the cumulative ACK that
+ *        must be sent back to the sender
+ *
+ * \param[in] domain_id The Domain ID
+ * \param[in] frame The Packed Frame
+ * \param[in] frame_size The size of the Frame
+ * \param[out] stream_id The Stream ID
+ * \param[out] ack_seq The highest frame sequence applied in order
+ * \param[out] status The status of processing the frame
+ *
+ * \retval DOVE_STATUS_OK The ACK fields are valid
+ * \retval DOVE_STATUS_INVALID_PARAMETER The Frame couldn't be processed
+ *
+ *****************************************************************************/
+dove_status dps_mass_transfer_stream_receive(uint32_t domain_id,
+                                             char *frame,
+                                             uint32_t frame_size,
+                                             uint32_t *stream_id,
+                                             uint32_t *ack_seq,
+                                             uint32_t *status);
+
+/*
+ ******************************************************************************
+ * dps_msg_reply_send_and_free --                                         *//**
+ *
+ * \brief This routine sends a reply formed by the DCS Server to a DPS Client
+ *        and frees the reply
+ *
+ * \param[in] reply The reply
+ * \param[in] status The dps_resp_status_t to send in the reply
+ *
+ *****************************************************************************/
+void dps_msg_reply_send_and_free(dps_client_data_t *reply, uint32_t status);
+
+/*
+ ******************************************************************************
+ * dps_replication_nodes_get --                                           *//**
+ *
+ * \brief This routine asks PYTHON for the other DCS Servers the Endpoint
+ *        Updates of a Domain must be replicated to.
+ *        MUST NOT be called with the PYTHON GIL held.
+ *
+ * \param[in] domain_id The Domain ID
+ * \param[out] nodes The DCS Servers (Host Order), the local node excluded
+ * \param[in] max_nodes The size of the nodes array
+ * \param[out] num_nodes The number of DCS Servers in nodes
+ *
+ * \return dps_resp_status_t
+ *
+ *****************************************************************************/
+dps_resp_status_t dps_replication_nodes_get(uint32_t domain_id,
+                                            ip_addr_t *nodes,
+                                            uint32_t max_nodes,
+                                            uint32_t *num_nodes);
+
+/*
+ ******************************************************************************
+ * dps_replication_batch_apply --                                         *//**
+ *
+ * \brief This routine hands a received batch of replicated Endpoint Updates
+ *        to PYTHON in a single Endpoint_Update_Batch call.
+ *        MUST NOT be called with the PYTHON GIL held.
+ *
+ * \param[in] domain_id The Domain ID
+ * \param[in] batch The batch
+ * \param[out] status_list The dps_resp_status_t of every entry
+ *
+ * \retval DPS_NO_ERR The batch was applied and status_list is valid
+ * \retval Other The batch wasn't applied
+ *
+ *****************************************************************************/
+dps_resp_status_t dps_replication_batch_apply(uint32_t domain_id,
+                                              dps_replication_batch_t *batch,
+                                              uint32_t *status_list);
+
 /*
  ******************************************************************************
  * report_endpoint_conflict --                                            *//**
@@ -463,6 +611,37 @@ dove_status python_init_dcs_protocol_interface(char *pythonpath);
 
 dps_return_status dps_protocol_send_to_server(dps_client_data_t *client_data);
 
+/*
+ ******************************************************************************
+ * dps_protocol_server_batch_start --                                     *//**
+ *
+ * \brief This routine is called by a DPS Protocol Handler Thread before it
+ *        hands a burst of received messages to dps_protocol_send_to_server.
+ *        Endpoint Location Requests that need PYTHON and Endpoint Updates
+ *        are held back till dps_protocol_server_batch_end and then handled
+ *        in a single call per message type.
+ *
+ * \return void
+ *
+ *****************************************************************************/
+
+void dps_protocol_server_batch_start(void);
+
+/*
+ ******************************************************************************
+ * dps_protocol_server_batch_end --                                       *//**
+ *
+ * \brief This routine is called by a DPS Protocol Handler Thread after the
+ *        burst of received messages has been handed to
+ *        dps_protocol_send_to_server. The held back requests are handled and
+ *        their replies sent.
+ *
+ * \return void
+ *
+ *****************************************************************************/
+
+void dps_protocol_server_batch_end(void);
+
 /*
  ******************************************************************************
  * send_message_and_free --                                               *//**
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2010-2013 IBM Corporation
+ * All rights reserved.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License v1.0 which accompanies this
+ * distribution, and is available at http://www.eclipse.org/legal/epl-v10.html
+ *
+ * File:   endpoint_index.h
+ *
+ * Native read-mostly copy of the Domain Endpoint tables. The PYTHON
+ * Domain/Endpoint/TunnelEndpoint objects remain the owner of the data and
+ * publish every change into this index (under the GIL). The DPS Protocol
+ * workers answer Endpoint Location Requests from the index without taking
+ * the GIL; anything the index cannot answer is handed to PYTHON as before.
+ */
+
+#ifndef _DPS_ENDPOINT_INDEX_H_
+#define _DPS_ENDPOINT_INDEX_H_
+
+/**
+ * \ingroup DPSClientProtocolInterface
+ * @{
+ */
+
+/*
+ ******************************************************************************
+ * dps_endpoint_index_lookup --                                           *//**
+ *
+ * \brief This routine resolves an Endpoint Location Request from the native
+ *        Endpoint Index. The search criteria is the same as the PYTHON
+ *        handlers i.e. search by vMac if the IPv4 value is 0 otherwise by vIP.
+ *        On success the routine fills in the loc_reply exactly as the
+ *        Endpoint_Location_vIP/Endpoint_Location_vMac PYTHON routines would.
+ *
+ * \param[in] domain_id The Domain ID
+ * \param[in] loc_req The Endpoint Location Request (Host Byte Order)
+ * \param[out] loc_reply The Endpoint Location Reply to fill
+ * \param[in] max_tunnels The number of tunnel_list entries that fit in
+ *                        loc_reply
+ * \param[out] num_tunnels The number of tunnels in the Endpoint record. Only
+ *                         valid when DOVE_STATUS_OK or DOVE_STATUS_EXCEEDS_CAP
+ *                         is returned.
+ *
+ * \retval DOVE_STATUS_OK loc_reply is filled in
+ * \retval DOVE_STATUS_EXCEEDS_CAP loc_reply cannot hold num_tunnels entries
+ * \retval DOVE_STATUS_NOT_FOUND Not in the index, ask PYTHON
+ * \retval DOVE_STATUS_INACTIVE Domain not active in the index, ask PYTHON
+ *
+ ******************************************************************************
+ */
+dove_status dps_endpoint_index_lookup(uint32_t domain_id,
+                                      dps_endpoint_loc_req_t *loc_req,
+                                      dps_endpoint_loc_reply_t *loc_reply,
+                                      uint32_t max_tunnels,
+                                      uint32_t *num_tunnels);
+
+/*
+ ******************************************************************************
+ * dps_endpoint_index_policy_lookup --                                    *//**
+ *
+ * \brief This routine resolves a Policy Request from the native Endpoint
+ *        Index and the unicast Policy table i.e. what Policy_Resolution_vIP/
+ *        Policy_Resolution_vMac return when a Policy exists between the
+ *        source VNID and the VNID of the destination Endpoint.
+ *
+ * \param[in] domain_id The Domain ID
+ * \param[in] policy_req The Policy Request (Host Byte Order)
+ * \param[out] policy_reply The Policy Reply to fill
+ * \param[in] max_tunnels The number of tunnel_list entries that fit in
+ *                        policy_reply
+ * \param[out] num_tunnels The number of tunnels of the destination Endpoint.
+ *                         Only valid when DOVE_STATUS_OK or
+ *                         DOVE_STATUS_EXCEEDS_CAP is returned.
+ *
+ * \retval DOVE_STATUS_OK policy_reply is filled in
+ * \retval DOVE_STATUS_EXCEEDS_CAP policy_reply cannot hold num_tunnels entries
+ * \retval DOVE_STATUS_NOT_FOUND Endpoint or Policy not in the index, ask PYTHON
+ * \retval DOVE_STATUS_INACTIVE Domain not active in the index, ask PYTHON
+ *
+ ******************************************************************************
+ */
+dove_status dps_endpoint_index_policy_lookup(uint32_t domain_id,
+                                             dps_policy_req_t *policy_req,
+                                             dps_policy_reply_t *policy_reply,
+                                             uint32_t max_tunnels,
+                                             uint32_t *num_tunnels);
+
+/*
+ ******************************************************************************
+ * endpoint_index_domain_activate --                                      *//**
+ *
+ * \brief This routine is called by the PYTHON Domain when it's created or
+ *        (de)activated. Lookups are only served for active domains.
+ *        def endpoint_index_domain_activate(domain_id, active)
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *endpoint_index_domain_activate(PyObject *self, PyObject *args);
+
+/*
+ ******************************************************************************
+ * endpoint_index_domain_flush --                                         *//**
+ *
+ * \brief This routine removes a Domain and all its Endpoints from the index.
+ *        def endpoint_index_domain_flush(domain_id)
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *endpoint_index_domain_flush(PyObject *self, PyObject *args);
+
+/*
+ ******************************************************************************
+ * endpoint_index_set --                                                  *//**
+ *
+ * \brief This routine adds or replaces the Endpoint record keyed by vMac.
+ *        def endpoint_index_set(domain_id, vMac, vnid, version,
+ *                               ipv4_list, ipv6_list, vIP_packed)
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *endpoint_index_set(PyObject *self, PyObject *args);
+
+/*
+ ******************************************************************************
+ * endpoint_index_del --                                                  *//**
+ *
+ * \brief This routine removes the Endpoint record keyed by vMac.
+ *        def endpoint_index_del(domain_id, vMac)
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *endpoint_index_del(PyObject *self, PyObject *args);
+
+/*
+ ******************************************************************************
+ * endpoint_index_vip_add --                                              *//**
+ *
+ * \brief This routine points a vIP at an Endpoint vMac.
+ *        def endpoint_index_vip_add(domain_id, vIP_type, vIP_val, vMac)
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *endpoint_index_vip_add(PyObject *self, PyObject *args);
+
+/*
+ ******************************************************************************
+ * endpoint_index_vip_del --                                              *//**
+ *
+ * \brief This routine removes a vIP from the index.
+ *        def endpoint_index_vip_del(domain_id, vIP_type, vIP_val)
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *endpoint_index_vip_del(PyObject *self, PyObject *args);
+
+/*
+ ******************************************************************************
+ * endpoint_index_policy_set --                                           *//**
+ *
+ * \brief This routine adds or replaces a unicast Policy.
+ *        def endpoint_index_policy_set(domain_id, src_vnid, dst_vnid, type,
+ *                                      version, ttl, action_packed)
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *endpoint_index_policy_set(PyObject *self, PyObject *args);
+
+/*
+ ******************************************************************************
+ * endpoint_index_policy_del --                                           *//**
+ *
+ * \brief This routine removes a unicast Policy.
+ *        def endpoint_index_policy_del(domain_id, src_vnid, dst_vnid)
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *endpoint_index_policy_del(PyObject *self, PyObject *args);
+
+/*
+ ******************************************************************************
+ * endpoint_index_lookups_fetch --                                        *//**
+ *
+ * \brief This routine returns (and resets) the number of Endpoint and Policy
+ *        Lookups served by the index for a Domain, so that PYTHON can fold
+ *        them into Endpoint_Lookup_Count and Policy_Lookup_Count.
+ *        def endpoint_index_lookups_fetch(domain_id)
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *endpoint_index_lookups_fetch(PyObject *self, PyObject *args);
+
+/** @} */
+
+#endif // _DPS_ENDPOINT_INDEX_H_
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2010-2013 IBM Corporation
+ * All rights reserved.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License v1.0 which accompanies this
+ * distribution, and is available at http://www.eclipse.org/legal/epl-v10.html
+ *
+ * File:   replication_channel.h
+ *
+ * Replication of Endpoint Updates to the other DCS Servers handling a
+ * Domain. Every (Domain, DCS Server) pair has a Replication Channel on which
+ * the updates travel in sequenced DPS_REPLICATION_BATCH messages, acked
+ * cumulatively by DPS_REPLICATION_BATCH_ACK. Windowing, retransmission and
+ * the tracking of the reply to the DPS Client are done in C; PYTHON is only
+ * called once per flush of a Domain and once per received batch.
+ */
+
+#ifndef _DPS_REPLICATION_CHANNEL_H_
+#define _DPS_REPLICATION_CHANNEL_H_
+
+/**
+ * \ingroup DPSClientProtocolInterface
+ * @{
+ */
+
+/**
+ * \brief The Query IDs of updates tracked by the Replication Channels. They
+ *        never collide with the PYTHON Query IDs which stay below 2^31.
+ */
+#define DPS_REPLICATION_UPDATE_ID_BASE 0x80000000
+
+/*
+ ******************************************************************************
+ * dps_replication_update_queue --                                        *//**
+ *
+ * \brief This routine queues an Endpoint Update, already applied on the
+ *        local node, for replication to the other DCS Servers of the
+ *        Domain. The reply is sent to the DPS Client when all of them have
+ *        acked the update, or as soon as one of them fails it.
+ *
+ * \param[in] domain_id The Domain ID
+ * \param[in] entry The Endpoint Update as received from the DPS Client
+ * \param[in] reply The reply to the DPS Client. Owned by the Replication
+ *                  Channels from here on.
+ * \param[in] fShared 1 if the update must also be acked by the Shared
+ *                    Address Space (see dps_replication_update_complete)
+ * \param[out] update_id The Query ID the Shared Address Space update must
+ *                       use
+ *
+ * \retval DOVE_STATUS_OK The update was queued
+ * \retval DOVE_STATUS_NO_MEMORY The reply wasn't taken over
+ *
+ ******************************************************************************
+ */
+dove_status dps_replication_update_queue(uint32_t domain_id,
+                                         dps_replication_entry_t *entry,
+                                         dps_client_data_t *reply,
+                                         uint32_t fShared,
+                                         uint32_t *update_id);
+
+/*
+ ******************************************************************************
+ * dps_replication_update_complete --                                     *//**
+ *
+ * \brief This routine handles the Endpoint Update Reply of the Shared Address
+ *        Space for an update queued by dps_replication_update_queue.
+ *
+ * \param[in] update_id The Query ID in the reply
+ * \param[in] status The dps_resp_status_t in the reply
+ *
+ * \retval 1 The Query ID belongs to the Replication Channels
+ * \retval 0 The Query ID belongs to PYTHON
+ *
+ ******************************************************************************
+ */
+int dps_replication_update_complete(uint32_t update_id, uint32_t status);
+
+/*
+ ******************************************************************************
+ * dps_replication_flush --                                               *//**
+ *
+ * \brief This routine hands the queued updates of every Domain to the
+ *        Replication Channels and sends the batches the windows allow. It
+ *        is called at the end of every burst of the DPS Protocol Handler
+ *        Threads and by the Replication Channel timer.
+ *        MUST NOT be called with the PYTHON GIL held.
+ *
+ ******************************************************************************
+ */
+void dps_replication_flush(void);
+
+/*
+ ******************************************************************************
+ * dps_replication_batch_receive --                                       *//**
+ *
+ * \brief This routine applies a DPS_REPLICATION_BATCH if it is the next one
+ *        on its Replication Channel and acks the Channel.
+ *        MUST NOT be called with the PYTHON GIL held.
+ *
+ * \param[in] domain_id The Domain ID
+ * \param[in] msg The DPS_REPLICATION_BATCH
+ *
+ ******************************************************************************
+ */
+void dps_replication_batch_receive(uint32_t domain_id, dps_client_data_t *msg);
+
+/*
+ ******************************************************************************
+ * dps_replication_ack_receive --                                         *//**
+ *
+ * \brief This routine handles a DPS_REPLICATION_BATCH_ACK: the acked
+ *        batches leave the window and their updates are completed.
+ *
+ * \param[in] msg The DPS_REPLICATION_BATCH_ACK
+ *
+ ******************************************************************************
+ */
+void dps_replication_ack_receive(dps_client_data_t *msg);
+
+/*
+ ******************************************************************************
+ * dps_replication_channel_init --                                        *//**
+ *
+ * \brief This routine starts the Replication Channel timer
+ *
+ * \retval DOVE_STATUS_OK
+ * \retval DOVE_STATUS_THREAD_FAILED
+ *
+ ******************************************************************************
+ */
+dove_status dps_replication_channel_init(void);
+
+/** @} */
+
+#endif // _DPS_REPLICATION_CHANNEL_H_
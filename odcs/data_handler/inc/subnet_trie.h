@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2010-2013 IBM Corporation
+ * All rights reserved.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License v1.0 which accompanies this
+ * distribution, and is available at http://www.eclipse.org/legal/epl-v10.html
+ *
+ * File:   subnet_trie.h
+ *
+ * Longest Prefix Match trie (path compressed binary trie) behind the PYTHON
+ * IPSubnetList. Every IPSubnetList owns a trie through an opaque handle and
+ * keeps it in sync with its subnets; lookups cost O(prefix length) whatever
+ * the number of subnets. The trie is only ever used with the GIL held.
+ */
+
+#ifndef _DPS_SUBNET_TRIE_H_
+#define _DPS_SUBNET_TRIE_H_
+
+/**
+ * \ingroup DPSClientProtocolInterface
+ * @{
+ */
+
+/*
+ ******************************************************************************
+ * ip_subnet_trie_create --                                               *//**
+ *
+ * \brief This routine creates an empty trie. The trie is freed when the
+ *        PYTHON handle is released.
+ *        def ip_subnet_trie_create()
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *ip_subnet_trie_create(PyObject *self, PyObject *args);
+
+/*
+ ******************************************************************************
+ * ip_subnet_trie_add --                                                  *//**
+ *
+ * \brief This routine adds (or replaces) the subnet object for a prefix.
+ *        The IP and Mask are Integers (Network Byte Order) for AF_INET and
+ *        16 byte strings for AF_INET6. The mask bits must be contiguous.
+ *        def ip_subnet_trie_add(trie, ip_type, ip_value, mask_value, subnet)
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *ip_subnet_trie_add(PyObject *self, PyObject *args);
+
+/*
+ ******************************************************************************
+ * ip_subnet_trie_del --                                                  *//**
+ *
+ * \brief This routine removes the subnet object for a prefix.
+ *        def ip_subnet_trie_del(trie, ip_type, ip_value, mask_value)
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *ip_subnet_trie_del(PyObject *self, PyObject *args);
+
+/*
+ ******************************************************************************
+ * ip_subnet_trie_lookup --                                               *//**
+ *
+ * \brief This routine returns the subnet object with the longest prefix
+ *        that covers an IP address, None if there is none.
+ *        def ip_subnet_trie_lookup(trie, ip_type, ip_value)
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *ip_subnet_trie_lookup(PyObject *self, PyObject *args);
+
+/*
+ ******************************************************************************
+ * ip_subnet_trie_flush --                                                *//**
+ *
+ * \brief This routine removes all subnets from the trie.
+ *        def ip_subnet_trie_flush(trie)
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *ip_subnet_trie_flush(PyObject *self, PyObject *args);
+
+/** @} */
+
+#endif // _DPS_SUBNET_TRIE_H_
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2010-2013 IBM Corporation
+ * All rights reserved.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License v1.0 which accompanies this
+ * distribution, and is available at http://www.eclipse.org/legal/epl-v10.html
+ *
+ * File:   vnid_cache.h
+ *
+ * Cache of the VNID to Domain ownership answered by the PYTHON
+ * Is_VNID_Handled_Locally routine. Readers (DPS Protocol workers) never
+ * lock; the cache is only ever written with the GIL held.
+ */
+
+#ifndef _DPS_VNID_CACHE_H_
+#define _DPS_VNID_CACHE_H_
+
+/**
+ * \ingroup DPSClientProtocolInterface
+ * @{
+ */
+
+/*
+ ******************************************************************************
+ * dps_vnid_cache_lookup --                                               *//**
+ *
+ * \brief This routine determines from the cache whether a VNID is handled by
+ *        the local node. Same semantics as Is_VNID_Handled_Locally.
+ *
+ * \param[in] vnid The VNID
+ * \param[in] transaction_type The DPS Transaction Type of the message
+ * \param[out] domain_id The Domain the VNID belongs to
+ * \param[out] fLocalDomain 1 if the Domain is handled locally, 0 otherwise
+ *
+ * \retval DOVE_STATUS_OK domain_id and fLocalDomain are valid
+ * \retval DOVE_STATUS_NOT_FOUND Not cached, ask PYTHON
+ *
+ ******************************************************************************
+ */
+dove_status dps_vnid_cache_lookup(uint32_t vnid,
+                                  uint32_t transaction_type,
+                                  uint32_t *domain_id,
+                                  int *fLocalDomain);
+
+/*
+ ******************************************************************************
+ * dps_vnid_cache_fill --                                                 *//**
+ *
+ * \brief This routine caches an answer of Is_VNID_Handled_Locally.
+ *        MUST be called with the PYTHON GIL held.
+ *
+ * \param[in] vnid The VNID
+ * \param[in] domain_id The Domain the VNID belongs to
+ * \param[in] fActive 1 if the Domain exists and is active on this node
+ *
+ ******************************************************************************
+ */
+void dps_vnid_cache_fill(uint32_t vnid, uint32_t domain_id, uint32_t fActive);
+
+/*
+ ******************************************************************************
+ * vnid_cache_invalidate --                                               *//**
+ *
+ * \brief This routine is called by PYTHON when a VNID is added to or removed
+ *        from VNID_Hash.
+ *        def vnid_cache_invalidate(vnid)
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *vnid_cache_invalidate(PyObject *self, PyObject *args);
+
+/*
+ ******************************************************************************
+ * vnid_cache_invalidate_all --                                           *//**
+ *
+ * \brief This routine is called by PYTHON when Domain_Hash, the activation
+ *        state of a Domain or all of VNID_Hash changes.
+ *        def vnid_cache_invalidate_all()
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *vnid_cache_invalidate_all(PyObject *self, PyObject *args);
+
+/** @} */
+
+#endif // _DPS_VNID_CACHE_H_
@@ -145,10 +145,8 @@ class DpsClientHandler(object):
         self.Gateway_Updates_To = DpsCollection.Gateway_Updates_To
         self.VNID_Multicast_Updates = DpsCollection.VNID_Multicast_Updates
         self.VNID_Multicast_Updates_To = DpsCollection.VNID_Multicast_Updates_To
-        self.Address_Resolution_Requests = DpsCollection.Address_Resolution_Requests
         self.Address_Resolution_Requests_To = DpsCollection.Address_Resolution_Requests_To
-        self.Conflict_Detection_Requests = DpsCollection.Conflict_Detection_Requests
-        self.Endpoint_Expiration_Timer_Queue = DpsCollection.Endpoint_Expiration_Timer_Queue
+        self.Timer_Wheel = DpsCollection.Timer_Wheel
         self.lock = DpsCollection.global_lock
         self.ip_get_val_from_packed = {socket.AF_INET6: self.ipv6_get_val_from_packed,
                                        socket.AF_INET: self.ipv4_get_val_from_packed}
@@ -327,6 +325,27 @@ class DpsClientHandler(object):
         @return: dps_resp_status_t
         @rtype: Integer
         '''
+        domain_locked = DpsCollection.domain_lock_acquire(domain_id)
+        ret_val = self.Endpoint_Update_Locked(domain_id, dvg_id, vnid, client_type, transaction_type,
+                                              dps_client_IP_type, dps_client_IP_packed, dps_client_port,
+                                              pIP_type, pIP_packed,
+                                              vMac, vIP_type, vIP_packed,
+                                              operation, version)
+        DpsCollection.domain_lock_release(domain_locked)
+        return ret_val
+
+    def Endpoint_Update_Locked(self, domain_id, dvg_id, vnid, client_type, transaction_type,
+                               dps_client_IP_type, dps_client_IP_packed, dps_client_port,
+                               pIP_type, pIP_packed,
+                               vMac, vIP_type, vIP_packed,
+                               operation, version):
+        '''
+        @attention: DO NOT IMPORT THIS FUNCTION FROM PYTHON CODE
+        This routine is Endpoint_Update for callers which already hold the
+        Domain lock i.e. DpsCollection.domain_lock_acquire(domain_id)
+        @param: See Endpoint_Update
+        @return: See Endpoint_Update
+        '''
         #print'Endpoint_Update: Enter domain_id %s, dvg %s, vMac %s\r'%(domain_id, dvg_id, mac_show(vMac))
         ret_val = self.dps_error_none
         fnew_endpoint = False
@@ -335,7 +354,6 @@ class DpsClientHandler(object):
         vIP_Addresses = []
         #IP Mode Integer (0 = Dedicated, 1 = Shared)
         ip_mode = IPSUBNETMode.IP_SUBNET_MODE_DEDICATED
-        self.lock.acquire()
         try:
             while True:
                 #Make sure vMAC is not a gateway MAC
@@ -583,7 +601,6 @@ class DpsClientHandler(object):
         except Exception, ex:
             message = 'Endpoint_Update, exception %s'%ex
             dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
-        self.lock.release()
         return (ret_val, ip_mode, version, vIP_Addresses)
 
     def Endpoint_Location_vIP(self, domain_id, client_type, dps_client_IP_type, dps_client_IP_packed,
@@ -609,11 +626,26 @@ class DpsClientHandler(object):
         @return: status, dvg_id, version, pIP_packed, vMac, vIP_packed
         @rtype: Integer, Integer, Integer, ByteArray, 6 char string, ByteArray
         '''
+        domain_locked = DpsCollection.domain_lock_acquire(domain_id)
+        ret_val = self.Endpoint_Location_vIP_Locked(domain_id, client_type,
+                                                    dps_client_IP_type, dps_client_IP_packed,
+                                                    src_dvg_id, vIP_type, vIP_val)
+        DpsCollection.domain_lock_release(domain_locked)
+        return ret_val
+
+    def Endpoint_Location_vIP_Locked(self, domain_id, client_type, dps_client_IP_type, dps_client_IP_packed,
+                                     src_dvg_id, vIP_type, vIP_val):
+        '''
+        @attention: DO NOT IMPORT THIS FUNCTION FROM PYTHON CODE
+        This routine is Endpoint_Location_vIP for callers which already hold
+        the Domain lock i.e. DpsCollection.domain_lock_acquire(domain_id)
+        @param: See Endpoint_Location_vIP
+        @return: See Endpoint_Location_vIP
+        '''
         #log.info('Endpoint_Location_vIP: Enter domain %s, vIP_type %s, vIP_val %s',
         #         domain_id, vIP_type, vIP_val)
         status = self.dps_error_none
         fGateway = 0
-        self.lock.acquire()
         try:
             while True:
                 try:
@@ -641,7 +673,6 @@ class DpsClientHandler(object):
                     #log.info('Endpoint_Location_vIP: Found Endpoint %s', endpoint)
                     pipv4_list = endpoint.tunnel_endpoint.ip_listv4.ip_list[:]
                     pipv6_list = endpoint.tunnel_endpoint.ip_listv6.ip_list[:]
-                    self.lock.release()
                     return (status, endpoint.dvg.unique_id, endpoint.version,
                             pipv4_list, pipv6_list, endpoint.vMac, vip_packed, fGateway)
                 except Exception:
@@ -657,7 +688,6 @@ class DpsClientHandler(object):
                 else:
                     gateway_list = src_dvg.ImplicitGatewayIPListv6
                 if gateway_list.search(vIP_val) == True:
-                    self.lock.release()
                     fGateway = 1
                     return (status, src_dvg_id, 1, 
                             [0], [],
@@ -673,13 +703,11 @@ class DpsClientHandler(object):
                                                         vIP_type, vIP_val, vip_packed)
                     except Exception:
                         pass
-                self.lock.release()
                 return (status, src_dvg_id, 1, pipv4_list, pipv6_list, vmac, vip_packed_return, fGateway)
             #Failure
         except Exception, ex:
             message = 'Endpoint_Location_vIP, exception %s'%ex
             dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
-        self.lock.release()
         return (status, 0, 0, [], [], '', '', fGateway)
 
     def Endpoint_Location_vMac(self, domain_id, src_dvg_id, vMac):
@@ -695,9 +723,21 @@ class DpsClientHandler(object):
         @return: status, dvg_id, version, pIP_packed, vMac, vIP_packed
         @rtype: Integer, Integer, Integer, ByteArray, ByteArray
         '''
+        domain_locked = DpsCollection.domain_lock_acquire(domain_id)
+        ret_val = self.Endpoint_Location_vMac_Locked(domain_id, src_dvg_id, vMac)
+        DpsCollection.domain_lock_release(domain_locked)
+        return ret_val
+
+    def Endpoint_Location_vMac_Locked(self, domain_id, src_dvg_id, vMac):
+        '''
+        @attention: DO NOT IMPORT THIS FUNCTION FROM PYTHON CODE
+        This routine is Endpoint_Location_vMac for callers which already hold
+        the Domain lock i.e. DpsCollection.domain_lock_acquire(domain_id)
+        @param: See Endpoint_Location_vMac
+        @return: See Endpoint_Location_vMac
+        '''
         status = self.dps_error_none
         fGateway = 0
-        self.lock.acquire()
         try:
             while True:
                 try:
@@ -711,7 +751,6 @@ class DpsClientHandler(object):
                 #Update Endpoint Lookup Count
                 domain.Endpoint_Lookup_Count = domain.Endpoint_Lookup_Count + 1
                 if vMac == DpsCollection.IGateway_MAC_Bytes:
-                    self.lock.release()
                     fGateway = 1
                     return (status, src_dvg_id, 1, 
                             [0], [],
@@ -729,16 +768,102 @@ class DpsClientHandler(object):
                     vip_packed = vip_addresses[0].ip_value_packed
                 else:
                     vip_packed = DpsCollection.Invalid_IP_Packed
-                self.lock.release()
                 return (status, endpoint.dvg.unique_id, endpoint.version, 
                         pipv4_list, pipv6_list, endpoint.vMac, vip_packed, fGateway)
             #Failure
         except Exception, ex:
             message = 'Endpoint_Location_vMac, exception %s'%ex
             dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
-        self.lock.release()
         return (status, 0, 0, [], [], '', '', fGateway)
 
+    def Endpoint_Location_Batch(self, request_list):
+        '''
+        @attention: DO NOT IMPORT THIS FUNCTION FROM PYTHON CODE
+        This routine Handles the Endpoint Location Requests which the DPS
+        Protocol Handler received in a single burst. The requests are grouped
+        by Domain and the lock of every Domain is taken once for its group.
+        @param request_list: List of (domain_id, client_type, dps_client_IP_type,
+                             dps_client_IP_packed, src_dvg_id, vIP_type, vIP_val,
+                             vMac). vIP_type 0 means search by vMac.
+        @type request_list: []
+        @return: List of the Endpoint_Location_vIP/Endpoint_Location_vMac return
+                 values in the same order as request_list
+        @rtype: []
+        '''
+        result_list = [(self.dps_error_no_memory, 0, 0, [], [], '', '', 0)] * len(request_list)
+        domain_requests = {}
+        for index in range(len(request_list)):
+            domain_id = request_list[index][0]
+            try:
+                domain_requests[domain_id].append(index)
+            except Exception:
+                domain_requests[domain_id] = [index]
+        for domain_id, index_list in domain_requests.items():
+            domain_locked = DpsCollection.domain_lock_acquire(domain_id)
+            try:
+                for index in index_list:
+                    (domain_id, client_type, dps_client_IP_type, dps_client_IP_packed,
+                     src_dvg_id, vIP_type, vIP_val, vMac) = request_list[index]
+                    if vIP_type == 0:
+                        result_list[index] = self.Endpoint_Location_vMac_Locked(domain_id, src_dvg_id, vMac)
+                    else:
+                        result_list[index] = self.Endpoint_Location_vIP_Locked(domain_id, client_type,
+                                                                               dps_client_IP_type,
+                                                                               dps_client_IP_packed,
+                                                                               src_dvg_id, vIP_type, vIP_val)
+            except Exception, ex:
+                message = 'Endpoint_Location_Batch, exception %s'%ex
+                dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
+            DpsCollection.domain_lock_release(domain_locked)
+        return result_list
+
+    def Endpoint_Update_Batch(self, update_list):
+        '''
+        @attention: DO NOT IMPORT THIS FUNCTION FROM PYTHON CODE
+        This routine Handles the Endpoint Updates which the DPS Protocol
+        Handler received in a single burst, or which another DCS Server
+        replicated on a Replication Channel. The updates are grouped by Domain,
+        the lock of every Domain is taken once for its group and the updates
+        of a Domain are applied in order.
+        @param update_list: List of Endpoint_Update arguments i.e.
+                            (domain_id, dvg_id, vnid, client_type,
+                            transaction_type, dps_client_IP_type,
+                            dps_client_IP_packed, dps_client_port, pIP_type,
+                            pIP_packed, vMac, vIP_type, vIP_packed, operation,
+                            version)
+        @type update_list: []
+        @return: List of the Endpoint_Update return values in the same order
+                 as update_list
+        @rtype: []
+        '''
+        result_list = [(self.dps_error_retry, IPSUBNETMode.IP_SUBNET_MODE_DEDICATED, 0, [])] * len(update_list)
+        domain_updates = {}
+        for index in range(len(update_list)):
+            domain_id = update_list[index][0]
+            try:
+                domain_updates[domain_id].append(index)
+            except Exception:
+                domain_updates[domain_id] = [index]
+        for domain_id, index_list in domain_updates.items():
+            domain_locked = DpsCollection.domain_lock_acquire(domain_id)
+            try:
+                #Same as replicated Endpoint Updates: force retry when
+                #forwarding after mass transfer
+                fForwarding = False
+                if domain_locked is not None:
+                    if len(domain_locked.mass_transfer_forward_nodes) > 0:
+                        fForwarding = True
+                for index in index_list:
+                    transaction_type = update_list[index][4]
+                    if fForwarding and transaction_type == DpsTransactionType.replication:
+                        continue
+                    result_list[index] = self.Endpoint_Update_Locked(*update_list[index])
+            except Exception, ex:
+                message = 'Endpoint_Update_Batch, exception %s'%ex
+                dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
+            DpsCollection.domain_lock_release(domain_locked)
+        return result_list
+
     def Policy_Resolution_vMac(self, domain_id, src_dvg_id, vMac):
         '''
         @attention: DO NOT IMPORT THIS FUNCTION FROM PYTHON CODE
@@ -756,7 +881,7 @@ class DpsClientHandler(object):
                 Integer, Integer, Integer, Integer, ByteArray
         '''
         status = self.dps_error_none
-        self.lock.acquire()
+        domain_locked = DpsCollection.domain_lock_acquire(domain_id)
         try:
             while True:
                 try:
@@ -795,7 +920,7 @@ class DpsClientHandler(object):
                 except Exception:
                     ###policy = domain_obj.Default_Policy?
                     #Return DENY Policy
-                    self.lock.release()
+                    DpsCollection.domain_lock_release(domain_locked)
                     return (self.dps_error_none,
                             endpoint.dvg.unique_id, endpoint.version,
                             pipv4_list,
@@ -804,7 +929,7 @@ class DpsClientHandler(object):
                             0, 0,
                             Policy.type_connectivity, Policy.action_drop_packed)
                 #Return the Policy
-                self.lock.release()
+                DpsCollection.domain_lock_release(domain_locked)
                 return (status, endpoint.dvg.unique_id, endpoint.version, 
                         pipv4_list,
                         pipv6_list,
@@ -815,7 +940,7 @@ class DpsClientHandler(object):
         except Exception, ex:
             message = 'Policy_Resolution_vMac, exception %s'%ex
             dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
-        self.lock.release()
+        DpsCollection.domain_lock_release(domain_locked)
         return (status, 0, 0, [], [], '', '', 0, 0, 0, 0, '')
 
     def Policy_Resolution_vIP(self, domain_id, client_type, dps_client_IP_type, dps_client_IP_packed,
@@ -844,7 +969,7 @@ class DpsClientHandler(object):
                 Integer, Integer, Integer, Integer, ByteArray
         '''
         status = self.dps_error_none
-        self.lock.acquire()
+        domain_locked = DpsCollection.domain_lock_acquire(domain_id)
         try:
             while True:
                 try:
@@ -884,7 +1009,7 @@ class DpsClientHandler(object):
                         policy = domain.Policy_Hash_DVG[0][key]
                     except Exception:
                         #Return DENY Policy
-                        self.lock.release()
+                        DpsCollection.domain_lock_release(domain_locked)
                         return (self.dps_error_none, 
                                 endpoint.dvg.unique_id, endpoint.version, 
                                 pipv4_list,
@@ -893,7 +1018,7 @@ class DpsClientHandler(object):
                                 0, 0,
                                 Policy.type_connectivity, Policy.action_drop_packed)
                     #Return the Policy
-                    self.lock.release()
+                    DpsCollection.domain_lock_release(domain_locked)
                     return (status, endpoint.dvg.unique_id, endpoint.version, 
                             pipv4_list,
                             pipv6_list,
@@ -909,7 +1034,7 @@ class DpsClientHandler(object):
                 else:
                     gateway_list = src_dvg.ImplicitGatewayIPListv6
                 if gateway_list.search(vIP_val) == True:
-                    self.lock.release()
+                    DpsCollection.domain_lock_release(domain_locked)
                     return (status, src_dvg_id, 1, 
                             [0],
                             [],
@@ -930,7 +1055,7 @@ class DpsClientHandler(object):
                     policy_action = Policy.action_forward_packed
                 else:
                     policy_action = Policy.action_drop_packed
-                self.lock.release()
+                DpsCollection.domain_lock_release(domain_locked)
                 return(status, src_dvg_id, 1, 
                        pipv4_list, pipv6_list, 
                        vmac, vip_packed_return,
@@ -940,7 +1065,7 @@ class DpsClientHandler(object):
         except Exception, ex:
             message = 'Policy_Resolution_vIP, exception %s'%ex
             dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
-        self.lock.release()
+        DpsCollection.domain_lock_release(domain_locked)
         return (status, 0, 0, [], [], '', '', 0, 0, 0, '')
 
     def Implicit_Gateway_List(self, domain_id, vnid):
@@ -956,7 +1081,7 @@ class DpsClientHandler(object):
         status = self.dps_error_none
         ListIPv4 = None
         ListIPv6 = None
-        self.lock.acquire()
+        domain_locked = DpsCollection.domain_lock_acquire(domain_id)
         try:
             while True:
                 try:
@@ -980,23 +1105,36 @@ class DpsClientHandler(object):
         except Exception, ex:
             message = 'Implicit_Gateway_List, exception %s'%ex
             dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
-        self.lock.release()
+        DpsCollection.domain_lock_release(domain_locked)
         return (status, ListIPv4, ListIPv6)
 
-    def Broadcast_List(self, domain_id, vnid):
+    def Broadcast_List(self, domain_id, vnid, sub_type, seq_num,
+                       dps_client_IP_type, dps_client_IP_packed):
         '''
         @attention: DO NOT IMPORT THIS FUNCTION FROM PYTHON CODE
-        This routine returns the List of DOVE Switches in a Domain
+        This routine returns the List of DOVE Switches in a Domain. DPS
+        Clients asking for sequenced lists get what changed since the
+        sequence number they have.
         @param domain_id: The Domain ID
         @type domain_id: Integer
         @param vnid: The VNID ID
         @type vnid: Integer
-        @return 2 Lists: 1st IPv4 DOVE Switches, 2nd IPv6 DOVE Switches
+        @param sub_type: DVG.bcast_list_full or DVG.bcast_list_sequenced
+        @type sub_type: Integer
+        @param seq_num: The sequence number of the list the DPS Client has
+                        (only for DVG.bcast_list_sequenced), 0 if none
+        @type seq_num: Integer
+        @param dps_client_IP_type: socket.AF_INET or socket.AF_INET6
+        @type dps_client_IP_type: Integer
+        @param dps_client_IP_packed: The DPS Client IP Address (packed)
+        @type dps_client_IP_packed: ByteArray
+        @return: (status, sub_type, packed table or change, version)
+        @rtype: (Integer, Integer, String, Integer)
         '''
         status = self.dps_error_none
-        ListIPv4 = []
-        ListIPv6 = []
-        self.lock.acquire()
+        packed = ''
+        version = 0
+        domain_locked = DpsCollection.domain_lock_acquire(domain_id)
         try:
             while True:
                 try:
@@ -1009,16 +1147,30 @@ class DpsClientHandler(object):
                 except Exception:
                     status = self.dps_error_invalid_src_dvg
                     break
-                for client_type in dvg.Tunnel_Endpoints_Hash_IPv4.keys():
-                    ListIPv4 += dvg.Tunnel_Endpoints_Hash_IPv4[client_type].keys()
-                for client_type in dvg.Tunnel_Endpoints_Hash_IPv6.keys():
-                    ListIPv6 += dvg.Tunnel_Endpoints_Hash_IPv6[client_type].keys()
+                if sub_type != DVG.bcast_list_sequenced:
+                    sub_type = DVG.bcast_list_full
+                    version, packed = dvg.broadcast_payload_get()
+                    break
+                version, packed = dvg.broadcast_delta_get(seq_num)
+                #From now on send this DPS Client sequenced lists
+                try:
+                    dps_client_IP_val = self.ip_get_val_from_packed[dps_client_IP_type](dps_client_IP_packed)
+                    if dps_client_IP_type == socket.AF_INET:
+                        dps_client = domain.DPSClients_Hash_IPv4[dps_client_IP_val]
+                    else:
+                        dps_client = domain.DPSClients_Hash_IPv6[dps_client_IP_val]
+                except Exception:
+                    break
+                dps_client.broadcast_sequenced = True
+                if dvg.Broadcast_DPS_Clients.has_key(dps_client):
+                    dvg.Broadcast_Sent[dps_client] = version
                 break
         except Exception, ex:
+            status = self.dps_error_no_memory
             message = 'Broadcast_List, exception %s'%ex
             dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
-        self.lock.release()
-        return (status, ListIPv4, ListIPv6)
+        DpsCollection.domain_lock_release(domain_locked)
+        return (status, sub_type, packed, version)
 
     def Gateway_List(self, domain_id, vnid, gateway_type):
         '''
@@ -1032,13 +1184,15 @@ class DpsClientHandler(object):
         @param gateway: The Type of Gateway
         @type gateway: DOVEGatewayTypes (GATEWAY_TYPE_IMPLICIT not supported)
                        Use Implicit_Gateway_List for GATEWAY_TYPE_IMPLICIT
-        @return: (v4 gateway List, v6 Gateway List)
-        @rtype: ([],[]) where each element of the list is (vnid, ip_value)
+        @return: (status, v4 gateway List, v6 Gateway List, version)
+        @rtype: (Integer, [], [], Integer) where each element of the list
+                is (vnid, ip_value). The version is 0 if not known.
         '''
         status = self.dps_error_none
         ListIPv4 = []
         ListIPv6 = []
-        self.lock.acquire()
+        version = 0
+        domain_locked = DpsCollection.domain_lock_acquire(domain_id)
         try:
             while True:
                 try:
@@ -1052,12 +1206,13 @@ class DpsClientHandler(object):
                     status = self.dps_error_invalid_src_dvg
                     break
                 ListIPv4, ListIPv6 = dvg.communication_gateway_list(True, gateway_type)
+                version = domain.Gateway_Version
                 break
         except Exception, ex:
             message = 'Gateway_List, exception %s'%ex
             dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
-        self.lock.release()
-        return (status, ListIPv4, ListIPv6)
+        DpsCollection.domain_lock_release(domain_locked)
+        return (status, ListIPv4, ListIPv6, version)
 
     def Is_VNID_Handled_Locally(self, vnid, transaction_type):
         '''
@@ -1067,13 +1222,15 @@ class DpsClientHandler(object):
         @type vnid: Integer
         @param transaction_type: The Type of Transaction: should be in DpsTransactionType
         @type transaction_type: Integer
-        @return: (Status {OK, NOT_FOUND}, fLocalDomain {0 = False, 1 = True}, domain_id)
-        @rtype: (Integer, Integer, Integer)
+        @return: (Status {OK, NOT_FOUND}, fLocalDomain {0 = False, 1 = True}, domain_id,
+                  fActive {1 = Domain exists and is active on this node})
+        @rtype: (Integer, Integer, Integer, Integer)
         '''
         ret_val = 0
         domain_id = 0
+        fActive = 0
         status = DOVEStatus.DOVE_STATUS_OK
-        self.lock.acquire()
+        self.lock.acquire_shared()
         try:
             while True:
                 try:
@@ -1084,6 +1241,8 @@ class DpsClientHandler(object):
                     break
                 try:
                     domain = self.Domain_Hash[domain_id]
+                    if domain.active:
+                        fActive = 1
                     if domain.active or transaction_type == DpsTransactionType.mass_transfer:
                         ret_val = 1
                 except Exception:
@@ -1092,8 +1251,8 @@ class DpsClientHandler(object):
         except Exception, ex:
             message = 'Is_VNID_Handled_Locally, exception %s'%ex
             dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
-        self.lock.release()
-        return (status, ret_val, domain_id)
+        self.lock.release_shared()
+        return (status, ret_val, domain_id, fActive)
 
     def pIP_Get_DPS_Client(self, domain_id, pIP_type, pIP_packed):
         '''
@@ -1109,7 +1268,7 @@ class DpsClientHandler(object):
         @return: status, dps_client_ip_packed, dps_client_port
         @rtype: Integer, ByteArray, Integer
         '''
-        self.lock.acquire()
+        domain_locked = DpsCollection.domain_lock_acquire(domain_id)
         try:
             while True:
                 try:
@@ -1133,12 +1292,12 @@ class DpsClientHandler(object):
                 dps_client_obj = tunnel_obj.dps_client
                 ip_packed = dps_client_obj.location.ip_value_packed
                 port = dps_client_obj.location.port
-                self.lock.release()
+                DpsCollection.domain_lock_release(domain_locked)
                 return (self.dps_error_none, ip_packed, port)
         except Exception, ex:
             message = 'pIP_Get_DPS_Client, exception %s'%ex
             dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
-        self.lock.release()
+        DpsCollection.domain_lock_release(domain_locked)
         return (ret_val, '', 0)
 
     def vIP_Get_DVG(self, domain_id, vIP_type, vIP_packed):
@@ -1155,7 +1314,7 @@ class DpsClientHandler(object):
         @rtype: Integer, Integer
         '''
         ret_val = self.dps_error_invalid_src_ip
-        self.lock.acquire()
+        domain_locked = DpsCollection.domain_lock_acquire(domain_id)
         try:
             while True:
                 try:
@@ -1174,12 +1333,12 @@ class DpsClientHandler(object):
                         endpoint = domain_obj.Endpoint_Hash_IPv6[vIP_val]
                 except Exception:
                     break
-                self.lock.release()
+                DpsCollection.domain_lock_release(domain_locked)
                 return (self.dps_error_none, endpoint.dvg.unique_id)
         except Exception, ex:
             message = 'vIP_Get_DVG, exception %s'%ex
             dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
-        self.lock.release()
+        DpsCollection.domain_lock_release(domain_locked)
         return (ret_val, 0)
 
     def Broadcast_Updates_Send(self):
@@ -1187,6 +1346,8 @@ class DpsClientHandler(object):
         @attention: DO NOT IMPORT THIS FUNCTION FROM C CODE
         This routine checks which domains need to send broadcast
         table updates to their switches and send it to them.
+        @attention: DO NOT hold the global lock when calling this routine.
+                    Each VNID is handled with its Domain lock held.
         '''
         #log.warning('VNID_Broadcast_Updates size %s\r', len(self.VNID_Broadcast_Updates))
         try:
@@ -1200,13 +1361,15 @@ class DpsClientHandler(object):
                 except Exception:
                     pass
             for dvg_tuple in dvg_dps_tuple_list:
+                dvg = dvg_tuple[0]
+                dps_client = dvg_tuple[1]
+                dvg.domain.lock_acquire()
                 try:
-                    dvg = dvg_tuple[0]
-                    dps_client = dvg_tuple[1]
                     #print 'Resending Broadcast Table To VNID %s DPS Client %s\r'%(dvg.unique_id, dps_client.location.show())
                     dvg.send_broadcast_table_to(dps_client)
                 except Exception:
                     pass
+                dvg.domain.lock_release()
             #Send new updates
             dvg_list = []
             dvg_keys = self.VNID_Broadcast_Updates.keys()
@@ -1217,10 +1380,12 @@ class DpsClientHandler(object):
                 except Exception:
                     pass
             for dvg in dvg_list:
+                dvg.domain.lock_acquire()
                 try:
                     dvg.send_broadcast_table_update()
                 except Exception:
                     pass
+                dvg.domain.lock_release()
         except Exception, ex:
             message = 'Broadcast_Updates_Send, exception %s'%ex
             dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
@@ -1230,6 +1395,7 @@ class DpsClientHandler(object):
         '''
         @attention: DO NOT IMPORT THIS FUNCTION FROM C CODE
         This routine checks sends Policy updates to DPS Clients
+        @attention: DO NOT hold the global lock when calling this routine
         '''
         #log.warning('Policy_Updates_To size %s\r', len(self.Policy_Updates_To))
         try:
@@ -1241,9 +1407,10 @@ class DpsClientHandler(object):
                 except Exception:
                     pass
             for dps_tuple in dps_client_list:
+                dvg = dps_tuple[0]
+                dps_client = dps_tuple[1]
+                dvg.domain.lock_acquire()
                 try:
-                    dvg = dps_tuple[0]
-                    dps_client = dps_tuple[1]
                     #log.warning('Policy_Updates_To_Send: Dvg %s Enter\r', dvg.unique_id)
                     dvg.send_policies_to(dps_client, 0, 0)
                     #gwy_v4, gwy_v6 = dvg.communication_gateway_list(True, DOVEGatewayTypes.GATEWAY_TYPE_EXTERNAL)
@@ -1255,6 +1422,7 @@ class DpsClientHandler(object):
                     message = 'Policy_Updates_Send: Exception in sending to DPS Client %s'%ex
                     dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
                     pass
+                dvg.domain.lock_release()
         except Exception, ex:
             message = 'Policy_Updates_Send, exception %s'%ex
             dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
@@ -1274,7 +1442,7 @@ class DpsClientHandler(object):
         @type dps_client_IP_packed: Packed Data
         @return None
         '''
-        self.lock.acquire()
+        domain_locked = DpsCollection.vnid_domain_lock_acquire(vnid_id)
         try:
             while True:
                 try:
@@ -1307,13 +1475,14 @@ class DpsClientHandler(object):
         except Exception, ex:
             message = 'Policy_Updates_Send_To, exception %s'%ex
             dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
-        self.lock.release()
+        DpsCollection.domain_lock_release(domain_locked)
         return
 
     def Gateway_Updates_Send(self):
         '''
         @attention: DO NOT IMPORT THIS FUNCTION FROM C CODE
         This routine checks sends Gateway updates to DPS Clients
+        @attention: DO NOT hold the global lock when calling this routine
         '''
         #log.warning('Gateway_Updates_Send size %s\r', len(self.Gateway_Updates_To))
         try:
@@ -1325,16 +1494,18 @@ class DpsClientHandler(object):
                 except Exception:
                     pass
             for dps_tuple in dps_client_list:
+                dvg = dps_tuple[0]
+                dps_client = dps_tuple[1]
+                gwy_type = dps_tuple[2]
+                dvg.domain.lock_acquire()
                 try:
-                    dvg = dps_tuple[0]
-                    dps_client = dps_tuple[1]
-                    gwy_type = dps_tuple[2]
                     gwy_v4, gwy_v6 = dvg.communication_gateway_list(True, gwy_type)
                     dvg.send_gateways_to(dps_client, gwy_type, gwy_v4, gwy_v6)
                 except Exception, ex:
                     message = 'Gateway_Updates_Send, Exception in sending to DPS Client %s'%ex
                     dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
                     pass
+                dvg.domain.lock_release()
         except Exception, ex:
             message = 'Gateway_Updates_Send, exception %s'%ex
             dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
@@ -1365,7 +1536,7 @@ class DpsClientHandler(object):
         @type dps_client_IP_packed: Packed Data
         @return None
         '''
-        self.lock.acquire()
+        domain_locked = DpsCollection.vnid_domain_lock_acquire(vnid_id)
         try:
             while True:
                 try:
@@ -1409,6 +1580,8 @@ class DpsClientHandler(object):
                 if message_type == self.DPS_UNSOLICITED_VNID_POLICY_LIST:
                     dvg_obj.send_policies_to(dps_client, 0, 0)
                 elif message_type == self.DPS_UNSOLICITED_BCAST_LIST_REPLY:
+                    #The DPS Client may have missed changes, send the whole list
+                    dvg_obj.broadcast_sent_reset(dps_client)
                     dvg_obj.send_broadcast_table_to(dps_client)
                 elif message_type == self.DPS_UNSOLICITED_EXTERNAL_GW_LIST:
                     gwy_v4, gwy_v6 = dvg_obj.communication_gateway_list(True, DOVEGatewayTypes.GATEWAY_TYPE_EXTERNAL)
@@ -1422,7 +1595,7 @@ class DpsClientHandler(object):
         except Exception, ex:
             message = 'Handle_Unsolicited_Message_Reply, exception %s'%ex
             dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
-        self.lock.release()
+        DpsCollection.domain_lock_release(domain_locked)
         return
 
     def Handle_Resolution_Reply(self, message_type, 
@@ -1453,7 +1626,7 @@ class DpsClientHandler(object):
         @type vIP_packed: Packed Data
         @return None
         '''
-        self.lock.acquire()
+        domain_locked = DpsCollection.vnid_domain_lock_acquire(vnid_id)
         try:
             while True:
                 try:
@@ -1526,7 +1699,7 @@ class DpsClientHandler(object):
         except Exception, ex:
             message = 'Handle_Resolution_Reply, exception %s'%ex
             dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
-        self.lock.release()
+        DpsCollection.domain_lock_release(domain_locked)
         return
 
     def Tunnel_Register(self, domain_id, vnid, client_type, transaction_type,
@@ -1557,7 +1730,7 @@ class DpsClientHandler(object):
         @rtype: Integer
         '''
         ret_val = self.dps_error_none
-        self.lock.acquire()
+        domain_locked = DpsCollection.domain_lock_acquire(domain_id)
         try:
             while True:
                 #Verify valid number
@@ -1617,7 +1790,7 @@ class DpsClientHandler(object):
             message = 'Tunnel_Register, exception %s'%ex
             dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
             ret_val = self.dps_error_retry
-        self.lock.release()
+        DpsCollection.domain_lock_release(domain_locked)
         return ret_val
 
     def Tunnel_Unregister(self, domain_id, vnid, client_type, pip_tuple_list):
@@ -1639,7 +1812,7 @@ class DpsClientHandler(object):
         @rtype: Integer
         '''
         ret_val = self.dps_error_none
-        self.lock.acquire()
+        domain_locked = DpsCollection.domain_lock_acquire(domain_id)
         try:
             while True:
                 try:
@@ -1662,7 +1835,7 @@ class DpsClientHandler(object):
             message = 'Tunnel_Unregister, exception %s'%ex
             dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
             ret_val = self.dps_error_retry
-        self.lock.release()
+        DpsCollection.domain_lock_release(domain_locked)
         return ret_val
 
     def Multicast_Get_Objects(self, domain_id, vnid, client_type, transaction_type,
@@ -1773,7 +1946,7 @@ class DpsClientHandler(object):
         @param tunnel_ip_packed: Tunnel IP in packed format
         @param tunnel_ip_packed: ByteArray
         '''
-        self.lock.acquire()
+        domain_locked = DpsCollection.domain_lock_acquire(domain_id)
         try:
             while True:
                 ret_val, multicast, dvg, mac, inet_type, ip_value, tunnel = self.Multicast_Get_Objects(
@@ -1805,7 +1978,7 @@ class DpsClientHandler(object):
             message = 'Multicast_Sender_Register, exception %s'%ex
             dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
             ret_val = self.dps_error_no_memory
-        self.lock.release()
+        DpsCollection.domain_lock_release(domain_locked)
         return ret_val
 
     def Multicast_Sender_Unregister(self, domain_id, vnid, client_type, transaction_type,
@@ -1832,7 +2005,7 @@ class DpsClientHandler(object):
         @param tunnel_ip_packed: Tunnel IP in packed format
         @param tunnel_ip_packed: ByteArray
         '''
-        self.lock.acquire()
+        domain_locked = DpsCollection.domain_lock_acquire(domain_id)
         try:
             while True:
                 ret_val, multicast, dvg, mac, inet_type, ip_value, tunnel = self.Multicast_Get_Objects(
@@ -1864,7 +2037,7 @@ class DpsClientHandler(object):
             message = 'Multicast_Sender_Unregister, exception %s'%ex
             dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
             ret_val = self.dps_error_no_memory
-        self.lock.release()
+        DpsCollection.domain_lock_release(domain_locked)
         return ret_val
 
     def Multicast_Receiver_Register(self, domain_id, vnid, client_type, transaction_type, global_scope,
@@ -1893,7 +2066,7 @@ class DpsClientHandler(object):
         @param tunnel_ip_packed: Tunnel IP in packed format
         @param tunnel_ip_packed: ByteArray
         '''
-        self.lock.acquire()
+        domain_locked = DpsCollection.domain_lock_acquire(domain_id)
         try:
             while True:
                 if global_scope == 1:
@@ -1933,7 +2106,7 @@ class DpsClientHandler(object):
             message = 'Multicast_Receiver_Register, exception %s'%ex
             dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
             ret_val = self.dps_error_no_memory
-        self.lock.release()
+        DpsCollection.domain_lock_release(domain_locked)
         return ret_val
 
     def Multicast_Receiver_Unregister(self, domain_id, vnid, client_type, transaction_type, global_scope,
@@ -1962,7 +2135,7 @@ class DpsClientHandler(object):
         @param tunnel_ip_packed: Tunnel IP in packed format
         @param tunnel_ip_packed: ByteArray
         '''
-        self.lock.acquire()
+        domain_locked = DpsCollection.domain_lock_acquire(domain_id)
         try:
             while True:
                 if global_scope == 1:
@@ -2002,7 +2175,7 @@ class DpsClientHandler(object):
             message = 'Multicast_Receiver_Unregister, exception %s'%ex
             dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
             ret_val = self.dps_error_no_memory
-        self.lock.release()
+        DpsCollection.domain_lock_release(domain_locked)
         return ret_val
 
     def Multicast_Global_Scope_Get(self, domain_id):
@@ -2017,7 +2190,7 @@ class DpsClientHandler(object):
         tunnel_ip_packed = DpsCollection.Invalid_IP_Packed
         tunnel_vnid = 0
         ret_val = self.dps_error_no_route
-        self.lock.acquire()
+        domain_locked = DpsCollection.domain_lock_acquire(domain_id)
         try:
             while True:
                 domain = self.Domain_Hash[domain_id]
@@ -2040,7 +2213,7 @@ class DpsClientHandler(object):
                 break
         except Exception:
             ret_val = self.dps_error_invalid_domain_id
-        self.lock.release()
+        DpsCollection.domain_lock_release(domain_locked)
         #print 'Multicast_Global_Scope_Get: Exit\r'
         return (ret_val, tunnel_vnid, tunnel_ip_packed)
 
@@ -2049,6 +2222,7 @@ class DpsClientHandler(object):
         This routine should be called periodically to send updated receiver
         multicast list to the senders.
         @attention: DO NOT IMPORT THIS FUNCTION FROM PYTHON CODE
+        @attention: DO NOT hold the global lock when calling this routine
         '''
         #log.warning('VNID_Multicast_Updates size %s\r', len(self.VNID_Multicast_Updates))
         try:
@@ -2072,6 +2246,7 @@ class DpsClientHandler(object):
                     ip_value = self.ip_get_val_from_packed[inet_type](ip_packed)
                 except Exception:
                     continue
+                sender_dvg.domain.lock_acquire()
                 try:
                     sender_dvg.domain.Multicast.sender_update_vnid_to(sender_dvg, 
                                                                       mac, inet_type, ip_value,
@@ -2079,6 +2254,7 @@ class DpsClientHandler(object):
                 except Exception:
                     message = 'Multicast_Updates_Send[0]: Problems sending to VNID %s'%sender_dvg.unique_id
                     dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
+                sender_dvg.domain.lock_release()
             #Nexy process new lists
             tuple_list = []
             for key in self.VNID_Multicast_Updates.keys():
@@ -2094,11 +2270,13 @@ class DpsClientHandler(object):
                 inet_type = vnid_tuple[2]
                 ip_value = vnid_tuple[3]
                 global_scope = vnid_tuple[4]
+                sender_dvg.domain.lock_acquire()
                 try:
                     sender_dvg.domain.Multicast.sender_update_vnid(sender_dvg, mac, inet_type, ip_value, global_scope)
                 except Exception:
                     message = 'Multicast_Updates_Send[1]: Problems sending to VNID %s'%sender_dvg.unique_id
                     dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
+                sender_dvg.domain.lock_release()
         except Exception, ex:
             message = 'Multicast_Updates_Send, exception %s'%ex
             dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
@@ -2121,13 +2299,11 @@ class DpsClientHandler(object):
 
     def Address_Resolution_Timeout(self):
         '''
-        This routine should be called on a periodic basis to handle timeouts 
-        for pending address resolution queries. There are 2 types of pending
-        requests.
-        1. Address Resolution Requests to specific DPS Client which could
-           not be sent out previously (due to resources constraints in the 
-           protocol handler).
-        2. Address Resolution (for a particular vIP) that hasn't been answered. 
+        This routine should be called on a periodic basis to send the
+        Address Resolution Requests to specific DPS Client which could
+        not be sent out previously (due to resources constraints in the 
+        protocol handler). Unanswered Address Resolutions are timed out
+        by the Timer Wheel.
         '''
         #Process Pending Address Resolutions
         pending_ars = []
@@ -2143,65 +2319,29 @@ class DpsClientHandler(object):
             dps_client = tuple_ar[1]
             vip_packed = tuple_ar[2]
             dvg.send_address_resolution_to(dps_client, vip_packed)
-        #Process Timeouts
-        try:
-            domain_list = []
-            for domain_id in self.Address_Resolution_Requests.keys():
-                try:
-                    domain = self.Address_Resolution_Requests[domain_id]
-                    domain_list.append(domain)
-                    del self.Address_Resolution_Requests[domain_id]
-                except Exception:
-                    pass
-            for domain in domain_list:
-                if not domain.valid:
-                    continue
-                domain.AddressResolution.process_timeout()
-                if domain.AddressResolution.total > 0:
-                    self.Address_Resolution_Requests[domain.unique_id] = domain
-        except Exception, ex:
-            message = 'Address_Resolution_Timeout, exception %s'%ex
-            dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
         return
 
-    def Conflict_Detection_Timeout(self):
-        '''
-        This routine should be called on a periodic basis to handle timeouts 
-        for pending conflict detection queries.
-        '''
-        #Process Pending Conflict Detectin
-        domain_ids = self.Conflict_Detection_Requests.keys()
-        #log.warning('Conflict_Detection_Timeout: domain ids %s\r', domain_ids)
-        for domain_id in domain_ids:
+    def Timer_Wheel_Tick(self):
+        '''
+        This routine advances the Timer Wheel by one Protocol Timer tick and
+        handles the objects whose timers expired. These are
+        1. Address Resolutions (for a particular vIP) that haven't been answered.
+        2. Conflict Detections (for a particular vIP) that haven't completed.
+        3. Endpoints which have been deleted from a tunnel but have not been
+           claimed by any other tunnel as yet. Typically this will happen in
+           a VM migration scenario when one tunnel deletes a VM but another
+           one claims it soon after.
+        Only the timers expiring in this tick are visited, so the cost does
+        not grow with the number of pending timers.
+        '''
+        for obj in self.Timer_Wheel.tick():
             try:
-                conflict = self.Conflict_Detection_Requests[domain_id]
-                del self.Conflict_Detection_Requests[domain_id]
-                conflict.process_timeout()
-            except Exception:
-                pass
+                obj.timer_expire()
+            except Exception, ex:
+                message = 'Timer_Wheel_Tick, exception %s'%ex
+                dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
         return
 
-    def Endpoint_Expiration_Timeout(self):
-        '''
-        This routine handle those Endpoint which have been deleted from a
-        tunnel but have not been claimed by any other tunnel as yet.
-        Typically this will happen in a VM migration scenario when one tunnel
-        deletes a VM but another one claims it soon after. We like to
-        preserve the vIP addresses on the endpoint from the 1st tunnel.
-        This routine will delete those endpoints that haven't been claimed
-        by a new tunnel.
-        '''
-        for endpoint in self.Endpoint_Expiration_Timer_Queue.keys():
-            try:
-                timeout = self.Endpoint_Expiration_Timer_Queue[endpoint]
-                if timeout == 0:
-                    del self.Endpoint_Expiration_Timer_Queue[endpoint]
-                    endpoint.delete()
-                else:
-                    self.Endpoint_Expiration_Timer_Queue[endpoint] = timeout - 1
-            except Exception:
-                pass
-
     def VNID_Query_Timeout(self):
         '''
         This routine sends a message to query for VNIDs which
@@ -2251,9 +2391,7 @@ class DpsClientHandler(object):
         self.Gateway_Updates_To.clear() 
         self.VNID_Multicast_Updates.clear()
         self.VNID_Multicast_Updates_To.clear()
-        self.Address_Resolution_Requests.clear()
         self.Address_Resolution_Requests_To.clear()
-        self.Conflict_Detection_Requests.clear()
         self.lock.release()
         return
 
@@ -2264,21 +2402,15 @@ class DpsClientHandler(object):
         '''
         if not self.started:
             return
-        self.lock.acquire()
         #print 'Protocol_Timer_Routine: Enter\r'
+        #The update senders take the Domain locks one VNID at a time
         self.Broadcast_Updates_Send()
         self.Policy_Updates_Send()
-        self.lock.release()
-        self.lock.acquire()
         self.Gateway_Updates_Send()
         self.Multicast_Updates_Send()
-        self.lock.release()
         self.lock.acquire()
         self.Address_Resolution_Timeout()
-        self.Conflict_Detection_Timeout()
-        self.lock.release()
-        self.lock.acquire()
-        self.Endpoint_Expiration_Timeout()
+        self.Timer_Wheel_Tick()
         #print 'Protocol_Timer_Routine: Exit\r'
         self.lock.release()
         self.lock.acquire()
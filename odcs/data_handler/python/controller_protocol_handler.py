@@ -180,6 +180,7 @@ class DpsControllerHandler(object):
                     del self.VNID_Hash[vnid]
                 except Exception:
                     pass
+                dcslib.vnid_cache_invalidate(vnid)
                 try:
                     del domain_global[vnid]
                 except Exception:
@@ -371,6 +372,8 @@ class DpsControllerHandler(object):
                 domain = self.Domain_Hash[domain_id]
                 domain.active = True
                 domain.replication_factor = replication_factor
+                dcslib.endpoint_index_domain_activate(domain_id, 1)
+                dcslib.vnid_cache_invalidate_all()
             except Exception:
                 ret_val = DOVEStatus.DOVE_STATUS_INVALID_DOMAIN
                 break
@@ -746,6 +749,7 @@ class DpsControllerHandler(object):
                 pass
             #Add to Global Collection
             self.VNID_Hash[dvg_id] = domain_id
+            dcslib.vnid_cache_invalidate(dvg_id)
             try:
                 domain_global = self.Domain_Hash_Global[domain_id]
             except Exception:
@@ -858,6 +862,7 @@ class DpsControllerHandler(object):
             del self.VNID_Hash[vnid]
         except Exception:
             pass
+        dcslib.vnid_cache_invalidate(vnid)
         try:
             del self.Domain_Hash_Global[domain_id][vnid]
             if len(self.Domain_Hash_Global[domain_id]) == 0:
@@ -1103,7 +1108,7 @@ class DpsControllerHandler(object):
         @return: The status of the operation
         @rtype: dove_status (defined in include/status.h) Integer
         '''
-        self.lock.acquire()
+        domain_locked = DpsCollection.domain_lock_acquire(domain_id)
         while True:
             try:
                 domain_obj = self.Domain_Hash[domain_id]
@@ -1114,18 +1119,18 @@ class DpsControllerHandler(object):
                 src_dvg_obj = domain_obj.DVG_Hash[src_dvg_id]
             except Exception:
                 #Create DVG implicitly
-                self.lock.release()
+                DpsCollection.domain_lock_release(domain_locked)
                 ret_val = self.Dvg_Add(domain_id, src_dvg_id)
-                self.lock.acquire()
+                domain_locked = DpsCollection.domain_lock_acquire(domain_id)
                 if ret_val != DOVEStatus.DOVE_STATUS_OK:
                     break
             try:
                 dst_dvg_obj = domain_obj.DVG_Hash[dst_dvg_id]
             except Exception:
                 #Create DVG implicitly
-                self.lock.release()
+                DpsCollection.domain_lock_release(domain_locked)
                 ret_val = self.Dvg_Add(domain_id, dst_dvg_id)
-                self.lock.acquire()
+                domain_locked = DpsCollection.domain_lock_acquire(domain_id)
                 if ret_val != DOVEStatus.DOVE_STATUS_OK:
                     break
             if policy_type != Policy.type_connectivity:
@@ -1147,7 +1152,7 @@ class DpsControllerHandler(object):
             else:
                 ret_val = DOVEStatus.DOVE_STATUS_OK
             break
-        self.lock.release()
+        DpsCollection.domain_lock_release(domain_locked)
         return ret_val
 
     def Policy_Delete(self, traffic_type, domain_id, src_dvg_id, dst_dvg_id):
@@ -1166,7 +1171,7 @@ class DpsControllerHandler(object):
         @rtype: dove_status (defined in include/status.h) Integer
         '''
         status = DOVEStatus.DOVE_STATUS_OK
-        self.lock.acquire()
+        domain_locked = DpsCollection.domain_lock_acquire(domain_id)
         while True:
             try:
                 domain_obj = self.Domain_Hash[domain_id]
@@ -1181,7 +1186,7 @@ class DpsControllerHandler(object):
             except Exception:
                 pass
             break
-        self.lock.release()
+        DpsCollection.domain_lock_release(domain_locked)
         return status
 
     def Controller_Location_Update(self, IP_type, IP_packed, Port):
@@ -1444,7 +1449,7 @@ class DpsControllerHandler(object):
         @return: status, policy_type, policy_ttl, policy_action, policy_version
         @rtype: Integer, Integer, Integer, Integer, ByteArray, Integer
         '''
-        self.lock.acquire()
+        domain_locked = DpsCollection.domain_lock_acquire(domain_id)
         while True:
             try:
                 domain_obj = self.Domain_Hash[domain_id]
@@ -1455,10 +1460,10 @@ class DpsControllerHandler(object):
                 policy_obj = domain_obj.Policy_Hash_DVG[traffic_type][policy_key]
             except Exception:
                 break
-            self.lock.release()
+            DpsCollection.domain_lock_release(domain_locked)
             return (DOVEStatus.DOVE_STATUS_OK, policy_obj.type,
                     policy_obj.ttl, policy_obj.action, policy_obj.version)
-        self.lock.release()
+        DpsCollection.domain_lock_release(domain_locked)
         return (DOVEStatus.DOVE_STATUS_INVALID_POLICY, 0, 0, '', 0)
 
     def Policy_GetAllIds(self, traffic_type, domain_id):
@@ -1473,7 +1478,7 @@ class DpsControllerHandler(object):
         @rtype: String
         '''
         policy_list_str = ''
-        self.lock.acquire()
+        domain_locked = DpsCollection.domain_lock_acquire(domain_id)
         while True:
             try:
                 domain_obj = self.Domain_Hash[domain_id]
@@ -1483,7 +1488,7 @@ class DpsControllerHandler(object):
             except Exception:
                 break
             break
-        self.lock.release()
+        DpsCollection.domain_lock_release(domain_locked)
         return policy_list_str
 
     def IP_Subnet_Add(self, associated_type, associated_id, IP_type, IP_value, mask_value, mode, gateway):
@@ -1722,6 +1727,7 @@ class DpsControllerHandler(object):
         self.lock.acquire()
         self.VNID_Hash.clear()
         self.Domain_Hash_Global.clear()
+        dcslib.vnid_cache_invalidate_all()
         self.cluster_db = None
         self.lock.release()
         return
@@ -28,22 +28,27 @@ class AddressResolutionvIP:
     Represents the Address Resolution for a Virtual IP Address
     '''
 
-    def __init__(self, vIP_type, vIP_value):
+    #The number of Protocol Timer ticks to wait for the vIP to be resolved
+    timeout_ticks = 3
+
+    def __init__(self, address_resolution, vIP_type, vIP_value):
         '''
         Constructor:
+        @param address_resolution: The Address Resolution of the Domain
+        @type address_resolution: AddressResolution
         @param vIP_type: socket.AF_INET or socket.AF_INET6
         @type vIP_type: Integer
         @param vIP_value: The Virtual IP Address
         @type vIP_value: String (IPv6), Integer (IPv4)
         '''
+        self.address_resolution = address_resolution
         self.vIP = IPAddressLocation(vIP_type, vIP_value, 0)
         #List of Waiters which are waiting for answer on this Resolution
         #Key (DPS Client)
         self.dps_clients = {}
         #Total number of waiters
         self.total = 0
-        #Retry is decremented in every cycle
-        self.retry = 2
+        DpsCollection.Timer_Wheel.start(self, self.timeout_ticks)
 
     def add(self, dps_client, dvg):
         '''
@@ -122,9 +127,9 @@ class AddressResolutionvIP:
             except Exception:
                 pass
             for dvg in dvgs:
-                DpsCollection.global_lock.acquire()
+                dvg.domain.lock_acquire()
                 if not dvg.valid:
-                    DpsCollection.global_lock.release()
+                    dvg.domain.lock_release()
                     continue
                 try:
                     dvg.send_endpoint_location_reply_to(dps_client.location.ip_value_packed,
@@ -140,7 +145,7 @@ class AddressResolutionvIP:
                     message = 'Address Resolution: Send location reply to Exception [%s]'%ex
                     dcslib.dps_data_write_log(DpsLogLevels.WARNING,
                                                  message)
-                DpsCollection.global_lock.release()
+                dvg.domain.lock_release()
         self.dps_clients.clear()
         return
 
@@ -158,6 +163,7 @@ class AddressResolutionvIP:
             vIP_location = endpoint.vIP_set[self.vIP.ip_value]
         except Exception:
             raise Exception('Incorrect Endpoint')
+        DpsCollection.Timer_Wheel.stop(self)
         #Put work item on the queue
         DpsCollection.address_resolution_queue.put((self.resolved_work_item, endpoint))
         return self.total
@@ -177,26 +183,20 @@ class AddressResolutionvIP:
             print '    [%d] DPS Client %s, VNIDs %s\r'%(i, dps_client.location.show(), vnids)
         print '--------------------------------------\r'
 
-    def timeout(self):
+    def timer_expire(self):
         '''
         Handle timeout
-        @return: (True, number of entries) if deleted
-        @rtype: Tuple (Boolean, Integer)
-        '''
-        if self.retry <= 0:
-            entries = self.delete()
-            return (True, entries)
-        else:
-            self.retry -= 1
-            return (False, 0)
+        '''
+        self.address_resolution.resolution_expired(self)
+        return
 
     def delete(self):
         '''
         Delete self
         '''
+        DpsCollection.Timer_Wheel.stop(self)
         total = self.total
         self.dps_clients.clear()
-        self.retry = 0
         self.total = 0
         return total
 
@@ -244,7 +244,7 @@ class AddressResolution:
                 resolution_obj = self.endpoint_resolution[vIP_val]
                 fSendAddressResolution = False
             except Exception:
-                resolution_obj = AddressResolutionvIP(vIP_type, vIP_val)
+                resolution_obj = AddressResolutionvIP(self, vIP_type, vIP_val)
                 self.endpoint_resolution[vIP_val] = resolution_obj
             added = resolution_obj.add(dps_client, dvg)
             if added:
@@ -306,20 +306,19 @@ class AddressResolution:
             dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
         return
 
-    def process_timeout(self):
+    def resolution_expired(self, resolution_obj):
         '''
-        This routine processes timeouts and removes resolutions that have been waiting a
-        long time for an answer
+        This routine removes a resolution that has been waiting a long time
+        for an answer
+        @param resolution_obj: The Address Resolution of the vIP
+        @type resolution_obj: AddressResolutionvIP
         '''
-        for key in self.endpoint_resolution.keys():
-            try:
-                obj = self.endpoint_resolution[key]
-                deleted, count = obj.timeout()
-                if deleted:
-                    self.total -= count
-                    del self.endpoint_resolution[key]
-            except Exception:
-                pass
+        try:
+            if self.endpoint_resolution[resolution_obj.vIP.ip_value] == resolution_obj:
+                del self.endpoint_resolution[resolution_obj.vIP.ip_value]
+        except Exception:
+            pass
+        self.total -= resolution_obj.delete()
         return
 
     def delete(self):
@@ -27,26 +27,30 @@ class ConflictDetectionvIP:
     Represents the Conflict Detection for a Virtual IP Address
     '''
 
-    def __init__(self, domain_id, vIP_type, vIP_value):
+    #The number of Protocol Timer ticks to wait for the Endpoints to
+    #register the vIP
+    timeout_ticks = 3
+
+    def __init__(self, conflict_detection, vIP_type, vIP_value):
         '''
         Constructor:
-        @param domain_id: The Domain ID
-        @type domain_id: Integer
+        @param conflict_detection: The Conflict Detection of the Domain
+        @type conflict_detection: ConflictDetection
         @param vIP_type: socket.AF_INET or socket.AF_INET6
         @type vIP_type: Integer
         @param vIP_value: The Virtual IP Address
         @type vIP_value: String (IPv6), Integer (IPv4)
         '''
-        self.domain_id = domain_id
+        self.conflict_detection = conflict_detection
+        self.domain_id = conflict_detection.domain_id
         self.vIP = IPAddressLocation(vIP_type, vIP_value, 0)
         #Set of Endpoints that claim to have this vIP
         self.endpoints_claim = {}
         #Set of Endpoint which actually have this vIP
         self.endpoints_registered = {}
-        #Retry is decremented in every cycle
-        self.retry = 2
         #Who owns the endpoint at this time
         self.endpoint_owner = None
+        DpsCollection.Timer_Wheel.start(self, self.timeout_ticks)
         #log.warning('ConflictDetectionvIP: for IP %s\r', self.vIP.show())
 
     def endpoint_claim(self, endpoint, transaction_type):
@@ -129,18 +133,14 @@ class ConflictDetectionvIP:
             pass
         return
 
-    def timeout(self):
+    def timer_expire(self):
         '''
         Handle timeout
-        @return: True if the conflict detection timer has expired
         '''
         #log.warning('timeout: vIP %s\r', self.vIP.show())
-        if self.retry <= 0:
-            self.complete()
-            return True
-        else:
-            self.retry -= 1
-            return False
+        self.conflict_detection.conflict_expired(self)
+        self.complete()
+        return
 
     def complete(self):
         '''
@@ -190,12 +190,14 @@ class ConflictDetectionvIP:
         #Clear all entries
         self.endpoints_claim.clear()
         self.endpoints_registered.clear()
+        DpsCollection.Timer_Wheel.stop(self)
         return
 
     def delete(self):
         '''
         This routine
         '''
+        DpsCollection.Timer_Wheel.stop(self)
         #Clear all entries
         self.endpoints_claim.clear()
         self.endpoints_registered.clear()
@@ -249,11 +251,9 @@ class ConflictDetection:
             except Exception:
                 if len(self.conflict_detection_IP) > self.total_max:
                     break
-                conflict = ConflictDetectionvIP(self.domain_id, vIP_type, vIP_val)
+                conflict = ConflictDetectionvIP(self, vIP_type, vIP_val)
                 self.conflict_detection_IP[vIP_val] = conflict
             conflict.endpoint_claim(endpoint, transaction_type)
-            #Add Domain to global collection waiting for conflict resolution
-            DpsCollection.Conflict_Detection_Requests[self.domain_id] = self
             break
         return
 
@@ -289,22 +289,18 @@ class ConflictDetection:
             conflict.endpoint_delete(endpoint)
         return
 
-    def process_timeout(self):
+    def conflict_expired(self, conflict):
         '''
-        This routine processes timeouts and removes resolutions that have been waiting a
+        This routine removes a Conflict Detection that has been waiting a
         long time for an answer
+        @param conflict: The Conflict Detection of the vIP
+        @type conflict: ConflictDetectionvIP
         '''
-        for key in self.conflict_detection_IP.keys():
-            try:
-                conflict = self.conflict_detection_IP[key]
-                deleted = conflict.timeout()
-                if deleted:
-                    del self.conflict_detection_IP[key]
-            except Exception:
-                pass
-        if len(self.conflict_detection_IP) > 0:
-            #Add Domain to global collection waiting for conflict resolution
-            DpsCollection.Conflict_Detection_Requests[self.domain_id] = self
+        try:
+            if self.conflict_detection_IP[conflict.vIP.ip_value] == conflict:
+                del self.conflict_detection_IP[conflict.vIP.ip_value]
+        except Exception:
+            pass
         return
 
     def delete(self):
@@ -321,8 +317,4 @@ class ConflictDetection:
                 del self.conflict_detection_IP[key]
             except Exception:
                 pass
-        try:
-            del DpsCollection.Conflict_Detection_Requests[self.domain_id]
-        except Exception:
-            pass
         return
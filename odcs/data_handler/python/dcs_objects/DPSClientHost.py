@@ -14,6 +14,7 @@ import socket
 from logging import getLogger
 log = getLogger(__name__)
 import time
+import threading
 
 from dcs_objects.IPAddressLocation import IPAddressLocation
 from object_collection import DpsCollection
@@ -30,6 +31,9 @@ class DPSClientHost:
                 keep in contact with that Host via heartbeat messages
     '''
     Collection = {}
+    #Protects the Collection against Routines holding different Domain
+    #locks. This is a leaf lock, see DpsGlobalLock.
+    lock = threading.Lock()
 
     #The frequency (seconds) at which to send heartbeat to DPS Clients
     heartbeat_frequency = {DpsClientType.dove_switch: 60,
@@ -218,11 +222,16 @@ class DPSClientHost:
         @type client_type: Should be one of DpsClientType
         '''
         #print 'Host_Add: Enter\r'
+        DPSClientHost.lock.acquire()
         try:
             dps_client = DPSClientHost.Collection[ip_val]
             dps_client.update_add(domain, port, client_type)
         except Exception:
-            dps_client = DPSClientHost(domain, ip_type, ip_val, port, client_type)
+            try:
+                dps_client = DPSClientHost(domain, ip_type, ip_val, port, client_type)
+            except Exception:
+                pass
+        DPSClientHost.lock.release()
         #print 'Host_Add: Exit\r'
         return
 
@@ -239,11 +248,13 @@ class DPSClientHost:
         @param client_type: What kind of Client is it
         @type client_type: Should be one of DpsClientType
         '''
+        DPSClientHost.lock.acquire()
         try:
             dps_client = DPSClientHost.Collection[ip_val]
             dps_client.update_delete(domain, client_type)
         except Exception:
             pass
+        DPSClientHost.lock.release()
         return
 
     @staticmethod
@@ -257,11 +268,13 @@ class DPSClientHost:
         @param ip_val: The Value of the IP Address
         @type ip_val: String (IPv6) or Integer
         '''
+        DPSClientHost.lock.acquire()
         try:
             dps_client = DPSClientHost.Collection[ip_val]
             dps_client.delete()
         except Exception:
             pass
+        DPSClientHost.lock.release()
         return
 
     @staticmethod
@@ -13,8 +13,10 @@ import time
 from logging import getLogger
 log = getLogger(__name__)
 
+import sys
 import struct
 import socket
+import random
 import Queue #renamed to queue in Python 3.0
 import threading
 from threading import Thread
@@ -38,6 +40,9 @@ class Domain(dcs_object):
     This represents the Domain Object in DOVE
     '''
 
+    #The number of Endpoints measured by memory_footprint
+    memory_sample_max = 1000
+
     def __init__(self, domain_id, active):
         '''
         Constructor:
@@ -52,6 +57,9 @@ class Domain(dcs_object):
         self.active = active
         self.replication_factor = 1
         self.mass_transfer = None
+        #The Domain Lock. Routines which only work on this Domain hold it
+        #together with the global lock in shared mode. See lock_acquire.
+        self.lock = threading.RLock()
         #Set of nodes to forward updates after Mass Transfer is complete
         #and waiting for all other nodes to see this new DPS Node
         #as part of the domain.
@@ -80,6 +88,10 @@ class Domain(dcs_object):
         #The first index is for unicast policy, the second for multicast
         #############################################################
         self.Policy_Hash_DVG = [{}, {}]
+        #Bumped every time the External or VLAN Gateways a VNID can
+        #communicate with may have changed i.e. when a Gateway, a Policy
+        #or a DVG is added or removed. Starts at a random value, never 0.
+        self.Gateway_Version = random.randint(1, 0x3fffffff)
         #############################################################
         #DPS Client Hash Tables (Requirement 1.5)
         #############################################################
@@ -103,6 +115,12 @@ class Domain(dcs_object):
         #############################################################
         DpsCollection.Domain_Hash[domain_id] = self
         #DpsCollection.VNID_Hash[domain_id] = domain_id
+        #Native Endpoint Index only serves active domains
+        try:
+            dcslib.endpoint_index_domain_activate(domain_id, 1 if active else 0)
+        except Exception:
+            pass
+        dcslib.vnid_cache_invalidate_all()
         #############################################################
         #Statistics 
         #############################################################
@@ -124,6 +142,24 @@ class Domain(dcs_object):
         # Initialize the common part
         dcs_object.__init__(self, domain_id)
 
+    def lock_acquire(self):
+        '''
+        This routine takes the global lock shared and the Domain lock.
+        @attention: Do not take the global lock exclusively while holding
+                    the Domain lock.
+        '''
+        DpsCollection.global_lock.acquire_shared()
+        self.lock.acquire()
+        return
+
+    def lock_release(self):
+        '''
+        This routine releases the locks taken by lock_acquire
+        '''
+        self.lock.release()
+        DpsCollection.global_lock.release_shared()
+        return
+
     def dvg_add(self, dvg):
         '''
         Adds a DVG to the Domain Collection
@@ -131,6 +167,17 @@ class Domain(dcs_object):
         @type dvg: DVG
         '''
         self.DVG_Hash[dvg.unique_id] = dvg
+        self.gateway_version_bump()
+        return
+
+    def gateway_version_bump(self):
+        '''
+        Moves the Gateway Lists of all VNIDs in this Domain to the next
+        version.
+        '''
+        self.Gateway_Version += 1
+        if self.Gateway_Version > 0x7fffffff:
+            self.Gateway_Version = 1
         return
 
     def dvg_del(self, dvg):
@@ -144,6 +191,7 @@ class Domain(dcs_object):
         try:
             dvg = self.DVG_Hash[dvg.unique_id]
             del self.DVG_Hash[dvg.unique_id]
+            self.gateway_version_bump()
             dvg.delete()
         except Exception:
             pass
@@ -166,6 +214,7 @@ class Domain(dcs_object):
         @type dvg: Policy
         '''
         self.Policy_Hash_DVG[policy.traffic_type][policy.key] = policy
+        self.policy_index_publish(policy)
         return
 
     def policy_del(self, policy):
@@ -178,6 +227,38 @@ class Domain(dcs_object):
             del self.Policy_Hash_DVG[policy.traffic_type][policy.key]
         except Exception:
             pass
+        if policy.traffic_type == 0:
+            try:
+                dcslib.endpoint_index_policy_del(self.unique_id,
+                                                 policy.src_dvg.unique_id,
+                                                 policy.dst_dvg.unique_id)
+            except Exception:
+                pass
+        return
+
+    def policy_index_publish(self, policy):
+        '''
+        Publishes a Unicast Policy into the native Endpoint Index from which
+        the DPS Protocol workers answer Policy Resolution Requests without
+        the GIL. Must be called whenever the Policy changes.
+        @param policy: The Policy Object
+        @type policy: Policy
+        '''
+        if policy.traffic_type != 0:
+            return
+        try:
+            if self.Policy_Hash_DVG[0][policy.key] is not policy:
+                return
+        except Exception:
+            return
+        try:
+            dcslib.endpoint_index_policy_set(self.unique_id,
+                                             policy.src_dvg.unique_id,
+                                             policy.dst_dvg.unique_id,
+                                             policy.type, policy.version,
+                                             policy.ttl, policy.action)
+        except Exception:
+            pass
         return
 
     def endpoint_add(self, endpoint):
@@ -189,6 +270,7 @@ class Domain(dcs_object):
         self.Endpoint_Hash_MAC[endpoint.vMac] = endpoint
         for vIP_key in endpoint.vIP_set.keys():
             self.endpoint_vIP_add(endpoint, endpoint.vIP_set[vIP_key])
+        self.endpoint_index_publish(endpoint)
         return
 
     def endpoint_del(self, endpoint):
@@ -201,10 +283,64 @@ class Domain(dcs_object):
             del self.Endpoint_Hash_MAC[endpoint.vMac]
         except Exception:
             pass
+        try:
+            dcslib.endpoint_index_del(self.unique_id, endpoint.vMac)
+        except Exception:
+            pass
         for vIP_key in endpoint.vIP_set.keys():
             self.endpoint_vIP_del(endpoint.vIP_set[vIP_key])
         return
 
+    def endpoint_index_publish(self, endpoint):
+        '''
+        Publishes the Endpoint into the native Endpoint Index from which
+        the DPS Protocol workers answer Endpoint Location Requests without
+        the GIL. Must be called whenever anything Endpoint_Location_vMac
+        returns changes. An Endpoint that is not the one hashed by its vMac
+        is left alone; one that is being deleted or migrated is withdrawn
+        so that the lookups fall back to this code.
+        @param endpoint: Endpoint Object
+        @type endpoint: Endpoint
+        '''
+        try:
+            if self.Endpoint_Hash_MAC[endpoint.vMac] is not endpoint:
+                return
+        except Exception:
+            return
+        if endpoint.vMac == DpsCollection.IGateway_MAC_Bytes:
+            return
+        try:
+            if (not endpoint.valid or endpoint.in_migration or
+                endpoint.tunnel_endpoint is None):
+                dcslib.endpoint_index_del(self.unique_id, endpoint.vMac)
+                return
+            vip_addresses = endpoint.vIP_set.values()
+            if len(vip_addresses) > 0:
+                vip_packed = vip_addresses[0].ip_value_packed
+            else:
+                vip_packed = DpsCollection.Invalid_IP_Packed
+            dcslib.endpoint_index_set(self.unique_id, endpoint.vMac,
+                                      endpoint.dvg.unique_id, endpoint.version,
+                                      endpoint.tunnel_endpoint.ip_listv4.ip_list,
+                                      endpoint.tunnel_endpoint.ip_listv6.ip_list,
+                                      vip_packed)
+        except Exception:
+            pass
+        return
+
+    def endpoint_lookup_count_update(self):
+        '''
+        Folds the Endpoint and Policy Lookups served by the native
+        Endpoint Index into Endpoint_Lookup_Count and Policy_Lookup_Count
+        '''
+        try:
+            endpoint_lookups, policy_lookups = dcslib.endpoint_index_lookups_fetch(self.unique_id)
+            self.Endpoint_Lookup_Count += endpoint_lookups
+            self.Policy_Lookup_Count += policy_lookups
+        except Exception:
+            pass
+        return
+
     def endpoint_vIP_add(self, endpoint, vIP):
         '''
         Adds an Endpoint (Virtual) IP Address to the collection
@@ -218,6 +354,11 @@ class Domain(dcs_object):
         else:
             ip_hash = self.Endpoint_Hash_IPv6
         ip_hash[vIP.ip_value] = endpoint
+        try:
+            dcslib.endpoint_index_vip_add(self.unique_id, vIP.inet_type,
+                                          vIP.ip_value, endpoint.vMac)
+        except Exception:
+            pass
         return
 
     def endpoint_vIP_del(self, vIP):
@@ -234,6 +375,10 @@ class Domain(dcs_object):
             del ip_hash[vIP.ip_value]
         except Exception:
             pass
+        try:
+            dcslib.endpoint_index_vip_del(self.unique_id, vIP.inet_type, vIP.ip_value)
+        except Exception:
+            pass
         return
 
     def tunnel_endpoint_add(self, tunnel_endpoint):
@@ -348,16 +493,12 @@ class Domain(dcs_object):
         self.valid = False
         #Unlink from DPS Clients
         DPSClientHost.Domain_Deleted_Locally(self)
-        #Unlink from Address_Resolution_Requests
-        try:
-            del DpsCollection.Address_Resolution_Requests[self.unique_id]
-        except Exception:
-            pass
         #Unlink self from DpsCollection
         try:
             del DpsCollection.Domain_Hash[self.unique_id]
         except Exception:
             pass
+        dcslib.vnid_cache_invalidate_all()
         #Delete all DVGs
         if fdelete:
             #Only delete dvg structures if the domain is deleted
@@ -425,6 +566,11 @@ class Domain(dcs_object):
         self.DPSClients_Hash_IPv6.clear()
         self.Policy_Hash_DVG[0].clear()
         self.Policy_Hash_DVG[1].clear()
+        #Remove from the native Endpoint Index
+        try:
+            dcslib.endpoint_index_domain_flush(self.unique_id)
+        except Exception:
+            pass
         #Destroy IP subnet list
         self.IP_Subnet_List.destroy()
         #Destroy Address Resolution
@@ -477,15 +623,18 @@ class Domain(dcs_object):
             break
         return ret_val
 
-    def ip_subnet_lookup(self, ip_value):
+    def ip_subnet_lookup(self, ip_value, ip_type = socket.AF_INET):
         '''
         Check if a given IP falls into a subnet in the list and get the subnet
+        with the longest prefix
         @param ip_value: IP Address
         @type ip_value: Integer
+        @param ip_type: socket.AF_INET or socket.AF_INET6
+        @type ip_type: Integer
         @return: status, subnet_ip, subnet_mask, subnet_mode, subnet_gateway
         @rtype: Integer, Integer, Integer, Integer, Integer
         '''
-        return self.IP_Subnet_List.lookup(ip_value)
+        return self.IP_Subnet_List.lookup(ip_value, ip_type)
 
     def ip_subnet_get(self, ip_value, mask_value):
         '''
@@ -566,7 +715,7 @@ class Domain(dcs_object):
         #log.warning('send_resolution_work: Enter\r')
         vIP_value = vIP_tuple[0]
         vIP_packed = vIP_tuple[1]
-        DpsCollection.global_lock.acquire()
+        self.lock_acquire()
         while True:
             if not self.valid:
                 break
@@ -575,22 +724,20 @@ class Domain(dcs_object):
             except Exception:
                 dvg_list = []
             #Send Address Resolution to all DVGS
-            #Drop Lock in between DVGs to allow other threads to run
-            DpsCollection.global_lock.release()
+            #Drop Lock in between DVGs to allow other threads in the Domain to run
+            self.lock_release()
             for dvg in dvg_list:
-                DpsCollection.global_lock.acquire()
+                self.lock_acquire()
                 try:
                     ret_val, subnet_ip, subnet_mask, subnet_mode, subnet_gateway = dvg.ip_subnet_lookup(vIP_value)
                     if ret_val == DOVEStatus.DOVE_STATUS_OK:
                         dvg.send_address_resolution(vIP_packed)
                 except Exception:
                     pass
-                DpsCollection.global_lock.release()
-            DpsCollection.global_lock.acquire()
-            #Store self in Global Timer
-            DpsCollection.Address_Resolution_Requests[self.unique_id] = self
+                self.lock_release()
+            self.lock_acquire()
             break
-        DpsCollection.global_lock.release()
+        self.lock_release()
         #log.warning('send_resolution_work: Exit\r')
         return
 
@@ -717,7 +864,7 @@ class Domain(dcs_object):
         '''
         if not self.active:
             return
-        DpsCollection.global_lock.acquire()
+        self.lock_acquire()
         #Create a set of dps_clients
         dps_clients = {}
         for dps_client in self.DPSClients_Hash_IPv4.values():
@@ -727,9 +874,50 @@ class Domain(dcs_object):
         for dps_client in dps_clients.keys():
             self.send_vm_migration_update_to(dps_client, endpoint, vnid, 0)
         dps_clients.clear()
-        DpsCollection.global_lock.release()
+        self.lock_release()
         return
 
+    def memory_footprint(self):
+        '''
+        Estimates the memory held by the Endpoints of this Domain. Only the
+        first memory_sample_max Endpoints are measured, the rest are
+        assumed to be the same size.
+        @return: (Endpoint Count, Bytes in Endpoints, Bytes in Hashes)
+        @rtype: (Integer, Integer, Integer)
+        '''
+        hashes = [self.Endpoint_Hash_MAC, self.Endpoint_Hash_IPv4, self.Endpoint_Hash_IPv6]
+        for dvg in self.DVG_Hash.values():
+            hashes.append(dvg.Endpoint_Hash_MAC)
+            hashes.append(dvg.Endpoint_Hash_IPv4)
+            hashes.append(dvg.Endpoint_Hash_IPv6)
+        tunnel_set = {}
+        for tunnel_hash in [self.Tunnel_Endpoints_Hash_IPv4, self.Tunnel_Endpoints_Hash_IPv6]:
+            for tunnel in tunnel_hash.values():
+                tunnel_set[tunnel] = True
+        for tunnel in tunnel_set.keys():
+            hashes.append(tunnel.Endpoint_Hash_MAC)
+        hash_bytes = 0
+        for ep_hash in hashes:
+            hash_bytes += sys.getsizeof(ep_hash)
+        endpoint_count = len(self.Endpoint_Hash_MAC)
+        sample_count = 0
+        sample_bytes = 0
+        for endpoint in self.Endpoint_Hash_MAC.itervalues():
+            if sample_count >= self.memory_sample_max:
+                break
+            sample_count += 1
+            sample_bytes += sys.getsizeof(endpoint) + sys.getsizeof(endpoint.vMac)
+            sample_bytes += sys.getsizeof(endpoint.vIP_set)
+            if endpoint.vIP_show is not None:
+                sample_bytes += sys.getsizeof(endpoint.vIP_show)
+            for vIP in endpoint.vIP_set.itervalues():
+                sample_bytes += sys.getsizeof(vIP) + sys.getsizeof(vIP.ip_value_packed)
+        if sample_count > 0:
+            endpoint_bytes = (sample_bytes * endpoint_count)/sample_count
+        else:
+            endpoint_bytes = 0
+        return (endpoint_count, endpoint_bytes, hash_bytes)
+
     def show(self, fdetails):
         '''
         Display Contents of a Domain
@@ -789,6 +977,11 @@ class Domain(dcs_object):
             print 'Endpoints: Total %s\r'%endpoint_count
             endpoint_ip = len(self.Endpoint_Hash_IPv4) + len(self.Endpoint_Hash_IPv6)
             print 'Endpoints: Total Number of vIP Addresses %s\r'%endpoint_ip
+        endpoint_count, endpoint_bytes, hash_bytes = self.memory_footprint()
+        if endpoint_count > 0:
+            print 'Endpoints: Memory %s KB (%s bytes per Endpoint), Hashes %s KB\r'%(endpoint_bytes/1024,
+                                                                                   endpoint_bytes/endpoint_count,
+                                                                                   hash_bytes/1024)
         #############################################################
         #Show Implicit Gateways.
         #############################################################
@@ -14,6 +14,7 @@ from logging import getLogger
 log = getLogger(__name__)
 
 import socket
+import random
 
 from object_collection import DpsCollection
 from object_collection import DpsClientType
@@ -33,6 +34,14 @@ class DVG(dcs_object):
     '''
     This represents the DVG/VNID Object in within a domain
     '''
+    #The number of Broadcast membership changes remembered to send DPS
+    #Clients with sequenced broadcast lists only what changed
+    broadcast_log_max = 256
+    #The sub_types of Broadcast Lists: dps_bcast_list_type in dps_client_common.h
+    bcast_list_full = 0
+    bcast_list_sequenced = 1
+    #The client types whose Tunnels make up the Gateway Lists
+    gateway_types = (DpsClientType.external_gateway, DpsClientType.vlan_gateway)
 
     def __init__(self, domain, dvg_id):
         '''
@@ -59,6 +68,28 @@ class DVG(dcs_object):
         self.Tunnel_Endpoints_Hash_IPv6 = {}
         for client_type in DpsClientType.types.keys():
             self.Tunnel_Endpoints_Hash_IPv6[client_type] = {}
+        #Broadcast membership of this DVG/VNID, maintained as the Tunnel
+        #Endpoints Hashes change. Each IP address maps to the number of
+        #client types it is registered under.
+        self.Broadcast_IPv4 = {}
+        self.Broadcast_IPv6 = {}
+        #DPS Clients hosting the Tunnels, mapped to the number of Tunnel IPs
+        self.Broadcast_DPS_Clients = {}
+        #Bumped every time the Broadcast membership changes. This is also the
+        #sequence number of the sequenced broadcast lists, so it starts at a
+        #random value that a DPS Client is unlikely to hold for this VNID from
+        #another DCS node, never 0.
+        self.Broadcast_Version = random.randint(1, 0x3fffffff)
+        #The membership changes after Broadcast_Log_Base, in order. Each is
+        #(version after the change, inet_type, ip_value, True if added)
+        self.Broadcast_Log = []
+        self.Broadcast_Log_Base = self.Broadcast_Version
+        #{base version: packed change} for the current Broadcast Version
+        self.Broadcast_Deltas = {}
+        #(version, packed table) last encoded by broadcast_payload_get
+        self.Broadcast_Payload = (-1, '')
+        #The Broadcast Version last sent to each DPS Client
+        self.Broadcast_Sent = {}
         #List of External Gateway IP Addresses for this Domain
         self.ExternalGatewayIPListv4 = IPAddressList(socket.AF_INET)
         self.ExternalGatewayIPListv6 = IPAddressList(socket.AF_INET6)
@@ -79,6 +110,7 @@ class DVG(dcs_object):
         Domain.dvg_add(domain, self)
         #Add to VNID Collection
         DpsCollection.VNID_Hash[dvg_id] = domain.unique_id
+        dcslib.vnid_cache_invalidate(dvg_id)
 
     def endpoint_add(self, endpoint):
         '''
@@ -142,6 +174,236 @@ class DVG(dcs_object):
             pass
         return
 
+    def tunnel_hash_set(self, client_type, inet_type, ip_value, tunnel_endpoint):
+        '''
+        Sets the Tunnel Endpoint of a Physical IP Address in the Tunnel
+        Endpoints Hash and updates the Broadcast membership.
+        @param client_type: The Type of Client: should be in DpsClientType.types
+        @type client_type: Integer
+        @param inet_type: AF_INET or AF_INET6
+        @type inet_type: Integer
+        @param ip_value: The IP address value
+        @type ip_value: Integer or String
+        @param tunnel_endpoint: The Tunnel Endpoint
+        @type tunnel_endpoint: TunnelEndpoint Object
+        @return: The Tunnel Endpoint that held the IP before, None if none did
+        @rtype: TunnelEndpoint Object
+        '''
+        if inet_type == socket.AF_INET:
+            ip_hash = self.Tunnel_Endpoints_Hash_IPv4[client_type]
+            broadcast_hash = self.Broadcast_IPv4
+        else:
+            ip_hash = self.Tunnel_Endpoints_Hash_IPv6[client_type]
+            broadcast_hash = self.Broadcast_IPv6
+        try:
+            tunnel = ip_hash[ip_value]
+        except Exception:
+            tunnel = None
+        if tunnel == tunnel_endpoint:
+            return tunnel
+        ip_hash[ip_value] = tunnel_endpoint
+        if client_type in self.gateway_types:
+            self.domain.gateway_version_bump()
+        if tunnel is None:
+            try:
+                broadcast_hash[ip_value] += 1
+            except Exception:
+                broadcast_hash[ip_value] = 1
+                self.broadcast_version_bump(inet_type, ip_value, True)
+        else:
+            self.broadcast_client_release(tunnel.dps_client)
+        self.broadcast_client_hold(tunnel_endpoint.dps_client)
+        return tunnel
+
+    def tunnel_hash_del(self, client_type, inet_type, ip_value):
+        '''
+        Removes a Physical IP Address from the Tunnel Endpoints Hash and
+        updates the Broadcast membership.
+        @param client_type: The Type of Client: should be in DpsClientType.types
+        @type client_type: Integer
+        @param inet_type: AF_INET or AF_INET6
+        @type inet_type: Integer
+        @param ip_value: The IP address value
+        @type ip_value: Integer or String
+        @raise KeyError: If the IP address is not in the Hash
+        '''
+        if inet_type == socket.AF_INET:
+            ip_hash = self.Tunnel_Endpoints_Hash_IPv4[client_type]
+            broadcast_hash = self.Broadcast_IPv4
+        else:
+            ip_hash = self.Tunnel_Endpoints_Hash_IPv6[client_type]
+            broadcast_hash = self.Broadcast_IPv6
+        tunnel = ip_hash[ip_value]
+        del ip_hash[ip_value]
+        if client_type in self.gateway_types:
+            self.domain.gateway_version_bump()
+        try:
+            broadcast_hash[ip_value] -= 1
+            if broadcast_hash[ip_value] <= 0:
+                del broadcast_hash[ip_value]
+                self.broadcast_version_bump(inet_type, ip_value, False)
+        except Exception:
+            pass
+        self.broadcast_client_release(tunnel.dps_client)
+        return
+
+    def broadcast_version_bump(self, inet_type, ip_value, fadd):
+        '''
+        Moves the Broadcast membership to the next version and remembers
+        the change for sequenced broadcast lists.
+        @param inet_type: AF_INET or AF_INET6
+        @type inet_type: Integer
+        @param ip_value: The IP address value, None if the change can't be
+                         expressed as a single IP (all DPS Clients get the
+                         whole list)
+        @type ip_value: Integer or String
+        @param fadd: True if the IP was added, False if it was removed
+        @type fadd: Boolean
+        '''
+        self.Broadcast_Version += 1
+        if self.Broadcast_Version > 0x7fffffff:
+            self.Broadcast_Version = 1
+        self.Broadcast_Deltas.clear()
+        if ip_value is None:
+            del self.Broadcast_Log[:]
+            self.Broadcast_Log_Base = self.Broadcast_Version
+            return
+        self.Broadcast_Log.append((self.Broadcast_Version, inet_type, ip_value, fadd))
+        if len(self.Broadcast_Log) > self.broadcast_log_max:
+            self.Broadcast_Log_Base = self.Broadcast_Log[0][0]
+            del self.Broadcast_Log[0]
+        return
+
+    def broadcast_client_hold(self, dps_client):
+        '''
+        Counts a Tunnel IP hosted by a DPS Client in this DVG/VNID
+        @param dps_client: DPSClient
+        @type dps_client: DPSClient
+        '''
+        try:
+            self.Broadcast_DPS_Clients[dps_client] += 1
+        except Exception:
+            self.Broadcast_DPS_Clients[dps_client] = 1
+        return
+
+    def broadcast_client_release(self, dps_client):
+        '''
+        Releases a Tunnel IP hosted by a DPS Client in this DVG/VNID
+        @param dps_client: DPSClient
+        @type dps_client: DPSClient
+        '''
+        try:
+            self.Broadcast_DPS_Clients[dps_client] -= 1
+            if self.Broadcast_DPS_Clients[dps_client] <= 0:
+                del self.Broadcast_DPS_Clients[dps_client]
+                try:
+                    del self.Broadcast_Sent[dps_client]
+                except Exception:
+                    pass
+        except Exception:
+            pass
+        return
+
+    def broadcast_payload_get(self):
+        '''
+        This routine must be called with the Domain lock held.
+        This routine returns the Broadcast Table packed for the DPS Client
+        Server Protocol. The table is only packed again if the Broadcast
+        membership changed since it was last packed.
+        @return: (version, packed table)
+        @rtype: (Integer, String)
+        '''
+        if self.Broadcast_Payload[0] != self.Broadcast_Version:
+            packed = dcslib.broadcast_table_pack(self.Broadcast_IPv4.keys(),
+                                                 self.Broadcast_IPv6.keys())
+            if packed is None:
+                raise Exception('Cannot pack Broadcast Table of VNID %s'%self.unique_id)
+            self.Broadcast_Payload = (self.Broadcast_Version, packed)
+        return self.Broadcast_Payload
+
+    def broadcast_delta_get(self, base):
+        '''
+        This routine must be called with the Domain lock held.
+        This routine returns what changed in the Broadcast Table since the
+        base version, packed for the DPS Client Server Protocol. If the
+        base version is no longer remembered the whole Table is returned
+        as a change from version 0.
+        @param base: The Broadcast Version the DPS Client has, 0 if none
+        @type base: Integer
+        @return: (version, packed change)
+        @rtype: (Integer, String)
+        '''
+        version = self.Broadcast_Version
+        try:
+            return (version, self.Broadcast_Deltas[base])
+        except Exception:
+            pass
+        packed = None
+        start = -1
+        if base == 0:
+            pass
+        elif base == version:
+            start = len(self.Broadcast_Log)
+        elif base == self.Broadcast_Log_Base:
+            start = 0
+        else:
+            for i in range(len(self.Broadcast_Log)):
+                if self.Broadcast_Log[i][0] == base:
+                    start = i + 1
+                    break
+        if start >= 0:
+            #Net change of every IP touched since the base version: Only
+            #the first change to an IP tells whether it was a member then.
+            was_member = {}
+            for i in range(start, len(self.Broadcast_Log)):
+                _version, inet_type, ip_value, fadd = self.Broadcast_Log[i]
+                key = (inet_type, ip_value)
+                if not was_member.has_key(key):
+                    was_member[key] = not fadd
+            ipv4_add = []
+            ipv4_del = []
+            ipv6_add = []
+            ipv6_del = []
+            for key, member in was_member.items():
+                inet_type, ip_value = key
+                if inet_type == socket.AF_INET:
+                    is_member = self.Broadcast_IPv4.has_key(ip_value)
+                    add_list = ipv4_add
+                    del_list = ipv4_del
+                else:
+                    is_member = self.Broadcast_IPv6.has_key(ip_value)
+                    add_list = ipv6_add
+                    del_list = ipv6_del
+                if is_member and not member:
+                    add_list.append(ip_value)
+                elif member and not is_member:
+                    del_list.append(ip_value)
+            packed = dcslib.broadcast_delta_pack(version, base,
+                                                 ipv4_add, ipv4_del,
+                                                 ipv6_add, ipv6_del)
+        if packed is None:
+            #Send the whole list
+            packed = dcslib.broadcast_delta_pack(version, 0,
+                                                 self.Broadcast_IPv4.keys(), [],
+                                                 self.Broadcast_IPv6.keys(), [])
+            if packed is None:
+                raise Exception('Cannot pack Broadcast Change of VNID %s'%self.unique_id)
+        self.Broadcast_Deltas[base] = packed
+        return (version, packed)
+
+    def broadcast_sent_reset(self, dps_client):
+        '''
+        Forgets what Broadcast Version a DPS Client was sent, so that the
+        next Broadcast Table it is sent is the whole Table.
+        @param dps_client: DPSClient
+        @type dps_client: DPSClient
+        '''
+        try:
+            del self.Broadcast_Sent[dps_client]
+        except Exception:
+            pass
+        return
+
     def tunnel_endpoint_add(self, fregister, tunnel_endpoint, client_type, transaction_type):
         '''
         Adds a Tunnel Endpoint to the DVG/VNID Collection
@@ -160,31 +422,30 @@ class DVG(dcs_object):
             except Exception:
                 break
             new_tunnel = fregister
-            for ip_value in tunnel_endpoint.ip_listv4.ip_list:
-                ip_hash = self.Tunnel_Endpoints_Hash_IPv4[client_type]
+            if fregister:
+                #An explicit register may come from a restarted DPS Client,
+                #so it must be sent the Broadcast Table again
                 try:
-                    tunnel = ip_hash[ip_value]
-                    if tunnel != tunnel_endpoint:
-                        IP = IPAddressLocation(socket.AF_INET, ip_value, 0)
-                        message = 'DVG.tunnel_endpoint_add. Tunnel IP %s migrated without informing DCS Server'%IP.show()
-                        dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
-                        ip_hash[ip_value] = tunnel_endpoint
-                        new_tunnel = True
+                    del self.Broadcast_Sent[tunnel_endpoint.dps_client]
                 except Exception:
-                    ip_hash[ip_value] = tunnel_endpoint
+                    pass
+            for ip_value in tunnel_endpoint.ip_listv4.ip_list:
+                tunnel = self.tunnel_hash_set(client_type, socket.AF_INET, ip_value, tunnel_endpoint)
+                if tunnel is None:
+                    new_tunnel = True
+                elif tunnel != tunnel_endpoint:
+                    IP = IPAddressLocation(socket.AF_INET, ip_value, 0)
+                    message = 'DVG.tunnel_endpoint_add. Tunnel IP %s migrated without informing DCS Server'%IP.show()
+                    dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
                     new_tunnel = True
             for ip_value in tunnel_endpoint.ip_listv6.ip_list:
-                ip_hash = self.Tunnel_Endpoints_Hash_IPv6[client_type]
-                try:
-                    tunnel = ip_hash[ip_value]
-                    if tunnel != tunnel_endpoint:
-                        IP = IPAddressLocation(socket.AF_INET6, ip_value, 0)
-                        message = 'DVG.tunnel_endpoint_add. Tunnel IP %s migrated without informing DCS Server'%IP.show()
-                        dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
-                        ip_hash[ip_value] = tunnel_endpoint
-                        new_tunnel = True
-                except Exception:
-                    ip_hash[ip_value] = tunnel_endpoint
+                tunnel = self.tunnel_hash_set(client_type, socket.AF_INET6, ip_value, tunnel_endpoint)
+                if tunnel is None:
+                    new_tunnel = True
+                elif tunnel != tunnel_endpoint:
+                    IP = IPAddressLocation(socket.AF_INET6, ip_value, 0)
+                    message = 'DVG.tunnel_endpoint_add. Tunnel IP %s migrated without informing DCS Server'%IP.show()
+                    dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
                     new_tunnel = True
             if (new_tunnel and (transaction_type == DpsTransactionType.normal) and 
                 self.domain.active and (self.unique_id != DpsCollection.Shared_VNID)):
@@ -212,9 +473,8 @@ class DVG(dcs_object):
                 break
             tunnel_deleted = False
             for ip_value in tunnel_endpoint.ip_listv4.ip_list:
-                ip_hash = self.Tunnel_Endpoints_Hash_IPv4[client_type]
                 try:
-                    del ip_hash[ip_value]
+                    self.tunnel_hash_del(client_type, socket.AF_INET, ip_value)
                     tunnel_deleted = True
                 except Exception:
                     pass
@@ -224,9 +484,8 @@ class DVG(dcs_object):
                     except Exception:
                         pass
             for ip_value in tunnel_endpoint.ip_listv6.ip_list:
-                ip_hash = self.Tunnel_Endpoints_Hash_IPv4[client_type]
                 try:
-                    del ip_hash[ip_value]
+                    self.tunnel_hash_del(client_type, socket.AF_INET6, ip_value)
                     tunnel_deleted = True
                 except Exception:
                     pass
@@ -270,23 +529,23 @@ class DVG(dcs_object):
                 client_type_value = DpsClientType.types[client_type]
             except Exception:
                 break
-            if inet_type == socket.AF_INET:
-                ip_hash = self.Tunnel_Endpoints_Hash_IPv4[client_type]
-            else:
-                ip_hash = self.Tunnel_Endpoints_Hash_IPv6[client_type]
             new_tunnel = fregister
-            try:
-                tunnel = ip_hash[ip_value]
-                if tunnel != tunnel_endpoint:
-                    IP = IPAddressLocation(socket.AF_INET, ip_value, 0)
-                    message = 'tunnel_endpoint_add_IP. Tunnel IP %s migrated without informing DCS Server'%(IP.show_ip())
-                    dcslib.dps_data_write_log(DpsLogLevels.NOTICE, message)
-                    ip_hash[ip_value] = tunnel_endpoint
-                    new_tunnel = True
-            except Exception:
-                ip_hash[ip_value] = tunnel_endpoint
+            if fregister:
+                #An explicit register may come from a restarted DPS Client,
+                #so it must be sent the Broadcast Table again
+                try:
+                    del self.Broadcast_Sent[tunnel_endpoint.dps_client]
+                except Exception:
+                    pass
+            tunnel = self.tunnel_hash_set(client_type, inet_type, ip_value, tunnel_endpoint)
+            if tunnel is None:
                 mass_transfer_needed = True
                 new_tunnel = True
+            elif tunnel != tunnel_endpoint:
+                IP = IPAddressLocation(inet_type, ip_value, 0)
+                message = 'tunnel_endpoint_add_IP. Tunnel IP %s migrated without informing DCS Server'%(IP.show_ip())
+                dcslib.dps_data_write_log(DpsLogLevels.NOTICE, message)
+                new_tunnel = True
             if (new_tunnel and (transaction_type == DpsTransactionType.normal) and 
                 self.domain.active and (self.unique_id != DpsCollection.Shared_VNID)):
                 DpsCollection.VNID_Broadcast_Updates[self.unique_id] = self
@@ -321,14 +580,7 @@ class DVG(dcs_object):
         '''
         while True:
             try:
-                if inet_type == socket.AF_INET:
-                    ip_hash = self.Tunnel_Endpoints_Hash_IPv4[client_type]
-                else:
-                    ip_hash = self.Tunnel_Endpoints_Hash_IPv6[client_type]
-            except Exception:
-                break
-            try:
-                del ip_hash[ip_value]
+                self.tunnel_hash_del(client_type, inet_type, ip_value)
             except Exception:
                 break
             try:
@@ -365,6 +617,7 @@ class DVG(dcs_object):
         @type policy: Policy
         '''
         self.Policy_Source[policy.traffic_type][dst_dvg_id] = policy
+        self.domain.gateway_version_bump()
         if self.domain.active:
             DpsCollection.policy_update_queue.put((self, policy.traffic_type))
 
@@ -393,6 +646,7 @@ class DVG(dcs_object):
             del self.Policy_Source[traffic_type][dst_dvg_id]
         except Exception:
             pass
+        self.domain.gateway_version_bump()
         if self.domain.active:
             DpsCollection.policy_update_queue.put((self, traffic_type))
 
@@ -530,15 +784,18 @@ class DVG(dcs_object):
             break
         return ret_val
 
-    def ip_subnet_lookup(self, ip_value):
+    def ip_subnet_lookup(self, ip_value, ip_type = socket.AF_INET):
         '''
         Check if a given IP falls into a subnet in the list and get the subnet
+        with the longest prefix
         @param ip_value: IP Address
         @type ip_value: Integer
+        @param ip_type: socket.AF_INET or socket.AF_INET6
+        @type ip_type: Integer
         @return: status, subnet_ip, subnet_mask, subnet_mode
         @rtype: Integer, Integer, Integer, Integer
         '''
-        return self.IP_Subnet_List.lookup(ip_value)
+        return self.IP_Subnet_List.lookup(ip_value, ip_type)
 
     def ip_subnet_get(self, ip_value, mask_value):
         '''
@@ -635,7 +892,7 @@ class DVG(dcs_object):
         '''
         if not self.valid:
             return
-        DpsCollection.global_lock.acquire()
+        self.domain.lock_acquire()
         #Create a set of dps_clients
         dps_clients = {}
         for client_type in self.Tunnel_Endpoints_Hash_IPv4.keys():
@@ -664,7 +921,7 @@ class DVG(dcs_object):
             #Send updates to all Multicast Senders in this DVG
             self.domain.Multicast.policy_update(self)
         dps_clients.clear()
-        DpsCollection.global_lock.release()
+        self.domain.lock_release()
         return
 
     def send_gateways_to(self, dps_client, gwy_type, v4_gwys, v6_gwys):
@@ -689,7 +946,8 @@ class DVG(dcs_object):
                                        query_id, #Query ID
                                        gwy_type,
                                        v4_gwys,
-                                       v6_gwys
+                                       v6_gwys,
+                                       self.domain.Gateway_Version
                                        )
         if ret_val != 0 and len(DpsCollection.Gateway_Updates_To) < DpsCollection.Max_Pending_Queue_Size:
             #Insert into a retry queue to be tried in the next iteration
@@ -949,7 +1207,7 @@ class DVG(dcs_object):
         #Step 1: Determine all source DVGs/VNIDs allowed to send to this VNID
         if not self.valid:
             return
-        DpsCollection.global_lock.acquire()
+        self.domain.lock_acquire()
         #Needed for Multicast Control Traffic
         src_vnids = self.policy_allowed_vnids(False, 1)
         for src_vnid in src_vnids:
@@ -959,7 +1217,7 @@ class DVG(dcs_object):
                 continue
             gateways_v4, gateways_v6 = src_dvg.communication_gateway_list(True, gwy_type)
             src_dvg.send_gateway_update(gwy_type, gateways_v4, gateways_v6)
-        DpsCollection.global_lock.release()
+        self.domain.lock_release()
         return
 
     def send_broadcast_table_to(self, dps_client):
@@ -971,79 +1229,51 @@ class DVG(dcs_object):
         '''
         if not self.valid or not self.domain.active:
             return
-        ipv4_set = {}
-        for client_type in self.Tunnel_Endpoints_Hash_IPv4.keys():
-            #ipv4_list += self.Tunnel_Endpoints_Hash_IPv4[client_type].keys()
-            for ipv4 in self.Tunnel_Endpoints_Hash_IPv4[client_type].keys():
-                ipv4_set[ipv4] = True
-        ipv4_list = ipv4_set.keys()
-        ipv6_set = {}
-        for client_type in self.Tunnel_Endpoints_Hash_IPv6.keys():
-            #ipv6_list += self.Tunnel_Endpoints_Hash_IPv6[client_type].keys()
-            for ipv6 in self.Tunnel_Endpoints_Hash_IPv6[client_type].keys():
-                ipv6_set[ipv6] = True
-        ipv6_list = ipv6_set.keys()
+        if dps_client.broadcast_sequenced:
+            sub_type = self.bcast_list_sequenced
+            version, packed = self.broadcast_delta_get(self.Broadcast_Sent.get(dps_client, 0))
+        else:
+            sub_type = self.bcast_list_full
+            version, packed = self.broadcast_payload_get()
         query_id = DpsCollection.generate_query_id()
         ret_val = dcslib.send_broadcast_table(dps_client.location.ip_value_packed, #DPS Client Location IP
                                               dps_client.location.port, #DPS Client Port
                                               self.unique_id,#VNID ID
                                               query_id, #Query ID
-                                              ipv4_list,
-                                              ipv6_list
+                                              packed,
+                                              sub_type,
+                                              version
                                               )
-        if ((ret_val != 0) and 
-            (len(DpsCollection.VNID_Broadcast_Updates_To) < DpsCollection.Max_Pending_Queue_Size)):
-            #Insert into a retry queue to be tried in the next iteration
-            key = '%s:%s'%(self.unique_id, dps_client.location.ip_value)
-            DpsCollection.VNID_Broadcast_Updates_To[key] = (self, dps_client)
+        if ret_val == 0:
+            if self.Broadcast_DPS_Clients.has_key(dps_client):
+                self.Broadcast_Sent[dps_client] = version
+        else:
+            try:
+                del self.Broadcast_Sent[dps_client]
+            except Exception:
+                pass
+            if len(DpsCollection.VNID_Broadcast_Updates_To) < DpsCollection.Max_Pending_Queue_Size:
+                #Insert into a retry queue to be tried in the next iteration
+                key = '%s:%s'%(self.unique_id, dps_client.location.ip_value)
+                DpsCollection.VNID_Broadcast_Updates_To[key] = (self, dps_client)
         return
 
     def send_broadcast_table_update(self):
         '''
         This routine must be called with global lock held.
         This routine sends the Broadcast Table list to every DPS Client in that
-        VNID.
+        VNID which hasn't been sent the current version of the table.
         '''
         if not self.valid or not self.domain.active:
             return
-        #Send to all IPv4 DPS Clients
-        ipv4_set = {}
-        for client_type in self.Tunnel_Endpoints_Hash_IPv4.keys():
-            #ipv4_list += self.Tunnel_Endpoints_Hash_IPv4[client_type].keys()
-            for ipv4 in self.Tunnel_Endpoints_Hash_IPv4[client_type].keys():
-                ipv4_set[ipv4] = True
-        ipv4_list = ipv4_set.keys()
-        ipv6_set = {}
-        for client_type in self.Tunnel_Endpoints_Hash_IPv6.keys():
-            #ipv6_list += self.Tunnel_Endpoints_Hash_IPv6[client_type].keys()
-            for ipv6 in self.Tunnel_Endpoints_Hash_IPv6[client_type].keys():
-                ipv6_set[ipv6] = True
-        ipv6_list = ipv6_set.keys()
-        #Create a set of dps_clients
-        dps_clients = {}
-        for client_type in self.Tunnel_Endpoints_Hash_IPv4.keys():
-            for tunnel in self.Tunnel_Endpoints_Hash_IPv4[client_type].values():
-                dps_client = tunnel.dps_client
-                dps_clients[dps_client] = True
-        for client_type in self.Tunnel_Endpoints_Hash_IPv6.keys():
-            for tunnel in self.Tunnel_Endpoints_Hash_IPv6[client_type].values():
-                dps_client = tunnel.dps_client
-                dps_clients[dps_client] = True
-        for dps_client in dps_clients.keys():
-            query_id = DpsCollection.generate_query_id()
-            ret_val = dcslib.send_broadcast_table(dps_client.location.ip_value_packed, #DPS Client Location IP
-                                                  dps_client.location.port, #DPS Client Port
-                                                  self.unique_id,#VNID ID
-                                                  query_id, #Query ID
-                                                  ipv4_list,
-                                                  ipv6_list
-                                                  )
-            if ((ret_val != 0) and 
-                (len(DpsCollection.VNID_Broadcast_Updates_To) < DpsCollection.Max_Pending_Queue_Size)):
-                #Insert into a retry queue to be tried in the next iteration
-                key = '%s:%s'%(self.unique_id, dps_client.location.ip_value)
-                DpsCollection.VNID_Broadcast_Updates_To[key] = (self, dps_client)
-        dps_clients.clear()
+        version = self.Broadcast_Version
+        for dps_client in self.Broadcast_DPS_Clients.keys():
+            try:
+                if self.Broadcast_Sent[dps_client] == version:
+                    continue
+            except Exception:
+                pass
+            self.send_broadcast_table_to(dps_client)
         return
 
     def delete(self):
@@ -1120,6 +1350,7 @@ class DVG(dcs_object):
             del DpsCollection.VNID_Hash[self.unique_id]
         except Exception:
             pass
+        dcslib.vnid_cache_invalidate(self.unique_id)
         #Delete all policies
         for policy_key in self.Policy_Destination[0].keys():
             try:
@@ -1191,6 +1422,11 @@ class DVG(dcs_object):
                 except Exception:
                     pass
                 self.Tunnel_Endpoints_Hash_IPv6[client_type].clear()
+        self.Broadcast_IPv4.clear()
+        self.Broadcast_IPv6.clear()
+        self.Broadcast_DPS_Clients.clear()
+        self.Broadcast_Sent.clear()
+        self.broadcast_version_bump(socket.AF_INET, None, False)
         #if self.IP_Subnet_List != self.domain.IP_Subnet_List:
         #    self.IP_Subnet_List.destroy()
         self.IP_Subnet_List.destroy()
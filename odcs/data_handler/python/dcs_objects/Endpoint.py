@@ -24,11 +24,16 @@ from dcs_objects.TunnelEndpoint import TunnelEndpoint
 from dcs_objects.IPAddressLocation import IPAddressLocation
 from object_collection import IPSUBNETMode
 
-class Endpoint:
+class Endpoint(object):
     '''
     This represents an Endpoint Object in the DOVE Environment
     '''
 
+    #A DCS node holds millions of Endpoints, don't give each one a __dict__
+    __slots__ = ('domain', 'dvg', 'vnid', 'client_type', 'vMac',
+                 'tunnel_endpoint', 'vIP_set', 'vIP_show', 'version',
+                 'valid', 'in_migration')
+
     #######################################################################
     #Endpoint Update Codes based on the following structure:
     #         dps_resp_status_t
@@ -52,6 +57,10 @@ class Endpoint:
 
     version_start = 0
 
+    #The number of Protocol Timer ticks an Endpoint deleted from its
+    #tunnel waits for another tunnel to claim it
+    expiration_ticks = 4
+
     def __init__(self, domain, dvg, vnid, client_type, transaction_type, 
                  tunnel_endpoint, vMac, vIP, version):
         '''
@@ -85,10 +94,11 @@ class Endpoint:
         self.vMac = vMac
         self.tunnel_endpoint = tunnel_endpoint
         self.vIP_set = {}
-        self.vIP_set_show = {}
+        #The vIPs to show only once there are too many to show all of
+        #vIP_set, None otherwise. Use vIP_set_show.
+        self.vIP_show = None
         if vIP is not None:
             self.vIP_set[vIP.ip_value] = vIP
-            self.vIP_set_show[vIP.ip_value] = vIP
         #self.version = self.version_start
         self.version = version
         self.valid = True
@@ -106,7 +116,7 @@ class Endpoint:
         DVG.endpoint_add(dvg, self)
         #log.info('__init__: Added to DVG\r')
         #self.show(None)
-        DpsCollection.Endpoints_Count += 1
+        DpsCollection.endpoints_count_update(1)
 
     def vIP_add(self, vIP):
         '''
@@ -118,8 +128,14 @@ class Endpoint:
             self.vIP_set[vIP.ip_value] = vIP
             Domain.endpoint_vIP_add(self.domain, self, vIP)
             DVG.endpoint_vIP_add(self.dvg, self, vIP)
-            if len(self.vIP_set) < DpsCollection.Endpoints_vIP_Max:
-                self.vIP_set_show[vIP.ip_value] = vIP
+            if self.vIP_show is not None:
+                if len(self.vIP_set) < DpsCollection.Endpoints_vIP_Max:
+                    self.vIP_show[vIP.ip_value] = vIP
+            elif len(self.vIP_set) >= DpsCollection.Endpoints_vIP_Max:
+                #Only show the vIPs there were before
+                self.vIP_show = self.vIP_set.copy()
+                del self.vIP_show[vIP.ip_value]
+            Domain.endpoint_index_publish(self.domain, self)
 
     def vIP_del(self, vIP):
         '''
@@ -132,9 +148,34 @@ class Endpoint:
                 del self.vIP_set[vIP.ip_value]
                 Domain.endpoint_vIP_del(self.domain, vIP)
                 DVG.endpoint_vIP_del(self.dvg, vIP)
-                del self.vIP_set_show[vIP.ip_value]
+                if self.vIP_show is not None:
+                    del self.vIP_show[vIP.ip_value]
+                    if len(self.vIP_show) == len(self.vIP_set):
+                        self.vIP_show = None
             except Exception:
                 pass
+            Domain.endpoint_index_publish(self.domain, self)
+
+    def vIP_set_show_get(self):
+        '''
+        The virtual IP addresses to show
+        @return: {ip_value: IPAddressLocation}
+        @rtype: Dictionary
+        '''
+        if self.vIP_show is None:
+            return self.vIP_set
+        return self.vIP_show
+
+    vIP_set_show = property(vIP_set_show_get)
+
+    def vIP_show_clear(self):
+        '''
+        Stop showing any of the current virtual IP addresses
+        '''
+        if len(self.vIP_set) > 0:
+            self.vIP_show = {}
+        else:
+            self.vIP_show = None
 
     def vIP_delete_all(self):
         '''
@@ -186,7 +227,7 @@ class Endpoint:
                 #Change in VNIDs. Clear all IPs
                 DVG.endpoint_del(self.dvg, self)
                 self.vIP_delete_all()
-                self.vIP_set_show.clear()
+                self.vIP_show_clear()
         #######################################################################
         #Add to new values
         #######################################################################
@@ -197,6 +238,7 @@ class Endpoint:
         self.client_type = client_type
         self.in_migration = False
         TunnelEndpoint.endpoint_add(self.tunnel_endpoint, self, transaction_type)
+        Domain.endpoint_index_publish(self.domain, self)
         return
 
     def delete(self):
@@ -206,6 +248,7 @@ class Endpoint:
         if not self.valid:
             return
         self.valid = False
+        DpsCollection.Timer_Wheel.stop(self)
         #Remove from Conflict Detection List
         self.domain.ConflictDetection.endpoint_delete(self)
         #Remove from DPS Client List
@@ -216,8 +259,8 @@ class Endpoint:
         DVG.endpoint_del(self.dvg, self)
         #Remove vIPs
         self.vIP_set.clear()
-        self.vIP_set_show.clear()
-        DpsCollection.Endpoints_Count -= 1
+        self.vIP_show = None
+        DpsCollection.endpoints_count_update(-1)
         return
 
     def update_del(self, vIP):
@@ -231,19 +274,25 @@ class Endpoint:
         self.vIP_add(vIP)
         #Mark self type as In Migration State
         self.in_migration = True
-        if len(DpsCollection.Endpoint_Expiration_Timer_Queue) < DpsCollection.Max_Endpoint_Timer_Queue_Length:
-            #Put on the global expiration timer list
-            #Remove from Tunnel since it could be a followed by migration. 
-            #But keep a reference to the old tunnel till a new tunnel claims it.
-            #Even if the old tunnel is removed this reference will keep the tunnel 
-            #object around.
-            #THIS IS A HACK that keeps endpoint.tunnel_endpoint a valid entity.
-            #Otherwise we would have to have the following checks every
-            #if endpoint.tunnel_endpoint != None: <---- TOO MANY PLACES!!!
-            TunnelEndpoint.endpoint_del(self.tunnel_endpoint, self)
-            DpsCollection.Endpoint_Expiration_Timer_Queue[self] = 3
-        else:
-            self.delete()
+        #Withdraw from the native Endpoint Index
+        Domain.endpoint_index_publish(self.domain, self)
+        #Put on the global expiration timer list
+        #Remove from Tunnel since it could be a followed by migration. 
+        #But keep a reference to the old tunnel till a new tunnel claims it.
+        #Even if the old tunnel is removed this reference will keep the tunnel 
+        #object around.
+        #THIS IS A HACK that keeps endpoint.tunnel_endpoint a valid entity.
+        #Otherwise we would have to have the following checks every
+        #if endpoint.tunnel_endpoint != None: <---- TOO MANY PLACES!!!
+        TunnelEndpoint.endpoint_del(self.tunnel_endpoint, self)
+        DpsCollection.Timer_Wheel.start(self, self.expiration_ticks)
+        return
+
+    def timer_expire(self):
+        '''
+        No tunnel claimed the Endpoint since it was deleted from its tunnel
+        '''
+        self.delete()
         return
 
     update_function_table = {op_update_add: vIP_add,
@@ -280,16 +329,13 @@ class Endpoint:
         self.vnid = vnid
         #Since we got an update on this endpoint from an entity, 
         #we can remove from Endpoint Expiration Timer List
-        try:
-            del DpsCollection.Endpoint_Expiration_Timer_Queue[self]
-        except Exception:
-            pass
+        DpsCollection.Timer_Wheel.stop(self)
         if self.dvg != dvg:
             #Remove self from old DVG
             DVG.endpoint_del(self.dvg, self)
             #Remove all old vIPs
             self.vIP_delete_all()
-            self.vIP_set_show.clear()
+            self.vIP_show_clear()
             self.dvg = dvg
             DVG.endpoint_add(self.dvg, self)
         if transaction_type == DpsTransactionType.mass_transfer:
@@ -310,6 +356,8 @@ class Endpoint:
         except Exception:
             #log.warning('update: operation %s not supported\r', operation)
             pass
+        #Version and DVG may have changed
+        Domain.endpoint_index_publish(self.domain, self)
         return
 
     def show(self):
@@ -15,13 +15,16 @@ log = getLogger(__name__)
 import struct
 import socket
 
-class IPAddressLocation:
+class IPAddressLocation(object):
     '''
     Represents an IP Address and a Port i.e. a Service Endpoint. In some cases
     the port may be non-existent in which case this structure just 
     represents an IP Address
     '''
 
+    #Every vIP of every Endpoint is one of these
+    __slots__ = ('inet_type', 'ip_value', 'mode', 'ip_value_packed', 'port', 'fValid')
+
     #Represents the format for the IPv4 and IPv6 addresses
     #IPv6 is represented as a character string of 16 bytes
     #IPv4 is represented as an Integer
@@ -26,7 +26,7 @@ class IPSubnet:
     '''
     Represents a SUBNET in PYTHON
     '''
-    def __init__(self, ip_value, mask_value, ip_gateway, mode):
+    def __init__(self, ip_value, mask_value, ip_gateway, mode, ip_type = socket.AF_INET):
         '''
         @param ip_value: IP Address of Subnet
         @type ip_value: Integer
@@ -36,7 +36,10 @@ class IPSubnet:
         @type ip_gateway: Integer
         @param mode: Mode of Subnet
         @type mode: Integer (0 = Dedicated, 1 = Shared)
+        @param ip_type: socket.AF_INET or socket.AF_INET6
+        @type ip_type: Integer
         '''
+        self.ip_type = ip_type
         self.ip_value = ip_value
         self.mask_value = mask_value
         self.ip_gateway = ip_gateway
@@ -45,7 +48,9 @@ class IPSubnet:
 class IPSubnetList:
     '''
     Represents an List of IP Subnet Ranges.
-    Note that currently on IPv4 subnet ranges are supported
+    The subnets are also kept in a native Longest Prefix Match trie (CList)
+    so that lookups don't depend on the number of subnets. IPv4 values are
+    Integers and IPv6 values 16 byte strings.
     '''
     #Represents the format for the IPv4 and IPv6 addresses
     #IPv6 is represented as a character string of 16 bytes
@@ -62,8 +67,10 @@ class IPSubnetList:
         #The Python list for Subnet
         self.PyList = {}
         self.count = 0
+        #The Longest Prefix Match trie
+        self.CList = dcslib.ip_subnet_trie_create()
 
-    def add(self, ip_value, mask_value, ip_gateway, mode):
+    def add(self, ip_value, mask_value, ip_gateway, mode, ip_type = socket.AF_INET):
         '''
         Adds a IP Subnet to List
         @param ip_value: IP Address of Subnet (Network Byte Order)
@@ -74,13 +81,20 @@ class IPSubnetList:
         @type ip_gateway: Integer
         @param mode: Mode of Subnet
         @type mode: Integer (0 = Dedicated, 1 = Shared)
+        @param ip_type: socket.AF_INET or socket.AF_INET6
+        @type ip_type: Integer
         @return: The status of the operation
         @rtype: dove_status (defined in include/status.h) Integer
         '''
+        subnet = IPSubnet(ip_value, mask_value, ip_gateway, mode, ip_type)
+        ret_val = dcslib.ip_subnet_trie_add(self.CList, ip_type, ip_value, mask_value, subnet)
+        if ret_val != DOVEStatus.DOVE_STATUS_OK:
+            return ret_val
         #Add to Python List
         key = '%s:%s'%(ip_value, mask_value)
-        self.PyList[key] = IPSubnet(ip_value, mask_value, ip_gateway, mode)
-        self.count += 1
+        if not self.PyList.has_key(key):
+            self.count += 1
+        self.PyList[key] = subnet
         return DOVEStatus.DOVE_STATUS_OK
 
     def delete(self, ip_value, mask_value):
@@ -95,42 +109,48 @@ class IPSubnetList:
         '''
         key = '%s:%s'%(ip_value, mask_value)
         try:
-            del self.PyList[key]
+            subnet = self.PyList[key]
         except Exception:
-            pass
+            return DOVEStatus.DOVE_STATUS_OK
+        dcslib.ip_subnet_trie_del(self.CList, subnet.ip_type, ip_value, mask_value)
+        del self.PyList[key]
         self.count -= 1
         if self.count < 0:
             message = 'IPSubnetList.delete: Count %s < 0 - Counting Error'%self.count
             dcslib.dps_data_write_log(DpsLogLevels.WARNING, message)
         return DOVEStatus.DOVE_STATUS_OK
 
-    def lookup(self, ip_value):
+    def lookup(self, ip_value, ip_type = socket.AF_INET):
         '''
         Check if a given IP falls into a subnet in the list and get the subnet
+        with the longest prefix
         @param ip_value: IP Address
         @type ip_value: Integer
+        @param ip_type: socket.AF_INET or socket.AF_INET6
+        @type ip_type: Integer
         @return: status, subnet_ip, subnet_mask, subnet_mode, subnet_gateway
         @rtype: Integer, Integer, Integer, Integer, Integer
         '''
         try:
-            subnet_list = self.PyList.values()
-            for subnet in subnet_list:
-                if (subnet.ip_value & subnet.mask_value) == (ip_value & subnet.mask_value):
-                    return DOVEStatus.DOVE_STATUS_OK, subnet.ip_value, subnet.mask_value, subnet.mode, subnet.ip_gateway
+            subnet = dcslib.ip_subnet_trie_lookup(self.CList, ip_type, ip_value)
+            if subnet is not None:
+                return DOVEStatus.DOVE_STATUS_OK, subnet.ip_value, subnet.mask_value, subnet.mode, subnet.ip_gateway
             return DOVEStatus.DOVE_STATUS_NOT_FOUND, 0, 0, 0, 0
         except Exception:
             return DOVEStatus.DOVE_STATUS_NOT_FOUND, 0, 0, 0, 0
 
-    def valid_ip(self, ip_value):
+    def valid_ip(self, ip_value, ip_type = socket.AF_INET):
         '''
         Check if a given IP falls in one of the Subnets in the Subnet List
         @param ip_value: IP Address
         @type ip_value: Integer
+        @param ip_type: socket.AF_INET or socket.AF_INET6
+        @type ip_type: Integer
         @return: (0 = Dedicated, 1 = Shared)
         @rtype: Integer
         @raise: Exception if the subnet is not found
         '''
-        ret_val, subnet_ip, subnet_mask, subnet_mode, subnet_gateway = self.lookup(ip_value)
+        ret_val, subnet_ip, subnet_mask, subnet_mode, subnet_gateway = self.lookup(ip_value, ip_type)
         if ret_val == DOVEStatus.DOVE_STATUS_OK:
             return subnet_mode
         else:
@@ -147,11 +167,8 @@ class IPSubnetList:
         @rtype: Integer, Integer, Integer, Integer, Integer
         '''
         try:
-            subnet_list = self.PyList.values()
-            for subnet in subnet_list:
-                if (subnet.ip_value & subnet.mask_value) == (ip_val & subnet_mask):
-                    return DOVEStatus.DOVE_STATUS_OK, subnet.ip_value, subnet.mask_value, subnet.mode, subnet.ip_gateway
-            return DOVEStatus.DOVE_STATUS_NOT_FOUND, 0, 0, 0, 0
+            subnet = self.PyList['%s:%s'%(ip_value, mask_value)]
+            return DOVEStatus.DOVE_STATUS_OK, subnet.ip_value, subnet.mask_value, subnet.mode, subnet.ip_gateway
         except Exception:
             return DOVEStatus.DOVE_STATUS_NOT_FOUND, 0, 0, 0, 0
 
@@ -164,10 +181,10 @@ class IPSubnetList:
         try:
             subnet_list = self.PyList.values()
             for subnet in subnet_list:
-                ip_value_packed = struct.pack('I', subnet.ip_value)
-                mask_value_packed = struct.pack('I', subnet.mask_value)
-                print 'IP: %s, Mask: %s\r'%(socket.inet_ntop(socket.AF_INET, ip_value_packed),
-                                            socket.inet_ntop(socket.AF_INET, mask_value_packed))
+                ip_value_packed = struct.pack(self.fmts[subnet.ip_type], subnet.ip_value)
+                mask_value_packed = struct.pack(self.fmts[subnet.ip_type], subnet.mask_value)
+                print 'IP: %s, Mask: %s\r'%(socket.inet_ntop(subnet.ip_type, ip_value_packed),
+                                            socket.inet_ntop(subnet.ip_type, mask_value_packed))
         except Exception:
             return DOVEStatus.DOVE_STATUS_NOT_FOUND
 
@@ -179,7 +196,8 @@ class IPSubnetList:
         '''
         self.count = 0
         self.PyList.clear()
-        return ret_val
+        dcslib.ip_subnet_trie_flush(self.CList)
+        return DOVEStatus.DOVE_STATUS_OK
 
     def destroy(self):
         '''
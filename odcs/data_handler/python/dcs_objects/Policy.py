@@ -132,6 +132,8 @@ class Policy(dcs_object):
             self.action_connectivity = action_struct[2] #3rd parameter
         #log.info('action_connectivity %s', self.action_connectivity)
         self.version += 1
+        self.domain.gateway_version_bump()
+        Domain.policy_index_publish(self.domain, self)
         #Send update to source DVG
         if self.domain.active:
             DpsCollection.policy_update_queue.put((self.src_dvg, self.traffic_type))
@@ -70,6 +70,8 @@ class DPSClient:
         self.failure_count = self.failure_count_max
         self.version = 0
         self.valid = True
+        #True once the DPS Client asked for sequenced broadcast lists
+        self.broadcast_sequenced = False
         #Add to Domain collection
         Domain.dps_client_add(self.domain, self)
         #self.show(None)
@@ -374,12 +376,17 @@ class TunnelEndpoint:
                 break
             self.DVG_Hash[client_type][dvg.unique_id] = dvg
             #Add to Tunnels List even though it may have come through other DVGs as well
+            fIPadded = False
             if inet_type == socket.AF_INET:
                 if not self.ip_listv4.search(ip_value):
                     self.ip_listv4.add(inet_type, ip_value)
+                    fIPadded = True
             elif inet_type == socket.AF_INET6:
                 if not self.ip_listv4.search(ip_value):
                     self.ip_listv6.add(inet_type, ip_value)
+                    fIPadded = True
+            if fIPadded:
+                self.endpoint_index_refresh()
             #log.info('ip_add: Adding to DPS Client %s', ip_value)
             #Add DVG to self.
             #Add IP to DPS Client
@@ -471,6 +478,7 @@ class TunnelEndpoint:
                 self.ip_listv4.remove(inet_type, ip_value)
             elif inet_type == socket.AF_INET6:
                 self.ip_listv6.remove(inet_type, ip_value)
+            self.endpoint_index_refresh()
             #Remove IP to DPS Client
             DPSClient.tunnel_endpoint_delete_IP(self.dps_client, inet_type, ip_value)
             #Remove IP from Domain
@@ -529,6 +537,7 @@ class TunnelEndpoint:
                 self.ip_listv4.remove(inet_type, ip_value)
             elif inet_type == socket.AF_INET6:
                 self.ip_listv6.remove(inet_type, ip_value)
+            self.endpoint_index_refresh()
             #Remove IP to DPS Client
             DPSClient.tunnel_endpoint_delete_IP(self.dps_client, inet_type, ip_value)
             #Remove IP from Domain
@@ -539,6 +548,15 @@ class TunnelEndpoint:
             break
         return
 
+    def endpoint_index_refresh(self):
+        '''
+        Republishes all Endpoints on this Tunnel into the native Endpoint
+        Index after the Tunnel IP lists have changed
+        '''
+        for endpoint in self.Endpoint_Hash_MAC.values():
+            Domain.endpoint_index_publish(endpoint.domain, endpoint)
+        return
+
     def delete_if_empty(self):
         '''
         This routine checks if a DPS Client no longer hosts any Endpoint.
@@ -656,6 +674,8 @@ class TunnelEndpoint:
                     tunnel_primary.ip_add(dvg, False, ctype, socket.AF_INET, ip_value, DpsTransactionType.normal)
         #Delete the Secondary Tunnel
         tunnel_secondary.delete()
+        #The moved Endpoints still reference the secondary Tunnel
+        tunnel_primary.endpoint_index_refresh()
         return
 
     @staticmethod
@@ -15,9 +15,11 @@ log = getLogger(__name__)
 import socket
 import struct
 import time
+import random
 import threading
 from threading import Lock
 from threading import Timer
+from collections import deque
 
 from object_collection import DOVEStatus
 from object_collection import DpsCollection
@@ -25,6 +27,7 @@ from object_collection import DpsClientType
 from object_collection import IPSUBNETMode
 from object_collection import IPSUBNETAssociatedType
 from object_collection import DpsLogLevels
+from object_collection import DpsTransactionType
 from dcs_objects.IPAddressLocation import IPAddressLocation
 from dcs_objects.Endpoint import Endpoint
 from dcs_objects.Policy import Policy
@@ -215,6 +218,86 @@ class DPSMulticastMassTransfer:
             multicast_ip_string = '0.0.0.0'
         return multicast_ip_string
 
+class DPSMassTransferStream:
+    '''
+    This PYTHON class defines the frames used by the bulk stream mode of
+    the mass transfer. A frame carries many VNID, Policy, Subnet, Tunnel,
+    Endpoint and Multicast records and is sent to the remote DPS Node over
+    the DCS REST (TCP) channel. Integers are in network order. IP addresses
+    are carried as (family, 16 bytes) holding the PYTHON packed format of
+    the address. IPv4 Subnets are carried as 4 bytes in the same format.
+    '''
+    #Frame Header: Node Nonce, Stream ID, Sequence Number, Number of Records
+    header_fmt = '!IIIH'
+    header_size = struct.calcsize(header_fmt)
+    #Stream IDs are Query IDs which restart on every DPS Node, so the remote
+    #node tells streams apart by the Nonce picked when this node starts.
+    nonce = random.SystemRandom().getrandbits(32)
+    #Record Types
+    record_tunnel = 1
+    record_endpoint = 2
+    record_multicast = 3
+    record_vnids = 4
+    record_policies = 5
+    record_subnets = 6
+    #Tunnel: Type, VNID, Client Type, Register, DPS Client (Family, Port, IP),
+    #        Number of pIPs. Followed by the pIPs (Family, IP)
+    tunnel_fmt = '!BIIBBH16sB'
+    tunnel_size = struct.calcsize(tunnel_fmt)
+    pip_fmt = '!B16s'
+    pip_size = struct.calcsize(pip_fmt)
+    #Endpoint: Type, VNID, DVG, Client Type, Version, Operation,
+    #          DPS Client (Family, Port, IP), pIP (Family, IP), vMac,
+    #          vIP (Family, IP)
+    endpoint_fmt = '!BIIIIIBH16sB16s6sB16s'
+    endpoint_size = struct.calcsize(endpoint_fmt)
+    #Multicast: Type, VNID, Sender, Register, Client Type, Global Scope,
+    #           Multicast MAC, Multicast IP (Family, IP), Tunnel IP (Family, IP)
+    multicast_fmt = '!BIBBIB6sB16sB16s'
+    multicast_size = struct.calcsize(multicast_fmt)
+    #VNIDs, Policies and Subnets: Type, Add, Number of Entries. Followed by
+    #the Entries. A record carries a whole DPSVNIDMassTransfer,
+    #DPSPolicyMassTransfer or DPSSubnetMassTransfer.
+    list_fmt = '!BBH'
+    list_size = struct.calcsize(list_fmt)
+    #VNID Entry: VNID
+    vnid_fmt = '!I'
+    vnid_size = struct.calcsize(vnid_fmt)
+    #Policy Entry: Traffic Type, Policy Type, Source VNID, Destination VNID,
+    #              TTL, Action
+    policy_fmt = '!BBIIIB'
+    policy_size = struct.calcsize(policy_fmt)
+    #Subnet Entry: VNID (0 for Domain), IP, Mask, Gateway, Mode
+    subnet_fmt = '!I4s4s4sB'
+    subnet_size = struct.calcsize(subnet_fmt)
+
+    @staticmethod
+    def ip_value_packed(inet_type, ip_value):
+        '''
+        This routine returns the packed format of an IP Address
+        @param inet_type: socket.AF_INET6 or socket.AF_INET
+        @type inet_type: Integer
+        @param ip_value: IPv4 in integer or IPv6 in string
+        @type ip_value: Integer or String
+        '''
+        try:
+            return struct.pack(IPAddressLocation.fmts[inet_type], ip_value)
+        except Exception:
+            return ''
+
+    @staticmethod
+    def ip_value_get(inet_type, ip_packed):
+        '''
+        This routine returns the IP Address value from the packed format
+        @param inet_type: socket.AF_INET6 or socket.AF_INET
+        @type inet_type: Integer
+        @param ip_packed: The packed IP Address (16 bytes)
+        @type ip_packed: String
+        '''
+        if inet_type == socket.AF_INET:
+            return struct.unpack('I', ip_packed[:4])[0]
+        return ip_packed
+
 class DPSDomainMassTransfer:
     '''
     This PYTHON class handles the Mass Transfer of objects related
@@ -260,6 +343,26 @@ class DPSDomainMassTransfer:
     #then force retry
     remaining_registration_retry = 500
 
+    #Bulk stream mode: Tunnels, Endpoints and Multicast registrations are
+    #packed into frames of stream_frame_objects records. Upto stream_window
+    #frames are outstanding at the remote node which ACKs them cumulatively.
+    stream_enabled = True
+    stream_frame_objects = 1000
+    stream_window = 8
+
+    #VNIDs, Policies and Subnets are streamed as well (needs stream mode).
+    #A record carries a whole list of them so a frame carries at most
+    #stream_frame_lists records. If disabled they are sent as JSON documents
+    #with synchronous REST requests, which is only meant for debugging.
+    stream_lists_enabled = True
+    stream_frame_lists = 16
+
+    #Snapshot mode (needs stream mode): The Tunnels, Endpoints and Multicast
+    #registrations are packed into an image of the domain when the transfer
+    #starts. Registrations that happen later are packed into an update log
+    #which is streamed after the image.
+    snapshot_enabled = True
+
     def __init__(self, domain, inet_type, ip_value, port, finish_callback, weight):
         '''
         This routine initializes the object associated with Mass Transfer
@@ -315,6 +418,36 @@ class DPSDomainMassTransfer:
                                  self.transfer_endpoints: self.endpoint_send}
         self.ip_get_val_from_packed = {socket.AF_INET6: self.ipv6_get_val_from_packed,
                                        socket.AF_INET: self.ipv4_get_val_from_packed}
+        #Bulk stream state. Frames in the window are keyed by sequence number
+        #Value = (transfer stage, query_ids, frame, tries)
+        #The checkpoint is the highest sequence number ACKed by the remote
+        #node. When the stream stalls, all frames after the checkpoint are
+        #sent again.
+        self.stream_record = {self.transfer_tunnels: self.tunnel_record,
+                              self.transfer_endpoints: self.endpoint_record,
+                              self.transfer_multicasts: self.multicast_record}
+        if self.stream_lists_enabled:
+            self.stream_record[self.transfer_vnids] = self.vnid_record
+            self.stream_record[self.transfer_policies] = self.policy_record
+            self.stream_record[self.transfer_subnets] = self.subnet_record
+        self.stream_id = DpsCollection.generate_query_id()
+        self.stream_seq = 0
+        self.stream_checkpoint = 0
+        self.stream_checkpoint_last = 0
+        self.stream_frames = {}
+        #Snapshot state. Both hold packed stream records in the order in
+        #which they must be applied at the remote node. Records are removed
+        #as they are put into frames.
+        self.snapshot = deque()
+        self.update_log = deque()
+        #The priority with which the scheduler sends the frames of this
+        #transfer. See priority_update.
+        self.priority = (0, 0)
+        if self.stream_enabled:
+            DpsCollection.mass_transfer_lock.acquire()
+            DpsCollection.MassTransfer_QueryID_Mapping[self.stream_id] = self
+            DpsCollection.MassTransfer_Scheduled[domain.unique_id] = self
+            DpsCollection.mass_transfer_lock.release()
 
     @staticmethod
     def domain_mass_transfer_weight(domain):
@@ -356,6 +489,7 @@ class DPSDomainMassTransfer:
         for i in range(self.transfer_tunnels, self.transfer_finished):
             count += len(self.transfer[i][0])
             count += len(self.transfer[i][1])
+        count += len(self.snapshot) + len(self.update_log)
         #print 'remaining_items %s\r'%count
         return count
 
@@ -617,6 +751,567 @@ class DPSDomainMassTransfer:
             DpsCollection.mass_transfer_lock.release()
         return
 
+    def tunnel_record(self, vnid, tunnel_transfer):
+        '''
+        This routine packs a tunnel into a bulk stream record
+        @attention: DO NOT IMPORT from other PYTHON modules
+        @param vnid: The vnid for this registration
+        @type vnid: Integer
+        @param tunnel_transfer: The DPSTunnelMassTransfer Object
+        @type tunnel_transfer: DPSTunnelMassTransfer
+        '''
+        if tunnel_transfer.fregister:
+            fregister = 1
+        else:
+            fregister = 0
+        host_location = tunnel_transfer.host_location
+        records = [struct.pack(DPSMassTransferStream.tunnel_fmt,
+                               DPSMassTransferStream.record_tunnel,
+                               vnid,
+                               tunnel_transfer.client_type,
+                               fregister,
+                               host_location.inet_type,
+                               host_location.port,
+                               host_location.ip_value_packed,
+                               len(tunnel_transfer.pip_tuple_list))]
+        for pip_tuple in tunnel_transfer.pip_tuple_list:
+            records.append(struct.pack(DPSMassTransferStream.pip_fmt,
+                                       pip_tuple[0],
+                                       DPSMassTransferStream.ip_value_packed(pip_tuple[0],
+                                                                             pip_tuple[1])))
+        return ''.join(records)
+
+    def endpoint_record(self, vnid, endpoint_transfer):
+        '''
+        This routine packs an endpoint into a bulk stream record. Like
+        endpoint_send only the 1st pIP of the tunnel is carried.
+        @attention: DO NOT IMPORT from other PYTHON modules
+        @param vnid: The vnid for this registration
+        @type vnid: Integer
+        @param endpoint_transfer: The DPSEndpointMassTransfer Object
+        @type endpoint_transfer: DPSEndpointMassTransfer
+        '''
+        endpoint = endpoint_transfer.endpoint
+        tunnel = endpoint.tunnel_endpoint
+        host_location = tunnel.dps_client.location
+        pip_type = 0
+        pip_packed = ''
+        if len(tunnel.ip_listv4.ip_list) > 0:
+            pip_type = socket.AF_INET
+            pip_packed = DPSMassTransferStream.ip_value_packed(pip_type,
+                                                               tunnel.ip_listv4.ip_list[0])
+        elif len(tunnel.ip_listv6.ip_list) > 0:
+            pip_type = socket.AF_INET6
+            pip_packed = DPSMassTransferStream.ip_value_packed(pip_type,
+                                                               tunnel.ip_listv6.ip_list[0])
+        return struct.pack(DPSMassTransferStream.endpoint_fmt,
+                           DPSMassTransferStream.record_endpoint,
+                           vnid,
+                           endpoint.dvg.unique_id,
+                           endpoint.client_type,
+                           endpoint.version,
+                           endpoint_transfer.operation,
+                           host_location.inet_type,
+                           host_location.port,
+                           host_location.ip_value_packed,
+                           pip_type,
+                           pip_packed,
+                           endpoint.vMac,
+                           endpoint_transfer.vIP.inet_type,
+                           endpoint_transfer.vIP.ip_value_packed)
+
+    def multicast_record(self, vnid, multicast_transfer):
+        '''
+        This routine packs a multicast registration into a bulk stream record
+        @attention: DO NOT IMPORT from other PYTHON modules
+        @param vnid: The vnid for this registration
+        @type vnid: Integer
+        @param multicast_transfer: The DPSMulticastMassTransfer Object
+        @type multicast_transfer: DPSMulticastMassTransfer
+        '''
+        if multicast_transfer.fsender:
+            fsender = 1
+        else:
+            fsender = 0
+        if multicast_transfer.fregister:
+            fregister = 1
+        else:
+            fregister = 0
+        if len(multicast_transfer.tunnel_ip_packed) == 4:
+            tunnel_ip_family = socket.AF_INET
+        else:
+            tunnel_ip_family = socket.AF_INET6
+        return struct.pack(DPSMassTransferStream.multicast_fmt,
+                           DPSMassTransferStream.record_multicast,
+                           multicast_transfer.vnid,
+                           fsender,
+                           fregister,
+                           multicast_transfer.client_type,
+                           multicast_transfer.global_scope,
+                           multicast_transfer.multicast_mac,
+                           multicast_transfer.multicast_ip_family,
+                           multicast_transfer.multicast_ip_packed,
+                           tunnel_ip_family,
+                           multicast_transfer.tunnel_ip_packed)
+
+    def vnid_record(self, vnid_key, vnid_transfer):
+        '''
+        This routine packs a set of VNIDs into a bulk stream record
+        @attention: DO NOT IMPORT from other PYTHON modules
+        @param vnid_key: The VNID key for this set
+        @type vnid_key: String
+        @param vnid_transfer: The DPSVNIDMassTransfer Object
+        @type vnid_transfer: DPSVNIDMassTransfer
+        '''
+        if vnid_transfer.fadd:
+            add = 1
+        else:
+            add = 0
+        records = [struct.pack(DPSMassTransferStream.list_fmt,
+                               DPSMassTransferStream.record_vnids,
+                               add,
+                               len(vnid_transfer.vnids))]
+        for vnid in vnid_transfer.vnids:
+            records.append(struct.pack(DPSMassTransferStream.vnid_fmt, vnid))
+        return ''.join(records)
+
+    def policy_record(self, policy_key, policy_transfer):
+        '''
+        This routine packs a set of policies into a bulk stream record
+        @attention: DO NOT IMPORT from other PYTHON modules
+        @param policy_key: The policy key for this set
+        @type policy_key: String
+        @param policy_transfer: The DPSPolicyMassTransfer Object
+        @type policy_transfer: DPSPolicyMassTransfer
+        '''
+        if policy_transfer.fadd:
+            add = 1
+        else:
+            add = 0
+        records = [struct.pack(DPSMassTransferStream.list_fmt,
+                               DPSMassTransferStream.record_policies,
+                               add,
+                               len(policy_transfer.policies))]
+        for (traffic_type, policy_type, src_dvg, dst_dvg, ttl, action) in policy_transfer.policies:
+            records.append(struct.pack(DPSMassTransferStream.policy_fmt,
+                                       traffic_type, policy_type,
+                                       src_dvg, dst_dvg, ttl, action))
+        return ''.join(records)
+
+    def subnet_record(self, subnet_key, subnet_transfer):
+        '''
+        This routine packs a set of IPv4 subnets into a bulk stream record
+        @attention: DO NOT IMPORT from other PYTHON modules
+        @param subnet_key: The subnet key for this set
+        @type subnet_key: String or Integer
+        @param subnet_transfer: The DPSSubnetMassTransfer Object
+        @type subnet_transfer: DPSSubnetMassTransfer
+        '''
+        if subnet_transfer.fadd:
+            add = 1
+        else:
+            add = 0
+        records = [struct.pack(DPSMassTransferStream.list_fmt,
+                               DPSMassTransferStream.record_subnets,
+                               add,
+                               len(subnet_transfer.subnets))]
+        for (vnid, ip_string, mask_string, gwy_string, mode_string) in subnet_transfer.subnets:
+            if mode_string == 'shared':
+                mode = IPSUBNETMode.IP_SUBNET_MODE_SHARED
+            else:
+                mode = IPSUBNETMode.IP_SUBNET_MODE_DEDICATED
+            records.append(struct.pack(DPSMassTransferStream.subnet_fmt,
+                                       vnid,
+                                       socket.inet_pton(socket.AF_INET, ip_string),
+                                       socket.inet_pton(socket.AF_INET, mask_string),
+                                       socket.inet_pton(socket.AF_INET, gwy_string),
+                                       mode))
+        return ''.join(records)
+
+    def stream_header(self, seq, count):
+        '''
+        This routine packs the header of a frame of this stream
+        @attention: DO NOT IMPORT from other PYTHON modules
+        @param seq: The sequence number of the frame
+        @type seq: Integer
+        @param count: The number of records in the frame
+        @type count: Integer
+        '''
+        return struct.pack(DPSMassTransferStream.header_fmt,
+                           DPSMassTransferStream.nonce,
+                           self.stream_id, seq, count)
+
+    def stream_frame_send(self, seq):
+        '''
+        This routine sends a frame in the window to the remote node
+        @attention: DO NOT IMPORT from other PYTHON modules
+        @param seq: The sequence number of the frame
+        @type seq: Integer
+        '''
+        stage, query_ids, frame, tries = self.stream_frames[seq]
+        if tries > self.MAX_RETRIES_PER_OBJECT:
+            #Reached max number of retries per frame
+            self.valid = False
+            raise Exception('Frame %s reached %s tries'%(seq, self.MAX_RETRIES_PER_OBJECT))
+        self.stream_frames[seq] = (stage, query_ids, frame, tries+1)
+        status = dcslib.mass_transfer_stream_send(self.remote_location.ip_value_packed,
+                                                  self.domain.unique_id,
+                                                  frame)
+        if status != 0:
+            message = 'Domain %s: Mass Transfer Stream %s cannot send frame %s'%(self.domain.unique_id,
+                                                                                   self.stream_id,
+                                                                                   seq)
+            dcslib.dps_cluster_write_log(DpsLogLevels.NOTICE, message)
+        return
+
+    def stream_objects(self, obj_set, obj_set_unacked, frames_max):
+        '''
+        This routine packs the objects of the current stage into frames and
+        sends them till the window is full
+        @attention: DO NOT IMPORT from other PYTHON modules
+        @attention: This routine assumes that the calling routine has the 
+                    object lock held.
+        @param obj_set: The objects which need to be transferred
+        @type obj_set: Dictionary
+        @param obj_set_unacked: The objects sent but not acknowledged
+        @type obj_set_unacked: Dictionary
+        @param frames_max: The maximum number of new frames to send
+        @type frames_max: Integer
+        @return: The number of new frames sent
+        @rtype: Integer
+        '''
+        record_routine = self.stream_record[self.transfer_stage]
+        if self.transfer_stage < self.transfer_tunnels:
+            records_max = self.stream_frame_lists
+        else:
+            records_max = self.stream_frame_objects
+        frames = 0
+        while len(self.stream_frames) < self.stream_window and frames < frames_max:
+            records = []
+            query_ids = []
+            while len(records) < records_max:
+                try:
+                    key, obj_tuple = obj_set.popitem()
+                except Exception:
+                    break
+                query_id = obj_tuple[2]
+                try:
+                    records.append(record_routine(obj_tuple[0], obj_tuple[1]))
+                except Exception, ex:
+                    message = 'Domain %s: Mass Transfer Stream cannot pack %s, Exception [%s]'%(self.domain.unique_id,
+                                                                                                  self.stage_get(),
+                                                                                                  ex)
+                    dcslib.dps_cluster_write_log(DpsLogLevels.WARNING, message)
+                    continue
+                obj_set_unacked[query_id] = (obj_tuple[0], obj_tuple[1], 0)
+                query_ids.append(query_id)
+            if len(records) == 0:
+                break
+            self.stream_seq += 1
+            header = self.stream_header(self.stream_seq, len(records))
+            self.stream_frames[self.stream_seq] = (self.transfer_stage,
+                                                   query_ids,
+                                                   header + ''.join(records),
+                                                   0)
+            self.stream_frame_send(self.stream_seq)
+            frames += 1
+        return frames
+
+    def stream_retransmit(self):
+        '''
+        This routine is invoked periodically. If the remote node didn't ACK
+        any frame since the last invocation, all frames after the checkpoint
+        are sent again.
+        @attention: DO NOT IMPORT from other PYTHON modules
+        @attention: This routine assumes that the calling routine has the 
+                    object lock held.
+        '''
+        if len(self.stream_frames) == 0:
+            return
+        if self.stream_checkpoint != self.stream_checkpoint_last:
+            self.stream_checkpoint_last = self.stream_checkpoint
+            return
+        message = 'Domain %s: Mass Transfer Stream %s resending from checkpoint %s'%(self.domain.unique_id,
+                                                                                     self.stream_id,
+                                                                                     self.stream_checkpoint)
+        dcslib.dps_cluster_write_log(DpsLogLevels.NOTICE, message)
+        seqs = self.stream_frames.keys()
+        seqs.sort()
+        for seq in seqs:
+            self.stream_frame_send(seq)
+        return
+
+    def stream_ack(self, ack_seq, status):
+        '''
+        This routine should be called when the remote node ACKs the frames
+        of the stream. The ACK is cumulative.
+        @attention: DO NOT IMPORT from other PYTHON modules
+        @param ack_seq: All frames upto and including this sequence number
+                        have been applied at the remote node
+        @type ack_seq: Integer
+        @param status: The status of the next frame
+        @type status: Integer
+        '''
+        self.lock.acquire()
+        try:
+            if ack_seq > self.stream_seq:
+                #The remote node confuses this stream with another one
+                self.stream_reset('ACK %s beyond last frame %s'%(ack_seq, self.stream_seq))
+            elif status == DpsClientHandler.dps_error_invalid_query_id:
+                #The remote node has no state for this stream
+                self.stream_reset('unknown at the remote node')
+            elif ack_seq > self.stream_checkpoint:
+                self.stream_checkpoint = ack_seq
+                for seq in self.stream_frames.keys():
+                    if seq > ack_seq:
+                        continue
+                    stage, query_ids, frame, tries = self.stream_frames[seq]
+                    del self.stream_frames[seq]
+                    obj_set_unacked = self.transfer[stage][1]
+                    for query_id in query_ids:
+                        try:
+                            del obj_set_unacked[query_id]
+                        except Exception:
+                            pass
+                #Let the scheduler fill the window
+                DpsCollection.MassTransfer_Schedule_Event.set()
+            if status != DpsClientHandler.dps_error_none:
+                message = 'Domain %s: Mass Transfer Stream %s ACK %s status %s'%(self.domain.unique_id,
+                                                                                 self.stream_id,
+                                                                                 ack_seq,
+                                                                                 status)
+                dcslib.dps_cluster_write_log(DpsLogLevels.INFO, message)
+        except Exception, ex:
+            message = 'Domain %s: Mass Transfer Stream ACK Exception [%s]'%(self.domain.unique_id, ex)
+            dcslib.dps_cluster_write_log(DpsLogLevels.WARNING, message)
+        self.lock.release()
+        return
+
+    def stream_reset(self, reason):
+        '''
+        This routine is called when the remote node ACKs frames that were
+        never sent or no longer knows the stream. The stream continues under
+        a new Stream ID: the frames in the window are numbered again from 1
+        and sent again.
+        @attention: DO NOT IMPORT from other PYTHON modules
+        @attention: This routine assumes that the calling routine has the 
+                    object lock held.
+        @param reason: Why the stream is reset
+        @type reason: String
+        '''
+        message = 'Domain %s: Mass Transfer Stream %s %s, resetting'%(self.domain.unique_id,
+                                                                       self.stream_id,
+                                                                       reason)
+        dcslib.dps_cluster_write_log(DpsLogLevels.WARNING, message)
+        DpsCollection.mass_transfer_lock.acquire()
+        try:
+            del DpsCollection.MassTransfer_QueryID_Mapping[self.stream_id]
+        except Exception:
+            pass
+        self.stream_id = DpsCollection.generate_query_id()
+        DpsCollection.MassTransfer_QueryID_Mapping[self.stream_id] = self
+        DpsCollection.mass_transfer_lock.release()
+        stream_frames = self.stream_frames
+        seqs = stream_frames.keys()
+        seqs.sort()
+        self.stream_frames = {}
+        self.stream_seq = 0
+        self.stream_checkpoint = 0
+        self.stream_checkpoint_last = 0
+        for seq in seqs:
+            stage, query_ids, frame, tries = stream_frames[seq]
+            count = struct.unpack_from(DPSMassTransferStream.header_fmt, frame, 0)[3]
+            self.stream_seq += 1
+            header = self.stream_header(self.stream_seq, count)
+            self.stream_frames[self.stream_seq] = (stage,
+                                                   query_ids,
+                                                   header + frame[DPSMassTransferStream.header_size:],
+                                                   0)
+            self.stream_frame_send(self.stream_seq)
+        return
+
+    def stream_close(self):
+        '''
+        This routine stops routing ACKs to this stream and lets the remote
+        node drop its state for the stream
+        @attention: DO NOT IMPORT from other PYTHON modules
+        '''
+        if self.stream_enabled and self.stream_seq > 0:
+            #A frame with sequence number 0 closes the stream. It isn't
+            #retransmitted, the remote node times out idle streams anyway.
+            dcslib.mass_transfer_stream_send(self.remote_location.ip_value_packed,
+                                             self.domain.unique_id,
+                                             self.stream_header(0, 0))
+        if self.stream_enabled:
+            DpsCollection.mass_transfer_lock.acquire()
+            try:
+                del DpsCollection.MassTransfer_QueryID_Mapping[self.stream_id]
+            except Exception:
+                pass
+            try:
+                if DpsCollection.MassTransfer_Scheduled[self.domain.unique_id] == self:
+                    del DpsCollection.MassTransfer_Scheduled[self.domain.unique_id]
+            except Exception:
+                pass
+            DpsCollection.mass_transfer_lock.release()
+        self.stream_frames.clear()
+        return
+
+    def snapshot_mode(self):
+        '''
+        This routine determines if the Tunnels, Endpoints and Multicast
+        registrations are transferred as a snapshot and an update log
+        @attention: DO NOT IMPORT from other PYTHON modules
+        '''
+        return self.stream_enabled and self.snapshot_enabled
+
+    def snapshot_take(self):
+        '''
+        This routine takes the image of the domain. The objects collected by
+        transfer_start_get_tunnels/endpoints/multicasts are packed right away
+        so later changes to the live objects don't leak into the image. Those
+        changes reach the remote node through the update log instead.
+        @attention: DO NOT IMPORT from other PYTHON modules
+        @attention: This routine assumes that the global database lock is held
+                    so that the domain objects don't change during this routine.
+        '''
+        for stage in (self.transfer_tunnels, self.transfer_endpoints, self.transfer_multicasts):
+            obj_set = self.transfer[stage][0]
+            record_routine = self.stream_record[stage]
+            for obj_tuple in obj_set.values():
+                try:
+                    self.snapshot.append(record_routine(obj_tuple[0], obj_tuple[1]))
+                except Exception, ex:
+                    message = 'Domain %s: Mass Transfer Snapshot cannot pack %s, Exception [%s]'%(self.domain.unique_id,
+                                                                                                    self.transfer_string[stage],
+                                                                                                    ex)
+                    dcslib.dps_cluster_write_log(DpsLogLevels.WARNING, message)
+            obj_set.clear()
+        message = 'Domain %s: Mass Transfer Snapshot %s records'%(self.domain.unique_id,
+                                                                  len(self.snapshot))
+        dcslib.dps_cluster_write_log(DpsLogLevels.INFO, message)
+        return
+
+    def snapshot_objects(self, frames_max):
+        '''
+        This routine puts the image and then the update log into frames and
+        sends them till the window is full
+        @attention: DO NOT IMPORT from other PYTHON modules
+        @attention: This routine assumes that the calling routine has the 
+                    object lock held.
+        @param frames_max: The maximum number of new frames to send
+        @type frames_max: Integer
+        @return: The number of new frames sent
+        @rtype: Integer
+        '''
+        frames = 0
+        while len(self.stream_frames) < self.stream_window and frames < frames_max:
+            records = []
+            for records_queue in (self.snapshot, self.update_log):
+                while len(records) < self.stream_frame_objects:
+                    try:
+                        records.append(records_queue.popleft())
+                    except Exception:
+                        break
+            if len(records) == 0:
+                break
+            self.stream_seq += 1
+            header = self.stream_header(self.stream_seq, len(records))
+            self.stream_frames[self.stream_seq] = (self.transfer_stage,
+                                                   [],
+                                                   header + ''.join(records),
+                                                   0)
+            self.stream_frame_send(self.stream_seq)
+            frames += 1
+        return frames
+
+    def stream_schedule(self, frames_max):
+        '''
+        This routine is invoked by the Mass Transfer Scheduler to send new
+        frames of this transfer within the budget it was handed
+        @attention: DO NOT IMPORT from other PYTHON modules
+        @param frames_max: The maximum number of new frames to send
+        @type frames_max: Integer
+        @return: The number of new frames sent
+        @rtype: Integer
+        '''
+        frames = 0
+        self.lock.acquire()
+        try:
+            while True:
+                if not self.valid or not self.domain.valid:
+                    break
+                if self.transfer_stage not in self.stream_record:
+                    break
+                if self.snapshot_mode() and self.transfer_stage >= self.transfer_tunnels:
+                    frames = self.snapshot_objects(frames_max)
+                else:
+                    set_tuple = self.transfer[self.transfer_stage]
+                    frames = self.stream_objects(set_tuple[0], set_tuple[1], frames_max)
+                break
+        except Exception, ex:
+            message = 'Domain %s: Mass Transfer Stream stage %s Exception [%s]'%(self.domain.unique_id,
+                                                                                 self.stage_get(),
+                                                                                 ex)
+            dcslib.dps_cluster_write_log(DpsLogLevels.WARNING, message)
+        self.lock.release()
+        return frames
+
+    def priority_update(self):
+        '''
+        This routine computes the priority of this transfer. Domains with
+        the fewest copies on nodes that are up (compared to the replication
+        factor) go first, then Domains with the most Endpoints.
+        @attention: DO NOT IMPORT from other PYTHON modules
+        '''
+        copies = 0
+        try:
+            for dps_node in self.cluster_db.cluster.Domain_Hash[self.domain.unique_id].values():
+                if dps_node.is_up():
+                    copies += 1
+        except Exception:
+            pass
+        self.priority = (copies - self.domain.replication_factor,
+                         -len(self.domain.Endpoint_Hash_MAC))
+        return
+
+    def snapshot_log(self, record_routine, vnid, obj_transfer):
+        '''
+        This routine appends a registration which happened after the image
+        was taken to the update log
+        @attention: MUST NOT BE INVOKED from other PYTHON modules
+        @attention: The global lock must be held when this routine is called
+        @param record_routine: The routine which packs the object
+        @type record_routine: PYTHON routine
+        @param vnid: The vnid for this registration
+        @type vnid: Integer
+        @param obj_transfer: The Tunnel, Endpoint or Multicast transfer object
+        @type obj_transfer: DPSTunnelMassTransfer/DPSEndpointMassTransfer/DPSMulticastMassTransfer
+        @return: The status of the operation
+        @rtype: DOVEStatus
+        '''
+        try:
+            record = record_routine(vnid, obj_transfer)
+        except Exception, ex:
+            message = 'Domain %s: Mass Transfer Update Log cannot pack %s, Exception [%s]'%(self.domain.unique_id,
+                                                                                              obj_transfer.show(),
+                                                                                              ex)
+            dcslib.dps_cluster_write_log(DpsLogLevels.WARNING, message)
+            return DOVEStatus.DOVE_STATUS_INVALID_PARAMETER
+        status = DOVEStatus.DOVE_STATUS_OK
+        self.lock.acquire()
+        while True:
+            if not self.registration_allow():
+                status = DOVEStatus.DOVE_STATUS_RETRY
+                break
+            self.update_log.append(record)
+            #The log is streamed in the Tunnel stage
+            if self.transfer_stage > self.transfer_tunnels:
+                self.transfer_stage = self.transfer_tunnels
+            break
+        self.lock.release()
+        return status
+
     def transfer_start_get_vnids(self):
         '''
         This routine gets the vnids which need to be transferred
@@ -1007,6 +1702,18 @@ class DPSDomainMassTransfer:
             except Exception:
                 fFinished = True
                 break
+            if self.stream_enabled and self.transfer_stage in self.stream_record:
+                #The frames are sent by the Mass Transfer Scheduler
+                #The image and the update log are streamed from the Tunnel stage
+                if (len(obj_set) == 0 and len(obj_set_unacked) == 0 and
+                    len(self.stream_frames) == 0 and
+                    (self.transfer_stage < self.transfer_tunnels or
+                     (len(self.snapshot) == 0 and len(self.update_log) == 0))):
+                    #Go to next transfer stage
+                    self.transfer_stage += 1
+                    continue
+                DpsCollection.MassTransfer_Schedule_Event.set()
+                break
             #Figure out the maximum objects to transfer
             max_new_objects = unacked_max - len(obj_set_unacked)
             max_new_objects = min(max_new_objects, len(obj_set))
@@ -1094,6 +1801,11 @@ class DPSDomainMassTransfer:
             if not self.domain.valid:
                 allow = False
                 break
+            if self.snapshot_mode():
+                #The update log is accepted till the transfer is complete
+                if self.invoked_callback:
+                    allow = False
+                break
             if ((len(self.transfer[self.transfer_tunnels][0]) == 0) and 
                 (len(self.transfer[self.transfer_endpoints][0]) == 0) and 
                 (len(self.transfer[self.transfer_multicasts][0]) == 0)):
@@ -1178,6 +1890,9 @@ class DPSDomainMassTransfer:
         self.lock.acquire()
         try:
             fInvokeCallback = False
+            if self.stream_enabled:
+                self.priority_update()
+                self.stream_retransmit()
             fFinished = self.transfer_objects()
             if fFinished and not self.invoked_callback:
                 self.invoked_callback = True
@@ -1193,6 +1908,7 @@ class DPSDomainMassTransfer:
         #Invoke callback if needed
         elif fInvokeCallback:
             #print 'Invoking transfer complete callback for Domain %s\r'%self.domain.unique_id
+            self.stream_close()
             self.finish_callback(self.remote_location, True, self.weight)
         #print 'Mass Transfer Thread for Domain %s finish\r'%self.domain.unique_id
         return
@@ -1216,6 +1932,10 @@ class DPSDomainMassTransfer:
         self.transfer_start_get_endpoints()
         #Get the Multicast Set
         self.transfer_start_get_multicasts()
+        #Pack the Tunnels, Endpoints and Multicast into the image
+        if self.snapshot_mode():
+            self.snapshot_take()
+        self.priority_update()
         #Start the Mass Transfer Thread
         self.transfer_stage = self.transfer_vnids
         #self.show()
@@ -1298,6 +2018,8 @@ class DPSDomainMassTransfer:
         #tunnel_key = '%s'%query_id
         tunnel_tuple = (vnid, tunnel_transfer, query_id)
         #print 'Mass Transfer: register_tunnel key %s, query_id %s, tunnel %s\r'%(tunnel_key, query_id, tunnel_transfer.show())
+        if self.snapshot_mode():
+            return self.snapshot_log(self.tunnel_record, vnid, tunnel_transfer)
         status = self.register_delta(self.transfer_tunnels, tunnel_key, tunnel_tuple)
         #print 'Mass Transfer: register_tunnel Exit\r'
         return status
@@ -1326,6 +2048,8 @@ class DPSDomainMassTransfer:
         #endpoint_key = '%s'%query_id
         endpoint_tuple = (vnid, endpoint_transfer, query_id)
         #print 'Mass Transfer: register_endpoint key %s, query_id %s, endpoint %s\r'%(endpoint_key, query_id, endpoint_transfer.show())
+        if self.snapshot_mode():
+            return self.snapshot_log(self.endpoint_record, vnid, endpoint_transfer)
         status = self.register_delta(self.transfer_endpoints, endpoint_key, endpoint_tuple)
         #print 'Mass Transfer: register_endpoint Exit\r'
         return status
@@ -1373,6 +2097,8 @@ class DPSDomainMassTransfer:
         #multicast_key = '%s:%s:%s:%s:%s'%(vnid, client_type, multicast_mac, multicast_IP_val, tunnel_IP_val)
         multicast_key = '%s'%query_id
         multicast_tuple = (vnid, multicast_transfer, query_id)
+        if self.snapshot_mode():
+            return self.snapshot_log(self.multicast_record, vnid, multicast_transfer)
         status = self.register_delta(self.transfer_multicasts, multicast_key, multicast_tuple)
         return status
 
@@ -1463,7 +2189,7 @@ class DPSDomainMassTransfer:
         else:
             vnid = associated_id
         subnet_tuple = (vnid, ip_string, mask_string, gwy_string, mode_string)
-        subnet_transfer = DPSSubnetMassTransfer(fadd, [subnet_tuple])
+        subnet_transfer = DPSSubnetMassTransfer([subnet_tuple], fadd)
         query_id = DpsCollection.generate_query_id()
         #Must match with transfer_set_get_subnets
         subnet_key = '%s:%s:%s'%(associated_type, associated_id, ip_value)
@@ -1481,6 +2207,9 @@ class DPSDomainMassTransfer:
             return 'Error: Unknown Stage'
 
     def delete(self):
+        self.stream_close()
+        self.snapshot.clear()
+        self.update_log.clear()
         for i in range(1,self.transfer_finished):
             try:
                 transfers = self.transfer[i]
@@ -1497,6 +2226,10 @@ class DPSDomainMassTransfer:
         Show contents
         @attention: CAN BE INVOKED from other PYTHON modules
         '''
+        if self.snapshot_mode():
+            print 'Snapshot Records %s, Update Log Records %s, Frames To Be ACKED %s\r'%(len(self.snapshot),
+                                                                                       len(self.update_log),
+                                                                                       len(self.stream_frames))
         print '------------------------ Tunnels ----------------------\r'
         set_tuple = self.transfer[self.transfer_tunnels]
         obj_set = set_tuple[0]
@@ -1534,6 +2267,13 @@ class DPSMassTransfer:
     This is the global class which handles mass transfer. The C code should
     invoke routines from this Class.
     '''
+    #Max number of incoming streams whose last applied sequence number
+    #is remembered. Every DPS Node may be sending MassTransfer_Max streams.
+    stream_received_max = 1024
+    #Seconds after which the state of an incoming stream that received no
+    #frame is dropped. This is well beyond the time a sender keeps
+    #retransmitting a frame (MAX_RETRIES_PER_OBJECT * TIMER_SLEEP).
+    stream_received_timeout = 300
 
     def __init__(self):
         '''
@@ -1541,6 +2281,21 @@ class DPSMassTransfer:
         '''
         #Mapping of Query IDs to DPSDomainMassTransfer Objects
         self.QueryID_Mapping = DpsCollection.MassTransfer_QueryID_Mapping
+        #Handlers used to apply the records of incoming streams. The
+        #controller_protocol_handler module imports this module so it can
+        #only be imported once both are loaded.
+        self.client_handler = DpsClientHandler()
+        from controller_protocol_handler import DpsControllerHandler
+        self.controller_handler = DpsControllerHandler()
+        #Incoming streams. Key = (Node Nonce, Domain ID, Stream ID),
+        #Value = (Last applied sequence number, Time of last frame)
+        self.Stream_Received = {}
+        self.stream_record = {DPSMassTransferStream.record_tunnel: self.stream_tunnel_apply,
+                              DPSMassTransferStream.record_endpoint: self.stream_endpoint_apply,
+                              DPSMassTransferStream.record_multicast: self.stream_multicast_apply,
+                              DPSMassTransferStream.record_vnids: self.stream_vnids_apply,
+                              DPSMassTransferStream.record_policies: self.stream_policies_apply,
+                              DPSMassTransferStream.record_subnets: self.stream_subnets_apply}
 
     def Transfer_Ack(self, query_id, status):
         '''
@@ -1561,3 +2316,299 @@ class DPSMassTransfer:
             domain_transfer.transfer_ack(query_id, status)
             break
         return
+
+    def Stream_Ack(self, stream_id, ack_seq, status):
+        '''
+        Handle the cumulative ACK of a bulk stream
+        @attention: This routine MUST be called from C code only
+        @param stream_id: The Stream ID
+        @type stream_id: Integer
+        @param ack_seq: The last sequence number applied by the remote node
+        @type ack_seq: Integer
+        @param status: The status of the next frame
+        @type status: Integer
+        '''
+        while True:
+            DpsCollection.mass_transfer_lock.acquire()
+            try:
+                domain_transfer = self.QueryID_Mapping[stream_id]
+            except Exception:
+                DpsCollection.mass_transfer_lock.release()
+                break
+            DpsCollection.mass_transfer_lock.release()
+            domain_transfer.stream_ack(ack_seq, status)
+            break
+        return
+
+    def stream_tunnel_apply(self, domain_id, frame, offset):
+        '''
+        This routine applies a tunnel record of a bulk stream
+        @return: (status, offset of next record)
+        @rtype: (Integer, Integer)
+        '''
+        (record_type, vnid, client_type, fregister,
+         host_type, host_port, host_packed, pip_count) = struct.unpack_from(DPSMassTransferStream.tunnel_fmt,
+                                                                             frame, offset)
+        offset += DPSMassTransferStream.tunnel_size
+        pip_tuple_list = []
+        for i in range(pip_count):
+            pip_type, pip_packed = struct.unpack_from(DPSMassTransferStream.pip_fmt, frame, offset)
+            offset += DPSMassTransferStream.pip_size
+            pip_tuple_list.append((pip_type, DPSMassTransferStream.ip_value_get(pip_type, pip_packed)))
+        if fregister:
+            status = self.client_handler.Tunnel_Register(domain_id, vnid, client_type,
+                                                         DpsTransactionType.mass_transfer,
+                                                         host_type, host_packed, host_port,
+                                                         pip_tuple_list)
+        else:
+            status = self.client_handler.Tunnel_Unregister(domain_id, vnid, client_type,
+                                                           pip_tuple_list)
+        return (status, offset)
+
+    def stream_endpoint_apply(self, domain_id, frame, offset):
+        '''
+        This routine applies an endpoint record of a bulk stream
+        @return: (status, offset of next record)
+        @rtype: (Integer, Integer)
+        '''
+        (record_type, vnid, dvg_id, client_type, version, operation,
+         host_type, host_port, host_packed, pip_type, pip_packed,
+         vMac, vIP_type, vIP_packed) = struct.unpack_from(DPSMassTransferStream.endpoint_fmt,
+                                                          frame, offset)
+        offset += DPSMassTransferStream.endpoint_size
+        ret_val = self.client_handler.Endpoint_Update(domain_id, vnid, dvg_id, client_type,
+                                                      DpsTransactionType.mass_transfer,
+                                                      host_type, host_packed, host_port,
+                                                      pip_type, pip_packed,
+                                                      vMac, vIP_type, vIP_packed,
+                                                      operation, version)
+        return (ret_val[0], offset)
+
+    def stream_multicast_apply(self, domain_id, frame, offset):
+        '''
+        This routine applies a multicast record of a bulk stream
+        @return: (status, offset of next record)
+        @rtype: (Integer, Integer)
+        '''
+        (record_type, vnid, fsender, fregister, client_type, global_scope,
+         multicast_mac, multicast_ip_family, multicast_ip_packed,
+         tunnel_ip_family, tunnel_ip_packed) = struct.unpack_from(DPSMassTransferStream.multicast_fmt,
+                                                                  frame, offset)
+        offset += DPSMassTransferStream.multicast_size
+        if fsender:
+            if fregister:
+                routine = self.client_handler.Multicast_Sender_Register
+            else:
+                routine = self.client_handler.Multicast_Sender_Unregister
+            status = routine(domain_id, vnid, client_type, DpsTransactionType.mass_transfer,
+                             multicast_mac, multicast_ip_family, multicast_ip_packed,
+                             tunnel_ip_family, tunnel_ip_packed)
+        else:
+            if fregister:
+                routine = self.client_handler.Multicast_Receiver_Register
+            else:
+                routine = self.client_handler.Multicast_Receiver_Unregister
+            status = routine(domain_id, vnid, client_type, DpsTransactionType.mass_transfer,
+                             global_scope, multicast_mac, multicast_ip_family,
+                             multicast_ip_packed, tunnel_ip_family, tunnel_ip_packed)
+        return (status, offset)
+
+    def stream_list_status(self, domain_id, record_type, ret_val):
+        '''
+        This routine converts the status of applying an entry of a VNID,
+        Policy or Subnet record. Like the JSON REST handlers the entries
+        are applied one after the other, an entry that cannot be applied
+        is logged and the remaining entries are applied.
+        @return: The status in DpsClientHandler terms
+        @rtype: Integer
+        '''
+        if ret_val == DOVEStatus.DOVE_STATUS_RETRY:
+            return DpsClientHandler.dps_error_retry
+        if ret_val != DOVEStatus.DOVE_STATUS_OK:
+            message = 'Domain %s: Mass Transfer Stream record type %s status %s'%(domain_id,
+                                                                                  record_type,
+                                                                                  ret_val)
+            dcslib.dps_cluster_write_log(DpsLogLevels.NOTICE, message)
+        return DpsClientHandler.dps_error_none
+
+    def stream_vnids_apply(self, domain_id, frame, offset):
+        '''
+        This routine applies a VNID record of a bulk stream
+        @return: (status, offset of next record)
+        @rtype: (Integer, Integer)
+        '''
+        (record_type, add, count) = struct.unpack_from(DPSMassTransferStream.list_fmt,
+                                                       frame, offset)
+        offset += DPSMassTransferStream.list_size
+        status = DpsClientHandler.dps_error_none
+        for i in range(count):
+            vnid = struct.unpack_from(DPSMassTransferStream.vnid_fmt, frame, offset)[0]
+            offset += DPSMassTransferStream.vnid_size
+            if add:
+                ret_val = self.controller_handler.Dvg_Add(domain_id, vnid)
+            else:
+                ret_val = self.controller_handler.Dvg_Delete(vnid)
+            status = self.stream_list_status(domain_id, record_type, ret_val)
+            if status != DpsClientHandler.dps_error_none:
+                break
+        return (status, offset)
+
+    def stream_policies_apply(self, domain_id, frame, offset):
+        '''
+        This routine applies a Policy record of a bulk stream
+        @return: (status, offset of next record)
+        @rtype: (Integer, Integer)
+        '''
+        (record_type, add, count) = struct.unpack_from(DPSMassTransferStream.list_fmt,
+                                                       frame, offset)
+        offset += DPSMassTransferStream.list_size
+        status = DpsClientHandler.dps_error_none
+        for i in range(count):
+            (traffic_type, policy_type, src_dvg, dst_dvg,
+             ttl, action) = struct.unpack_from(DPSMassTransferStream.policy_fmt, frame, offset)
+            offset += DPSMassTransferStream.policy_size
+            if add:
+                if action != Policy.action_drop:
+                    action = Policy.action_forward
+                action_packed = struct.pack(Policy.fmt_action_struct_hdr, 1, 0, action)
+                ret_val = self.controller_handler.Policy_Add(traffic_type, domain_id, policy_type,
+                                                             src_dvg, dst_dvg, ttl, action_packed)
+            else:
+                ret_val = self.controller_handler.Policy_Delete(traffic_type, domain_id,
+                                                                src_dvg, dst_dvg)
+            status = self.stream_list_status(domain_id, record_type, ret_val)
+            if status != DpsClientHandler.dps_error_none:
+                break
+        return (status, offset)
+
+    def stream_subnets_apply(self, domain_id, frame, offset):
+        '''
+        This routine applies an IPv4 Subnet record of a bulk stream
+        @return: (status, offset of next record)
+        @rtype: (Integer, Integer)
+        '''
+        (record_type, add, count) = struct.unpack_from(DPSMassTransferStream.list_fmt,
+                                                       frame, offset)
+        offset += DPSMassTransferStream.list_size
+        status = DpsClientHandler.dps_error_none
+        for i in range(count):
+            (vnid, ip_packed, mask_packed,
+             gwy_packed, mode) = struct.unpack_from(DPSMassTransferStream.subnet_fmt, frame, offset)
+            offset += DPSMassTransferStream.subnet_size
+            if vnid == 0:
+                associated_type = IPSUBNETAssociatedType.IP_SUBNET_ASSOCIATED_TYPE_DOMAIN
+                associated_id = domain_id
+            else:
+                associated_type = IPSUBNETAssociatedType.IP_SUBNET_ASSOCIATED_TYPE_VNID
+                associated_id = vnid
+            ip_value = DPSMassTransferStream.ip_value_get(socket.AF_INET, ip_packed)
+            mask_value = DPSMassTransferStream.ip_value_get(socket.AF_INET, mask_packed)
+            if add:
+                ret_val = self.controller_handler.IP_Subnet_Add(associated_type, associated_id,
+                                                                socket.AF_INET, ip_value, mask_value, mode,
+                                                                DPSMassTransferStream.ip_value_get(socket.AF_INET,
+                                                                                                   gwy_packed))
+            else:
+                ret_val = self.controller_handler.IP_Subnet_Delete(associated_type, associated_id,
+                                                                   socket.AF_INET, ip_value, mask_value)
+            status = self.stream_list_status(domain_id, record_type, ret_val)
+            if status != DpsClientHandler.dps_error_none:
+                break
+        return (status, offset)
+
+    def stream_received_add(self, stream_key, curr_time):
+        '''
+        This routine starts tracking an incoming stream. The streams that
+        have been idle for stream_received_timeout are dropped first, if the
+        table is still full the least recently active stream is dropped.
+        @attention: This routine assumes that the calling routine has the 
+                    mass_transfer_lock held.
+        @param stream_key: (Node Nonce, Domain ID, Stream ID)
+        @type stream_key: Tuple
+        @param curr_time: The current time
+        @type curr_time: Float
+        '''
+        if len(self.Stream_Received) >= self.stream_received_max:
+            for key, value in self.Stream_Received.items():
+                if curr_time - value[1] > self.stream_received_timeout:
+                    del self.Stream_Received[key]
+        if len(self.Stream_Received) >= self.stream_received_max:
+            key_oldest = None
+            time_oldest = curr_time
+            for key, value in self.Stream_Received.items():
+                if value[1] <= time_oldest:
+                    key_oldest = key
+                    time_oldest = value[1]
+            if key_oldest is not None:
+                del self.Stream_Received[key_oldest]
+        self.Stream_Received[stream_key] = (0, curr_time)
+        return
+
+    def Stream_Frame_Receive(self, domain_id, frame):
+        '''
+        Handle a frame of a bulk stream from another DPS Node. Frames are
+        applied in sequence number order, duplicates and frames after a gap
+        are dropped. The reply is a cumulative ACK which lets the sender
+        resume from the last frame applied. A frame of a stream that isn't
+        known, other than the first one, is answered with
+        dps_error_invalid_query_id so that the sender starts over. A frame
+        with sequence number 0 closes the stream.
+        @attention: This routine MUST be called from C code only
+        @param domain_id: The Domain ID
+        @type domain_id: Integer
+        @param frame: The frame
+        @type frame: ByteArray
+        @return: (stream_id, last applied sequence number, status)
+        @rtype: (Integer, Integer, Integer)
+        '''
+        status = DpsClientHandler.dps_error_none
+        try:
+            nonce, stream_id, seq, count = struct.unpack_from(DPSMassTransferStream.header_fmt, frame, 0)
+        except Exception:
+            return (0, 0, DpsClientHandler.dps_error_no_memory)
+        stream_key = (nonce, domain_id, stream_id)
+        curr_time = time.time()
+        DpsCollection.mass_transfer_lock.acquire()
+        try:
+            ack_seq = self.Stream_Received[stream_key][0]
+            if seq == 0:
+                #The sender closed the stream
+                del self.Stream_Received[stream_key]
+            else:
+                self.Stream_Received[stream_key] = (ack_seq, curr_time)
+        except Exception:
+            ack_seq = 0
+            if seq == 1:
+                self.stream_received_add(stream_key, curr_time)
+            elif seq != 0:
+                #Forgotten stream, the sender must start it over
+                status = DpsClientHandler.dps_error_invalid_query_id
+        DpsCollection.mass_transfer_lock.release()
+        if seq == 0 or status != DpsClientHandler.dps_error_none:
+            return (stream_id, ack_seq, status)
+        if seq != ack_seq + 1:
+            #Duplicate or Out of Order
+            return (stream_id, ack_seq, status)
+        offset = DPSMassTransferStream.header_size
+        for i in range(count):
+            try:
+                record_type = struct.unpack_from('!B', frame, offset)[0]
+                ret_val, offset = self.stream_record[record_type](domain_id, frame, offset)
+            except Exception, ex:
+                message = 'Domain %s: Mass Transfer Stream %s frame %s record %s Exception [%s]'%(domain_id,
+                                                                                                   stream_id,
+                                                                                                   seq, i, ex)
+                dcslib.dps_cluster_write_log(DpsLogLevels.WARNING, message)
+                status = DpsClientHandler.dps_error_no_memory
+                break
+            if ret_val == DpsClientHandler.dps_error_retry:
+                #Let the sender resend this frame
+                status = ret_val
+                break
+        if status == DpsClientHandler.dps_error_none:
+            ack_seq = seq
+            DpsCollection.mass_transfer_lock.acquire()
+            if self.Stream_Received.has_key(stream_key):
+                self.Stream_Received[stream_key] = (ack_seq, time.time())
+            DpsCollection.mass_transfer_lock.release()
+        return (stream_id, ack_seq, status)
@@ -16,9 +16,12 @@ log = getLogger(__name__)
 import Queue #renamed to queue in Python 3.0
 import threading
 import struct
+import time
 from threading import Thread
 from threading import Lock
 
+import dcslib
+
 class DOVEGatewayTypes:
     '''
     This class contains the various types of gateway 
@@ -179,6 +182,69 @@ class cluster_heartbeat_request_worker_thread(Thread):
             self.queue.task_done()
         log.warning('cluster_heartbeat_request_worker_thread: Exiting...!\r')
 
+class mass_transfer_scheduler_thread(Thread):
+    """
+    This is the thread that shares the Mass Transfer budget among all the
+    Domains being transferred from this node. Every tick the budget is
+    topped up and handed out as frames, to the Domain with the highest
+    priority first. The frames are sent by the DCS REST client worker
+    threads, one per remote node.
+    """
+
+    def __init__(self, transfers, lock, event, frames_per_sec, frames_burst, tick):
+        """
+        @param transfers: The Mass Transfers to schedule. Each has a priority
+                          (lower is more urgent) and a routine stream_schedule
+                          which sends upto the given number of frames.
+        @type transfers: Dictionary
+        @param lock: The lock protecting transfers
+        @type lock: threading.Lock
+        @param event: Set to run the scheduler before the tick expires
+        @type event: threading.Event
+        @param frames_per_sec: The budget of frames per second
+        @type frames_per_sec: Integer
+        @param frames_burst: The maximum budget that can be saved up
+        @type frames_burst: Integer
+        @param tick: The time between scheduling rounds in seconds
+        @type tick: Float
+        """
+        Thread.__init__(self)
+        self.transfers = transfers
+        self.lock = lock
+        self.event = event
+        self.frames_per_sec = frames_per_sec
+        self.frames_burst = frames_burst
+        self.tick = tick
+        self.setDaemon(True)
+
+    def run(self):
+        """
+        This is the worker thread that hands out the frame budget.
+        """
+        tokens = 0.0
+        last = time.time()
+        while True:
+            self.event.wait(self.tick)
+            self.event.clear()
+            now = time.time()
+            tokens = min(tokens + (now - last) * self.frames_per_sec, self.frames_burst)
+            last = now
+            if tokens < 1:
+                continue
+            self.lock.acquire()
+            transfers = self.transfers.values()
+            self.lock.release()
+            transfers.sort(key = lambda transfer: transfer.priority)
+            for transfer in transfers:
+                try:
+                    tokens -= transfer.stream_schedule(int(tokens))
+                except Exception, ex:
+                    message = 'mass_transfer_scheduler_thread: Domain %s, Exception %s'%(transfer.domain.unique_id, ex)
+                    dcslib.dps_cluster_write_log(DpsLogLevels.WARNING, message)
+                if tokens < 1:
+                    break
+        log.warning('mass_transfer_scheduler_thread: Exiting...!\r')
+
 def mac_bytes(mac_string):
     '''
     Returns the byte array representing a MAC String.
@@ -204,6 +270,191 @@ def mac_show(mac):
     return '%x:%x:%x:%x:%x:%x'%(ord(mac[0]), ord(mac[1]), ord(mac[2]),
                                 ord(mac[3]), ord(mac[4]), ord(mac[5]))
 
+class DpsGlobalLock(object):
+    '''
+    The global lock for the runtime database. It can be held in 2 modes:
+    1. Exclusive: acquire()/release(). This is how the lock has always been
+       used and it MUST be used by routines which change the Domain_Hash,
+       VNID_Hash or walk objects belonging to more than 1 Domain.
+    2. Shared: acquire_shared()/release_shared(). Routines which work on a
+       single Domain hold the global lock shared together with the Domain
+       lock (see DpsCollection.domain_lock_acquire) so that independent
+       Domains don't contend with each other.
+    Exclusive waiters are preferred over new shared holders so that the
+    timer routines are not starved. The shared mode can be nested and can
+    be taken by a thread already holding the lock exclusively.
+    @attention: Lock Hierarchy
+                1. DpsCollection.global_lock
+                2. Domain Object Lock
+                3. DpsCollection.counter_lock, DPSClientHost.lock,
+                   DpsTimerWheel lock
+    '''
+    def __init__(self):
+        self.cond = threading.Condition(Lock())
+        self.shared = 0
+        self.exclusive_owner = None
+        self.exclusive_waiting = 0
+        self.local = threading.local()
+
+    def acquire(self):
+        '''
+        Takes the lock exclusively
+        '''
+        self.cond.acquire()
+        self.exclusive_waiting += 1
+        while self.exclusive_owner is not None or self.shared > 0:
+            self.cond.wait()
+        self.exclusive_waiting -= 1
+        self.exclusive_owner = threading.current_thread()
+        self.cond.release()
+        return
+
+    def release(self):
+        '''
+        Releases the exclusively held lock
+        '''
+        self.cond.acquire()
+        self.exclusive_owner = None
+        self.cond.notifyAll()
+        self.cond.release()
+        return
+
+    def acquire_shared(self):
+        '''
+        Takes the lock shared
+        '''
+        depth = getattr(self.local, 'depth', 0)
+        if depth == 0:
+            if self.exclusive_owner is threading.current_thread():
+                self.local.counted = False
+            else:
+                self.cond.acquire()
+                while self.exclusive_owner is not None or self.exclusive_waiting > 0:
+                    self.cond.wait()
+                self.shared += 1
+                self.cond.release()
+                self.local.counted = True
+        self.local.depth = depth + 1
+        return
+
+    def release_shared(self):
+        '''
+        Releases the shared lock
+        '''
+        self.local.depth -= 1
+        if self.local.depth > 0 or not self.local.counted:
+            return
+        self.cond.acquire()
+        self.shared -= 1
+        if self.shared == 0:
+            self.cond.notifyAll()
+        self.cond.release()
+        return
+
+class DpsTimerWheel(object):
+    '''
+    A timing wheel advanced once every Protocol Timer tick. An object that
+    must time out in n ticks is put in the slot n ticks ahead of the
+    current one, with the number of times the wheel must go round before
+    it expires. Starting and stopping a timer are O(1) and a tick only
+    looks at the objects in one slot.
+    Objects on the wheel must have a timer_expire() routine which is
+    called by the owner of the wheel for every object that expired.
+    '''
+    def __init__(self, size):
+        '''
+        Constructor:
+        @param size: The number of slots
+        @type size: Integer
+        '''
+        #Each slot is {object: rounds left}
+        self.slots = []
+        for i in range(size):
+            self.slots.append({})
+        self.current = 0
+        #{object: slot} of all the objects on the wheel
+        self.timers = {}
+        #Objects are put on the wheel by holders of different Domain locks
+        self.lock = Lock()
+
+    def start(self, obj, ticks):
+        '''
+        Starts (or restarts) the timer of an object
+        @param obj: The object
+        @type obj: Any object with a timer_expire() routine
+        @param ticks: The number of ticks after which the object expires (>= 1)
+        @type ticks: Integer
+        '''
+        if ticks < 1:
+            ticks = 1
+        size = len(self.slots)
+        self.lock.acquire()
+        try:
+            del self.slots[self.timers[obj]][obj]
+        except Exception:
+            pass
+        slot = (self.current + ticks) % size
+        self.slots[slot][obj] = (ticks - 1)/size
+        self.timers[obj] = slot
+        self.lock.release()
+        return
+
+    def stop(self, obj):
+        '''
+        Stops the timer of an object
+        @param obj: The object
+        @type obj: Any object
+        @return: True if the timer was running
+        @rtype: Boolean
+        '''
+        self.lock.acquire()
+        try:
+            slot = self.timers[obj]
+            del self.timers[obj]
+            del self.slots[slot][obj]
+            running = True
+        except Exception:
+            running = False
+        self.lock.release()
+        return running
+
+    def running(self, obj):
+        '''
+        @param obj: The object
+        @type obj: Any object
+        @return: True if the timer of the object is running
+        @rtype: Boolean
+        '''
+        return self.timers.has_key(obj)
+
+    def count(self):
+        '''
+        @return: The number of timers running
+        @rtype: Integer
+        '''
+        return len(self.timers)
+
+    def tick(self):
+        '''
+        Advances the wheel by one tick
+        @return: The objects that expired. Their timer_expire() routine
+                 must be called by the caller.
+        @rtype: List
+        '''
+        expired = []
+        self.lock.acquire()
+        self.current = (self.current + 1) % len(self.slots)
+        slot = self.slots[self.current]
+        for obj, rounds in slot.items():
+            if rounds > 0:
+                slot[obj] = rounds - 1
+                continue
+            del slot[obj]
+            del self.timers[obj]
+            expired.append(obj)
+        self.lock.release()
+        return expired
+
 class DpsCollection(object):
     '''
     This class contains all the collection
@@ -247,7 +498,9 @@ class DpsCollection(object):
     Domain_Replication_Requests = {}
     #Count of Endpoints Registered
     Endpoints_Count = 0
-    Endpoints_Count_Max = 400000
+    #Endpoints are slotted objects (about a quarter of the memory a
+    #__dict__ based object took), so the same memory holds 4 times more
+    Endpoints_Count_Max = 1600000
     Endpoints_vIP_Max = 8
     policy_all_max_per_datagram = 1000
     #A queue for sending Policy Updates in a Domain
@@ -287,21 +540,16 @@ class DpsCollection(object):
     #failure in Broadcast Updates,Collection of (DVG,DPSClient) Tuples. 
     #Indexed by "DVG_ID,DPSClient.IPvalue"
     VNID_Multicast_Updates_To = {}
-    #Collection of Address Resolution requests waiting to be resolved.
-    Address_Resolution_Requests = {}
     #Collection of Address Resolution which need to be retransmitted
     Address_Resolution_Requests_To = {}
-    #Collection of Conflict Resolution requests waiting to be resolved
-    Conflict_Detection_Requests = {}
     #The Maximum number of Pending Messages per failure
     Max_Pending_Queue_Size = 256
-    #Endpoint Expiration Timer List. Endpoint which are "deleted" from a tunnel 
-    #will be put on this timer list for a max of 2 iterations in the protocol 
-    #timer to see if endpoint has vmotioned to another host. This will help us preserve
-    #the vIPs of the Endpoint from the previous incarnation.
-    Endpoint_Expiration_Timer_Queue = {}
-    #Maximum number of endpoints in limbo at a given time
-    Max_Endpoint_Timer_Queue_Length = 8192
+    #The Timers of the DPS Client Server Protocol, advanced by the Protocol
+    #Timer: Address Resolutions and Conflict Detections waiting to be
+    #resolved, and Endpoints which are "deleted" from a tunnel waiting to
+    #see if the endpoint has vmotioned to another host. This will help us
+    #preserve the vIPs of the Endpoint from the previous incarnation.
+    Timer_Wheel = DpsTimerWheel(64)
     #The Mapping of Mass Transfer Query IDs to DPS Mass Transfer Objects
     #Key = Query ID, Value = DPSMassTransfer Object
     MassTransfer_QueryID_Mapping = {}
@@ -311,6 +559,23 @@ class DpsCollection(object):
     MassTransfer_Max = 100
     #Mass transfer lock
     mass_transfer_lock = threading.Lock()
+    #Mass Transfers whose frames are sent by the scheduler.
+    #Key = Domain ID, Value = DPSDomainMassTransfer Object
+    MassTransfer_Scheduled = {}
+    #The budget shared by all Mass Transfers from this node. A frame carries
+    #upto 1000 objects, so this bounds the load put on the remote nodes and
+    #the time this node spends away from lookups.
+    MassTransfer_Frames_Per_Sec = 40
+    MassTransfer_Frames_Burst = 8
+    MassTransfer_Tick = 0.1
+    MassTransfer_Schedule_Event = threading.Event()
+    mass_transfer_scheduler = mass_transfer_scheduler_thread(MassTransfer_Scheduled,
+                                                             mass_transfer_lock,
+                                                             MassTransfer_Schedule_Event,
+                                                             MassTransfer_Frames_Per_Sec,
+                                                             MassTransfer_Frames_Burst,
+                                                             MassTransfer_Tick)
+    mass_transfer_scheduler.start()
     #Mass transfer get ready list. Collection of Domains which are expecting
     #to be transferred over. The value represent the time when the Get Ready
     #was issued
@@ -318,7 +583,10 @@ class DpsCollection(object):
     #A Global Counter and Lock for the runtime database
     QueryID = 1
     MaxQueryID = 2147483647
-    global_lock = threading.Lock()
+    global_lock = DpsGlobalLock()
+    #Protects the global counters which are updated by holders of
+    #different Domain locks
+    counter_lock = threading.Lock()
     #Collection of Query IDs and corresponding messages
     Query_ID_Hash = {}
 
@@ -328,12 +596,81 @@ class DpsCollection(object):
         This routine generates a query id that the DCS Server can use
         @return: 
         '''
+        cls.counter_lock.acquire()
         ret_val = cls.QueryID
         cls.QueryID += 1
         if cls.QueryID >= cls.MaxQueryID:
             cls.QueryID = 1
+        cls.counter_lock.release()
         return ret_val
 
+    @classmethod
+    def endpoints_count_update(cls, delta):
+        '''
+        This routine updates the count of Endpoints Registered
+        @param delta: The change in the count
+        @type delta: Integer
+        '''
+        cls.counter_lock.acquire()
+        cls.Endpoints_Count += delta
+        cls.counter_lock.release()
+        return
+
+    @classmethod
+    def domain_lock_acquire(cls, domain_id):
+        '''
+        This routine takes the global lock shared and the lock of the Domain.
+        It should be used by routines which only work on a single Domain.
+        @attention: The global lock must NOT be held when this routine is
+                    called. Call domain_lock_release with the returned value
+                    irrespective of whether the Domain was found.
+        @param domain_id: The Domain ID
+        @type domain_id: Integer
+        @return: The Domain Object or None if the Domain doesn't exist
+        @rtype: Domain
+        '''
+        cls.global_lock.acquire_shared()
+        try:
+            domain = cls.Domain_Hash[domain_id]
+        except Exception:
+            return None
+        domain.lock.acquire()
+        return domain
+
+    @classmethod
+    def vnid_domain_lock_acquire(cls, vnid):
+        '''
+        This routine takes the global lock shared and the lock of the Domain
+        which handles the VNID.
+        @attention: The global lock must NOT be held when this routine is
+                    called. Call domain_lock_release with the returned value
+                    irrespective of whether the Domain was found.
+        @param vnid: The VNID
+        @type vnid: Integer
+        @return: The Domain Object or None if the Domain doesn't exist
+        @rtype: Domain
+        '''
+        cls.global_lock.acquire_shared()
+        try:
+            domain = cls.Domain_Hash[cls.VNID_Hash[vnid]]
+        except Exception:
+            return None
+        domain.lock.acquire()
+        return domain
+
+    @classmethod
+    def domain_lock_release(cls, domain):
+        '''
+        This routine releases the locks taken by domain_lock_acquire or
+        vnid_domain_lock_acquire
+        @param domain: The Domain Object returned by the acquire routine
+        @type domain: Domain or None
+        '''
+        if domain is not None:
+            domain.lock.release()
+        cls.global_lock.release_shared()
+        return
+
 class DOVEStatus:
     '''
     This class contains the DOVE Status Error Codes
@@ -379,6 +379,29 @@ class DPSReplicationTracker(object):
         self.lock.release()
         return (status, dps_nodes, query_ids)
 
+    def ReplicationNodes(self, msg_domain_id):
+        '''
+        This routine determines the DCS Servers (including Local) that the
+        Endpoint Updates of a Domain are replicated to on the Replication
+        Channels. The replies are tracked by the C code.
+        @attention: DO NOT IMPORT THIS FUNCTION FROM PYTHON CODE
+        @param msg_domain_id: The Domain ID in the messages
+        @type msg_domain_id: Integer
+        @return: (DOVEStatus, List of DCS Servers to replicate to)
+        @return: Each DCS Server in list is a tuple of (inet_type, ip_packed, port)
+        '''
+        self.lock.acquire()
+        try:
+            status, dps_nodes = self.ReplicationDetermineDPSNodesPYTHON(msg_domain_id,
+                                                                        DpsTransactionType.normal)
+        except Exception, ex:
+            message ='DCS: Force registration retry [%s]'%(ex)
+            dcslib.dps_data_write_log(DpsLogLevels.INFO, message)
+            status = DpsClientHandler.dps_error_retry
+            dps_nodes = []
+        self.lock.release()
+        return (status, dps_nodes)
+
     def ReplicationReplyProcess(self, replication_query_id, dps_protocol_status):
         '''
         This routine process the Replication Reply Message
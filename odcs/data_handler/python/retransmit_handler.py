@@ -97,10 +97,7 @@ class DPSRetransmitHandler:
         '''
         This routine generates a system wide unique id
         '''
-        DpsCollection.global_lock.acquire()
-        query_id = DpsCollection.generate_query_id()
-        DpsCollection.global_lock.release()
-        return query_id
+        return DpsCollection.generate_query_id()
 
     def Timer_Routine(self):
         '''
@@ -68,6 +68,7 @@ class DpsStatisticsHandler(object):
         while True:
             try:
                 domain_obj = self.Domain_Hash[domain_id]
+                domain_obj.endpoint_lookup_count_update()
                 index = len(domain_obj.Stats_Array) - 1
                 domain_obj.Endpoint_Update_Count_Delta = (domain_obj.Endpoint_Update_Count - 
                                                           domain_obj.Stats_Array[index][1])
@@ -140,6 +141,7 @@ class DpsStatisticsHandler(object):
         while True:
             try:
                 domain_obj = self.Domain_Hash[domain_id]
+                domain_obj.endpoint_lookup_count_update()
                 eu_count = domain_obj.Endpoint_Update_Count
                 el_count = domain_obj.Endpoint_Lookup_Count
                 pl_count = domain_obj.Policy_Lookup_Count
@@ -71,6 +71,18 @@ int PythonMulticastDataHandlerLogLevel = DPS_SERVER_LOGLEVEL_NOTICE;
  */
 #define PYTHON_FUNC_ENDPOINT_REQUEST_vMac "Endpoint_Location_vMac"
 
+/**
+ * \brief The PYTHON function that handles a batch of Endpoint Location
+ *        Requests
+ */
+#define PYTHON_FUNC_ENDPOINT_REQUEST_BATCH "Endpoint_Location_Batch"
+
+/**
+ * \brief The PYTHON function that applies a batch of replicated Endpoint
+ *        Updates
+ */
+#define PYTHON_FUNC_ENDPOINT_UPDATE_BATCH "Endpoint_Update_Batch"
+
 /**
  * \brief The PYTHON function that handles Policy Resolution 
  *        Request for vMac
@@ -196,6 +208,14 @@ typedef struct python_dps_client_protocol_s{
 	 * \brief The function that Endpoint_Location_vMac
 	 */
 	PyObject *Endpoint_Location_vMac;
+	/*
+	 * \brief The function that Endpoint_Location_Batch
+	 */
+	PyObject *Endpoint_Location_Batch;
+	/*
+	 * \brief The function that Endpoint_Update_Batch
+	 */
+	PyObject *Endpoint_Update_Batch;
 	/*
 	 * \brief The function that Policy_Resolution_vIP
 	 */
@@ -303,6 +323,12 @@ static python_dps_client_protocol_t Client_Protocol_Interface;
  */
 #define PYTHON_REPLICATION_REPLY_PROCESS "ReplicationReplyProcess"
 
+/**
+ * \brief The PYTHON function to determine the nodes of the Replication
+ *        Channels
+ */
+#define PYTHON_REPLICATION_NODES "ReplicationNodes"
+
 /**
  * \brief The Replication handler function pointers data structure
  */
@@ -320,6 +346,11 @@ typedef struct python_dps_replication_s{
 	 * \brief The PYTHON function to process Replication
 	 */
 	PyObject *ReplicationReplyProcess;
+	/*
+	 * \brief The PYTHON function to determine the nodes of the Replication
+	 *        Channels
+	 */
+	PyObject *ReplicationNodes;
 }python_dps_replication_t;
 
 /*
@@ -342,6 +373,16 @@ static python_dps_replication_t Replication_Interface;
  */
 #define PYTHON_MASS_TRANSFER_ACK "Transfer_Ack"
 
+/**
+ * \brief The PYTHON function to Process the Mass Transfer Stream ACKs
+ */
+#define PYTHON_MASS_TRANSFER_STREAM_ACK "Stream_Ack"
+
+/**
+ * \brief The PYTHON function to Apply a received Mass Transfer Stream Frame
+ */
+#define PYTHON_MASS_TRANSFER_STREAM_FRAME_RECEIVE "Stream_Frame_Receive"
+
 /**
  * \brief The Mass Transfer handler function pointers data structure
  */
@@ -355,6 +396,14 @@ typedef struct python_dps_mass_transfer_s{
 	 * \brief The PYTHON function to Transfer_Ack
 	 */
 	PyObject *Transfer_Ack;
+	/*
+	 * \brief The PYTHON function to Stream_Ack
+	 */
+	PyObject *Stream_Ack;
+	/*
+	 * \brief The PYTHON function to Stream_Frame_Receive
+	 */
+	PyObject *Stream_Frame_Receive;
 }python_dps_mass_transfer_t;
 
 /**
@@ -428,15 +477,64 @@ int outstanding_unsolicited_msg_count = 0;
  */
 static uint8_t send_buff_py[SEND_BUFF_SIZE];
 /**
- * \brief To be used by calls from the DPS Protocol Handler Thread
+ * \brief To be used by calls from the DPS Protocol Handler Threads. There
+ *        can be several of those threads so every thread gets its own
+ *        buffer, see dps_protocol_send_buff_get.
+ */
+static pthread_key_t send_buff_key;
+static pthread_once_t send_buff_key_once = PTHREAD_ONCE_INIT;
+
+/**
+ * \brief The maximum number of Endpoint Location Requests (Endpoint Updates)
+ *        handed to PYTHON in a single Endpoint_Location_Batch
+ *        (Endpoint_Update_Batch) call
+ */
+#define DPS_PROTOCOL_BATCH_SZ 64
+
+/**
+ * \brief An Endpoint Location Request held back in the batch
+ */
+typedef struct dps_protocol_batch_entry_s {
+	uint32_t domain;
+	dps_client_hdr_t hdr;
+	dps_endpoint_loc_req_t endpoint_loc_req;
+} dps_protocol_batch_entry_t;
+
+/**
+ * \brief An Endpoint Update held back in the batch
  */
-static uint8_t send_buff[SEND_BUFF_SIZE];
+typedef struct dps_protocol_batch_update_s {
+	uint32_t domain;
+	dps_client_hdr_t hdr;
+	dps_endpoint_update_t endpoint_update;
+	/**
+	 * \brief The following are only valid while the batch is flushed
+	 */
+	dps_client_data_t *reply;
+	uint32_t ret_code;
+	uint32_t shared_address;
+} dps_protocol_batch_update_t;
 
 /**
- * \brief Buffer to store Endpoint Update Addresses
+ * \brief The batch of a DPS Protocol Handler Thread, see
+ *        dps_protocol_server_batch_start
  */
-#define MAX_VIP_ADDRESS 32
-static ip_addr_t vIP_address[MAX_VIP_ADDRESS];
+typedef struct dps_protocol_batch_s {
+	int active;
+	/**
+	 * \brief Set while the Endpoint Updates are flushed. The Endpoint
+	 *        Updates sent to the Shared Address Space at that time are
+	 *        handled one by one.
+	 */
+	int flushing;
+	uint32_t count;
+	dps_protocol_batch_entry_t entries[DPS_PROTOCOL_BATCH_SZ];
+	uint32_t update_count;
+	dps_protocol_batch_update_t updates[DPS_PROTOCOL_BATCH_SZ];
+} dps_protocol_batch_t;
+
+static pthread_key_t batch_key;
+static pthread_once_t batch_key_once = PTHREAD_ONCE_INIT;
 
 #define MAX_REPLICATION_COUNT 8
 
@@ -457,6 +555,64 @@ static ip_addr_t vIP_address[MAX_VIP_ADDRESS];
  */
 int Hash_Perf_Test_CLI = 0;
 
+/*
+ ******************************************************************************
+ * send_buff_key_create --                                                *//**
+ *
+ * \brief Creates the key holding the per thread send buffer
+ *
+ ******************************************************************************/
+
+static void send_buff_key_create(void)
+{
+	pthread_key_create(&send_buff_key, free);
+	return;
+}
+
+/*
+ ******************************************************************************
+ * batch_key_create --                                                    *//**
+ *
+ * \brief Creates the key holding the per thread Endpoint Location and
+ *        Endpoint Update batch
+ *
+ ******************************************************************************/
+
+static void batch_key_create(void)
+{
+	pthread_key_create(&batch_key, free);
+	return;
+}
+
+/*
+ ******************************************************************************
+ * dps_protocol_send_buff_get --                                          *//**
+ *
+ * \brief Returns the send buffer of the calling DPS Protocol Handler Thread.
+ *        The buffer is allocated on first use and freed when the thread
+ *        exits.
+ *
+ * \return Pointer to a SEND_BUFF_SIZE buffer, NULL if no memory
+ *
+ ******************************************************************************/
+
+static uint8_t *dps_protocol_send_buff_get(void)
+{
+	uint8_t *buff;
+
+	pthread_once(&send_buff_key_once, send_buff_key_create);
+	buff = (uint8_t *)pthread_getspecific(send_buff_key);
+	if (buff == NULL)
+	{
+		buff = (uint8_t *)malloc(SEND_BUFF_SIZE);
+		if (buff != NULL)
+		{
+			pthread_setspecific(send_buff_key, buff);
+		}
+	}
+	return buff;
+}
+
 /*
  ******************************************************************************
  * dps_msg_send_inline --                                                 *//**
@@ -692,6 +848,7 @@ PyObject *send_gateways(PyObject *self, PyObject *args)
 {
 	int dps_client_ip_size, j;
 	uint32_t vnid, gwy_vnid, query_id, gateway_type;
+	uint32_t version = 0;
 	uint16_t dps_client_port;
 	char *dps_client_ip;
 	PyObject *ret_val;
@@ -712,14 +869,15 @@ PyObject *send_gateways(PyObject *self, PyObject *args)
 
 	do
 	{
-		if (!PyArg_ParseTuple(args, "z#HIIIOO",
+		if (!PyArg_ParseTuple(args, "z#HIIIOO|I",
 		                      &dps_client_ip, &dps_client_ip_size,
 		                      &dps_client_port,
 		                      &vnid,
 		                      &query_id,
 		                      &gateway_type,
 		                      &pyList_ipv4,
-		                      &pyList_ipv6))
+		                      &pyList_ipv6,
+		                      &version))
 		{
 			log_warn(PythonMulticastDataHandlerLogLevel, "Bad Data!!!");
 			break;
@@ -764,6 +922,7 @@ PyObject *send_gateways(PyObject *self, PyObject *args)
 		hdr->resp_status = DPS_NO_ERR;
 		hdr->query_id = query_id;
 		hdr->reply_addr.port = dps_client_port;
+		hdr->payload_version = version;
 		gw_data->num_of_tunnels = 0;
 	
 		j = 0;
@@ -1174,249 +1333,562 @@ PyObject *send_multicast_tunnels(PyObject *self, PyObject *args)
 
 /*
  ******************************************************************************
- * send_broadcast_table --                                                *//**
+ * broadcast_table_pack --                                                *//**
  *
- * \brief This is the routine that the PYTHON Scripts must call to send the
- *        broadcast table to a DPS Client
+ * \brief This is the routine that the PYTHON Scripts call to pack the
+ *        broadcast table of a VNID once, every time the table changes. The
+ *        packed table is the dps_pkd_tunnel_list_t starting at num_v4_tunnels
+ *        and is handed as is to send_broadcast_table and Broadcast_List.
+ *        def broadcast_table_pack(ipv4_list, ipv6_list)
  *
  * \param[in] self  PyObject
- * \param[in] args  The input must be the following:
+ * \param[in] args  The IPv4 and IPv6 Lists of DOVE Switches
  *
- * \retval 0 Success
- * \retval -1 Failure
+ * \return The packed table (String), None on failure
  *
  ******************************************************************************/
-PyObject *send_broadcast_table(PyObject *self, PyObject *args)
+PyObject *broadcast_table_pack(PyObject *self, PyObject *args)
 {
-	int dps_client_ip_size, j;
-	uint32_t vnid, query_id;
-	uint16_t dps_client_port;
-	char *dps_client_ip;
-	PyObject *ret_val;
-	PyObject *pyList_ipv4, *pyList_ipv6;
-	dps_client_data_t *client_data = (dps_client_data_t *)send_buff_py;
-	dps_client_hdr_t *hdr = &client_data->hdr;
-	dps_pkd_tunnel_list_t *switch_list = &((dps_client_data_t *)send_buff_py)->dove_switch_list;
+	PyObject *pyList_ipv4, *pyList_ipv6, *pyIP;
+	PyObject *ret_val = NULL;
+	dps_pkd_tunnel_list_t *switch_list;
+	size_t max_size, size;
+	Py_ssize_t i, num_v4, num_v6;
+	uint32_t j;
 	int ipv4, ipv6_size;
 	char *ipv6;
-	Py_ssize_t i;
-	PyObject *pyIP;
-	dps_return_status return_status = DPS_ERROR;
-	unsolicited_msg_context_t *pcontext;
-	char str[INET6_ADDRSTRLEN];
 
 	log_debug(PythonDataHandlerLogLevel, "Enter");
-	//Py_BEGIN_ALLOW_THREADS
 
 	do
 	{
-		if (!PyArg_ParseTuple(args, "z#HIIOO",
-		                      &dps_client_ip, &dps_client_ip_size,
-		                      &dps_client_port,
-		                      &vnid,
-		                      &query_id,
-		                      &pyList_ipv4,
-		                      &pyList_ipv6))
+		if (!PyArg_ParseTuple(args, "OO", &pyList_ipv4, &pyList_ipv6) ||
+		    !PyList_Check(pyList_ipv4) || !PyList_Check(pyList_ipv6))
 		{
 			log_warn(PythonDataHandlerLogLevel, "Bad Data!!!");
 			break;
 		}
-		if(!PyList_Check(pyList_ipv4) || !PyList_Check(pyList_ipv6))
+		num_v4 = PyList_Size(pyList_ipv4);
+		num_v6 = PyList_Size(pyList_ipv6);
+		// Whatever is packed must fit in a send buffer
+		max_size = SEND_BUFF_SIZE - dps_offsetof(dps_client_data_t,
+		                                         dove_switch_list.tunnel_list[0]);
+		size = (num_v4 + (num_v6 * 4)) * sizeof(uint32_t);
+		if (size > max_size)
 		{
-			log_warn(PythonDataHandlerLogLevel, "Not List Type!!!");
-			break;
+			log_alert(PythonDataHandlerLogLevel,
+			          "ALERT!!! Number of DOVE Switches %d exceeds Send Buffer %d max size",
+			          num_v4 + num_v6, SEND_BUFF_SIZE);
+			size = max_size;
 		}
-		if (dps_client_ip == NULL)
+		switch_list = (dps_pkd_tunnel_list_t *)malloc(sizeof(dps_pkd_tunnel_list_t) + size);
+		if (switch_list == NULL)
 		{
-			log_warn(PythonDataHandlerLogLevel, "Bad DPS Client IP Address!!!");
+			log_warn(PythonDataHandlerLogLevel, "No memory");
 			break;
 		}
-
-		log_info(PythonDataHandlerLogLevel,"VNID: %d, Broadcast Switches IPv4 %d, IPv6 %d",
-		         vnid, PyList_Size(pyList_ipv4), PyList_Size(pyList_ipv6));
-		hdr->type = DPS_UNSOLICITED_BCAST_LIST_REPLY;
-		hdr->client_id = DPS_POLICY_SERVER_ID;
-		hdr->transaction_type = DPS_TRANSACTION_NORMAL;
-		hdr->vnid = vnid;
-		hdr->resp_status = DPS_NO_ERR;
-		hdr->query_id = query_id;
-		hdr->reply_addr.port = dps_client_port;
 		switch_list->num_v4_tunnels = 0;
 		switch_list->num_v6_tunnels = 0;
-
 		j = 0;
-		for (i = 0; i < PyList_Size(pyList_ipv4); i++)
+		for (i = 0; i < num_v4; i++)
 		{
-			if (dps_offsetof(dps_client_data_t,
-			                 dove_switch_list.tunnel_list[j+1]) > SEND_BUFF_SIZE)
+			if ((j + 1) * sizeof(uint32_t) > size)
 			{
-				log_alert(PythonDataHandlerLogLevel,
-				          "ALERT!!! Number of DOVE Switches %d exceeds Send Buffer %d max size",
-				          PyList_Size(pyList_ipv4) + PyList_Size(pyList_ipv6),
-				          SEND_BUFF_SIZE
-				         );
 				break;
 			}
 			pyIP = PyList_GetItem(pyList_ipv4, i);
 			if (!PyArg_Parse(pyIP, "I", &ipv4))
 			{
+				PyErr_Clear();
 				log_warn(PythonDataHandlerLogLevel,
 				         "Invalid IPv4 in element %d", i);
 				continue;
 			}
-			inet_ntop(AF_INET, &ipv4, str, INET_ADDRSTRLEN);
-			log_info(PythonDataHandlerLogLevel,
-			         "[%d] Broadcast: DOVE Switch %s", i, str);
 			switch_list->tunnel_list[j++] = ntohl(ipv4);
 			switch_list->num_v4_tunnels++;
 		}
-		for (i = 0, j = 0; i < PyList_Size(pyList_ipv6); i++, j++)
+		for (i = 0; i < num_v6; i++)
 		{
-			if (dps_offsetof(dps_client_data_t,
-			                 dove_switch_list.tunnel_list[j+4]) > SEND_BUFF_SIZE)
+			if ((j + 4) * sizeof(uint32_t) > size)
 			{
-				log_alert(PythonDataHandlerLogLevel,
-				          "ALERT!!! Number of DOVE Switches %d exceeds Send Buffer %d max size",
-				          PyList_Size(pyList_ipv4) + PyList_Size(pyList_ipv6),
-				          SEND_BUFF_SIZE
-				         );
 				break;
 			}
 			pyIP = PyList_GetItem(pyList_ipv6, i);
-			if (!PyArg_Parse(pyIP, "z#", &ipv6, &ipv6_size))
+			if (!PyArg_Parse(pyIP, "z#", &ipv6, &ipv6_size) ||
+			    (ipv6 == NULL) || (ipv6_size != 16))
 			{
+				PyErr_Clear();
 				log_warn(PythonDataHandlerLogLevel,
 				         "Invalid IPv6 in element %d", i);
 				continue;
 			}
-			inet_ntop(AF_INET6, ipv6, str, INET6_ADDRSTRLEN);
-			log_info(PythonDataHandlerLogLevel,
-			         "[%d] Broadcast: DOVE Switch %s",
-			         switch_list->num_v4_tunnels+i, str);
-			memcpy((uint8_t *)(&switch_list->tunnel_list[j]), ipv6, ipv6_size);
+			memcpy((uint8_t *)(&switch_list->tunnel_list[j]), ipv6, 16);
 			switch_list->num_v6_tunnels++;
 			j += 4;
 		}
-//		if (Hash_Perf_Test_CLI)
-//		{
-//			break;
-//		}
-#if 1
-		pcontext = (unsolicited_msg_context_t *)malloc(sizeof(unsolicited_msg_context_t));
-		client_data->context = (void *)pcontext;
-		log_debug(PythonDataHandlerLogLevel,
-		          "Setting QueryID %d, Context %p",
-		          client_data->hdr.query_id,
-		          client_data->context);
-		if (pcontext != NULL)
-		{
-			outstanding_unsolicited_msg_count++;
-			pcontext->vnid_id = vnid;
-			pcontext->original_msg_type = client_data->hdr.type;
-			if (dps_client_ip_size == 4)
-			{
-				pcontext->dps_client_location.family = AF_INET;
-			}
-			else
-			{
-				pcontext->dps_client_location.family = AF_INET6;
-			}
-			pcontext->dps_client_location.port = dps_client_port;
-			memcpy(pcontext->dps_client_location.ip6, dps_client_ip, dps_client_ip_size);
-		}
-#else
-		client_data->context = NULL;
-#endif
-		if (dps_client_ip_size == 4)
-		{
-			inet_ntop(AF_INET, dps_client_ip, str, INET_ADDRSTRLEN);
-			// IPv4
-			log_info(PythonDataHandlerLogLevel,
-			         "DPS Client: IPv4 %s, Port %d", str, dps_client_port);
-			hdr->reply_addr.family = AF_INET;
-			hdr->reply_addr.ip4 = ntohl(*((uint32_t *)dps_client_ip));
-		}
-		else
-		{
-			// IPv6
-			inet_ntop(AF_INET6, dps_client_ip, str, INET6_ADDRSTRLEN);
-			log_info(PythonDataHandlerLogLevel,
-			         "DPS Client: pIPv6 %s, Port %d", str, dps_client_port);
-			hdr->reply_addr.family = AF_INET6;
-			memcpy(hdr->reply_addr.ip6, dps_client_ip, dps_client_ip_size);
-		}
-		return_status = dps_protocol_client_send(client_data);
-		if (return_status != DPS_SUCCESS)
-		{
-			log_info(PythonDataHandlerLogLevel,
-			         "dps_protocol_client_send returns failure");
-			free(client_data->context);
-			outstanding_unsolicited_msg_count--;
-		}
+		ret_val = Py_BuildValue("s#", (char *)&switch_list->num_v4_tunnels,
+		                        (int)(dps_offsetof(dps_pkd_tunnel_list_t, tunnel_list[j]) -
+		                              dps_offsetof(dps_pkd_tunnel_list_t, num_v4_tunnels)));
+		free(switch_list);
 	}while(0);
 
-	//Py_END_ALLOW_THREADS
-	ret_val = Py_BuildValue("i", return_status);
-	log_debug(PythonDataHandlerLogLevel, "Exit status %d", return_status);
+	if (ret_val == NULL)
+	{
+		PyErr_Clear();
+		Py_INCREF(Py_None);
+		ret_val = Py_None;
+	}
+	log_debug(PythonDataHandlerLogLevel, "Exit");
 
 	return ret_val;
 }
 
 /*
  ******************************************************************************
- * send_address_resolution --                                             *//**
+ * broadcast_table_unpack --                                              *//**
  *
- * \brief This is the routine that the PYTHON Scripts must call to send the
- *        address resolution request to a DPS Client
+ * \brief This routine copies a table packed by broadcast_table_pack into
+ *        the DOVE Switch List of a message in a send buffer.
+ *
+ * \param[out] switch_list The DOVE Switch List of the message
+ * \param[in] payload The packed table
+ * \param[in] payload_size The size of the packed table
+ *
+ * \retval 1 Success
+ * \retval 0 The packed table is not valid
+ *
+ ******************************************************************************/
+static int broadcast_table_unpack(dps_pkd_tunnel_list_t *switch_list,
+                                  char *payload, int payload_size)
+{
+	dps_pkd_tunnel_list_t *packed;
+	size_t header_size;
+
+	header_size = dps_offsetof(dps_pkd_tunnel_list_t, tunnel_list[0]) -
+	              dps_offsetof(dps_pkd_tunnel_list_t, num_v4_tunnels);
+	if ((payload == NULL) || (payload_size < (int)header_size))
+	{
+		return 0;
+	}
+	packed = (dps_pkd_tunnel_list_t *)(payload -
+	                                   dps_offsetof(dps_pkd_tunnel_list_t, num_v4_tunnels));
+	if ((header_size + ((packed->num_v4_tunnels + (packed->num_v6_tunnels * 4)) *
+	                    sizeof(uint32_t)) != (size_t)payload_size) ||
+	    (dps_offsetof(dps_client_data_t, dove_switch_list.num_v4_tunnels) +
+	     (size_t)payload_size > SEND_BUFF_SIZE))
+	{
+		return 0;
+	}
+	memcpy(&switch_list->num_v4_tunnels, payload, payload_size);
+	return 1;
+}
+
+/*
+ ******************************************************************************
+ * broadcast_delta_pack --                                                *//**
+ *
+ * \brief This is the routine that the PYTHON Scripts call to pack a change
+ *        to the broadcast table of a VNID for DPS Clients that asked for
+ *        sequenced broadcast lists. The packed change is the
+ *        dps_bcast_list_delta_t starting at seq_num and is handed as is to
+ *        send_broadcast_table and Broadcast_List.
+ *        def broadcast_delta_pack(seq_num, base_seq_num, ipv4_add, ipv4_del,
+ *                                 ipv6_add, ipv6_del)
  *
  * \param[in] self  PyObject
- * \param[in] args  The input must be the following:
+ * \param[in] args  The Sequence Numbers and the IPv4 and IPv6 Lists of
+ *                  DOVE Switches added and removed
  *
- * \retval 0 Success
- * \retval -1 Failure
+ * \return The packed change (String), None on failure
  *
  ******************************************************************************/
-PyObject *send_address_resolution(PyObject *self, PyObject *args)
+PyObject *broadcast_delta_pack(PyObject *self, PyObject *args)
 {
-	int dps_client_ip_size, vIP_address_size, vMac_size;
-	uint32_t vnid, query_id;
-	uint16_t dps_client_port;
-	char *dps_client_ip, *vIP_address, *vMac;
-	PyObject *ret_val;
-	dps_client_data_t *client_data = (dps_client_data_t *)send_buff_py;
-	dps_client_hdr_t *hdr = &client_data->hdr;
-	dps_endpoint_loc_req_t *addr_resolve = &((dps_client_data_t *)send_buff_py)->address_resolve;
-	dps_return_status return_status = DPS_ERROR;
-	endpoint_resolution_context_t *pcontext;
-	char str[INET6_ADDRSTRLEN];
+	PyObject *pyList[4], *pyIP;
+	PyObject *ret_val = NULL;
+	dps_bcast_list_delta_t *delta;
+	uint16_t *num_list[4];
+	uint32_t seq_num, base_seq_num;
+	size_t max_size, size;
+	Py_ssize_t i, num;
+	uint32_t j;
+	int k, ipv4, ipv6_size;
+	char *ipv6;
 
-	//Py_BEGIN_ALLOW_THREADS
-	log_info(PythonDataHandlerLogLevel, "Enter");
+	log_debug(PythonDataHandlerLogLevel, "Enter");
 
 	do
 	{
-		if (!PyArg_ParseTuple(args, "z#HIIz#z#",
-		                      &dps_client_ip, &dps_client_ip_size,
-		                      &dps_client_port,
-		                      &vnid,
-		                      &query_id,
-		                      &vIP_address, &vIP_address_size,
-		                      &vMac, &vMac_size))
+		if (!PyArg_ParseTuple(args, "IIOOOO", &seq_num, &base_seq_num,
+		                      &pyList[0], &pyList[1], &pyList[2], &pyList[3]))
 		{
 			log_warn(PythonDataHandlerLogLevel, "Bad Data!!!");
 			break;
 		}
-		if (dps_client_ip == NULL)
+		size = 0;
+		for (k = 0; k < 4; k++)
 		{
-			log_warn(PythonDataHandlerLogLevel, "Bad DPS Client IP Address!!!");
-			break;
+			if (!PyList_Check(pyList[k]))
+			{
+				break;
+			}
+			size += PyList_Size(pyList[k]) * ((k < 2) ? 1 : 4) * sizeof(uint32_t);
 		}
-		if (vIP_address == NULL)
+		if (k < 4)
 		{
-			log_warn(PythonDataHandlerLogLevel, "Bad Virtual IP Address!!!");
+			log_warn(PythonDataHandlerLogLevel, "Bad Data!!!");
 			break;
 		}
-		hdr->type = DPS_ADDR_RESOLVE;
+		// Whatever is packed must fit in a send buffer
+		max_size = SEND_BUFF_SIZE - dps_offsetof(dps_client_data_t,
+		                                         dove_switch_delta.tunnel_list[0]);
+		if (size > max_size)
+		{
+			// The DPS Client will have to ask for the whole list
+			log_alert(PythonDataHandlerLogLevel,
+			          "ALERT!!! Broadcast change %d bytes exceeds Send Buffer %d max size",
+			          size, SEND_BUFF_SIZE);
+			break;
+		}
+		delta = (dps_bcast_list_delta_t *)malloc(sizeof(dps_bcast_list_delta_t) + size);
+		if (delta == NULL)
+		{
+			log_warn(PythonDataHandlerLogLevel, "No memory");
+			break;
+		}
+		delta->seq_num = seq_num;
+		delta->base_seq_num = base_seq_num;
+		num_list[0] = &delta->num_v4_add;
+		num_list[1] = &delta->num_v4_del;
+		num_list[2] = &delta->num_v6_add;
+		num_list[3] = &delta->num_v6_del;
+		j = 0;
+		for (k = 0; k < 4; k++)
+		{
+			*num_list[k] = 0;
+			num = PyList_Size(pyList[k]);
+			for (i = 0; i < num; i++)
+			{
+				pyIP = PyList_GetItem(pyList[k], i);
+				if (k < 2)
+				{
+					if (!PyArg_Parse(pyIP, "I", &ipv4))
+					{
+						PyErr_Clear();
+						log_warn(PythonDataHandlerLogLevel,
+						         "Invalid IPv4 in element %d", i);
+						continue;
+					}
+					delta->tunnel_list[j++] = ntohl(ipv4);
+				}
+				else
+				{
+					if (!PyArg_Parse(pyIP, "z#", &ipv6, &ipv6_size) ||
+					    (ipv6 == NULL) || (ipv6_size != 16))
+					{
+						PyErr_Clear();
+						log_warn(PythonDataHandlerLogLevel,
+						         "Invalid IPv6 in element %d", i);
+						continue;
+					}
+					memcpy((uint8_t *)(&delta->tunnel_list[j]), ipv6, 16);
+					j += 4;
+				}
+				(*num_list[k])++;
+			}
+		}
+		ret_val = Py_BuildValue("s#", (char *)&delta->seq_num,
+		                        (int)(dps_offsetof(dps_bcast_list_delta_t, tunnel_list[j]) -
+		                              dps_offsetof(dps_bcast_list_delta_t, seq_num)));
+		free(delta);
+	}while(0);
+
+	if (ret_val == NULL)
+	{
+		PyErr_Clear();
+		Py_INCREF(Py_None);
+		ret_val = Py_None;
+	}
+	log_debug(PythonDataHandlerLogLevel, "Exit");
+
+	return ret_val;
+}
+
+/*
+ ******************************************************************************
+ * broadcast_delta_unpack --                                              *//**
+ *
+ * \brief This routine copies a change packed by broadcast_delta_pack into
+ *        the DOVE Switch Change of a message in a send buffer.
+ *
+ * \param[out] delta The DOVE Switch Change of the message
+ * \param[in] payload The packed change
+ * \param[in] payload_size The size of the packed change
+ *
+ * \retval 1 Success
+ * \retval 0 The packed change is not valid
+ *
+ ******************************************************************************/
+static int broadcast_delta_unpack(dps_bcast_list_delta_t *delta,
+                                  char *payload, int payload_size)
+{
+	dps_bcast_list_delta_t *packed;
+	size_t header_size;
+
+	header_size = dps_offsetof(dps_bcast_list_delta_t, tunnel_list[0]) -
+	              dps_offsetof(dps_bcast_list_delta_t, seq_num);
+	if ((payload == NULL) || (payload_size < (int)header_size))
+	{
+		return 0;
+	}
+	packed = (dps_bcast_list_delta_t *)(payload -
+	                                    dps_offsetof(dps_bcast_list_delta_t, seq_num));
+	if ((header_size + ((packed->num_v4_add + packed->num_v4_del +
+	                     ((packed->num_v6_add + packed->num_v6_del) * 4)) *
+	                    sizeof(uint32_t)) != (size_t)payload_size) ||
+	    (dps_offsetof(dps_client_data_t, dove_switch_delta.seq_num) +
+	     (size_t)payload_size > SEND_BUFF_SIZE))
+	{
+		return 0;
+	}
+	memcpy(&delta->seq_num, payload, payload_size);
+	return 1;
+}
+
+/*
+ ******************************************************************************
+ * broadcast_payload_unpack --                                            *//**
+ *
+ * \brief This routine copies a packed broadcast table or change into a
+ *        message in a send buffer based on the sub_type of the message.
+ *
+ * \param[out] client_data The message
+ * \param[in] sub_type DPS_BCAST_LIST_FULL or DPS_BCAST_LIST_SEQUENCED
+ * \param[in] payload The packed table or change
+ * \param[in] payload_size The size of the packed table or change
+ *
+ * \retval 1 Success
+ * \retval 0 The packed table or change is not valid
+ *
+ ******************************************************************************/
+static int broadcast_payload_unpack(dps_client_data_t *client_data,
+                                    uint32_t sub_type,
+                                    char *payload, int payload_size)
+{
+	client_data->hdr.sub_type = (uint8_t)sub_type;
+	if (sub_type == DPS_BCAST_LIST_SEQUENCED)
+	{
+		return broadcast_delta_unpack(&client_data->dove_switch_delta,
+		                              payload, payload_size);
+	}
+	else if (sub_type == DPS_BCAST_LIST_FULL)
+	{
+		return broadcast_table_unpack(&client_data->dove_switch_list,
+		                              payload, payload_size);
+	}
+	return 0;
+}
+
+/*
+ ******************************************************************************
+ * send_broadcast_table --                                                *//**
+ *
+ * \brief This is the routine that the PYTHON Scripts must call to send the
+ *        broadcast table to a DPS Client
+ *
+ * \param[in] self  PyObject
+ * \param[in] args  The input must be the following:
+ *
+ * \retval 0 Success
+ * \retval -1 Failure
+ *
+ ******************************************************************************/
+PyObject *send_broadcast_table(PyObject *self, PyObject *args)
+{
+	int dps_client_ip_size, payload_size;
+	uint32_t vnid, query_id;
+	uint32_t sub_type = DPS_BCAST_LIST_FULL;
+	uint32_t version = 0;
+	uint16_t dps_client_port;
+	char *dps_client_ip, *payload;
+	PyObject *ret_val;
+	dps_client_data_t *client_data = (dps_client_data_t *)send_buff_py;
+	dps_client_hdr_t *hdr = &client_data->hdr;
+	dps_pkd_tunnel_list_t *switch_list = &((dps_client_data_t *)send_buff_py)->dove_switch_list;
+	dps_bcast_list_delta_t *delta = &((dps_client_data_t *)send_buff_py)->dove_switch_delta;
+	dps_return_status return_status = DPS_ERROR;
+	unsolicited_msg_context_t *pcontext;
+	char str[INET6_ADDRSTRLEN];
+
+	log_debug(PythonDataHandlerLogLevel, "Enter");
+	//Py_BEGIN_ALLOW_THREADS
+
+	do
+	{
+		if (!PyArg_ParseTuple(args, "z#HIIz#|II",
+		                      &dps_client_ip, &dps_client_ip_size,
+		                      &dps_client_port,
+		                      &vnid,
+		                      &query_id,
+		                      &payload, &payload_size,
+		                      &sub_type,
+		                      &version))
+		{
+			log_warn(PythonDataHandlerLogLevel, "Bad Data!!!");
+			break;
+		}
+		if (dps_client_ip == NULL)
+		{
+			log_warn(PythonDataHandlerLogLevel, "Bad DPS Client IP Address!!!");
+			break;
+		}
+		if (!broadcast_payload_unpack(client_data, sub_type, payload, payload_size))
+		{
+			log_warn(PythonDataHandlerLogLevel, "Bad Broadcast Table!!!");
+			break;
+		}
+
+		if (sub_type == DPS_BCAST_LIST_SEQUENCED)
+		{
+			log_info(PythonDataHandlerLogLevel,
+			         "VNID: %d, Broadcast Change %u -> %u, IPv4 +%d -%d, IPv6 +%d -%d",
+			         vnid, delta->base_seq_num, delta->seq_num,
+			         delta->num_v4_add, delta->num_v4_del,
+			         delta->num_v6_add, delta->num_v6_del);
+		}
+		else
+		{
+			log_info(PythonDataHandlerLogLevel,"VNID: %d, Broadcast Switches IPv4 %d, IPv6 %d",
+			         vnid, switch_list->num_v4_tunnels, switch_list->num_v6_tunnels);
+		}
+		hdr->type = DPS_UNSOLICITED_BCAST_LIST_REPLY;
+		hdr->client_id = DPS_POLICY_SERVER_ID;
+		hdr->transaction_type = DPS_TRANSACTION_NORMAL;
+		hdr->vnid = vnid;
+		hdr->resp_status = DPS_NO_ERR;
+		hdr->query_id = query_id;
+		hdr->reply_addr.port = dps_client_port;
+		hdr->payload_version = version;
+//		if (Hash_Perf_Test_CLI)
+//		{
+//			break;
+//		}
+#if 1
+		pcontext = (unsolicited_msg_context_t *)malloc(sizeof(unsolicited_msg_context_t));
+		client_data->context = (void *)pcontext;
+		log_debug(PythonDataHandlerLogLevel,
+		          "Setting QueryID %d, Context %p",
+		          client_data->hdr.query_id,
+		          client_data->context);
+		if (pcontext != NULL)
+		{
+			outstanding_unsolicited_msg_count++;
+			pcontext->vnid_id = vnid;
+			pcontext->original_msg_type = client_data->hdr.type;
+			if (dps_client_ip_size == 4)
+			{
+				pcontext->dps_client_location.family = AF_INET;
+			}
+			else
+			{
+				pcontext->dps_client_location.family = AF_INET6;
+			}
+			pcontext->dps_client_location.port = dps_client_port;
+			memcpy(pcontext->dps_client_location.ip6, dps_client_ip, dps_client_ip_size);
+		}
+#else
+		client_data->context = NULL;
+#endif
+		if (dps_client_ip_size == 4)
+		{
+			inet_ntop(AF_INET, dps_client_ip, str, INET_ADDRSTRLEN);
+			// IPv4
+			log_info(PythonDataHandlerLogLevel,
+			         "DPS Client: IPv4 %s, Port %d", str, dps_client_port);
+			hdr->reply_addr.family = AF_INET;
+			hdr->reply_addr.ip4 = ntohl(*((uint32_t *)dps_client_ip));
+		}
+		else
+		{
+			// IPv6
+			inet_ntop(AF_INET6, dps_client_ip, str, INET6_ADDRSTRLEN);
+			log_info(PythonDataHandlerLogLevel,
+			         "DPS Client: pIPv6 %s, Port %d", str, dps_client_port);
+			hdr->reply_addr.family = AF_INET6;
+			memcpy(hdr->reply_addr.ip6, dps_client_ip, dps_client_ip_size);
+		}
+		return_status = dps_protocol_client_send(client_data);
+		if (return_status != DPS_SUCCESS)
+		{
+			log_info(PythonDataHandlerLogLevel,
+			         "dps_protocol_client_send returns failure");
+			free(client_data->context);
+			outstanding_unsolicited_msg_count--;
+		}
+	}while(0);
+
+	//Py_END_ALLOW_THREADS
+	ret_val = Py_BuildValue("i", return_status);
+	log_debug(PythonDataHandlerLogLevel, "Exit status %d", return_status);
+
+	return ret_val;
+}
+
+/*
+ ******************************************************************************
+ * send_address_resolution --                                             *//**
+ *
+ * \brief This is the routine that the PYTHON Scripts must call to send the
+ *        address resolution request to a DPS Client
+ *
+ * \param[in] self  PyObject
+ * \param[in] args  The input must be the following:
+ *
+ * \retval 0 Success
+ * \retval -1 Failure
+ *
+ ******************************************************************************/
+PyObject *send_address_resolution(PyObject *self, PyObject *args)
+{
+	int dps_client_ip_size, vIP_address_size, vMac_size;
+	uint32_t vnid, query_id;
+	uint16_t dps_client_port;
+	char *dps_client_ip, *vIP_address, *vMac;
+	PyObject *ret_val;
+	dps_client_data_t *client_data = (dps_client_data_t *)send_buff_py;
+	dps_client_hdr_t *hdr = &client_data->hdr;
+	dps_endpoint_loc_req_t *addr_resolve = &((dps_client_data_t *)send_buff_py)->address_resolve;
+	dps_return_status return_status = DPS_ERROR;
+	endpoint_resolution_context_t *pcontext;
+	char str[INET6_ADDRSTRLEN];
+
+	//Py_BEGIN_ALLOW_THREADS
+	log_info(PythonDataHandlerLogLevel, "Enter");
+
+	do
+	{
+		if (!PyArg_ParseTuple(args, "z#HIIz#z#",
+		                      &dps_client_ip, &dps_client_ip_size,
+		                      &dps_client_port,
+		                      &vnid,
+		                      &query_id,
+		                      &vIP_address, &vIP_address_size,
+		                      &vMac, &vMac_size))
+		{
+			log_warn(PythonDataHandlerLogLevel, "Bad Data!!!");
+			break;
+		}
+		if (dps_client_ip == NULL)
+		{
+			log_warn(PythonDataHandlerLogLevel, "Bad DPS Client IP Address!!!");
+			break;
+		}
+		if (vIP_address == NULL)
+		{
+			log_warn(PythonDataHandlerLogLevel, "Bad Virtual IP Address!!!");
+			break;
+		}
+		hdr->type = DPS_ADDR_RESOLVE;
 		hdr->client_id = DPS_POLICY_SERVER_ID;
 		hdr->transaction_type = DPS_TRANSACTION_NORMAL;
 		hdr->vnid = vnid;
@@ -1561,11 +2033,6 @@ PyObject *send_heartbeat(PyObject *self, PyObject *args)
 			log_warn(PythonDataHandlerLogLevel, "Bad DPS Client IP Address!!!");
 			break;
 		}
-		if (vIP_address == NULL)
-		{
-			log_warn(PythonDataHandlerLogLevel, "Bad Virtual IP Address!!!");
-			break;
-		}
 		hdr->type = DPS_CTRL_PLANE_HB;
 		hdr->client_id = DPS_POLICY_SERVER_ID;
 		hdr->transaction_type = DPS_TRANSACTION_NORMAL;
@@ -3304,36 +3771,93 @@ PyObject * dps_ipsubnet_bulk_replicate(PyObject *self, PyObject *args)
 
 /*
  ******************************************************************************
- * vnid_query_send_to_controller --                                       *//**
+ * mass_transfer_stream_send --                                           *//**
  *
- * \brief This is the routine that the PYTHON Scripts calls to send a query
- *        to the controller regarding a particular vnid.
+ * \brief This is the routine that the PYTHON Scripts calls to send a Mass
+ *        Transfer Stream Frame (a batch of packed objects) to a remote node
  *
  * \param[in] self  PyObject
  * \param[in] args  The input must be the following:
+ *                  dps_node_ip (packed), domain, frame (packed)
  *
  * \retval 0 Success
  * \retval -1 Failure
  *
  ******************************************************************************/
-PyObject *vnid_query_send_to_controller(PyObject *self, PyObject *args)
+PyObject *mass_transfer_stream_send(PyObject *self, PyObject *args)
 {
 	PyObject *ret_val;
-	uint32_t vnid;
+	char *dps_node_ip, *frame;
+	uint32_t domain;
+	int dps_node_sz, frame_size, status = -1;
+	char dps_node_str[INET6_ADDRSTRLEN];
 
 	log_info(PythonDataHandlerLogLevel, "Enter");
 
 	do
 	{
-		if (!PyArg_ParseTuple(args, "I", &vnid))
+		if (!PyArg_ParseTuple(args, "z#Iz#",
+		                      &dps_node_ip, &dps_node_sz,
+		                      &domain,
+		                      &frame, &frame_size))
 		{
 			log_alert(PythonDataHandlerLogLevel,
-			          "Cannot parse arguments");
+			          "Mass Transfer Stream Send: Cannot parse arguments");
 			break;
 		}
-		log_info(PythonDataHandlerLogLevel, "Query Controller for VNID %d", vnid);
-		dps_rest_client_query_dove_controller_vnid_info(vnid);
-	}while(0);
+		if (dps_node_sz == 4)
+		{
+			inet_ntop(AF_INET, dps_node_ip, dps_node_str, INET_ADDRSTRLEN);
+		}
+		else
+		{
+			inet_ntop(AF_INET6, dps_node_ip, dps_node_str, INET6_ADDRSTRLEN);
+		}
+
+		status = dps_cluster_mass_transfer_stream_send(dps_node_str, domain,
+		                                               frame, frame_size);
+
+		log_debug(PythonDataHandlerLogLevel,"Return status %d", status);
+	}while(0);
+
+	ret_val = Py_BuildValue("i", status);
+	log_info(PythonDataHandlerLogLevel, "Exit status %d", status);
+
+	return ret_val;
+}
+
+/*
+ ******************************************************************************
+ * vnid_query_send_to_controller --                                       *//**
+ *
+ * \brief This is the routine that the PYTHON Scripts calls to send a query
+ *        to the controller regarding a particular vnid.
+ *
+ * \param[in] self  PyObject
+ * \param[in] args  The input must be the following:
+ *
+ * \retval 0 Success
+ * \retval -1 Failure
+ *
+ ******************************************************************************/
+PyObject *vnid_query_send_to_controller(PyObject *self, PyObject *args)
+{
+	PyObject *ret_val;
+	uint32_t vnid;
+
+	log_info(PythonDataHandlerLogLevel, "Enter");
+
+	do
+	{
+		if (!PyArg_ParseTuple(args, "I", &vnid))
+		{
+			log_alert(PythonDataHandlerLogLevel,
+			          "Cannot parse arguments");
+			break;
+		}
+		log_info(PythonDataHandlerLogLevel, "Query Controller for VNID %d", vnid);
+		dps_rest_client_query_dove_controller_vnid_info(vnid);
+	}while(0);
 	ret_val = Py_BuildValue("i", 0);
 	log_info(PythonDataHandlerLogLevel, "Exit");
 
@@ -3396,6 +3920,28 @@ PyObject *send_message_and_free(PyObject *self, PyObject *args)
 	return ret_val;
 }
 
+/*
+ ******************************************************************************
+ * dps_msg_reply_send_and_free --                                         *//**
+ *
+ * \brief This routine sends a reply formed by the DCS Server to a DPS Client
+ *        and frees the reply
+ *
+ * \param[in] reply The reply
+ * \param[in] status The dps_resp_status_t to send in the reply
+ *
+ *****************************************************************************/
+
+void dps_msg_reply_send_and_free(dps_client_data_t *reply, uint32_t status)
+{
+	reply->hdr.resp_status = status;
+	log_info(PythonDataHandlerLogLevel,
+	         "Sending Message Type %d, Query ID %d, Status %d",
+	         reply->hdr.type, reply->hdr.query_id, reply->hdr.resp_status);
+	dps_msg_send_inline(reply);
+	free(reply);
+}
+
 /*
  ******************************************************************************
  * domain_query_from_controller --                                        *//**
@@ -3875,6 +4421,15 @@ static dps_return_status dps_msg_update_reply(uint32_t domain_id,
 
 	log_debug(PythonDataHandlerLogLevel, "Enter Domain Id %d", domain_id);
 
+	// Shared Address Space replies for updates on the Replication Channels
+	if ((dps_msg->hdr.transaction_type != DPS_TRANSACTION_MASS_COPY) &&
+	    dps_replication_update_complete(dps_msg->hdr.query_id,
+	                                    dps_msg->hdr.resp_status))
+	{
+		log_debug(PythonDataHandlerLogLevel, "Exit");
+		return DPS_SUCCESS;
+	}
+
 	// Ensure the PYTHON Global Interpreter Lock
 	gstate = PyGILState_Ensure();
 	do
@@ -3938,6 +4493,188 @@ static dps_return_status dps_msg_update_reply(uint32_t domain_id,
 	return DPS_SUCCESS;
 }
 
+/*
+ ******************************************************************************
+ * dps_msg_replication_batch --                                           *//**
+ *
+ * \brief This routine handles a batch of Endpoint Updates received on a
+ *        Replication Channel
+ *
+ * \param domain_id The Domain ID
+ * \param dps_msg The DPS_REPLICATION_BATCH
+ *
+ * \retval DPS_SUCCESS
+ *
+ *****************************************************************************/
+
+static dps_return_status dps_msg_replication_batch(uint32_t domain_id,
+                                                   dps_client_data_t *dps_msg)
+{
+	log_debug(PythonDataHandlerLogLevel, "Enter Domain Id %d", domain_id);
+	dps_replication_batch_receive(domain_id, dps_msg);
+	log_debug(PythonDataHandlerLogLevel, "Exit");
+	return DPS_SUCCESS;
+}
+
+/*
+ ******************************************************************************
+ * dps_msg_replication_batch_ack --                                       *//**
+ *
+ * \brief This routine handles the ACK of a Replication Channel
+ *
+ * \param domain_id The Domain ID
+ * \param dps_msg The DPS_REPLICATION_BATCH_ACK
+ *
+ * \retval DPS_SUCCESS
+ *
+ *****************************************************************************/
+
+static dps_return_status dps_msg_replication_batch_ack(uint32_t domain_id,
+                                                       dps_client_data_t *dps_msg)
+{
+	log_debug(PythonDataHandlerLogLevel, "Enter Domain Id %d", domain_id);
+	dps_replication_ack_receive(dps_msg);
+	log_debug(PythonDataHandlerLogLevel, "Exit");
+	return DPS_SUCCESS;
+}
+
+/*
+ ******************************************************************************
+ * dps_mass_transfer_stream_ack --                                        *//**
+ *
+ * \brief This routine hands the cumulative ACK of a Mass Transfer Stream
+ *        (received from the remote DCS Server) to the PYTHON Mass Transfer
+ *        handler
+ *
+ * \param stream_id The Stream ID
+ * \param ack_seq The highest frame sequence applied in order by the remote
+ * \param status The status of the last frame processed by the remote
+ *
+ * \retval None
+ *
+ *****************************************************************************/
+
+void dps_mass_transfer_stream_ack(uint32_t stream_id,
+                                  uint32_t ack_seq,
+                                  uint32_t status)
+{
+	PyObject *strret, *strargs;
+	PyGILState_STATE gstate;
+
+	log_debug(PythonDataHandlerLogLevel,
+	          "Enter Stream %d, Ack %d, Status %d",
+	          stream_id, ack_seq, status);
+
+	// Ensure the PYTHON Global Interpreter Lock
+	gstate = PyGILState_Ensure();
+	do
+	{
+		//def Stream_Ack(self, stream_id, ack_seq, status):
+		strargs = Py_BuildValue("(III)", stream_id, ack_seq, status);
+		if (strargs == NULL)
+		{
+			log_notice(PythonDataHandlerLogLevel,
+			           "Py_BuildValue returns NULL");
+			break;
+		}
+
+		strret = PyEval_CallObject(Mass_Transfer_Interface.Stream_Ack, strargs);
+		Py_DECREF(strargs);
+
+		if (strret != NULL)
+		{
+			Py_DECREF(strret);
+		}
+		else
+		{
+			log_warn(PythonDataHandlerLogLevel,
+			         "PyEval_CallObject Stream_Ack returns NULL");
+		}
+
+	} while(0);
+
+	PyGILState_Release(gstate);
+
+	log_debug(PythonDataHandlerLogLevel, "Exit");
+
+	return;
+}
+
+/*
+ ******************************************************************************
+ * dps_mass_transfer_stream_receive --                                    *//**
+ *
+ * \brief This routine hands a received Mass Transfer Stream Frame to the
+ *        PYTHON Mass Transfer handler and returns the cumulative ACK that
+ *        must be sent back to the sender
+ *
+ * \param[in] domain_id The Domain ID
+ * \param[in] frame The Packed Frame
+ * \param[in] frame_size The size of the Frame
+ * \param[out] stream_id The Stream ID
+ * \param[out] ack_seq The highest frame sequence applied in order
+ * \param[out] status The status of processing the frame
+ *
+ * \retval DOVE_STATUS_OK The ACK fields are valid
+ * \retval DOVE_STATUS_INVALID_PARAMETER The Frame couldn't be processed
+ *
+ *****************************************************************************/
+
+dove_status dps_mass_transfer_stream_receive(uint32_t domain_id,
+                                             char *frame,
+                                             uint32_t frame_size,
+                                             uint32_t *stream_id,
+                                             uint32_t *ack_seq,
+                                             uint32_t *status)
+{
+	PyObject *strret, *strargs;
+	PyGILState_STATE gstate;
+	dove_status ret_val = DOVE_STATUS_INVALID_PARAMETER;
+
+	log_debug(PythonDataHandlerLogLevel, "Enter Domain %d, Frame Size %d",
+	          domain_id, frame_size);
+
+	// Ensure the PYTHON Global Interpreter Lock
+	gstate = PyGILState_Ensure();
+	do
+	{
+		//def Stream_Frame_Receive(self, domain_id, frame):
+		strargs = Py_BuildValue("(Iz#)", domain_id, frame, (int)frame_size);
+		if (strargs == NULL)
+		{
+			log_notice(PythonDataHandlerLogLevel,
+			           "Py_BuildValue returns NULL");
+			break;
+		}
+
+		strret = PyEval_CallObject(Mass_Transfer_Interface.Stream_Frame_Receive,
+		                           strargs);
+		Py_DECREF(strargs);
+
+		if (strret == NULL)
+		{
+			log_warn(PythonDataHandlerLogLevel,
+			         "PyEval_CallObject Stream_Frame_Receive returns NULL");
+			break;
+		}
+
+		//@return: stream_id, ack_seq, status
+		//@rtype: Integer, Integer, Integer
+		if (PyArg_ParseTuple(strret, "III", stream_id, ack_seq, status))
+		{
+			ret_val = DOVE_STATUS_OK;
+		}
+		Py_DECREF(strret);
+
+	} while(0);
+
+	PyGILState_Release(gstate);
+
+	log_debug(PythonDataHandlerLogLevel, "Exit %d", ret_val);
+
+	return ret_val;
+}
+
 /*
  ******************************************************************************
  * dps_update_replicate --                                                *//**
@@ -4174,319 +4911,1512 @@ static dps_resp_status_t dps_update_replicate(uint32_t domain_id,
 
 /*
  ******************************************************************************
- * dps_msg_endpoint_update --                                             *//**
+ * dps_replication_nodes_get --                                           *//**
  *
- * \brief This routine handles Endpoint Update
+ * \brief This routine asks PYTHON for the other DCS Servers the Endpoint
+ *        Updates of a Domain must be replicated to.
+ *        MUST NOT be called with the PYTHON GIL held.
  *
- * \param domain_id The Domain ID
- * \param dps_msg The DPS Client Server Protocol Message for Endpoint Update
+ * \param[in] domain_id The Domain ID
+ * \param[out] nodes The DCS Servers (Host Order), the local node excluded
+ * \param[in] max_nodes The size of the nodes array
+ * \param[out] num_nodes The number of DCS Servers in nodes
  *
- * \retval DOVE_STATUS_OK
+ * \return dps_resp_status_t
  *
  *****************************************************************************/
 
-static dps_return_status dps_msg_endpoint_update(uint32_t domain_id,
-                                                 dps_client_data_t *dps_msg)
+dps_resp_status_t dps_replication_nodes_get(uint32_t domain_id,
+                                            ip_addr_t *nodes,
+                                            uint32_t max_nodes,
+                                            uint32_t *num_nodes)
 {
-	ip_addr_t dps_client_address, sender_client_address;
-	dps_tunnel_endpoint_t pIP_address;
-	dps_client_data_t *dps_msg_reply = NULL;
-	dps_endpoint_update_t *endpoint_update_msg = NULL;
 	PyObject *strret, *strargs;
-	PyObject *py_vIP_List;
+	PyObject *py_ipaddress_list;
 	PyGILState_STATE gstate;
-	size_t dps_msg_size;
-	uint32_t query_id = 0;
-	int ret_code = DPS_NO_MEMORY; // dps_resp_status_t
-	int shared_address = 0; // 0 Dedicated, 1 Shared
-	int fFreeReplyMessage = 0;
-	int i;
-	char str[INET6_ADDRSTRLEN];
+	dps_resp_status_t ret_code = DPS_NO_MEMORY;
+	uint32_t dps_status;
+	int i, list_size;
 
 	log_debug(PythonDataHandlerLogLevel, "Enter Domain Id %d", domain_id);
 
+	*num_nodes = 0;
+	gstate = PyGILState_Ensure();
 	do
 	{
-		//Create the Reply Message
-		dps_msg_reply = (dps_client_data_t *)malloc(sizeof(dps_client_data_t));
-		if (dps_msg_reply == NULL)
+		//def ReplicationNodes(self, msg_domain_id):
+		strargs = Py_BuildValue("(I)", domain_id);
+		if (strargs == NULL)
 		{
+			log_notice(PythonDataHandlerLogLevel,
+			           "Py_BuildValue returns NULL");
 			break;
 		}
-		fFreeReplyMessage = 1;
-		log_debug(PythonDataHandlerLogLevel, "Allocated Message %p:%d",
-		          dps_msg_reply, sizeof(dps_client_data_t));
-		dps_form_endpoint_update_reply(dps_msg_reply, dps_msg, DPS_NO_ERR);
-
-		endpoint_update_msg = (dps_endpoint_update_t *)&dps_msg->endpoint_update;
-
-		if ((endpoint_update_msg->dps_client_addr.family != AF_INET) &&
-		    (endpoint_update_msg->dps_client_addr.family != AF_INET6))
+		strret = PyEval_CallObject(Replication_Interface.ReplicationNodes,
+		                           strargs);
+		Py_DECREF(strargs);
+		if (strret == NULL)
 		{
-			ret_code = DPS_INVALID_SRC_IP;
+			log_warn(PythonDataHandlerLogLevel,
+			         "PyEval_CallObject ReplicationNodes returns NULL");
 			break;
 		}
-		if (endpoint_update_msg->tunnel_info.num_of_tunnels != 0)
+
+		// Parse the return value (dps_resp_status_t, DCS Servers List)
+		if (!PyArg_ParseTuple(strret, "IO", &dps_status, &py_ipaddress_list) ||
+		    !PyList_Check(py_ipaddress_list))
 		{
-			if ((endpoint_update_msg->tunnel_info.tunnel_list[0].family != AF_INET) &&
-			    (endpoint_update_msg->tunnel_info.tunnel_list[0].family != AF_INET6))
-			{
-				ret_code = DPS_INVALID_SRC_IP;
-				break;
-			}
+			Py_DECREF(strret);
+			log_warn(PythonDataHandlerLogLevel,
+			         "ReplicationNodes: Invalid return value");
+			break;
 		}
-		if ((endpoint_update_msg->vm_ip_addr.family != AF_INET) &&
-		    (endpoint_update_msg->vm_ip_addr.family != AF_INET6))
+		ret_code = (dps_resp_status_t)dps_status;
+		if (ret_code != DPS_NO_ERR)
 		{
-			ret_code = DPS_INVALID_SRC_IP;
+			Py_DECREF(strret);
+			log_notice(PythonDataHandlerLogLevel,
+			           "ReplicationNodes returns dps_status %d", ret_code);
 			break;
 		}
-		// Copy the Addresses so that they can be converted to Network Order
-		memcpy(&sender_client_address, &dps_msg->hdr.reply_addr, sizeof(ip_addr_t));
-		memcpy(&dps_client_address, &endpoint_update_msg->dps_client_addr, sizeof(ip_addr_t));
-		memcpy(&pIP_address, &endpoint_update_msg->tunnel_info.tunnel_list[0], sizeof(dps_tunnel_endpoint_t));
-		memcpy(&vIP_address[0], &endpoint_update_msg->vm_ip_addr, sizeof(ip_addr_t));
 
-		if(sender_client_address.family == AF_INET)
-		{
-			sender_client_address.ip4 = htonl(sender_client_address.ip4);
-		}
-		if(dps_client_address.family == AF_INET)
-		{
-			dps_client_address.ip4 = htonl(dps_client_address.ip4);
-		}
-		if(pIP_address.family == AF_INET)
-		{
-			pIP_address.ip4 = htonl(pIP_address.ip4);
-		}
-		if(vIP_address[0].family == AF_INET)
+		list_size = PyList_Size(py_ipaddress_list);
+		for (i = 0; i < list_size; i++)
 		{
-			vIP_address[0].ip4 = htonl(vIP_address[0].ip4);
-		}
-		{
-			log_info(PythonDataHandlerLogLevel, "VNID %d", dps_msg->hdr.vnid);
-			inet_ntop(sender_client_address.family, sender_client_address.ip6, str, INET6_ADDRSTRLEN);
-			log_info(PythonDataHandlerLogLevel, "Sender IP %s, Port %d",
-			          str, sender_client_address.port);
-			inet_ntop(dps_client_address.family, dps_client_address.ip6, str, INET6_ADDRSTRLEN);
-			log_info(PythonDataHandlerLogLevel, "DPS Client %s, Port %d",
-			          str, dps_client_address.port);
-			inet_ntop(pIP_address.family, pIP_address.ip6, str, INET6_ADDRSTRLEN);
-			log_info(PythonDataHandlerLogLevel, "DOVE Switch %s", str);
-			inet_ntop(vIP_address[0].family, vIP_address[0].ip6, str, INET6_ADDRSTRLEN);
-			log_info(PythonDataHandlerLogLevel, "Endpoint IP %s", str);
-			log_info(PythonDataHandlerLogLevel, "Endpoint Mac " MAC_FMT,
-			          MAC_OCTETS(dps_msg->endpoint_update.mac));
-			log_info(PythonDataHandlerLogLevel, "Query ID %d", dps_msg->hdr.query_id);
-			log_info(PythonDataHandlerLogLevel, "Sub Type %d", dps_msg->hdr.sub_type);
-			log_info(PythonDataHandlerLogLevel, "Sender Type %d", dps_msg->hdr.client_id);
-			log_info(PythonDataHandlerLogLevel, "Transaction Type %d", dps_msg->hdr.transaction_type);
-			log_info(PythonDataHandlerLogLevel, "Version %d", endpoint_update_msg->version);
+			uint16_t family, port;
+			int IP_packed_size;
+			char *IP_packed;
+
+			if (!PyArg_ParseTuple(PyList_GetItem(py_ipaddress_list, i), "Hz#H",
+			                      &family,
+			                      &IP_packed, &IP_packed_size,
+			                      &port))
+			{
+				log_error(PythonDataHandlerLogLevel,
+				         "Invalid IP Address in Replication element %d", i);
+				continue;
+			}
+			if (!memcmp(IP_packed, dcs_local_ip.ip6, IP_packed_size))
+			{
+				continue;
+			}
+			if (*num_nodes == max_nodes)
+			{
+				log_warn(PythonDataHandlerLogLevel,
+				         "Domain %d: More than %d nodes to replicate to",
+				         domain_id, max_nodes);
+				break;
+			}
+			memset(&nodes[*num_nodes], 0, sizeof(ip_addr_t));
+			nodes[*num_nodes].family = family;
+			nodes[*num_nodes].port = port;
+			memcpy(nodes[*num_nodes].ip6, IP_packed,
+			       (IP_packed_size < 16) ? IP_packed_size : 16);
+			if (family == AF_INET)
+			{
+				nodes[*num_nodes].ip4 = ntohl(nodes[*num_nodes].ip4);
+			}
+			(*num_nodes)++;
 		}
+		Py_DECREF(strret);
+	} while(0);
+	PyGILState_Release(gstate);
 
-		// Check if there are other nodes this request should be forwarded to.
-		dps_msg_size = dps_offsetof(dps_client_data_t,
-		                            endpoint_update.tunnel_info.tunnel_list[endpoint_update_msg->tunnel_info.num_of_tunnels]);
-		ret_code = dps_update_replicate(domain_id,
-		                                dps_msg,
-		                                dps_msg_reply,
-		                                dps_msg_size,
-		                                &query_id);
-		if (ret_code != DPS_NO_ERR)
+	log_debug(PythonDataHandlerLogLevel, "Exit: status %d, nodes %d",
+	          ret_code, *num_nodes);
+
+	return ret_code;
+}
+
+/*
+ ******************************************************************************
+ * dps_endpoint_update_batch_args --                                      *//**
+ *
+ * \brief This routine builds the PYTHON Endpoint_Update_Batch element for an
+ *        Endpoint Update i.e. the Endpoint_Update arguments. The PYTHON GIL
+ *        MUST be held by the caller.
+ *        (domain_id, dvg_id, vnid, client_type, transaction_type,
+ *         dps_client_IP_type, dps_client_IP_packed, dps_client_port,
+ *         pIP_type, pIP_packed, vMac, vIP_type, vIP_packed,
+ *         operation, version)
+ *
+ * \param domain_id The Domain ID
+ * \param dvg_id The VNID in the header of the Endpoint Update
+ * \param client_id The client_id in the header of the Endpoint Update
+ * \param transaction_type The dps_transaction_type of the Endpoint Update
+ * \param sub_type The sub_type in the header of the Endpoint Update
+ * \param endpoint_update The Endpoint Update
+ *
+ * \return The PYTHON tuple, NULL if no memory
+ *
+ *****************************************************************************/
+
+static PyObject *dps_endpoint_update_batch_args(uint32_t domain_id,
+                                                uint32_t dvg_id,
+                                                uint32_t client_id,
+                                                uint32_t transaction_type,
+                                                uint32_t sub_type,
+                                                dps_endpoint_update_t *endpoint_update)
+{
+	ip_addr_t dps_client_address, vIP_address;
+	dps_tunnel_endpoint_t pIP_address;
+
+	// Network Order, same as dps_msg_endpoint_update
+	memcpy(&dps_client_address, &endpoint_update->dps_client_addr, sizeof(ip_addr_t));
+	memcpy(&vIP_address, &endpoint_update->vm_ip_addr, sizeof(ip_addr_t));
+	memset(&pIP_address, 0, sizeof(dps_tunnel_endpoint_t));
+	if (endpoint_update->tunnel_info.num_of_tunnels != 0)
+	{
+		memcpy(&pIP_address, &endpoint_update->tunnel_info.tunnel_list[0],
+		       sizeof(dps_tunnel_endpoint_t));
+	}
+	if (dps_client_address.family == AF_INET)
+	{
+		dps_client_address.ip4 = htonl(dps_client_address.ip4);
+	}
+	if (pIP_address.family == AF_INET)
+	{
+		pIP_address.ip4 = htonl(pIP_address.ip4);
+	}
+	if (vIP_address.family == AF_INET)
+	{
+		vIP_address.ip4 = htonl(vIP_address.ip4);
+	}
+	return Py_BuildValue("(IIIIIIz#IIz#z#Iz#II)",
+	                     domain_id,
+	                     dvg_id,
+	                     endpoint_update->vnid,
+	                     client_id,
+	                     transaction_type,
+	                     dps_client_address.family,
+	                     dps_client_address.ip6, 16,
+	                     dps_client_address.port,
+	                     pIP_address.family,
+	                     pIP_address.ip6, 16,
+	                     (char *)endpoint_update->mac, 6,
+	                     vIP_address.family,
+	                     vIP_address.ip6, 16,
+	                     sub_type, endpoint_update->version);
+}
+
+/*
+ ******************************************************************************
+ * dps_replication_batch_apply --                                         *//**
+ *
+ * \brief This routine hands a received batch of replicated Endpoint Updates
+ *        to PYTHON in a single Endpoint_Update_Batch call.
+ *        MUST NOT be called with the PYTHON GIL held.
+ *
+ * \param[in] domain_id The Domain ID
+ * \param[in] batch The batch
+ * \param[out] status_list The dps_resp_status_t of every entry
+ *
+ * \retval DPS_NO_ERR The batch was applied and status_list is valid
+ * \retval Other The batch wasn't applied
+ *
+ *****************************************************************************/
+
+dps_resp_status_t dps_replication_batch_apply(uint32_t domain_id,
+                                              dps_replication_batch_t *batch,
+                                              uint32_t *status_list)
+{
+	PyObject *strret, *strargs, *update_list, *update, *result;
+	PyGILState_STATE gstate;
+	dps_resp_status_t ret_code = DPS_NO_MEMORY;
+	dps_replication_entry_t *entry;
+	uint32_t i;
+
+	log_debug(PythonDataHandlerLogLevel, "Enter Domain Id %d, Channel %d, Seq %d",
+	          domain_id, batch->channel_id, batch->seq_num);
+
+	gstate = PyGILState_Ensure();
+	do
+	{
+		update_list = PyList_New(batch->num_entries);
+		if (update_list == NULL)
 		{
+			log_notice(PythonDataHandlerLogLevel, "PyList_New returns NULL");
 			break;
 		}
-		// Let the query handler take care of reply message
-		fFreeReplyMessage = 0;
-		if (query_id == 0)
+		for (i = 0; i < batch->num_entries; i++)
+		{
+			entry = &batch->entries[i];
+			update = dps_endpoint_update_batch_args(domain_id, entry->vnid,
+			                                        entry->client_id,
+			                                        DPS_TRANSACTION_REPLICATION,
+			                                        entry->sub_type,
+			                                        &entry->endpoint_update);
+			if (update == NULL)
+			{
+				break;
+			}
+			// Steals the reference
+			PyList_SET_ITEM(update_list, i, update);
+		}
+		if (i < batch->num_entries)
 		{
+			Py_DECREF(update_list);
+			log_notice(PythonDataHandlerLogLevel, "Py_BuildValue returns NULL");
 			break;
 		}
-
-		gstate = PyGILState_Ensure();
-		// Update Local Nodes data structures
-		//def Endpoint_Update(self, domain_id, dvg_id, vnid, client_type, transaction_type,
-		//                    dps_client_IP_type, dps_client_IP_packed, dps_client_port,
-		//                    pIP_type, pIP_packed,
-		//                    vMac, vIP_type, vIP_packed,
-		//                    operation, version):
-		strargs = Py_BuildValue("(IIIIIIz#IIz#z#Iz#II)",
-		                        domain_id,
-		                        dps_msg->hdr.vnid,
-		                        endpoint_update_msg->vnid,
-		                        dps_msg->hdr.client_id,
-		                        dps_msg->hdr.transaction_type,
-		                        dps_client_address.family,
-		                        dps_client_address.ip6, 16,
-		                        dps_client_address.port,
-		                        pIP_address.family,
-		                        pIP_address.ip6, 16,
-		                        (char *)endpoint_update_msg->mac, 6,
-		                        vIP_address[0].family,
-		                        vIP_address[0].ip6, 16,
-		                        dps_msg->hdr.sub_type, endpoint_update_msg->version);
+		//def Endpoint_Update_Batch(self, update_list):
+		strargs = Py_BuildValue("(O)", update_list);
+		Py_DECREF(update_list);
 		if (strargs == NULL)
 		{
-			// Let the request timeout
-			PyGILState_Release(gstate);
 			log_notice(PythonDataHandlerLogLevel, "Py_BuildValue returns NULL");
-			ret_code = DPS_NO_MEMORY;
 			break;
 		}
 
-		// Invoke the Endpoint_Update call
-		strret = PyEval_CallObject(Client_Protocol_Interface.Endpoint_Update, strargs);
+		strret = PyEval_CallObject(Client_Protocol_Interface.Endpoint_Update_Batch,
+		                           strargs);
 		Py_DECREF(strargs);
-
 		if (strret == NULL)
 		{
-			// Let the request timeout
-			PyGILState_Release(gstate);
 			log_warn(PythonDataHandlerLogLevel,
-			         "PyEval_CallObject Endpoint_Update returns NULL");
-			ret_code = DPS_NO_MEMORY;
+			         "PyEval_CallObject Endpoint_Update_Batch returns NULL");
 			break;
 		}
-
-		// Parse the return value (ret_val, version)
-		PyArg_ParseTuple(strret, "IIIO", &ret_code, &shared_address, &endpoint_update_msg->version, &py_vIP_List);
-
-		log_info(PythonDataHandlerLogLevel,
-		         "PYTHON Endpoint_Update: returns ret_code %d, shared_address %d, "
-		         "version %d, vIP_List size %d",
-		         ret_code, shared_address,
-		         endpoint_update_msg->version, PyList_Size(py_vIP_List));
-
-		// Copy the vIP_Address from the py_vIP_List into the Reply
-		for (i = 0; i < PyList_Size(py_vIP_List); i++)
+		if ((!PyList_Check(strret)) ||
+		    (PyList_Size(strret) != (Py_ssize_t)batch->num_entries))
 		{
-			PyObject *py_vIP;
-			if (i == MAX_VIP_ADDR)
-			{
-				break;
-			}
-			py_vIP = PyList_GetItem(py_vIP_List, i);
-			if (PyInt_CheckExact(py_vIP))
-			{
-				//IPv4
-				if (!PyArg_Parse(py_vIP, "I",
-				                 &dps_msg_reply->endpoint_update_reply.vm_ip_addr[i].ip4))
-				{
-					log_warn(PythonDataHandlerLogLevel,
-					         "Cannot get IPv4 address at vIP_List Index %d",
-					         i);
-					continue;
-				}
-				dps_msg_reply->endpoint_update_reply.vm_ip_addr[i].family = AF_INET;
-				dps_msg_reply->endpoint_update_reply.num_of_vip++;
-				inet_ntop(AF_INET, &dps_msg_reply->endpoint_update_reply.vm_ip_addr[i].ip4, str, INET6_ADDRSTRLEN);
-				log_info(PythonDataHandlerLogLevel,
-				         "Endpoint Update Reply [%d] vIP %s", i, str);
-				dps_msg_reply->endpoint_update_reply.vm_ip_addr[i].ip4 =
-					ntohl(dps_msg_reply->endpoint_update_reply.vm_ip_addr[i].ip4);
-			}
-			else
+			Py_DECREF(strret);
+			log_warn(PythonDataHandlerLogLevel,
+			         "Endpoint_Update_Batch: Invalid return value");
+			break;
+		}
+		// Only the status of the Endpoint_Update return value matters
+		for (i = 0; i < batch->num_entries; i++)
+		{
+			result = PyList_GET_ITEM(strret, i);
+			if ((!PyTuple_Check(result)) || (PyTuple_Size(result) == 0) ||
+			    (!PyArg_Parse(PyTuple_GET_ITEM(result, 0), "I", &status_list[i])))
 			{
-				char *ipv6;
-				int ipv6_size;
-				//Assume IPv6
-				//IPv4
-				if (!PyArg_Parse(py_vIP, "z#", &ipv6, &ipv6_size))
-				{
-					log_warn(PythonDataHandlerLogLevel,
-					         "Cannot get IPv6 address at vIP_List Index %d",
-					         i);
-					continue;
-				}
-				dps_msg_reply->endpoint_update_reply.vm_ip_addr[i].family = AF_INET6;
-				memcpy(dps_msg_reply->endpoint_update_reply.vm_ip_addr[i].ip6,
-				       ipv6, ipv6_size);
-				dps_msg_reply->endpoint_update_reply.num_of_vip++;
-				inet_ntop(AF_INET6, dps_msg_reply->endpoint_update_reply.vm_ip_addr[i].ip6, str, INET6_ADDRSTRLEN);
-				log_info(PythonDataHandlerLogLevel,
-				         "Endpoint Update Reply [%d] vIP %s", i, str);
+				status_list[i] = DPS_ERROR_RETRY;
 			}
+		}
+		Py_DECREF(strret);
+		ret_code = DPS_NO_ERR;
+	} while(0);
+	PyGILState_Release(gstate);
+
+	log_debug(PythonDataHandlerLogLevel, "Exit: status %d", ret_code);
+
+	return ret_code;
+}
+
+/*
+ ******************************************************************************
+ * dps_msg_endpoint_update_check --                                       *//**
+ *
+ * \brief This routine checks the addresses in an Endpoint Update
+ *
+ * \param endpoint_update_msg The Endpoint Update
+ *
+ * \retval DPS_SUCCESS The addresses are valid
+ * \retval DPS_ERROR The Endpoint Update must be failed with
+ *                   DPS_INVALID_SRC_IP
+ *
+ *****************************************************************************/
 
+static dps_return_status dps_msg_endpoint_update_check(dps_endpoint_update_t *endpoint_update_msg)
+{
+	if ((endpoint_update_msg->dps_client_addr.family != AF_INET) &&
+	    (endpoint_update_msg->dps_client_addr.family != AF_INET6))
+	{
+		return DPS_ERROR;
+	}
+	if (endpoint_update_msg->tunnel_info.num_of_tunnels != 0)
+	{
+		if ((endpoint_update_msg->tunnel_info.tunnel_list[0].family != AF_INET) &&
+		    (endpoint_update_msg->tunnel_info.tunnel_list[0].family != AF_INET6))
+		{
+			return DPS_ERROR;
 		}
-		log_info(PythonDataHandlerLogLevel, "Tunnel Info: Family %d",
-		         dps_msg_reply->endpoint_update_reply.tunnel_info.tunnel_list[0].family);
+	}
+	if ((endpoint_update_msg->vm_ip_addr.family != AF_INET) &&
+	    (endpoint_update_msg->vm_ip_addr.family != AF_INET6))
+	{
+		return DPS_ERROR;
+	}
+	return DPS_SUCCESS;
+}
 
-		// Lose the reference on all parameters and return arguments since they
-		// are no longer needed.
-		Py_DECREF(strret);
-		PyGILState_Release(gstate);
+/*
+ ******************************************************************************
+ * dps_msg_endpoint_update_reply_form --                                  *//**
+ *
+ * \brief This routine copies the PYTHON Endpoint_Update return value
+ *        (ret_val, ip_mode, version, vIP_Addresses) into the Endpoint Update
+ *        Reply. The PYTHON GIL MUST be held by the caller.
+ *
+ * \param strret The Endpoint_Update return value
+ * \param dps_msg_reply The Reply Message formed by
+ *                      dps_form_endpoint_update_reply
+ * \param shared_address 1 if the vIP is in the Shared Address Space
+ *
+ * \return dps_resp_status_t returned by Endpoint_Update
+ *
+ *****************************************************************************/
+
+static uint32_t dps_msg_endpoint_update_reply_form(PyObject *strret,
+                                                   dps_client_data_t *dps_msg_reply,
+                                                   uint32_t *shared_address)
+{
+	PyObject *py_vIP_List;
+	uint32_t ret_code = DPS_NO_MEMORY;
+	uint32_t version = 0;
+	char str[INET6_ADDRSTRLEN];
+	int i;
+
+	*shared_address = 0;
+	// Parse the return value (ret_val, shared_address, version, vIP_List)
+	if (!PyArg_ParseTuple(strret, "IIIO", &ret_code, shared_address, &version, &py_vIP_List))
+	{
+		log_warn(PythonDataHandlerLogLevel,
+		         "Endpoint_Update: Invalid return value");
+		return DPS_NO_MEMORY;
+	}
+
+	log_info(PythonDataHandlerLogLevel,
+	         "PYTHON Endpoint_Update: returns ret_code %d, shared_address %d, "
+	         "version %d, vIP_List size %d",
+	         ret_code, *shared_address, version, PyList_Size(py_vIP_List));
 
-		// Handle Shared Address Space
-		if ((ret_code == DPS_NO_ERR) &&
-		    (dps_msg->hdr.transaction_type == DPS_TRANSACTION_NORMAL) &&
-		    (shared_address))
-		{
-			// Send the original message to the node which handles vnid 0
-			// Modify the header to indicate VNID 0 and use the local query
-			// id
-			dps_msg->hdr.vnid = SHARED_ADDR_SPACE_VNID;
-			dps_msg->hdr.query_id = query_id;
-			dps_msg->endpoint_update.version = 0;
-			// Replace the Sender IP with local IP so that the reply
-			// comes back here
-			memcpy(&dps_msg->hdr.reply_addr, &dcs_local_ip, sizeof(ip_addr_t));
-			if (dps_msg->hdr.reply_addr.family == AF_INET)
+	// Copy the vIP_Address from the py_vIP_List into the Reply
+	for (i = 0; i < PyList_Size(py_vIP_List); i++)
+	{
+		PyObject *py_vIP;
+		if (i == MAX_VIP_ADDR)
+		{
+			break;
+		}
+		py_vIP = PyList_GetItem(py_vIP_List, i);
+		if (PyInt_CheckExact(py_vIP))
+		{
+			//IPv4
+			if (!PyArg_Parse(py_vIP, "I",
+			                 &dps_msg_reply->endpoint_update_reply.vm_ip_addr[i].ip4))
 			{
-				dps_msg->hdr.reply_addr.ip4 = ntohl(dps_msg->hdr.reply_addr.ip4);
+				log_warn(PythonDataHandlerLogLevel,
+				         "Cannot get IPv4 address at vIP_List Index %d",
+				         i);
+				continue;
 			}
-			dps_msg_endpoint_update(0, dps_msg);
+			dps_msg_reply->endpoint_update_reply.vm_ip_addr[i].family = AF_INET;
+			dps_msg_reply->endpoint_update_reply.num_of_vip++;
+			inet_ntop(AF_INET, &dps_msg_reply->endpoint_update_reply.vm_ip_addr[i].ip4, str, INET6_ADDRSTRLEN);
+			log_info(PythonDataHandlerLogLevel,
+			         "Endpoint Update Reply [%d] vIP %s", i, str);
+			dps_msg_reply->endpoint_update_reply.vm_ip_addr[i].ip4 =
+				ntohl(dps_msg_reply->endpoint_update_reply.vm_ip_addr[i].ip4);
 		}
 		else
 		{
-			gstate = PyGILState_Ensure();
-			//Process the local node replication
-			//def ReplicationReplyProcess(self, replication_query_id, dps_protocol_status)
-			strargs = Py_BuildValue("(II)", query_id, ret_code);
-			if (strargs == NULL)
+			char *ipv6;
+			int ipv6_size;
+			//Assume IPv6
+			//IPv4
+			if (!PyArg_Parse(py_vIP, "z#", &ipv6, &ipv6_size))
 			{
-				// No need to reply - ReplicationReplyProcess
-				// Let it timeout, unfortunately there is no better :(
-				// If we send the message and clean out the structure
-				// then the Python routine when it does timeout will
-				// crash on the reply message
-				PyGILState_Release(gstate);
 				log_warn(PythonDataHandlerLogLevel,
-				         "Cannot allocate arguments for local replication reply");
-				break;
+				         "Cannot get IPv6 address at vIP_List Index %d",
+				         i);
+				continue;
 			}
+			dps_msg_reply->endpoint_update_reply.vm_ip_addr[i].family = AF_INET6;
+			memcpy(dps_msg_reply->endpoint_update_reply.vm_ip_addr[i].ip6,
+			       ipv6, ipv6_size);
+			dps_msg_reply->endpoint_update_reply.num_of_vip++;
+			inet_ntop(AF_INET6, dps_msg_reply->endpoint_update_reply.vm_ip_addr[i].ip6, str, INET6_ADDRSTRLEN);
+			log_info(PythonDataHandlerLogLevel,
+			         "Endpoint Update Reply [%d] vIP %s", i, str);
+		}
+
+	}
+	log_info(PythonDataHandlerLogLevel, "Tunnel Info: Family %d",
+	         dps_msg_reply->endpoint_update_reply.tunnel_info.tunnel_list[0].family);
+
+	return ret_code;
+}
+
+static dps_return_status dps_msg_endpoint_update(uint32_t domain_id,
+                                                 dps_client_data_t *dps_msg);
+
+/*
+ ******************************************************************************
+ * dps_msg_endpoint_update_replicate --                                   *//**
+ *
+ * \brief This routine completes a DPS_TRANSACTION_NORMAL Endpoint Update
+ *        once PYTHON has applied it locally: the update is handed to the
+ *        Replication Channels, which send the reply, and forwarded to the
+ *        Shared Address Space if needed. MUST NOT be called with the PYTHON
+ *        GIL held.
+ *
+ * \param domain_id The Domain ID
+ * \param dps_msg The Endpoint Update as received from the DPS Client
+ * \param dps_msg_reply The Reply Message. Owned by this routine.
+ * \param ret_code The dps_resp_status_t returned by PYTHON
+ * \param shared_address 1 if the vIP is in the Shared Address Space
+ *
+ *****************************************************************************/
+
+static void dps_msg_endpoint_update_replicate(uint32_t domain_id,
+                                              dps_client_data_t *dps_msg,
+                                              dps_client_data_t *dps_msg_reply,
+                                              uint32_t ret_code,
+                                              uint32_t shared_address)
+{
+	dps_replication_entry_t replication_entry;
+	uint32_t query_id = 0;
+
+	// The reply waits for the other nodes unless the local
+	// node already failed the update
+	if (ret_code != DPS_NO_ERR)
+	{
+		dps_msg_reply_send_and_free(dps_msg_reply, ret_code);
+		return;
+	}
+	memset(&replication_entry, 0, sizeof(dps_replication_entry_t));
+	replication_entry.vnid = dps_msg->hdr.vnid;
+	replication_entry.sub_type = dps_msg->hdr.sub_type;
+	replication_entry.client_id = dps_msg->hdr.client_id;
+	memcpy(&replication_entry.endpoint_update, &dps_msg->endpoint_update,
+	       sizeof(dps_endpoint_update_t));
+	if (dps_replication_update_queue(domain_id,
+	                                 &replication_entry,
+	                                 dps_msg_reply,
+	                                 shared_address ? 1 : 0,
+	                                 &query_id) != DOVE_STATUS_OK)
+	{
+		dps_msg_reply_send_and_free(dps_msg_reply, DPS_NO_MEMORY);
+		return;
+	}
+
+	// Handle Shared Address Space
+	if (shared_address)
+	{
+		// Send the original message to the node which handles vnid 0
+		// Modify the header to indicate VNID 0 and use the local query
+		// id
+		dps_msg->hdr.vnid = SHARED_ADDR_SPACE_VNID;
+		dps_msg->hdr.query_id = query_id;
+		dps_msg->endpoint_update.version = 0;
+		// Replace the Sender IP with local IP so that the reply
+		// comes back here
+		memcpy(&dps_msg->hdr.reply_addr, &dcs_local_ip, sizeof(ip_addr_t));
+		if (dps_msg->hdr.reply_addr.family == AF_INET)
+		{
+			dps_msg->hdr.reply_addr.ip4 = ntohl(dps_msg->hdr.reply_addr.ip4);
+		}
+		dps_msg_endpoint_update(0, dps_msg);
+	}
+	return;
+}
+
+/*
+ ******************************************************************************
+ * dps_protocol_batch_update_flush --                                     *//**
+ *
+ * \brief This routine hands all the Endpoint Updates in the batch to PYTHON
+ *        in a single Endpoint_Update_Batch call i.e. with one GIL
+ *        acquisition, and then hands them to the Replication Channels. If
+ *        PYTHON cannot be called the updates are dropped and the DPS Clients
+ *        retransmit them, same as when they are handled one by one.
+ *
+ * \param batch The batch of the calling DPS Protocol Handler Thread
+ *
+ *****************************************************************************/
+
+static void dps_protocol_batch_update_flush(dps_protocol_batch_t *batch)
+{
+	dps_protocol_batch_update_t *entry;
+	dps_client_data_t dps_msg;
+	PyObject *strret, *strargs, *update_list, *update;
+	PyGILState_STATE gstate;
+	uint32_t i, j, num_updates;
+	int fApplied = 0;
+
+	if (batch->update_count == 0)
+	{
+		return;
+	}
+
+	log_debug(PythonDataHandlerLogLevel, "Enter Count %d", batch->update_count);
+
+	batch->flushing = 1;
+	dps_msg.context = NULL;
+	num_updates = 0;
+	for (i = 0; i < batch->update_count; i++)
+	{
+		entry = &batch->updates[i];
+		entry->ret_code = DPS_NO_MEMORY;
+		entry->shared_address = 0;
+		entry->reply = (dps_client_data_t *)malloc(sizeof(dps_client_data_t));
+		if (entry->reply == NULL)
+		{
+			continue;
+		}
+		memcpy(&dps_msg.hdr, &entry->hdr, sizeof(dps_client_hdr_t));
+		memcpy(&dps_msg.endpoint_update, &entry->endpoint_update,
+		       sizeof(dps_endpoint_update_t));
+		dps_form_endpoint_update_reply(entry->reply, &dps_msg, DPS_NO_ERR);
+		num_updates++;
+	}
+
+	gstate = PyGILState_Ensure();
+	do
+	{
+		if (num_updates == 0)
+		{
+			break;
+		}
+		update_list = PyList_New(num_updates);
+		if (update_list == NULL)
+		{
+			log_notice(PythonDataHandlerLogLevel, "PyList_New returns NULL");
+			break;
+		}
+		for (i = 0, j = 0; i < batch->update_count; i++)
+		{
+			entry = &batch->updates[i];
+			if (entry->reply == NULL)
+			{
+				continue;
+			}
+			update = dps_endpoint_update_batch_args(entry->domain,
+			                                        entry->hdr.vnid,
+			                                        entry->hdr.client_id,
+			                                        entry->hdr.transaction_type,
+			                                        entry->hdr.sub_type,
+			                                        &entry->endpoint_update);
+			if (update == NULL)
+			{
+				break;
+			}
+			// Steals the reference
+			PyList_SET_ITEM(update_list, j, update);
+			j++;
+		}
+		if (i < batch->update_count)
+		{
+			Py_DECREF(update_list);
+			log_notice(PythonDataHandlerLogLevel, "Py_BuildValue returns NULL");
+			break;
+		}
+		//def Endpoint_Update_Batch(self, update_list):
+		strargs = Py_BuildValue("(O)", update_list);
+		Py_DECREF(update_list);
+		if (strargs == NULL)
+		{
+			log_notice(PythonDataHandlerLogLevel, "Py_BuildValue returns NULL");
+			break;
+		}
+
+		strret = PyEval_CallObject(Client_Protocol_Interface.Endpoint_Update_Batch,
+		                           strargs);
+		Py_DECREF(strargs);
+		if (strret == NULL)
+		{
+			log_warn(PythonDataHandlerLogLevel,
+			         "PyEval_CallObject Endpoint_Update_Batch returns NULL");
+			break;
+		}
+		if ((!PyList_Check(strret)) ||
+		    (PyList_Size(strret) != (Py_ssize_t)num_updates))
+		{
+			Py_DECREF(strret);
+			log_warn(PythonDataHandlerLogLevel,
+			         "Endpoint_Update_Batch: Invalid return value");
+			break;
+		}
+		for (i = 0, j = 0; i < batch->update_count; i++)
+		{
+			entry = &batch->updates[i];
+			if (entry->reply == NULL)
+			{
+				continue;
+			}
+			entry->ret_code = dps_msg_endpoint_update_reply_form(PyList_GET_ITEM(strret, j),
+			                                                     entry->reply,
+			                                                     &entry->shared_address);
+			j++;
+		}
+		Py_DECREF(strret);
+		fApplied = 1;
+	} while(0);
+	PyGILState_Release(gstate);
+
+	for (i = 0; i < batch->update_count; i++)
+	{
+		entry = &batch->updates[i];
+		if (entry->reply == NULL)
+		{
+			continue;
+		}
+		if (!fApplied)
+		{
+			// Let the request timeout
+			free(entry->reply);
+			continue;
+		}
+		memcpy(&dps_msg.hdr, &entry->hdr, sizeof(dps_client_hdr_t));
+		memcpy(&dps_msg.endpoint_update, &entry->endpoint_update,
+		       sizeof(dps_endpoint_update_t));
+		dps_msg_endpoint_update_replicate(entry->domain, &dps_msg,
+		                                  entry->reply, entry->ret_code,
+		                                  entry->shared_address);
+	}
+	batch->update_count = 0;
+	batch->flushing = 0;
+
+	log_debug(PythonDataHandlerLogLevel, "Exit");
+
+	return;
+}
+
+/*
+ ******************************************************************************
+ * dps_msg_endpoint_update_batch_add --                                   *//**
+ *
+ * \brief This routine adds a DPS_TRANSACTION_NORMAL Endpoint Update to the
+ *        batch of the calling thread if the thread is draining a burst of
+ *        messages. The batch is flushed when full.
+ *
+ * \param domain_id The Domain ID
+ * \param dps_msg The DPS Client Server Protocol Message for Endpoint Update
+ *
+ * \retval DPS_SUCCESS The update was added to the batch
+ * \retval DPS_ERROR The thread isn't batching, handle the update now
+ *
+ *****************************************************************************/
+
+static dps_return_status dps_msg_endpoint_update_batch_add(uint32_t domain_id,
+                                                           dps_client_data_t *dps_msg)
+{
+	dps_protocol_batch_t *batch;
+	dps_protocol_batch_update_t *entry;
+
+	if ((dps_msg->hdr.transaction_type != DPS_TRANSACTION_NORMAL) ||
+	    (dps_msg_endpoint_update_check(&dps_msg->endpoint_update) != DPS_SUCCESS))
+	{
+		return DPS_ERROR;
+	}
+	pthread_once(&batch_key_once, batch_key_create);
+	batch = (dps_protocol_batch_t *)pthread_getspecific(batch_key);
+	if ((batch == NULL) || (!batch->active) || (batch->flushing))
+	{
+		return DPS_ERROR;
+	}
+	if (batch->update_count == DPS_PROTOCOL_BATCH_SZ)
+	{
+		dps_protocol_batch_update_flush(batch);
+	}
+	entry = &batch->updates[batch->update_count];
+	entry->domain = domain_id;
+	memcpy(&entry->hdr, &dps_msg->hdr, sizeof(dps_client_hdr_t));
+	memcpy(&entry->endpoint_update, &dps_msg->endpoint_update,
+	       sizeof(dps_endpoint_update_t));
+	batch->update_count++;
+	return DPS_SUCCESS;
+}
+
+/*
+ ******************************************************************************
+ * dps_msg_endpoint_update --                                             *//**
+ *
+ * \brief This routine handles Endpoint Update
+ *
+ * \param domain_id The Domain ID
+ * \param dps_msg The DPS Client Server Protocol Message for Endpoint Update
+ *
+ * \retval DOVE_STATUS_OK
+ *
+ *****************************************************************************/
+
+static dps_return_status dps_msg_endpoint_update(uint32_t domain_id,
+                                                 dps_client_data_t *dps_msg)
+{
+	ip_addr_t dps_client_address, sender_client_address, vIP_address;
+	dps_tunnel_endpoint_t pIP_address;
+	dps_client_data_t *dps_msg_reply = NULL;
+	dps_endpoint_update_t *endpoint_update_msg = NULL;
+	PyObject *strret, *strargs;
+	PyGILState_STATE gstate;
+	size_t dps_msg_size;
+	uint32_t query_id = 0;
+	uint32_t ret_code = DPS_NO_MEMORY; // dps_resp_status_t
+	uint32_t shared_address = 0; // 0 Dedicated, 1 Shared
+	int fFreeReplyMessage = 0;
+	int fReplicationChannel = 0;
+	char str[INET6_ADDRSTRLEN];
+
+	log_debug(PythonDataHandlerLogLevel, "Enter Domain Id %d", domain_id);
+
+	// While a burst is being drained PYTHON gets all the updates at once
+	if (dps_msg_endpoint_update_batch_add(domain_id, dps_msg) == DPS_SUCCESS)
+	{
+		log_debug(PythonDataHandlerLogLevel, "Exit: Batched");
+		return DPS_SUCCESS;
+	}
+
+	do
+	{
+		//Create the Reply Message
+		dps_msg_reply = (dps_client_data_t *)malloc(sizeof(dps_client_data_t));
+		if (dps_msg_reply == NULL)
+		{
+			break;
+		}
+		fFreeReplyMessage = 1;
+		log_debug(PythonDataHandlerLogLevel, "Allocated Message %p:%d",
+		          dps_msg_reply, sizeof(dps_client_data_t));
+		dps_form_endpoint_update_reply(dps_msg_reply, dps_msg, DPS_NO_ERR);
+
+		endpoint_update_msg = (dps_endpoint_update_t *)&dps_msg->endpoint_update;
+
+		if (dps_msg_endpoint_update_check(endpoint_update_msg) != DPS_SUCCESS)
+		{
+			ret_code = DPS_INVALID_SRC_IP;
+			break;
+		}
+		// Copy the Addresses so that they can be converted to Network Order
+		memcpy(&sender_client_address, &dps_msg->hdr.reply_addr, sizeof(ip_addr_t));
+		memcpy(&dps_client_address, &endpoint_update_msg->dps_client_addr, sizeof(ip_addr_t));
+		memcpy(&pIP_address, &endpoint_update_msg->tunnel_info.tunnel_list[0], sizeof(dps_tunnel_endpoint_t));
+		memcpy(&vIP_address, &endpoint_update_msg->vm_ip_addr, sizeof(ip_addr_t));
+
+		if(sender_client_address.family == AF_INET)
+		{
+			sender_client_address.ip4 = htonl(sender_client_address.ip4);
+		}
+		if(dps_client_address.family == AF_INET)
+		{
+			dps_client_address.ip4 = htonl(dps_client_address.ip4);
+		}
+		if(pIP_address.family == AF_INET)
+		{
+			pIP_address.ip4 = htonl(pIP_address.ip4);
+		}
+		if(vIP_address.family == AF_INET)
+		{
+			vIP_address.ip4 = htonl(vIP_address.ip4);
+		}
+		{
+			log_info(PythonDataHandlerLogLevel, "VNID %d", dps_msg->hdr.vnid);
+			inet_ntop(sender_client_address.family, sender_client_address.ip6, str, INET6_ADDRSTRLEN);
+			log_info(PythonDataHandlerLogLevel, "Sender IP %s, Port %d",
+			          str, sender_client_address.port);
+			inet_ntop(dps_client_address.family, dps_client_address.ip6, str, INET6_ADDRSTRLEN);
+			log_info(PythonDataHandlerLogLevel, "DPS Client %s, Port %d",
+			          str, dps_client_address.port);
+			inet_ntop(pIP_address.family, pIP_address.ip6, str, INET6_ADDRSTRLEN);
+			log_info(PythonDataHandlerLogLevel, "DOVE Switch %s", str);
+			inet_ntop(vIP_address.family, vIP_address.ip6, str, INET6_ADDRSTRLEN);
+			log_info(PythonDataHandlerLogLevel, "Endpoint IP %s", str);
+			log_info(PythonDataHandlerLogLevel, "Endpoint Mac " MAC_FMT,
+			          MAC_OCTETS(dps_msg->endpoint_update.mac));
+			log_info(PythonDataHandlerLogLevel, "Query ID %d", dps_msg->hdr.query_id);
+			log_info(PythonDataHandlerLogLevel, "Sub Type %d", dps_msg->hdr.sub_type);
+			log_info(PythonDataHandlerLogLevel, "Sender Type %d", dps_msg->hdr.client_id);
+			log_info(PythonDataHandlerLogLevel, "Transaction Type %d", dps_msg->hdr.transaction_type);
+			log_info(PythonDataHandlerLogLevel, "Version %d", endpoint_update_msg->version);
+		}
+
+		if (dps_msg->hdr.transaction_type == DPS_TRANSACTION_NORMAL)
+		{
+			// The other nodes get the update on the Replication Channels
+			// once it's applied locally
+			fReplicationChannel = 1;
+		}
+		else
+		{
+			// Check if there are other nodes this request should be forwarded to.
+			dps_msg_size = dps_offsetof(dps_client_data_t,
+			                            endpoint_update.tunnel_info.tunnel_list[endpoint_update_msg->tunnel_info.num_of_tunnels]);
+			ret_code = dps_update_replicate(domain_id,
+			                                dps_msg,
+			                                dps_msg_reply,
+			                                dps_msg_size,
+			                                &query_id);
+			if (ret_code != DPS_NO_ERR)
+			{
+				break;
+			}
+			// Let the query handler take care of reply message
+			fFreeReplyMessage = 0;
+			if (query_id == 0)
+			{
+				break;
+			}
+		}
+
+		gstate = PyGILState_Ensure();
+		// Update Local Nodes data structures
+		//def Endpoint_Update(self, domain_id, dvg_id, vnid, client_type, transaction_type,
+		//                    dps_client_IP_type, dps_client_IP_packed, dps_client_port,
+		//                    pIP_type, pIP_packed,
+		//                    vMac, vIP_type, vIP_packed,
+		//                    operation, version):
+		strargs = Py_BuildValue("(IIIIIIz#IIz#z#Iz#II)",
+		                        domain_id,
+		                        dps_msg->hdr.vnid,
+		                        endpoint_update_msg->vnid,
+		                        dps_msg->hdr.client_id,
+		                        dps_msg->hdr.transaction_type,
+		                        dps_client_address.family,
+		                        dps_client_address.ip6, 16,
+		                        dps_client_address.port,
+		                        pIP_address.family,
+		                        pIP_address.ip6, 16,
+		                        (char *)endpoint_update_msg->mac, 6,
+		                        vIP_address.family,
+		                        vIP_address.ip6, 16,
+		                        dps_msg->hdr.sub_type, endpoint_update_msg->version);
+		if (strargs == NULL)
+		{
+			// Let the request timeout
+			PyGILState_Release(gstate);
+			log_notice(PythonDataHandlerLogLevel, "Py_BuildValue returns NULL");
+			ret_code = DPS_NO_MEMORY;
+			break;
+		}
+
+		// Invoke the Endpoint_Update call
+		strret = PyEval_CallObject(Client_Protocol_Interface.Endpoint_Update, strargs);
+		Py_DECREF(strargs);
+
+		if (strret == NULL)
+		{
+			// Let the request timeout
+			PyGILState_Release(gstate);
+			log_warn(PythonDataHandlerLogLevel,
+			         "PyEval_CallObject Endpoint_Update returns NULL");
+			ret_code = DPS_NO_MEMORY;
+			break;
+		}
+
+		ret_code = dps_msg_endpoint_update_reply_form(strret, dps_msg_reply,
+		                                              &shared_address);
+
+		// Lose the reference on all parameters and return arguments since they
+		// are no longer needed.
+		Py_DECREF(strret);
+		PyGILState_Release(gstate);
+
+		if (fReplicationChannel)
+		{
+			fFreeReplyMessage = 0;
+			dps_msg_endpoint_update_replicate(domain_id, dps_msg, dps_msg_reply,
+			                                  ret_code, shared_address);
+		}
+		else
+		{
+			gstate = PyGILState_Ensure();
+			//Process the local node replication
+			//def ReplicationReplyProcess(self, replication_query_id, dps_protocol_status)
+			strargs = Py_BuildValue("(II)", query_id, ret_code);
+			if (strargs == NULL)
+			{
+				// No need to reply - ReplicationReplyProcess
+				// Let it timeout, unfortunately there is no better :(
+				// If we send the message and clean out the structure
+				// then the Python routine when it does timeout will
+				// crash on the reply message
+				PyGILState_Release(gstate);
+				log_warn(PythonDataHandlerLogLevel,
+				         "Cannot allocate arguments for local replication reply");
+				break;
+			}
+
+			// Add the query ID to the dictionary to track the replies
+			strret = PyEval_CallObject(Replication_Interface.ReplicationReplyProcess,
+			                           strargs);
+
+			Py_DECREF(strargs);
+
+			if (strret == NULL)
+			{
+				PyGILState_Release(gstate);
+				log_warn(PythonDataHandlerLogLevel,
+				         "PyEval_CallObject ReplicationReplyProcess returns NULL");
+				break;
+			}
+			// Lose the reference on all parameters and return arguments since they
+			// are no longer needed.
+			Py_DECREF(strret);
+			PyGILState_Release(gstate);
+			log_info(PythonDataHandlerLogLevel,
+			         "Processed Local Query ID %d",
+			         query_id);
+		}
+
+	}while(0);
+
+	if ((fFreeReplyMessage) && (dps_msg_reply != NULL))
+	{
+		free(dps_msg_reply);
+	}
+
+	log_debug(PythonDataHandlerLogLevel, "Exit");
+
+	return (ret_code == DPS_NO_ERR ? DPS_SUCCESS: DPS_ERROR);
+}
+
+/*
+ ******************************************************************************
+ * dps_msg_endpoint_request_index --                                      *//**
+ *
+ * \brief This routine tries to answer an Endpoint Request from the native
+ *        Endpoint Index without taking the PYTHON GIL.
+ *
+ * \param domain The Domain ID
+ * \param dps_msg The DPS Client Server Protocol Message for Endpoint Request
+ * \param dps_msg_reply The Reply Message with the header already filled in
+ *
+ * \retval DPS_SUCCESS The reply was sent
+ * \retval DPS_ERROR The index cannot answer, PYTHON must handle the request
+ *
+ *****************************************************************************/
+
+static dps_return_status dps_msg_endpoint_request_index(uint32_t domain,
+                                                        dps_client_data_t *dps_msg,
+                                                        dps_client_data_t *dps_msg_reply)
+{
+	dps_client_data_t *pdps_msg_reply = dps_msg_reply;
+	dps_endpoint_loc_req_t *endpoint_loc_msg = &dps_msg->endpoint_loc_req;
+	uint32_t num_tunnels, max_tunnels;
+	size_t dps_msg_reply_size;
+	dove_status status;
+
+	if ((endpoint_loc_msg->vm_ip_addr.ip4 != 0) &&
+	    (endpoint_loc_msg->dps_client_addr.family != AF_INET) &&
+	    (endpoint_loc_msg->dps_client_addr.family != AF_INET6))
+	{
+		// PYTHON reports the invalid DPS Client
+		return DPS_ERROR;
+	}
+
+	max_tunnels = (sizeof(dps_client_data_t) -
+	               dps_offsetof(dps_client_data_t,
+	                            endpoint_loc_reply.tunnel_info.tunnel_list[0])) /
+	              sizeof(dps_tunnel_endpoint_t);
+	status = dps_endpoint_index_lookup(domain, endpoint_loc_msg,
+	                                   &pdps_msg_reply->endpoint_loc_reply,
+	                                   max_tunnels, &num_tunnels);
+	if (status == DOVE_STATUS_EXCEEDS_CAP)
+	{
+		dps_msg_reply_size = dps_offsetof(dps_client_data_t,
+		                                  endpoint_loc_reply.tunnel_info.tunnel_list[num_tunnels]);
+		pdps_msg_reply = (dps_client_data_t *)malloc(dps_msg_reply_size);
+		if (pdps_msg_reply == NULL)
+		{
+			return DPS_ERROR;
+		}
+		memcpy(pdps_msg_reply, dps_msg_reply, sizeof(dps_client_data_t));
+		// The record may have changed in between, in which case PYTHON
+		// handles the request
+		status = dps_endpoint_index_lookup(domain, endpoint_loc_msg,
+		                                   &pdps_msg_reply->endpoint_loc_reply,
+		                                   num_tunnels, &num_tunnels);
+	}
+	if (status == DOVE_STATUS_OK)
+	{
+		pdps_msg_reply->hdr.sub_type = DPS_ENDPOINT_LOC_REPLY_VM;
+		pdps_msg_reply->hdr.resp_status = DPS_NO_ERR;
+		log_debug(PythonDataHandlerLogLevel,
+		          "Endpoint_Request: Domain %d, vnid %d served from index",
+		          domain, pdps_msg_reply->endpoint_loc_reply.vnid);
+		dps_msg_send_inline(pdps_msg_reply);
+	}
+	if (pdps_msg_reply != dps_msg_reply)
+	{
+		free(pdps_msg_reply);
+	}
+
+	return (status == DOVE_STATUS_OK) ? DPS_SUCCESS : DPS_ERROR;
+}
+
+/*
+ ******************************************************************************
+ * dps_msg_endpoint_reply_hdr --                                          *//**
+ *
+ * \brief This routine forms the header of the Endpoint Location Reply
+ *
+ * \param dps_msg The DPS Client Server Protocol Message for Endpoint Request
+ * \param dps_msg_reply The Reply Message
+ *
+ *****************************************************************************/
+
+static void dps_msg_endpoint_reply_hdr(dps_client_data_t *dps_msg,
+                                       dps_client_data_t *dps_msg_reply)
+{
+	dps_msg_reply->context = NULL;
+	dps_msg_reply->hdr.type = DPS_ENDPOINT_LOC_REPLY;
+	dps_msg_reply->hdr.vnid = dps_msg->hdr.vnid;
+	dps_msg_reply->hdr.query_id = dps_msg->hdr.query_id;
+	dps_msg_reply->hdr.client_id = DPS_POLICY_SERVER_ID;
+	dps_msg_reply->hdr.transaction_type = DPS_TRANSACTION_NORMAL;
+	dps_msg_reply->hdr.resp_status = DPS_NO_MEMORY;
+	memcpy(&dps_msg_reply->hdr.reply_addr,
+	       &dps_msg->endpoint_loc_req.dps_client_addr,
+	       sizeof(ip_addr_t));
+	return;
+}
+
+/*
+ ******************************************************************************
+ * dps_msg_endpoint_reply_form --                                         *//**
+ *
+ * \brief This routine fills in the Endpoint Location Reply from the value
+ *        returned by the PYTHON Endpoint_Location_vIP/Endpoint_Location_vMac
+ *        routines. The PYTHON GIL MUST be held by the caller.
+ *
+ * \param dps_msg The DPS Client Server Protocol Message for Endpoint Request
+ * \param strret The PYTHON return value
+ * \param ppdps_msg_reply The Reply Message with the header already formed.
+ *                        If the tunnel list doesn't fit a bigger Reply
+ *                        Message is allocated and returned here.
+ * \param pfreplymsgallocated Set to 1 if the Reply Message was allocated
+ *
+ * \retval DPS_SUCCESS The Endpoint was found
+ * \retval DPS_ERROR The Endpoint was not found
+ *
+ *****************************************************************************/
+
+static dps_return_status dps_msg_endpoint_reply_form(dps_client_data_t *dps_msg,
+                                                     PyObject *strret,
+                                                     dps_client_data_t **ppdps_msg_reply,
+                                                     int *pfreplymsgallocated)
+{
+	dps_client_data_t *pdps_msg_reply = *ppdps_msg_reply;
+	dps_endpoint_loc_req_t *endpoint_loc_msg = &dps_msg->endpoint_loc_req;
+	dps_return_status return_status = DPS_ERROR;
+	int ret_code; // dps_resp_status_t
+	uint32_t dvg, version;
+	char *vIP_ret_packed, *vMac_ret;
+	PyObject *pyList_ipv4, *pyList_ipv6;
+	int vIP_ret_packed_size, vMac_ret_size;
+	unsigned int fGateway = 0;
+
+	//@return: status, dvg_id, version, pIP_packed, vMac, vIP_packed
+	//@rtype: Integer, Integer, Integer, ByteArray, ByteArray
+	if (!PyArg_ParseTuple(strret, "IIIOOz#z#I", &ret_code, &dvg, &version,
+	                      &pyList_ipv4, &pyList_ipv6,
+	                      &vMac_ret, &vMac_ret_size,
+	                      &vIP_ret_packed, &vIP_ret_packed_size, &fGateway))
+	{
+		log_warn(PythonDataHandlerLogLevel,
+		         "Endpoint_Request: Invalid PYTHON return value");
+		PyErr_Clear();
+		return return_status;
+	}
+
+	if (fGateway)
+	{
+		pdps_msg_reply->hdr.sub_type = DPS_ENDPOINT_LOC_REPLY_GW;
+	}
+	else
+	{
+		pdps_msg_reply->hdr.sub_type = DPS_ENDPOINT_LOC_REPLY_VM;
+	}
+	pdps_msg_reply->hdr.resp_status = ret_code;
+	pdps_msg_reply->endpoint_loc_reply.vnid = dvg;
+#if defined(NDEBUG)
+	log_info(PythonDataHandlerLogLevel,
+	         "Endpoint_Request: status %d, vnid %d", ret_code, dvg);
+#endif
+	if (ret_code == DPS_NO_ERR)
+	{
+		Py_ssize_t i, j;
+		int num_tunnelsv4, num_tunnelsv6;
+		PyObject *pypIP;
+		size_t dps_msg_reply_size;
+#if defined(NDEBUG)
+		char str[INET6_ADDRSTRLEN];
+#endif
+		return_status = DPS_SUCCESS;
+		pdps_msg_reply->endpoint_loc_reply.version =version;
+		if (vMac_ret != NULL)
+		{
+#if defined(NDEBUG)
+			log_info(PythonDataHandlerLogLevel,
+			         "Endpoint_Request: vMac " MAC_FMT,
+			         MAC_OCTETS(vMac_ret));
+#endif
+			memcpy(pdps_msg_reply->endpoint_loc_reply.mac,
+			       vMac_ret,
+			       6);
+		}
+		else
+		{
+			memset(pdps_msg_reply->endpoint_loc_reply.mac, 0, 6);
+		}
+		if (vIP_ret_packed != NULL)
+		{
+			if (vIP_ret_packed_size == 4)
+			{
+				// IPv4
+#if defined(NDEBUG)
+				inet_ntop(AF_INET, vIP_ret_packed, str, INET_ADDRSTRLEN);
+				log_info(PythonDataHandlerLogLevel,
+				          "Endpoint_Request: vIPv4 %s", str);
+#endif
+				pdps_msg_reply->endpoint_loc_reply.vm_ip_addr.family = AF_INET;
+				memcpy(&pdps_msg_reply->endpoint_loc_reply.vm_ip_addr.ip4,
+				       vIP_ret_packed,
+				       4);
+				pdps_msg_reply->endpoint_loc_reply.vm_ip_addr.ip4 =
+					ntohl(pdps_msg_reply->endpoint_loc_reply.vm_ip_addr.ip4);
+			}
+			else
+			{
+				// IPv6
+#if defined(NDEBUG)
+				inet_ntop(AF_INET6, vIP_ret_packed, str, INET6_ADDRSTRLEN);
+				log_info(PythonDataHandlerLogLevel,
+				          "Endpoint_Request: vIPv6 %s", str);
+#endif
+				pdps_msg_reply->endpoint_loc_reply.vm_ip_addr.family = AF_INET6;
+				memcpy(pdps_msg_reply->endpoint_loc_reply.vm_ip_addr.ip6,
+				       vIP_ret_packed,
+				       16);
+			}
+		}
+		// Determine if a bigger reply message size is needed
+		num_tunnelsv4 = PyList_Size(pyList_ipv4);
+		num_tunnelsv6 = PyList_Size(pyList_ipv6);
+#if defined(NDEBUG)
+		log_info(PythonDataHandlerLogLevel,
+		          "Endpoint Request: Tunnels IPv4 %d, IPv6 %d",
+		          num_tunnelsv4, num_tunnelsv6);
+#endif
+		dps_msg_reply_size = dps_offsetof(dps_client_data_t,
+		                                  endpoint_loc_reply.tunnel_info.tunnel_list[num_tunnelsv4 + num_tunnelsv6]);
+
+		if (dps_msg_reply_size > sizeof(dps_client_data_t))
+		{
+			pdps_msg_reply = (dps_client_data_t *)malloc(dps_msg_reply_size);
+			if (pdps_msg_reply == NULL)
+			{
+				// Set back to old values
+				pdps_msg_reply = *ppdps_msg_reply;
+				if (PyList_Size(pyList_ipv4) > 0)
+				{
+					num_tunnelsv4 = 1;
+					num_tunnelsv6 = 0;
+				}
+				else
+				{
+					num_tunnelsv4 = 0;
+					num_tunnelsv6 = 1;
+				}
+			}
+			else
+			{
+				*pfreplymsgallocated = 1;
+				log_debug(PythonDataHandlerLogLevel,
+				          "Allocated Reply Message %p:%d sizeof dps_client_data_t %d",
+				          pdps_msg_reply, dps_msg_reply_size, sizeof(dps_client_data_t));
+				memcpy(pdps_msg_reply, *ppdps_msg_reply, sizeof(dps_client_data_t));
+			}
+		}
+		j = 0;
+		for (i = 0; i < num_tunnelsv4; i++)
+		{
+			int ipv4;
+			pypIP = PyList_GetItem(pyList_ipv4, i);
+			dps_tunnel_endpoint_t *tunnel;
+
+			if (!PyArg_Parse(pypIP, "I", &ipv4))
+			{
+				log_warn(PythonDataHandlerLogLevel,
+				         "Endpoint_Request: Invalid IPv4 in element %d", i);
+				continue;
+			}
+#if defined(NDEBUG)
+			inet_ntop(AF_INET, &ipv4, str, INET_ADDRSTRLEN);
+			log_info(PythonDataHandlerLogLevel,
+			         "Endpoint_Request: [%d] pIPv4 %s", i, str);
+#endif
+			tunnel = &pdps_msg_reply->endpoint_loc_reply.tunnel_info.tunnel_list[j];
+			tunnel->family = AF_INET;
+			tunnel->tunnel_type = TUNNEL_TYPE_VXLAN;
+			tunnel->ip4 = ntohl(ipv4);
+			tunnel->vnid = dvg;
+			tunnel->tunnel_type = TUNNEL_TYPE_VXLAN;
+			j++;
+		}
+		for (i = 0; i < num_tunnelsv6; i++)
+		{
+			char *ipv6;
+			int ipv6_size;
+			dps_tunnel_endpoint_t *tunnel;
+
+			pypIP = PyList_GetItem(pyList_ipv6, i);
+			if (!PyArg_Parse(pypIP, "z#", &ipv6, &ipv6_size))
+			{
+				log_warn(PythonDataHandlerLogLevel,
+				         "Endpoint_Request: Invalid IPv6 in element %d", i);
+				continue;
+			}
+#if defined(NDEBUG)
+			inet_ntop(AF_INET6, ipv6, str, INET6_ADDRSTRLEN);
+			log_info(PythonDataHandlerLogLevel,
+			          "Endpoint_Request: [%d] pIPv6 %s", i, str);
+#endif
+			tunnel = &pdps_msg_reply->endpoint_loc_reply.tunnel_info.tunnel_list[j];
+			tunnel->family = AF_INET6;
+			tunnel->tunnel_type = TUNNEL_TYPE_VXLAN;
+			tunnel->vnid = dvg;
+			memcpy(tunnel->ip6, ipv6, ipv6_size);
+			j++;
+		}
+		pdps_msg_reply->endpoint_loc_reply.tunnel_info.num_of_tunnels = j;
+	}
+	else
+	{
+		// Failure case
+		// Just copy the destination endpoint location from the request message
+		memset(&pdps_msg_reply->endpoint_loc_reply, 0, sizeof(dps_endpoint_loc_reply_t));
+		memcpy(&pdps_msg_reply->endpoint_loc_reply.vm_ip_addr,
+		       &endpoint_loc_msg->vm_ip_addr,
+		       sizeof(ip_addr_t));
+		pdps_msg_reply->endpoint_loc_reply.vnid = endpoint_loc_msg->vnid;
+		memcpy(pdps_msg_reply->endpoint_loc_reply.mac,
+		       endpoint_loc_msg->mac,
+		       6);
+	}
+
+	*ppdps_msg_reply = pdps_msg_reply;
+	return return_status;
+}
+
+/*
+ ******************************************************************************
+ * dps_msg_endpoint_request_batch_args --                                 *//**
+ *
+ * \brief This routine builds the PYTHON Endpoint_Location_Batch element for
+ *        an Endpoint Location Request. The PYTHON GIL MUST be held by the
+ *        caller.
+ *        (domain_id, client_type, dps_client_IP_type, dps_client_IP_packed,
+ *         src_dvg_id, vIP_type, vIP_val, vMac)
+ *        vIP_type is 0 if the search must be done by vMac.
+ *
+ * \param entry The Endpoint Location Request in the batch
+ *
+ * \return The PYTHON tuple, NULL if no memory
+ *
+ *****************************************************************************/
+
+static PyObject *dps_msg_endpoint_request_batch_args(dps_protocol_batch_entry_t *entry)
+{
+	dps_endpoint_loc_req_t *endpoint_loc_msg = &entry->endpoint_loc_req;
+	ip_addr_t dps_client;
+	int vIPv4;
+
+	vIPv4 = htonl(endpoint_loc_msg->vm_ip_addr.ip4);
+	memcpy(&dps_client, &endpoint_loc_msg->dps_client_addr, sizeof(ip_addr_t));
+	if (dps_client.family == AF_INET)
+	{
+		dps_client.ip4 = htonl(dps_client.ip4);
+	}
+
+	// Same search criteria as dps_msg_endpoint_request
+	if (vIPv4 == 0)
+	{
+		return Py_BuildValue("(IIIz#IIIz#)",
+		                     entry->domain, entry->hdr.client_id,
+		                     dps_client.family, dps_client.ip6, 16,
+		                     endpoint_loc_msg->vnid,
+		                     0, 0,
+		                     (char *)endpoint_loc_msg->mac, 6);
+	}
+	else if (endpoint_loc_msg->vm_ip_addr.family == AF_INET)
+	{
+		return Py_BuildValue("(IIIz#IIIz#)",
+		                     entry->domain, entry->hdr.client_id,
+		                     dps_client.family, dps_client.ip6, 16,
+		                     endpoint_loc_msg->vnid,
+		                     AF_INET, vIPv4,
+		                     (char *)endpoint_loc_msg->mac, 6);
+	}
+	else
+	{
+		return Py_BuildValue("(IIIz#IIz#z#)",
+		                     entry->domain, entry->hdr.client_id,
+		                     dps_client.family, dps_client.ip6, 16,
+		                     endpoint_loc_msg->vnid,
+		                     endpoint_loc_msg->vm_ip_addr.family,
+		                     (char *)endpoint_loc_msg->vm_ip_addr.ip6, 16,
+		                     (char *)endpoint_loc_msg->mac, 6);
+	}
+}
+
+/*
+ ******************************************************************************
+ * dps_protocol_batch_flush --                                            *//**
+ *
+ * \brief This routine hands all the Endpoint Location Requests in the batch
+ *        to PYTHON in a single Endpoint_Location_Batch call i.e. with one
+ *        GIL acquisition, and sends the replies. If PYTHON cannot be
+ *        called the requests get the same DPS_NO_MEMORY reply they would
+ *        get when handled one by one.
+ *
+ * \param batch The batch of the calling DPS Protocol Handler Thread
+ *
+ *****************************************************************************/
+
+static void dps_protocol_batch_flush(dps_protocol_batch_t *batch)
+{
+	dps_protocol_batch_entry_t *entry;
+	dps_client_data_t dps_msg, dps_msg_reply, *pdps_msg_reply;
+	PyObject *strret, *strargs, *request_list, *request;
+	PyGILState_STATE gstate;
+	uint32_t i, sent;
+	int freplymsgallocated;
 
-			// Add the query ID to the dictionary to track the replies
-			strret = PyEval_CallObject(Replication_Interface.ReplicationReplyProcess,
-			                           strargs);
+	if (batch->count == 0)
+	{
+		return;
+	}
 
-			Py_DECREF(strargs);
+	log_debug(PythonDataHandlerLogLevel, "Enter Count %d", batch->count);
 
-			if (strret == NULL)
+	sent = 0;
+	dps_msg.context = NULL;
+	gstate = PyGILState_Ensure();
+	do
+	{
+		request_list = PyList_New(batch->count);
+		if (request_list == NULL)
+		{
+			log_notice(PythonDataHandlerLogLevel, "PyList_New returns NULL");
+			break;
+		}
+		for (i = 0; i < batch->count; i++)
+		{
+			request = dps_msg_endpoint_request_batch_args(&batch->entries[i]);
+			if (request == NULL)
 			{
-				PyGILState_Release(gstate);
-				log_warn(PythonDataHandlerLogLevel,
-				         "PyEval_CallObject ReplicationReplyProcess returns NULL");
 				break;
 			}
-			// Lose the reference on all parameters and return arguments since they
-			// are no longer needed.
+			// Steals the reference
+			PyList_SET_ITEM(request_list, i, request);
+		}
+		if (i < batch->count)
+		{
+			Py_DECREF(request_list);
+			log_notice(PythonDataHandlerLogLevel, "Py_BuildValue returns NULL");
+			break;
+		}
+		strargs = Py_BuildValue("(O)", request_list);
+		Py_DECREF(request_list);
+		if (strargs == NULL)
+		{
+			log_notice(PythonDataHandlerLogLevel, "Py_BuildValue returns NULL");
+			break;
+		}
+
+		// Invoke the Endpoint_Location_Batch call
+		strret = PyEval_CallObject(Client_Protocol_Interface.Endpoint_Location_Batch,
+		                           strargs);
+		Py_DECREF(strargs);
+		if (strret == NULL)
+		{
+			log_warn(PythonDataHandlerLogLevel,
+			         "PyEval_CallObject Endpoint_Location_Batch returns NULL");
+			break;
+		}
+		if ((!PyList_Check(strret)) ||
+		    (PyList_Size(strret) != (Py_ssize_t)batch->count))
+		{
 			Py_DECREF(strret);
-			PyGILState_Release(gstate);
-			log_info(PythonDataHandlerLogLevel,
-			         "Processed Local Query ID %d",
-			         query_id);
+			log_warn(PythonDataHandlerLogLevel,
+			         "Endpoint_Location_Batch: Invalid return value");
+			break;
 		}
 
+		// The replies only go to the transmit batch of this thread so
+		// they are sent while still holding the GIL
+		for (i = 0; i < batch->count; i++)
+		{
+			entry = &batch->entries[i];
+			memcpy(&dps_msg.hdr, &entry->hdr, sizeof(dps_client_hdr_t));
+			memcpy(&dps_msg.endpoint_loc_req, &entry->endpoint_loc_req,
+			       sizeof(dps_endpoint_loc_req_t));
+			pdps_msg_reply = &dps_msg_reply;
+			freplymsgallocated = 0;
+			dps_msg_endpoint_reply_hdr(&dps_msg, pdps_msg_reply);
+			dps_msg_endpoint_reply_form(&dps_msg, PyList_GET_ITEM(strret, i),
+			                            &pdps_msg_reply, &freplymsgallocated);
+			dps_msg_send_inline(pdps_msg_reply);
+			if (freplymsgallocated)
+			{
+				free(pdps_msg_reply);
+			}
+		}
+		sent = batch->count;
+		Py_DECREF(strret);
 	}while(0);
+	PyGILState_Release(gstate);
 
-	if ((fFreeReplyMessage) && (dps_msg_reply != NULL))
+	// PYTHON could not be called
+	for (i = sent; i < batch->count; i++)
 	{
-		free(dps_msg_reply);
+		entry = &batch->entries[i];
+		memcpy(&dps_msg.hdr, &entry->hdr, sizeof(dps_client_hdr_t));
+		memcpy(&dps_msg.endpoint_loc_req, &entry->endpoint_loc_req,
+		       sizeof(dps_endpoint_loc_req_t));
+		dps_msg_endpoint_reply_hdr(&dps_msg, &dps_msg_reply);
+		dps_msg_send_inline(&dps_msg_reply);
 	}
+	batch->count = 0;
 
 	log_debug(PythonDataHandlerLogLevel, "Exit");
 
-	return (ret_code == DPS_NO_ERR ? DPS_SUCCESS: DPS_ERROR);
+	return;
+}
+
+/*
+ ******************************************************************************
+ * dps_msg_endpoint_request_batch_add --                                  *//**
+ *
+ * \brief This routine adds an Endpoint Location Request to the batch of the
+ *        calling thread if the thread is draining a burst of messages. The
+ *        batch is flushed when full.
+ *
+ * \param domain The Domain ID
+ * \param dps_msg The DPS Client Server Protocol Message for Endpoint Request
+ *
+ * \retval DPS_SUCCESS The request was added to the batch
+ * \retval DPS_ERROR The thread isn't batching, handle the request now
+ *
+ *****************************************************************************/
+
+static dps_return_status dps_msg_endpoint_request_batch_add(uint32_t domain,
+                                                            dps_client_data_t *dps_msg)
+{
+	dps_protocol_batch_t *batch;
+	dps_protocol_batch_entry_t *entry;
+
+	pthread_once(&batch_key_once, batch_key_create);
+	batch = (dps_protocol_batch_t *)pthread_getspecific(batch_key);
+	if ((batch == NULL) || (!batch->active))
+	{
+		return DPS_ERROR;
+	}
+	if (batch->count == DPS_PROTOCOL_BATCH_SZ)
+	{
+		dps_protocol_batch_flush(batch);
+	}
+	entry = &batch->entries[batch->count];
+	entry->domain = domain;
+	memcpy(&entry->hdr, &dps_msg->hdr, sizeof(dps_client_hdr_t));
+	memcpy(&entry->endpoint_loc_req, &dps_msg->endpoint_loc_req,
+	       sizeof(dps_endpoint_loc_req_t));
+	batch->count++;
+	return DPS_SUCCESS;
 }
 
 /*
@@ -4509,16 +6439,11 @@ static dps_return_status dps_msg_endpoint_request(uint32_t domain,
 	dps_endpoint_loc_req_t *endpoint_loc_msg;
 	PyObject *strret, *strargs;
 	PyGILState_STATE gstate;
-	int ret_code, freplymsgallocated; // dps_resp_status_t
+	int freplymsgallocated;
 	dps_return_status return_status = DPS_ERROR;
 	int vIP_type, vIPv4;
-	uint32_t dvg, version;
 	char *vMac, *vIPv6;
-	char *vIP_ret_packed, *vMac_ret;
-	PyObject *pyList_ipv4, *pyList_ipv6;
-	int vIP_ret_packed_size, vMac_ret_size;
 	ip_addr_t dps_client;
-	unsigned int fGateway = 0;
 
 	log_debug(PythonDataHandlerLogLevel, "Enter Domain Id %d", domain);
 
@@ -4545,16 +6470,7 @@ static dps_return_status dps_msg_endpoint_request(uint32_t domain,
 	}
 
 	// Form the Endpoint Location Request reply message header
-	pdps_msg_reply->context = NULL;
-	pdps_msg_reply->hdr.type = DPS_ENDPOINT_LOC_REPLY;
-	pdps_msg_reply->hdr.vnid = dps_msg->hdr.vnid;
-	pdps_msg_reply->hdr.query_id = dps_msg->hdr.query_id;
-	pdps_msg_reply->hdr.client_id = DPS_POLICY_SERVER_ID;
-	pdps_msg_reply->hdr.transaction_type = DPS_TRANSACTION_NORMAL;
-	pdps_msg_reply->hdr.resp_status = DPS_NO_MEMORY;
-	memcpy(&pdps_msg_reply->hdr.reply_addr,
-	       &dps_msg->endpoint_loc_req.dps_client_addr,
-	       sizeof(ip_addr_t));
+	dps_msg_endpoint_reply_hdr(dps_msg, pdps_msg_reply);
 
 	log_debug(PythonDataHandlerLogLevel, "Endpoint_Request: domain %d, vnid %d",
 	          domain, endpoint_loc_msg->vnid);
@@ -4588,6 +6504,19 @@ static dps_return_status dps_msg_endpoint_request(uint32_t domain,
 	}
 #endif
 
+	if (dps_msg_endpoint_request_index(domain, dps_msg, pdps_msg_reply) == DPS_SUCCESS)
+	{
+		log_debug(PythonDataHandlerLogLevel, "Exit");
+		return DPS_SUCCESS;
+	}
+
+	// While a burst is being drained PYTHON gets all the requests at once
+	if (dps_msg_endpoint_request_batch_add(domain, dps_msg) == DPS_SUCCESS)
+	{
+		log_debug(PythonDataHandlerLogLevel, "Exit: Batched");
+		return DPS_SUCCESS;
+	}
+
 	do{
 		gstate = PyGILState_Ensure();
 		if (vIPv4 == 0)
@@ -4621,219 +6550,39 @@ static dps_return_status dps_msg_endpoint_request(uint32_t domain,
 				                        endpoint_loc_msg->vnid,
 				                        vIP_type, vIPv4);
 			}
-			else
-			{
-				strargs = Py_BuildValue("(IIIz#IIz#)",
-				                        domain,
-				                        domain, dps_msg->hdr.client_id,
-				                        dps_client.family, dps_client.ip6, 16,
-				                        endpoint_loc_msg->vnid,
-				                        vIP_type, vIPv6, 16);
-			}
-			if (strargs == NULL)
-			{
-				// Release the PYTHON Global Interpreter Lock
-				PyGILState_Release(gstate);
-				log_warn(PythonDataHandlerLogLevel,
-				         "Py_BuildValue for Endpoint_Location_vIP returns NULL");
-				break;
-			}
-			// Invoke the Endpoint_Location_vMac call
-			strret = PyEval_CallObject(Client_Protocol_Interface.Endpoint_Location_vIP, strargs);
-			Py_DECREF(strargs);
-		}
-
-		if (strret == NULL)
-		{
-			// Release the PYTHON Global Interpreter Lock
-			PyGILState_Release(gstate);
-			log_warn(PythonDataHandlerLogLevel,
-			         "PyEval_CallObject Endpoint_Location_X returns NULL");
-			break;
-		}
-
-		//@return: status, dvg_id, version, pIP_packed, vMac, vIP_packed
-		//@rtype: Integer, Integer, Integer, ByteArray, ByteArray
-		PyArg_ParseTuple(strret, "IIIOOz#z#I", &ret_code, &dvg, &version,
-		                 &pyList_ipv4, &pyList_ipv6,
-		                 &vMac_ret, &vMac_ret_size,
-		                 &vIP_ret_packed, &vIP_ret_packed_size, &fGateway);
-
-		if (fGateway)
-		{
-			pdps_msg_reply->hdr.sub_type = DPS_ENDPOINT_LOC_REPLY_GW;
-		}
-		else
-		{
-			pdps_msg_reply->hdr.sub_type = DPS_ENDPOINT_LOC_REPLY_VM;
-		}
-		pdps_msg_reply->hdr.resp_status = ret_code;
-		pdps_msg_reply->endpoint_loc_reply.vnid = dvg;
-#if defined(NDEBUG)
-		log_info(PythonDataHandlerLogLevel,
-		         "Endpoint_Request: status %d, vnid %d", ret_code, dvg);
-#endif
-		if (ret_code == DPS_NO_ERR)
-		{
-			Py_ssize_t i, j;
-			int num_tunnelsv4, num_tunnelsv6;
-			PyObject *pypIP;
-			size_t dps_msg_reply_size;
-#if defined(NDEBUG)
-			char str[INET6_ADDRSTRLEN];
-#endif
-			return_status = DPS_SUCCESS;
-			pdps_msg_reply->endpoint_loc_reply.version =version;
-			if (vMac_ret != NULL)
-			{
-#if defined(NDEBUG)
-				log_info(PythonDataHandlerLogLevel,
-				         "Endpoint_Request: vMac " MAC_FMT,
-				         MAC_OCTETS(vMac_ret));
-#endif
-				memcpy(pdps_msg_reply->endpoint_loc_reply.mac,
-				       vMac_ret,
-				       6);
-			}
-			else
-			{
-				memset(pdps_msg_reply->endpoint_loc_reply.mac, 0, 6);
-			}
-			if (vIP_ret_packed != NULL)
-			{
-				if (vIP_ret_packed_size == 4)
-				{
-					// IPv4
-#if defined(NDEBUG)
-					inet_ntop(AF_INET, vIP_ret_packed, str, INET_ADDRSTRLEN);
-					log_info(PythonDataHandlerLogLevel,
-					          "Endpoint_Request: vIPv4 %s", str);
-#endif
-					pdps_msg_reply->endpoint_loc_reply.vm_ip_addr.family = AF_INET;
-					memcpy(&pdps_msg_reply->endpoint_loc_reply.vm_ip_addr.ip4,
-					       vIP_ret_packed,
-					       4);
-					pdps_msg_reply->endpoint_loc_reply.vm_ip_addr.ip4 =
-						ntohl(pdps_msg_reply->endpoint_loc_reply.vm_ip_addr.ip4);
-				}
-				else
-				{
-					// IPv6
-#if defined(NDEBUG)
-					inet_ntop(AF_INET6, vIP_ret_packed, str, INET6_ADDRSTRLEN);
-					log_info(PythonDataHandlerLogLevel,
-					          "Endpoint_Request: vIPv6 %s", str);
-#endif
-					pdps_msg_reply->endpoint_loc_reply.vm_ip_addr.family = AF_INET6;
-					memcpy(pdps_msg_reply->endpoint_loc_reply.vm_ip_addr.ip6,
-					       vIP_ret_packed,
-					       16);
-				}
-			}
-			// Determine if a bigger reply message size is needed
-			num_tunnelsv4 = PyList_Size(pyList_ipv4);
-			num_tunnelsv6 = PyList_Size(pyList_ipv6);
-#if defined(NDEBUG)
-			log_info(PythonDataHandlerLogLevel,
-			          "Endpoint Request: Tunnels IPv4 %d, IPv6 %d",
-			          num_tunnelsv4, num_tunnelsv6);
-#endif
-			dps_msg_reply_size = dps_offsetof(dps_client_data_t,
-			                                  endpoint_loc_reply.tunnel_info.tunnel_list[num_tunnelsv4 + num_tunnelsv6]);
-
-			if (dps_msg_reply_size > sizeof(dps_client_data_t))
-			{
-				pdps_msg_reply = (dps_client_data_t *)malloc(dps_msg_reply_size);
-				if (pdps_msg_reply == NULL)
-				{
-					// Set back to old values
-					pdps_msg_reply = &dps_msg_reply;
-					if (PyList_Size(pyList_ipv4) > 0)
-					{
-						num_tunnelsv4 = 1;
-						num_tunnelsv6 = 0;
-					}
-					else
-					{
-						num_tunnelsv4 = 0;
-						num_tunnelsv6 = 1;
-					}
-				}
-				else
-				{
-					freplymsgallocated = 1;
-					log_debug(PythonDataHandlerLogLevel,
-					          "Allocated Reply Message %p:%d sizeof dps_client_data_t %d",
-					          pdps_msg_reply, dps_msg_reply_size, sizeof(dps_client_data_t));
-					memcpy(pdps_msg_reply, &dps_msg_reply, sizeof(dps_client_data_t));
-				}
-			}
-			j = 0;
-			for (i = 0; i < num_tunnelsv4; i++)
-			{
-				int ipv4;
-				pypIP = PyList_GetItem(pyList_ipv4, i);
-				dps_tunnel_endpoint_t *tunnel;
-
-				if (!PyArg_Parse(pypIP, "I", &ipv4))
-				{
-					log_warn(PythonDataHandlerLogLevel,
-					         "Endpoint_Request: Invalid IPv4 in element %d", i);
-					continue;
-				}
-#if defined(NDEBUG)
-				inet_ntop(AF_INET, &ipv4, str, INET_ADDRSTRLEN);
-				log_info(PythonDataHandlerLogLevel,
-				         "Endpoint_Request: [%d] pIPv4 %s", i, str);
-#endif
-				tunnel = &pdps_msg_reply->endpoint_loc_reply.tunnel_info.tunnel_list[j];
-				tunnel->family = AF_INET;
-				tunnel->tunnel_type = TUNNEL_TYPE_VXLAN;
-				tunnel->ip4 = ntohl(ipv4);
-				tunnel->vnid = dvg;
-				tunnel->tunnel_type = TUNNEL_TYPE_VXLAN;
-				j++;
-			}
-			for (i = 0; i < num_tunnelsv6; i++)
-			{
-				char *ipv6;
-				int ipv6_size;
-				dps_tunnel_endpoint_t *tunnel;
-
-				pypIP = PyList_GetItem(pyList_ipv6, i);
-				if (!PyArg_Parse(pypIP, "z#", &ipv6, &ipv6_size))
-				{
-					log_warn(PythonDataHandlerLogLevel,
-					         "Endpoint_Request: Invalid IPv6 in element %d", i);
-					continue;
-				}
-#if defined(NDEBUG)
-				inet_ntop(AF_INET6, ipv6, str, INET6_ADDRSTRLEN);
-				log_info(PythonDataHandlerLogLevel,
-				          "Endpoint_Request: [%d] pIPv6 %s", i, str);
-#endif
-				tunnel = &pdps_msg_reply->endpoint_loc_reply.tunnel_info.tunnel_list[j];
-				tunnel->family = AF_INET6;
-				tunnel->tunnel_type = TUNNEL_TYPE_VXLAN;
-				tunnel->vnid = dvg;
-				memcpy(tunnel->ip6, ipv6, ipv6_size);
-				j++;
+			else
+			{
+				strargs = Py_BuildValue("(IIIz#IIz#)",
+				                        domain, dps_msg->hdr.client_id,
+				                        dps_client.family, dps_client.ip6, 16,
+				                        endpoint_loc_msg->vnid,
+				                        vIP_type, vIPv6, 16);
+			}
+			if (strargs == NULL)
+			{
+				// Release the PYTHON Global Interpreter Lock
+				PyGILState_Release(gstate);
+				log_warn(PythonDataHandlerLogLevel,
+				         "Py_BuildValue for Endpoint_Location_vIP returns NULL");
+				break;
 			}
-			pdps_msg_reply->endpoint_loc_reply.tunnel_info.num_of_tunnels = j;
+			// Invoke the Endpoint_Location_vMac call
+			strret = PyEval_CallObject(Client_Protocol_Interface.Endpoint_Location_vIP, strargs);
+			Py_DECREF(strargs);
 		}
-		else
+
+		if (strret == NULL)
 		{
-			// Failure case
-			// Just copy the destination endpoint location from the request message
-			memset(&pdps_msg_reply->endpoint_loc_reply, 0, sizeof(dps_endpoint_loc_reply_t));
-			memcpy(&pdps_msg_reply->endpoint_loc_reply.vm_ip_addr,
-			       &endpoint_loc_msg->vm_ip_addr,
-			       sizeof(ip_addr_t));
-			pdps_msg_reply->endpoint_loc_reply.vnid = endpoint_loc_msg->vnid;
-			memcpy(pdps_msg_reply->endpoint_loc_reply.mac,
-			       endpoint_loc_msg->mac,
-			       6);
+			// Release the PYTHON Global Interpreter Lock
+			PyGILState_Release(gstate);
+			log_warn(PythonDataHandlerLogLevel,
+			         "PyEval_CallObject Endpoint_Location_X returns NULL");
+			break;
 		}
+
+		return_status = dps_msg_endpoint_reply_form(dps_msg, strret,
+		                                            &pdps_msg_reply,
+		                                            &freplymsgallocated);
 		// Lose the reference on all parameters and return arguments since they
 		// are no longer needed.
 		Py_DECREF(strret);
@@ -4856,6 +6605,142 @@ static dps_return_status dps_msg_endpoint_request(uint32_t domain,
 
 }
 
+/*
+ ******************************************************************************
+ * dps_protocol_server_batch_start --                                     *//**
+ *
+ * \brief This routine is called by a DPS Protocol Handler Thread before it
+ *        processes a burst of received messages. Until
+ *        dps_protocol_server_batch_end is called, Endpoint Location Requests
+ *        that cannot be answered from the native Endpoint Index and Endpoint
+ *        Updates are held back and handed to PYTHON together.
+ *
+ *****************************************************************************/
+
+void dps_protocol_server_batch_start(void)
+{
+	dps_protocol_batch_t *batch;
+
+	pthread_once(&batch_key_once, batch_key_create);
+	batch = (dps_protocol_batch_t *)pthread_getspecific(batch_key);
+	if (batch == NULL)
+	{
+		batch = (dps_protocol_batch_t *)malloc(sizeof(dps_protocol_batch_t));
+		if (batch == NULL)
+		{
+			// Messages are handled one by one
+			return;
+		}
+		pthread_setspecific(batch_key, batch);
+	}
+	batch->active = 1;
+	batch->flushing = 0;
+	batch->count = 0;
+	batch->update_count = 0;
+	return;
+}
+
+/*
+ ******************************************************************************
+ * dps_protocol_server_batch_end --                                       *//**
+ *
+ * \brief This routine is called by a DPS Protocol Handler Thread after it
+ *        has processed a burst of received messages. All the held back
+ *        updates and requests are handed to PYTHON and their replies sent,
+ *        and the Endpoint Updates of the burst are handed to the Replication
+ *        Channels.
+ *
+ *****************************************************************************/
+
+void dps_protocol_server_batch_end(void)
+{
+	dps_protocol_batch_t *batch;
+
+	pthread_once(&batch_key_once, batch_key_create);
+	batch = (dps_protocol_batch_t *)pthread_getspecific(batch_key);
+	if ((batch != NULL) && (batch->active))
+	{
+		// Updates first so that the requests of the burst see them
+		dps_protocol_batch_update_flush(batch);
+		dps_protocol_batch_flush(batch);
+		batch->active = 0;
+	}
+	dps_replication_flush();
+	return;
+}
+
+/*
+ ******************************************************************************
+ * dps_msg_policy_request_index --                                        *//**
+ *
+ * \brief This routine tries to answer a Policy Resolution Request from the
+ *        native Endpoint Index without taking the PYTHON GIL.
+ *
+ * \param domain The Domain ID
+ * \param dps_msg The DPS Client Server Protocol Message for Policy Resolution
+ * \param dps_msg_reply The reply with the header already formed
+ *
+ * \retval DPS_SUCCESS The reply has been sent
+ * \retval DPS_ERROR The request must be handled by PYTHON
+ *
+ *****************************************************************************/
+
+static dps_return_status dps_msg_policy_request_index(uint32_t domain,
+                                                      dps_client_data_t *dps_msg,
+                                                      dps_client_data_t *dps_msg_reply)
+{
+	dps_client_data_t *pdps_msg_reply = dps_msg_reply;
+	dps_policy_req_t *policy_req_msg = &dps_msg->policy_req;
+	uint32_t num_tunnels, max_tunnels;
+	size_t dps_msg_reply_size;
+	dove_status status;
+
+	if ((policy_req_msg->dst_endpoint.vm_ip_addr.ip4 != 0) &&
+	    (policy_req_msg->dps_client_addr.family != AF_INET) &&
+	    (policy_req_msg->dps_client_addr.family != AF_INET6))
+	{
+		// PYTHON reports the invalid DPS Client
+		return DPS_ERROR;
+	}
+
+	max_tunnels = (sizeof(dps_client_data_t) -
+	               dps_offsetof(dps_client_data_t,
+	                            policy_reply.dst_endpoint_loc_reply.tunnel_info.tunnel_list[0])) /
+	              sizeof(dps_tunnel_endpoint_t);
+	status = dps_endpoint_index_policy_lookup(domain, policy_req_msg,
+	                                          &pdps_msg_reply->policy_reply,
+	                                          max_tunnels, &num_tunnels);
+	if (status == DOVE_STATUS_EXCEEDS_CAP)
+	{
+		dps_msg_reply_size = dps_offsetof(dps_client_data_t,
+		                                  policy_reply.dst_endpoint_loc_reply.tunnel_info.tunnel_list[num_tunnels]);
+		pdps_msg_reply = (dps_client_data_t *)malloc(dps_msg_reply_size);
+		if (pdps_msg_reply == NULL)
+		{
+			return DPS_ERROR;
+		}
+		memcpy(pdps_msg_reply, dps_msg_reply, sizeof(dps_client_data_t));
+		status = dps_endpoint_index_policy_lookup(domain, policy_req_msg,
+		                                          &pdps_msg_reply->policy_reply,
+		                                          num_tunnels, &num_tunnels);
+	}
+	if (status == DOVE_STATUS_OK)
+	{
+		pdps_msg_reply->hdr.resp_status = DPS_NO_ERR;
+		log_debug(PythonDataHandlerLogLevel,
+		          "Policy_Request: Domain %d, Src VNID %d, Dst VNID %d served from index",
+		          domain, policy_req_msg->src_endpoint.vnid,
+		          pdps_msg_reply->policy_reply.dst_endpoint_loc_reply.vnid);
+		dps_msg_send_inline(pdps_msg_reply);
+	}
+	if (pdps_msg_reply != dps_msg_reply)
+	{
+		free(pdps_msg_reply);
+	}
+
+	return (status == DOVE_STATUS_OK) ? DPS_SUCCESS : DPS_ERROR;
+}
+
 /*
  ******************************************************************************
  * dps_msg_policy_request --                                             *//**
@@ -4944,6 +6829,11 @@ static dps_return_status dps_msg_policy_request(uint32_t domain,
 	       &dps_msg->policy_req.dps_client_addr,
 	       sizeof(ip_addr_t));
 
+	if (dps_msg_policy_request_index(domain, dps_msg, pdps_msg_reply) == DPS_SUCCESS)
+	{
+		return DPS_SUCCESS;
+	}
+
 	do
 	{
 		// Ensure the PYTHON Global Interpreter Lock
@@ -5249,6 +7139,7 @@ static dps_return_status dps_msg_policy_request(uint32_t domain,
 static dps_return_status dps_msg_implicit_gateway_request(uint32_t domain,
                                                           dps_client_data_t *dps_msg)
 {
+	uint8_t *send_buff = dps_protocol_send_buff_get();
 	dps_return_status return_status = DPS_SUCCESS;
 	dps_client_hdr_t *hdr = &((dps_client_data_t *)send_buff)->hdr;
 	dps_internal_gw_t *int_gw = &((dps_client_data_t *)send_buff)->internal_gw_list;
@@ -5263,6 +7154,12 @@ static dps_return_status dps_msg_implicit_gateway_request(uint32_t domain,
 
 	log_debug(PythonDataHandlerLogLevel, "Enter Domain Id %d", domain);
 
+	if (send_buff == NULL)
+	{
+		log_warn(PythonDataHandlerLogLevel, "No memory for send buffer");
+		return DPS_ERROR;
+	}
+
 #if defined(NDEBUG)
 	if (dps_msg->internal_gw_req.dps_client_addr.family == AF_INET)
 	{
@@ -5408,6 +7305,7 @@ static dps_return_status dps_msg_implicit_gateway_request(uint32_t domain,
 static dps_return_status dps_msg_gateway_request(uint32_t domain,
                                                  dps_client_data_t *dps_msg)
 {
+	uint8_t *send_buff = dps_protocol_send_buff_get();
 	dps_return_status return_status = DPS_SUCCESS;
 	dps_client_hdr_t *hdr = &((dps_client_data_t *)send_buff)->hdr;
 	dps_tunnel_list_t *gw_data = &((dps_client_data_t *)send_buff)->tunnel_info;
@@ -5424,6 +7322,12 @@ static dps_return_status dps_msg_gateway_request(uint32_t domain,
 
 	log_debug(PythonDataHandlerLogLevel, "Enter Domain Id %d", domain);
 
+	if (send_buff == NULL)
+	{
+		log_warn(PythonDataHandlerLogLevel, "No memory for send buffer");
+		return DPS_ERROR;
+	}
+
 	if (dps_msg->gen_msg_req.dps_client_addr.family == AF_INET)
 	{
 		int dps_client_ip4 = htonl(dps_msg->gen_msg_req.dps_client_addr.ip4);
@@ -5450,7 +7354,8 @@ static dps_return_status dps_msg_gateway_request(uint32_t domain,
 	// Reply to the DPS Client
 	memcpy(&hdr->reply_addr,
 	       &dps_msg->gen_msg_req.dps_client_addr,
-	       sizeof(dps_client_hdr_t));
+	       sizeof(ip_addr_t));
+	hdr->payload_version = 0;
 	if (dps_msg->hdr.type == DPS_EXTERNAL_GW_LIST_REQ)
 	{
 		hdr->type = DPS_EXTERNAL_GW_LIST_REPLY;
@@ -5488,9 +7393,10 @@ static dps_return_status dps_msg_gateway_request(uint32_t domain,
 			break;
 		}
 
-		//@return: (status, ListIPv4, ListIPv6)
-		//@rtype: Integer, List, List
-		PyArg_ParseTuple(strret, "IOO", &status, &pyList_ipv4, &pyList_ipv6);
+		//@return: (status, ListIPv4, ListIPv6, version)
+		//@rtype: Integer, List, List, Integer
+		PyArg_ParseTuple(strret, "IOO|I", &status, &pyList_ipv4, &pyList_ipv6,
+		                 &hdr->payload_version);
 
 		// Set the reply status
 		hdr->resp_status = status;
@@ -5596,20 +7502,24 @@ static dps_return_status dps_msg_gateway_request(uint32_t domain,
 static dps_return_status dps_msg_broadcast_list_request(uint32_t domain,
                                                         dps_client_data_t *dps_msg)
 {
+	uint8_t *send_buff = dps_protocol_send_buff_get();
 	dps_return_status return_status = DPS_SUCCESS;
 	dps_client_hdr_t *hdr = &((dps_client_data_t *)send_buff)->hdr;
-	dps_pkd_tunnel_list_t *switch_list = &((dps_client_data_t *)send_buff)->dove_switch_list;
 	PyObject *strret, *strargs;
 	PyGILState_STATE gstate;
-	uint32_t status;
-	PyObject *pyList_ipv4, *pyList_ipv6;
-	Py_ssize_t i, j;
-	PyObject *pyIP;
-	int ipv4, ipv6_size;
-	char *ipv6;
+	uint32_t status, sub_type;
+	ip_addr_t dps_client;
+	char *payload;
+	int payload_size;
 
 	log_debug(PythonDataHandlerLogLevel, "Enter Domain %d", domain);
 
+	if (send_buff == NULL)
+	{
+		log_warn(PythonDataHandlerLogLevel, "No memory for send buffer");
+		return DPS_ERROR;
+	}
+
 #if defined(NDEBUG)
 	if (dps_msg->gen_msg_req.dps_client_addr.family == AF_INET)
 	{
@@ -5637,17 +7547,32 @@ static dps_return_status dps_msg_broadcast_list_request(uint32_t domain,
 	// Reply to the DPS Client
 	memcpy(&hdr->reply_addr,
 	       &dps_msg->gen_msg_req.dps_client_addr,
-	       sizeof(dps_client_hdr_t));
+	       sizeof(ip_addr_t));
 	hdr->type = DPS_BCAST_LIST_REPLY;
 	hdr->client_id = DPS_POLICY_SERVER_ID;
 	hdr->transaction_type = DPS_TRANSACTION_NORMAL;
 	hdr->resp_status = DPS_NO_MEMORY;
+	// Until PYTHON says otherwise the reply is the whole list
+	hdr->sub_type = DPS_BCAST_LIST_FULL;
+	hdr->payload_version = 0;
+
+	memcpy(&dps_client, &dps_msg->gen_msg_req.dps_client_addr, sizeof(ip_addr_t));
+	if (dps_client.family == AF_INET)
+	{
+		dps_client.ip4 = htonl(dps_client.ip4);
+	}
 
 	// Ensure the PYTHON Global Interpreter Lock
 	gstate = PyGILState_Ensure();
 	do
 	{
-		strargs = Py_BuildValue("(II)", domain, dps_msg->hdr.vnid);
+		//def Broadcast_List(self, domain_id, vnid, sub_type, seq_num,
+		//                   dps_client_IP_type, dps_client_IP_packed):
+		strargs = Py_BuildValue("(IIIIIz#)",
+		                        domain, dps_msg->hdr.vnid,
+		                        (uint32_t)dps_msg->hdr.sub_type,
+		                        dps_msg->gen_msg_req.bcast_seq_num,
+		                        dps_client.family, dps_client.ip6, 16);
 		if (strargs == NULL)
 		{
 			log_notice(PythonDataHandlerLogLevel, "Py_BuildValue returns NULL");
@@ -5663,79 +7588,29 @@ static dps_return_status dps_msg_broadcast_list_request(uint32_t domain,
 			break;
 		}
 
-		//@return: (status, ListIPv4, ListIPv6)
-		//@rtype: Integer, List, List
-		PyArg_ParseTuple(strret, "IOO", &status, &pyList_ipv4, &pyList_ipv6);
+		//@return: (status, sub_type, packed broadcast table or change, version)
+		//@rtype: Integer, Integer, String, Integer
+		if (!PyArg_ParseTuple(strret, "IIz#|I", &status, &sub_type,
+		                      &payload, &payload_size,
+		                      &hdr->payload_version))
+		{
+			log_warn(PythonDataHandlerLogLevel,
+			         "Broadcast_List returns bad data");
+			Py_DECREF(strret);
+			PyErr_Clear();
+			break;
+		}
 		// Set the return status
 		hdr->resp_status = status;
 
 		if (status == DPS_NO_ERR)
 		{
 			// Copy the DOVE Switches
-			switch_list->num_v4_tunnels = 0;
-			switch_list->num_v6_tunnels = 0;
-
-			j = 0;
-			for (i = 0; i < PyList_Size(pyList_ipv4); i++)
-			{
-	#if defined(NDEBUG)
-				char str[INET_ADDRSTRLEN];
-	#endif
-				if (dps_offsetof(dps_client_data_t,
-				                 dove_switch_list.tunnel_list[j+1]) > SEND_BUFF_SIZE)
-				{
-					log_alert(PythonDataHandlerLogLevel,
-					          "ALERT!!! Number of DOVE Switches %d exceeds Send Buffer %d max size",
-					          PyList_Size(pyList_ipv4) + PyList_Size(pyList_ipv6),
-					          SEND_BUFF_SIZE
-					          );
-					break;
-				}
-				pyIP = PyList_GetItem(pyList_ipv4, i);
-				if (!PyArg_Parse(pyIP, "I", &ipv4))
-				{
-					log_warn(PythonDataHandlerLogLevel,
-					         "Invalid IPv4 in element %d", i);
-					continue;
-				}
-#if defined(NDEBUG)
-				inet_ntop(AF_INET, &ipv4, str, INET_ADDRSTRLEN);
-				log_info(PythonDataHandlerLogLevel,
-				         "Broadcast: DOVE Switch %s", str);
-#endif
-				switch_list->tunnel_list[j++] = ntohl(ipv4);
-				switch_list->num_v4_tunnels++;
-			}
-			for (i = 0, j = 0; i < PyList_Size(pyList_ipv6); i++, j++)
+			if (!broadcast_payload_unpack((dps_client_data_t *)send_buff,
+			                              sub_type, payload, payload_size))
 			{
-#if defined(NDEBUG)
-				char str[INET6_ADDRSTRLEN];
-#endif
-				if (dps_offsetof(dps_client_data_t,
-						 dove_switch_list.tunnel_list[j+4]) > SEND_BUFF_SIZE)
-				{
-					log_alert(PythonDataHandlerLogLevel,
-					          "ALERT!!! Number of DOVE Switches %d exceeds Send Buffer %d max size",
-					          PyList_Size(pyList_ipv4) + PyList_Size(pyList_ipv6),
-					          SEND_BUFF_SIZE
-					          );
-					break;
-				}
-				pyIP = PyList_GetItem(pyList_ipv6, i);
-				if (!PyArg_Parse(pyIP, "z#", &ipv6, &ipv6_size))
-				{
-					log_warn(PythonDataHandlerLogLevel,
-					         "Invalid IPv6 in element %d", i);
-					continue;
-				}
-#if defined(NDEBUG)
-				inet_ntop(AF_INET6, ipv6, str, INET6_ADDRSTRLEN);
-				log_info(PythonDataHandlerLogLevel,
-				         "Broadcast: DOVE Switch %s", str);
-#endif
-				memcpy((uint8_t *)(&switch_list->tunnel_list[j]), ipv6, ipv6_size);
-				switch_list->num_v6_tunnels++;
-				j += 4;
+				log_warn(PythonDataHandlerLogLevel, "Bad Broadcast Table!!!");
+				hdr->resp_status = DPS_NO_BCAST_LIST;
 			}
 		}
 
@@ -7072,6 +8947,8 @@ static dove_status dps_msg_functions_init(void)
 	dps_msg_function_array[DPS_UNSOLICITED_VNID_DEL_REQ] = NULL;
 	dps_msg_function_array[DPS_CTRL_PLANE_HB] = NULL;
 	dps_msg_function_array[DPS_GET_DCS_NODE] = NULL;
+	dps_msg_function_array[DPS_REPLICATION_BATCH] = dps_msg_replication_batch;
+	dps_msg_function_array[DPS_REPLICATION_BATCH_ACK] = dps_msg_replication_batch_ack;
 
 
 	dps_msg_forward_remote[0] = 0;
@@ -7115,6 +8992,8 @@ static dove_status dps_msg_functions_init(void)
 	dps_msg_forward_remote[DPS_UNSOLICITED_VNID_DEL_REQ] = 0;
 	dps_msg_forward_remote[DPS_CTRL_PLANE_HB] = 0;
 	dps_msg_forward_remote[DPS_GET_DCS_NODE] = 0;
+	dps_msg_forward_remote[DPS_REPLICATION_BATCH] = 0;
+	dps_msg_forward_remote[DPS_REPLICATION_BATCH_ACK] = 0;
 
 	return DOVE_STATUS_OK;
 }
@@ -7191,6 +9070,32 @@ static dove_status python_client_protocol_handler_init(char *pythonpath)
 			break;
 		}
 
+		// Get handle to function Endpoint_Location_Batch
+		Client_Protocol_Interface.Endpoint_Location_Batch =
+			PyObject_GetAttrString(Client_Protocol_Interface.instance,
+			                       PYTHON_FUNC_ENDPOINT_REQUEST_BATCH);
+		if (Client_Protocol_Interface.Endpoint_Location_Batch == NULL)
+		{
+			log_emergency(PythonDataHandlerLogLevel,
+			              "ERROR! PyObject_GetAttrString (%s) failed...\n",
+			              PYTHON_FUNC_ENDPOINT_REQUEST_BATCH);
+			status = DOVE_STATUS_NOT_FOUND;
+			break;
+		}
+
+		// Get handle to function Endpoint_Update_Batch
+		Client_Protocol_Interface.Endpoint_Update_Batch =
+			PyObject_GetAttrString(Client_Protocol_Interface.instance,
+			                       PYTHON_FUNC_ENDPOINT_UPDATE_BATCH);
+		if (Client_Protocol_Interface.Endpoint_Update_Batch == NULL)
+		{
+			log_emergency(PythonDataHandlerLogLevel,
+			              "ERROR! PyObject_GetAttrString (%s) failed...\n",
+			              PYTHON_FUNC_ENDPOINT_UPDATE_BATCH);
+			status = DOVE_STATUS_NOT_FOUND;
+			break;
+		}
+
 		// Get handle to function Endpoint_Location_vIP
 		Client_Protocol_Interface.Endpoint_Location_vIP =
 			PyObject_GetAttrString(Client_Protocol_Interface.instance,
@@ -7546,6 +9451,19 @@ static dove_status python_replication_handler_init(char *pythonpath)
 			break;
 		}
 
+		// Get handle to function ReplicationNodes
+		Replication_Interface.ReplicationNodes =
+			PyObject_GetAttrString(Replication_Interface.instance,
+			                       PYTHON_REPLICATION_NODES);
+		if (Replication_Interface.ReplicationNodes == NULL)
+		{
+			log_emergency(PythonDataHandlerLogLevel,
+			              "ERROR! PyObject_GetAttrString (%s) failed...\n",
+			              PYTHON_REPLICATION_NODES);
+			status = DOVE_STATUS_NOT_FOUND;
+			break;
+		}
+
 		status = DOVE_STATUS_OK;
 	}while(0);
 
@@ -7612,6 +9530,32 @@ static dove_status python_mass_transfer_handler_init(char *pythonpath)
 			break;
 		}
 
+		// Get handle to function Stream_Ack
+		Mass_Transfer_Interface.Stream_Ack =
+			PyObject_GetAttrString(Mass_Transfer_Interface.instance,
+			                       PYTHON_MASS_TRANSFER_STREAM_ACK);
+		if (Mass_Transfer_Interface.Stream_Ack == NULL)
+		{
+			log_emergency(PythonDataHandlerLogLevel,
+			              "ERROR! PyObject_GetAttrString (%s) failed...\n",
+			              PYTHON_MASS_TRANSFER_STREAM_ACK);
+			status = DOVE_STATUS_NOT_FOUND;
+			break;
+		}
+
+		// Get handle to function Stream_Frame_Receive
+		Mass_Transfer_Interface.Stream_Frame_Receive =
+			PyObject_GetAttrString(Mass_Transfer_Interface.instance,
+			                       PYTHON_MASS_TRANSFER_STREAM_FRAME_RECEIVE);
+		if (Mass_Transfer_Interface.Stream_Frame_Receive == NULL)
+		{
+			log_emergency(PythonDataHandlerLogLevel,
+			              "ERROR! PyObject_GetAttrString (%s) failed...\n",
+			              PYTHON_MASS_TRANSFER_STREAM_FRAME_RECEIVE);
+			status = DOVE_STATUS_NOT_FOUND;
+			break;
+		}
+
 		status = DOVE_STATUS_OK;
 	}while(0);
 
@@ -7662,6 +9606,12 @@ dove_status python_init_dcs_protocol_interface(char *pythonpath)
 			break;
 		}
 
+		status = dps_replication_channel_init();
+		if (status != DOVE_STATUS_OK)
+		{
+			break;
+		}
+
 	} while (0);
 
 	log_info(PythonDataHandlerLogLevel, "Exit: %s",
@@ -7687,6 +9637,7 @@ dps_return_status dps_protocol_send_to_server(dps_client_data_t *client_data)
 	uint32_t msg_type;
 	uint32_t domain_id = 0;
 	int fLocalDomain = 0;
+	uint32_t fDomainActive = 0;
 	dove_status dps_status;
 	dps_return_status status = DPS_ERROR;
 	dps_msg_func_handler func;
@@ -7709,44 +9660,57 @@ dps_return_status dps_protocol_send_to_server(dps_client_data_t *client_data)
 			break;
 		}
 		msg_type = (uint32_t)client_data->hdr.type;
-		// Ensure the PYTHON Global Interpreter Lock
-		gstate = PyGILState_Ensure();
-		strargs = Py_BuildValue("(II)",
-		                        client_data->hdr.vnid,
-		                        client_data->hdr.transaction_type);
-		if (strargs == NULL)
+		// Most messages are for VNIDs whose ownership is already cached
+		if (dps_vnid_cache_lookup(client_data->hdr.vnid,
+		                          client_data->hdr.transaction_type,
+		                          &domain_id, &fLocalDomain) != DOVE_STATUS_OK)
 		{
-			PyGILState_Release(gstate);
-			log_notice(PythonDataHandlerLogLevel, "Py_BuildValue returns NULL");
-			break;
-		}
+			// Ensure the PYTHON Global Interpreter Lock
+			gstate = PyGILState_Ensure();
+			strargs = Py_BuildValue("(II)",
+			                        client_data->hdr.vnid,
+			                        client_data->hdr.transaction_type);
+			if (strargs == NULL)
+			{
+				PyGILState_Release(gstate);
+				log_notice(PythonDataHandlerLogLevel, "Py_BuildValue returns NULL");
+				break;
+			}
 
-		// Invoke the Is_VNID_Handled_Locally call
-		strret = PyEval_CallObject(Client_Protocol_Interface.Is_VNID_Handled_Locally, strargs);
-		Py_DECREF(strargs);
+			// Invoke the Is_VNID_Handled_Locally call
+			strret = PyEval_CallObject(Client_Protocol_Interface.Is_VNID_Handled_Locally, strargs);
+			Py_DECREF(strargs);
 
-		// Parse the return value @return: 0 = False, 1 = True
-		if (strret == NULL)
-		{
+			// Parse the return value @return: 0 = False, 1 = True
+			if (strret == NULL)
+			{
+				PyGILState_Release(gstate);
+				log_warn(PythonDataHandlerLogLevel,
+				         "Msg Type %d, VNID %d, PyEval_CallObject returns NULL",
+				         client_data->hdr.type, client_data->hdr.vnid);
+				break;
+			}
+			PyArg_ParseTuple(strret, "IIII", &dps_status, &fLocalDomain,
+			                 &domain_id, &fDomainActive);
+			Py_DECREF(strret);
+			if (dps_status == DOVE_STATUS_OK)
+			{
+				// Cache while still holding the GIL so that no
+				// invalidation can slip in between
+				dps_vnid_cache_fill(client_data->hdr.vnid, domain_id, fDomainActive);
+			}
 			PyGILState_Release(gstate);
-			log_warn(PythonDataHandlerLogLevel,
-			         "Msg Type %d, VNID %d, PyEval_CallObject returns NULL",
-			         client_data->hdr.type, client_data->hdr.vnid);
-			break;
-		}
-		PyArg_ParseTuple(strret, "III", &dps_status, &fLocalDomain, &domain_id);
-		Py_DECREF(strret);
-		PyGILState_Release(gstate);
 
-		log_debug(PythonDataHandlerLogLevel,
-		          "Is_VNID_Handled_Locally returns dps_status %s, "
-		          "fLocalDomain %d, Domain %d",
-		          DOVEStatusToString(dps_status), fLocalDomain, domain_id);
-		if (dps_status != DOVE_STATUS_OK)
-		{
-			// Let the client retry
-			status = DPS_ERROR;
-			break;
+			log_debug(PythonDataHandlerLogLevel,
+			          "Is_VNID_Handled_Locally returns dps_status %s, "
+			          "fLocalDomain %d, Domain %d",
+			          DOVEStatusToString(dps_status), fLocalDomain, domain_id);
+			if (dps_status != DOVE_STATUS_OK)
+			{
+				// Let the client retry
+				status = DPS_ERROR;
+				break;
+			}
 		}
 
 		// If can be handled by Local Node, then handle it
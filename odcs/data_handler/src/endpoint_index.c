@@ -0,0 +1,1205 @@
+/******************************************************************************
+** File Main Owner:   DOVE DPS Development Team
+** File Description:  Native Endpoint Index for the DPS Endpoint Location path
+**/
+/*
+{
+* Copyright (c) 2010-2013 IBM Corporation
+* All rights reserved.
+*
+* This program and the accompanying materials are made available under the
+* terms of the Eclipse Public License v1.0 which accompanies this
+* distribution, and is available at http://www.eclipse.org/legal/epl-v10.html
+*
+*
+*  HISTORY
+*
+*  $Log: endpoint_index.c $
+*  $EndLog$
+*
+*  PORTING HISTORY
+*
+}
+*/
+
+#include "include.h"
+
+/**
+ * \brief The initial (and minimum) number of buckets in an index table
+ */
+#define DPS_ENDPOINT_INDEX_BUCKETS_MIN 1024
+
+/**
+ * \brief The common header of every record in an index table. A record is
+ *        only ever linked in one table.
+ */
+typedef struct dps_endpoint_index_node_s {
+	/**
+	 * \brief Next record in the bucket chain
+	 */
+	struct dps_endpoint_index_node_s *next;
+	/**
+	 * \brief The full hash value of the key
+	 */
+	uint32_t hash;
+	/**
+	 * \brief The Domain ID (part of every key)
+	 */
+	uint32_t domain_id;
+} dps_endpoint_index_node_t;
+
+/**
+ * \brief A chained hash table that doubles when the load factor exceeds 1
+ */
+typedef struct dps_endpoint_index_table_s {
+	dps_endpoint_index_node_t **buckets;
+	uint32_t size;
+	uint32_t count;
+} dps_endpoint_index_table_t;
+
+/**
+ * \brief The Domain record. Holds the active state and the lookups served
+ *        from the index since PYTHON last fetched them.
+ */
+typedef struct dps_endpoint_index_domain_s {
+	dps_endpoint_index_node_t node;
+	uint32_t active;
+	uint32_t lookups;
+	uint32_t policy_lookups;
+} dps_endpoint_index_domain_t;
+
+/**
+ * \brief The Endpoint record keyed by (Domain, vMac). Mirrors what the PYTHON
+ *        Endpoint_Location_vMac routine returns.
+ */
+typedef struct dps_endpoint_index_mac_s {
+	dps_endpoint_index_node_t node;
+	uint8_t mac[6];
+	/**
+	 * \brief Size of vip: 4 (IPv4, Network Byte Order) or 16 (IPv6)
+	 */
+	uint16_t vip_size;
+	uint8_t vip[16];
+	/**
+	 * \brief The DVG/VNID of the Endpoint
+	 */
+	uint32_t vnid;
+	uint32_t version;
+	uint16_t num_ipv4;
+	uint16_t num_ipv6;
+	/**
+	 * \brief num_ipv4 IPv4 Tunnel IPs (PYTHON Integer values) followed by
+	 *        num_ipv6 IPv6 Tunnel IPs (4 words each)
+	 */
+	uint32_t tunnel_ip[1];
+} dps_endpoint_index_mac_t;
+
+/**
+ * \brief The vIP record keyed by (Domain, Family, vIP) pointing at a vMac.
+ */
+typedef struct dps_endpoint_index_vip_s {
+	dps_endpoint_index_node_t node;
+	uint16_t family;
+	uint8_t mac[6];
+	union {
+		/**
+		 * \brief IPv4 as the PYTHON Integer value (Network Byte Order)
+		 */
+		uint32_t ip4;
+		uint8_t ip6[16];
+	};
+} dps_endpoint_index_vip_t;
+
+/**
+ * \brief The unicast Policy record keyed by (Domain, Source VNID, Destination
+ *        VNID). Mirrors Domain.Policy_Hash_DVG[0].
+ */
+typedef struct dps_endpoint_index_policy_s {
+	dps_endpoint_index_node_t node;
+	uint32_t src_vnid;
+	uint32_t dst_vnid;
+	uint32_t type;
+	uint32_t version;
+	uint32_t ttl;
+	/**
+	 * \brief The connectivity field of dps_object_policy_action_t
+	 */
+	uint16_t connectivity;
+} dps_endpoint_index_policy_t;
+
+/**
+ * \brief Readers are the DPS Protocol workers, Writers are the PYTHON
+ *        publishing routines (which already hold the GIL)
+ */
+static pthread_rwlock_t dps_endpoint_index_lock = PTHREAD_RWLOCK_INITIALIZER;
+
+static dps_endpoint_index_table_t dps_endpoint_index_domains;
+static dps_endpoint_index_table_t dps_endpoint_index_macs;
+static dps_endpoint_index_table_t dps_endpoint_index_vips;
+static dps_endpoint_index_table_t dps_endpoint_index_policies;
+
+/*
+ ******************************************************************************
+ * DPS Endpoint Index Table Helpers                                       *//**
+ *
+ * \addtogroup DPSClientProtocolInterface
+ * @{
+ * \brief Generic chained hash helpers. Callers hold the index lock.
+ *
+ ******************************************************************************
+ */
+
+static uint32_t dps_endpoint_index_hash(uint32_t domain_id,
+                                        const void *key,
+                                        size_t key_len)
+{
+	const uint8_t *data = (const uint8_t *)key;
+	uint32_t hash = 2166136261u;
+	size_t i;
+
+	for (i = 0; i < sizeof(domain_id); i++)
+	{
+		hash = (hash ^ ((domain_id >> (i << 3)) & 0xff)) * 16777619u;
+	}
+	for (i = 0; i < key_len; i++)
+	{
+		hash = (hash ^ data[i]) * 16777619u;
+	}
+	return hash;
+}
+
+static dps_endpoint_index_node_t **dps_endpoint_index_bucket(dps_endpoint_index_table_t *table,
+                                                             uint32_t hash)
+{
+	if (table->buckets == NULL)
+	{
+		return NULL;
+	}
+	return &table->buckets[hash & (table->size - 1)];
+}
+
+static void dps_endpoint_index_grow(dps_endpoint_index_table_t *table)
+{
+	dps_endpoint_index_node_t **buckets, *node, *next;
+	uint32_t size, i;
+
+	size = (table->size == 0) ? DPS_ENDPOINT_INDEX_BUCKETS_MIN : (table->size << 1);
+	buckets = (dps_endpoint_index_node_t **)calloc(size, sizeof(dps_endpoint_index_node_t *));
+	if (buckets == NULL)
+	{
+		// Keep the current table, the chains just get longer
+		log_warn(PythonDataHandlerLogLevel,
+		         "Endpoint Index: Cannot grow table to %d buckets", size);
+		return;
+	}
+	for (i = 0; i < table->size; i++)
+	{
+		for (node = table->buckets[i]; node != NULL; node = next)
+		{
+			next = node->next;
+			node->next = buckets[node->hash & (size - 1)];
+			buckets[node->hash & (size - 1)] = node;
+		}
+	}
+	if (table->buckets != NULL)
+	{
+		free(table->buckets);
+	}
+	table->buckets = buckets;
+	table->size = size;
+	return;
+}
+
+static dove_status dps_endpoint_index_insert(dps_endpoint_index_table_t *table,
+                                             dps_endpoint_index_node_t *node)
+{
+	dps_endpoint_index_node_t **bucket;
+
+	if (table->count >= table->size)
+	{
+		dps_endpoint_index_grow(table);
+	}
+	bucket = dps_endpoint_index_bucket(table, node->hash);
+	if (bucket == NULL)
+	{
+		return DOVE_STATUS_NO_MEMORY;
+	}
+	node->next = *bucket;
+	*bucket = node;
+	table->count++;
+	return DOVE_STATUS_OK;
+}
+
+static void dps_endpoint_index_unlink(dps_endpoint_index_table_t *table,
+                                      dps_endpoint_index_node_t **prev)
+{
+	dps_endpoint_index_node_t *node = *prev;
+
+	*prev = node->next;
+	table->count--;
+	free(node);
+	return;
+}
+
+/*
+ * The find routines return the address of the link pointing at the matching
+ * record (so that it can be replaced or unlinked) or NULL.
+ */
+
+static dps_endpoint_index_node_t **dps_endpoint_index_domain_find(uint32_t domain_id)
+{
+	dps_endpoint_index_node_t **prev;
+	uint32_t hash = dps_endpoint_index_hash(domain_id, NULL, 0);
+
+	prev = dps_endpoint_index_bucket(&dps_endpoint_index_domains, hash);
+	for (; (prev != NULL) && (*prev != NULL); prev = &(*prev)->next)
+	{
+		if ((*prev)->domain_id == domain_id)
+		{
+			return prev;
+		}
+	}
+	return NULL;
+}
+
+static dps_endpoint_index_node_t **dps_endpoint_index_mac_find(uint32_t domain_id,
+                                                               uint8_t *mac)
+{
+	dps_endpoint_index_node_t **prev;
+	uint32_t hash = dps_endpoint_index_hash(domain_id, mac, 6);
+
+	prev = dps_endpoint_index_bucket(&dps_endpoint_index_macs, hash);
+	for (; (prev != NULL) && (*prev != NULL); prev = &(*prev)->next)
+	{
+		if (((*prev)->hash == hash) &&
+		    ((*prev)->domain_id == domain_id) &&
+		    (memcmp(((dps_endpoint_index_mac_t *)*prev)->mac, mac, 6) == 0))
+		{
+			return prev;
+		}
+	}
+	return NULL;
+}
+
+static uint32_t dps_endpoint_index_vip_hash(uint32_t domain_id,
+                                            uint16_t family,
+                                            uint8_t *ip)
+{
+	return dps_endpoint_index_hash(domain_id, ip, (family == AF_INET) ? 4 : 16);
+}
+
+static dps_endpoint_index_node_t **dps_endpoint_index_vip_find(uint32_t domain_id,
+                                                               uint16_t family,
+                                                               uint8_t *ip)
+{
+	dps_endpoint_index_node_t **prev;
+	dps_endpoint_index_vip_t *vip;
+	uint32_t hash = dps_endpoint_index_vip_hash(domain_id, family, ip);
+
+	prev = dps_endpoint_index_bucket(&dps_endpoint_index_vips, hash);
+	for (; (prev != NULL) && (*prev != NULL); prev = &(*prev)->next)
+	{
+		vip = (dps_endpoint_index_vip_t *)*prev;
+		if ((vip->node.hash != hash) ||
+		    (vip->node.domain_id != domain_id) ||
+		    (vip->family != family))
+		{
+			continue;
+		}
+		if (memcmp(vip->ip6, ip, (family == AF_INET) ? 4 : 16) == 0)
+		{
+			return prev;
+		}
+	}
+	return NULL;
+}
+
+static uint32_t dps_endpoint_index_policy_hash(uint32_t domain_id,
+                                               uint32_t src_vnid,
+                                               uint32_t dst_vnid)
+{
+	uint32_t key[2];
+
+	key[0] = src_vnid;
+	key[1] = dst_vnid;
+	return dps_endpoint_index_hash(domain_id, key, sizeof(key));
+}
+
+static dps_endpoint_index_node_t **dps_endpoint_index_policy_find(uint32_t domain_id,
+                                                                  uint32_t src_vnid,
+                                                                  uint32_t dst_vnid)
+{
+	dps_endpoint_index_node_t **prev;
+	dps_endpoint_index_policy_t *policy;
+	uint32_t hash = dps_endpoint_index_policy_hash(domain_id, src_vnid, dst_vnid);
+
+	prev = dps_endpoint_index_bucket(&dps_endpoint_index_policies, hash);
+	for (; (prev != NULL) && (*prev != NULL); prev = &(*prev)->next)
+	{
+		policy = (dps_endpoint_index_policy_t *)*prev;
+		if ((policy->node.hash == hash) &&
+		    (policy->node.domain_id == domain_id) &&
+		    (policy->src_vnid == src_vnid) &&
+		    (policy->dst_vnid == dst_vnid))
+		{
+			return prev;
+		}
+	}
+	return NULL;
+}
+
+static void dps_endpoint_index_table_flush(dps_endpoint_index_table_t *table,
+                                           uint32_t domain_id)
+{
+	dps_endpoint_index_node_t **prev;
+	uint32_t i;
+
+	for (i = 0; i < table->size; i++)
+	{
+		prev = &table->buckets[i];
+		while (*prev != NULL)
+		{
+			if ((*prev)->domain_id == domain_id)
+			{
+				dps_endpoint_index_unlink(table, prev);
+			}
+			else
+			{
+				prev = &(*prev)->next;
+			}
+		}
+	}
+	return;
+}
+
+/** @} */
+
+/*
+ ******************************************************************************
+ * dps_endpoint_index_resolve --                                          *//**
+ *
+ * \brief This routine resolves an Endpoint (by vMac if the IPv4 value is 0
+ *        otherwise by vIP) and fills in loc_reply. The caller holds the index
+ *        lock.
+ *
+ * \param[in] domain_id The Domain ID
+ * \param[in] mac The vMac of the Endpoint
+ * \param[in] vm_ip_addr The vIP of the Endpoint (Host Byte Order)
+ * \param[out] loc_reply The Endpoint Location Reply to fill
+ * \param[in] max_tunnels The number of tunnel_list entries that fit in
+ *                        loc_reply
+ * \param[out] num_tunnels The number of tunnels in the Endpoint record.
+ * \param[out] pdomain The Domain record
+ *
+ * \return dove_status (Same as dps_endpoint_index_lookup)
+ *
+ ******************************************************************************
+ */
+static dove_status dps_endpoint_index_resolve(uint32_t domain_id,
+                                              uint8_t *mac,
+                                              ip_addr_t *vm_ip_addr,
+                                              dps_endpoint_loc_reply_t *loc_reply,
+                                              uint32_t max_tunnels,
+                                              uint32_t *num_tunnels,
+                                              dps_endpoint_index_domain_t **pdomain)
+{
+	dps_endpoint_index_node_t **pnode;
+	dps_endpoint_index_mac_t *endpoint;
+	dps_tunnel_endpoint_t *tunnel;
+	uint32_t vIPv4, i;
+
+	pnode = dps_endpoint_index_domain_find(domain_id);
+	if (pnode == NULL)
+	{
+		return DOVE_STATUS_NOT_FOUND;
+	}
+	*pdomain = (dps_endpoint_index_domain_t *)*pnode;
+	if (!(*pdomain)->active)
+	{
+		return DOVE_STATUS_INACTIVE;
+	}
+	vIPv4 = htonl(vm_ip_addr->ip4);
+	if (vIPv4 != 0)
+	{
+		if (vm_ip_addr->family == AF_INET)
+		{
+			pnode = dps_endpoint_index_vip_find(domain_id, AF_INET,
+			                                    (uint8_t *)&vIPv4);
+		}
+		else if (vm_ip_addr->family == AF_INET6)
+		{
+			pnode = dps_endpoint_index_vip_find(domain_id, AF_INET6,
+			                                    vm_ip_addr->ip6);
+		}
+		else
+		{
+			pnode = NULL;
+		}
+		if (pnode == NULL)
+		{
+			// Could still be an Implicit Gateway, let PYTHON decide
+			return DOVE_STATUS_NOT_FOUND;
+		}
+		mac = ((dps_endpoint_index_vip_t *)*pnode)->mac;
+	}
+	pnode = dps_endpoint_index_mac_find(domain_id, mac);
+	if (pnode == NULL)
+	{
+		return DOVE_STATUS_NOT_FOUND;
+	}
+	endpoint = (dps_endpoint_index_mac_t *)*pnode;
+	*num_tunnels = endpoint->num_ipv4 + endpoint->num_ipv6;
+	if (*num_tunnels > max_tunnels)
+	{
+		return DOVE_STATUS_EXCEEDS_CAP;
+	}
+	loc_reply->vnid = endpoint->vnid;
+	loc_reply->version = endpoint->version;
+	memcpy(loc_reply->mac, endpoint->mac, 6);
+	if (vIPv4 != 0)
+	{
+		// Lookups by vIP return the vIP being looked up
+		memcpy(&loc_reply->vm_ip_addr, vm_ip_addr, sizeof(ip_addr_t));
+	}
+	else if (endpoint->vip_size == 4)
+	{
+		loc_reply->vm_ip_addr.family = AF_INET;
+		memcpy(&loc_reply->vm_ip_addr.ip4, endpoint->vip, 4);
+		loc_reply->vm_ip_addr.ip4 = ntohl(loc_reply->vm_ip_addr.ip4);
+	}
+	else
+	{
+		loc_reply->vm_ip_addr.family = AF_INET6;
+		memcpy(loc_reply->vm_ip_addr.ip6, endpoint->vip, 16);
+	}
+	for (i = 0; i < endpoint->num_ipv4; i++)
+	{
+		tunnel = &loc_reply->tunnel_info.tunnel_list[i];
+		tunnel->family = AF_INET;
+		tunnel->tunnel_type = TUNNEL_TYPE_VXLAN;
+		tunnel->vnid = endpoint->vnid;
+		tunnel->ip4 = ntohl(endpoint->tunnel_ip[i]);
+	}
+	for (i = 0; i < endpoint->num_ipv6; i++)
+	{
+		tunnel = &loc_reply->tunnel_info.tunnel_list[endpoint->num_ipv4 + i];
+		tunnel->family = AF_INET6;
+		tunnel->tunnel_type = TUNNEL_TYPE_VXLAN;
+		tunnel->vnid = endpoint->vnid;
+		memcpy(tunnel->ip6, &endpoint->tunnel_ip[endpoint->num_ipv4 + (i << 2)], 16);
+	}
+	loc_reply->tunnel_info.num_of_tunnels = (uint16_t)*num_tunnels;
+	return DOVE_STATUS_OK;
+}
+
+/*
+ ******************************************************************************
+ * dps_endpoint_index_lookup --                                           *//**
+ *
+ * \brief This routine resolves an Endpoint Location Request from the native
+ *        Endpoint Index.
+ *
+ * \param[in] domain_id The Domain ID
+ * \param[in] loc_req The Endpoint Location Request (Host Byte Order)
+ * \param[out] loc_reply The Endpoint Location Reply to fill
+ * \param[in] max_tunnels The number of tunnel_list entries that fit in
+ *                        loc_reply
+ * \param[out] num_tunnels The number of tunnels in the Endpoint record.
+ *
+ * \retval DOVE_STATUS_OK loc_reply is filled in
+ * \retval DOVE_STATUS_EXCEEDS_CAP loc_reply cannot hold num_tunnels entries
+ * \retval DOVE_STATUS_NOT_FOUND Not in the index
+ * \retval DOVE_STATUS_INACTIVE Domain not active in the index
+ *
+ ******************************************************************************
+ */
+dove_status dps_endpoint_index_lookup(uint32_t domain_id,
+                                      dps_endpoint_loc_req_t *loc_req,
+                                      dps_endpoint_loc_reply_t *loc_reply,
+                                      uint32_t max_tunnels,
+                                      uint32_t *num_tunnels)
+{
+	dps_endpoint_index_domain_t *domain = NULL;
+	dove_status status;
+
+	pthread_rwlock_rdlock(&dps_endpoint_index_lock);
+	status = dps_endpoint_index_resolve(domain_id, loc_req->mac,
+	                                    &loc_req->vm_ip_addr, loc_reply,
+	                                    max_tunnels, num_tunnels, &domain);
+	if (status == DOVE_STATUS_OK)
+	{
+		// Readers share the lock, the counter has to be atomic
+		__sync_fetch_and_add(&domain->lookups, 1);
+	}
+	pthread_rwlock_unlock(&dps_endpoint_index_lock);
+
+	return status;
+}
+
+/*
+ ******************************************************************************
+ * dps_endpoint_index_policy_lookup --                                    *//**
+ *
+ * \brief This routine resolves a Policy Request from the native Endpoint
+ *        Index and the unicast Policy table.
+ *
+ * \param[in] domain_id The Domain ID
+ * \param[in] policy_req The Policy Request (Host Byte Order)
+ * \param[out] policy_reply The Policy Reply to fill
+ * \param[in] max_tunnels The number of tunnel_list entries that fit in
+ *                        policy_reply
+ * \param[out] num_tunnels The number of tunnels of the destination Endpoint.
+ *
+ * \retval DOVE_STATUS_OK policy_reply is filled in
+ * \retval DOVE_STATUS_EXCEEDS_CAP policy_reply cannot hold num_tunnels entries
+ * \retval DOVE_STATUS_NOT_FOUND Endpoint or Policy not in the index
+ * \retval DOVE_STATUS_INACTIVE Domain not active in the index
+ *
+ ******************************************************************************
+ */
+dove_status dps_endpoint_index_policy_lookup(uint32_t domain_id,
+                                             dps_policy_req_t *policy_req,
+                                             dps_policy_reply_t *policy_reply,
+                                             uint32_t max_tunnels,
+                                             uint32_t *num_tunnels)
+{
+	dps_endpoint_index_domain_t *domain = NULL;
+	dps_endpoint_index_node_t **ppolicy;
+	dps_endpoint_index_policy_t *policy;
+	dps_policy_t *dps_policy;
+	uint32_t src_vnid, dst_vnid;
+	dove_status status;
+
+	pthread_rwlock_rdlock(&dps_endpoint_index_lock);
+	do
+	{
+		status = dps_endpoint_index_resolve(domain_id,
+		                                    policy_req->dst_endpoint.mac,
+		                                    &policy_req->dst_endpoint.vm_ip_addr,
+		                                    &policy_reply->dst_endpoint_loc_reply,
+		                                    max_tunnels, num_tunnels, &domain);
+		if (status != DOVE_STATUS_OK)
+		{
+			break;
+		}
+		src_vnid = policy_req->src_endpoint.vnid;
+		dst_vnid = policy_reply->dst_endpoint_loc_reply.vnid;
+		ppolicy = dps_endpoint_index_policy_find(domain_id, src_vnid, dst_vnid);
+		if (ppolicy == NULL)
+		{
+			// PYTHON validates the source VNID before returning the
+			// default DENY
+			status = DOVE_STATUS_NOT_FOUND;
+			break;
+		}
+		policy = (dps_endpoint_index_policy_t *)*ppolicy;
+		policy_reply->dps_policy_info.version = policy->version;
+		policy_reply->dps_policy_info.ttl = policy->ttl;
+		dps_policy = &policy_reply->dps_policy_info.dps_policy;
+		dps_policy->policy_type = (uint8_t)policy->type;
+		if (policy->type == DPS_POLICY_TYPE_CONNECTIVITY)
+		{
+			if (policy->connectivity == DPS_CONNECTIVITY_ALLOW)
+			{
+				dps_policy->vnid_policy.num_deny_rules = 0;
+				dps_policy->vnid_policy.num_permit_rules = 1;
+			}
+			else
+			{
+				dps_policy->vnid_policy.num_deny_rules = 1;
+				dps_policy->vnid_policy.num_permit_rules = 0;
+			}
+			dps_policy->vnid_policy.src_dst_vnid[0].dvnid = dst_vnid;
+			dps_policy->vnid_policy.src_dst_vnid[0].svnid = src_vnid;
+		}
+		__sync_fetch_and_add(&domain->policy_lookups, 1);
+	}while(0);
+	pthread_rwlock_unlock(&dps_endpoint_index_lock);
+
+	return status;
+}
+
+/*
+ ******************************************************************************
+ * endpoint_index_domain_activate --                                      *//**
+ *
+ * \brief This routine is called by the PYTHON Domain when it's created or
+ *        (de)activated.
+ *        def endpoint_index_domain_activate(domain_id, active)
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *endpoint_index_domain_activate(PyObject *self, PyObject *args)
+{
+	dps_endpoint_index_node_t **pdomain;
+	dps_endpoint_index_domain_t *domain;
+	uint32_t domain_id, active;
+	dove_status status = DOVE_STATUS_INVALID_PARAMETER;
+
+	do
+	{
+		if (!PyArg_ParseTuple(args, "II", &domain_id, &active))
+		{
+			log_warn(PythonDataHandlerLogLevel, "Bad Data!!!");
+			break;
+		}
+		pthread_rwlock_wrlock(&dps_endpoint_index_lock);
+		pdomain = dps_endpoint_index_domain_find(domain_id);
+		if (pdomain != NULL)
+		{
+			((dps_endpoint_index_domain_t *)*pdomain)->active = active;
+			status = DOVE_STATUS_OK;
+		}
+		else
+		{
+			domain = (dps_endpoint_index_domain_t *)malloc(sizeof(dps_endpoint_index_domain_t));
+			if (domain == NULL)
+			{
+				status = DOVE_STATUS_NO_MEMORY;
+			}
+			else
+			{
+				domain->node.domain_id = domain_id;
+				domain->node.hash = dps_endpoint_index_hash(domain_id, NULL, 0);
+				domain->active = active;
+				domain->lookups = 0;
+				domain->policy_lookups = 0;
+				status = dps_endpoint_index_insert(&dps_endpoint_index_domains,
+				                                   &domain->node);
+				if (status != DOVE_STATUS_OK)
+				{
+					free(domain);
+				}
+			}
+		}
+		pthread_rwlock_unlock(&dps_endpoint_index_lock);
+	}while(0);
+
+	return Py_BuildValue("i", status);
+}
+
+/*
+ ******************************************************************************
+ * endpoint_index_domain_flush --                                         *//**
+ *
+ * \brief This routine removes a Domain and all its Endpoints from the index.
+ *        def endpoint_index_domain_flush(domain_id)
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *endpoint_index_domain_flush(PyObject *self, PyObject *args)
+{
+	dps_endpoint_index_node_t **pdomain;
+	uint32_t domain_id;
+	dove_status status = DOVE_STATUS_INVALID_PARAMETER;
+
+	do
+	{
+		if (!PyArg_ParseTuple(args, "I", &domain_id))
+		{
+			log_warn(PythonDataHandlerLogLevel, "Bad Data!!!");
+			break;
+		}
+		pthread_rwlock_wrlock(&dps_endpoint_index_lock);
+		pdomain = dps_endpoint_index_domain_find(domain_id);
+		if (pdomain != NULL)
+		{
+			dps_endpoint_index_unlink(&dps_endpoint_index_domains, pdomain);
+		}
+		dps_endpoint_index_table_flush(&dps_endpoint_index_macs, domain_id);
+		dps_endpoint_index_table_flush(&dps_endpoint_index_vips, domain_id);
+		dps_endpoint_index_table_flush(&dps_endpoint_index_policies, domain_id);
+		pthread_rwlock_unlock(&dps_endpoint_index_lock);
+		status = DOVE_STATUS_OK;
+	}while(0);
+
+	return Py_BuildValue("i", status);
+}
+
+/*
+ ******************************************************************************
+ * endpoint_index_set --                                                  *//**
+ *
+ * \brief This routine adds or replaces the Endpoint record keyed by vMac. The
+ *        record is built outside the lock and swapped in.
+ *        def endpoint_index_set(domain_id, vMac, vnid, version,
+ *                               ipv4_list, ipv6_list, vIP_packed)
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *endpoint_index_set(PyObject *self, PyObject *args)
+{
+	dps_endpoint_index_node_t **pmac;
+	dps_endpoint_index_mac_t *endpoint = NULL;
+	PyObject *pyList_ipv4, *pyList_ipv6, *pypIP;
+	uint32_t domain_id, vnid, version;
+	Py_ssize_t num_ipv4, num_ipv6, i;
+	char *vMac, *vIP_packed, *ipv6;
+	int vMac_size, vIP_packed_size, ipv6_size;
+	uint32_t ipv4;
+	dove_status status = DOVE_STATUS_INVALID_PARAMETER;
+
+	do
+	{
+		if (!PyArg_ParseTuple(args, "Iz#IIO!O!z#",
+		                      &domain_id, &vMac, &vMac_size, &vnid, &version,
+		                      &PyList_Type, &pyList_ipv4,
+		                      &PyList_Type, &pyList_ipv6,
+		                      &vIP_packed, &vIP_packed_size))
+		{
+			log_warn(PythonDataHandlerLogLevel, "Bad Data!!!");
+			break;
+		}
+		if ((vMac == NULL) || (vMac_size != 6) || (vIP_packed == NULL) ||
+		    ((vIP_packed_size != 4) && (vIP_packed_size != 16)))
+		{
+			log_warn(PythonDataHandlerLogLevel,
+			         "Invalid vMac (size %d) or vIP (size %d)",
+			         vMac_size, vIP_packed_size);
+			break;
+		}
+		num_ipv4 = PyList_Size(pyList_ipv4);
+		num_ipv6 = PyList_Size(pyList_ipv6);
+		if ((num_ipv4 + num_ipv6) > 0xffff)
+		{
+			status = DOVE_STATUS_EXCEEDS_CAP;
+			break;
+		}
+		endpoint = (dps_endpoint_index_mac_t *)malloc(
+			dps_offsetof(dps_endpoint_index_mac_t, tunnel_ip[num_ipv4 + (num_ipv6 << 2)]));
+		if (endpoint == NULL)
+		{
+			status = DOVE_STATUS_NO_MEMORY;
+			break;
+		}
+		endpoint->node.domain_id = domain_id;
+		endpoint->node.hash = dps_endpoint_index_hash(domain_id, vMac, 6);
+		memcpy(endpoint->mac, vMac, 6);
+		endpoint->vip_size = (uint16_t)vIP_packed_size;
+		memcpy(endpoint->vip, vIP_packed, vIP_packed_size);
+		endpoint->vnid = vnid;
+		endpoint->version = version;
+		endpoint->num_ipv4 = (uint16_t)num_ipv4;
+		endpoint->num_ipv6 = (uint16_t)num_ipv6;
+		status = DOVE_STATUS_OK;
+		for (i = 0; i < num_ipv4; i++)
+		{
+			pypIP = PyList_GetItem(pyList_ipv4, i);
+			if (!PyArg_Parse(pypIP, "I", &ipv4))
+			{
+				status = DOVE_STATUS_INVALID_PARAMETER;
+				break;
+			}
+			endpoint->tunnel_ip[i] = ipv4;
+		}
+		for (i = 0; (status == DOVE_STATUS_OK) && (i < num_ipv6); i++)
+		{
+			pypIP = PyList_GetItem(pyList_ipv6, i);
+			if (!PyArg_Parse(pypIP, "z#", &ipv6, &ipv6_size) ||
+			    (ipv6 == NULL) || (ipv6_size != 16))
+			{
+				status = DOVE_STATUS_INVALID_PARAMETER;
+				break;
+			}
+			memcpy(&endpoint->tunnel_ip[num_ipv4 + (i << 2)], ipv6, 16);
+		}
+		if (status != DOVE_STATUS_OK)
+		{
+			PyErr_Clear();
+			log_warn(PythonDataHandlerLogLevel,
+			         "Invalid Tunnel IP in Endpoint " MAC_FMT,
+			         MAC_OCTETS(vMac));
+			break;
+		}
+		pthread_rwlock_wrlock(&dps_endpoint_index_lock);
+		pmac = dps_endpoint_index_mac_find(domain_id, (uint8_t *)vMac);
+		if (pmac != NULL)
+		{
+			endpoint->node.next = (*pmac)->next;
+			free(*pmac);
+			*pmac = &endpoint->node;
+		}
+		else
+		{
+			status = dps_endpoint_index_insert(&dps_endpoint_index_macs,
+			                                   &endpoint->node);
+		}
+		pthread_rwlock_unlock(&dps_endpoint_index_lock);
+		if (status == DOVE_STATUS_OK)
+		{
+			endpoint = NULL;
+		}
+	}while(0);
+
+	if (endpoint != NULL)
+	{
+		// A stale record is worse than none: lookups must fall back to PYTHON
+		pthread_rwlock_wrlock(&dps_endpoint_index_lock);
+		pmac = dps_endpoint_index_mac_find(domain_id, (uint8_t *)vMac);
+		if (pmac != NULL)
+		{
+			dps_endpoint_index_unlink(&dps_endpoint_index_macs, pmac);
+		}
+		pthread_rwlock_unlock(&dps_endpoint_index_lock);
+		free(endpoint);
+	}
+
+	return Py_BuildValue("i", status);
+}
+
+/*
+ ******************************************************************************
+ * endpoint_index_del --                                                  *//**
+ *
+ * \brief This routine removes the Endpoint record keyed by vMac.
+ *        def endpoint_index_del(domain_id, vMac)
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *endpoint_index_del(PyObject *self, PyObject *args)
+{
+	dps_endpoint_index_node_t **pmac;
+	uint32_t domain_id;
+	char *vMac;
+	int vMac_size;
+	dove_status status = DOVE_STATUS_INVALID_PARAMETER;
+
+	do
+	{
+		if (!PyArg_ParseTuple(args, "Iz#", &domain_id, &vMac, &vMac_size) ||
+		    (vMac == NULL) || (vMac_size != 6))
+		{
+			log_warn(PythonDataHandlerLogLevel, "Bad Data!!!");
+			break;
+		}
+		status = DOVE_STATUS_NOT_FOUND;
+		pthread_rwlock_wrlock(&dps_endpoint_index_lock);
+		pmac = dps_endpoint_index_mac_find(domain_id, (uint8_t *)vMac);
+		if (pmac != NULL)
+		{
+			dps_endpoint_index_unlink(&dps_endpoint_index_macs, pmac);
+			status = DOVE_STATUS_OK;
+		}
+		pthread_rwlock_unlock(&dps_endpoint_index_lock);
+	}while(0);
+
+	return Py_BuildValue("i", status);
+}
+
+/*
+ ******************************************************************************
+ * endpoint_index_vip_parse --                                            *//**
+ *
+ * \brief Converts a PYTHON vIP value (Integer for AF_INET, 16 byte string for
+ *        AF_INET6) into the index key.
+ *
+ * \return 1 on success, 0 on failure
+ *
+ ******************************************************************************
+ */
+static int endpoint_index_vip_parse(uint32_t vIP_type, PyObject *pyvIP, uint8_t *ip)
+{
+	char *ipv6;
+	int ipv6_size;
+	uint32_t ipv4;
+
+	if (vIP_type == AF_INET)
+	{
+		if (!PyArg_Parse(pyvIP, "I", &ipv4))
+		{
+			PyErr_Clear();
+			return 0;
+		}
+		memcpy(ip, &ipv4, 4);
+		return 1;
+	}
+	if (vIP_type == AF_INET6)
+	{
+		if (!PyArg_Parse(pyvIP, "z#", &ipv6, &ipv6_size) ||
+		    (ipv6 == NULL) || (ipv6_size != 16))
+		{
+			PyErr_Clear();
+			return 0;
+		}
+		memcpy(ip, ipv6, 16);
+		return 1;
+	}
+	return 0;
+}
+
+/*
+ ******************************************************************************
+ * endpoint_index_vip_add --                                              *//**
+ *
+ * \brief This routine points a vIP at an Endpoint vMac. Like the PYTHON
+ *        ip_hash the last writer wins.
+ *        def endpoint_index_vip_add(domain_id, vIP_type, vIP_val, vMac)
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *endpoint_index_vip_add(PyObject *self, PyObject *args)
+{
+	dps_endpoint_index_node_t **pvip;
+	dps_endpoint_index_vip_t *vip;
+	PyObject *pyvIP;
+	uint32_t domain_id, vIP_type;
+	uint8_t ip[16];
+	char *vMac;
+	int vMac_size;
+	dove_status status = DOVE_STATUS_INVALID_PARAMETER;
+
+	do
+	{
+		if (!PyArg_ParseTuple(args, "IIOz#", &domain_id, &vIP_type, &pyvIP,
+		                      &vMac, &vMac_size) ||
+		    (vMac == NULL) || (vMac_size != 6) ||
+		    !endpoint_index_vip_parse(vIP_type, pyvIP, ip))
+		{
+			log_warn(PythonDataHandlerLogLevel, "Bad Data!!!");
+			break;
+		}
+		status = DOVE_STATUS_OK;
+		pthread_rwlock_wrlock(&dps_endpoint_index_lock);
+		pvip = dps_endpoint_index_vip_find(domain_id, (uint16_t)vIP_type, ip);
+		if (pvip != NULL)
+		{
+			memcpy(((dps_endpoint_index_vip_t *)*pvip)->mac, vMac, 6);
+		}
+		else
+		{
+			vip = (dps_endpoint_index_vip_t *)malloc(sizeof(dps_endpoint_index_vip_t));
+			if (vip == NULL)
+			{
+				status = DOVE_STATUS_NO_MEMORY;
+			}
+			else
+			{
+				vip->node.domain_id = domain_id;
+				vip->node.hash = dps_endpoint_index_vip_hash(domain_id,
+				                                             (uint16_t)vIP_type,
+				                                             ip);
+				vip->family = (uint16_t)vIP_type;
+				memcpy(vip->mac, vMac, 6);
+				memset(vip->ip6, 0, 16);
+				memcpy(vip->ip6, ip, (vIP_type == AF_INET) ? 4 : 16);
+				status = dps_endpoint_index_insert(&dps_endpoint_index_vips,
+				                                   &vip->node);
+				if (status != DOVE_STATUS_OK)
+				{
+					free(vip);
+				}
+			}
+		}
+		pthread_rwlock_unlock(&dps_endpoint_index_lock);
+	}while(0);
+
+	return Py_BuildValue("i", status);
+}
+
+/*
+ ******************************************************************************
+ * endpoint_index_vip_del --                                              *//**
+ *
+ * \brief This routine removes a vIP from the index.
+ *        def endpoint_index_vip_del(domain_id, vIP_type, vIP_val)
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *endpoint_index_vip_del(PyObject *self, PyObject *args)
+{
+	dps_endpoint_index_node_t **pvip;
+	PyObject *pyvIP;
+	uint32_t domain_id, vIP_type;
+	uint8_t ip[16];
+	dove_status status = DOVE_STATUS_INVALID_PARAMETER;
+
+	do
+	{
+		if (!PyArg_ParseTuple(args, "IIO", &domain_id, &vIP_type, &pyvIP) ||
+		    !endpoint_index_vip_parse(vIP_type, pyvIP, ip))
+		{
+			log_warn(PythonDataHandlerLogLevel, "Bad Data!!!");
+			break;
+		}
+		status = DOVE_STATUS_NOT_FOUND;
+		pthread_rwlock_wrlock(&dps_endpoint_index_lock);
+		pvip = dps_endpoint_index_vip_find(domain_id, (uint16_t)vIP_type, ip);
+		if (pvip != NULL)
+		{
+			dps_endpoint_index_unlink(&dps_endpoint_index_vips, pvip);
+			status = DOVE_STATUS_OK;
+		}
+		pthread_rwlock_unlock(&dps_endpoint_index_lock);
+	}while(0);
+
+	return Py_BuildValue("i", status);
+}
+
+/*
+ ******************************************************************************
+ * endpoint_index_policy_set --                                           *//**
+ *
+ * \brief This routine adds or replaces a unicast Policy.
+ *        def endpoint_index_policy_set(domain_id, src_vnid, dst_vnid, type,
+ *                                      version, ttl, action_packed)
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *endpoint_index_policy_set(PyObject *self, PyObject *args)
+{
+	dps_endpoint_index_node_t **ppolicy;
+	dps_endpoint_index_policy_t *policy;
+	dps_object_policy_action_t *action;
+	uint32_t domain_id, src_vnid, dst_vnid, type, version, ttl;
+	char *action_packed;
+	int action_packed_size;
+	dove_status status = DOVE_STATUS_INVALID_PARAMETER;
+
+	do
+	{
+		if (!PyArg_ParseTuple(args, "IIIIIIz#", &domain_id, &src_vnid,
+		                      &dst_vnid, &type, &version, &ttl,
+		                      &action_packed, &action_packed_size) ||
+		    (action_packed == NULL) ||
+		    (action_packed_size < (int)dps_offsetof(dps_object_policy_action_t, connectivity) + 2))
+		{
+			log_warn(PythonDataHandlerLogLevel, "Bad Data!!!");
+			break;
+		}
+		action = (dps_object_policy_action_t *)action_packed;
+		status = DOVE_STATUS_OK;
+		pthread_rwlock_wrlock(&dps_endpoint_index_lock);
+		ppolicy = dps_endpoint_index_policy_find(domain_id, src_vnid, dst_vnid);
+		if (ppolicy != NULL)
+		{
+			policy = (dps_endpoint_index_policy_t *)*ppolicy;
+		}
+		else
+		{
+			policy = (dps_endpoint_index_policy_t *)malloc(sizeof(dps_endpoint_index_policy_t));
+			if (policy == NULL)
+			{
+				status = DOVE_STATUS_NO_MEMORY;
+			}
+			else
+			{
+				policy->node.domain_id = domain_id;
+				policy->node.hash = dps_endpoint_index_policy_hash(domain_id,
+				                                                   src_vnid,
+				                                                   dst_vnid);
+				policy->src_vnid = src_vnid;
+				policy->dst_vnid = dst_vnid;
+				status = dps_endpoint_index_insert(&dps_endpoint_index_policies,
+				                                   &policy->node);
+				if (status != DOVE_STATUS_OK)
+				{
+					free(policy);
+				}
+			}
+		}
+		if (status == DOVE_STATUS_OK)
+		{
+			policy->type = type;
+			policy->version = version;
+			policy->ttl = ttl;
+			policy->connectivity = action->connectivity;
+		}
+		pthread_rwlock_unlock(&dps_endpoint_index_lock);
+	}while(0);
+
+	return Py_BuildValue("i", status);
+}
+
+/*
+ ******************************************************************************
+ * endpoint_index_policy_del --                                           *//**
+ *
+ * \brief This routine removes a unicast Policy.
+ *        def endpoint_index_policy_del(domain_id, src_vnid, dst_vnid)
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *endpoint_index_policy_del(PyObject *self, PyObject *args)
+{
+	dps_endpoint_index_node_t **ppolicy;
+	uint32_t domain_id, src_vnid, dst_vnid;
+	dove_status status = DOVE_STATUS_INVALID_PARAMETER;
+
+	do
+	{
+		if (!PyArg_ParseTuple(args, "III", &domain_id, &src_vnid, &dst_vnid))
+		{
+			log_warn(PythonDataHandlerLogLevel, "Bad Data!!!");
+			break;
+		}
+		status = DOVE_STATUS_NOT_FOUND;
+		pthread_rwlock_wrlock(&dps_endpoint_index_lock);
+		ppolicy = dps_endpoint_index_policy_find(domain_id, src_vnid, dst_vnid);
+		if (ppolicy != NULL)
+		{
+			dps_endpoint_index_unlink(&dps_endpoint_index_policies, ppolicy);
+			status = DOVE_STATUS_OK;
+		}
+		pthread_rwlock_unlock(&dps_endpoint_index_lock);
+	}while(0);
+
+	return Py_BuildValue("i", status);
+}
+
+/*
+ ******************************************************************************
+ * endpoint_index_lookups_fetch --                                        *//**
+ *
+ * \brief This routine returns (and resets) the number of Endpoint and Policy
+ *        Lookups served by the index for a Domain.
+ *        def endpoint_index_lookups_fetch(domain_id)
+ *
+ * \return PyObject (endpoint_lookups, policy_lookups)
+ *
+ ******************************************************************************
+ */
+PyObject *endpoint_index_lookups_fetch(PyObject *self, PyObject *args)
+{
+	dps_endpoint_index_node_t **pdomain;
+	dps_endpoint_index_domain_t *domain;
+	uint32_t domain_id;
+	uint32_t lookups = 0;
+	uint32_t policy_lookups = 0;
+
+	do
+	{
+		if (!PyArg_ParseTuple(args, "I", &domain_id))
+		{
+			log_warn(PythonDataHandlerLogLevel, "Bad Data!!!");
+			break;
+		}
+		// The read lock is enough: readers only ever add to the counters
+		pthread_rwlock_rdlock(&dps_endpoint_index_lock);
+		pdomain = dps_endpoint_index_domain_find(domain_id);
+		if (pdomain != NULL)
+		{
+			domain = (dps_endpoint_index_domain_t *)*pdomain;
+			lookups = __sync_lock_test_and_set(&domain->lookups, 0);
+			policy_lookups = __sync_lock_test_and_set(&domain->policy_lookups, 0);
+		}
+		pthread_rwlock_unlock(&dps_endpoint_index_lock);
+	}while(0);
+
+	return Py_BuildValue("(II)", lookups, policy_lookups);
+}
@@ -0,0 +1,1207 @@
+/******************************************************************************
+** File Main Owner:   DOVE DPS Development Team
+** File Description:  Replication Channels for Endpoint Updates
+**/
+/*
+{
+* Copyright (c) 2010-2013 IBM Corporation
+* All rights reserved.
+*
+* This program and the accompanying materials are made available under the
+* terms of the Eclipse Public License v1.0 which accompanies this
+* distribution, and is available at http://www.eclipse.org/legal/epl-v10.html
+*
+*
+*  HISTORY
+*
+*  $Log: replication_channel.c $
+*  $EndLog$
+*
+*  PORTING HISTORY
+*
+}
+*/
+
+#include "include.h"
+
+/**
+ * \brief Number of batches a Replication Channel can have unacked
+ */
+#define DPS_REPLICATION_WINDOW 32
+
+/**
+ * \brief Time (ms) after which the unacked batches are sent again. The
+ *        time doubles with every retransmission without progress, up to
+ *        DPS_REPLICATION_RETRANSMIT_MS << DPS_REPLICATION_BACKOFF_MAX.
+ */
+#define DPS_REPLICATION_RETRANSMIT_MS 500
+#define DPS_REPLICATION_BACKOFF_MAX 3
+
+/**
+ * \brief Time (ms) the Shared Address Space has to ack an update. Matches
+ *        the timeout of the PYTHON Replication Tracker (3 x 6 seconds).
+ */
+#define DPS_REPLICATION_SHARED_TIMEOUT_MS 18000
+
+/**
+ * \brief Time (ms) a Replication Channel may go without progress before
+ *        its updates are failed with DPS_ERROR_RETRY. The same budget as the
+ *        Shared Address Space, so a peer busy for a few seconds isn't reset.
+ */
+#define DPS_REPLICATION_STALL_MS DPS_REPLICATION_SHARED_TIMEOUT_MS
+
+/**
+ * \brief Idle time (ms) after which a Domain or a sending Channel is freed
+ */
+#define DPS_REPLICATION_TX_IDLE_MS 30000
+
+/**
+ * \brief Idle time (ms) after which a receiving Channel is freed. Longer than
+ *        the sender's so that the sender always starts a new Channel first.
+ */
+#define DPS_REPLICATION_RX_IDLE_MS 120000
+
+/**
+ * \brief Interval (ms) of the Replication Channel timer
+ */
+#define DPS_REPLICATION_TICK_MS 10
+
+/**
+ * \brief Interval (ms) of the idle and Shared Address Space timeout scans
+ */
+#define DPS_REPLICATION_SCAN_MS 1000
+
+/**
+ * \brief Maximum number of other DCS Servers a Domain is replicated to
+ */
+#define DPS_REPLICATION_NODES_MAX 8
+
+/**
+ * \brief Hash table sizes (powers of 2)
+ */
+#define DPS_REPLICATION_UPDATE_BUCKETS 4096
+#define DPS_REPLICATION_DOMAIN_BUCKETS 256
+#define DPS_REPLICATION_CHANNEL_BUCKETS 256
+
+/**
+ * \brief An Endpoint Update waiting for its acks. It is freed when the last
+ *        ack (local queue, Shared Address Space, one per batch it was sent
+ *        in) is in.
+ */
+typedef struct dps_replication_update_s {
+	struct dps_replication_update_s *hash_next;
+	struct dps_replication_update_s *queue_next;
+	uint32_t id;
+	uint32_t domain_id;
+	uint32_t pending;
+	uint64_t shared_deadline;
+	dps_client_data_t *reply;
+	dps_replication_entry_t entry;
+} dps_replication_update_t;
+
+/**
+ * \brief The updates of a Domain not yet handed to the Replication Channels
+ */
+typedef struct dps_replication_domain_s {
+	struct dps_replication_domain_s *hash_next;
+	struct dps_replication_domain_s *dirty_next;
+	uint32_t domain_id;
+	uint8_t dirty;
+	uint8_t flushing;
+	dps_replication_update_t *queue_head;
+	dps_replication_update_t *queue_tail;
+	uint64_t last_ms;
+} dps_replication_domain_t;
+
+/**
+ * \brief A batch on a sending Replication Channel
+ */
+typedef struct dps_replication_tx_batch_s {
+	struct dps_replication_tx_batch_s *next;
+	uint32_t seq_num;
+	uint32_t num_entries;
+	dps_replication_update_t *updates[DPS_REPLICATION_BATCH_MAX];
+} dps_replication_tx_batch_t;
+
+/**
+ * \brief The sending side of the Replication Channel of a (Domain, DCS Server)
+ *        pair. Batches from head up to unsent are in flight, the batches from
+ *        unsent on wait for the window. Only the tail batch takes more
+ *        updates and only while it hasn't been sent.
+ */
+typedef struct dps_replication_tx_channel_s {
+	struct dps_replication_tx_channel_s *hash_next;
+	struct dps_replication_tx_channel_s *id_hash_next;
+	uint32_t domain_id;
+	ip_addr_t peer;
+	uint32_t channel_id;
+	uint32_t next_seq;
+	dps_replication_tx_batch_t *head;
+	dps_replication_tx_batch_t *tail;
+	dps_replication_tx_batch_t *unsent;
+	uint32_t in_flight;
+	uint32_t retries;
+	uint64_t sent_ms;
+	uint64_t progress_ms;
+	uint64_t last_ms;
+} dps_replication_tx_channel_t;
+
+/**
+ * \brief The receiving side of a Replication Channel
+ */
+typedef struct dps_replication_rx_channel_s {
+	struct dps_replication_rx_channel_s *hash_next;
+	ip_addr_t peer;
+	uint32_t channel_id;
+	uint32_t ack_seq;
+	uint8_t busy;
+	uint32_t errors_seq_num;
+	uint32_t num_errors;
+	uint32_t next_error;
+	dps_replication_error_t errors[DPS_REPLICATION_ACK_ERRORS_MAX];
+	uint64_t last_ms;
+} dps_replication_rx_channel_t;
+
+/**
+ * \brief Protects everything below. The PYTHON GIL is never taken while
+ *        holding it since the legacy replication completes updates with the
+ *        GIL held.
+ */
+static pthread_mutex_t dps_replication_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static dps_replication_update_t *dps_replication_updates[DPS_REPLICATION_UPDATE_BUCKETS];
+static dps_replication_domain_t *dps_replication_domains[DPS_REPLICATION_DOMAIN_BUCKETS];
+static dps_replication_tx_channel_t *dps_replication_tx_channels[DPS_REPLICATION_CHANNEL_BUCKETS];
+static dps_replication_tx_channel_t *dps_replication_tx_channel_ids[DPS_REPLICATION_CHANNEL_BUCKETS];
+static dps_replication_rx_channel_t *dps_replication_rx_channels[DPS_REPLICATION_CHANNEL_BUCKETS];
+
+/**
+ * \brief Domains with queued updates that no flush has picked up yet.
+ *        Peeked without the lock to keep idle flushes cheap.
+ */
+static dps_replication_domain_t * volatile dps_replication_dirty;
+
+static uint32_t dps_replication_update_id;
+static uint32_t dps_replication_channel_id;
+
+/**
+ * \brief The buffer the batches are formed in
+ */
+static union {
+	dps_client_data_t msg;
+	uint8_t buff[sizeof(dps_client_data_t) +
+	             (DPS_REPLICATION_BATCH_MAX * sizeof(dps_replication_entry_t))];
+} dps_replication_tx_buff;
+
+static uint64_t dps_replication_time_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000) + (ts.tv_nsec / 1000000);
+}
+
+static int dps_replication_addr_equal(ip_addr_t *addr1, ip_addr_t *addr2)
+{
+	if (addr1->family != addr2->family)
+	{
+		return 0;
+	}
+	if (addr1->family == AF_INET)
+	{
+		return (addr1->ip4 == addr2->ip4);
+	}
+	return !memcmp(addr1->ip6, addr2->ip6, 16);
+}
+
+static uint32_t dps_replication_addr_hash(ip_addr_t *addr)
+{
+	uint32_t hash;
+
+	if (addr->family == AF_INET)
+	{
+		hash = addr->ip4;
+	}
+	else
+	{
+		hash = ((uint32_t *)addr->ip6)[0] ^ ((uint32_t *)addr->ip6)[1] ^
+		       ((uint32_t *)addr->ip6)[2] ^ ((uint32_t *)addr->ip6)[3];
+	}
+	return hash * 2654435769u;
+}
+
+static inline uint32_t dps_replication_update_bucket(uint32_t id)
+{
+	return id & (DPS_REPLICATION_UPDATE_BUCKETS - 1);
+}
+
+static inline uint32_t dps_replication_domain_bucket(uint32_t domain_id)
+{
+	return (domain_id * 2654435769u) >> 24 & (DPS_REPLICATION_DOMAIN_BUCKETS - 1);
+}
+
+static inline uint32_t dps_replication_channel_bucket(uint32_t domain_id, ip_addr_t *peer)
+{
+	return ((domain_id * 2654435769u) ^ dps_replication_addr_hash(peer)) >> 24 &
+	       (DPS_REPLICATION_CHANNEL_BUCKETS - 1);
+}
+
+static inline uint32_t dps_replication_channel_id_bucket(uint32_t channel_id)
+{
+	return (channel_id * 2654435769u) >> 24 & (DPS_REPLICATION_CHANNEL_BUCKETS - 1);
+}
+
+/*
+ ******************************************************************************
+ * dps_replication_update_release --                                      *//**
+ *
+ * \brief This routine drops one pending ack of an update. The first failure
+ *        is replied to the DPS Client right away, success once the last ack
+ *        is in. Called with dps_replication_lock held.
+ *
+ * \param[in] update The update
+ * \param[in] status The dps_resp_status_t of the ack
+ *
+ ******************************************************************************
+ */
+static void dps_replication_update_release(dps_replication_update_t *update,
+                                           uint32_t status)
+{
+	dps_replication_update_t **pprev;
+
+	if ((status != DPS_NO_ERR) && (update->reply != NULL))
+	{
+		log_info(PythonDataHandlerLogLevel,
+		         "Update %d failed with status %d", update->id, status);
+		dps_msg_reply_send_and_free(update->reply, status);
+		update->reply = NULL;
+	}
+	if (--update->pending != 0)
+	{
+		return;
+	}
+	if (update->reply != NULL)
+	{
+		dps_msg_reply_send_and_free(update->reply, DPS_NO_ERR);
+		update->reply = NULL;
+	}
+	pprev = &dps_replication_updates[dps_replication_update_bucket(update->id)];
+	while (*pprev != NULL)
+	{
+		if (*pprev == update)
+		{
+			*pprev = update->hash_next;
+			break;
+		}
+		pprev = &(*pprev)->hash_next;
+	}
+	free(update);
+}
+
+static dps_replication_domain_t *dps_replication_domain_get(uint32_t domain_id)
+{
+	dps_replication_domain_t *domain;
+	uint32_t bucket = dps_replication_domain_bucket(domain_id);
+
+	for (domain = dps_replication_domains[bucket]; domain != NULL; domain = domain->hash_next)
+	{
+		if (domain->domain_id == domain_id)
+		{
+			return domain;
+		}
+	}
+	domain = (dps_replication_domain_t *)calloc(1, sizeof(dps_replication_domain_t));
+	if (domain == NULL)
+	{
+		return NULL;
+	}
+	domain->domain_id = domain_id;
+	domain->hash_next = dps_replication_domains[bucket];
+	dps_replication_domains[bucket] = domain;
+	return domain;
+}
+
+static void dps_replication_domain_mark_dirty(dps_replication_domain_t *domain)
+{
+	if (domain->dirty || domain->flushing)
+	{
+		return;
+	}
+	domain->dirty = 1;
+	domain->dirty_next = dps_replication_dirty;
+	dps_replication_dirty = domain;
+}
+
+static uint32_t dps_replication_channel_id_new(void)
+{
+	uint32_t channel_id;
+
+	do
+	{
+		channel_id = ++dps_replication_channel_id;
+	} while (channel_id == 0);
+	return channel_id;
+}
+
+static void dps_replication_tx_channel_id_unhash(dps_replication_tx_channel_t *channel)
+{
+	dps_replication_tx_channel_t **pprev;
+
+	pprev = &dps_replication_tx_channel_ids[dps_replication_channel_id_bucket(channel->channel_id)];
+	while (*pprev != NULL)
+	{
+		if (*pprev == channel)
+		{
+			*pprev = channel->id_hash_next;
+			break;
+		}
+		pprev = &(*pprev)->id_hash_next;
+	}
+}
+
+static void dps_replication_tx_channel_id_hash(dps_replication_tx_channel_t *channel)
+{
+	uint32_t bucket = dps_replication_channel_id_bucket(channel->channel_id);
+
+	channel->id_hash_next = dps_replication_tx_channel_ids[bucket];
+	dps_replication_tx_channel_ids[bucket] = channel;
+}
+
+static dps_replication_tx_channel_t *dps_replication_tx_channel_get(uint32_t domain_id,
+                                                                    ip_addr_t *peer)
+{
+	dps_replication_tx_channel_t *channel;
+	uint32_t bucket = dps_replication_channel_bucket(domain_id, peer);
+
+	for (channel = dps_replication_tx_channels[bucket]; channel != NULL; channel = channel->hash_next)
+	{
+		if ((channel->domain_id == domain_id) &&
+		    dps_replication_addr_equal(&channel->peer, peer))
+		{
+			return channel;
+		}
+	}
+	channel = (dps_replication_tx_channel_t *)calloc(1, sizeof(dps_replication_tx_channel_t));
+	if (channel == NULL)
+	{
+		return NULL;
+	}
+	channel->domain_id = domain_id;
+	memcpy(&channel->peer, peer, sizeof(ip_addr_t));
+	channel->channel_id = dps_replication_channel_id_new();
+	channel->next_seq = 1;
+	channel->last_ms = dps_replication_time_ms();
+	channel->hash_next = dps_replication_tx_channels[bucket];
+	dps_replication_tx_channels[bucket] = channel;
+	dps_replication_tx_channel_id_hash(channel);
+	return channel;
+}
+
+/*
+ ******************************************************************************
+ * dps_replication_tx_channel_reset --                                    *//**
+ *
+ * \brief This routine fails every update on a Replication Channel with
+ *        DPS_ERROR_RETRY and restarts the Channel under a new Channel ID so
+ *        that the receiver starts again at sequence number 1.
+ *
+ * \param[in] channel The Replication Channel
+ *
+ ******************************************************************************
+ */
+static void dps_replication_tx_channel_reset(dps_replication_tx_channel_t *channel)
+{
+	dps_replication_tx_batch_t *batch;
+	uint32_t i;
+
+	while ((batch = channel->head) != NULL)
+	{
+		channel->head = batch->next;
+		for (i = 0; i < batch->num_entries; i++)
+		{
+			dps_replication_update_release(batch->updates[i], DPS_ERROR_RETRY);
+		}
+		free(batch);
+	}
+	channel->tail = channel->unsent = NULL;
+	channel->in_flight = 0;
+	channel->retries = 0;
+	dps_replication_tx_channel_id_unhash(channel);
+	channel->channel_id = dps_replication_channel_id_new();
+	channel->next_seq = 1;
+	dps_replication_tx_channel_id_hash(channel);
+}
+
+static void dps_replication_tx_batch_send(dps_replication_tx_channel_t *channel,
+                                          dps_replication_tx_batch_t *batch)
+{
+	dps_client_data_t *msg = &dps_replication_tx_buff.msg;
+	uint32_t i;
+
+	memset(&msg->hdr, 0, sizeof(dps_client_hdr_t));
+	msg->context = NULL;
+	msg->hdr.type = DPS_REPLICATION_BATCH;
+	msg->hdr.client_id = DPS_POLICY_SERVER_ID;
+	msg->hdr.transaction_type = DPS_TRANSACTION_REPLICATION;
+	msg->hdr.vnid = batch->updates[0]->entry.vnid;
+	msg->hdr.resp_status = DPS_NO_ERR;
+	memcpy(&msg->hdr.reply_addr, &channel->peer, sizeof(ip_addr_t));
+	msg->replication_batch.channel_id = channel->channel_id;
+	msg->replication_batch.seq_num = batch->seq_num;
+	msg->replication_batch.num_entries = batch->num_entries;
+	for (i = 0; i < batch->num_entries; i++)
+	{
+		memcpy(&msg->replication_batch.entries[i],
+		       &batch->updates[i]->entry,
+		       sizeof(dps_replication_entry_t));
+	}
+	if (dps_protocol_client_send(msg) != DPS_SUCCESS)
+	{
+		// The retransmission timer takes care of it
+		log_info(PythonDataHandlerLogLevel,
+		         "Channel %d: Cannot send batch %d",
+		         channel->channel_id, batch->seq_num);
+	}
+}
+
+/*
+ ******************************************************************************
+ * dps_replication_tx_channel_send --                                     *//**
+ *
+ * \brief This routine sends the waiting batches of a Replication Channel that
+ *        fit in the window. Called with dps_replication_lock held.
+ *
+ * \param[in] channel The Replication Channel
+ * \param[in] now_ms The current time
+ *
+ ******************************************************************************
+ */
+static void dps_replication_tx_channel_send(dps_replication_tx_channel_t *channel,
+                                            uint64_t now_ms)
+{
+	while ((channel->unsent != NULL) &&
+	       (channel->in_flight < DPS_REPLICATION_WINDOW))
+	{
+		if (channel->in_flight == 0)
+		{
+			channel->sent_ms = now_ms;
+			channel->progress_ms = now_ms;
+		}
+		dps_replication_tx_batch_send(channel, channel->unsent);
+		channel->unsent = channel->unsent->next;
+		channel->in_flight++;
+	}
+}
+
+static dove_status dps_replication_tx_channel_append(dps_replication_tx_channel_t *channel,
+                                                     dps_replication_update_t *update)
+{
+	dps_replication_tx_batch_t *batch = channel->tail;
+
+	if ((channel->unsent == NULL) ||
+	    (batch->num_entries == DPS_REPLICATION_BATCH_MAX))
+	{
+		batch = (dps_replication_tx_batch_t *)malloc(sizeof(dps_replication_tx_batch_t));
+		if (batch == NULL)
+		{
+			return DOVE_STATUS_NO_MEMORY;
+		}
+		batch->next = NULL;
+		batch->seq_num = channel->next_seq++;
+		batch->num_entries = 0;
+		if (channel->tail == NULL)
+		{
+			channel->head = batch;
+		}
+		else
+		{
+			channel->tail->next = batch;
+		}
+		channel->tail = batch;
+		if (channel->unsent == NULL)
+		{
+			channel->unsent = batch;
+		}
+	}
+	batch->updates[batch->num_entries++] = update;
+	update->pending++;
+	return DOVE_STATUS_OK;
+}
+
+/*
+ ******************************************************************************
+ * dps_replication_domain_distribute --                                   *//**
+ *
+ * \brief This routine hands the updates detached from a Domain to the
+ *        Replication Channels of the other DCS Servers. Called with
+ *        dps_replication_lock held.
+ *
+ * \param[in] domain The Domain
+ * \param[in] queue The updates in the order they were received
+ * \param[in] status The status of the DCS Server lookup
+ * \param[in] nodes The other DCS Servers of the Domain
+ * \param[in] num_nodes The number of other DCS Servers
+ *
+ ******************************************************************************
+ */
+static void dps_replication_domain_distribute(dps_replication_domain_t *domain,
+                                              dps_replication_update_t *queue,
+                                              uint32_t status,
+                                              ip_addr_t *nodes,
+                                              uint32_t num_nodes)
+{
+	dps_replication_tx_channel_t *channels[DPS_REPLICATION_NODES_MAX];
+	dps_replication_update_t *update;
+	uint64_t now_ms = dps_replication_time_ms();
+	uint32_t i, update_status;
+
+	for (i = 0; (status == DPS_NO_ERR) && (i < num_nodes); i++)
+	{
+		channels[i] = dps_replication_tx_channel_get(domain->domain_id, &nodes[i]);
+		if (channels[i] == NULL)
+		{
+			status = DPS_NO_MEMORY;
+		}
+	}
+
+	while ((update = queue) != NULL)
+	{
+		queue = update->queue_next;
+		update->queue_next = NULL;
+		update_status = status;
+		for (i = 0; (status == DPS_NO_ERR) && (i < num_nodes); i++)
+		{
+			if (dps_replication_tx_channel_append(channels[i], update) != DOVE_STATUS_OK)
+			{
+				update_status = DPS_NO_MEMORY;
+				break;
+			}
+		}
+		// Drop the token of the queue
+		dps_replication_update_release(update, update_status);
+	}
+
+	for (i = 0; (status == DPS_NO_ERR) && (i < num_nodes); i++)
+	{
+		channels[i]->last_ms = now_ms;
+		dps_replication_tx_channel_send(channels[i], now_ms);
+	}
+}
+
+/*
+ ******************************************************************************
+ * dps_replication_update_queue --                                        *//**
+ *
+ * \brief This routine queues an Endpoint Update, already applied on the
+ *        local node, for replication to the other DCS Servers of the
+ *        Domain. The reply is sent to the DPS Client when all of them have
+ *        acked the update, or as soon as one of them fails it.
+ *
+ * \param[in] domain_id The Domain ID
+ * \param[in] entry The Endpoint Update as received from the DPS Client
+ * \param[in] reply The reply to the DPS Client. Owned by the Replication
+ *                  Channels from here on.
+ * \param[in] fShared 1 if the update must also be acked by the Shared
+ *                    Address Space (see dps_replication_update_complete)
+ * \param[out] update_id The Query ID the Shared Address Space update must
+ *                       use
+ *
+ * \retval DOVE_STATUS_OK The update was queued
+ * \retval DOVE_STATUS_NO_MEMORY The reply wasn't taken over
+ *
+ ******************************************************************************
+ */
+dove_status dps_replication_update_queue(uint32_t domain_id,
+                                         dps_replication_entry_t *entry,
+                                         dps_client_data_t *reply,
+                                         uint32_t fShared,
+                                         uint32_t *update_id)
+{
+	dps_replication_update_t *update;
+	dps_replication_domain_t *domain;
+	uint32_t bucket;
+	uint64_t now_ms = dps_replication_time_ms();
+
+	update = (dps_replication_update_t *)malloc(sizeof(dps_replication_update_t));
+	if (update == NULL)
+	{
+		return DOVE_STATUS_NO_MEMORY;
+	}
+	memcpy(&update->entry, entry, sizeof(dps_replication_entry_t));
+	if (update->entry.endpoint_update.tunnel_info.num_of_tunnels > 1)
+	{
+		update->entry.endpoint_update.tunnel_info.num_of_tunnels = 1;
+	}
+	update->domain_id = domain_id;
+	update->reply = reply;
+	update->queue_next = NULL;
+	update->pending = 1;
+	update->shared_deadline = 0;
+	if (fShared)
+	{
+		update->pending++;
+		update->shared_deadline = now_ms + DPS_REPLICATION_SHARED_TIMEOUT_MS;
+	}
+
+	pthread_mutex_lock(&dps_replication_lock);
+	domain = dps_replication_domain_get(domain_id);
+	if (domain == NULL)
+	{
+		pthread_mutex_unlock(&dps_replication_lock);
+		free(update);
+		return DOVE_STATUS_NO_MEMORY;
+	}
+	update->id = DPS_REPLICATION_UPDATE_ID_BASE |
+	             (++dps_replication_update_id & ~DPS_REPLICATION_UPDATE_ID_BASE);
+	bucket = dps_replication_update_bucket(update->id);
+	update->hash_next = dps_replication_updates[bucket];
+	dps_replication_updates[bucket] = update;
+	if (domain->queue_tail == NULL)
+	{
+		domain->queue_head = update;
+	}
+	else
+	{
+		domain->queue_tail->queue_next = update;
+	}
+	domain->queue_tail = update;
+	domain->last_ms = now_ms;
+	dps_replication_domain_mark_dirty(domain);
+	*update_id = update->id;
+	pthread_mutex_unlock(&dps_replication_lock);
+
+	return DOVE_STATUS_OK;
+}
+
+/*
+ ******************************************************************************
+ * dps_replication_update_complete --                                     *//**
+ *
+ * \brief This routine handles the Endpoint Update Reply of the Shared Address
+ *        Space for an update queued by dps_replication_update_queue.
+ *
+ * \param[in] update_id The Query ID in the reply
+ * \param[in] status The dps_resp_status_t in the reply
+ *
+ * \retval 1 The Query ID belongs to the Replication Channels
+ * \retval 0 The Query ID belongs to PYTHON
+ *
+ ******************************************************************************
+ */
+int dps_replication_update_complete(uint32_t update_id, uint32_t status)
+{
+	dps_replication_update_t *update;
+
+	if (!(update_id & DPS_REPLICATION_UPDATE_ID_BASE))
+	{
+		return 0;
+	}
+	pthread_mutex_lock(&dps_replication_lock);
+	for (update = dps_replication_updates[dps_replication_update_bucket(update_id)];
+	     update != NULL;
+	     update = update->hash_next)
+	{
+		if (update->id == update_id)
+		{
+			break;
+		}
+	}
+	// A late or duplicate reply finds nothing
+	if ((update != NULL) && (update->shared_deadline != 0))
+	{
+		update->shared_deadline = 0;
+		dps_replication_update_release(update, status);
+	}
+	pthread_mutex_unlock(&dps_replication_lock);
+	return 1;
+}
+
+/*
+ ******************************************************************************
+ * dps_replication_flush --                                               *//**
+ *
+ * \brief This routine hands the queued updates of every Domain to the
+ *        Replication Channels and sends the batches the windows allow. It
+ *        is called at the end of every burst of the DPS Protocol Handler
+ *        Threads and by the Replication Channel timer.
+ *        MUST NOT be called with the PYTHON GIL held.
+ *
+ ******************************************************************************
+ */
+void dps_replication_flush(void)
+{
+	dps_replication_domain_t *dirty, *domain;
+	dps_replication_update_t *queue;
+	ip_addr_t nodes[DPS_REPLICATION_NODES_MAX];
+	uint32_t num_nodes;
+	dps_resp_status_t status;
+
+	if (dps_replication_dirty == NULL)
+	{
+		return;
+	}
+
+	pthread_mutex_lock(&dps_replication_lock);
+	dirty = dps_replication_dirty;
+	dps_replication_dirty = NULL;
+	for (domain = dirty; domain != NULL; domain = domain->dirty_next)
+	{
+		domain->dirty = 0;
+		domain->flushing = 1;
+	}
+	pthread_mutex_unlock(&dps_replication_lock);
+
+	while ((domain = dirty) != NULL)
+	{
+		dirty = domain->dirty_next;
+		domain->dirty_next = NULL;
+
+		// Updates queued while PYTHON looks up the nodes go in the
+		// next flush
+		pthread_mutex_lock(&dps_replication_lock);
+		queue = domain->queue_head;
+		domain->queue_head = domain->queue_tail = NULL;
+		pthread_mutex_unlock(&dps_replication_lock);
+
+		num_nodes = 0;
+		status = dps_replication_nodes_get(domain->domain_id,
+		                                   nodes,
+		                                   DPS_REPLICATION_NODES_MAX,
+		                                   &num_nodes);
+
+		pthread_mutex_lock(&dps_replication_lock);
+		dps_replication_domain_distribute(domain, queue, status, nodes, num_nodes);
+		domain->flushing = 0;
+		if (domain->queue_head != NULL)
+		{
+			dps_replication_domain_mark_dirty(domain);
+		}
+		pthread_mutex_unlock(&dps_replication_lock);
+	}
+}
+
+static void dps_replication_ack_form(dps_replication_rx_channel_t *rx,
+                                     dps_client_data_t *msg,
+                                     dps_client_data_t *ack)
+{
+	uint32_t i, index;
+
+	memset(&ack->hdr, 0, sizeof(dps_client_hdr_t));
+	ack->context = NULL;
+	ack->hdr.type = DPS_REPLICATION_BATCH_ACK;
+	ack->hdr.client_id = DPS_POLICY_SERVER_ID;
+	ack->hdr.transaction_type = DPS_TRANSACTION_REPLICATION;
+	ack->hdr.vnid = msg->hdr.vnid;
+	ack->hdr.resp_status = DPS_NO_ERR;
+	memcpy(&ack->hdr.reply_addr, &msg->hdr.reply_addr, sizeof(ip_addr_t));
+	ack->replication_ack.channel_id = rx->channel_id;
+	ack->replication_ack.ack_seq_num = rx->ack_seq;
+	ack->replication_ack.errors_seq_num = rx->errors_seq_num;
+	ack->replication_ack.num_errors = rx->num_errors;
+	// Oldest first
+	index = (rx->next_error + DPS_REPLICATION_ACK_ERRORS_MAX - rx->num_errors) %
+	        DPS_REPLICATION_ACK_ERRORS_MAX;
+	for (i = 0; i < rx->num_errors; i++)
+	{
+		ack->replication_ack.errors[i] = rx->errors[index];
+		index = (index + 1) % DPS_REPLICATION_ACK_ERRORS_MAX;
+	}
+}
+
+static dps_replication_rx_channel_t *dps_replication_rx_channel_get(ip_addr_t *peer,
+                                                                    uint32_t channel_id)
+{
+	dps_replication_rx_channel_t *rx;
+	uint32_t bucket = dps_replication_channel_id_bucket(channel_id ^ dps_replication_addr_hash(peer));
+
+	for (rx = dps_replication_rx_channels[bucket]; rx != NULL; rx = rx->hash_next)
+	{
+		if ((rx->channel_id == channel_id) &&
+		    dps_replication_addr_equal(&rx->peer, peer))
+		{
+			return rx;
+		}
+	}
+	rx = (dps_replication_rx_channel_t *)calloc(1, sizeof(dps_replication_rx_channel_t));
+	if (rx == NULL)
+	{
+		return NULL;
+	}
+	memcpy(&rx->peer, peer, sizeof(ip_addr_t));
+	rx->channel_id = channel_id;
+	rx->errors_seq_num = 1;
+	rx->hash_next = dps_replication_rx_channels[bucket];
+	dps_replication_rx_channels[bucket] = rx;
+	return rx;
+}
+
+/*
+ ******************************************************************************
+ * dps_replication_batch_receive --                                       *//**
+ *
+ * \brief This routine applies a DPS_REPLICATION_BATCH if it is the next one
+ *        on its Replication Channel and acks the Channel.
+ *        MUST NOT be called with the PYTHON GIL held.
+ *
+ * \param[in] domain_id The Domain ID
+ * \param[in] msg The DPS_REPLICATION_BATCH
+ *
+ ******************************************************************************
+ */
+void dps_replication_batch_receive(uint32_t domain_id, dps_client_data_t *msg)
+{
+	dps_replication_batch_t *batch = &msg->replication_batch;
+	dps_replication_rx_channel_t *rx;
+	dps_client_data_t ack;
+	uint32_t status_list[DPS_REPLICATION_BATCH_MAX];
+	dps_resp_status_t status;
+	uint32_t i;
+
+	pthread_mutex_lock(&dps_replication_lock);
+	rx = dps_replication_rx_channel_get(&msg->hdr.reply_addr, batch->channel_id);
+	if ((rx == NULL) || rx->busy)
+	{
+		// The sender retransmits
+		pthread_mutex_unlock(&dps_replication_lock);
+		return;
+	}
+	rx->last_ms = dps_replication_time_ms();
+	if (batch->seq_num != rx->ack_seq + 1)
+	{
+		// Duplicate or out of order, tell the sender where we are
+		dps_replication_ack_form(rx, msg, &ack);
+		pthread_mutex_unlock(&dps_replication_lock);
+		dps_protocol_client_send(&ack);
+		return;
+	}
+	rx->busy = 1;
+	pthread_mutex_unlock(&dps_replication_lock);
+
+	for (i = 0; i < batch->num_entries; i++)
+	{
+		status_list[i] = DPS_NO_ERR;
+	}
+	status = dps_replication_batch_apply(domain_id, batch, status_list);
+
+	pthread_mutex_lock(&dps_replication_lock);
+	if (status == DPS_NO_ERR)
+	{
+		for (i = 0; i < batch->num_entries; i++)
+		{
+			if (status_list[i] == DPS_NO_ERR)
+			{
+				continue;
+			}
+			if (rx->num_errors == DPS_REPLICATION_ACK_ERRORS_MAX)
+			{
+				// The oldest failure drops out, its batch and the older
+				// ones are no longer reported completely
+				rx->errors_seq_num = rx->errors[rx->next_error].seq_num + 1;
+			}
+			rx->errors[rx->next_error].seq_num = batch->seq_num;
+			rx->errors[rx->next_error].index = (uint16_t)i;
+			rx->errors[rx->next_error].status = (uint16_t)status_list[i];
+			rx->next_error = (rx->next_error + 1) % DPS_REPLICATION_ACK_ERRORS_MAX;
+			if (rx->num_errors < DPS_REPLICATION_ACK_ERRORS_MAX)
+			{
+				rx->num_errors++;
+			}
+		}
+		rx->ack_seq = batch->seq_num;
+	}
+	rx->busy = 0;
+	rx->last_ms = dps_replication_time_ms();
+	dps_replication_ack_form(rx, msg, &ack);
+	pthread_mutex_unlock(&dps_replication_lock);
+
+	dps_protocol_client_send(&ack);
+}
+
+/*
+ ******************************************************************************
+ * dps_replication_ack_receive --                                         *//**
+ *
+ * \brief This routine handles a DPS_REPLICATION_BATCH_ACK: the acked
+ *        batches leave the window and their updates are completed.
+ *
+ * \param[in] msg The DPS_REPLICATION_BATCH_ACK
+ *
+ ******************************************************************************
+ */
+void dps_replication_ack_receive(dps_client_data_t *msg)
+{
+	dps_replication_ack_t *ack = &msg->replication_ack;
+	dps_replication_tx_channel_t *channel;
+	dps_replication_tx_batch_t *batch;
+	uint64_t now_ms = dps_replication_time_ms();
+	uint32_t i, j, status;
+	int fProgress = 0;
+
+	pthread_mutex_lock(&dps_replication_lock);
+	do
+	{
+		for (channel = dps_replication_tx_channel_ids[dps_replication_channel_id_bucket(ack->channel_id)];
+		     channel != NULL;
+		     channel = channel->id_hash_next)
+		{
+			if ((channel->channel_id == ack->channel_id) &&
+			    dps_replication_addr_equal(&channel->peer, &msg->hdr.reply_addr))
+			{
+				break;
+			}
+		}
+		if (channel == NULL)
+		{
+			// Stale ACK of a Channel that was reset
+			break;
+		}
+		if (ack->ack_seq_num >= channel->next_seq)
+		{
+			// The receiver acks batches never sent on this Channel
+			log_notice(PythonDataHandlerLogLevel,
+			           "Channel %d: ACK %d beyond sequence %d, resetting",
+			           channel->channel_id, ack->ack_seq_num, channel->next_seq);
+			dps_replication_tx_channel_reset(channel);
+			break;
+		}
+		while (((batch = channel->head) != NULL) &&
+		       (batch != channel->unsent) &&
+		       (batch->seq_num <= ack->ack_seq_num))
+		{
+			channel->head = batch->next;
+			if (channel->head == NULL)
+			{
+				channel->tail = NULL;
+			}
+			channel->in_flight--;
+			if (batch->seq_num < ack->errors_seq_num)
+			{
+				// The ACK which reported the failures of this batch was lost
+				// and they no longer fit in this one
+				log_notice(PythonDataHandlerLogLevel,
+				           "Channel %d: Errors of batch %d lost, failing it",
+				           channel->channel_id, batch->seq_num);
+			}
+			for (i = 0; i < batch->num_entries; i++)
+			{
+				status = (batch->seq_num < ack->errors_seq_num) ? DPS_ERROR_RETRY : DPS_NO_ERR;
+				for (j = 0; j < ack->num_errors; j++)
+				{
+					if ((ack->errors[j].seq_num == batch->seq_num) &&
+					    (ack->errors[j].index == i))
+					{
+						status = ack->errors[j].status;
+						break;
+					}
+				}
+				dps_replication_update_release(batch->updates[i], status);
+			}
+			free(batch);
+			fProgress = 1;
+		}
+		if (fProgress)
+		{
+			channel->retries = 0;
+			channel->sent_ms = now_ms;
+			channel->progress_ms = now_ms;
+			channel->last_ms = now_ms;
+			dps_replication_tx_channel_send(channel, now_ms);
+		}
+	} while(0);
+	pthread_mutex_unlock(&dps_replication_lock);
+}
+
+/*
+ ******************************************************************************
+ * dps_replication_retransmit --                                          *//**
+ *
+ * \brief This routine sends the unacked batches again (go back N) on the
+ *        Channels whose oldest batch has timed out, backing off
+ *        exponentially, and resets the Channels that made no progress for
+ *        DPS_REPLICATION_STALL_MS. Called with dps_replication_lock held.
+ *
+ * \param[in] now_ms The current time
+ *
+ ******************************************************************************
+ */
+static void dps_replication_retransmit(uint64_t now_ms)
+{
+	dps_replication_tx_channel_t *channel;
+	dps_replication_tx_batch_t *batch;
+	uint32_t bucket, backoff;
+
+	for (bucket = 0; bucket < DPS_REPLICATION_CHANNEL_BUCKETS; bucket++)
+	{
+		for (channel = dps_replication_tx_channels[bucket]; channel != NULL; channel = channel->hash_next)
+		{
+			if (channel->in_flight == 0)
+			{
+				continue;
+			}
+			backoff = (channel->retries < DPS_REPLICATION_BACKOFF_MAX) ?
+			          channel->retries : DPS_REPLICATION_BACKOFF_MAX;
+			if (now_ms - channel->sent_ms < ((uint64_t)DPS_REPLICATION_RETRANSMIT_MS << backoff))
+			{
+				continue;
+			}
+			if (now_ms - channel->progress_ms >= DPS_REPLICATION_STALL_MS)
+			{
+				log_notice(PythonDataHandlerLogLevel,
+				           "Channel %d: No ACK for batch %d, resetting",
+				           channel->channel_id, channel->head->seq_num);
+				dps_replication_tx_channel_reset(channel);
+				continue;
+			}
+			for (batch = channel->head; batch != channel->unsent; batch = batch->next)
+			{
+				dps_replication_tx_batch_send(channel, batch);
+			}
+			channel->retries++;
+			channel->sent_ms = now_ms;
+		}
+	}
+}
+
+/*
+ ******************************************************************************
+ * dps_replication_scan --                                                *//**
+ *
+ * \brief This routine times out the Shared Address Space acks and frees the
+ *        idle Domains and Channels. Called with dps_replication_lock held.
+ *
+ * \param[in] now_ms The current time
+ *
+ ******************************************************************************
+ */
+static void dps_replication_scan(uint64_t now_ms)
+{
+	dps_replication_update_t *update, *update_next;
+	dps_replication_domain_t **ppdomain, *domain;
+	dps_replication_tx_channel_t **ppchannel, *channel;
+	dps_replication_rx_channel_t **pprx, *rx;
+	uint32_t bucket;
+
+	for (bucket = 0; bucket < DPS_REPLICATION_UPDATE_BUCKETS; bucket++)
+	{
+		for (update = dps_replication_updates[bucket]; update != NULL; update = update_next)
+		{
+			update_next = update->hash_next;
+			if ((update->shared_deadline != 0) &&
+			    (now_ms >= update->shared_deadline))
+			{
+				update->shared_deadline = 0;
+				dps_replication_update_release(update, DPS_ERROR_RETRY);
+			}
+		}
+	}
+
+	for (bucket = 0; bucket < DPS_REPLICATION_DOMAIN_BUCKETS; bucket++)
+	{
+		ppdomain = &dps_replication_domains[bucket];
+		while ((domain = *ppdomain) != NULL)
+		{
+			if (domain->dirty || domain->flushing ||
+			    (domain->queue_head != NULL) ||
+			    (now_ms - domain->last_ms < DPS_REPLICATION_TX_IDLE_MS))
+			{
+				ppdomain = &domain->hash_next;
+				continue;
+			}
+			*ppdomain = domain->hash_next;
+			free(domain);
+		}
+	}
+
+	for (bucket = 0; bucket < DPS_REPLICATION_CHANNEL_BUCKETS; bucket++)
+	{
+		ppchannel = &dps_replication_tx_channels[bucket];
+		while ((channel = *ppchannel) != NULL)
+		{
+			if ((channel->head != NULL) ||
+			    (now_ms - channel->last_ms < DPS_REPLICATION_TX_IDLE_MS))
+			{
+				ppchannel = &channel->hash_next;
+				continue;
+			}
+			*ppchannel = channel->hash_next;
+			dps_replication_tx_channel_id_unhash(channel);
+			free(channel);
+		}
+		pprx = &dps_replication_rx_channels[bucket];
+		while ((rx = *pprx) != NULL)
+		{
+			if (rx->busy ||
+			    (now_ms - rx->last_ms < DPS_REPLICATION_RX_IDLE_MS))
+			{
+				pprx = &rx->hash_next;
+				continue;
+			}
+			*pprx = rx->hash_next;
+			free(rx);
+		}
+	}
+}
+
+/*
+ ******************************************************************************
+ * dps_replication_timer --                                               *//**
+ *
+ * \brief The Replication Channel timer. Flushes the updates queued outside
+ *        the DPS Protocol Handler bursts and drives retransmission and
+ *        cleanup.
+ *
+ * \param[in] pDummy Not used
+ *
+ ******************************************************************************
+ */
+static void dps_replication_timer(void *pDummy)
+{
+	struct timespec ts;
+	uint64_t now_ms, scan_ms = 0;
+
+	ts.tv_sec = 0;
+	ts.tv_nsec = DPS_REPLICATION_TICK_MS * 1000000;
+	while (1)
+	{
+		nanosleep(&ts, NULL);
+		dps_replication_flush();
+		now_ms = dps_replication_time_ms();
+		pthread_mutex_lock(&dps_replication_lock);
+		dps_replication_retransmit(now_ms);
+		if (now_ms - scan_ms >= DPS_REPLICATION_SCAN_MS)
+		{
+			dps_replication_scan(now_ms);
+			scan_ms = now_ms;
+		}
+		pthread_mutex_unlock(&dps_replication_lock);
+	}
+}
+
+/*
+ ******************************************************************************
+ * dps_replication_channel_init --                                        *//**
+ *
+ * \brief This routine starts the Replication Channel timer
+ *
+ * \retval DOVE_STATUS_OK
+ * \retval DOVE_STATUS_THREAD_FAILED
+ *
+ ******************************************************************************
+ */
+dove_status dps_replication_channel_init(void)
+{
+	long taskId;
+
+	// Channel IDs of a restarted node must not match the old ones the
+	// receivers still remember
+	dps_replication_channel_id = (uint32_t)time(NULL) ^ ((uint32_t)getpid() << 16);
+
+	if (create_task((const char *)"RepChannel", 0, OSW_DEFAULT_STACK_SIZE,
+	                dps_replication_timer, 0, &taskId) != OSW_OK)
+	{
+		log_alert(PythonDataHandlerLogLevel,
+		          "Cannot create the Replication Channel timer");
+		return DOVE_STATUS_THREAD_FAILED;
+	}
+	return DOVE_STATUS_OK;
+}
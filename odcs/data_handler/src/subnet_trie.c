@@ -0,0 +1,644 @@
+/******************************************************************************
+** File Main Owner:   DOVE DPS Development Team
+** File Description:  Longest Prefix Match trie for the IP Subnet Lists
+**/
+/*
+{
+* Copyright (c) 2010-2013 IBM Corporation
+* All rights reserved.
+*
+* This program and the accompanying materials are made available under the
+* terms of the Eclipse Public License v1.0 which accompanies this
+* distribution, and is available at http://www.eclipse.org/legal/epl-v10.html
+*
+*
+*  HISTORY
+*
+*  $Log: subnet_trie.c $
+*  $EndLog$
+*
+*  PORTING HISTORY
+*
+}
+*/
+
+#include "include.h"
+
+/**
+ * \brief Number of bits in the key of every address family
+ */
+#define IP_SUBNET_TRIE_BITS_V4 32
+#define IP_SUBNET_TRIE_BITS_V6 128
+
+/**
+ * \brief A node of the path compressed binary trie. A node covers the first
+ *        prefix_len bits of prefix; its children differ in bit prefix_len.
+ *        Nodes without a subnet only exist to join two subtrees and always
+ *        have both children.
+ */
+typedef struct ip_subnet_trie_node_s {
+	struct ip_subnet_trie_node_s *child[2];
+	/**
+	 * \brief The prefix (Network Byte Order) with the bits beyond
+	 *        prefix_len cleared
+	 */
+	uint8_t prefix[16];
+	uint32_t prefix_len;
+	/**
+	 * \brief The PYTHON IPSubnet object, NULL for a join node
+	 */
+	PyObject *subnet;
+} ip_subnet_trie_node_t;
+
+/**
+ * \brief The trie of an IPSubnetList, one root per address family
+ */
+typedef struct ip_subnet_trie_s {
+	ip_subnet_trie_node_t *root_v4;
+	ip_subnet_trie_node_t *root_v6;
+} ip_subnet_trie_t;
+
+/**
+ * \ingroup DPSClientProtocolInterface
+ * @{
+ */
+
+/*
+ ******************************************************************************
+ * ip_subnet_trie_bit --                                                  *//**
+ *
+ * \brief Returns bit (0 = Most Significant) of a Network Byte Order key
+ *
+ ******************************************************************************
+ */
+static inline uint32_t ip_subnet_trie_bit(uint8_t *key, uint32_t bit)
+{
+	return (key[bit >> 3] >> (7 - (bit & 7))) & 1;
+}
+
+/*
+ ******************************************************************************
+ * ip_subnet_trie_match_len --                                            *//**
+ *
+ * \brief Returns the number of leading bits (up to max_len) that 2 keys
+ *        have in common
+ *
+ ******************************************************************************
+ */
+static uint32_t ip_subnet_trie_match_len(uint8_t *key1, uint8_t *key2,
+                                         uint32_t max_len)
+{
+	uint32_t len = 0;
+	uint8_t diff;
+
+	while (len < max_len)
+	{
+		diff = key1[len >> 3] ^ key2[len >> 3];
+		if (diff == 0)
+		{
+			len += 8;
+			continue;
+		}
+		while (!(diff & 0x80))
+		{
+			diff <<= 1;
+			len++;
+		}
+		break;
+	}
+	return (len < max_len) ? len : max_len;
+}
+
+/*
+ ******************************************************************************
+ * ip_subnet_trie_mask --                                                 *//**
+ *
+ * \brief Clears the bits of a key beyond prefix_len
+ *
+ ******************************************************************************
+ */
+static void ip_subnet_trie_mask(uint8_t *key, uint32_t prefix_len)
+{
+	uint32_t i;
+
+	for (i = prefix_len; i < IP_SUBNET_TRIE_BITS_V6; i++)
+	{
+		if ((i & 7) == 0)
+		{
+			memset(&key[i >> 3], 0, 16 - (i >> 3));
+			break;
+		}
+		key[i >> 3] &= ~(0x80 >> (i & 7));
+	}
+	return;
+}
+
+/*
+ ******************************************************************************
+ * ip_subnet_trie_node_alloc --                                           *//**
+ *
+ * \brief Allocates a node for the first prefix_len bits of key
+ *
+ * \return The node, NULL if no memory
+ *
+ ******************************************************************************
+ */
+static ip_subnet_trie_node_t *ip_subnet_trie_node_alloc(uint8_t *key,
+                                                        uint32_t prefix_len,
+                                                        PyObject *subnet)
+{
+	ip_subnet_trie_node_t *node;
+
+	node = (ip_subnet_trie_node_t *)malloc(sizeof(ip_subnet_trie_node_t));
+	if (node == NULL)
+	{
+		return NULL;
+	}
+	node->child[0] = node->child[1] = NULL;
+	memcpy(node->prefix, key, 16);
+	ip_subnet_trie_mask(node->prefix, prefix_len);
+	node->prefix_len = prefix_len;
+	node->subnet = subnet;
+	Py_XINCREF(subnet);
+	return node;
+}
+
+/*
+ ******************************************************************************
+ * ip_subnet_trie_free --                                                 *//**
+ *
+ * \brief Frees a subtree. The GIL MUST be held.
+ *
+ ******************************************************************************
+ */
+static void ip_subnet_trie_free(ip_subnet_trie_node_t *node)
+{
+	if (node == NULL)
+	{
+		return;
+	}
+	ip_subnet_trie_free(node->child[0]);
+	ip_subnet_trie_free(node->child[1]);
+	Py_XDECREF(node->subnet);
+	free(node);
+	return;
+}
+
+/*
+ ******************************************************************************
+ * ip_subnet_trie_insert --                                               *//**
+ *
+ * \brief Adds (or replaces) the subnet for the prefix
+ *
+ * \retval DOVE_STATUS_OK
+ * \retval DOVE_STATUS_NO_MEMORY
+ *
+ ******************************************************************************
+ */
+static dove_status ip_subnet_trie_insert(ip_subnet_trie_node_t **proot,
+                                         uint8_t *key, uint32_t prefix_len,
+                                         PyObject *subnet)
+{
+	ip_subnet_trie_node_t **pnode = proot;
+	ip_subnet_trie_node_t *node, *leaf, *join;
+	uint32_t common;
+
+	while ((node = *pnode) != NULL)
+	{
+		common = ip_subnet_trie_match_len(node->prefix, key,
+		                                  (node->prefix_len < prefix_len) ?
+		                                  node->prefix_len : prefix_len);
+		if (common < node->prefix_len)
+		{
+			// The new prefix branches off (or sits) above this node
+			leaf = ip_subnet_trie_node_alloc(key, prefix_len, subnet);
+			if (leaf == NULL)
+			{
+				return DOVE_STATUS_NO_MEMORY;
+			}
+			if (common == prefix_len)
+			{
+				leaf->child[ip_subnet_trie_bit(node->prefix, prefix_len)] = node;
+				*pnode = leaf;
+				return DOVE_STATUS_OK;
+			}
+			join = ip_subnet_trie_node_alloc(key, common, NULL);
+			if (join == NULL)
+			{
+				ip_subnet_trie_free(leaf);
+				return DOVE_STATUS_NO_MEMORY;
+			}
+			join->child[ip_subnet_trie_bit(node->prefix, common)] = node;
+			join->child[ip_subnet_trie_bit(key, common)] = leaf;
+			*pnode = join;
+			return DOVE_STATUS_OK;
+		}
+		if (node->prefix_len == prefix_len)
+		{
+			// Same prefix, last writer wins
+			Py_INCREF(subnet);
+			Py_XDECREF(node->subnet);
+			node->subnet = subnet;
+			return DOVE_STATUS_OK;
+		}
+		pnode = &node->child[ip_subnet_trie_bit(key, node->prefix_len)];
+	}
+	leaf = ip_subnet_trie_node_alloc(key, prefix_len, subnet);
+	if (leaf == NULL)
+	{
+		return DOVE_STATUS_NO_MEMORY;
+	}
+	*pnode = leaf;
+	return DOVE_STATUS_OK;
+}
+
+/*
+ ******************************************************************************
+ * ip_subnet_trie_remove --                                               *//**
+ *
+ * \brief Removes the subnet for the prefix and the nodes no longer needed
+ *
+ * \retval DOVE_STATUS_OK
+ * \retval DOVE_STATUS_NOT_FOUND
+ *
+ ******************************************************************************
+ */
+static dove_status ip_subnet_trie_remove(ip_subnet_trie_node_t **proot,
+                                         uint8_t *key, uint32_t prefix_len)
+{
+	ip_subnet_trie_node_t **pnode = proot;
+	ip_subnet_trie_node_t **pparent = NULL;
+	ip_subnet_trie_node_t *node, *parent;
+
+	while ((node = *pnode) != NULL)
+	{
+		if ((node->prefix_len > prefix_len) ||
+		    (ip_subnet_trie_match_len(node->prefix, key, node->prefix_len) <
+		     node->prefix_len))
+		{
+			return DOVE_STATUS_NOT_FOUND;
+		}
+		if (node->prefix_len == prefix_len)
+		{
+			break;
+		}
+		pparent = pnode;
+		pnode = &node->child[ip_subnet_trie_bit(key, node->prefix_len)];
+	}
+	if ((node == NULL) || (node->subnet == NULL))
+	{
+		return DOVE_STATUS_NOT_FOUND;
+	}
+
+	Py_DECREF(node->subnet);
+	node->subnet = NULL;
+	if ((node->child[0] != NULL) && (node->child[1] != NULL))
+	{
+		// Still needed as a join node
+		return DOVE_STATUS_OK;
+	}
+	*pnode = (node->child[0] != NULL) ? node->child[0] : node->child[1];
+	free(node);
+
+	// A join node left with a single child is no longer needed
+	if (pparent != NULL)
+	{
+		parent = *pparent;
+		if ((parent->subnet == NULL) &&
+		    ((parent->child[0] == NULL) || (parent->child[1] == NULL)))
+		{
+			*pparent = (parent->child[0] != NULL) ? parent->child[0] : parent->child[1];
+			free(parent);
+		}
+	}
+	return DOVE_STATUS_OK;
+}
+
+/*
+ ******************************************************************************
+ * ip_subnet_trie_find --                                                 *//**
+ *
+ * \brief Returns the subnet with the longest prefix that covers key
+ *
+ * \return The PYTHON IPSubnet object (borrowed), NULL if none
+ *
+ ******************************************************************************
+ */
+static PyObject *ip_subnet_trie_find(ip_subnet_trie_node_t *node,
+                                     uint8_t *key, uint32_t key_len)
+{
+	PyObject *subnet = NULL;
+
+	while (node != NULL)
+	{
+		if (ip_subnet_trie_match_len(node->prefix, key, node->prefix_len) <
+		    node->prefix_len)
+		{
+			break;
+		}
+		if (node->subnet != NULL)
+		{
+			subnet = node->subnet;
+		}
+		if (node->prefix_len >= key_len)
+		{
+			break;
+		}
+		node = node->child[ip_subnet_trie_bit(key, node->prefix_len)];
+	}
+	return subnet;
+}
+
+/*
+ ******************************************************************************
+ * ip_subnet_trie_destroy --                                              *//**
+ *
+ * \brief The destructor of the PYTHON handle
+ *
+ ******************************************************************************
+ */
+static void ip_subnet_trie_destroy(void *ptr)
+{
+	ip_subnet_trie_t *trie = (ip_subnet_trie_t *)ptr;
+
+	ip_subnet_trie_free(trie->root_v4);
+	ip_subnet_trie_free(trie->root_v6);
+	free(trie);
+	return;
+}
+
+/*
+ ******************************************************************************
+ * ip_subnet_trie_args --                                                 *//**
+ *
+ * \brief Converts the PYTHON handle, IP type and IP value (Integer for
+ *        AF_INET, 16 byte string for AF_INET6) into the trie root and key
+ *
+ * \return 1 on success, 0 on failure
+ *
+ ******************************************************************************
+ */
+static int ip_subnet_trie_args(PyObject *pytrie, uint32_t ip_type,
+                               PyObject *pyIP, ip_subnet_trie_node_t ***proot,
+                               uint8_t *key, uint32_t *key_len)
+{
+	ip_subnet_trie_t *trie;
+	char *ipv6;
+	int ipv6_size;
+	uint32_t ipv4;
+
+	if (!PyCObject_Check(pytrie))
+	{
+		return 0;
+	}
+	trie = (ip_subnet_trie_t *)PyCObject_AsVoidPtr(pytrie);
+	memset(key, 0, 16);
+	if (ip_type == AF_INET)
+	{
+		if (!PyArg_Parse(pyIP, "I", &ipv4))
+		{
+			PyErr_Clear();
+			return 0;
+		}
+		memcpy(key, &ipv4, 4);
+		*proot = &trie->root_v4;
+		*key_len = IP_SUBNET_TRIE_BITS_V4;
+		return 1;
+	}
+	if (ip_type == AF_INET6)
+	{
+		if (!PyArg_Parse(pyIP, "z#", &ipv6, &ipv6_size) ||
+		    (ipv6 == NULL) || (ipv6_size != 16))
+		{
+			PyErr_Clear();
+			return 0;
+		}
+		memcpy(key, ipv6, 16);
+		*proot = &trie->root_v6;
+		*key_len = IP_SUBNET_TRIE_BITS_V6;
+		return 1;
+	}
+	return 0;
+}
+
+/*
+ ******************************************************************************
+ * ip_subnet_trie_prefix_len --                                           *//**
+ *
+ * \brief Converts a subnet mask into a prefix length
+ *
+ * \return The prefix length, -1 if the mask bits are not contiguous
+ *
+ ******************************************************************************
+ */
+static int ip_subnet_trie_prefix_len(uint8_t *mask, uint32_t key_len)
+{
+	uint32_t len, i;
+
+	for (len = 0; len < key_len; len++)
+	{
+		if (!ip_subnet_trie_bit(mask, len))
+		{
+			break;
+		}
+	}
+	for (i = len; i < key_len; i++)
+	{
+		if (ip_subnet_trie_bit(mask, i))
+		{
+			return -1;
+		}
+	}
+	return (int)len;
+}
+
+/*
+ ******************************************************************************
+ * ip_subnet_trie_create --                                               *//**
+ *
+ * \brief This routine creates an empty trie. The trie is freed when the
+ *        PYTHON handle is released.
+ *        def ip_subnet_trie_create()
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *ip_subnet_trie_create(PyObject *self, PyObject *args)
+{
+	ip_subnet_trie_t *trie;
+	PyObject *pytrie;
+
+	trie = (ip_subnet_trie_t *)malloc(sizeof(ip_subnet_trie_t));
+	if (trie == NULL)
+	{
+		log_error(PythonDataHandlerLogLevel, "No memory for trie");
+		return PyErr_NoMemory();
+	}
+	trie->root_v4 = NULL;
+	trie->root_v6 = NULL;
+	pytrie = PyCObject_FromVoidPtr((void *)trie, ip_subnet_trie_destroy);
+	if (pytrie == NULL)
+	{
+		log_error(PythonDataHandlerLogLevel, "PyCObject_FromVoidPtr returns NULL");
+		free(trie);
+	}
+	return pytrie;
+}
+
+/*
+ ******************************************************************************
+ * ip_subnet_trie_add --                                                  *//**
+ *
+ * \brief This routine adds (or replaces) the subnet object for a prefix.
+ *        def ip_subnet_trie_add(trie, ip_type, ip_value, mask_value, subnet)
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *ip_subnet_trie_add(PyObject *self, PyObject *args)
+{
+	ip_subnet_trie_node_t **proot;
+	PyObject *pytrie, *pyIP, *pyMask, *subnet;
+	uint32_t ip_type, key_len;
+	uint8_t key[16], mask[16];
+	int prefix_len;
+	dove_status status = DOVE_STATUS_INVALID_PARAMETER;
+
+	do
+	{
+		if (!PyArg_ParseTuple(args, "OIOOO", &pytrie, &ip_type, &pyIP,
+		                      &pyMask, &subnet) ||
+		    !ip_subnet_trie_args(pytrie, ip_type, pyMask, &proot, mask, &key_len) ||
+		    !ip_subnet_trie_args(pytrie, ip_type, pyIP, &proot, key, &key_len))
+		{
+			log_warn(PythonDataHandlerLogLevel, "Bad Data!!!");
+			break;
+		}
+		prefix_len = ip_subnet_trie_prefix_len(mask, key_len);
+		if (prefix_len < 0)
+		{
+			log_warn(PythonDataHandlerLogLevel, "Mask is not contiguous");
+			break;
+		}
+		status = ip_subnet_trie_insert(proot, key, (uint32_t)prefix_len, subnet);
+	}while(0);
+
+	return Py_BuildValue("i", status);
+}
+
+/*
+ ******************************************************************************
+ * ip_subnet_trie_del --                                                  *//**
+ *
+ * \brief This routine removes the subnet object for a prefix.
+ *        def ip_subnet_trie_del(trie, ip_type, ip_value, mask_value)
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *ip_subnet_trie_del(PyObject *self, PyObject *args)
+{
+	ip_subnet_trie_node_t **proot;
+	PyObject *pytrie, *pyIP, *pyMask;
+	uint32_t ip_type, key_len;
+	uint8_t key[16], mask[16];
+	int prefix_len;
+	dove_status status = DOVE_STATUS_INVALID_PARAMETER;
+
+	do
+	{
+		if (!PyArg_ParseTuple(args, "OIOO", &pytrie, &ip_type, &pyIP, &pyMask) ||
+		    !ip_subnet_trie_args(pytrie, ip_type, pyMask, &proot, mask, &key_len) ||
+		    !ip_subnet_trie_args(pytrie, ip_type, pyIP, &proot, key, &key_len))
+		{
+			log_warn(PythonDataHandlerLogLevel, "Bad Data!!!");
+			break;
+		}
+		prefix_len = ip_subnet_trie_prefix_len(mask, key_len);
+		if (prefix_len < 0)
+		{
+			status = DOVE_STATUS_NOT_FOUND;
+			break;
+		}
+		ip_subnet_trie_mask(key, (uint32_t)prefix_len);
+		status = ip_subnet_trie_remove(proot, key, (uint32_t)prefix_len);
+	}while(0);
+
+	return Py_BuildValue("i", status);
+}
+
+/*
+ ******************************************************************************
+ * ip_subnet_trie_lookup --                                               *//**
+ *
+ * \brief This routine returns the subnet object with the longest prefix
+ *        that covers an IP address, None if there is none.
+ *        def ip_subnet_trie_lookup(trie, ip_type, ip_value)
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *ip_subnet_trie_lookup(PyObject *self, PyObject *args)
+{
+	ip_subnet_trie_node_t **proot;
+	PyObject *pytrie, *pyIP, *subnet = NULL;
+	uint32_t ip_type, key_len;
+	uint8_t key[16];
+
+	if (PyArg_ParseTuple(args, "OIO", &pytrie, &ip_type, &pyIP) &&
+	    ip_subnet_trie_args(pytrie, ip_type, pyIP, &proot, key, &key_len))
+	{
+		subnet = ip_subnet_trie_find(*proot, key, key_len);
+	}
+	else
+	{
+		PyErr_Clear();
+	}
+	if (subnet == NULL)
+	{
+		subnet = Py_None;
+	}
+	Py_INCREF(subnet);
+	return subnet;
+}
+
+/*
+ ******************************************************************************
+ * ip_subnet_trie_flush --                                                *//**
+ *
+ * \brief This routine removes all subnets from the trie.
+ *        def ip_subnet_trie_flush(trie)
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *ip_subnet_trie_flush(PyObject *self, PyObject *args)
+{
+	ip_subnet_trie_t *trie;
+	PyObject *pytrie;
+	dove_status status = DOVE_STATUS_INVALID_PARAMETER;
+
+	do
+	{
+		if (!PyArg_ParseTuple(args, "O", &pytrie) || !PyCObject_Check(pytrie))
+		{
+			log_warn(PythonDataHandlerLogLevel, "Bad Data!!!");
+			break;
+		}
+		trie = (ip_subnet_trie_t *)PyCObject_AsVoidPtr(pytrie);
+		ip_subnet_trie_free(trie->root_v4);
+		ip_subnet_trie_free(trie->root_v6);
+		trie->root_v4 = NULL;
+		trie->root_v6 = NULL;
+		status = DOVE_STATUS_OK;
+	}while(0);
+
+	return Py_BuildValue("i", status);
+}
+
+/** @} */
@@ -0,0 +1,250 @@
+/******************************************************************************
+** File Main Owner:   DOVE DPS Development Team
+** File Description:  VNID to Domain ownership cache
+**/
+/*
+{
+* Copyright (c) 2010-2013 IBM Corporation
+* All rights reserved.
+*
+* This program and the accompanying materials are made available under the
+* terms of the Eclipse Public License v1.0 which accompanies this
+* distribution, and is available at http://www.eclipse.org/legal/epl-v10.html
+*
+*
+*  HISTORY
+*
+*  $Log: vnid_cache.c $
+*  $EndLog$
+*
+*  PORTING HISTORY
+*
+}
+*/
+
+#include "include.h"
+
+/**
+ * \brief Number of slots in the cache (power of 2)
+ */
+#define DPS_VNID_CACHE_SLOTS 16384
+
+/**
+ * \brief Number of slots probed for a VNID
+ */
+#define DPS_VNID_CACHE_PROBE 4
+
+/*
+ * Each slot is a single 64 bit word so that readers see either the old or
+ * the new entry, never a mix:
+ *   [0:23]  VNID
+ *   [24:47] Domain ID
+ *   [48:61] Generation
+ *   [62]    Domain Active
+ *   [63]    Valid
+ */
+#define DPS_VNID_CACHE_VNID_MASK   0xffffffULL
+#define DPS_VNID_CACHE_DOMAIN_SHIFT 24
+#define DPS_VNID_CACHE_GEN_SHIFT   48
+#define DPS_VNID_CACHE_GEN_MASK    0x3fffULL
+#define DPS_VNID_CACHE_ACTIVE      (1ULL << 62)
+#define DPS_VNID_CACHE_VALID       (1ULL << 63)
+
+/**
+ * \brief The cache slots
+ */
+static volatile uint64_t dps_vnid_cache[DPS_VNID_CACHE_SLOTS];
+
+/**
+ * \brief The current generation. Entries from older generations are stale.
+ */
+static volatile uint32_t dps_vnid_cache_generation;
+
+static inline uint32_t dps_vnid_cache_slot(uint32_t vnid)
+{
+	// Fibonacci hashing, VNIDs are often allocated sequentially
+	return (uint32_t)((vnid * 2654435769u) >> 18) & (DPS_VNID_CACHE_SLOTS - 1);
+}
+
+/*
+ ******************************************************************************
+ * dps_vnid_cache_lookup --                                               *//**
+ *
+ * \brief This routine determines from the cache whether a VNID is handled by
+ *        the local node.
+ *
+ * \param[in] vnid The VNID
+ * \param[in] transaction_type The DPS Transaction Type of the message
+ * \param[out] domain_id The Domain the VNID belongs to
+ * \param[out] fLocalDomain 1 if the Domain is handled locally, 0 otherwise
+ *
+ * \retval DOVE_STATUS_OK domain_id and fLocalDomain are valid
+ * \retval DOVE_STATUS_NOT_FOUND Not cached
+ *
+ ******************************************************************************
+ */
+dove_status dps_vnid_cache_lookup(uint32_t vnid,
+                                  uint32_t transaction_type,
+                                  uint32_t *domain_id,
+                                  int *fLocalDomain)
+{
+	uint64_t entry, generation;
+	uint32_t slot, i;
+
+	if (vnid > DPS_VNID_CACHE_VNID_MASK)
+	{
+		return DOVE_STATUS_NOT_FOUND;
+	}
+	generation = dps_vnid_cache_generation & DPS_VNID_CACHE_GEN_MASK;
+	slot = dps_vnid_cache_slot(vnid);
+	for (i = 0; i < DPS_VNID_CACHE_PROBE; i++)
+	{
+		entry = dps_vnid_cache[(slot + i) & (DPS_VNID_CACHE_SLOTS - 1)];
+		if (!(entry & DPS_VNID_CACHE_VALID) ||
+		    ((entry & DPS_VNID_CACHE_VNID_MASK) != vnid))
+		{
+			continue;
+		}
+		if (((entry >> DPS_VNID_CACHE_GEN_SHIFT) & DPS_VNID_CACHE_GEN_MASK) != generation)
+		{
+			break;
+		}
+		if (!(entry & DPS_VNID_CACHE_ACTIVE) &&
+		    (transaction_type == DPS_TRANSACTION_MASS_COPY))
+		{
+			// Mass Transfer is local if the Domain exists at all, which
+			// the cache doesn't know
+			break;
+		}
+		*domain_id = (uint32_t)((entry >> DPS_VNID_CACHE_DOMAIN_SHIFT) & DPS_VNID_CACHE_VNID_MASK);
+		*fLocalDomain = (entry & DPS_VNID_CACHE_ACTIVE) ? 1 : 0;
+		return DOVE_STATUS_OK;
+	}
+	return DOVE_STATUS_NOT_FOUND;
+}
+
+/*
+ ******************************************************************************
+ * dps_vnid_cache_fill --                                                 *//**
+ *
+ * \brief This routine caches an answer of Is_VNID_Handled_Locally. The GIL
+ *        serializes all writers.
+ *
+ * \param[in] vnid The VNID
+ * \param[in] domain_id The Domain the VNID belongs to
+ * \param[in] fActive 1 if the Domain exists and is active on this node
+ *
+ ******************************************************************************
+ */
+void dps_vnid_cache_fill(uint32_t vnid, uint32_t domain_id, uint32_t fActive)
+{
+	uint64_t entry, old, generation;
+	uint32_t slot, i, victim;
+
+	if ((vnid > DPS_VNID_CACHE_VNID_MASK) || (domain_id > DPS_VNID_CACHE_VNID_MASK))
+	{
+		return;
+	}
+	generation = dps_vnid_cache_generation & DPS_VNID_CACHE_GEN_MASK;
+	entry = DPS_VNID_CACHE_VALID |
+	        (generation << DPS_VNID_CACHE_GEN_SHIFT) |
+	        ((uint64_t)domain_id << DPS_VNID_CACHE_DOMAIN_SHIFT) |
+	        (uint64_t)vnid;
+	if (fActive)
+	{
+		entry |= DPS_VNID_CACHE_ACTIVE;
+	}
+	// Reuse the slot of the same VNID, else the first free or stale one,
+	// else evict the home slot
+	slot = dps_vnid_cache_slot(vnid);
+	victim = slot;
+	for (i = 0; i < DPS_VNID_CACHE_PROBE; i++)
+	{
+		old = dps_vnid_cache[(slot + i) & (DPS_VNID_CACHE_SLOTS - 1)];
+		if ((old & DPS_VNID_CACHE_VALID) &&
+		    ((old & DPS_VNID_CACHE_VNID_MASK) == vnid))
+		{
+			victim = slot + i;
+			break;
+		}
+		if ((victim == slot) &&
+		    (!(old & DPS_VNID_CACHE_VALID) ||
+		     (((old >> DPS_VNID_CACHE_GEN_SHIFT) & DPS_VNID_CACHE_GEN_MASK) != generation)))
+		{
+			victim = slot + i;
+		}
+	}
+	dps_vnid_cache[victim & (DPS_VNID_CACHE_SLOTS - 1)] = entry;
+	return;
+}
+
+/*
+ ******************************************************************************
+ * vnid_cache_invalidate --                                               *//**
+ *
+ * \brief This routine is called by PYTHON when a VNID is added to or removed
+ *        from VNID_Hash.
+ *        def vnid_cache_invalidate(vnid)
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *vnid_cache_invalidate(PyObject *self, PyObject *args)
+{
+	uint64_t entry;
+	uint32_t vnid, slot, i;
+
+	do
+	{
+		if (!PyArg_ParseTuple(args, "I", &vnid))
+		{
+			log_warn(PythonDataHandlerLogLevel, "Bad Data!!!");
+			break;
+		}
+		slot = dps_vnid_cache_slot(vnid);
+		for (i = 0; i < DPS_VNID_CACHE_PROBE; i++)
+		{
+			entry = dps_vnid_cache[(slot + i) & (DPS_VNID_CACHE_SLOTS - 1)];
+			if ((entry & DPS_VNID_CACHE_VALID) &&
+			    ((entry & DPS_VNID_CACHE_VNID_MASK) == vnid))
+			{
+				dps_vnid_cache[(slot + i) & (DPS_VNID_CACHE_SLOTS - 1)] = 0;
+			}
+		}
+	}while(0);
+
+	return Py_BuildValue("i", 0);
+}
+
+/*
+ ******************************************************************************
+ * vnid_cache_invalidate_all --                                           *//**
+ *
+ * \brief This routine is called by PYTHON when Domain_Hash, the activation
+ *        state of a Domain or all of VNID_Hash changes. Moving to the next
+ *        generation makes every entry stale at once; the slots are only
+ *        wiped when the generation number wraps around.
+ *        def vnid_cache_invalidate_all()
+ *
+ * \return PyObject
+ *
+ ******************************************************************************
+ */
+PyObject *vnid_cache_invalidate_all(PyObject *self, PyObject *args)
+{
+	uint32_t i;
+
+	if (((dps_vnid_cache_generation + 1) & DPS_VNID_CACHE_GEN_MASK) == 0)
+	{
+		for (i = 0; i < DPS_VNID_CACHE_SLOTS; i++)
+		{
+			dps_vnid_cache[i] = 0;
+		}
+	}
+	dps_vnid_cache_generation++;
+	log_debug(PythonDataHandlerLogLevel, "VNID Cache Generation %d",
+	          dps_vnid_cache_generation);
+
+	return Py_BuildValue("i", 0);
+}
@@ -27,21 +27,9 @@
 #include "fd_process_internal.h"
 
 /**
- * \brief The Events the poll should wait on
+ * \brief The Events epoll should wait on
  */
-const int poll_event = POLLIN | POLLPRI | POLLERR | POLLNVAL | POLLHUP;
-
-/**
- * \brief The number of Sockets supported
- */
-
-#define CORE_API_P1_MAX_SOCKETS 4
-
-/**
- * \brief Max file descriptors allowed for polling
- *        1 for the Dummy FDs
- */
-#define CORE_API_P1_POLL_FD_MAX (1 + CORE_API_P1_MAX_SOCKETS)
+const int poll_event = EPOLLIN | EPOLLPRI | EPOLLERR | EPOLLHUP;
 
 /*
  ******************************************************************************
@@ -51,21 +39,12 @@ const int poll_event = POLLIN | POLLPRI | POLLERR | POLLNVAL | POLLHUP;
  * @{
  * \defgroup DPSServerCoreAPI CORE APIs
  * @{
- * This module implements the CORE API
- */
-
-/**
- * \brief A pair of file descriptors,  fd_poll_dummy[0] is for
- * reading, fd_poll_dummy[1] is for writing. fd_poll_dummy[0]
- * will be added to fd_process_pfd anytime, and used to wake up poll thread
- * when poll_update_fds is called
+ * This module implements the CORE API. The File Descriptors are registered
+ * with an epoll instance, so the dispatch cost only depends on the number of
+ * File Descriptors that are ready. Registration is done directly on the
+ * epoll instance, other threads can add and remove File Descriptors without
+ * waking up the processing thread.
  */
-static int fd_poll_dummy[2] = {-1, -1};
-
-/**
- * \brief The Global Polling Structure
- */
-static struct pollfd pfd[CORE_API_P1_POLL_FD_MAX];
 
 /*
  * \brief A Structure that is utilized to store function and data
@@ -75,29 +54,47 @@ static struct pollfd pfd[CORE_API_P1_POLL_FD_MAX];
  */
 typedef struct fd_process_poll_callback_s{
 	/**
-	 * \brief The Callback Routine
+	 * \brief The Callback Routine. NULL if the File Descriptor is not
+	 *        registered.
 	 */
 	poll_event_callback poll_callback_routine;
 	/**
 	 * \brief The Callback Context
 	 */
 	void *context;
+	/**
+	 * \brief The Priority of the File Descriptor. Ready File Descriptors
+	 *        with a higher priority are processed first.
+	 */
+	int priority;
+	/**
+	 * \brief The File Descriptor
+	 */
+	int fd;
 } fd_process_poll_callback_t;
 
 /**
- * \brief A List of Routines that is associated with every File
- * Descriptor. When the File Descriptor is activated this routine
- * is called.
+ * \brief The Routines that are associated with every File Descriptor,
+ * indexed by the File Descriptor. When the File Descriptor is activated
+ * this routine is called. The chunks are allocated on demand and are never
+ * freed or moved: epoll hands the entry back in data.ptr and the processing
+ * thread reads it without taking the mutex.
+ */
+static fd_process_poll_callback_t *poll_callback_chunks[FD_PROCESS_MAX_CHUNKS];
+
+/**
+ * \brief The epoll instance
  */
-static fd_process_poll_callback_t poll_callback_array[CORE_API_P1_POLL_FD_MAX];
+static int epoll_fd = -1;
 
 /**
- * \brief The Total File Descriptor count needed for Polling
+ * \brief The Total File Descriptor count registered
  */
 static int fd_count_total = 0;
 
 /**
- * \brief A Global mutex for interacting with File Descriptors
+ * \brief A Global mutex serializing registrations. The processing thread
+ *        never takes this mutex.
  */
 
 static pthread_mutex_t base_mutex = PTHREAD_MUTEX_INITIALIZER;
@@ -106,243 +103,210 @@ static int LogLevel = DPS_SERVER_LOGLEVEL_WARNING;
 
 /*
  ******************************************************************************
- * poll_dummy_info_process --                                                  *//**
+ * poll_callback_entry --                                                 *//**
  *
- * \brief Process for dummy information, which is only used for waking up
- *  poll thread
+ * \brief This routine returns the registration entry of a File Descriptor.
+ *        The calling routine MUST hold the base_mutex.
  *
- * \param[in] fd The File Descriptor for Events, Log and Statistics
- * \param[in] context Not Used
+ * \param[in] fd The File Descriptor
+ * \param[in] allocate Whether the chunk holding the entry should be
+ *                     allocated if it doesn't exist
  *
- * \retval 0 No more event processing currently
- * \retval 1 If there are event processing to be done
+ * \retval NULL File Descriptor too large or not registered
+ * \retval Otherwise The entry
  *
  *****************************************************************************/
-static int poll_dummy_info_process(int fd, void *context)
+
+static fd_process_poll_callback_t *poll_callback_entry(int fd, int allocate)
 {
-	char dummy;
-	if(fd >= 0)
+	fd_process_poll_callback_t *chunk;
+	int chunk_index, i;
+
+	if ((fd < 0) || (fd >= FD_PROCESS_MAX_FDS))
+	{
+		return NULL;
+	}
+	chunk_index = fd >> FD_PROCESS_CHUNK_SHIFT;
+	chunk = poll_callback_chunks[chunk_index];
+	if (chunk == NULL)
 	{
-		if(1 != read(fd, &dummy, 1))
+		if (!allocate)
 		{
-			log_debug(LogLevel, "No data to read in dummy");
+			return NULL;
 		}
+		chunk = (fd_process_poll_callback_t *)calloc(FD_PROCESS_CHUNK_FDS,
+		                                             sizeof(fd_process_poll_callback_t));
+		if (chunk == NULL)
+		{
+			return NULL;
+		}
+		for (i = 0; i < FD_PROCESS_CHUNK_FDS; i++)
+		{
+			chunk[i].fd = (chunk_index << FD_PROCESS_CHUNK_SHIFT) + i;
+			chunk[i].priority = FD_PROCESS_PRIORITY_NORMAL;
+		}
+		poll_callback_chunks[chunk_index] = chunk;
 	}
-	return 0;
+	return &chunk[fd & (FD_PROCESS_CHUNK_FDS - 1)];
 }
 
-
 /*
  ******************************************************************************
- * poll_array_init --                                                     *//**
+ * poll_print_events --                                                   *//**
  *
- * \brief This routine initializes the polling array
+ * \brief This routine prints the events that were set.
  *
- * \retval Count The number of file descriptors which can be polled
+ * \retval None
  *
  *****************************************************************************/
 
-static dove_status poll_array_init(void)
+static void poll_print_events(int fd, int priority, uint32_t events)
 {
-	dove_status status = DOVE_STATUS_OK;
-	int index;
+	char print_str[128];
+
+	memset(print_str, 0, 128);
 
-	for (index = 0; index < CORE_API_P1_POLL_FD_MAX ; index++)
+	if(events & EPOLLIN)
 	{
-		pfd[index].fd = -1;
-		pfd[index].events = poll_event;
-		pfd[index].revents = 0;
-		poll_callback_array[index].poll_callback_routine = NULL;
-		poll_callback_array[index].context = NULL;
+		strcat(print_str, "EPOLLIN ");
 	}
-
-	// Set the Dummy FD
-	if (pipe(fd_poll_dummy) == -1)
+	if(events & EPOLLPRI)
 	{
-		log_critical(LogLevel, "pipe: fd_poll_dummy creation failed ");
-		status = DOVE_STATUS_INVALID_FD;
+		strcat(print_str, "EPOLLPRI ");
 	}
-	else
+	if(events & EPOLLERR)
 	{
-		if ((fcntl(fd_poll_dummy[0], F_SETFL, O_NONBLOCK) == -1) ||
-		    (fcntl(fd_poll_dummy[1], F_SETFL, O_NONBLOCK) == -1))
-		{
-			log_critical(LogLevel, "pipe: Set to UNBLOCK failed ");
-			status = DOVE_STATUS_INVALID_FD;
-		}
+		strcat(print_str, "EPOLLERR ");
 	}
-
-	if (status == DOVE_STATUS_OK)
+	if(events & EPOLLHUP)
 	{
-		pfd[POLL_DUMMY_FD_INDEX].fd = fd_poll_dummy[0];
-		pfd[POLL_DUMMY_FD_INDEX].events = poll_event;
-		poll_callback_array[POLL_DUMMY_FD_INDEX].poll_callback_routine = poll_dummy_info_process;
-		poll_callback_array[POLL_DUMMY_FD_INDEX].context = NULL;
-		fd_count_total = 1;
+		strcat(print_str, "EPOLLHUP ");
 	}
+	log_debug(LogLevel, "FD %d, Priority %d, Events [0x%x:%s]",
+	          fd, priority, events, print_str);
+	return;
 
-	return status;
 }
 
-
 /*
  ******************************************************************************
- * poll_print_events --                                                   *//**
+ * poll_sort_ready --                                                     *//**
  *
- * \brief This routine prints the events that were set.
+ * \brief This routine sorts the ready File Descriptors by descending
+ *        priority. The list is at most MAX_FD_EVENT_PROCESS long so an
+ *        insertion sort is good enough.
+ *
+ * \param[in,out] ready The ready File Descriptors
+ * \param[in] count The number of ready File Descriptors
  *
  * \retval None
  *
  *****************************************************************************/
 
-static void poll_print_events(int fd_index, int fd, int events)
+static void poll_sort_ready(fd_process_poll_callback_t **ready, int count)
 {
-	char print_str[128];
-
-	memset(print_str, 0, 128);
+	fd_process_poll_callback_t *entry;
+	int i, j;
 
-	if(events & POLLIN)
-	{
-		strcat(print_str, "POLLIN ");
-	}
-	if(events & POLLPRI)
-	{
-		strcat(print_str, "POLLPRI ");
-	}
-	if(events & POLLERR)
-	{
-		sprintf(print_str, "POLLERR ");
-	}
-	if(events & POLLNVAL)
+	for (i = 1; i < count; i++)
 	{
-		sprintf(print_str, "POLLNVAL ");
-	}
-	if(events & POLLHUP)
-	{
-		sprintf(print_str, "POLLHUP ");
+		entry = ready[i];
+		j = i - 1;
+		while ((j >= 0) && (ready[j]->priority < entry->priority))
+		{
+			ready[j+1] = ready[j];
+			j--;
+		}
+		ready[j+1] = entry;
 	}
-	log_debug(LogLevel, "Index %d, FD %d, Events [0x%x:%s]",
-	          fd_index, fd, events, print_str);
 	return;
-
 }
 
 /*
  ******************************************************************************
  * poll_process_result --                                               *//**
  *
- * \brief This routine generates the array of polling file descriptors. It will
- * return the count of file descriptors that can be polled.
+ * \brief This routine processes the events returned by epoll_wait. The
+ *        ready File Descriptors are processed in order of priority. The
+ *        File Descriptors whose callbacks have more processing to do are
+ *        called again till all of them are done.
  *
- * \retval ISWITCH_STATUS_OK Success
- * \retval Other The Character Device had error.
+ * \param[in] events The events returned by epoll_wait
+ * \param[in] poll_result The return value of epoll_wait
+ *
+ * \retval DOVE_STATUS_OK Success
+ * \retval DOVE_STATUS_INTERRUPT epoll_wait failed
  *
  *****************************************************************************/
 
-static dove_status poll_process_result(struct pollfd *fds,
-                                             int numfds,
-                                             int poll_result)
+static dove_status poll_process_result(struct epoll_event *events,
+                                       int poll_result)
 {
 	dove_status status = DOVE_STATUS_OK;
-	int fd_index;
-	int processed_index = 0;
-	int count;
-	struct pollfd *currfd;
+	fd_process_poll_callback_t *ready[MAX_FD_EVENT_PROCESS];
+	fd_process_poll_callback_t *entry;
+	int ready_count, pending_count;
+	int index;
 	poll_event_callback callback_routine;
 	void *callback_context;
-	int continue_processing = 0;
 
 	log_info(LogLevel, "Enter");
 
-	if (poll_result < 0)
-	{
-		status = DOVE_STATUS_INTERRUPT;
-		log_info(LogLevel, "Poll Result Errno %d", errno);
-		goto Exit;
-	}
-	if (poll_result == 0)
-	{
-		log_info(LogLevel, "Poll Timed out");
-		goto Exit;
-	}
-
-	// First check only the FDs that were set
-	fd_index = 0;
-	count = 0;
-	while((count < poll_result) && (processed_index < numfds) &&
-	      (fd_index < fd_count_total))
+	do
 	{
-
-		log_debug(LogLevel,
-		          "Checking Index %d, Processed Index %d, NumFds %d, "
-		          "Count %d, poll_result %d",
-		          fd_index, processed_index, numfds, count, poll_result);
-
-		currfd = &fds[fd_index];
-
-		log_debug(LogLevel,
-		          "Socket %d, Revents %d",
-		          currfd->fd, currfd->revents);
-
-		currfd->events = poll_event;
-		if (currfd->revents == 0)
+		if (poll_result < 0)
 		{
-			fd_index++;
-			continue;
+			status = DOVE_STATUS_INTERRUPT;
+			log_info(LogLevel, "Poll Result Errno %d", errno);
+			break;
 		}
-
-		if (LogLevel >= DPS_SERVER_LOGLEVEL_VERBOSE)
+		if (poll_result == 0)
 		{
-			poll_print_events(fd_index, currfd->fd, currfd->revents);
+			log_info(LogLevel, "Poll Timed out");
+			break;
 		}
 
-		callback_routine = poll_callback_array[fd_index].poll_callback_routine;
-		callback_context = poll_callback_array[fd_index].context;
-
-		if (callback_routine)
+		ready_count = 0;
+		for (index = 0; index < poll_result; index++)
 		{
-			continue_processing |= callback_routine(currfd->fd,
-			                                        callback_context);
+			entry = (fd_process_poll_callback_t *)events[index].data.ptr;
+			if (LogLevel >= DPS_SERVER_LOGLEVEL_VERBOSE)
+			{
+				poll_print_events(entry->fd, entry->priority,
+				                  events[index].events);
+			}
+			ready[ready_count++] = entry;
 		}
+		poll_sort_ready(ready, ready_count);
 
-		currfd->revents = 0;
-		processed_index++;
-		fd_index++;
-		count++;
-	}
-
-	// If some module needs to continue processing, then process all
-	// the fds in the array
-	while(continue_processing)
-	{
-		log_debug(LogLevel, "Continuing Processing...");
-		continue_processing = 0;
-		for (fd_index = 0; fd_index < fd_count_total; fd_index++)
+		// Keep processing the File Descriptors that have more work
+		while (ready_count > 0)
 		{
-			currfd = &fds[fd_index];
-			if (currfd->fd < 0)
+			pending_count = 0;
+			for (index = 0; index < ready_count; index++)
 			{
-				continue;
+				entry = ready[index];
+				callback_routine = entry->poll_callback_routine;
+				callback_context = entry->context;
+				if (callback_routine == NULL)
+				{
+					// Removed while being processed
+					continue;
+				}
+				if (callback_routine(entry->fd, callback_context))
+				{
+					// The sort order is preserved
+					ready[pending_count++] = entry;
+				}
 			}
-			callback_routine = poll_callback_array[fd_index].poll_callback_routine;
-			callback_context = poll_callback_array[fd_index].context;
-
-			/* TODO: TEMP fix it, call poll_dummy_info_process may block the process
-			 * if there is no one write the pipe, it may happen in continue_processing
-			 * maybe should set the poll_dummy_info to unblock
-			 */
-#if 0
-			if (callback_routine && callback_routine != poll_dummy_info_process)
-#endif
-			if (callback_routine)
+			if (pending_count > 0)
 			{
-				continue_processing |= callback_routine(currfd->fd,
-				                                        callback_context);
+				log_debug(LogLevel, "Continuing Processing %d FDs...",
+				          pending_count);
 			}
+			ready_count = pending_count;
 		}
-	}
-
-Exit:
+	} while (0);
 
 	log_debug(LogLevel, "Exit %s",
 	          DOVEStatusToString(status));
@@ -350,34 +314,34 @@ Exit:
 	return status;
 }
 
-
 /*
  ******************************************************************************
- * fd_process_add_fd --                                                     *//**
+ * fd_process_add_fd_priority --                                          *//**
  *
- * \brief This routine adds a new file descriptor to the array of polled
- *        file descriptors
+ * \brief This routine adds a new file descriptor to the set of polled
+ *        file descriptors with a processing priority
  *
  * \param[in] fd	The File Descriptor
  * \param[in] callback	The Callback to invoke when an event occurs on the fd
  * \param[in] context	The Context to invoke with the callback
+ * \param[in] priority	The Priority. When several File Descriptors are ready
+ *                      the ones with higher priority are processed first.
  *
  * \retval DOVE_STATUS_OK Success
- * \retval DOVE_STATUS_NO_RESOURCES Polling FD Array is Full
+ * \retval DOVE_STATUS_NO_RESOURCES File Descriptor value too large, no
+ *                                  memory or the CORE API is not initialized
  * \retval DOVE_STATUS_INVALID_PARAMETER Bad File Descriptor or Callback
- * \retval DOVE_STATUS_EXISTS File Descriptor Exists in the Array
- *
- * \note This routine updates the Global fd_count_total to the number of
- *       FDs that can be polled
+ * \retval DOVE_STATUS_EXISTS File Descriptor is already registered
  *
  *****************************************************************************/
 
-int fd_process_add_fd(int fd,
-                    poll_event_callback callback,
-                    void *context)
+int fd_process_add_fd_priority(int fd,
+                               poll_event_callback callback,
+                               void *context,
+                               int priority)
 {
-	char dummy;
-	int fd_index;
+	struct epoll_event event;
+	fd_process_poll_callback_t *entry;
 	dove_status status = DOVE_STATUS_NO_RESOURCES;
 
 	log_info(LogLevel, "Enter");
@@ -391,40 +355,42 @@ int fd_process_add_fd(int fd,
 			status = DOVE_STATUS_INVALID_PARAMETER;
 			break;
 		}
-
-		for (fd_index = 0 ; fd_index < CORE_API_P1_POLL_FD_MAX ; fd_index++)
+		if (epoll_fd < 0)
 		{
-			if (pfd[fd_index].fd >= 0)
-			{
-				continue;
-			}
-			if (pfd[fd_index].fd == fd)
-			{
-				status = DOVE_STATUS_EXISTS;
-				break;
-			}
-			pfd[fd_index].fd = fd;
-			pfd[fd_index].events = poll_event;
-			poll_callback_array[fd_index].poll_callback_routine = callback;
-			poll_callback_array[fd_index].context = context;
-			status = DOVE_STATUS_OK;
-			fd_count_total++;
+			status = DOVE_STATUS_NO_RESOURCES;
 			break;
 		}
-
-		if (status != DOVE_STATUS_OK)
+		entry = poll_callback_entry(fd, 1);
+		if (entry == NULL)
 		{
+			status = DOVE_STATUS_NO_RESOURCES;
 			break;
 		}
+		if (entry->poll_callback_routine != NULL)
+		{
+			status = DOVE_STATUS_EXISTS;
+			break;
+		}
+
+		// Fill the entry before epoll can report the fd
+		entry->context = context;
+		entry->priority = priority;
+		entry->poll_callback_routine = callback;
 
-		if(fd_poll_dummy[1] >= 0)
+		memset(&event, 0, sizeof(event));
+		event.events = poll_event;
+		event.data.ptr = entry;
+		if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) == -1)
 		{
-			/* Wake up poll */
-			if(1 != write(fd_poll_dummy[1], &dummy, 1))
-			{
-				log_debug(LogLevel, "write poll dummy fd error!");
-			}
+			log_error(LogLevel, "epoll_ctl ADD fd %d error %s",
+			          fd, strerror(errno));
+			entry->poll_callback_routine = NULL;
+			entry->context = NULL;
+			status = DOVE_STATUS_INVALID_FD;
+			break;
 		}
+		fd_count_total++;
+		status = DOVE_STATUS_OK;
 	} while (0);
 
 	pthread_mutex_unlock(&base_mutex);
@@ -435,61 +401,72 @@ int fd_process_add_fd(int fd,
 	return (int)status;
 }
 
+/*
+ ******************************************************************************
+ * fd_process_add_fd --                                                     *//**
+ *
+ * \brief This routine adds a new file descriptor to the set of polled
+ *        file descriptors with the normal priority
+ *
+ * \param[in] fd	The File Descriptor
+ * \param[in] callback	The Callback to invoke when an event occurs on the fd
+ * \param[in] context	The Context to invoke with the callback
+ *
+ * \retval DOVE_STATUS_OK Success
+ * \retval DOVE_STATUS_NO_RESOURCES File Descriptor value too large
+ * \retval DOVE_STATUS_INVALID_PARAMETER Bad File Descriptor or Callback
+ * \retval DOVE_STATUS_EXISTS File Descriptor is already registered
+ *
+ *****************************************************************************/
+
+int fd_process_add_fd(int fd,
+                    poll_event_callback callback,
+                    void *context)
+{
+	return fd_process_add_fd_priority(fd, callback, context,
+	                                  FD_PROCESS_PRIORITY_NORMAL);
+}
+
 /*
  ******************************************************************************
  * fd_process_del_fd --                                                     *//**
  *
- * \brief This routine removes a file descriptor to the array of polled
+ * \brief This routine removes a file descriptor from the set of polled
  *        file descriptors
  *
  * \param[in] fd	The File Descriptor
  *
  * \retval DOVE_STATUS_OK Success
- * \retval DOVE_STATUS_INVALID_FD File Descriptor doesn't exist in Array
- *
- * \note This routine updates the Global fd_count_total to the number of
- *       FDs that can be polled
+ * \retval DOVE_STATUS_INVALID_FD File Descriptor is not registered
  *
  *****************************************************************************/
 
 int fd_process_del_fd(int fd)
 {
-	dove_status status = DOVE_STATUS_NO_RESOURCES;
-	char dummy;
-	int fd_index;
+	fd_process_poll_callback_t *entry;
+	dove_status status = DOVE_STATUS_INVALID_FD;
 
 	log_info(LogLevel, "Enter");
 
 	pthread_mutex_lock(&base_mutex);
-	for (fd_index = 0 ; fd_index < CORE_API_P1_POLL_FD_MAX ; fd_index++)
+	do
 	{
-		if (fd != pfd[fd_index].fd)
+		entry = poll_callback_entry(fd, 0);
+		if ((entry == NULL) || (entry->poll_callback_routine == NULL))
 		{
-			continue;
+			break;
 		}
-		// Need to compress the array. Move the final element to
-		// the current location
-		pfd[fd_index].fd = pfd[fd_count_total-1].fd;
-		pfd[fd_index].events = pfd[fd_count_total-1].events;
-		poll_callback_array[fd_index].poll_callback_routine =
-			poll_callback_array[fd_count_total-1].poll_callback_routine;
-		poll_callback_array[fd_index].context =
-			poll_callback_array[fd_count_total-1].context;
-		status = DOVE_STATUS_OK;
-		fd_count_total--;
-		// NULL out the previous final value
-		pfd[fd_count_total].fd = -1;
-		poll_callback_array[fd_count_total].poll_callback_routine = NULL;
-		poll_callback_array[fd_count_total].context = NULL;
-	}
-	if(fd_poll_dummy[1] >= 0)
-	{
-		/* Wake up poll */
-		if(1 != write(fd_poll_dummy[1], &dummy, 1))
+		if (epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL) == -1)
 		{
-			log_debug(LogLevel, "write poll dummy fd error!");
+			log_notice(LogLevel, "epoll_ctl DEL fd %d error %s",
+			           fd, strerror(errno));
 		}
-	}
+		entry->poll_callback_routine = NULL;
+		entry->context = NULL;
+		entry->priority = FD_PROCESS_PRIORITY_NORMAL;
+		fd_count_total--;
+		status = DOVE_STATUS_OK;
+	} while (0);
 	pthread_mutex_unlock(&base_mutex);
 
 	log_info(LogLevel, "Exit %s, FD Count %d",
@@ -511,16 +488,25 @@ int fd_process_del_fd(int fd)
 
 dove_status fd_process_init(void)
 {
-	dove_status status = DOVE_STATUS_NO_RESOURCES;
+	dove_status status = DOVE_STATUS_OK;
 
+	pthread_mutex_lock(&base_mutex);
 	do
 	{
-		status = poll_array_init();
-		if (status != DOVE_STATUS_OK)
+		if (epoll_fd >= 0)
 		{
 			break;
 		}
+		fd_count_total = 0;
+		epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+		if (epoll_fd == -1)
+		{
+			log_critical(LogLevel, "epoll_create1 failed %s", strerror(errno));
+			status = DOVE_STATUS_INVALID_FD;
+			break;
+		}
 	} while(0);
+	pthread_mutex_unlock(&base_mutex);
 
 	return status;
 }
@@ -538,6 +524,7 @@ dove_status fd_process_init(void)
 void fd_process_start(void)
 {
 	dove_status status;
+	struct epoll_event events[MAX_FD_EVENT_PROCESS];
 	int poll_result;
 	int poll_errno;
 
@@ -553,9 +540,9 @@ void fd_process_start(void)
 			break;
 		}
 		log_debug(LogLevel,"Polling with %d FDs", fd_count_total);
-		poll_result = poll(pfd, fd_count_total, -1);
+		poll_result = epoll_wait(epoll_fd, events, MAX_FD_EVENT_PROCESS, -1);
 		poll_errno = errno;
-		status = poll_process_result(pfd, fd_count_total, poll_result);
+		status = poll_process_result(events, poll_result);
 
 		if ((status != DOVE_STATUS_OK) && (poll_errno != EINTR))
 		{
@@ -574,4 +561,3 @@ void fd_process_start(void)
 
 /** @} */
 /** @} */
-
@@ -30,16 +30,27 @@
 #define _FD_PROCESS_INTERNAL_
 
 #include "include.h"
+#include <sys/epoll.h>
 
 /**
  * \ingroup DPSServerCoreAPI
  * @{
  */
 
- /* \brief The The File Descriptor used to wake up the poll thread immediately when
-   * fd_process_pfd changes, and then poll can be called with updated fd_process_pfd
+/**
+ * \brief The registration table is indexed by the File Descriptor and is
+ *        allocated in chunks of FD_PROCESS_CHUNK_FDS entries as higher File
+ *        Descriptors get registered.
+ */
+#define FD_PROCESS_CHUNK_SHIFT 10
+#define FD_PROCESS_CHUNK_FDS (1 << FD_PROCESS_CHUNK_SHIFT)
+
+/**
+ * \brief The Maximum File Descriptor value that can be registered. This is
+ *        the default kernel limit on open files per process (fs.nr_open).
  */
-#define POLL_DUMMY_FD_INDEX 0
+#define FD_PROCESS_MAX_FDS (1 << 20)
+#define FD_PROCESS_MAX_CHUNKS (FD_PROCESS_MAX_FDS >> FD_PROCESS_CHUNK_SHIFT)
 
 /**
  * \brief Maximum number of Events to process at a time before giving up
@@ -91,6 +91,10 @@
 #include "cli_interface.h"
 #include "statistics.h"
 #include "client_protocol_interface.h"
+#include "endpoint_index.h"
+#include "vnid_cache.h"
+#include "subnet_trie.h"
+#include "replication_channel.h"
 #include "controller_interface.h"
 #include "retransmit_interface.h"
 #include "rest_api.h"
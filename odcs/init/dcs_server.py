@@ -41,6 +41,7 @@ if __name__ == '__main__':
         print "REST service port: Default 1888\r"
         print "CLI (Y/N): Default Y \r"
         print "Exit on Ctrl+C (Y/N): Default Y\r"
+        print "UDP workers: Environment DCS_UDP_WORKERS, Default 1\r"
         sys.exit()
     try:
         #UDP Port
@@ -81,6 +82,14 @@ if __name__ == '__main__':
             signal.signal(signal.SIGTERM, handler_no_quit)
         else:
             fExitOnCtrlC = 1
+        #UDP Workers
+        try:
+            udp_workers = int(os.environ['DCS_UDP_WORKERS'])
+        except Exception:
+            udp_workers = 1
+        if dcslib.set_udp_workers(udp_workers) != 0:
+            print "Invalid number of UDP workers %s, using 1\r"%udp_workers
+            dcslib.set_udp_workers(1)
         if len(sys.argv) == 6:
             dcslib.initialize(udp_port, rest_port, fDebugCli, fExitOnCtrlC, sys.argv[5])
         else:
@@ -378,7 +378,9 @@ static int dcs_local_ip_monitor_init(void)
 			break;
 		}
 
-		ret = fd_process_add_fd(dps_monitor_socket, dcs_local_ip_monitor_process, NULL);
+		ret = fd_process_add_fd_priority(dps_monitor_socket,
+		                                 dcs_local_ip_monitor_process, NULL,
+		                                 FD_PROCESS_PRIORITY_LOW);
 		if (ret != DOVE_STATUS_OK)
 		{
 			break;
@@ -424,14 +426,48 @@ init_dps_lib(PyObject *self, PyObject *args)
 	return Py_BuildValue("i", 0);
 }
 
+/*
+ ******************************************************************************
+ * set_udp_workers --                                                     *//**
+ *
+ * \brief Sets the Number of Workers that will service the DCS Server UDP
+ *        Port. This routine must be called from the PYTHON Script before
+ *        the DPS Library is initialized.
+ *
+ * \param[in] self  PyObject
+ * \param[in] args  The List of arguments (Integer)
+ *                  1st input Integer - Number of Workers
+ *
+ * \retval 0 Success
+ * \retval -1 Failure
+ *
+ ******************************************************************************/
+static PyObject *
+set_udp_workers(PyObject *self, PyObject *args)
+{
+	uint32_t num_workers;
+	if (!PyArg_ParseTuple(args, "I", &num_workers))
+	{
+		return Py_BuildValue("i", -1);
+	}
+	if (dps_svr_proto_workers_set(num_workers) != DOVE_STATUS_OK)
+	{
+		return Py_BuildValue("i", -1);
+	}
+	return Py_BuildValue("i", 0);
+}
+
 /**
  * \brief The DPS Library Methods
  */
 static PyMethodDef dps_lib_methods[] = {
 	{"initialize", init_dps_lib, METH_VARARGS, "dcslib doc"},
+	{"set_udp_workers", set_udp_workers, METH_VARARGS, "dcslib doc"},
 	{"send_all_connectivity_policies", send_all_connectivity_policies, METH_VARARGS, "dcslib doc"},
 	{"send_multicast_tunnels", send_multicast_tunnels, METH_VARARGS, "dcslib doc"},
 	{"send_gateways", send_gateways, METH_VARARGS, "dcslib doc"},
+	{"broadcast_table_pack", broadcast_table_pack, METH_VARARGS, "dcslib doc"},
+	{"broadcast_delta_pack", broadcast_delta_pack, METH_VARARGS, "dcslib doc"},
 	{"send_broadcast_table", send_broadcast_table, METH_VARARGS, "dcslib doc"},
 	{"send_address_resolution", send_address_resolution, METH_VARARGS, "dcslib doc"},
 	{"send_heartbeat", send_heartbeat, METH_VARARGS, "dcslib doc"},
@@ -444,6 +480,7 @@ static PyMethodDef dps_lib_methods[] = {
 	{"dps_vnids_replicate", dps_vnids_replicate, METH_VARARGS, "dcslib doc"},
 	{"dps_policy_bulk_replicate", dps_policy_bulk_replicate, METH_VARARGS, "dcslib doc"},
 	{"dps_ipsubnet_bulk_replicate", dps_ipsubnet_bulk_replicate, METH_VARARGS, "dcslib doc"},
+	{"mass_transfer_stream_send", mass_transfer_stream_send, METH_VARARGS, "dcslib doc"},
 	{"report_endpoint_conflict", report_endpoint_conflict, METH_VARARGS, "dcslib doc"},
 	{"process_cli_data", process_cli_data, METH_VARARGS, "dcslib doc"},
 	{"send_message_and_free", send_message_and_free, METH_VARARGS, "dcslib doc"},
@@ -471,6 +508,22 @@ static PyMethodDef dps_lib_methods[] = {
 	{"dps_rest_vnid_delete_send_to_dps_node", dps_rest_vnid_delete_send_to_dps_node, METH_VARARGS, "dcslib doc"},
 	{"dps_cluster_reregister_endpoints", dps_cluster_reregister_endpoints, METH_VARARGS, "dcslib doc"},
 	{"send_all_vm_migration_update", send_all_vm_migration_update, METH_VARARGS, "dcslib doc"},
+	{"endpoint_index_domain_activate", endpoint_index_domain_activate, METH_VARARGS, "dcslib doc"},
+	{"endpoint_index_domain_flush", endpoint_index_domain_flush, METH_VARARGS, "dcslib doc"},
+	{"endpoint_index_set", endpoint_index_set, METH_VARARGS, "dcslib doc"},
+	{"endpoint_index_del", endpoint_index_del, METH_VARARGS, "dcslib doc"},
+	{"endpoint_index_vip_add", endpoint_index_vip_add, METH_VARARGS, "dcslib doc"},
+	{"endpoint_index_vip_del", endpoint_index_vip_del, METH_VARARGS, "dcslib doc"},
+	{"endpoint_index_policy_set", endpoint_index_policy_set, METH_VARARGS, "dcslib doc"},
+	{"endpoint_index_policy_del", endpoint_index_policy_del, METH_VARARGS, "dcslib doc"},
+	{"endpoint_index_lookups_fetch", endpoint_index_lookups_fetch, METH_VARARGS, "dcslib doc"},
+	{"vnid_cache_invalidate", vnid_cache_invalidate, METH_VARARGS, "dcslib doc"},
+	{"vnid_cache_invalidate_all", vnid_cache_invalidate_all, METH_VARARGS, "dcslib doc"},
+	{"ip_subnet_trie_create", ip_subnet_trie_create, METH_VARARGS, "dcslib doc"},
+	{"ip_subnet_trie_add", ip_subnet_trie_add, METH_VARARGS, "dcslib doc"},
+	{"ip_subnet_trie_del", ip_subnet_trie_del, METH_VARARGS, "dcslib doc"},
+	{"ip_subnet_trie_lookup", ip_subnet_trie_lookup, METH_VARARGS, "dcslib doc"},
+	{"ip_subnet_trie_flush", ip_subnet_trie_flush, METH_VARARGS, "dcslib doc"},
 	{NULL, NULL, 0, NULL}  // end of table marker
 };
 
@@ -108,6 +108,116 @@ extern void show_dmc_info(void);
 
 static uint32_t nexthop_list[250];
 
+/*
+ * Broadcast lists of the domains as last received from DPS. Only the
+ * changes since seq_num are asked for (DPS_BCAST_LIST_SEQUENCED).
+ * seq_num 0 means the whole list must be asked for.
+ */
+typedef struct dgwy_bcast_cache_s {
+    uint32_t    domain;
+    uint32_t    seq_num;
+    uint32_t    num_v4_tunnels;
+    uint32_t    num_v6_tunnels;
+    uint32_t    tunnel_list[MAX_BROADCAST_MEMBERS_PER_DOMAIN];
+    uint32_t    tunnel_list_v6[MAX_BROADCAST_MEMBERS_PER_DOMAIN][4];
+} dgwy_bcast_cache_t;
+
+static dgwy_bcast_cache_t bcast_cache[MAX_DVMAP];
+static pthread_mutex_t bcast_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Called with bcast_cache_lock held */
+static dgwy_bcast_cache_t *bcast_cache_get(uint32_t domain, int fcreate)
+{
+    dgwy_bcast_cache_t *free_entry = NULL;
+    int i;
+
+    for(i=0; i<MAX_DVMAP; i++)
+    {
+        if(bcast_cache[i].domain == domain)
+        {
+            return &bcast_cache[i];
+        }
+        if((free_entry == NULL) && (bcast_cache[i].domain == 0))
+        {
+            free_entry = &bcast_cache[i];
+        }
+    }
+    if(fcreate && free_entry)
+    {
+        memset(free_entry, 0, sizeof(dgwy_bcast_cache_t));
+        free_entry->domain = domain;
+    }
+    else
+    {
+        free_entry = NULL;
+    }
+    return free_entry;
+}
+
+/*
+ * Remove the entries of del_list from a cached list. An entry is width
+ * uint32_t long: 1 for IPv4, 4 for IPv6.
+ * Called with bcast_cache_lock held
+ */
+static void bcast_cache_del(uint32_t *list, uint32_t *count, uint32_t width,
+                            uint32_t *del_list, uint32_t num_del)
+{
+    uint32_t i, j;
+
+    for(i=0; i<num_del; i++)
+    {
+        for(j=0; j<*count; j++)
+        {
+            if(!memcmp(&list[j*width], &del_list[i*width],
+                       width*sizeof(uint32_t)))
+            {
+                (*count)--;
+                memmove(&list[j*width], &list[(*count)*width],
+                       width*sizeof(uint32_t));
+                break;
+            }
+        }
+    }
+}
+
+/*
+ * Add the entries of add_list missing from a cached list, as long as the
+ * cache holds less than MAX_BROADCAST_MEMBERS_PER_DOMAIN members.
+ * Returns 0 if the list did not fit.
+ * Called with bcast_cache_lock held
+ */
+static int bcast_cache_add(dgwy_bcast_cache_t *cache,
+                           uint32_t *list, uint32_t *count, uint32_t width,
+                           uint32_t *add_list, uint32_t num_add)
+{
+    uint32_t i, j;
+
+    for(i=0; i<num_add; i++)
+    {
+        for(j=0; j<*count; j++)
+        {
+            if(!memcmp(&list[j*width], &add_list[i*width],
+                       width*sizeof(uint32_t)))
+            {
+                break;
+            }
+        }
+        if(j < *count)
+        {
+            continue;
+        }
+        if((cache->num_v4_tunnels + cache->num_v6_tunnels) >=
+           MAX_BROADCAST_MEMBERS_PER_DOMAIN)
+        {
+            return 0;
+        }
+        memcpy(&list[(*count)*width], &add_list[i*width],
+               width*sizeof(uint32_t));
+        (*count)++;
+    }
+    return 1;
+}
+
 /*
 static unsigned long long get_timestamp ()
 {
@@ -3444,6 +3554,21 @@ int dgwy_request_bcast_lst(uint32_t domain, uint16_t dvg)
     dps_client_data.hdr.type = DPS_BCAST_LIST_REQ;
     dps_client_data.hdr.vnid = domain;
 
+    /* Only ask for what changed since the list we have */
+    dps_client_data.hdr.sub_type = DPS_BCAST_LIST_SEQUENCED;
+    if(domain)
+    {
+        dgwy_bcast_cache_t *cache;
+
+        pthread_mutex_lock(&bcast_cache_lock);
+        cache = bcast_cache_get(domain, 0);
+        if(cache)
+        {
+            dps_client_data.gen_msg_req.bcast_seq_num = cache->seq_num;
+        }
+        pthread_mutex_unlock(&bcast_cache_lock);
+    }
+
     if(g_APPBRIDGE_type==DGWY_TYPE_EXTERNAL)
     {
         dps_client_data.hdr.client_id = DOVE_EXTERNAL_GATEWAY_AGENT_ID;
@@ -6064,6 +6189,110 @@ dgwy_return_status handle_dps_bcast_reply_lst(void* context,
     return (retVal);
 }
 
+/*
+ ******************************************************************************
+ * handle_dps_bcast_reply_delta                                           *//**
+ *
+ * \brief - Apply a sequenced bcast list from DPS server to the cached list
+ *           of the domain and program the resulting list. If a change was
+ *           missed the cached list is dropped and the next bcast request
+ *           asks for the whole list.
+ *
+ ******************************************************************************
+ */
+static inline
+dgwy_return_status handle_dps_bcast_reply_delta(void* context,
+                                                dps_bcast_list_delta_t* p_delta,
+                                                uint32_t domain,
+                                                uint32_t resp_status)
+{
+    dgwy_bcast_cache_t *cache;
+    uint32_t *v4_add, *v4_del, *v6_add, *v6_del;
+    uint32_t list_buf[(sizeof(dps_pkd_tunnel_list_t)/sizeof(uint32_t)) +
+                      (MAX_BROADCAST_MEMBERS_PER_DOMAIN * 4)];
+    dps_pkd_tunnel_list_t *p_bcast_lst = (dps_pkd_tunnel_list_t *)list_buf;
+    int fchanged=0;
+
+    pthread_mutex_lock(&bcast_cache_lock);
+    do
+    {
+        if(resp_status)
+        {
+            /* Keep the list we have */
+            break;
+        }
+        cache = bcast_cache_get(domain, (p_delta->base_seq_num == 0));
+        if(cache == NULL)
+        {
+            break;
+        }
+        if(p_delta->base_seq_num == 0)
+        {
+            cache->num_v4_tunnels = 0;
+            cache->num_v6_tunnels = 0;
+        }
+        else if(p_delta->base_seq_num != cache->seq_num)
+        {
+            log_info(ServiceUtilLogLevel,
+                     "domain %d bcast list %u missed change %u -> %u\n",
+                     domain, cache->seq_num,
+                     p_delta->base_seq_num, p_delta->seq_num);
+            cache->seq_num = 0;
+            break;
+        }
+        else if(p_delta->seq_num == p_delta->base_seq_num)
+        {
+            /* Nothing changed */
+            break;
+        }
+
+        v4_add = p_delta->tunnel_list;
+        v4_del = v4_add + p_delta->num_v4_add;
+        v6_add = v4_del + p_delta->num_v4_del;
+        v6_del = v6_add + (p_delta->num_v6_add * 4);
+        bcast_cache_del(cache->tunnel_list, &cache->num_v4_tunnels, 1,
+                        v4_del, p_delta->num_v4_del);
+        bcast_cache_del(&cache->tunnel_list_v6[0][0], &cache->num_v6_tunnels, 4,
+                        v6_del, p_delta->num_v6_del);
+        if(!bcast_cache_add(cache, cache->tunnel_list,
+                            &cache->num_v4_tunnels, 1,
+                            v4_add, p_delta->num_v4_add) ||
+           !bcast_cache_add(cache, &cache->tunnel_list_v6[0][0],
+                            &cache->num_v6_tunnels, 4,
+                            v6_add, p_delta->num_v6_add))
+        {
+            log_error(ServiceUtilLogLevel,
+                        "Bcast List is too big!\n");
+            cache->seq_num = 0;
+            break;
+        }
+        cache->seq_num = p_delta->seq_num;
+
+        p_bcast_lst->num_v4_tunnels = cache->num_v4_tunnels;
+        p_bcast_lst->num_v6_tunnels = cache->num_v6_tunnels;
+        memcpy(p_bcast_lst->tunnel_list, cache->tunnel_list,
+               cache->num_v4_tunnels * sizeof(uint32_t));
+        memcpy(&p_bcast_lst->tunnel_list[cache->num_v4_tunnels],
+               cache->tunnel_list_v6,
+               cache->num_v6_tunnels * 4 * sizeof(uint32_t));
+        fchanged = 1;
+    }while(0);
+    pthread_mutex_unlock(&bcast_cache_lock);
+
+    if(fchanged)
+    {
+        /* Frees the context */
+        return handle_dps_bcast_reply_lst(context, p_bcast_lst, domain);
+    }
+
+    if(context)
+    {
+        free(context);
+        stat_ctx_alloc--;
+    }
+    return (DGWY_SUCCESS);
+}
+
 
 int dgwy_ctrl_mcast_lst(dgwy_ctrl_mcast_lst_t *mlst)
 {
@@ -7294,7 +7523,29 @@ static int dgwy_handle_dps_response(void* rsp)
             break;
         }
         case DPS_BCAST_LIST_REPLY:
+        case DPS_UNSOLICITED_BCAST_LIST_REPLY:
         {
+            if(((dps_client_data_t*)rsp)->hdr.sub_type == DPS_BCAST_LIST_SEQUENCED)
+            {
+                if(handle_dps_bcast_reply_delta(p_context,
+                   &(((dps_client_data_t*)rsp)->dove_switch_delta),
+                   domain_id, resp_status)!=DGWY_SUCCESS)
+                {
+                    /* Log error */
+                    retVal = 1;
+                }
+                break;
+            }
+            if(rspType == DPS_UNSOLICITED_BCAST_LIST_REPLY)
+            {
+                /* Only sequenced lists are pushed to the gateway */
+                if(p_context)
+                {
+                    free(p_context);
+                    stat_ctx_alloc--;
+                }
+                break;
+            }
             if(handle_dps_bcast_reply_lst(p_context, 
                &(((dps_client_data_t*)rsp)->dove_switch_list), 
                domain_id)!=DGWY_SUCCESS)